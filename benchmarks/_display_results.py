@@ -1,6 +1,10 @@
 #!/usr/bin/env python3
 # Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+import argparse
+import json
 import logging
+import os
+import sys
 
 
 logging.basicConfig(level=logging.INFO)
@@ -10,6 +14,9 @@ log = logging.getLogger(__name__)
 MD_ROW_SEP = "-"
 MD_COLUMN_SEP = "|"
 
+# Multipliers from google-benchmark time units to nanoseconds
+_TIME_UNIT_TO_NS = {"ns": 1, "us": 1e3, "ms": 1e6, "s": 1e9}
+
 
 def _format_value(value):
     if isinstance(value, float):
@@ -77,3 +84,62 @@ def build_table(results):
         if idx == 0:
             message += header_split + "\n"
     return message
+
+
+def load_runtime_benchmark_results(report, interpreter):
+    # Converts the JSON report of the runtime-benchmarks binary into rows
+    # accepted by build_table and build_perf_delta_table
+    results = []
+    for entry in report["benchmarks"]:
+        if entry.get("error_occurred"):
+            log.error(f"Benchmark {entry['name']} failed: {entry['error_message']}")
+            continue
+        scale = _TIME_UNIT_TO_NS[entry["time_unit"]]
+        results.append(
+            {
+                "benchmark": entry["name"],
+                "interpreter": interpreter,
+                "cpu_time_ns": entry["cpu_time"] * scale,
+                "real_time_ns": entry["real_time"] * scale,
+            }
+        )
+    return results
+
+
+def compare_runtime_benchmark_results(reports):
+    # Takes (interpreter, report) pairs and compares every interpreter with the
+    # last one. Only benchmarks present in all reports are compared.
+    per_report = [
+        load_runtime_benchmark_results(report, interpreter)
+        for interpreter, report in reports
+    ]
+    common = set.intersection(
+        *({result["benchmark"] for result in results} for results in per_report)
+    )
+    benchmark_results = [
+        result
+        for results in per_report
+        for result in results
+        if result["benchmark"] in common
+    ]
+    return build_perf_delta_table(benchmark_results, len(reports))
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(
+        description="Compare JSON reports written by runtime-benchmarks. "
+        "Every report is compared against the last one."
+    )
+    parser.add_argument("reports", nargs="+", metavar="REPORT")
+    args = parser.parse_args(argv)
+    if len(args.reports) < 2:
+        parser.error("need at least two reports to compare")
+    reports = []
+    for path in args.reports:
+        with open(path) as fp:
+            reports.append((os.path.basename(path), json.load(fp)))
+    print(compare_runtime_benchmark_results(reports), end="")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -2,7 +2,12 @@
 # Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
 import unittest
 
-from _display_results import build_perf_delta_table, build_table
+from _display_results import (
+    build_perf_delta_table,
+    build_table,
+    compare_runtime_benchmark_results,
+    load_runtime_benchmark_results,
+)
 
 
 class TestDisplayResults(unittest.TestCase):
@@ -196,6 +201,89 @@ class TestDisplayResults(unittest.TestCase):
 |-----------|-----------------------------|------------|--------------|
 |richards   |fbcode-python vs python_new  |-73.78%     |-74.84%       |
 |richards   |python_base vs python_new    |-0.56%      |-0.0%         |
+"""
+        self.assertEqual(result, expected_result)
+
+    def test_load_runtime_benchmark_results_normalizes_time_units(self):
+        report = {
+            "context": {"num_cpus": 8},
+            "benchmarks": [
+                {
+                    "name": "DictBenchmark/DictAtStr/8",
+                    "iterations": 1000,
+                    "real_time": 12.5,
+                    "cpu_time": 12.0,
+                    "time_unit": "ns",
+                },
+                {
+                    "name": "ScavengerBenchmark/CollectGarbage/1024",
+                    "iterations": 10,
+                    "real_time": 1.5,
+                    "cpu_time": 1.25,
+                    "time_unit": "us",
+                },
+                {
+                    "name": "MarshalBenchmark/ReadCode",
+                    "error_occurred": True,
+                    "error_message": "setup failed",
+                },
+            ],
+        }
+        self.assertEqual(
+            load_runtime_benchmark_results(report, "base"),
+            [
+                {
+                    "benchmark": "DictBenchmark/DictAtStr/8",
+                    "interpreter": "base",
+                    "cpu_time_ns": 12.0,
+                    "real_time_ns": 12.5,
+                },
+                {
+                    "benchmark": "ScavengerBenchmark/CollectGarbage/1024",
+                    "interpreter": "base",
+                    "cpu_time_ns": 1250.0,
+                    "real_time_ns": 1500.0,
+                },
+            ],
+        )
+
+    def test_compare_runtime_benchmark_results(self):
+        def report(dict_time, ic_time, extra):
+            benchmarks = [
+                {
+                    "name": "DictBenchmark/DictAtStr/8",
+                    "real_time": dict_time,
+                    "cpu_time": dict_time,
+                    "time_unit": "ns",
+                },
+                {
+                    "name": "IcBenchmark/IcLookupGlobalVar",
+                    "real_time": ic_time,
+                    "cpu_time": ic_time,
+                    "time_unit": "ns",
+                },
+            ]
+            if extra:
+                benchmarks.append(
+                    {
+                        "name": "StrBenchmark/StrFind/64",
+                        "real_time": 1.0,
+                        "cpu_time": 1.0,
+                        "time_unit": "ns",
+                    }
+                )
+            return {"benchmarks": benchmarks}
+
+        reports = [
+            ("base.json", report(200.0, 10.0, extra=True)),
+            ("new.json", report(100.0, 11.0, extra=False)),
+        ]
+        result = "\n" + compare_runtime_benchmark_results(reports)
+        expected_result = """
+|benchmark                      |compare                |cpu_time_ns  |real_time_ns  |
+|-------------------------------|-----------------------|-------------|--------------|
+|IcBenchmark/IcLookupGlobalVar  |base.json vs new.json  |**10.0%**    |**10.0%**     |
+|DictBenchmark/DictAtStr/8      |base.json vs new.json  |-50.0%       |-50.0%        |
 """
         self.assertEqual(result, expected_result)
 
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Runs the same allocation heavy loop on a growing number of threads.
+
+Every thread does the same amount of work, so on a runtime that runs bytecode
+in parallel the time per round stays flat until the threads outnumber the
+cores. Each thread gets its own function object and writes its result into
+its own list slot; the main thread polls for the results.
+"""
+
+import _thread
+import argparse
+import time
+
+
+def make_worker():
+    def worker(results, index, num_items):
+        total = 0
+        for i in range(num_items):
+            item = [i, str(i), (i, i)]
+            total += item[0] + len(item[1])
+        results[index] = total
+
+    return worker
+
+
+def bench_threads(num_threads, num_items):
+    results = [None] * num_threads
+    for index in range(num_threads):
+        _thread.start_new_thread(make_worker(), (results, index, num_items))
+    while None in results:
+        time.sleep(0.001)
+    return results
+
+
+def run():
+    bench_threads(2, 10000)
+
+
+def warmup():
+    run()
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter
+    )
+    parser.add_argument(
+        "num_iterations",
+        type=int,
+        default=1,
+        nargs="?",
+        help="Number of iterations to run the benchmark",
+    )
+    parser.add_argument(
+        "--max-threads", type=int, default=8, help="Largest number of threads"
+    )
+    parser.add_argument(
+        "--items", type=int, default=200000, help="Loop iterations per thread"
+    )
+    args = parser.parse_args()
+    warmup()
+
+    expected = sum(i + len(str(i)) for i in range(args.items))
+    for _ in range(args.num_iterations):
+        num_threads = 1
+        while num_threads <= args.max_threads:
+            start = time.perf_counter()
+            results = bench_threads(num_threads, args.items)
+            elapsed = time.perf_counter() - start
+            assert results == [expected] * num_threads
+            print(f"{num_threads} threads: {elapsed:.3f}s")
+            num_threads *= 2
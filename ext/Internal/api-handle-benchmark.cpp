@@ -0,0 +1,86 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "cpython-func.h"
+
+#include "api-handle.h"
+#include "benchmark-utils.h"
+#include "handles.h"
+#include "runtime.h"
+#include "test-utils.h"
+
+namespace py {
+namespace testing {
+
+using ApiHandleBenchmark = RuntimeBenchmark;
+
+// Calls `PyObject_GetAttr(module, name)` in a loop. The extra reference held
+// on the attribute keeps its handle alive, so each iteration only measures
+// finding the existing handle of the result.
+static void getAttrLoop(benchmark::State& state, Runtime* runtime,
+                        const char* attribute) {
+  Thread* thread = Thread::current();
+  HandleScope scope(thread);
+  Object module(&scope, findMainModule(runtime));
+  PyObject* module_handle = ApiHandle::newReference(runtime, *module);
+  PyObject* name = PyUnicode_InternFromString(attribute);
+  PyObject* value = PyObject_GetAttr(module_handle, name);
+  for (auto _ : state) {
+    PyObject* result = PyObject_GetAttr(module_handle, name);
+    Py_DECREF(result);
+  }
+  Py_DECREF(value);
+  Py_DECREF(name);
+  Py_DECREF(module_handle);
+}
+
+// Types keep their handle in an embedded slot.
+BENCHMARK_DEFINE_F(ApiHandleBenchmark, GetAttrReturningType)
+(benchmark::State& state) {
+  CHECK(!runFromCStr(runtime_, R"(
+class C:
+  pass
+)")
+             .isError(),
+        "could not define class");
+  getAttrLoop(state, runtime_, "C");
+}
+BENCHMARK_REGISTER_F(ApiHandleBenchmark, GetAttrReturningType);
+
+// Functions keep their handle in the handle dictionary.
+BENCHMARK_DEFINE_F(ApiHandleBenchmark, GetAttrReturningFunction)
+(benchmark::State& state) {
+  CHECK(!runFromCStr(runtime_, R"(
+def f():
+  pass
+)")
+             .isError(),
+        "could not define function");
+  getAttrLoop(state, runtime_, "f");
+}
+BENCHMARK_REGISTER_F(ApiHandleBenchmark, GetAttrReturningFunction);
+
+// Runs young collections while `state.range(0)` tenured objects exist. When
+// `state.range(1)` is set, every one of them has a handle.
+BENCHMARK_DEFINE_F(ApiHandleBenchmark, YoungGCWithTenuredHandles)
+(benchmark::State& state) {
+  Thread* thread = Thread::current();
+  HandleScope scope(thread);
+  word num_objects = state.range(0);
+  bool with_handles = state.range(1);
+  MutableTuple objects(&scope, runtime_->newMutableTuple(num_objects));
+  Object obj(&scope, NoneType::object());
+  for (word i = 0; i < num_objects; i++) {
+    obj = runtime_->newList();
+    objects.atPut(i, *obj);
+    if (with_handles) ApiHandle::newReference(runtime_, *obj);
+  }
+  runtime_->collectGarbage();
+  for (auto _ : state) {
+    runtime_->collectYoungGarbage();
+  }
+}
+BENCHMARK_REGISTER_F(ApiHandleBenchmark, YoungGCWithTenuredHandles)
+    ->Args({100000, 0})
+    ->Args({100000, 1});
+
+}  // namespace testing
+}  // namespace py
@@ -43,6 +43,8 @@ class ApiHandleDict {
 
   void grow();
 
+  // Sets up empty storage with `num_indices` indices. Does not free the
+  // previous storage.
   void initialize(word num_indices);
 
   // Rehash the items into new storage with the given number of indices.
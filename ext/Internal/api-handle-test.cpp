@@ -264,6 +264,143 @@ TEST_F(ApiHandleTest, BuiltinObjectReturnsSameApiHandle) {
   EXPECT_EQ(handle, handle2);
 }
 
+TEST_F(ApiHandleTest, TypeObjectKeepsApiHandleInEmbeddedSlot) {
+  HandleScope scope(thread_);
+  Type type(&scope, runtime_->newType());
+  EXPECT_EQ(type.apiHandle(), NoneType::object());
+
+  ApiHandle* handle = ApiHandle::newReference(runtime_, *type);
+  EXPECT_EQ(type.apiHandle(), SmallInt::fromAlignedCPtr(handle));
+  EXPECT_EQ(capiHandles(runtime_)->at(*type), nullptr);
+  EXPECT_EQ(ApiHandle::newReference(runtime_, *type), handle);
+  EXPECT_EQ(handle->refcnt(), 2);
+  EXPECT_EQ(ApiHandle::borrowedReference(runtime_, *type), handle);
+  EXPECT_EQ(handle->refcnt(), 2);
+  handle->decref();
+  handle->decref();
+}
+
+TEST_F(ApiHandleTest, ModuleObjectKeepsApiHandleInEmbeddedSlot) {
+  HandleScope scope(thread_);
+  Object name(&scope, runtime_->newStrFromCStr("mod"));
+  Module module(&scope, runtime_->newModule(name));
+
+  ApiHandle* handle = ApiHandle::newReference(runtime_, *module);
+  EXPECT_EQ(module.apiHandle(), SmallInt::fromAlignedCPtr(handle));
+  EXPECT_EQ(capiHandles(runtime_)->at(*module), nullptr);
+  EXPECT_EQ(ApiHandle::newReference(runtime_, *module), handle);
+  handle->decref();
+  handle->decref();
+}
+
+TEST_F(ApiHandleTest, EmbeddedApiHandleWithRefcountZeroIsKeptUntilGC) {
+  HandleScope scope(thread_);
+  Type type(&scope, runtime_->newType());
+  word num_handles = numApiHandles(runtime_);
+
+  ApiHandle* handle = ApiHandle::newReference(runtime_, *type);
+  EXPECT_EQ(numApiHandles(runtime_), num_handles + 1);
+  handle->decref();
+  EXPECT_TRUE(handle->isBorrowedNoImmediate());
+  EXPECT_EQ(handle->refcnt(), 0);
+  EXPECT_EQ(numApiHandles(runtime_), num_handles + 1);
+  EXPECT_EQ(ApiHandle::borrowedReference(runtime_, *type), handle);
+
+  runtime_->collectGarbage();
+  EXPECT_EQ(numApiHandles(runtime_), num_handles + 1);
+  EXPECT_EQ(handle->asObject(), *type);
+
+  type = runtime_->newType();
+  runtime_->collectGarbage();
+  EXPECT_EQ(numApiHandles(runtime_), num_handles);
+}
+
+TEST_F(ApiHandleTest, EmbeddedApiHandleFollowsObjectMovedByGC) {
+  HandleScope scope(thread_);
+  Type type(&scope, runtime_->newType());
+  ApiHandle* handle = ApiHandle::newReference(runtime_, *type);
+  RawObject before = *type;
+
+  runtime_->collectGarbage();
+  EXPECT_NE(*type, before);
+  EXPECT_EQ(handle->asObject(), *type);
+  EXPECT_EQ(type.apiHandle(), SmallInt::fromAlignedCPtr(handle));
+  EXPECT_EQ(ApiHandle::newReference(runtime_, *type), handle);
+  handle->decref();
+  handle->decref();
+}
+
+TEST_F(ApiHandleTest, YoungCollectionOnlySweepsYoungHandles) {
+  HandleScope scope(thread_);
+  const word num_tenured = 20000;
+  const word num_young = 1000;
+  ApiHandleDict* young = capiHandles(runtime_);
+  ApiHandleDict* tenured = capiTenuredHandles(runtime_);
+
+  MutableTuple old_objects(&scope, runtime_->newMutableTuple(num_tenured));
+  Object obj(&scope, NoneType::object());
+  for (word i = 0; i < num_tenured; i++) {
+    obj = runtime_->newList();
+    old_objects.atPut(i, *obj);
+    ApiHandle::newReference(runtime_, *obj);
+  }
+  EXPECT_GE(young->numItems(), num_tenured);
+  runtime_->collectGarbage();
+  EXPECT_EQ(young->numItems(), 0);
+  word num_tenured_handles = tenured->numItems();
+  EXPECT_GE(num_tenured_handles, num_tenured);
+
+  // Handles created after the full collection are young: some stay alive,
+  // others are borrowed and die with their objects.
+  MutableTuple new_objects(&scope, runtime_->newMutableTuple(num_young));
+  for (word i = 0; i < num_young; i++) {
+    obj = runtime_->newList();
+    new_objects.atPut(i, *obj);
+    ApiHandle::newReference(runtime_, *obj);
+    obj = runtime_->newList();
+    ApiHandle::borrowedReference(runtime_, *obj);
+  }
+  obj = NoneType::object();
+  ApiHandle* cached = ApiHandle::borrowedReference(runtime_, new_objects.at(0));
+  void* buffer = std::malloc(16);
+  cached->setCache(runtime_, buffer);
+  EXPECT_EQ(young->numItems(), num_young * 2);
+
+  // The first young collection keeps the survivors in the young generation.
+  // The tenured handles are not looked at, so their storage stays the same.
+  RawObject* tenured_keys = tenured->keys();
+  runtime_->collectYoungGarbage();
+  EXPECT_EQ(tenured->keys(), tenured_keys);
+  EXPECT_EQ(tenured->numItems(), num_tenured_handles);
+  EXPECT_EQ(young->numItems(), num_young);
+  EXPECT_EQ(cached->asObject(), new_objects.at(0));
+  EXPECT_EQ(cached->cache(runtime_), buffer);
+
+  // The second one promotes them along with their handles.
+  runtime_->collectYoungGarbage();
+  EXPECT_EQ(young->numItems(), 0);
+  EXPECT_EQ(tenured->numItems(), num_tenured_handles + num_young);
+  EXPECT_EQ(cached->asObject(), new_objects.at(0));
+  EXPECT_EQ(cached->cache(runtime_), buffer);
+
+  for (word i = 0; i < num_tenured; i++) {
+    obj = old_objects.at(i);
+    ApiHandle* handle = static_cast<ApiHandle*>(tenured->at(*obj));
+    ASSERT_NE(handle, nullptr);
+    EXPECT_EQ(handle->asObject(), *obj);
+    handle->decref();
+  }
+  for (word i = 0; i < num_young; i++) {
+    obj = new_objects.at(i);
+    ApiHandle* handle = static_cast<ApiHandle*>(tenured->at(*obj));
+    ASSERT_NE(handle, nullptr);
+    EXPECT_EQ(handle->asObject(), *obj);
+    handle->decref();
+  }
+  // Only the borrowed handle with the cache is left.
+  EXPECT_EQ(tenured->numItems(), num_tenured_handles - num_tenured + 1);
+}
+
 TEST_F(ApiHandleTest, ApiHandleReturnsBuiltinObject) {
   HandleScope scope(thread_);
   Object obj(&scope, runtime_->newList());
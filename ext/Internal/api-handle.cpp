@@ -197,7 +197,9 @@ NEVER_INLINE void ApiHandleDict::grow() {
 
 void ApiHandleDict::initialize(word num_indices) {
   setIndices(newIndices(num_indices));
+  setNextIndex(0);
   setNumIndices(num_indices);
+  num_items_ = 0;
 
   int32_t capacity = maxCapacity(num_indices);
   setCapacity(capacity);
@@ -314,6 +316,41 @@ static void freeHandle(Runtime* runtime, ApiHandle* handle) {
   *free_handles = node;
 }
 
+// Returns true if `obj` does not move during a young collection.
+static bool isTenured(Runtime* runtime, RawObject obj) {
+  if (!obj.isHeapObject()) return true;
+  Heap* heap = runtime->heap();
+  uword address = HeapObject::cast(obj).address();
+  return heap->isOld(address) || heap->isImmortal(address);
+}
+
+// Returns the dictionary that holds the handle of `obj`, if it has one.
+static ApiHandleDict* handlesFor(Runtime* runtime, RawObject obj) {
+  return isTenured(runtime, obj) ? capiTenuredHandles(runtime)
+                                 : capiHandles(runtime);
+}
+
+// Types and modules cross the C-API boundary often enough to keep their handle
+// in a hidden attribute, which replaces the `capiHandles` dictionary lookup
+// with a single load. Only instances of exactly `type` and `module` qualify:
+// their layout cannot change with a `__class__` assignment.
+static bool hasEmbeddedHandle(RawObject obj) {
+  return obj.isType() || obj.isModule();
+}
+
+static RawObject embeddedHandle(RawObject obj) {
+  if (obj.isType()) return obj.rawCast<RawType>().apiHandle();
+  return obj.rawCast<RawModule>().apiHandle();
+}
+
+static void setEmbeddedHandle(RawObject obj, RawObject handle) {
+  if (obj.isType()) {
+    obj.rawCast<RawType>().setApiHandle(handle);
+  } else {
+    obj.rawCast<RawModule>().setApiHandle(handle);
+  }
+}
+
 RawNativeProxy ApiHandle::asNativeProxy() {
   DCHECK(!isImmediate() && reference_ != 0, "expected extension object handle");
   return RawObject{reference_}.rawCast<RawNativeProxy>();
@@ -337,8 +374,25 @@ ApiHandle* ApiHandle::newReferenceWithManaged(Runtime* runtime, RawObject obj) {
   DCHECK(!runtime->isInstanceOfNativeProxy(obj),
          "native proxy not handled here");
 
+  if (hasEmbeddedHandle(obj)) {
+    RawObject embedded = embeddedHandle(obj);
+    if (!embedded.isNoneType()) {
+      ApiHandle* result =
+          static_cast<ApiHandle*>(SmallInt::cast(embedded).asAlignedCPtr());
+      result->increfNoImmediate();
+      return result;
+    }
+    EVENT_ID(AllocateCAPIHandle, obj.layoutId());
+    ApiHandle* handle = allocateHandle(runtime);
+    handle->reference_ = obj.raw();
+    handle->ob_refcnt = 1;
+    setEmbeddedHandle(obj, SmallInt::fromAlignedCPtr(handle));
+    capiEmbeddedHandles(runtime)->push_back(handle);
+    return handle;
+  }
+
   // Get the handle of a builtin instance
-  ApiHandleDict* handles = capiHandles(runtime);
+  ApiHandleDict* handles = handlesFor(runtime, obj);
   int32_t index;
   if (!handles->atPutLookup(obj, &index)) {
     ApiHandle* result = reinterpret_cast<ApiHandle*>(handles->atIndex(index));
@@ -413,7 +467,13 @@ void ApiHandle::disposeWithRuntime(Runtime* runtime) {
   RawObject obj = asObjectNoImmediate();
   DCHECK(!runtime->isInstanceOfNativeProxy(obj),
          "Dispose must not be called on extension object");
-  capiHandles(runtime)->remove(obj);
+  if (hasEmbeddedHandle(obj)) {
+    // The object still points to the handle. Keep it like a borrowed handle
+    // until the GC finds the object unreachable.
+    setBorrowedNoImmediate();
+    return;
+  }
+  handlesFor(runtime, obj)->remove(obj);
 
   void* cache = capiCaches(runtime)->remove(obj);
   std::free(cache);
@@ -441,8 +501,7 @@ void ApiHandle::setRefcnt(Py_ssize_t count) {
   ob_refcnt = count | flags;
 }
 
-void disposeApiHandles(Runtime* runtime) {
-  ApiHandleDict* handles = capiHandles(runtime);
+static void disposeHandlesIn(Runtime* runtime, ApiHandleDict* handles) {
   int32_t end = handles->nextIndex();
   RawObject* keys = handles->keys();
   void** values = handles->values();
@@ -455,12 +514,28 @@ void disposeApiHandles(Runtime* runtime) {
   }
 }
 
+void disposeApiHandles(Runtime* runtime) {
+  disposeHandlesIn(runtime, capiHandles(runtime));
+  disposeHandlesIn(runtime, capiTenuredHandles(runtime));
+
+  ApiHandleDict* caches = capiCaches(runtime);
+  Vector<ApiHandle*>* embedded = capiEmbeddedHandles(runtime);
+  for (ApiHandle* handle : *embedded) {
+    RawObject obj = handle->asObjectNoImmediate();
+    setEmbeddedHandle(obj, NoneType::object());
+    std::free(caches->remove(obj));
+    freeHandle(runtime, handle);
+  }
+  embedded->clear();
+}
+
 word numApiHandles(Runtime* runtime) {
-  return capiHandles(runtime)->numItems();
+  return capiHandles(runtime)->numItems() +
+         capiTenuredHandles(runtime)->numItems() +
+         capiEmbeddedHandles(runtime)->size();
 }
 
-void visitApiHandles(Runtime* runtime, HandleVisitor* visitor) {
-  ApiHandleDict* handles = capiHandles(runtime);
+static void visitHandlesIn(ApiHandleDict* handles, HandleVisitor* visitor) {
   int32_t end = handles->nextIndex();
   RawObject* keys = handles->keys();
   void** values = handles->values();
@@ -472,10 +547,16 @@ void visitApiHandles(Runtime* runtime, HandleVisitor* visitor) {
   }
 }
 
-void visitIncrementedApiHandles(Runtime* runtime, PointerVisitor* visitor) {
-  // Report handles with a refcount > 0 as roots. We deliberately do not visit
-  // other handles and do not update dictionary keys yet.
-  ApiHandleDict* handles = capiHandles(runtime);
+void visitApiHandles(Runtime* runtime, HandleVisitor* visitor) {
+  visitHandlesIn(capiHandles(runtime), visitor);
+  visitHandlesIn(capiTenuredHandles(runtime), visitor);
+  for (ApiHandle* handle : *capiEmbeddedHandles(runtime)) {
+    visitor->visitHandle(handle, handle->asObjectNoImmediate());
+  }
+}
+
+static void visitIncrementedHandlesIn(ApiHandleDict* handles,
+                                      PointerVisitor* visitor) {
   int32_t end = handles->nextIndex();
   RawObject* keys = handles->keys();
   void** values = handles->values();
@@ -493,36 +574,42 @@ void visitIncrementedApiHandles(Runtime* runtime, PointerVisitor* visitor) {
   }
 }
 
-void visitNotIncrementedBorrowedApiHandles(Runtime* runtime,
-                                           Scavenger* scavenger,
-                                           PointerVisitor* visitor) {
-  // This function:
-  // - Rebuilds the handle dictionary: The GC may have moved object around so
-  //   we have to adjust the dictionary keys to the new references and updated
-  //   hash values. As a side effect this also clears tombstones and shrinks
-  //   the dictionary if possible.
-  // - Remove (or rather not insert into the new dictionary) entries with
-  //   refcount zero, that are not referenced from any other live object
-  //   (object is "white" after GC tri-coloring).
-  // - Rebuild cache dictionary to adjust for moved `key` addresses.
-
-  ApiHandleDict* caches = capiCaches(runtime);
-  ApiHandleDict* handles = capiHandles(runtime);
-  int32_t end = handles->nextIndex();
-  int32_t* indices = handles->indices();
-  RawObject* keys = handles->keys();
-  void** values = handles->values();
+void visitIncrementedApiHandles(Runtime* runtime, Scavenger* scavenger,
+                                PointerVisitor* visitor) {
+  // Report handles with a refcount > 0 as roots. We deliberately do not visit
+  // other handles and do not update dictionary keys yet. Tenured objects stay
+  // in place during a young collection, so only a full collection needs to
+  // look at their handles.
+  visitIncrementedHandlesIn(capiHandles(runtime), visitor);
+  if (isCollectingOld(scavenger)) {
+    visitIncrementedHandlesIn(capiTenuredHandles(runtime), visitor);
+  }
+  for (ApiHandle* handle : *capiEmbeddedHandles(runtime)) {
+    if (handle->refcntNoImmediate() > 0) {
+      // Same as above: the handle keeps the old address until later.
+      RawObject obj = handle->asObjectNoImmediate();
+      visitor->visitPointer(&obj, PointerKind::kApiHandle);
+    }
+  }
+}
 
-  word old_num_items = handles->numItems();
-  word new_num_indices = Utils::nextPowerOfTwo((old_num_items * 3) / 2 + 1);
-  int32_t new_capacity = maxCapacity(new_num_indices);
-  int32_t* new_indices = newIndices(new_num_indices);
-  RawObject* new_keys = newKeys(new_capacity);
-  void** new_values = newValues(new_capacity);
+static word numIndicesFor(word num_items) {
+  return Utils::maximum(word{8},
+                        Utils::nextPowerOfTwo((num_items * 3) / 2 + 1));
+}
 
+// Moves the entries in `keys` and `values`, which is the storage a dictionary
+// had before the collection, into `young` or `tenured` with the new addresses
+// of their objects. Handles with refcount zero whose objects are unreachable
+// are freed instead. When `move_caches` is set, the cached values of moved
+// objects are re-inserted with the new addresses as well.
+static void sweepHandles(Runtime* runtime, Scavenger* scavenger,
+                         PointerVisitor* visitor, RawObject* keys,
+                         void** values, int32_t end, ApiHandleDict* young,
+                         ApiHandleDict* tenured, bool move_caches) {
+  ApiHandleDict* caches = capiCaches(runtime);
   RawObject key = NoneType::object();
   void* value;
-  int32_t count = 0;
   for (int32_t i = 0; nextItem(keys, values, &i, end, &key, &value);) {
     ApiHandle* handle = reinterpret_cast<ApiHandle*>(value);
     if (handle->refcntNoImmediate() == 0) {
@@ -531,43 +618,112 @@ void visitNotIncrementedBorrowedApiHandles(Runtime* runtime,
       if (key.isHeapObject() &&
           isWhiteObject(scavenger, HeapObject::cast(key))) {
         // Lookup associated cache data. Note that `key` and the keys in the
-        // `caches` array both use addressed from before GC movement.
-        // `caches.rehash()` happens is delayed until the end of this function.
+        // `caches` array both use addresses from before GC movement.
         void* cache = caches->remove(key);
         freeHandle(runtime, handle);
         std::free(cache);
         continue;
       }
     }
-    visitor->visitPointer(&key, PointerKind::kApiHandle);
-    handle->reference_ = reinterpret_cast<uintptr_t>(key.raw());
-    // Insert into new handle dictionary.
-    uword hash = handleHash(key);
-    for (IndexProbe probe = probeBegin(new_num_indices, hash);;
-         probeNext(&probe)) {
-      if (indexAt(new_indices, probe.index) == kEmptyIndex) {
-        indexAtPut(new_indices, probe.index, count);
-        itemAtPut(new_keys, new_values, count, key, value);
-        break;
-      }
+    RawObject new_key = key;
+    visitor->visitPointer(&new_key, PointerKind::kApiHandle);
+    handle->reference_ = reinterpret_cast<uintptr_t>(new_key.raw());
+    if (move_caches && new_key != key) {
+      void* cache = caches->remove(key);
+      if (cache != nullptr) caches->atPut(new_key, cache);
     }
-    count++;
+    ApiHandleDict* handles = isTenured(runtime, new_key) ? tenured : young;
+    handles->atPut(new_key, handle);
   }
+}
 
-  handles->setCapacity(new_capacity);
-  handles->setIndices(new_indices);
-  handles->setKeys(new_keys);
-  handles->setNextIndex(count);
-  handles->setNumIndices(new_num_indices);
-  handles->setValues(new_values);
+void visitNotIncrementedBorrowedApiHandles(Runtime* runtime,
+                                           Scavenger* scavenger,
+                                           PointerVisitor* visitor) {
+  // This function:
+  // - Rebuilds the handle dictionaries: The GC may have moved object around so
+  //   we have to adjust the dictionary keys to the new references and updated
+  //   hash values. As a side effect this also clears tombstones and shrinks
+  //   the dictionaries if possible.
+  // - Remove (or rather not insert into the new dictionary) entries with
+  //   refcount zero, that are not referenced from any other live object
+  //   (object is "white" after GC tri-coloring).
+  // - Move handles of objects that got promoted into `capiTenuredHandles`.
+  // - Update or free the handles embedded in types and modules the same way.
+  // - Adjust the cache dictionary for moved `key` addresses.
+  //
+  // A young collection leaves tenured objects where they are and never finds
+  // them white, so it only rebuilds the dictionary of young handles. The cost
+  // of the collection then depends on the number of handles created since the
+  // last one instead of the number of all live handles.
 
-  std::free(indices);
-  std::free(keys);
-  std::free(values);
+  ApiHandleDict* caches = capiCaches(runtime);
+  ApiHandleDict* handles = capiHandles(runtime);
+  ApiHandleDict* tenured = capiTenuredHandles(runtime);
+  bool full = isCollectingOld(scavenger);
+
+  int32_t* young_indices = handles->indices();
+  RawObject* young_keys = handles->keys();
+  void** young_values = handles->values();
+  int32_t young_end = handles->nextIndex();
+  if (full) {
+    // Everything that survives a full collection is tenured.
+    int32_t* tenured_indices = tenured->indices();
+    RawObject* tenured_keys = tenured->keys();
+    void** tenured_values = tenured->values();
+    int32_t tenured_end = tenured->nextIndex();
+    tenured->initialize(
+        numIndicesFor(tenured->numItems() + handles->numItems()));
+    handles->initialize(numIndicesFor(0));
+    sweepHandles(runtime, scavenger, visitor, tenured_keys, tenured_values,
+                 tenured_end, tenured, tenured, /*move_caches=*/false);
+    sweepHandles(runtime, scavenger, visitor, young_keys, young_values,
+                 young_end, tenured, tenured, /*move_caches=*/false);
+    std::free(tenured_indices);
+    std::free(tenured_keys);
+    std::free(tenured_values);
+  } else {
+    handles->initialize(numIndicesFor(handles->numItems()));
+    sweepHandles(runtime, scavenger, visitor, young_keys, young_values,
+                 young_end, handles, tenured, /*move_caches=*/true);
+  }
+  std::free(young_indices);
+  std::free(young_keys);
+  std::free(young_values);
+
+  // Handles embedded in their objects only need their reference updated.
+  Vector<ApiHandle*>* embedded = capiEmbeddedHandles(runtime);
+  word num_embedded = 0;
+  for (word i = 0, length = embedded->size(); i < length; i++) {
+    ApiHandle* handle = (*embedded)[i];
+    RawObject key = handle->asObjectNoImmediate();
+    if (handle->refcntNoImmediate() == 0 &&
+        isWhiteObject(scavenger, HeapObject::cast(key))) {
+      DCHECK(handle->isBorrowedNoImmediate(),
+             "non-borrowed object should already be disposed");
+      void* cache = caches->remove(key);
+      freeHandle(runtime, handle);
+      std::free(cache);
+      continue;
+    }
+    RawObject new_key = key;
+    visitor->visitPointer(&new_key, PointerKind::kApiHandle);
+    handle->reference_ = reinterpret_cast<uintptr_t>(new_key.raw());
+    if (!full && new_key != key) {
+      void* cache = caches->remove(key);
+      if (cache != nullptr) caches->atPut(new_key, cache);
+    }
+    (*embedded)[num_embedded++] = handle;
+  }
+  while (embedded->size() > num_embedded) {
+    embedded->pop_back();
+  }
 
-  // Re-hash caches dictionary.
-  caches->visitKeys(visitor);
-  caches->rehash(caches->numIndices());
+  if (full) {
+    // Re-hash caches dictionary.
+    caches->visitKeys(visitor);
+    caches->rehash(caches->numIndices());
+  }
 }
 
 RawObject objectGetMember(Thread* thread, RawObject ptr, RawObject name) {
@@ -66,6 +66,7 @@ void initializeCAPIState(Runtime* runtime) {
   new (state) CAPIState;
   state->caches.initialize(kInitialCachesCapacity);
   state->handles.initialize(kInitialHandlesCapacity);
+  state->tenured_handles.initialize(kInitialHandlesCapacity);
 
   state->handle_buffer =
       OS::allocateMemory(kHandleBlockSize, &state->handle_buffer_size);
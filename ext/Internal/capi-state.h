@@ -27,9 +27,19 @@ struct CAPIState {
   byte* handle_buffer;
   word handle_buffer_size;
 
-  // C-API object handles
+  // C-API handles of objects in the young generation. A young collection only
+  // sweeps this dictionary.
   ApiHandleDict handles;
 
+  // C-API handles of objects in the old generation or the immortal partition
+  // and of heap-less objects. These objects do not move during a young
+  // collection, so the dictionary is only swept by full collections.
+  ApiHandleDict tenured_handles;
+
+  // Handles of objects that keep their handle in an embedded slot instead of
+  // `handles`. The GC walks this list to update and free them.
+  Vector<ApiHandle*> embedded_handles;
+
   Vector<PyObject*> modules;
 
   ListEntry* extension_objects;
@@ -54,6 +64,14 @@ inline ApiHandleDict* capiHandles(Runtime* runtime) {
   return &capiState(runtime)->handles;
 }
 
+inline ApiHandleDict* capiTenuredHandles(Runtime* runtime) {
+  return &capiState(runtime)->tenured_handles;
+}
+
+inline Vector<ApiHandle*>* capiEmbeddedHandles(Runtime* runtime) {
+  return &capiState(runtime)->embedded_handles;
+}
+
 inline Vector<PyObject*>* capiModules(Runtime* runtime) {
   return &capiState(runtime)->modules;
 }
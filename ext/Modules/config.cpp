@@ -20,7 +20,6 @@ extern "C" PyObject* PyInit__random();
 extern "C" PyObject* PyInit__socket();
 extern "C" PyObject* PyInit__sha3();
 extern "C" PyObject* PyInit__sqlite3();
-extern "C" PyObject* PyInit__sre();
 extern "C" PyObject* PyInit__ssl();
 extern "C" PyObject* PyInit__stat();
 extern "C" PyObject* PyInit__struct();
@@ -72,7 +71,6 @@ struct _inittab _PyImport_Inittab[] = {
     {"_socket", PyInit__socket},
     {"_sha3", PyInit__sha3},
     {"_sqlite3", PyInit__sqlite3},
-    {"_sre", PyInit__sre},
     {"_ssl", PyInit__ssl},
     {"_stat", PyInit__stat},
     {"_struct", PyInit__struct},
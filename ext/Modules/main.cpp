@@ -23,14 +23,21 @@
 namespace py {
 
 extern Vector<const char*> warn_options;
+extern const char* snapshot_path;
+extern const char* build_snapshot_path;
 
 static const char* const kInteractiveHelp =
     R"(Type "help", "copyright", "credits" or "license" for more information.)";
 
 static const char* const kSupportedOpts = "+bBc:dEthiIm:OqsSuvVW:xX:";
+// Values returned by getopt_long() for long options without a short form.
+static const int kSnapshotOpt = 256;
+static const int kBuildSnapshotOpt = 257;
 static const struct option kSupportedLongOpts[] = {
     {"help", no_argument, nullptr, 'h'},
     {"version", no_argument, nullptr, 'V'},
+    {"snapshot", required_argument, nullptr, kSnapshotOpt},
+    {"build-snapshot", required_argument, nullptr, kBuildSnapshotOpt},
     {nullptr, 0, nullptr, 0}};
 
 static void failArgConversion(const char* message, int argi) {
@@ -221,6 +228,12 @@ PY_EXPORT int Py_BytesMain(int argc, char** argv) {
       case 'q':
         Py_QuietFlag++;
         break;
+      case kSnapshotOpt:
+        snapshot_path = optarg;
+        break;
+      case kBuildSnapshotOpt:
+        build_snapshot_path = optarg;
+        break;
       default:
         UNREACHABLE("Unexpected value returned from getopt_long()");
     }
@@ -252,6 +265,12 @@ PY_EXPORT int Py_BytesMain(int argc, char** argv) {
 
   Py_Initialize();
 
+  if (build_snapshot_path != nullptr) {
+    // The snapshot was written while initializing the runtime.
+    Py_Finalize();
+    return EXIT_SUCCESS;
+  }
+
   if (!Py_QuietFlag &&
       (Py_VerboseFlag || (command == nullptr && filename == nullptr &&
                           module == nullptr && is_interactive))) {
@@ -132,13 +132,19 @@ PY_EXPORT void PyEval_ReleaseThread(PyThreadState* /* e */) {
   UNIMPLEMENTED("PyEval_ReleaseThread");
 }
 
-PY_EXPORT void PyEval_RestoreThread(PyThreadState* /* e */) {
-  // TODO(T37761469): Implement instead of making it a noop
+PY_EXPORT void PyEval_RestoreThread(PyThreadState* tstate) {
+  Thread* thread = reinterpret_cast<Thread*>(tstate);
+  DCHECK(thread == Thread::current(), "thread state of another thread");
+  thread->leaveBlockingRegion();
 }
 
 PY_EXPORT PyThreadState* PyEval_SaveThread() {
-  // TODO(T37761469): Implement instead of making it a noop
-  return nullptr;
+  // There is no global interpreter lock. Code between `PyEval_SaveThread()`
+  // and `PyEval_RestoreThread()` must not touch Python objects, so the thread
+  // can be treated as stopped for garbage collections started by others.
+  Thread* thread = Thread::current();
+  thread->enterBlockingRegion();
+  return reinterpret_cast<PyThreadState*>(thread);
 }
 
 PY_EXPORT int Py_AddPendingCall(int (*/* func */)(void*), void* /* g */) {
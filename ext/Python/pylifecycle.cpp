@@ -6,6 +6,7 @@
 #include <clocale>
 #include <cstdio>
 #include <cstdlib>
+#include <memory>
 
 #include "cpython-data.h"
 #include "cpython-func.h"
@@ -17,6 +18,7 @@
 #include "modules.h"
 #include "os.h"
 #include "runtime.h"
+#include "snapshot.h"
 #include "str-builtins.h"
 #include "sys-module.h"
 #include "vector.h"
@@ -47,6 +49,12 @@ namespace py {
 // them and clear the vector.
 Vector<const char*> warn_options;
 
+// Used by Py_BytesMain to store the `--snapshot` and `--build-snapshot`
+// options. `Py_Initialize` starts the runtime from the heap snapshot at
+// `snapshot_path` or writes a new one to `build_snapshot_path`.
+const char* snapshot_path = nullptr;
+const char* build_snapshot_path = nullptr;
+
 PY_EXPORT PyOS_sighandler_t PyOS_getsig(int signum) {
   return OS::signalHandler(signum);
 }
@@ -407,7 +415,35 @@ PY_EXPORT void Py_InitializeEx(int initsigs) {
   Interpreter* interpreter = boolFromEnv("PYRO_CPP_INTERPRETER", false)
                                  ? createCppInterpreter()
                                  : createAsmInterpreter();
-  Runtime* runtime = new Runtime(heap_size, interpreter, random_seed);
+  std::unique_ptr<Snapshot> snapshot;
+  if (build_snapshot_path != nullptr) {
+    snapshot.reset(Snapshot::create(build_snapshot_path));
+  } else if (snapshot_path != nullptr) {
+    const char* error = nullptr;
+    snapshot.reset(Snapshot::open(snapshot_path, &error));
+    if (snapshot == nullptr) {
+      std::fprintf(stderr, "Ignoring heap snapshot %s: %s\n", snapshot_path,
+                   error);
+    }
+  }
+  Runtime* runtime =
+      new Runtime(heap_size, interpreter, random_seed, snapshot.get());
+  if (build_snapshot_path != nullptr && snapshot->error() != nullptr) {
+    std::fprintf(stderr, "Failed to write heap snapshot %s: %s\n",
+                 build_snapshot_path, snapshot->error());
+    std::exit(EXIT_FAILURE);
+  }
+  const char* scavenger_workers =
+      Py_IgnoreEnvironmentFlag ? nullptr
+                               : std::getenv("PYRO_SCAVENGER_WORKERS");
+  if (scavenger_workers != nullptr && scavenger_workers[0] != '\0') {
+    char* endptr;
+    long num_workers = std::strtol(scavenger_workers, &endptr, 10);
+    if (*endptr != '\0' || num_workers < 1 || num_workers > 64) {
+      Py_FatalError("PYRO_SCAVENGER_WORKERS must be an integer in [1; 64]");
+    }
+    runtime->heap()->setNumScavengerWorkers(num_workers);
+  }
   Thread* thread = Thread::current();
   initializeSysFromGlobals(thread);
   CHECK(runtime->initialize(thread).isNoneType(),
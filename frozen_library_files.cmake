@@ -18,6 +18,7 @@ library/_json.py
 library/_os.py
 library/_path.py
 library/_signal.py
+library/_sre.py
 library/_str_mod.py
 library/_thread.py
 library/_valgrind.py
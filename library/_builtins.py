@@ -668,6 +668,19 @@ def _jit_iscompiled(func):
     _builtin()
 
 
+def _jit_num_tier_ups():
+    """Return the number of functions that were compiled automatically because
+    they reached the threshold set by `_jit_set_threshold`."""
+    _builtin()
+
+
+def _jit_set_threshold(threshold):
+    """Compile functions to native code automatically once the sum of their
+    calls and loop iterations reaches `threshold`. 0 disables automatic
+    compilation, which is the default."""
+    _builtin()
+
+
 def _list_append(self, item):
     "$intrinsic$"
     _builtin()
@@ -873,6 +886,24 @@ def _profiler_exclude(callable):
     _builtin()
 
 
+def _profiler_sample_start(interval_usec, allocation_interval):
+    """Start recording the stack of the current thread every `interval_usec`
+    microseconds of CPU time and every `allocation_interval` allocated bytes.
+    Either interval may be 0 to disable that kind of sample."""
+    _builtin()
+
+
+def _profiler_sample_stop():
+    _builtin()
+
+
+def _profiler_samples(clear):
+    """Return a list of `(kind, weight, frames)` tuples for the recorded
+    samples. `frames` alternates between function and bytecode offset,
+    starting with the innermost frame."""
+    _builtin()
+
+
 def _property(fget=None, fset=None, fdel=None, doc=None):
     """Has the same effect as property(), but can be used for bootstrapping."""
     _builtin()
@@ -84,11 +84,57 @@ class UnderBuiltinsTests(unittest.TestCase):
         self.assertEqual(C.a_classmethod(), 2)
         self.assertEqual(C.a_staticmethod(), 3)
 
+    def test_jit_set_threshold_compiles_hot_function(self):
+        def foo():
+            return 10
+
+        before = _builtins._jit_num_tier_ups()
+        _builtins._jit_set_threshold(5)
+        try:
+            for _i in range(10):
+                foo()
+        finally:
+            _builtins._jit_set_threshold(0)
+        self.assertTrue(_builtins._jit_iscompiled(foo))
+        self.assertGreater(_builtins._jit_num_tier_ups(), before)
+        self.assertEqual(foo(), 10)
+
+    def test_jit_set_threshold_with_negative_raises_value_error(self):
+        with self.assertRaises(ValueError):
+            _builtins._jit_set_threshold(-1)
+
+    def test_jit_set_threshold_with_non_int_raises_type_error(self):
+        with self.assertRaises(TypeError):
+            _builtins._jit_set_threshold("5")
+
     def test_list_new_default_fill_returns_list(self):
         self.assertListEqual(_builtins._list_new(-1), [])
         self.assertListEqual(_builtins._list_new(0), [])
         self.assertListEqual(_builtins._list_new(3), [None, None, None])
 
+    def test_jit_set_threshold_compiles_hot_function(self):
+        def foo():
+            return 10
+
+        before = _builtins._jit_num_tier_ups()
+        _builtins._jit_set_threshold(5)
+        try:
+            for _i in range(10):
+                foo()
+        finally:
+            _builtins._jit_set_threshold(0)
+        self.assertTrue(_builtins._jit_iscompiled(foo))
+        self.assertGreater(_builtins._jit_num_tier_ups(), before)
+        self.assertEqual(foo(), 10)
+
+    def test_jit_set_threshold_with_negative_raises_value_error(self):
+        with self.assertRaises(ValueError):
+            _builtins._jit_set_threshold(-1)
+
+    def test_jit_set_threshold_with_non_int_raises_type_error(self):
+        with self.assertRaises(TypeError):
+            _builtins._jit_set_threshold("5")
+
     def test_list_new_default_fill_returns_list(self):
         self.assertListEqual(_builtins._list_new(0, 1), [])
         self.assertListEqual(_builtins._list_new(3, 1), [1, 1, 1])
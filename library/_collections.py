@@ -32,10 +32,10 @@ class OrderedDict(dict):
     # maintained by `dict`.
 
     def move_to_end(self, key, last=True):
-        value = self.pop(key)
-        if not last:
-            _unimplemented()
-        self[key] = value
+        _ordered_dict_move_to_end(self, key, last)
+
+    def popitem(self, last=True):
+        return _ordered_dict_popitem(self, last)
 
     def __repr__(self):
         return _sequence_repr(f"{self.__class__.__name__}([", self.items(), "])")
@@ -93,6 +93,14 @@ def _deque_setitem(self, index, value):
     _builtin()
 
 
+def _ordered_dict_move_to_end(self, key, last):
+    _builtin()
+
+
+def _ordered_dict_popitem(self, last):
+    _builtin()
+
+
 class _tuplegetter(metaclass=_non_heaptype):
     __slots__ = ("_index", "_doc")
 
@@ -191,6 +191,17 @@ name_op("LOAD_METHOD", 160)
 def_op("CALL_METHOD", 161)
 jrel_op("CALL_FINALLY", 162)
 def_op("POP_FINALLY", 163)
+jrel_op("FOR_ITER_ACCUMULATE", 164)
+jrel_op("FOR_ITER_CHAIN", 165)
+jrel_op("FOR_ITER_COUNT", 166)
+jrel_op("FOR_ITER_GROUPBY", 167)
+jrel_op("FOR_ITER_ISLICE", 168)
+jrel_op("FOR_ITER_PRODUCT", 169)
+jrel_op("FOR_ITER_REPEAT", 170)
+jrel_op("FOR_ITER_TEE", 171)
+jrel_op("FOR_ITER_ZIP_LONGEST", 172)
+name_op("LOAD_METHOD_MEGAMORPHIC", 174)
+name_op("LOAD_ATTR_MEGAMORPHIC", 175)
 compare_op("COMPARE_NE_STR", 178)
 jrel_op("FOR_ITER_GENERATOR", 179)
 def_op("STORE_SUBSCR_DICT", 180)
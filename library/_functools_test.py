@@ -128,5 +128,114 @@ class FunctoolsLRUCacheWrapperTests(unittest.TestCase):
         self.assertEqual(info.currsize, 0)
 
 
+    def test_bounded_lru_wrapper_evicts_least_recently_used(self):
+        calls = []
+
+        def func(x):
+            calls.append(x)
+            return x * 2
+
+        wrapper = _functools._lru_cache_wrapper(func, 2, False, _CacheInfo)
+        wrapper(1)
+        wrapper(2)
+        wrapper(1)
+        wrapper(3)
+        self.assertEqual(calls, [1, 2, 3])
+        self.assertEqual(wrapper(1), 2)
+        self.assertEqual(calls, [1, 2, 3])
+        self.assertEqual(wrapper(2), 4)
+        self.assertEqual(calls, [1, 2, 3, 2])
+
+    def test_lru_wrapper_with_keyword_arguments_caches_separately(self):
+        def func(*args, **kwargs):
+            return (args, kwargs)
+
+        wrapper = _functools._lru_cache_wrapper(func, None, False, _CacheInfo)
+        self.assertEqual(wrapper(1, b=2), ((1,), {"b": 2}))
+        self.assertEqual(wrapper(1, 2), ((1, 2), {}))
+        self.assertEqual(wrapper(1, b=2), ((1,), {"b": 2}))
+        info = wrapper.cache_info()
+        self.assertEqual(info.hits, 1)
+        self.assertEqual(info.misses, 2)
+
+    def test_lru_wrapper_with_typed_distinguishes_argument_types(self):
+        wrapper = _functools._lru_cache_wrapper(repr, 10, True, _CacheInfo)
+        self.assertEqual(wrapper(1), "1")
+        self.assertEqual(wrapper(1.0), "1.0")
+        self.assertEqual(wrapper.cache_info().currsize, 2)
+
+    def test_lru_wrapper_without_typed_treats_equal_arguments_as_same(self):
+        def func(*args):
+            return repr(args[0])
+
+        wrapper = _functools._lru_cache_wrapper(func, 10, False, _CacheInfo)
+        self.assertEqual(wrapper(1, 2), "1")
+        self.assertEqual(wrapper(1.0, 2.0), "1")
+
+    def test_lru_wrapper_with_unhashable_argument_raises_type_error(self):
+        wrapper = _functools._lru_cache_wrapper(len, 10, False, _CacheInfo)
+        with self.assertRaises(TypeError):
+            wrapper([1, 2])
+
+    def test_lru_wrapper_does_not_cache_exceptions(self):
+        calls = []
+
+        def func(x):
+            calls.append(x)
+            raise ValueError(x)
+
+        wrapper = _functools._lru_cache_wrapper(func, 10, False, _CacheInfo)
+        with self.assertRaises(ValueError):
+            wrapper(1)
+        with self.assertRaises(ValueError):
+            wrapper(1)
+        self.assertEqual(calls, [1, 1])
+        self.assertEqual(wrapper.cache_info().currsize, 0)
+
+    def test_lru_wrapper_with_reentrant_call_caches_result_once(self):
+        def func(n):
+            return n if n == 0 else wrapper(n - 1) + n
+
+        wrapper = _functools._lru_cache_wrapper(func, 3, False, _CacheInfo)
+        self.assertEqual(wrapper(10), 55)
+        self.assertEqual(wrapper.cache_info().currsize, 3)
+        self.assertEqual(wrapper(10), 55)
+        self.assertEqual(wrapper.cache_info().hits, 1)
+
+    def test_lru_wrapper_with_negative_maxsize_does_not_cache(self):
+        wrapper = _functools._lru_cache_wrapper(pow, -1, False, _CacheInfo)
+        wrapper(2, 3)
+        self.assertEqual(wrapper.cache_info(), _CacheInfo(0, 1, 0, 0))
+
+    def test_lru_wrapper_with_non_callable_raises_type_error(self):
+        with self.assertRaises(TypeError):
+            _functools._lru_cache_wrapper(1, 10, False, _CacheInfo)
+
+    def test_lru_wrapper_with_non_int_maxsize_raises_type_error(self):
+        with self.assertRaises(TypeError):
+            _functools._lru_cache_wrapper(pow, "10", False, _CacheInfo)
+
+    def test_lru_cache_keeps_wrapped_function_attributes(self):
+        def func(x):
+            """doc"""
+            return x
+
+        wrapper = functools.lru_cache(maxsize=4)(func)
+        self.assertIsInstance(wrapper, _functools._lru_cache_wrapper)
+        self.assertIs(wrapper.__wrapped__, func)
+        self.assertEqual(wrapper.__name__, "func")
+        self.assertEqual(wrapper.__doc__, "doc")
+
+
+    def test_lru_cache_on_method_binds_self(self):
+        class C:
+            @functools.lru_cache()
+            def method(self, x):
+                return (self, x)
+
+        c = C()
+        self.assertEqual(c.method(1), (c, 1))
+        self.assertIsInstance(C.method, _functools._lru_cache_wrapper)
+
 if __name__ == "__main__":
     unittest.main()
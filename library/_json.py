@@ -47,6 +47,51 @@ def _decode_with_cls(
     return cls(**kw).decode(s)
 
 
+def _encode_with_cls(
+    obj,
+    skipkeys,
+    ensure_ascii,
+    check_circular,
+    allow_nan,
+    cls,
+    indent,
+    separators,
+    default,
+    sort_keys,
+    **kw,
+):
+    if cls is None:
+        cls = _JSONEncoder
+    return cls(
+        skipkeys=skipkeys,
+        ensure_ascii=ensure_ascii,
+        check_circular=check_circular,
+        allow_nan=allow_nan,
+        indent=indent,
+        separators=separators,
+        default=default,
+        sort_keys=sort_keys,
+        **kw,
+    ).encode(obj)
+
+
+def dumps(
+    obj,
+    *,
+    skipkeys=False,
+    ensure_ascii=True,
+    check_circular=True,
+    allow_nan=True,
+    cls=None,
+    indent=None,
+    separators=None,
+    default=None,
+    sort_keys=False,
+    **kw,
+):
+    _builtin()
+
+
 def loads(
     s,
     *,
@@ -63,3 +108,4 @@ def loads(
 
 
 from json.decoder import JSONDecoder as _JSONDecoder
+from json.encoder import JSONEncoder as _JSONEncoder
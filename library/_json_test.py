@@ -7,9 +7,143 @@ from test_support import cpython_only
 
 
 if sys.implementation.name == "pyro":
-    from _json import loads, JSONDecodeError
+    from _json import dumps, loads, JSONDecodeError
 else:
-    from json import loads, JSONDecodeError
+    from json import dumps, loads, JSONDecodeError
+
+
+class DumpsTests(unittest.TestCase):
+    def test_with_constants_returns_str(self):
+        self.assertEqual(dumps(None), "null")
+        self.assertEqual(dumps(True), "true")
+        self.assertEqual(dumps(False), "false")
+
+    def test_with_int_returns_decimal(self):
+        self.assertEqual(dumps(0), "0")
+        self.assertEqual(dumps(-42), "-42")
+        self.assertEqual(dumps(1 << 100), "1267650600228229401496703205376")
+
+    def test_with_int_subclass_ignores_dunder_repr(self):
+        class C(int):
+            def __repr__(self):
+                return "C"
+
+        self.assertEqual(dumps(C(7)), "7")
+
+    def test_with_float_returns_shortest_repr(self):
+        self.assertEqual(dumps(0.1), "0.1")
+        self.assertEqual(dumps(-0.0), "-0.0")
+        self.assertEqual(dumps(1e100), "1e+100")
+        self.assertEqual(dumps(2.0), "2.0")
+
+    def test_with_non_finite_float_returns_javascript_names(self):
+        self.assertEqual(
+            dumps([float("nan"), float("inf"), float("-inf")]),
+            "[NaN, Infinity, -Infinity]",
+        )
+
+    def test_with_non_finite_float_and_allow_nan_false_raises_value_error(self):
+        with self.assertRaisesRegex(ValueError, "not JSON compliant"):
+            dumps(float("inf"), allow_nan=False)
+
+    def test_with_str_escapes_special_characters(self):
+        self.assertEqual(dumps('a"b\\c'), '"a\\"b\\\\c"')
+        self.assertEqual(
+            dumps("\b\f\n\r\t\x00\x1f"), '"\\b\\f\\n\\r\\t\\u0000\\u001f"'
+        )
+
+    def test_with_str_escapes_non_ascii(self):
+        self.assertEqual(dumps("caf\xe9 \x7f"), '"caf\\u00e9 \\u007f"')
+        self.assertEqual(dumps("\U0001f40d"), '"\\ud83d\\udc0d"')
+
+    def test_with_long_str_escapes_every_chunk(self):
+        text = ("0123456789" * 30 + "\n\u20ac") * 10
+        self.assertEqual(loads(dumps(text)), text)
+        escaped = text.replace("\n", "\\n").replace("\u20ac", "\\u20ac")
+        self.assertEqual(dumps(text), f'"{escaped}"')
+
+    def test_with_ensure_ascii_false_keeps_non_ascii(self):
+        self.assertEqual(
+            dumps("caf\xe9 \x7f \U0001f40d", ensure_ascii=False),
+            '"caf\xe9 \x7f \U0001f40d"',
+        )
+
+    def test_with_containers_returns_nested_text(self):
+        self.assertEqual(dumps([]), "[]")
+        self.assertEqual(dumps({}), "{}")
+        self.assertEqual(
+            dumps({"a": [1, (2, 3)], "b": {"c": None}}),
+            '{"a": [1, [2, 3]], "b": {"c": null}}',
+        )
+
+    def test_with_non_str_keys_converts_keys(self):
+        self.assertEqual(
+            dumps({2: 0, 2.5: 0, True: 0, None: 0}),
+            '{"2": 0, "2.5": 0, "true": 0, "null": 0}',
+        )
+
+    def test_with_unsupported_key_raises_type_error(self):
+        with self.assertRaisesRegex(TypeError, "keys must be str.*not tuple"):
+            dumps({(1,): 0})
+
+    def test_with_skipkeys_skips_unsupported_keys(self):
+        self.assertEqual(dumps({(1,): 0, "a": 1}, skipkeys=True), '{"a": 1}')
+
+    def test_with_sort_keys_sorts_keys(self):
+        self.assertEqual(
+            dumps({"b": 1, "a": {"d": 2, "c": 3}}, sort_keys=True),
+            '{"a": {"c": 3, "d": 2}, "b": 1}',
+        )
+
+    def test_with_indent_int_indents_with_spaces(self):
+        self.assertEqual(
+            dumps({"a": [1, 2], "b": []}, indent=2),
+            '{\n  "a": [\n    1,\n    2\n  ],\n  "b": []\n}',
+        )
+
+    def test_with_indent_str_uses_indent_str(self):
+        self.assertEqual(dumps([1], indent="\t"), "[\n\t1\n]")
+
+    def test_with_separators_uses_separators(self):
+        self.assertEqual(
+            dumps({"a": [1, 2]}, separators=(",", ":")), '{"a":[1,2]}'
+        )
+
+    def test_with_default_encodes_result_of_default(self):
+        self.assertEqual(dumps({1, 2}, default=sorted), "[1, 2]")
+
+    def test_without_default_raises_type_error(self):
+        with self.assertRaisesRegex(
+            TypeError, "Object of type object is not JSON serializable"
+        ):
+            dumps(object())
+
+    def test_with_circular_list_raises_value_error(self):
+        ls = []
+        ls.append(ls)
+        with self.assertRaisesRegex(ValueError, "Circular reference detected"):
+            dumps(ls)
+
+    def test_with_circular_default_raises_value_error(self):
+        o = object()
+        with self.assertRaisesRegex(ValueError, "Circular reference detected"):
+            dumps(o, default=lambda x: x)
+
+    def test_with_dict_subclass_calls_items(self):
+        class C(dict):
+            def items(self):
+                return [("x", 1)]
+
+        self.assertEqual(dumps(C(a=0)), '{"x": 1}')
+
+    def test_with_cls_calls_encoder_class(self):
+        import json
+
+        class Encoder(json.JSONEncoder):
+            def default(self, o):
+                return "custom"
+
+        self.assertEqual(dumps([object()], cls=Encoder), '["custom"]')
 
 
 class LoadsTests(unittest.TestCase):
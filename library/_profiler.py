@@ -1,6 +1,14 @@
 #!/usr/bin/env python3
 # Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
-from _builtins import _int_check_exact, _profiler_exclude, _profiler_install
+from _builtins import (
+    _function_lineno,
+    _int_check_exact,
+    _profiler_exclude,
+    _profiler_install,
+    _profiler_sample_start,
+    _profiler_sample_stop,
+    _profiler_samples,
+)
 
 
 next_id = 0
@@ -266,3 +274,156 @@ def _dump_callgrind_impl(filename, clear):
 
 def dump_callgrind(filename, clear=True):
     _profiler_exclude(lambda: _dump_callgrind_impl(filename, clear))
+
+
+_SAMPLE_TIME = 0
+_SAMPLE_ALLOCATION = 1
+
+
+def start_sampling(interval=0.001, allocation_interval=0):
+    """Sample the stack of the current thread every `interval` seconds of CPU
+    time and every `allocation_interval` allocated bytes. Samples are recorded
+    without calling back into Python, so this can be left running. Set either
+    interval to 0 to disable that kind of sample."""
+    _profiler_sample_start(int(interval * 1000000), allocation_interval)
+
+
+def stop_sampling():
+    _profiler_sample_stop()
+
+
+def _function_name(function):
+    module = getattr(function, "__module__", "?")
+    qualname = getattr(function, "__qualname__", function.__code__.co_name)
+    return f"{module}.{qualname}"
+
+
+def _sample_stacks(clear):
+    """Return a list of `(kind, weight, stack)` tuples where stack is a list of
+    `(function, lineno)` pairs, starting with the outermost frame."""
+    result = []
+    for kind, weight, frames in _profiler_samples(clear):
+        stack = []
+        for i in range(len(frames) - 2, -1, -2):
+            function = frames[i]
+            code = function.__code__
+            if _is_native(code):
+                lineno = code.co_firstlineno
+            else:
+                lineno = _function_lineno(function, frames[i + 1])
+            stack.append((function, lineno))
+        result.append((kind, weight, stack))
+    return result
+
+
+def _dump_folded_to_fp(fp, samples, kind):
+    counts = {}
+    for sample_kind, weight, stack in samples:
+        if sample_kind != kind or not stack:
+            continue
+        key = ";".join(_function_name(function) for function, _ in stack)
+        counts[key] = counts.get(key, 0) + weight
+    for key in sorted(counts):
+        fp.write(f"{key} {counts[key]}\n")
+
+
+def dump_folded(filename, allocations=False, clear=True):
+    """Write the recorded samples in folded stack format, one line per unique
+    stack followed by its weight. Time samples weigh 1 each; allocation samples
+    (selected with `allocations=True`) weigh the number of bytes they stand
+    for."""
+    samples = _sample_stacks(clear)
+    kind = _SAMPLE_ALLOCATION if allocations else _SAMPLE_TIME
+    with open(filename, "w") as fp:
+        _dump_folded_to_fp(fp, samples, kind)
+
+
+class _SampleInfo:
+    """Costs attributed to a single function by the sampling profiler."""
+
+    def __init__(self, function):
+        self.function = function
+        # Maps line number to [samples, bytes] spent in the function itself.
+        self.lines = {}
+        # Maps (line number, callee function) to [calls, samples, bytes] of
+        # samples passing through the call.
+        self.calls = {}
+
+
+def _dump_sampled_callgrind_to_fp(fp, samples):
+    infos = {}
+
+    def info_for(function):
+        info = infos.get(function)
+        if info is None:
+            info = _SampleInfo(function)
+            infos[function] = info
+        return info
+
+    for kind, weight, stack in samples:
+        if not stack:
+            continue
+        cost = 1 if kind == _SAMPLE_TIME else 0
+        size = weight if kind == _SAMPLE_ALLOCATION else 0
+        function, lineno = stack[-1]
+        line = info_for(function).lines.setdefault(lineno, [0, 0])
+        line[0] += cost
+        line[1] += size
+        # Only count the first occurrence of an edge in recursive stacks.
+        seen = set()
+        for i in range(len(stack) - 1):
+            caller, caller_lineno = stack[i]
+            callee = stack[i + 1][0]
+            key = (caller_lineno, callee)
+            if (caller, key) in seen:
+                continue
+            seen.add((caller, key))
+            call = info_for(caller).calls.setdefault(key, [0, 0, 0])
+            call[0] += 1
+            call[1] += cost
+            call[2] += size
+
+    env = _DumpCallgrind(fp)
+    env.write(
+        """\
+# callgrind format
+version: 1
+creator: _profiler
+positions: line
+events: Samples Bytes
+
+"""
+    )
+    ids = {}
+
+    def func(prefix, function):
+        func_id = ids.get(function)
+        if func_id is None:
+            func_id = len(ids)
+            ids[function] = func_id
+            env.write(f"{prefix}=({func_id}) {_function_name(function)}\n")
+        else:
+            env.write(f"{prefix}=({func_id})\n")
+
+    to_print = sorted(infos.values(), key=lambda i: _function_name(i.function))
+    for info in to_print:
+        code = info.function.__code__
+        env.file("fl", code.co_filename)
+        func("fn", info.function)
+        for lineno in sorted(info.lines):
+            samples_count, size = info.lines[lineno]
+            env.write(f"{lineno} {samples_count} {size}\n")
+        for (lineno, callee), (calls, samples_count, size) in info.calls.items():
+            callee_code = callee.__code__
+            env.file("cfi", callee_code.co_filename)
+            func("cfn", callee)
+            env.write(f"calls={calls} {callee_code.co_firstlineno}\n")
+            env.write(f"{lineno} {samples_count} {size}\n")
+        env.write("\n")
+
+
+def dump_sampled_callgrind(filename, clear=True):
+    """Write the recorded time and allocation samples in callgrind format."""
+    samples = _sample_stacks(clear)
+    with open(filename, "w") as fp:
+        _dump_sampled_callgrind_to_fp(fp, samples)
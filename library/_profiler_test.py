@@ -93,5 +93,71 @@ calls=1 [0-9]+
             self.assertRegex(contents, expected)
 
 
+@pyro_only
+class SamplingProfilerTest(unittest.TestCase):
+    def test_dump_folded_writes_allocation_stacks(self):
+        def allocate():
+            return [[i] for i in range(1000)]
+
+        def foo():
+            for _ in range(10):
+                allocate()
+
+        with TemporaryDirectory() as temp_dir:
+            _profiler.start_sampling(interval=0, allocation_interval=1024)
+            foo()
+            _profiler.stop_sampling()
+            _profiler.dump_folded(f"{temp_dir}/profile.folded", allocations=True)
+
+            with open(f"{temp_dir}/profile.folded") as fp:
+                lines = fp.read().splitlines()
+
+        self.assertTrue(lines)
+        self.assertTrue(
+            any(
+                ".<locals>.foo;" in line and ".<locals>.allocate" in line
+                for line in lines
+            )
+        )
+        for line in lines:
+            stack, weight = line.rsplit(" ", 1)
+            self.assertTrue(stack)
+            self.assertEqual(int(weight) % 1024, 0)
+
+    def test_dump_sampled_callgrind_writes_file(self):
+        def allocate():
+            return [[i] for i in range(1000)]
+
+        with TemporaryDirectory() as temp_dir:
+            _profiler.start_sampling(allocation_interval=1024)
+            allocate()
+            _profiler.stop_sampling()
+            _profiler.dump_sampled_callgrind(f"{temp_dir}/profile.cg")
+
+            with open(f"{temp_dir}/profile.cg") as fp:
+                contents = fp.read()
+
+        self.assertTrue(contents.startswith("# callgrind format\n"))
+        self.assertIn("events: Samples Bytes\n", contents)
+        self.assertRegex(
+            contents,
+            "fn=\\([0-9]+\\) __main__.SamplingProfilerTest."
+            "test_dump_sampled_callgrind_writes_file.<locals>.allocate\n",
+        )
+
+    def test_dump_clears_samples(self):
+        with TemporaryDirectory() as temp_dir:
+            _profiler.start_sampling(interval=0, allocation_interval=1024)
+            [[i] for i in range(1000)]
+            _profiler.stop_sampling()
+            _profiler.dump_folded(f"{temp_dir}/first", allocations=True)
+            _profiler.dump_folded(f"{temp_dir}/second", allocations=True)
+            with open(f"{temp_dir}/second") as fp:
+                self.assertEqual(fp.read(), "")
+
+    def test_start_sampling_with_negative_interval_raises_value_error(self):
+        with self.assertRaises(ValueError):
+            _profiler.start_sampling(interval=-1)
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,422 @@
+# Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+# Regular expression matching for the re module. The patterns compiled by
+# sre_compile are matched by the engine in runtime/under-sre-module.cpp; this
+# module wraps its results into Pattern and Match objects.
+from builtins import _index, callable_iterator as _callable_iterator
+from sys import maxsize as _maxsize
+
+from _builtins import (
+    _builtin,
+    _byteslike_check,
+    _bytes_check,
+    _int_check,
+    _str_check,
+)
+
+
+MAGIC = 20171005
+
+CODESIZE = 4
+
+MAXREPEAT = 4294967295
+
+MAXGROUPS = 2147483647
+
+copyright = " SRE 2.2.2 Copyright (c) 1997-2002 by Secret Labs AB "
+
+_KIND_STR = 0
+_KIND_BYTES = 1
+_KIND_ANY = 2
+
+_MATCH = 0
+_FULLMATCH = 1
+_SEARCH = 2
+
+_FLAG_NAMES = (
+    ("re.TEMPLATE", 1),
+    ("re.IGNORECASE", 2),
+    ("re.LOCALE", 4),
+    ("re.MULTILINE", 8),
+    ("re.DOTALL", 16),
+    ("re.UNICODE", 32),
+    ("re.VERBOSE", 64),
+    ("re.DEBUG", 128),
+    ("re.ASCII", 256),
+)
+_FLAG_LOCALE = 4
+_FLAG_UNICODE = 32
+_FLAG_ASCII = 256
+
+_mappingproxy = type(type.__dict__)
+
+
+def _pack_code(code, groups, kind):
+    _builtin()
+
+
+def _match(code, string, pos, endpos, start, mode, must_advance):
+    _builtin()
+
+
+def _findall(code, string, pos, endpos):
+    _builtin()
+
+
+def _split(code, string, maxsplit):
+    _builtin()
+
+
+def _sub(code, template, string, count):
+    _builtin()
+
+
+def _getslice(string, start, end):
+    _builtin()
+
+
+def ascii_iscased(character):
+    _builtin()
+
+
+def ascii_tolower(character):
+    _builtin()
+
+
+def unicode_iscased(character):
+    _builtin()
+
+
+def unicode_tolower(character):
+    _builtin()
+
+
+def getcodesize():
+    return CODESIZE
+
+
+def compile(pattern, flags, code, groups, groupindex, indexgroup):
+    if pattern is None:
+        kind = _KIND_ANY
+    elif _str_check(pattern):
+        kind = _KIND_STR
+    elif _byteslike_check(pattern):
+        kind = _KIND_BYTES
+    else:
+        raise TypeError("expected string or bytes-like object")
+    result = object.__new__(Pattern)
+    result.pattern = pattern
+    result.flags = flags
+    result.groups = groups
+    result._code = _pack_code(code, groups, kind)
+    result._groupindex = groupindex
+    result._indexgroup = indexgroup
+    return result
+
+
+def _new_match(pattern, string, regs):
+    result = object.__new__(Match)
+    result.re = pattern
+    result.string = string
+    result._regs = regs
+    return result
+
+
+def _compile_template(pattern, repl):
+    import re
+
+    groups, literals = re._compile_repl(repl, pattern)
+    if not groups and len(literals) == 1:
+        return literals[0]
+    # Literals and group numbers, which _sub() expands natively.
+    parts = list(literals)
+    for index, group in groups:
+        parts[index] = group
+    return tuple(parts)
+
+
+def _sub_with_callable(pattern, repl, string, count):
+    code = pattern._code
+    pieces = []
+    n = 0
+    last = 0
+    must_advance = False
+    while not count or n < count:
+        regs = _match(code, string, 0, _maxsize, last, _SEARCH, must_advance)
+        if regs is None:
+            break
+        start = regs[0]
+        end = regs[1]
+        if last < start:
+            pieces.append(_getslice(string, last, start))
+        item = repl(_new_match(pattern, string, regs))
+        if item is not None:
+            pieces.append(item)
+        n += 1
+        must_advance = start == end
+        last = end
+    pieces.append(_getslice(string, last, _maxsize))
+    empty = "" if _str_check(string) else b""
+    return empty.join(pieces), n
+
+
+class Pattern:
+    __slots__ = (
+        "pattern",
+        "flags",
+        "groups",
+        "_code",
+        "_groupindex",
+        "_indexgroup",
+        "__weakref__",
+    )
+
+    __module__ = "re"
+
+    def __init__(self, *args, **kwargs):
+        raise TypeError("cannot create 're.Pattern' instances")
+
+    def __copy__(self):
+        return self
+
+    def __deepcopy__(self, memo):
+        return self
+
+    def __eq__(self, other):
+        if not isinstance(other, Pattern):
+            return NotImplemented
+        return self is other or (
+            self.flags == other.flags
+            and self._code == other._code
+            and self.pattern == other.pattern
+        )
+
+    def __hash__(self):
+        return hash((self.pattern, self.flags, self._code))
+
+    def __repr__(self):
+        flags = self.flags
+        # Omit re.UNICODE for string patterns, where it is the default.
+        if (
+            _str_check(self.pattern)
+            and flags & (_FLAG_LOCALE | _FLAG_UNICODE | _FLAG_ASCII) == _FLAG_UNICODE
+        ):
+            flags &= ~_FLAG_UNICODE
+        names = []
+        for name, value in _FLAG_NAMES:
+            if flags & value:
+                names.append(name)
+                flags &= ~value
+        if flags:
+            names.append(hex(flags))
+        pattern = repr(self.pattern)[:200]
+        if names:
+            return f"re.compile({pattern}, {'|'.join(names)})"
+        return f"re.compile({pattern})"
+
+    def findall(self, string, pos=0, endpos=_maxsize):
+        return _findall(self._code, string, _index(pos), _index(endpos))
+
+    def finditer(self, string, pos=0, endpos=_maxsize):
+        return _callable_iterator(self.scanner(string, pos, endpos).search, None)
+
+    def fullmatch(self, string, pos=0, endpos=_maxsize):
+        pos = _index(pos)
+        regs = _match(self._code, string, pos, _index(endpos), pos, _FULLMATCH, False)
+        if regs is None:
+            return None
+        return _new_match(self, string, regs)
+
+    @property
+    def groupindex(self):
+        return _mappingproxy(self._groupindex)
+
+    def match(self, string, pos=0, endpos=_maxsize):
+        pos = _index(pos)
+        regs = _match(self._code, string, pos, _index(endpos), pos, _MATCH, False)
+        if regs is None:
+            return None
+        return _new_match(self, string, regs)
+
+    def scanner(self, string, pos=0, endpos=_maxsize):
+        if not _str_check(string) and not _byteslike_check(string):
+            raise TypeError("expected string or bytes-like object")
+        result = object.__new__(Scanner)
+        result.pattern = self
+        result._string = string
+        result._pos = _index(pos)
+        result._endpos = _index(endpos)
+        result._start = result._pos
+        result._must_advance = False
+        return result
+
+    def search(self, string, pos=0, endpos=_maxsize):
+        pos = _index(pos)
+        regs = _match(self._code, string, pos, _index(endpos), pos, _SEARCH, False)
+        if regs is None:
+            return None
+        return _new_match(self, string, regs)
+
+    def split(self, string, maxsplit=0):
+        return _split(self._code, string, _index(maxsplit))
+
+    def sub(self, repl, string, count=0):
+        return self._subx(repl, string, count)[0]
+
+    def subn(self, repl, string, count=0):
+        return self._subx(repl, string, count)
+
+    def _subx(self, repl, string, count):
+        count = _index(count)
+        if callable(repl):
+            return _sub_with_callable(self, repl, string, count)
+        if _str_check(repl):
+            template = repl if "\\" not in repl else None
+        elif _bytes_check(repl):
+            template = repl if b"\\" not in repl else None
+        elif _byteslike_check(repl):
+            template = repl if b"\\" not in bytes(repl) else None
+        else:
+            template = None
+        if template is None:
+            template = _compile_template(self, repl)
+        return _sub(self._code, template, string, count)
+
+
+class Match:
+    __slots__ = ("re", "string", "_regs")
+
+    __module__ = "re"
+
+    def __init__(self, *args, **kwargs):
+        raise TypeError("cannot create 're.Match' instances")
+
+    def __copy__(self):
+        return self
+
+    def __deepcopy__(self, memo):
+        return self
+
+    def __getitem__(self, group):
+        return self._group(self._group_index(group), None)
+
+    def __repr__(self):
+        regs = self._regs
+        match = repr(self._group(0, None))[:50]
+        return f"<re.Match object; span=({regs[0]}, {regs[1]}), match={match}>"
+
+    def end(self, group=0):
+        return self._regs[self._group_index(group) * 2 + 1]
+
+    @property
+    def endpos(self):
+        return self._regs[-1]
+
+    def expand(self, template):
+        import re
+
+        return re._expand(self.re, self, template)
+
+    def group(self, *args):
+        if not args:
+            return self._group(0, None)
+        if len(args) == 1:
+            return self._group(self._group_index(args[0]), None)
+        return tuple(self._group(self._group_index(group), None) for group in args)
+
+    def groupdict(self, default=None):
+        return {
+            name: self._group(self._group_index(name), default)
+            for name in self.re._groupindex
+        }
+
+    def groups(self, default=None):
+        return tuple(
+            self._group(index, default) for index in range(1, self.re.groups + 1)
+        )
+
+    @property
+    def lastgroup(self):
+        indexgroup = self.re._indexgroup
+        lastindex = self._regs[-3]
+        if indexgroup is None or lastindex < 0:
+            return None
+        try:
+            return indexgroup[lastindex]
+        except IndexError:
+            return None
+
+    @property
+    def lastindex(self):
+        lastindex = self._regs[-3]
+        return None if lastindex < 0 else lastindex
+
+    @property
+    def pos(self):
+        return self._regs[-2]
+
+    @property
+    def regs(self):
+        regs = self._regs
+        return tuple(
+            (regs[index], regs[index + 1])
+            for index in range(0, self.re.groups * 2 + 2, 2)
+        )
+
+    def span(self, group=0):
+        index = self._group_index(group) * 2
+        return self._regs[index], self._regs[index + 1]
+
+    def start(self, group=0):
+        return self._regs[self._group_index(group) * 2]
+
+    def _group(self, index, default):
+        start = self._regs[index * 2]
+        if start < 0:
+            return default
+        return _getslice(self.string, start, self._regs[index * 2 + 1])
+
+    def _group_index(self, group):
+        if not _int_check(group):
+            if _str_check(group):
+                group = self.re._groupindex.get(group, -1)
+            else:
+                try:
+                    group = _index(group)
+                except TypeError:
+                    try:
+                        group = self.re._groupindex.get(group, -1)
+                    except TypeError:
+                        group = -1
+        if group < 0 or group > self.re.groups:
+            raise IndexError("no such group")
+        return group
+
+
+class Scanner:
+    __slots__ = ("pattern", "_string", "_pos", "_endpos", "_start", "_must_advance")
+
+    def match(self):
+        return self._next(_MATCH)
+
+    def search(self):
+        return self._next(_SEARCH)
+
+    def _next(self, mode):
+        start = self._start
+        if start is None:
+            return None
+        regs = _match(
+            self.pattern._code,
+            self._string,
+            self._pos,
+            self._endpos,
+            start,
+            mode,
+            self._must_advance,
+        )
+        if regs is None:
+            self._start = None
+            return None
+        self._must_advance = regs[1] == regs[0]
+        self._start = regs[1]
+        return _new_match(self.pattern, self._string, regs)
@@ -7,9 +7,6 @@ import time
 import unittest
 
 
-_thread._enable_threads = True
-
-
 class UnderThreadTest(unittest.TestCase):
     def test_start_new_thread_returns_new_thread(self):
         def bootstrap():
@@ -40,6 +37,30 @@ Traceback \(most recent call last\):
 RuntimeError""",
             )
 
+    def test_start_new_thread_runs_threads_in_parallel_with_gc(self):
+        import gc
+
+        num_threads = 4
+        results = [None] * num_threads
+
+        def bootstrap(index):
+            total = 0
+            for i in range(20000):
+                item = [index, i, str(i)]
+                total += item[1] + len(item[2])
+                if i % 5000 == 0:
+                    gc.collect()
+            results[index] = total
+
+        for index in range(num_threads):
+            _thread.start_new_thread(bootstrap, (index,))
+        deadline = time.monotonic() + 60
+        while None in results and time.monotonic() < deadline:
+            time.sleep(0.01)
+
+        expected = sum(i + len(str(i)) for i in range(20000))
+        self.assertEqual(results, [expected] * num_threads)
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -4594,10 +4594,16 @@ class int(bootstrap=True):
         if modulo == 1:
             return 0
         if modulo is None:
-            result = self
-            while int.__gt__(other, 1):
-                result = int.__mul__(result, self)
-                other = int.__sub__(other, 1)
+            # Square-and-multiply; squaring an int with itself takes the
+            # dedicated squaring path of the multiplication.
+            result = 1
+            while True:
+                if int.__and__(other, 1):
+                    result = int.__mul__(result, self)
+                other = int.__rshift__(other, 1)
+                if not other:
+                    break
+                self = int.__mul__(self, self)
         else:
             result = 1
             self = int.__mod__(self, modulo)
@@ -50,6 +50,26 @@ class IntTests(unittest.TestCase):
         self.assertEqual(int.__hash__(value), 2278332794247153219)
         self.assertEqual(int.__hash__(-value), -2278332794247153219)
 
+    def test_dunder_mul_with_large_ints_matches_digitwise_product(self):
+        def digitwise_mul(x, y):
+            result = 0
+            shift = 0
+            while y:
+                result += (x * (y & 0xFFFF)) << shift
+                y >>= 16
+                shift += 16
+            return result
+
+        x = 0x9E3779B97F4A7C15 ** 45
+        y = 0xC2B2AE3D27D4EB4F ** 90
+        for left, right in ((x, y), (y, x), (-x, y), (x, -y), (-x, -y)):
+            expected = digitwise_mul(abs(left), abs(right))
+            if (left < 0) != (right < 0):
+                expected = -expected
+            self.assertEqual(int.__mul__(left, right), expected)
+        self.assertEqual(int.__mul__(y, y), digitwise_mul(y, y))
+        self.assertEqual(int.__mul__(-y, -y), digitwise_mul(y, y))
+
     def test_dunder_new_with_bool_class_raises_type_error(self):
         with self.assertRaisesRegex(
             TypeError, r"int\.__new__\(bool\) is not safe.*bool\.__new__\(\)"
@@ -206,6 +226,14 @@ class IntTests(unittest.TestCase):
         self.assertEqual(int.__new__(int, "-abc", 16), -0xABC)
         self.assertEqual(int.__new__(int, "0xabc", 0), 0xABC)
 
+    def test_dunder_new_with_long_str_returns_int(self):
+        digits = "1234567890" * 500
+        self.assertEqual(str(int(digits)), digits)
+        self.assertEqual(str(int("-" + digits)), "-" + digits)
+        self.assertEqual(int("9" * 3000), 10 ** 3000 - 1)
+        self.assertEqual(int("f" * 2000, 16), (1 << 8000) - 1)
+        self.assertEqual(int(b"1" * 1000, 2), (1 << 1000) - 1)
+
     def test_dunder_new_with_zero_args_returns_zero(self):
         self.assertIs(int.__new__(int), 0)
 
@@ -242,6 +270,18 @@ class IntTests(unittest.TestCase):
     def test_dunder_pow_with_non_int_power_returns_not_implemented(self):
         self.assertEqual(int.__pow__(1, None), NotImplemented)
 
+    def test_dunder_pow_with_large_power_returns_int(self):
+        result = 1
+        for _ in range(1000):
+            result *= 3
+        self.assertEqual(int.__pow__(3, 1000), result)
+        self.assertEqual(int.__pow__(-3, 1001), -3 * result)
+
+    def test_dunder_pow_with_bool_self_returns_int(self):
+        result = int.__pow__(True, 1)
+        self.assertIs(type(result), int)
+        self.assertEqual(result, 1)
+
     def test_dunder_truediv_with_non_int_raises_type_error(self):
         self.assertRaisesRegex(
             TypeError,
@@ -85,6 +85,21 @@ class StrTests(unittest.TestCase):
         self.assertEqual(s[1:8:2], " \xa921")
         self.assertEqual(s[-1:3:-3], "\nn,ecU1 ")
 
+    def test_dunder_getitem_with_long_non_ascii_str_indexes_by_code_point(self):
+        chars = ["a", "\xe9", "\u20ac", "\U0001f600"]
+        codes = [chars[i % 4] for i in range(300)]
+        s = "".join(codes)
+        self.assertEqual(len(s), 300)
+        for i in (0, 1, 63, 64, 65, 128, 255, 256, 299):
+            self.assertEqual(s[i], codes[i])
+            self.assertEqual(s[i - 300], codes[i])
+        self.assertEqual(s[62:70], "".join(codes[62:70]))
+        self.assertEqual(s[-70:-62], "".join(codes[-70:-62]))
+        self.assertEqual(s[::97], "".join(codes[::97]))
+        self.assertEqual(s.find("\U0001f600", 100), 103)
+        with self.assertRaises(IndexError):
+            s[300]
+
     def test_dunder_getitem_with_slice_uses_adjusted_bounds(self):
         s = "hello world"
         self.assertEqual(s[-20:5], "hello")
@@ -16,6 +16,56 @@ class OrderedDictTests(unittest.TestCase):
         k, v = d.popitem()
         self.assertEqual((k, v), ("b", 1))
 
+    def test_move_to_end_with_last_false_moves_key_to_front(self):
+        d = OrderedDict({"d": 2, "b": 1, "z": 0})
+        d.move_to_end("z", last=False)
+        self.assertEqual(list(d), ["z", "d", "b"])
+        d.move_to_end("b", last=False)
+        self.assertEqual(list(d.items()), [("b", 1), ("z", 0), ("d", 2)])
+
+    def test_move_to_end_with_missing_key_raises_key_error(self):
+        d = OrderedDict({"a": 1})
+        with self.assertRaises(KeyError) as context:
+            d.move_to_end("b")
+        self.assertEqual(context.exception.args, ("b",))
+        with self.assertRaises(KeyError):
+            d.move_to_end("b", last=False)
+
+    def test_move_to_end_repeatedly_preserves_order(self):
+        d = OrderedDict.fromkeys(range(5))
+        for i in range(1000):
+            d.move_to_end(i % 5, last=i % 3 != 0)
+            d[i % 7] = i
+        expected = list(range(5))
+        for i in range(1000):
+            key = i % 5
+            expected.remove(key)
+            if i % 3 != 0:
+                expected.append(key)
+            else:
+                expected.insert(0, key)
+            if i % 7 not in expected:
+                expected.append(i % 7)
+        self.assertEqual(list(d), expected)
+
+    def test_popitem_with_last_false_returns_first_item(self):
+        d = OrderedDict({"d": 2, "b": 1, "z": 0})
+        self.assertEqual(d.popitem(last=False), ("d", 2))
+        self.assertEqual(d.popitem(), ("z", 0))
+        self.assertEqual(d.popitem(False), ("b", 1))
+        with self.assertRaises(KeyError):
+            d.popitem(last=False)
+
+    def test_popitem_with_last_false_after_churn_returns_items_in_order(self):
+        d = OrderedDict()
+        result = []
+        for i in range(100):
+            d[i] = i
+            if len(d) > 3:
+                result.append(d.popitem(last=False)[0])
+        self.assertEqual(result, list(range(97)))
+        self.assertEqual(list(d), [97, 98, 99])
+
 
 class DefaultdictTests(unittest.TestCase):
     def test_dunder_init_returns_dict_subclass(self):
@@ -3,11 +3,8 @@
 """Functional tools for creating and using iterators."""
 # TODO(T42113424) Replace stubs with an actual implementation
 
-import operator
-from builtins import _number_check
-
 from _builtins import (
-    _int_check,
+    _builtin,
     _int_guard,
     _list_len,
     _list_new,
@@ -17,35 +14,16 @@ from _builtins import (
 )
 
 
-class accumulate:
+class accumulate(bootstrap=True):
     def __iter__(self):
         return self
 
-    def __new__(cls, iterable, func=None, initial=None):
-        result = object.__new__(cls)
-        result._it = iter(iterable)
-        result._func = operator.add if func is None else func
-        result._initial = initial
-        result._accumulated = None
-        return result
+    @staticmethod
+    def __new__(cls, iterable, func=None, *, initial=None):
+        _builtin()
 
     def __next__(self):
-        initial = self._initial
-        if initial is not None:
-            self._accumulated = initial
-            self._initial = None
-            return initial
-
-        result = self._accumulated
-
-        if result is None:
-            result = next(self._it)
-            self._accumulated = result
-            return result
-
-        result = self._func(result, next(self._it))
-        self._accumulated = result
-        return result
+        _builtin()
 
     def __reduce__(self):
         _unimplemented()
@@ -54,29 +32,16 @@ class accumulate:
         _unimplemented()
 
 
-class chain:
+class chain(bootstrap=True):
     def __iter__(self):
         return self
 
+    @staticmethod
     def __new__(cls, *iterables):
-        result = object.__new__(cls)
-        result._it = None
-        result._iterables = iter(iterables)
-        return result
+        _builtin()
 
     def __next__(self):
-        while True:
-            if self._it is None:
-                try:
-                    self._it = iter(next(self._iterables))
-                except StopIteration:
-                    raise
-            try:
-                result = next(self._it)
-            except StopIteration:
-                self._it = None
-                continue
-            return result
+        _builtin()
 
     def __reduce__(self):
         _unimplemented()
@@ -86,10 +51,7 @@ class chain:
 
     @classmethod
     def from_iterable(cls, iterable):
-        result = object.__new__(cls)
-        result._it = None
-        result._iterables = iter(iterable)
-        return result
+        _builtin()
 
 
 class combinations:
@@ -246,29 +208,22 @@ class compress:
         _unimplemented()
 
 
-class count:
+class count(bootstrap=True):
     def __iter__(self):
         return self
 
+    @staticmethod
     def __new__(cls, start=0, step=1):
-        if not _number_check(start):
-            raise TypeError("a number is required")
-
-        result = object.__new__(cls)
-        result.count = start
-        result.step = step
-        return result
+        _builtin()
 
     def __next__(self):
-        result = self.count
-        self.count += self.step
-        return result
+        _builtin()
 
     def __reduce__(self):
         _unimplemented()
 
     def __repr__(self):
-        return f"count({self.count})"
+        _builtin()
 
 
 class cycle:
@@ -350,126 +305,49 @@ class filterfalse:
         _unimplemented()
 
 
-# internal helper class for groupby
-class _groupby_iterator:
+class _grouper(bootstrap=True):
     def __iter__(self):
         return self
 
-    def __new__(cls, parent, cur):
-
-        obj = object.__new__(cls)
-        obj._parent = parent
-        obj._currkey = cur
-        return obj
+    @staticmethod
+    def __new__(cls, *args, **kwargs):
+        raise TypeError("cannot create 'itertools._grouper' instances")
 
     def __next__(self):
-        parent = self._parent
-        if parent._currkey == self._currkey:
-            val = parent._currval
-            try:
-                parent._currval = next(parent._it)
-                parent._currkey = (
-                    parent._currval
-                    if parent._keyfunc is None
-                    else parent._keyfunc(parent._currval)
-                )
-            except StopIteration:
-                parent._currkey = _Unbound
-            return val
-        raise StopIteration
+        _builtin()
+
+    def __reduce__(self):
+        _unimplemented()
 
 
-class groupby:
+class groupby(bootstrap=True):
     def __iter__(self):
         return self
 
+    @staticmethod
     def __new__(cls, iterable, key=None):
-
-        obj = object.__new__(cls)
-        obj._it = iter(iterable)
-        obj._tgtkey = obj._currkey = obj._currval = _Unbound
-        obj._keyfunc = key
-        return obj
+        _builtin()
 
     def __next__(self):
-        # In middle of previous iterator
-        while self._currkey == self._tgtkey:
-            self._currval = next(self._it)
-            self._currkey = (
-                self._currval if self._keyfunc is None else self._keyfunc(self._currval)
-            )
-        if self._currkey is _Unbound:
-            raise StopIteration
-        # remember group of returned iterator
-        self._tgtkey = self._currkey
-        return self._currkey, _groupby_iterator(self, self._currkey)
+        _builtin()
+
+    def __reduce__(self):
+        _unimplemented()
 
+    def __setstate__(self):
+        _unimplemented()
 
-class islice:
-    def __new__(cls, seq, stop_or_start, stop=_Unbound, step=_Unbound):
-        result = object.__new__(cls)
-        result._it = iter(seq)
-        result._count = 0
-        if stop is _Unbound:
-            start = 0
-            stop = stop_or_start
-            step = 1
-        else:
-            start = 0 if stop_or_start is None else stop_or_start
-            if step is _Unbound or step is None:
-                step = 1
-            elif not _int_check(step) or step < 1:
-                raise ValueError(
-                    "Step for islice() must be a positive integer or None."
-                )
-        if stop is None:
-            stop = -1
-        elif not _int_check(stop) or stop == -1:
-            raise ValueError(
-                "Stop argument for islice() must be None or an "
-                "integer: 0 <= x <= sys.maxsize."
-            )
-        if not _int_check(start) or start < 0 or stop < -1:
-            raise ValueError(
-                "Indices for islice() must be None or an integer: "
-                "0 <= x <= sys.maxsize."
-            )
-        result._next = start
-        result._stop = stop
-        result._step = step
-        return result
 
+class islice(bootstrap=True):
     def __iter__(self):
         return self
 
+    @staticmethod
+    def __new__(cls, seq, stop_or_start, stop=_Unbound, step=_Unbound):
+        _builtin()
+
     def __next__(self):
-        it = self._it
-        if it is None:
-            raise StopIteration
-        count = self._count
-        new_next = self._next
-        while count < new_next:
-            try:
-                next(it)
-            except Exception as exc:
-                self._it = None
-                raise exc
-            count += 1
-        stop = self._stop
-        if count >= stop and stop != -1:
-            self._it = None
-            raise StopIteration
-        try:
-            item = next(it)
-        except Exception as exc:
-            self._it = None
-            raise exc
-        self._count = count + 1
-        new_next += self._step
-        if new_next > stop and stop != -1:
-            new_next = stop
-        self._next = new_next
-        return item
+        _builtin()
 
     def __reduce__(self):
         _unimplemented()
@@ -538,53 +416,16 @@ class permutations:
         _unimplemented()
 
 
-class product:
+class product(bootstrap=True):
     def __iter__(self):
         return self
 
+    @staticmethod
     def __new__(cls, *iterables, repeat=1):
-        if not _int_check(repeat):
-            raise TypeError
-        length = _tuple_len(iterables) if repeat else 0
-        i = 0
-        repeated = _list_new(length)
-        result = object.__new__(cls)
-        while i < length:
-            item = tuple(iterables[i])
-            if not item:
-                result._iterables = None
-                return result
-            repeated[i] = item
-            i += 1
-        repeated *= repeat
-        result._iterables = repeated
-        result._digits = _list_new(length * repeat, 0)
-        return result
+        _builtin()
 
     def __next__(self):
-        iterables = self._iterables
-        if iterables is None:
-            raise StopIteration
-        digits = self._digits
-        length = _list_len(iterables)
-        result = _list_new(length)
-        i = length - 1
-        carry = 1
-        while i >= 0:
-            j = digits[i]
-            result[i] = iterables[i][j]
-            j += carry
-            if j < _tuple_len(iterables[i]):
-                carry = 0
-                digits[i] = j
-            else:
-                carry = 1
-                digits[i] = 0
-            i -= 1
-        if carry:
-            # counter overflowed, stop iteration
-            self._iterables = None
-        return tuple(result)
+        _builtin()
 
     def __reduce__(self):
         _unimplemented()
@@ -596,34 +437,25 @@ class product:
         _unimplemented()
 
 
-class repeat:
+class repeat(bootstrap=True):
     def __iter__(self):
         return self
 
-    def __new__(cls, elem, times=None):
-        result = object.__new__(cls)
-        result._elem = elem
-        if times is not None:
-            _int_guard(times)
-        result._times = times
-        return result
+    def __length_hint__(self):
+        _builtin()
 
-    def __next__(self):
-        if self._times is None:
-            return self._elem
-        if self._times > 0:
-            self._times -= 1
-            return self._elem
-        raise StopIteration
+    @staticmethod
+    def __new__(cls, object, times=None):
+        _builtin()
 
-    def __length_hint__(self):
-        _unimplemented()
+    def __next__(self):
+        _builtin()
 
     def __reduce__(self):
         _unimplemented()
 
     def __repr__(self):
-        _unimplemented()
+        _builtin()
 
 
 class starmap:
@@ -652,65 +484,24 @@ def tee(iterable, n=2):
         return ()
 
     it = iter(iterable)
-    copyable = it if hasattr(it, "__copy__") else _tee.from_iterable(it)
+    copyable = it if hasattr(it, "__copy__") else _tee(it)
     copyfunc = copyable.__copy__
     return tuple(copyable if i == 0 else copyfunc() for i in range(n))
 
 
-# Internal cache for tee, a linked list where each link is a cached window to
-# a section of the source iterator
-class _tee_dataobject:
-    # CPython sets this at 57 to align exactly with cache line size. We choose
-    # 55 to align with cache lines in our system: Arrays <=255 elements have 1
-    # word of header. The header and each data element is 8 bytes on a 64-bit
-    # machine.  Cache lines are 64-bytes on all x86 machines though they tend to
-    # be fetched in pairs, so any multiple of 8 minus 1 up to 255 is fine.
-    _MAX_VALUES = 55
-
-    def __init__(self, it):
-        self._num_read = 0
-        self._next_link = _Unbound
-        self._it = it
-        self._values = []
-
-    def get_item(self, i):
-        assert i < self.__class__._MAX_VALUES
-
-        if i < self._num_read:
-            return self._values[i]
-        else:
-            assert i == self._num_read
-            value = next(self._it)
-            self._num_read += 1
-            # mutable tuple might be a nice future optimization here
-            self._values.append(value)
-            return value
-
-    def next_link(self):
-        if self._next_link is _Unbound:
-            self._next_link = self.__class__(self._it)
-        return self._next_link
-
-
-class _tee:
+class _tee(bootstrap=True):
     def __copy__(self):
-        return self.__class__(self._data, self._index)
-
-    def __init__(self, data, index):
-        self._data = data
-        self._index = index
+        _builtin()
 
     def __iter__(self):
         return self
 
-    def __next__(self):
-        if self._index >= _tee_dataobject._MAX_VALUES:
-            self._data = self._data.next_link()
-            self._index = 0
+    @staticmethod
+    def __new__(cls, iterable):
+        _builtin()
 
-        value = self._data.get_item(self._index)
-        self._index += 1
-        return value
+    def __next__(self):
+        _builtin()
 
     def __reduce__(self):
         _unimplemented()
@@ -718,14 +509,14 @@ class _tee:
     def __setstate__(self):
         _unimplemented()
 
-    @classmethod
-    def from_iterable(cls, iterable):
-        it = iter(iterable)
 
-        if isinstance(it, _tee):
-            return it.__copy__()
-        else:
-            return cls(_tee_dataobject(it), 0)
+class _tee_dataobject(bootstrap=True):
+    @staticmethod
+    def __new__(cls, *args, **kwargs):
+        raise TypeError("cannot create 'itertools._tee_dataobject' instances")
+
+    def __reduce__(self):
+        _unimplemented()
 
 
 class takewhile:
@@ -757,34 +548,16 @@ class takewhile:
         _unimplemented()
 
 
-class zip_longest:
+class zip_longest(bootstrap=True):
     def __iter__(self):
         return self
 
+    @staticmethod
     def __new__(cls, *seqs, fillvalue=None):
-        length = _tuple_len(seqs)
-        result = object.__new__(cls)
-        result._iters = [iter(seq) for seq in seqs]
-        result._num_iters = length
-        result._num_active = length
-        result._fillvalue = fillvalue
-        return result
+        _builtin()
 
     def __next__(self):
-        iters = self._iters
-        if not self._num_active:
-            raise StopIteration
-        fillvalue = self._fillvalue
-        values = _list_new(self._num_iters, fillvalue)
-        for i, it in enumerate(iters):
-            try:
-                values[i] = next(it)
-            except StopIteration:
-                self._num_active -= 1
-                if not self._num_active:
-                    raise
-                self._iters[i] = repeat(fillvalue)
-        return tuple(values)
+        _builtin()
 
     def __reduce__(self):
         _unimplemented()
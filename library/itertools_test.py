@@ -2,6 +2,7 @@
 # Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
 import itertools
 import operator
+import sys
 import unittest
 from unittest.mock import Mock
 
@@ -58,6 +59,26 @@ class ChainTests(unittest.TestCase):
             ("1", "2", "3", "4", "5", "6"),
         )
 
+    def test_chain_in_for_loop_yields_all_items(self):
+        result = []
+        for item in itertools.chain([1, 2], (), "ab", range(3, 5)):
+            result.append(item)
+        self.assertEqual(result, [1, 2, "a", "b", 3, 4])
+
+    def test_from_iterable_with_subclass_returns_subclass_instance(self):
+        class C(itertools.chain):
+            pass
+
+        result = C.from_iterable(["ab", "c"])
+        self.assertIsInstance(result, C)
+        self.assertEqual(list(result), ["a", "b", "c"])
+
+    def test_dunder_next_with_non_iterable_item_raises_type_error(self):
+        result = itertools.chain([1], 2)
+        self.assertEqual(next(result), 1)
+        with self.assertRaisesRegex(TypeError, "'int' object is not iterable"):
+            next(result)
+
 
 class CycleTests(unittest.TestCase):
     def test_dunder_init_with_seq_does_calls_dunder_iter(self):
@@ -112,6 +133,23 @@ class CountTests(unittest.TestCase):
         with self.assertRaisesRegex(TypeError, "a number is required"):
             itertools.count(start="a", step=".")
 
+    def test_count_with_float_step_returns_floats(self):
+        iterator = itertools.count(1, 0.5)
+        self.assertEqual([next(iterator) for _ in range(3)], [1, 1.5, 2.0])
+
+    def test_count_past_small_int_range_returns_large_ints(self):
+        iterator = itertools.count(2 ** 62 - 2)
+        self.assertEqual(
+            [next(iterator) for _ in range(3)], [2 ** 62 - 2, 2 ** 62 - 1, 2 ** 62]
+        )
+
+    def test_dunder_repr_returns_str(self):
+        self.assertEqual(repr(itertools.count()), "count(0)")
+        self.assertEqual(repr(itertools.count(5, 2)), "count(5, 2)")
+        iterator = itertools.count(1.5, 1)
+        next(iterator)
+        self.assertEqual(repr(iterator), "count(2.5)")
+
 
 class IsliceTests(unittest.TestCase):
     def test_too_few_arguments_raises_type_error(self):
@@ -296,6 +334,32 @@ class IsliceTests(unittest.TestCase):
             next(islice)
         self.assertEqual(str(ctx.exception), "Called with 5")
 
+    def test_slice_with_maxsize_stop_returns_all_items(self):
+        islice = itertools.islice([0, 1, 2], 1, sys.maxsize)
+        self.assertEqual(list(islice), [1, 2])
+
+    def test_slice_in_for_loop_respects_slice(self):
+        result = []
+        for item in itertools.islice(itertools.count(), 2, 10, 3):
+            result.append(item)
+        self.assertEqual(result, [2, 5, 8])
+
+    def test_slice_after_exhaustion_does_not_call_next(self):
+        class C:
+            calls = 0
+
+            def __iter__(self):
+                return self
+
+            def __next__(self):
+                C.calls += 1
+                raise StopIteration
+
+        islice = itertools.islice(C(), 5)
+        self.assertEqual(list(islice), [])
+        self.assertEqual(list(islice), [])
+        self.assertEqual(C.calls, 1)
+
 
 class PermutationsTests(unittest.TestCase):
     def test_too_few_arguments_raises_type_error(self):
@@ -375,6 +439,23 @@ class ProductTests(unittest.TestCase):
             tuple(itertools.product("ab", "1", "!")), (("a", "1", "!"), ("b", "1", "!"))
         )
 
+    def test_negative_repeat_raises_value_error(self):
+        with self.assertRaisesRegex(ValueError, "repeat argument cannot be negative"):
+            itertools.product("ab", repeat=-1)
+
+    def test_product_in_for_loop_returns_all_combinations(self):
+        result = []
+        for item in itertools.product("ab", range(2), repeat=1):
+            result.append(item)
+        self.assertEqual(result, [("a", 0), ("a", 1), ("b", 0), ("b", 1)])
+
+    def test_product_calls_dunder_iter_on_iterables_once(self):
+        class C:
+            __iter__ = Mock(name="__iter__", return_value=[1, 2].__iter__())
+
+        self.assertEqual(len(list(itertools.product(C(), repeat=3))), 8)
+        C.__iter__.assert_called_once()
+
 
 class RepeatTests(unittest.TestCase):
     def test_dunder_init_with_non_int_times_raises_type_error(self):
@@ -401,6 +482,19 @@ class RepeatTests(unittest.TestCase):
         self.assertEqual(next(iterator), 5)
         self.assertEqual(next(iterator), 5)
 
+    def test_dunder_length_hint_returns_remaining_times(self):
+        iterator = itertools.repeat(5, 3)
+        next(iterator)
+        self.assertEqual(iterator.__length_hint__(), 2)
+
+    def test_dunder_length_hint_without_times_raises_type_error(self):
+        with self.assertRaisesRegex(TypeError, "len\\(\\) of unsized object"):
+            itertools.repeat(5).__length_hint__()
+
+    def test_dunder_repr_returns_str(self):
+        self.assertEqual(repr(itertools.repeat("a")), "repeat('a')")
+        self.assertEqual(repr(itertools.repeat("a", 2)), "repeat('a', 2)")
+
 
 class ZipLongestTests(unittest.TestCase):
     def test_dunder_init_with_no_seqs_returns_empty_iterator(self):
@@ -425,6 +519,11 @@ class ZipLongestTests(unittest.TestCase):
         right = itertools.zip_longest("ab", [1, 2, 3], fillvalue="X")
         self.assertEqual(list(right), [("a", 1), ("b", 2), ("X", 3)])
 
+    def test_dunder_next_after_exhaustion_raises_stop_iteration(self):
+        iterator = itertools.zip_longest([1], [])
+        self.assertEqual(list(iterator), [(1, None)])
+        self.assertRaises(StopIteration, next, iterator)
+
 
 class AccumulateTests(unittest.TestCase):
     def test_accumulate_with_iterable_accumulates(self):
@@ -486,6 +585,10 @@ class AccumulateTests(unittest.TestCase):
             TypeError, "'str' object is not callable", next, iterator
         )
 
+    def test_accumulate_with_none_values_calls_func(self):
+        iterator = itertools.accumulate([None, 1, None], lambda x, y: (x, y))
+        self.assertEqual(list(iterator), [None, (None, 1), ((None, 1), None)])
+
 
 class GroupbyTests(unittest.TestCase):
     def test_groupby_returns_groups(self):
@@ -560,6 +663,16 @@ class GroupbyTests(unittest.TestCase):
         self.assertEqual([5], list(next(groups)[1]))
         self.assertRaises(StopIteration, next, groups)
 
+    def test_groupby_in_for_loop_returns_groups(self):
+        result = []
+        for key, group in itertools.groupby([1, 1, 2, 3, 3, 3]):
+            result.append((key, len(list(group))))
+        self.assertEqual(result, [(1, 2), (2, 1), (3, 3)])
+
+    def test_grouper_cannot_be_created_directly(self):
+        grouper = type(next(itertools.groupby("a"))[1])
+        self.assertRaises(TypeError, grouper)
+
 
 class FilterFalseTests(unittest.TestCase):
     def test_filterfalse_with_no_predicate_returns_false_values(self):
@@ -655,6 +768,22 @@ class TeeTests(unittest.TestCase):
     def test_tee_with_n_equal_zero_returns_empty_tuple(self):
         self.assertEqual(itertools.tee([1, 2, 3, 4, 5], 0), ())
 
+    def test_tee_of_tee_shares_data(self):
+        a, b = itertools.tee(iter(range(3)))
+        next(a)
+        c, d = itertools.tee(a)
+        self.assertEqual(list(c), [1, 2])
+        self.assertEqual(list(d), [1, 2])
+        self.assertEqual(list(b), [0, 1, 2])
+
+    def test_reentrant_tee_raises_runtime_error(self):
+        def gen():
+            yield next(tees[0])
+
+        tees = itertools.tee(gen())
+        with self.assertRaisesRegex(RuntimeError, "cannot re-enter the tee iterator"):
+            next(tees[0])
+
 
 class DropWhileTests(unittest.TestCase):
     def test_dropwhile_passing_none_predicate_raises_typeerror(self):
@@ -1330,5 +1330,44 @@ class DumpsTest(unittest.TestCase):
         self.assertIn("unmarshallable object", str(context.exception))
 
 
+class DumpsVersionTest(unittest.TestCase):
+    def test_dumps_with_version_0_writes_float_as_text(self):
+        self.assertEqual(marshal.dumps(1.5, 0), b"f\x031.5")
+
+    def test_dumps_with_version_1_writes_complex_as_text(self):
+        self.assertEqual(marshal.dumps(1 + 2j, 1), b"x\x011\x012")
+
+    @pyro_only
+    def test_dumps_with_version_4_writes_short_ascii_str(self):
+        self.assertEqual(marshal.dumps("hello", 4), b"Z\x05hello")
+        length = 300
+        self.assertEqual(marshal.dumps("x" * length, 4)[:5], b"a,\x01\x00\x00")
+
+    @pyro_only
+    def test_dumps_with_version_4_writes_small_tuple(self):
+        self.assertEqual(marshal.dumps((None,), 4), b")\x01N")
+
+    def test_dumps_with_non_int_version_raises_type_error(self):
+        with self.assertRaises(TypeError):
+            marshal.dumps(None, "4")
+
+    def test_dumps_with_recursive_list_and_version_2_raises_value_error(self):
+        value = []
+        value.append(value)
+        with self.assertRaises(ValueError):
+            marshal.dumps(value, 2)
+
+    def test_loads_returns_value_passed_to_dumps(self):
+        value = (
+            [1, -(2 ** 80), 0.25, 1j, "h\xe9llo", b"bytes", None, ...],
+            {"key": (True, False)},
+            frozenset({1, 2}),
+            {"set"},
+        )
+        for version in range(5):
+            with self.subTest(version=version):
+                self.assertEqual(marshal.loads(marshal.dumps(value, version)), value)
+
+
 if __name__ == "__main__":
     unittest.main()
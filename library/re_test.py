@@ -36,5 +36,91 @@ class MatchTest(unittest.TestCase):
         self.assertEqual(re.match("abc", "dabc"), None)
 
 
+class PatternTest(unittest.TestCase):
+    def test_search_with_non_ascii_text_returns_character_span(self):
+        m = re.search("b+", "\u00e9\u00e9abbbc\U0001f40d")
+        self.assertEqual(m.span(), (3, 6))
+        self.assertEqual(m.group(), "bbb")
+
+    def test_search_with_ignorecase_matches_non_ascii(self):
+        m = re.search("\u00c9T\u00c9", "l'\u00e9t\u00e9", re.IGNORECASE)
+        self.assertEqual(m.span(), (2, 5))
+
+    def test_search_with_literal_prefix_finds_later_match(self):
+        text = "x" * 100 + "needle" + "y" * 10
+        self.assertEqual(re.search("needle", text).start(), 100)
+        self.assertIsNone(re.search("needles", text))
+
+    def test_search_with_pos_and_endpos_limits_match(self):
+        p = re.compile("a")
+        self.assertIsNone(p.search("abca", 1, 3))
+        self.assertEqual(p.search("abca", 1).span(), (3, 4))
+
+    def test_fullmatch_requires_whole_string(self):
+        self.assertIsNone(re.fullmatch("a|ab", "abc"))
+        self.assertEqual(re.fullmatch("a|ab", "ab").group(), "ab")
+
+    def test_match_with_groups_returns_groups(self):
+        m = re.match(r"(?P<first>\w+) (\w+)?(x)?", "hello world")
+        self.assertEqual(m.groups(), ("hello", "world", None))
+        self.assertEqual(m.group("first", 2), ("hello", "world"))
+        self.assertEqual(m.groupdict(), {"first": "hello"})
+        self.assertEqual(m.span(3), (-1, -1))
+        self.assertEqual(m.lastindex, 2)
+        with self.assertRaises(IndexError):
+            m.group(4)
+
+    def test_match_with_backreference_and_lookbehind(self):
+        self.assertEqual(re.search(r"(\w)\1", "abccd").group(), "cc")
+        self.assertEqual(re.search(r"(?<=\u00e9)x", "ax\u00e9x").start(), 3)
+        self.assertIsNone(re.search(r"(?<!a)x", "ax"))
+
+    def test_findall_returns_matches_or_groups(self):
+        self.assertEqual(re.findall(r"\d+", "a1b22c333"), ["1", "22", "333"])
+        self.assertEqual(re.findall(r"(\w)=(\d)", "a=1 b=2"), [("a", "1"), ("b", "2")])
+        self.assertEqual(re.findall("", "ab"), ["", "", ""])
+
+    def test_finditer_returns_match_objects(self):
+        spans = [m.span() for m in re.finditer("a*", "baa")]
+        self.assertEqual(spans, [(0, 0), (1, 3), (3, 3)])
+
+    def test_split_with_groups_keeps_separators(self):
+        self.assertEqual(re.split(r"(,)", "a,b,c"), ["a", ",", "b", ",", "c"])
+        self.assertEqual(re.split(",", "a,b,c", maxsplit=1), ["a", "b,c"])
+        self.assertEqual(re.split("x*", "ab"), ["", "a", "b", ""])
+
+    def test_sub_with_template_expands_groups(self):
+        self.assertEqual(re.sub(r"(\w+)@(\w+)", r"\2 at \1", "me@home"), "home at me")
+        self.assertEqual(re.sub(r"(?P<x>b)", r"[\g<x>]", "abc"), "a[b]c")
+        self.assertEqual(re.subn("a", "-", "banana", 2), ("b-n-na", 2))
+
+    def test_sub_with_callable_calls_it_per_match(self):
+        result = re.sub(r"\d", lambda m: str(int(m.group()) * 2), "a1b2\u00e93")
+        self.assertEqual(result, "a2b4\u00e96")
+
+    def test_sub_with_empty_matches_inserts_between_characters(self):
+        self.assertEqual(re.sub("x*", "-", "abxd"), "-a-b--d-")
+
+    def test_bytes_pattern_matches_bytes(self):
+        self.assertEqual(re.findall(rb"[a-c]+", b"xabcyba"), [b"abc", b"ba"])
+        self.assertEqual(re.sub(rb"\s+", b" ", bytearray(b"a \t b")), b"a b")
+
+    def test_mixing_str_and_bytes_raises_type_error(self):
+        with self.assertRaises(TypeError):
+            re.match("a", b"a")
+        with self.assertRaises(TypeError):
+            re.match(b"a", "a")
+
+    def test_repr_shows_pattern_and_flags(self):
+        self.assertEqual(repr(re.compile("a")), "re.compile('a')")
+        self.assertEqual(
+            repr(re.compile("a", re.I | re.M)),
+            "re.compile('a', re.IGNORECASE|re.MULTILINE)",
+        )
+        self.assertEqual(
+            repr(re.match("b", "bc")), "<re.Match object; span=(0, 1), match='b'>"
+        )
+
+
 if __name__ == "__main__":
     unittest.main()
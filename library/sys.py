@@ -156,6 +156,10 @@ def _getframe(depth=0):
     _builtin()
 
 
+def _ic_stats(function=None):
+    _builtin()
+
+
 abiflags = ""
 
 
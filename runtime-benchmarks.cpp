@@ -0,0 +1,20 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+int main(int argc, char* argv[]) {
+  // Report JSON by default so results can be compared with
+  // `benchmarks/_display_results.py`. An explicit --benchmark_format given on
+  // the command line comes later and takes precedence.
+  static char json_format[] = "--benchmark_format=json";
+  std::vector<char*> args(argv, argv + argc + 1);
+  args.insert(args.begin() + 1, json_format);
+  int num_args = argc + 1;
+  benchmark::Initialize(&num_args, args.data());
+  if (benchmark::ReportUnrecognizedArguments(num_args, args.data())) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
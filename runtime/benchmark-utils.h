@@ -0,0 +1,38 @@
+/* Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com) */
+#pragma once
+
+#include "benchmark/benchmark.h"
+
+#include "runtime.h"
+#include "test-utils.h"
+#include "thread.h"
+
+namespace py {
+
+namespace testing {
+
+// Fixture for benchmarks that need a fully initialized runtime. Creating a
+// runtime takes far longer than any single benchmark, and google-benchmark
+// calls `SetUp` for every run, so all benchmarks share one runtime.
+class RuntimeBenchmark : public benchmark::Fixture {
+ public:
+  void SetUp(benchmark::State&) override {
+    static Runtime* runtime = createTestRuntime();
+    runtime_ = runtime;
+    thread_ = runtime->mainThread();
+  }
+
+  void TearDown(benchmark::State& state) override {
+    // Do not let garbage from one benchmark skew the next. Threaded benchmarks
+    // share the runtime, so only one of their threads collects.
+    if (state.thread_index == 0) runtime_->collectGarbage();
+  }
+
+ protected:
+  Runtime* runtime_;
+  Thread* thread_;
+};
+
+}  // namespace testing
+
+}  // namespace py
@@ -299,9 +299,12 @@ bool FUNC(builtins, len_intrinsic)(Thread* thread) {
     case LayoutId::kLargeBytes:
       length = LargeBytes::cast(arg).length();
       break;
-    case LayoutId::kLargeStr:
-      length = LargeStr::cast(arg).codePointLength();
+    case LayoutId::kLargeStr: {
+      HandleScope scope(thread);
+      Str str(&scope, arg);
+      length = thread->strCodePointLength(str);
       break;
+    }
     case LayoutId::kList:
       length = List::cast(arg).numItems();
       break;
@@ -181,18 +181,18 @@ namespace py {
   V(CALL_METHOD, 161, doCallMethod)                                            \
   V(CALL_FINALLY, 162, doCallFinally)                                          \
   V(POP_FINALLY, 163, doPopFinally)                                            \
-  V(UNUSED_BYTECODE_164, 164, doInvalidBytecode)                               \
-  V(UNUSED_BYTECODE_165, 165, doInvalidBytecode)                               \
-  V(UNUSED_BYTECODE_166, 166, doInvalidBytecode)                               \
-  V(UNUSED_BYTECODE_167, 167, doInvalidBytecode)                               \
-  V(UNUSED_BYTECODE_168, 168, doInvalidBytecode)                               \
-  V(UNUSED_BYTECODE_169, 169, doInvalidBytecode)                               \
-  V(UNUSED_BYTECODE_170, 170, doInvalidBytecode)                               \
-  V(UNUSED_BYTECODE_171, 171, doInvalidBytecode)                               \
-  V(UNUSED_BYTECODE_172, 172, doInvalidBytecode)                               \
+  V(FOR_ITER_ACCUMULATE, 164, doForIterAccumulate)                             \
+  V(FOR_ITER_CHAIN, 165, doForIterChain)                                       \
+  V(FOR_ITER_COUNT, 166, doForIterCount)                                       \
+  V(FOR_ITER_GROUPBY, 167, doForIterGroupby)                                   \
+  V(FOR_ITER_ISLICE, 168, doForIterIslice)                                     \
+  V(FOR_ITER_PRODUCT, 169, doForIterProduct)                                   \
+  V(FOR_ITER_REPEAT, 170, doForIterRepeat)                                     \
+  V(FOR_ITER_TEE, 171, doForIterTee)                                           \
+  V(FOR_ITER_ZIP_LONGEST, 172, doForIterZipLongest)                            \
   V(UNUSED_BYTECODE_173, 173, doInvalidBytecode)                               \
-  V(UNUSED_BYTECODE_174, 174, doInvalidBytecode)                               \
-  V(UNUSED_BYTECODE_175, 175, doInvalidBytecode)                               \
+  V(LOAD_METHOD_MEGAMORPHIC, 174, doLoadMethodMegamorphic)                     \
+  V(LOAD_ATTR_MEGAMORPHIC, 175, doLoadAttrMegamorphic)                         \
   V(CALL_FUNCTION_TYPE_NEW, 176, doCallFunctionTypeNew)                        \
   V(CALL_FUNCTION_ANAMORPHIC, 177, doCallFunctionAnamorphic)                   \
   V(COMPARE_NE_STR, 178, doCompareNeStr)                                       \
@@ -391,11 +391,14 @@ inline bool isByteCodeWithCache(const Bytecode bc) {
     case LOAD_ATTR_INSTANCE_TYPE:
     case LOAD_ATTR_INSTANCE_TYPE_BOUND_METHOD:
     case LOAD_ATTR_INSTANCE_TYPE_DESCR:
+    case LOAD_ATTR_MEGAMORPHIC:
     case LOAD_ATTR_MODULE:
+    case LOAD_ATTR_POLYMORPHIC:
     case LOAD_ATTR_TYPE:
     case LOAD_ATTR_ANAMORPHIC:
     case LOAD_METHOD_ANAMORPHIC:
     case LOAD_METHOD_INSTANCE_FUNCTION:
+    case LOAD_METHOD_MEGAMORPHIC:
     case LOAD_METHOD_POLYMORPHIC:
     case STORE_ATTR_INSTANCE:
     case STORE_ATTR_INSTANCE_OVERFLOW:
@@ -1398,6 +1398,30 @@ TEST_F(BytesBuiltinsTest, DecodeWithASCIIReturnsString) {
   EXPECT_TRUE(isStrEqualsCStr(*result, "hello"));
 }
 
+TEST_F(BytesBuiltinsTest, DecodeWithUTF8ReturnsString) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+small = b'h\xc3\xa9'.decode('utf-8')
+large = (b'caf\xc3\xa9 ' * 20).decode('utf-8')
+)")
+                   .isError());
+  Object small(&scope, mainModuleAt(runtime_, "small"));
+  EXPECT_TRUE(isStrEqualsCStr(*small, "h\xC3\xA9"));
+  Object large(&scope, mainModuleAt(runtime_, "large"));
+  ASSERT_TRUE(large.isLargeStr());
+  EXPECT_EQ(Str::cast(*large).length(), 120);
+  EXPECT_EQ(Str::cast(*large).codePointLength(), 100);
+}
+
+TEST_F(BytesBuiltinsTest, DecodeUTF8WithInvalidBytesReturnsUnbound) {
+  HandleScope scope(thread_);
+  Bytes small(&scope, newBytesFromCStr(thread_, "h\xC3"));
+  EXPECT_TRUE(bytesDecodeUTF8(thread_, small).isUnbound());
+  Bytes large(&scope, newBytesFromCStr(
+                          thread_, "a surrogate \xED\xA0\x80 is not valid"));
+  EXPECT_TRUE(bytesDecodeUTF8(thread_, large).isUnbound());
+}
+
 TEST_F(BytesBuiltinsTest, JoinWithBytesReturnsBytes) {
   HandleScope scope(thread_);
   Bytes sep(&scope, newBytesFromCStr(thread_, ","));
@@ -31,6 +31,29 @@ RawObject bytesDecodeASCII(Thread* thread, const Bytes& bytes) {
   return buf.becomeStr();
 }
 
+RawObject bytesDecodeUTF8(Thread* thread, const Bytes& bytes) {
+  if (bytes.isSmallBytes()) {
+    byte buffer[SmallBytes::kMaxLength];
+    word length = bytes.length();
+    bytes.copyTo(buffer, length);
+    if (!UTF8::isValid(buffer, length)) {
+      return Unbound::object();
+    }
+    return SmallBytes::cast(*bytes).becomeStr();
+  }
+  HandleScope scope(thread);
+  LargeBytes large_bytes(&scope, *bytes);
+  word bytes_len = large_bytes.length();
+  if (!UTF8::isValid(reinterpret_cast<byte*>(large_bytes.address()),
+                     bytes_len)) {
+    return Unbound::object();
+  }
+  MutableBytes buf(&scope,
+                   thread->runtime()->newMutableBytesUninitialized(bytes_len));
+  buf.replaceFromWith(0, *large_bytes, bytes_len);
+  return buf.becomeStr();
+}
+
 word bytesCount(const Bytes& haystack, word haystack_len, const Bytes& needle,
                 word needle_len, word start, word end) {
   DCHECK_BOUND(haystack_len, haystack.length());
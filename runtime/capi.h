@@ -31,7 +31,7 @@ class Runtime;
 class Scavenger;
 class Thread;
 
-static const word kCAPIStateSize = 256;
+static const word kCAPIStateSize = 320;
 
 extern struct _inittab* PyImport_Inittab;
 
@@ -111,8 +111,10 @@ void visitApiHandles(Runtime* runtime, HandleVisitor* visitor);
 
 // Visits all `ApiHandle`s with `refcount > 1`. `ApiHandle`s with refcount zero
 // are ignored here and will be handled by
-// `visitNotIncrementedBorrowedApiHandles`.
-void visitIncrementedApiHandles(Runtime* runtime, PointerVisitor* visitor);
+// `visitNotIncrementedBorrowedApiHandles`. A young collection skips the handles
+// of tenured objects.
+void visitIncrementedApiHandles(Runtime* runtime, Scavenger* scavenger,
+                                PointerVisitor* visitor);
 
 // Should be called when all GC roots are processed and no gray objects remain.
 // This disposes `ApiHandle`s with reference count 0 that are not referenced
@@ -218,6 +218,7 @@ TEST_F(DebuggingTests, DumpExtendedInstanceWithOverflowDict) {
   (in-object) "_function__caches" = mutabletuple(None, None, None, None)
   (in-object) "_function__dict" = {"funcattr0": 4}
   (in-object) "_function__intrinsic" = 37280
+  (in-object) "_function__jit_countdown" = 4611686018427387903
   overflow dict: {"funcattr0": 4}
 )";
   EXPECT_EQ(ss.str(), expected.str());
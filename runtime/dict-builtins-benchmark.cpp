@@ -0,0 +1,88 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "benchmark/benchmark.h"
+
+#include "benchmark-utils.h"
+#include "dict-builtins.h"
+#include "handles.h"
+#include "int-builtins.h"
+#include "runtime.h"
+#include "str-builtins.h"
+
+namespace py {
+namespace testing {
+
+using DictBenchmark = RuntimeBenchmark;
+
+static RawObject newStrKeys(Thread* thread, word num_keys) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  MutableTuple keys(&scope, runtime->newMutableTuple(num_keys));
+  for (word i = 0; i < num_keys; i++) {
+    keys.atPut(i, runtime->newStrFromFmt("dict_benchmark_key_%w", i));
+  }
+  return keys.becomeImmutable();
+}
+
+BENCHMARK_DEFINE_F(DictBenchmark, DictAtPutStr)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  word num_keys = state.range(0);
+  Tuple keys(&scope, newStrKeys(thread_, num_keys));
+  Object key(&scope, NoneType::object());
+  Object value(&scope, SmallInt::fromWord(0));
+  Dict dict(&scope, runtime_->newDict());
+  for (auto _ : state) {
+    dict = runtime_->newDict();
+    for (word i = 0; i < num_keys; i++) {
+      key = keys.at(i);
+      dictAtPut(thread_, dict, key, strHash(thread_, *key), value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_keys);
+}
+BENCHMARK_REGISTER_F(DictBenchmark, DictAtPutStr)->Arg(8)->Arg(1024);
+
+BENCHMARK_DEFINE_F(DictBenchmark, DictAtStr)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  word num_keys = state.range(0);
+  Tuple keys(&scope, newStrKeys(thread_, num_keys));
+  Object key(&scope, NoneType::object());
+  Object value(&scope, NoneType::object());
+  Dict dict(&scope, runtime_->newDict());
+  for (word i = 0; i < num_keys; i++) {
+    key = keys.at(i);
+    value = SmallInt::fromWord(i);
+    dictAtPut(thread_, dict, key, strHash(thread_, *key), value);
+  }
+  for (auto _ : state) {
+    for (word i = 0; i < num_keys; i++) {
+      key = keys.at(i);
+      benchmark::DoNotOptimize(
+          dictAt(thread_, dict, key, strHash(thread_, *key)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_keys);
+}
+BENCHMARK_REGISTER_F(DictBenchmark, DictAtStr)->Arg(8)->Arg(1024);
+
+BENCHMARK_DEFINE_F(DictBenchmark, DictAtSmallIntMiss)
+(benchmark::State& state) {
+  HandleScope scope(thread_);
+  word num_keys = state.range(0);
+  Dict dict(&scope, runtime_->newDict());
+  Object key(&scope, NoneType::object());
+  for (word i = 0; i < num_keys; i++) {
+    key = SmallInt::fromWord(i * 2);
+    dictAtPut(thread_, dict, key, intHash(*key), key);
+  }
+  for (auto _ : state) {
+    for (word i = 0; i < num_keys; i++) {
+      key = SmallInt::fromWord(i * 2 + 1);
+      benchmark::DoNotOptimize(dictAt(thread_, dict, key, intHash(*key)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_keys);
+}
+BENCHMARK_REGISTER_F(DictBenchmark, DictAtSmallIntMiss)->Arg(8)->Arg(1024);
+
+}  // namespace testing
+}  // namespace py
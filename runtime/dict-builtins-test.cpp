@@ -996,6 +996,76 @@ TEST_F(DictBuiltinsTest, PopitemAfterInsert) {
   ASSERT_EQ(dict.numItems(), 0);
 }
 
+TEST_F(DictBuiltinsTest, DictPopitemWithLastFalseRemovesFirstItem) {
+  HandleScope scope(thread_);
+  Dict dict(&scope, runtime_->newDict());
+  for (word i = 0; i < 3; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    ASSERT_TRUE(dictAtPut(thread_, dict, key, intHash(*key), key).isNoneType());
+  }
+
+  Object result(&scope, dictPopitem(thread_, dict, /*last=*/false));
+  ASSERT_TRUE(result.isTuple());
+  EXPECT_TRUE(isIntEqualsWord(Tuple::cast(*result).at(0), 0));
+  EXPECT_EQ(dict.firstLiveItemIndex() / kItemNumPointers, 1);
+  result = dictPopitem(thread_, dict, /*last=*/true);
+  ASSERT_TRUE(result.isTuple());
+  EXPECT_TRUE(isIntEqualsWord(Tuple::cast(*result).at(0), 2));
+  result = dictPopitem(thread_, dict, /*last=*/false);
+  ASSERT_TRUE(result.isTuple());
+  EXPECT_TRUE(isIntEqualsWord(Tuple::cast(*result).at(0), 1));
+  EXPECT_EQ(dict.numItems(), 0);
+  EXPECT_TRUE(dictPopitem(thread_, dict, /*last=*/false).isErrorNotFound());
+}
+
+TEST_F(DictBuiltinsTest, DictMoveToEndMovesItemToEnd) {
+  HandleScope scope(thread_);
+  Dict dict(&scope, runtime_->newDict());
+  for (word i = 0; i < 4; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    ASSERT_TRUE(dictAtPut(thread_, dict, key, intHash(*key), key).isNoneType());
+  }
+  Object key(&scope, SmallInt::fromWord(1));
+  ASSERT_TRUE(dictMoveToEnd(thread_, dict, key, intHash(*key), /*last=*/true)
+                  .isNoneType());
+  key = SmallInt::fromWord(3);
+  ASSERT_TRUE(dictMoveToEnd(thread_, dict, key, intHash(*key), /*last=*/false)
+                  .isNoneType());
+  EXPECT_EQ(dict.numItems(), 4);
+
+  Object value(&scope, NoneType::object());
+  word expected[] = {3, 0, 2, 1};
+  word num_found = 0;
+  for (word i = 0; dictNextItem(dict, &i, &key, &value); num_found++) {
+    EXPECT_TRUE(isIntEqualsWord(*key, expected[num_found]));
+    EXPECT_TRUE(isIntEqualsWord(*value, expected[num_found]));
+  }
+  EXPECT_EQ(num_found, 4);
+  key = SmallInt::fromWord(4);
+  EXPECT_TRUE(dictMoveToEnd(thread_, dict, key, intHash(*key), /*last=*/true)
+                  .isErrorNotFound());
+}
+
+TEST_F(DictBuiltinsTest, DictMoveToEndCompactsDictInsteadOfGrowing) {
+  HandleScope scope(thread_);
+  Dict dict(&scope, runtime_->newDict());
+  for (word i = 0; i < 2; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    ASSERT_TRUE(dictAtPut(thread_, dict, key, intHash(*key), key).isNoneType());
+  }
+  for (word i = 0; i < 100; i++) {
+    Object key(&scope, SmallInt::fromWord(i % 2));
+    ASSERT_TRUE(dictMoveToEnd(thread_, dict, key, intHash(*key), i % 3 == 0)
+                    .isNoneType());
+  }
+  EXPECT_EQ(dict.numItems(), 2);
+  EXPECT_EQ(dict.numIndices(), kInitialDictIndicesLength);
+  for (word i = 0; i < 2; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    EXPECT_TRUE(isIntEqualsWord(dictAt(thread_, dict, key, intHash(*key)), i));
+  }
+}
+
 TEST_F(DictBuiltinsTest, PopWithMisingKeyRaisesKeyError) {
   EXPECT_TRUE(
       raised(runFromCStr(runtime_, "{}.pop('hello')"), LayoutId::kKeyError));
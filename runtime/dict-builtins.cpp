@@ -209,8 +209,43 @@ static RawObject dictLookupForInsertion(Thread* thread,
   UNREACHABLE("Expected to have found an empty index");
 }
 
-static word nextItemIndex(RawObject data, word* index, word end) {
-  for (word i = *index; i < end; i += kItemNumPointers) {
+// Returns the bytes offset of the entry in `indices` that refers to the item
+// at `item_index`, which must be live.
+static word indicesOffsetOfItem(RawMutableBytes indices, word num_indices,
+                                word hash, word item_index) {
+  uword perturb;
+  word indices_mask;
+  for (word current_index =
+           probeBegin(num_indices, hash, &indices_mask, &perturb);
+       ; current_index = probeNext(current_index, indices_mask, &perturb)) {
+    word bytes_offset = indexOffset(current_index);
+    uint32_t comp;
+    if (indicesIsFull(indices, bytes_offset, &comp) &&
+        static_cast<word>(comp) == item_index) {
+      return bytes_offset;
+    }
+  }
+  UNREACHABLE("cannot find index for entry in dict.sparse");
+}
+
+// Replaces the item at `item_index`, which is referred to by
+// indices[bytes_offset], with a tombstone.
+static void dictRemoveItem(const Dict& dict, const MutableTuple& data,
+                           const MutableBytes& indices, word item_index,
+                           word bytes_offset) {
+  itemSetTombstone(*data, item_index);
+  indicesSetTombstone(*indices, bytes_offset);
+  dict.setNumItems(dict.numItems() - 1);
+  if (item_index == dict.firstLiveItemIndex()) {
+    dict.setFirstLiveItemIndex(item_index + kItemNumPointers);
+  }
+}
+
+static word nextItemIndex(RawDict dict, word* index) {
+  RawObject data = dict.data();
+  word end = dict.firstEmptyItemIndex();
+  for (word i = Utils::maximum(*index, dict.firstLiveItemIndex()); i < end;
+       i += kItemNumPointers) {
     if (!itemIsFull(MutableTuple::cast(data), i)) continue;
     *index = i + kItemNumPointers;
     return i;
@@ -221,7 +256,7 @@ static word nextItemIndex(RawObject data, word* index, word end) {
 bool dictNextItem(const Dict& dict, word* index, Object* key_out,
                   Object* value_out) {
   RawObject data = dict.data();
-  word next_item_index = nextItemIndex(data, index, dict.firstEmptyItemIndex());
+  word next_item_index = nextItemIndex(*dict, index);
   if (next_item_index < 0) {
     return false;
   }
@@ -233,7 +268,7 @@ bool dictNextItem(const Dict& dict, word* index, Object* key_out,
 bool dictNextItemHash(const Dict& dict, word* index, Object* key_out,
                       Object* value_out, word* hash_out) {
   RawObject data = dict.data();
-  word next_item_index = nextItemIndex(data, index, dict.firstEmptyItemIndex());
+  word next_item_index = nextItemIndex(*dict, index);
   if (next_item_index < 0) {
     return false;
   }
@@ -245,7 +280,7 @@ bool dictNextItemHash(const Dict& dict, word* index, Object* key_out,
 
 bool dictNextKey(const Dict& dict, word* index, Object* key_out) {
   RawObject data = dict.data();
-  word next_item_index = nextItemIndex(data, index, dict.firstEmptyItemIndex());
+  word next_item_index = nextItemIndex(*dict, index);
   if (next_item_index < 0) {
     return false;
   }
@@ -256,7 +291,7 @@ bool dictNextKey(const Dict& dict, word* index, Object* key_out) {
 bool dictNextKeyHash(const Dict& dict, word* index, Object* key_out,
                      word* hash_out) {
   RawObject data = dict.data();
-  word next_item_index = nextItemIndex(data, index, dict.firstEmptyItemIndex());
+  word next_item_index = nextItemIndex(*dict, index);
   if (next_item_index < 0) {
     return false;
   }
@@ -267,7 +302,7 @@ bool dictNextKeyHash(const Dict& dict, word* index, Object* key_out,
 
 bool dictNextValue(const Dict& dict, word* index, Object* value_out) {
   RawObject data = dict.data();
-  word next_item_index = nextItemIndex(data, index, dict.firstEmptyItemIndex());
+  word next_item_index = nextItemIndex(*dict, index);
   if (next_item_index < 0) {
     return false;
   }
@@ -295,6 +330,7 @@ void dictAllocateArrays(Thread* thread, const Dict& dict, word num_indices) {
   dict.setIndices(
       runtime->mutableBytesWith(indexOffset(num_indices), kMaxByte));
   dict.setFirstEmptyItemIndex(0);
+  dict.setFirstLiveItemIndex(0);
 }
 
 // Return true if `dict` has an available item for insertion.
@@ -325,15 +361,12 @@ static void dictInsertNoUpdate(const MutableTuple& data,
   }
 }
 
-static void dictEnsureCapacity(Thread* thread, const Dict& dict) {
-  DCHECK(dict.numIndices() && Utils::isPowerOfTwo(dict.numIndices()),
-         "dict capacity must be power of two, greater than zero");
-  if (dictHasUsableItem(dict)) {
-    return;
-  }
-
+// Rebuild `dict` with `new_num_indices` indices, dropping all tombstones. The
+// live items are placed after `num_leading` tombstone items, which leaves room
+// to move items to the front of the dict.
+static void dictRehash(Thread* thread, const Dict& dict, word new_num_indices,
+                       word num_leading) {
   // TODO(T44247845): Handle overflow here.
-  word new_num_indices = dict.numIndices() * kDictGrowthFactor;
   DCHECK(new_num_indices < kTombstoneValue,
          "new_num_indices is expected to be less than kTombstoneValue");
   HandleScope scope(thread);
@@ -344,21 +377,44 @@ static void dictEnsureCapacity(Thread* thread, const Dict& dict) {
   new_data.fill(NoneType::object());
   MutableBytes new_indices(&scope, runtime->mutableBytesWith(
                                        indexOffset(new_num_indices), kMaxByte));
+  for (word i = 0; i < num_leading; i++) {
+    itemSetTombstone(*new_data, i * kItemNumPointers);
+  }
 
   // Re-insert items
   Object key(&scope, NoneType::object());
   Object value(&scope, NoneType::object());
   word hash;
-  word item_count = 0;
+  word item_count = num_leading;
   for (word i = 0; dictNextItemHash(dict, &i, &key, &value, &hash);
        item_count++) {
     dictInsertNoUpdate(new_data, new_indices, new_num_indices, item_count, key,
                        hash, value);
   }
-  DCHECK(item_count == dict.numItems(), "found entries != dictNumItems()");
+  DCHECK(item_count - num_leading == dict.numItems(),
+         "found entries != dictNumItems()");
   dict.setData(*new_data);
   dict.setIndices(*new_indices);
-  dict.setFirstEmptyItemIndex(dict.numItems() * kItemNumPointers);
+  dict.setFirstEmptyItemIndex(item_count * kItemNumPointers);
+  dict.setFirstLiveItemIndex(num_leading * kItemNumPointers);
+}
+
+static void dictEnsureCapacity(Thread* thread, const Dict& dict) {
+  DCHECK(dict.numIndices() && Utils::isPowerOfTwo(dict.numIndices()),
+         "dict capacity must be power of two, greater than zero");
+  if (dictHasUsableItem(dict)) {
+    return;
+  }
+  // Items are only ever appended, so removals and moves leave tombstones
+  // behind. When at least half of the items are tombstones, compact the data
+  // in place instead of growing it; this keeps churning dicts at a stable size
+  // while amortizing the rebuild over the appends that filled the gap.
+  word new_num_indices = dict.numIndices();
+  word capacity = sizeOfDataTuple(new_num_indices);
+  if (dict.numItems() * 2 > capacity) {
+    new_num_indices *= kDictGrowthFactor;
+  }
+  dictRehash(thread, dict, new_num_indices, /*num_leading=*/0);
 }
 
 RawObject dictAtPut(Thread* thread, const Dict& dict, const Object& key,
@@ -486,6 +542,7 @@ void dictClear(Thread* thread, const Dict& dict) {
   indices.replaceFromWithByte(0, kMaxByte, indices.length());
   dict.setNumItems(0);
   dict.setFirstEmptyItemIndex(0);
+  dict.setFirstLiveItemIndex(0);
 }
 
 RawObject dictIncludes(Thread* thread, const Dict& dict, const Object& key,
@@ -531,9 +588,109 @@ RawObject dictRemove(Thread* thread, const Dict& dict, const Object& key,
   }
   uint32_t item_index = itemIndexAt(*indices, bytes_offset);
   Object result(&scope, itemValue(*data, item_index));
-  itemSetTombstone(*data, item_index);
-  indicesSetTombstone(*indices, bytes_offset);
-  dict.setNumItems(dict.numItems() - 1);
+  dictRemoveItem(dict, data, indices, item_index, bytes_offset);
+  return *result;
+}
+
+RawObject dictMoveToEnd(Thread* thread, const Dict& dict, const Object& key,
+                        word hash, bool last) {
+  if (dict.numItems() == 0) {
+    return Error::notFound();
+  }
+  HandleScope scope(thread);
+  MutableTuple data(&scope, dict.data());
+  MutableBytes indices(&scope, dict.indices());
+  word num_indices = dict.numIndices();
+  RawObject lookup_result =
+      dictLookup(thread, data, indices, num_indices, key, hash);
+  if (UNLIKELY(lookup_result.isErrorException())) {
+    return lookup_result;
+  }
+  word bytes_offset = SmallInt::cast(lookup_result).value();
+  if (bytes_offset < 0) {
+    return Error::notFound();
+  }
+  word item_index = itemIndexAt(*indices, bytes_offset);
+  Object item_key(&scope, itemKey(*data, item_index));
+  Object value(&scope, itemValue(*data, item_index));
+
+  if (last) {
+    // Append the item and leave a tombstone at its old position.
+    word new_item_index = dict.firstEmptyItemIndex();
+    if (item_index + kItemNumPointers == new_item_index) {
+      return NoneType::object();
+    }
+    itemSetTombstone(*data, item_index);
+    itemSet(*data, new_item_index, hash, *item_key, *value);
+    itemIndexAtPut(*indices, bytes_offset, new_item_index);
+    if (item_index == dict.firstLiveItemIndex()) {
+      dict.setFirstLiveItemIndex(item_index + kItemNumPointers);
+    }
+    dict.setFirstEmptyItemIndex(new_item_index + kItemNumPointers);
+    dictEnsureCapacity(thread, dict);
+    return NoneType::object();
+  }
+
+  // Prepend the item by reusing the tombstone before the first live item.
+  word first_live = dict.firstLiveItemIndex();
+  while (itemIsTombstone(*data, first_live)) {
+    first_live += kItemNumPointers;
+  }
+  dict.setFirstLiveItemIndex(first_live);
+  if (item_index == first_live) {
+    return NoneType::object();
+  }
+  if (first_live > 0) {
+    word new_item_index = first_live - kItemNumPointers;
+    itemSetTombstone(*data, item_index);
+    itemSet(*data, new_item_index, hash, *item_key, *value);
+    itemIndexAtPut(*indices, bytes_offset, new_item_index);
+    dict.setFirstLiveItemIndex(new_item_index);
+    return NoneType::object();
+  }
+
+  // There is no tombstone at the front: rebuild the dict with half of its
+  // free items in front of the live ones so that further moves are O(1).
+  dictRemoveItem(dict, data, indices, item_index, bytes_offset);
+  word num_free = sizeOfDataTuple(num_indices) - dict.numItems();
+  word num_leading = num_free / 2;
+  DCHECK(num_leading > 0, "dict must have an empty item left");
+  dictRehash(thread, dict, num_indices, num_leading);
+  data = dict.data();
+  indices = dict.indices();
+  dictInsertNoUpdate(data, indices, num_indices, num_leading - 1, item_key,
+                     hash, value);
+  dict.setNumItems(dict.numItems() + 1);
+  dict.setFirstLiveItemIndex((num_leading - 1) * kItemNumPointers);
+  return NoneType::object();
+}
+
+RawObject dictPopitem(Thread* thread, const Dict& dict, bool last) {
+  if (dict.numItems() == 0) {
+    return Error::notFound();
+  }
+  HandleScope scope(thread);
+  MutableTuple data(&scope, dict.data());
+  word item_index;
+  if (last) {
+    item_index = dict.firstEmptyItemIndex() - kItemNumPointers;
+    while (itemIsTombstone(*data, item_index)) {
+      item_index -= kItemNumPointers;
+    }
+  } else {
+    item_index = dict.firstLiveItemIndex();
+    while (itemIsTombstone(*data, item_index)) {
+      item_index += kItemNumPointers;
+    }
+    dict.setFirstLiveItemIndex(item_index);
+  }
+  Object key(&scope, itemKey(*data, item_index));
+  Object value(&scope, itemValue(*data, item_index));
+  Tuple result(&scope, thread->runtime()->newTupleWith2(key, value));
+  MutableBytes indices(&scope, dict.indices());
+  word bytes_offset = indicesOffsetOfItem(
+      *indices, dict.numIndices(), itemHash(*data, item_index), item_index);
+  dictRemoveItem(dict, data, indices, item_index, bytes_offset);
   return *result;
 }
 
@@ -840,6 +997,8 @@ static const BuiltinAttribute kDictAttributes[] = {
     {ID(_dict__sparse), RawDict::kIndicesOffset, AttributeFlags::kHidden},
     {ID(_dict__first_empty_item_index), RawDict::kFirstEmptyItemIndexOffset,
      AttributeFlags::kHidden},
+    {ID(_dict__first_live_item_index), RawDict::kFirstLiveItemIndexOffset,
+     AttributeFlags::kHidden},
 };
 
 static const BuiltinAttribute kDictItemIteratorAttributes[] = {
@@ -1013,45 +1172,12 @@ RawObject METH(dict, popitem)(Thread* thread, Arguments args) {
     return thread->raiseRequiresType(self, ID(dict));
   }
   Dict dict(&scope, *self);
-  if (dict.numItems() == 0) {
+  Object result(&scope, dictPopitem(thread, dict, /*last=*/true));
+  if (result.isErrorNotFound()) {
     return thread->raiseWithFmt(LayoutId::kKeyError,
                                 "popitem(): dictionary is empty");
   }
-  MutableTuple data(&scope, dict.data());
-  for (word item_index = dict.firstEmptyItemIndex() - kItemNumPointers;
-       item_index >= 0; item_index -= kItemNumPointers) {
-    if (!itemIsEmpty(*data, item_index) &&
-        !itemIsTombstone(*data, item_index)) {
-      Object key(&scope, itemKey(*data, item_index));
-      Object value(&scope, itemValue(*data, item_index));
-      Tuple result(&scope, runtime->newTupleWith2(key, value));
-      // Find the item for the entry and set a tombstone in it.
-      // Note that this would take amortized cost O(1).
-      word indices_index = -1;
-      MutableBytes indices(&scope, dict.indices());
-      uword perturb;
-      word indices_mask;
-      word hash = itemHash(*data, item_index);
-      word num_indices = dict.numIndices();
-      for (word current_index =
-               probeBegin(num_indices, hash, &indices_mask, &perturb);
-           ; current_index = probeNext(current_index, indices_mask, &perturb)) {
-        word bytes_offset = indexOffset(current_index);
-        uint32_t comp;
-        if (indicesIsFull(*indices, bytes_offset, &comp) &&
-            comp == item_index) {
-          indices_index = current_index;
-          break;
-        }
-      }
-      DCHECK(indices_index >= 0, "cannot find index for entry in dict.sparse");
-      itemSetTombstone(*data, item_index);
-      indicesSetTombstone(*indices, indexOffset(indices_index));
-      dict.setNumItems(dict.numItems() - 1);
-      return *result;
-    }
-  }
-  UNREACHABLE("dict.numItems() > 0, but couldn't find any active item");
+  return *result;
 }
 
 RawObject METH(dict, values)(Thread* thread, Arguments args) {
@@ -1082,6 +1208,7 @@ RawObject METH(dict, __new__)(Thread* thread, Arguments args) {
   result.setData(SmallInt::fromWord(0));
   result.setIndices(SmallInt::fromWord(0));
   result.setFirstEmptyItemIndex(0);
+  result.setFirstLiveItemIndex(0);
   return *result;
 }
 
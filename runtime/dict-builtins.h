@@ -83,6 +83,17 @@ RawObject dictRemove(Thread* thread, const Dict& dict, const Object& key,
 // `Error:notFound()`.
 RawObject dictRemoveByStr(Thread* thread, const Dict& dict, const Object& name);
 
+// Move the entry associated with `key` to the end of `dict`, or to the front
+// when `last` is false. Returns None on success, `Error::notFound()` if `key`
+// is not in the dict, or `Error::exception()` if a comparison raised.
+RawObject dictMoveToEnd(Thread* thread, const Dict& dict, const Object& key,
+                        word hash, bool last);
+
+// Remove the last entry of `dict`, or the first one when `last` is false.
+// Returns the removed entry as a (key, value) tuple or `Error::notFound()` if
+// the dict is empty.
+RawObject dictPopitem(Thread* thread, const Dict& dict, bool last);
+
 RawObject dictKeys(Thread* thread, const Dict& dict);
 
 // Creates a new dict with shallow copies of the given dict's elements.
@@ -165,6 +165,10 @@ class Frame {
   TryBlock blockStackPop();
   void blockStackPush(TryBlock block);
 
+  // Returns true if the block stack contains a `TryBlock::kFinally` entry,
+  // meaning that an exception raised now is handled within this frame.
+  bool blockStackHasFinally();
+
   void addReturnMode(word mode);
   word returnMode();
 
@@ -335,6 +339,16 @@ inline void Frame::blockStackPush(TryBlock block) {
   setBlockStackDepthReturnMode(depth_return_mode + kPointerSize);
 }
 
+inline bool Frame::blockStackHasFinally() {
+  word depth = blockStackDepthReturnMode() & kBlockStackDepthMask;
+  for (word offset = 0; offset < depth; offset += kPointerSize) {
+    if (TryBlock(at(kBlockStackOffset + offset)).kind() == TryBlock::kFinally) {
+      return true;
+    }
+  }
+  return false;
+}
+
 inline void Frame::addReturnMode(word mode) {
   DCHECK(!isNative(), "Cannot set return mode on native frames");
   word blockstack_depth_return_mode = blockStackDepthReturnMode();
@@ -53,6 +53,8 @@ static const BuiltinAttribute kFunctionAttributes[] = {
     {ID(_function__dict), RawFunction::kDictOffset, AttributeFlags::kHidden},
     {ID(_function__intrinsic), RawFunction::kIntrinsicOffset,
      AttributeFlags::kHidden},
+    {ID(_function__jit_countdown), RawFunction::kJitCountdownOffset,
+     AttributeFlags::kHidden},
 };
 
 static const BuiltinAttribute kBoundMethodAttributes[] = {
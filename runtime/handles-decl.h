@@ -52,6 +52,7 @@ class Handle;
   V(Generator)                                                                 \
   V(GeneratorBase)                                                             \
   V(GeneratorFrame)                                                            \
+  V(Grouper)                                                                   \
   V(Header)                                                                    \
   V(HeapObject)                                                                \
   V(IncrementalNewlineDecoder)                                                 \
@@ -92,6 +93,8 @@ class Handle;
   V(StrArray)                                                                  \
   V(StrIterator)                                                               \
   V(Super)                                                                     \
+  V(Tee)                                                                       \
+  V(TeeDataObject)                                                             \
   V(Token)                                                                     \
   V(Traceback)                                                                 \
   V(Tuple)                                                                     \
@@ -110,21 +113,29 @@ class Handle;
 
 // The handles for certain types allow user-defined subtypes.
 #define SUBTYPE_HANDLE_TYPES(V)                                                \
+  V(Accumulate)                                                                \
   V(Array)                                                                     \
   V(BaseException)                                                             \
   V(Bytearray)                                                                 \
   V(BytesIO)                                                                   \
+  V(Chain)                                                                     \
   V(ClassMethod)                                                               \
+  V(Count)                                                                     \
   V(Deque)                                                                     \
   V(Dict)                                                                      \
   V(FileIO)                                                                    \
   V(FrozenSet)                                                                 \
+  V(Groupby)                                                                   \
   V(ImportError)                                                               \
+  V(Islice)                                                                    \
   V(List)                                                                      \
+  V(LruCacheWrapper)                                                           \
   V(Mmap)                                                                      \
   V(Module)                                                                    \
   V(NativeProxy)                                                               \
+  V(Product)                                                                   \
   V(Property)                                                                  \
+  V(Repeat)                                                                    \
   V(Set)                                                                       \
   V(SetBase)                                                                   \
   V(StaticMethod)                                                              \
@@ -144,7 +155,8 @@ class Handle;
   V(UserIntBase)                                                               \
   V(UserStrBase)                                                               \
   V(UserTupleBase)                                                             \
-  V(UserWeakRefBase)
+  V(UserWeakRefBase)                                                           \
+  V(ZipLongest)
 
 #define HANDLE_ALIAS(ty) using ty = Handle<class Raw##ty>;
 HANDLE_TYPES(HANDLE_ALIAS)
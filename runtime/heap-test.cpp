@@ -67,6 +67,28 @@ TEST_F(HeapTest, AllocateFails) {
   ASSERT_EQ(heap->space()->end(), heap->space()->fill());
 }
 
+TEST_F(HeapTest, AllocateUsesAllocationBufferOfCurrentThread) {
+  Heap* heap = runtime_->heap();
+  AllocationBuffer* buffer = thread_->allocationBuffer();
+  ASSERT_EQ(Heap::currentBuffer(), buffer);
+
+  uword address;
+  ASSERT_TRUE(heap->allocate(4 * kPointerSize, &address));
+  EXPECT_TRUE(heap->space()->contains(address));
+  EXPECT_EQ(buffer->fill, address + 4 * kPointerSize);
+  EXPECT_LE(buffer->fill, buffer->end);
+
+  // Large allocations that do not fit bypass the buffer.
+  uword fill = buffer->fill;
+  ASSERT_TRUE(heap->allocate(Heap::kAllocationBufferSize, &address));
+  EXPECT_TRUE(heap->space()->contains(address));
+  EXPECT_EQ(buffer->fill, fill);
+
+  runtime_->collectGarbage();
+  EXPECT_EQ(buffer->fill, uword{0});
+  EXPECT_EQ(buffer->end, uword{0});
+}
+
 TEST_F(HeapTest, AllocateBigLargeInt) {
   HandleScope scope(thread_);
   Object result(&scope, runtime_->createLargeInt(100000));
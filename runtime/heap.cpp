@@ -10,20 +10,65 @@
 
 namespace py {
 
-Heap::Heap(word size) {
+Heap::Heap(word size) : Heap(size, 0) {}
+
+Heap::Heap(word size, uword immortal_start) {
+  // Reserve the immortal partition first so the other spaces cannot take its
+  // preferred address.
+  immortal_ = new Space(size, immortal_start);
   space_ = new Space(size);
-  immortal_ = new Space(size);
+  old_ = new Space(size);
+  age_mark_ = space_->start();
 }
 
 Heap::~Heap() {
   delete space_;
+  delete old_;
   delete immortal_;
 }
 
+thread_local AllocationBuffer* Heap::current_buffer_ = nullptr;
+
 NEVER_INLINE bool Heap::allocateRetry(word size, uword* address_out) {
+  AllocationBuffer* buffer = current_buffer_;
+  if (buffer == nullptr || size > kMaxBufferedAllocationSize) {
+    return allocateShared(size, address_out);
+  }
+  if (size <= static_cast<word>(buffer->end - buffer->fill)) {
+    // The allocation only crossed the allocation sampling limit.
+    *address_out = buffer->fill;
+    buffer->fill += size;
+    if (allocation_sample_interval_ > 0) {
+      Thread* thread = Thread::current();
+      thread->runtime()->samplingProfiler()->sampleAllocation(
+          thread, allocation_sample_interval_);
+    }
+    armAllocationSample(buffer);
+    return true;
+  }
+  // Taking a new buffer is a safepoint. The rest of the old buffer is left
+  // unused; heap walks skip it like alignment padding.
+  Thread* thread = Thread::current();
+  if (thread->isInterrupted(Thread::kSafepoint)) {
+    thread->runtime()->safepoint(thread);
+  }
+  uword start;
+  if (!allocateShared(kAllocationBufferSize, &start)) {
+    // Not enough room for a whole buffer even after a collection.
+    return allocateShared(size, address_out);
+  }
+  *address_out = start;
+  buffer->fill = start + size;
+  buffer->end = start + kAllocationBufferSize;
+  armAllocationSample(buffer);
+  return true;
+}
+
+bool Heap::allocateShared(word size, uword* address_out) {
+  if (space_->allocateShared(size, address_out)) return true;
   // Since the allocation failed, invoke the garbage collector and retry.
   collectGarbage();
-  return space_->allocate(size, address_out);
+  return space_->allocateShared(size, address_out);
 }
 
 bool Heap::allocateImmortal(word size, uword* address_out) {
@@ -34,11 +79,38 @@ bool Heap::allocateImmortal(word size, uword* address_out) {
   return true;
 }
 
+void Heap::setAllocationSampleInterval(word interval) {
+  DCHECK(interval >= 0, "negative allocation sample interval");
+  allocation_sample_interval_ = interval;
+  if (current_buffer_ != nullptr) {
+    armAllocationSample(current_buffer_);
+  }
+}
+
+void Heap::armAllocationSample(AllocationBuffer* buffer) {
+  uword limit = buffer->end;
+  if (allocation_sample_interval_ > 0 &&
+      static_cast<word>(buffer->end - buffer->fill) >
+          allocation_sample_interval_) {
+    limit = buffer->fill + allocation_sample_interval_;
+  }
+  buffer->limit = limit;
+}
+
 bool Heap::contains(uword address) {
-  return space_->contains(address) || immortal_->contains(address);
+  return space_->contains(address) || old_->contains(address) ||
+         immortal_->contains(address);
+}
+
+void Heap::collectGarbage() {
+  Thread::current()->runtime()->collectYoungGarbage();
 }
 
-void Heap::collectGarbage() { Thread::current()->runtime()->collectGarbage(); }
+bool Heap::shouldCollectOld() {
+  // Everything below the age mark is promoted by the next scavenge.
+  uword promotable = age_mark_ - space_->start();
+  return old_->end() - old_->fill() < promotable;
+}
 
 bool Heap::verifySpace(Space* space) {
   uword scan = space->start();
@@ -84,6 +156,7 @@ bool Heap::verifySpace(Space* space) {
 
 void Heap::visitAllObjects(HeapObjectVisitor* visitor) {
   visitSpace(immortal_, visitor);
+  visitSpace(old_, visitor);
   visitSpace(space_, visitor);
 }
 
@@ -8,51 +8,140 @@
 
 namespace py {
 
+// A chunk of the young generation that a single thread bump allocates into
+// without synchronization. Every thread owns one; see `Heap::allocate()`.
+struct AllocationBuffer {
+  uword fill = 0;
+  // Allocation takes the slow path once it would cross the limit. The limit is
+  // the end of the buffer unless the heap lowered it to sample an allocation.
+  uword limit = 0;
+  uword end = 0;
+
+  void reset() { fill = limit = end = 0; }
+
+  static int fillOffset() { return offsetof(AllocationBuffer, fill); }
+  static int limitOffset() { return offsetof(AllocationBuffer, limit); }
+};
+
+// The heap is split into two generations plus the immortal partition:
+//
+// - The young generation (`space()`) is the nursery all mutator allocations
+//   bump allocate into. It is evacuated on every collection.
+// - The old generation (`old()`) holds objects that survived a scavenge while
+//   already being above the age mark. It is only evacuated by a full
+//   collection. Stores into old objects go through the card marking write
+//   barrier (see `Space::markCard`) so that a young collection only needs to
+//   scan dirty cards instead of the whole old generation.
+// - The immortal partition is never evacuated.
+//
+// Threads do not allocate from the young generation directly. Each thread bump
+// allocates into its own `AllocationBuffer` and only synchronizes with other
+// threads to carve a new buffer out of the young generation when it runs out.
 class Heap {
  public:
   explicit Heap(word size);
+  // Places the immortal partition at `immortal_start` if possible.
+  Heap(word size, uword immortal_start);
   ~Heap();
 
   // Returns true if allocation succeeded and writes output address + offset to
-  // *address. Returns false otherwise.
+  // *address. Returns false otherwise. Allocates from the buffer of the current
+  // thread.
   bool allocate(word size, uword* address_out);
   bool allocateImmortal(word size, uword* address_out);
   void collectGarbage();
 
   bool contains(uword address);
-  bool verify() { return verifySpace(space_) && verifySpace(immortal_); }
+  bool verify() {
+    return verifySpace(space_) && verifySpace(old_) && verifySpace(immortal_);
+  }
 
   Space* space() { return space_; }
+  Space* old() { return old_; }
   Space* immortal() { return immortal_; }
 
   void setSpace(Space* new_space) { space_ = new_space; }
+  void setOld(Space* new_old) { old_ = new_old; }
+
+  // Objects in the young generation below the age mark have survived one
+  // scavenge already and are promoted when they survive the next one.
+  uword ageMark() const { return age_mark_; }
+  void setAgeMark(uword age_mark) { age_mark_ = age_mark; }
 
   bool isImmortal(uword address) const {
     return immortal_->isAllocated(address);
   }
+  bool isOld(uword address) const { return old_->isAllocated(address); }
   bool inHeap(uword address) const {
-    return space_->isAllocated(address) || isImmortal(address);
+    return space_->isAllocated(address) || isOld(address) ||
+           isImmortal(address);
+  }
+
+  // Returns true if the next collection should evacuate the old generation
+  // too because it may not have enough room left for the promoted objects.
+  bool shouldCollectOld();
+
+  // Number of threads a collection copies objects with. The scavenger runs
+  // single threaded when this is 1, which is the default.
+  word numScavengerWorkers() const { return num_scavenger_workers_; }
+  void setNumScavengerWorkers(word num_workers) {
+    DCHECK(num_workers > 0, "need at least one scavenger worker");
+    num_scavenger_workers_ = num_workers;
+  }
+
+  // Records an allocation sample with the sampling profiler every time roughly
+  // `interval` bytes have been allocated in the young generation. An interval
+  // of 0 disables allocation sampling.
+  word allocationSampleInterval() const { return allocation_sample_interval_; }
+  void setAllocationSampleInterval(word interval);
+
+  // Lowers the allocation limit of `buffer` to trigger the next allocation
+  // sample.
+  void armAllocationSample(AllocationBuffer* buffer);
+
+  // The allocation buffer of the thread running on this OS thread. Updated by
+  // `Thread::setCurrentThread()`.
+  static AllocationBuffer* currentBuffer() { return current_buffer_; }
+  static void setCurrentBuffer(AllocationBuffer* buffer) {
+    current_buffer_ = buffer;
   }
 
-  static int spaceOffset() { return offsetof(Heap, space_); };
+  // Threads take allocation buffers of `kAllocationBufferSize` bytes. Objects
+  // larger than `kMaxBufferedAllocationSize` that do not fit into the current
+  // buffer are allocated from the young generation directly.
+  static const word kAllocationBufferSize = 32 * kKiB;
+  static const word kMaxBufferedAllocationSize = kAllocationBufferSize / 4;
 
   void visitAllObjects(HeapObjectVisitor* visitor);
+  void visitSpace(Space* space, HeapObjectVisitor* visitor);
 
  private:
   bool allocateRetry(word size, uword* address_out);
+  bool allocateShared(word size, uword* address_out);
   bool verifySpace(Space*);
-  void visitSpace(Space* space, HeapObjectVisitor* visitor);
+
+  static thread_local AllocationBuffer* current_buffer_;
 
   Space* space_;
+  Space* old_;
   Space* immortal_;
+  uword age_mark_;
+  word num_scavenger_workers_ = 1;
+  word allocation_sample_interval_ = 0;
 };
 
 inline bool Heap::allocate(word size, uword* address_out) {
   DCHECK(Utils::isAligned(size, kPointerSize), "request %ld not aligned", size);
-  if (UNLIKELY(!space_->allocate(size, address_out))) {
-    return allocateRetry(size, address_out);
+  AllocationBuffer* buffer = current_buffer_;
+  if (LIKELY(buffer != nullptr)) {
+    uword fill = buffer->fill;
+    if (LIKELY(size <= static_cast<word>(buffer->limit - fill))) {
+      *address_out = fill;
+      buffer->fill = fill + size;
+      return true;
+    }
   }
-  return true;
+  return allocateRetry(size, address_out);
 }
 
 }  // namespace py
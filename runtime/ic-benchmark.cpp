@@ -0,0 +1,100 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "benchmark/benchmark.h"
+
+#include "benchmark-utils.h"
+#include "handles.h"
+#include "ic.h"
+#include "runtime.h"
+
+namespace py {
+namespace testing {
+
+using IcBenchmark = RuntimeBenchmark;
+
+BENCHMARK_DEFINE_F(IcBenchmark, IcLookupMonomorphic)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  MutableTuple caches(&scope,
+                      runtime_->newMutableTuple(1 * kIcPointersPerEntry));
+  caches.fill(NoneType::object());
+  Object value(&scope, SmallInt::fromWord(42));
+  Object name(&scope, Str::empty());
+  Function dependent(&scope, newEmptyFunction());
+  icUpdateAttr(thread_, caches, 0, LayoutId::kSmallInt, value, name, dependent);
+  for (auto _ : state) {
+    bool is_found;
+    benchmark::DoNotOptimize(
+        icLookupMonomorphic(*caches, 0, LayoutId::kSmallInt, &is_found));
+  }
+}
+BENCHMARK_REGISTER_F(IcBenchmark, IcLookupMonomorphic);
+
+// Looks up the last of `kIcEntriesPerPolyCache` entries, the worst case of a
+// polymorphic cache hit.
+BENCHMARK_DEFINE_F(IcBenchmark, IcLookupPolymorphic)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  MutableTuple caches(&scope,
+                      runtime_->newMutableTuple(1 * kIcPointersPerEntry));
+  caches.fill(NoneType::object());
+  Object value(&scope, SmallInt::fromWord(42));
+  Object name(&scope, Str::empty());
+  Function dependent(&scope, newEmptyFunction());
+  LayoutId layout_ids[] = {LayoutId::kSmallInt, LayoutId::kSmallStr,
+                           LayoutId::kLargeInt, LayoutId::kLargeStr};
+  for (LayoutId layout_id : layout_ids) {
+    icUpdateAttr(thread_, caches, 0, layout_id, value, name, dependent);
+  }
+  for (auto _ : state) {
+    bool is_found;
+    benchmark::DoNotOptimize(
+        icLookupPolymorphic(*caches, 0, LayoutId::kLargeStr, &is_found));
+  }
+}
+BENCHMARK_REGISTER_F(IcBenchmark, IcLookupPolymorphic);
+
+BENCHMARK_DEFINE_F(IcBenchmark, IcLookupMegamorphic)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  MutableTuple cache(&scope,
+                     runtime_->newMutableTuple(kIcMegamorphicCacheEntries));
+  cache.fill(NoneType::object());
+  Object value(&scope, SmallInt::fromWord(42));
+  Object name(&scope, Runtime::internStrFromCStr(thread_, "attribute_name"));
+  icUpdateMegamorphic(thread_, cache, LayoutId::kLargeStr, name, value);
+  for (auto _ : state) {
+    bool is_found;
+    benchmark::DoNotOptimize(
+        icLookupMegamorphic(*cache, LayoutId::kLargeStr, *name, &is_found));
+  }
+}
+BENCHMARK_REGISTER_F(IcBenchmark, IcLookupMegamorphic);
+
+BENCHMARK_DEFINE_F(IcBenchmark, IcLookupBinOpMonomorphic)
+(benchmark::State& state) {
+  HandleScope scope(thread_);
+  MutableTuple caches(&scope,
+                      runtime_->newMutableTuple(1 * kIcPointersPerEntry));
+  caches.fill(NoneType::object());
+  Object value(&scope, SmallInt::fromWord(42));
+  icUpdateBinOp(thread_, caches, 0, LayoutId::kSmallInt, LayoutId::kFloat,
+                value, kBinaryOpNone);
+  for (auto _ : state) {
+    BinaryOpFlags flags;
+    benchmark::DoNotOptimize(icLookupBinOpMonomorphic(
+        *caches, 0, LayoutId::kSmallInt, LayoutId::kFloat, &flags));
+  }
+}
+BENCHMARK_REGISTER_F(IcBenchmark, IcLookupBinOpMonomorphic);
+
+BENCHMARK_DEFINE_F(IcBenchmark, IcLookupGlobalVar)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  MutableTuple caches(&scope, runtime_->newMutableTuple(1));
+  ValueCell cell(&scope, runtime_->newValueCell());
+  cell.setValue(SmallInt::fromWord(42));
+  caches.atPut(0, *cell);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(icLookupGlobalVar(*caches, 0));
+  }
+}
+BENCHMARK_REGISTER_F(IcBenchmark, IcLookupGlobalVar);
+
+}  // namespace testing
+}  // namespace py
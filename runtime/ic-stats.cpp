@@ -0,0 +1,298 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "ic-stats.h"
+
+#include "dict-builtins.h"
+#include "handles.h"
+#include "ic.h"
+#include "runtime.h"
+#include "thread.h"
+
+namespace py {
+
+IcSiteState icSiteState(Bytecode bc) {
+  switch (bc) {
+    case BINARY_OP_ANAMORPHIC:
+    case BINARY_SUBSCR_ANAMORPHIC:
+    case CALL_FUNCTION_ANAMORPHIC:
+    case COMPARE_IN_ANAMORPHIC:
+    case COMPARE_OP_ANAMORPHIC:
+    case FOR_ITER_ANAMORPHIC:
+    case INPLACE_OP_ANAMORPHIC:
+    case LOAD_ATTR_ANAMORPHIC:
+    case LOAD_METHOD_ANAMORPHIC:
+    case STORE_ATTR_ANAMORPHIC:
+    case STORE_SUBSCR_ANAMORPHIC:
+      return IcSiteState::kAnamorphic;
+    case BINARY_ADD_SMALLINT:
+    case BINARY_AND_SMALLINT:
+    case BINARY_FLOORDIV_SMALLINT:
+    case BINARY_MUL_SMALLINT:
+    case BINARY_OP_MONOMORPHIC:
+    case BINARY_OR_SMALLINT:
+    case BINARY_SUBSCR_DICT:
+    case BINARY_SUBSCR_LIST:
+    case BINARY_SUBSCR_MONOMORPHIC:
+    case BINARY_SUBSCR_TUPLE:
+    case BINARY_SUB_SMALLINT:
+    case CALL_FUNCTION_TYPE_NEW:
+    case COMPARE_EQ_SMALLINT:
+    case COMPARE_EQ_STR:
+    case COMPARE_GE_SMALLINT:
+    case COMPARE_GT_SMALLINT:
+    case COMPARE_IN_DICT:
+    case COMPARE_IN_LIST:
+    case COMPARE_IN_MONOMORPHIC:
+    case COMPARE_IN_STR:
+    case COMPARE_IN_TUPLE:
+    case COMPARE_LE_SMALLINT:
+    case COMPARE_LT_SMALLINT:
+    case COMPARE_NE_SMALLINT:
+    case COMPARE_NE_STR:
+    case COMPARE_OP_MONOMORPHIC:
+    case FOR_ITER_ACCUMULATE:
+    case FOR_ITER_CHAIN:
+    case FOR_ITER_COUNT:
+    case FOR_ITER_DICT:
+    case FOR_ITER_GENERATOR:
+    case FOR_ITER_GROUPBY:
+    case FOR_ITER_ISLICE:
+    case FOR_ITER_LIST:
+    case FOR_ITER_MONOMORPHIC:
+    case FOR_ITER_PRODUCT:
+    case FOR_ITER_RANGE:
+    case FOR_ITER_REPEAT:
+    case FOR_ITER_STR:
+    case FOR_ITER_TEE:
+    case FOR_ITER_TUPLE:
+    case FOR_ITER_ZIP_LONGEST:
+    case INPLACE_ADD_SMALLINT:
+    case INPLACE_OP_MONOMORPHIC:
+    case INPLACE_SUB_SMALLINT:
+    case LOAD_ATTR_INSTANCE:
+    case LOAD_ATTR_INSTANCE_PROPERTY:
+    case LOAD_ATTR_INSTANCE_SLOT_DESCR:
+    case LOAD_ATTR_INSTANCE_TYPE:
+    case LOAD_ATTR_INSTANCE_TYPE_BOUND_METHOD:
+    case LOAD_ATTR_INSTANCE_TYPE_DESCR:
+    case LOAD_ATTR_MODULE:
+    case LOAD_ATTR_TYPE:
+    case LOAD_GLOBAL_CACHED:
+    case LOAD_METHOD_INSTANCE_FUNCTION:
+    case STORE_ATTR_INSTANCE:
+    case STORE_ATTR_INSTANCE_OVERFLOW:
+    case STORE_ATTR_INSTANCE_OVERFLOW_UPDATE:
+    case STORE_ATTR_INSTANCE_UPDATE:
+    case STORE_GLOBAL_CACHED:
+    case STORE_SUBSCR_DICT:
+    case STORE_SUBSCR_LIST:
+    case STORE_SUBSCR_MONOMORPHIC:
+      return IcSiteState::kMonomorphic;
+    case BINARY_OP_POLYMORPHIC:
+    case BINARY_SUBSCR_POLYMORPHIC:
+    case COMPARE_IN_POLYMORPHIC:
+    case COMPARE_OP_POLYMORPHIC:
+    case FOR_ITER_POLYMORPHIC:
+    case INPLACE_OP_POLYMORPHIC:
+    case LOAD_ATTR_POLYMORPHIC:
+    case LOAD_METHOD_POLYMORPHIC:
+    case STORE_ATTR_POLYMORPHIC:
+    case STORE_SUBSCR_POLYMORPHIC:
+      return IcSiteState::kPolymorphic;
+    case LOAD_ATTR_MEGAMORPHIC:
+    case LOAD_METHOD_MEGAMORPHIC:
+      return IcSiteState::kMegamorphic;
+    default:
+      return IcSiteState::kGeneric;
+  }
+}
+
+const char* icSiteStateName(IcSiteState state) {
+  switch (state) {
+    case IcSiteState::kGeneric:
+      return "generic";
+    case IcSiteState::kAnamorphic:
+      return "anamorphic";
+    case IcSiteState::kMonomorphic:
+      return "monomorphic";
+    case IcSiteState::kPolymorphic:
+      return "polymorphic";
+    case IcSiteState::kMegamorphic:
+      return "megamorphic";
+  }
+  UNREACHABLE("invalid IcSiteState");
+}
+
+void IcStats::add(const IcStats& other) {
+  for (word i = 0; i < kNumBytecodes; i++) {
+    executions[i] += other.executions[i];
+    misses[i] += other.misses[i];
+    rewrites[i] += other.rewrites[i];
+  }
+  for (word i = 0; i < kNumIcSiteStates; i++) {
+    for (word j = 0; j < kNumIcSiteStates; j++) {
+      transitions[i][j] += other.transitions[i][j];
+    }
+  }
+  jit_deopts += other.jit_deopts;
+}
+
+void IcStats::countRewrite(Bytecode from, Bytecode to) {
+  if (from == to) return;
+  rewrites[to]++;
+  transitions[static_cast<word>(icSiteState(from))]
+             [static_cast<word>(icSiteState(to))]++;
+}
+
+// Returns a dict mapping the names of opcodes with a non-zero count in
+// `counts` to their count.
+static RawObject opcodeCountsAsDict(Thread* thread, const word* counts) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Dict result(&scope, runtime->newDict());
+  Object name(&scope, NoneType::object());
+  Object count(&scope, NoneType::object());
+  for (word i = 0; i < kNumBytecodes; i++) {
+    if (counts[i] == 0) continue;
+    name = Runtime::internStrFromCStr(thread, kBytecodeNames[i]);
+    count = runtime->newInt(counts[i]);
+    dictAtPutByStr(thread, result, name, count);
+  }
+  return *result;
+}
+
+static void dictAtPutByCStr(Thread* thread, const Dict& dict, const char* key,
+                            const Object& value) {
+  HandleScope scope(thread);
+  Object key_str(&scope, Runtime::internStrFromCStr(thread, key));
+  dictAtPutByStr(thread, dict, key_str, value);
+}
+
+RawObject icStatsAsDict(Thread* thread) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  IcStats stats = {};
+  runtime->icStats(&stats);
+
+  Dict result(&scope, runtime->newDict());
+  Object value(&scope, Bool::fromBool(kIcStatsEnabled));
+  dictAtPutByCStr(thread, result, "enabled", value);
+  value = opcodeCountsAsDict(thread, stats.executions);
+  dictAtPutByCStr(thread, result, "executions", value);
+  value = opcodeCountsAsDict(thread, stats.misses);
+  dictAtPutByCStr(thread, result, "misses", value);
+  value = opcodeCountsAsDict(thread, stats.rewrites);
+  dictAtPutByCStr(thread, result, "rewrites", value);
+
+  Dict transitions(&scope, runtime->newDict());
+  Object key(&scope, NoneType::object());
+  for (word i = 0; i < kNumIcSiteStates; i++) {
+    for (word j = 0; j < kNumIcSiteStates; j++) {
+      if (stats.transitions[i][j] == 0) continue;
+      key = runtime->newStrFromFmt(
+          "%s->%s", icSiteStateName(static_cast<IcSiteState>(i)),
+          icSiteStateName(static_cast<IcSiteState>(j)));
+      value = runtime->newInt(stats.transitions[i][j]);
+      dictAtPutByStr(thread, transitions, key, value);
+    }
+  }
+  dictAtPutByCStr(thread, result, "transitions", transitions);
+
+  value = runtime->newInt(stats.jit_deopts);
+  dictAtPutByCStr(thread, result, "jit_deopts", value);
+  value = runtime->newInt(runtime->megamorphicCacheHits());
+  dictAtPutByCStr(thread, result, "megamorphic_cache_hits", value);
+  value = runtime->newInt(runtime->megamorphicCacheMisses());
+  dictAtPutByCStr(thread, result, "megamorphic_cache_misses", value);
+  return *result;
+}
+
+static bool isBinaryOpCache(Bytecode bc) {
+  switch (bc) {
+    case BINARY_OP_ANAMORPHIC:
+    case BINARY_OP_MONOMORPHIC:
+    case BINARY_OP_POLYMORPHIC:
+    case COMPARE_OP_ANAMORPHIC:
+    case COMPARE_OP_MONOMORPHIC:
+    case COMPARE_OP_POLYMORPHIC:
+    case INPLACE_OP_ANAMORPHIC:
+    case INPLACE_OP_MONOMORPHIC:
+    case INPLACE_OP_POLYMORPHIC:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Appends the type or the pair of types encoded in the cache key `key` of an
+// opcode `bc` to `types`.
+static void appendCachedTypes(Thread* thread, Bytecode bc, RawObject key,
+                              const List& types) {
+  if (!key.isSmallInt()) return;
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  word key_value = SmallInt::cast(key).value();
+  if (isBinaryOpCache(bc)) {
+    word layout_ids = key_value >> kBitsPerByte;
+    Object left(&scope, runtime->typeAt(static_cast<LayoutId>(
+                            layout_ids >> Header::kLayoutIdBits)));
+    Object right(&scope,
+                 runtime->typeAt(static_cast<LayoutId>(
+                     layout_ids & ((word{1} << Header::kLayoutIdBits) - 1))));
+    Object pair(&scope, runtime->newTupleWith2(left, right));
+    runtime->listAdd(thread, types, pair);
+    return;
+  }
+  Object type(&scope, runtime->typeAt(static_cast<LayoutId>(key_value)));
+  runtime->listAdd(thread, types, type);
+}
+
+RawObject icStatsForFunction(Thread* thread, const Function& function) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  List result(&scope, runtime->newList());
+  if (!function.isInterpreted()) return *result;
+  MutableBytes bytecode(&scope, function.rewrittenBytecode());
+  Object caches_obj(&scope, function.caches());
+  Object offset(&scope, NoneType::object());
+  Object name(&scope, NoneType::object());
+  Object state_name(&scope, NoneType::object());
+  List types(&scope, runtime->newList());
+  Tuple items(&scope, runtime->emptyTuple());
+  Object types_tuple(&scope, NoneType::object());
+  Object site(&scope, NoneType::object());
+  word num_opcodes = rewrittenBytecodeLength(bytecode);
+  for (word i = 0; i < num_opcodes;) {
+    BytecodeOp op = nextBytecodeOp(bytecode, &i);
+    IcSiteState state = icSiteState(op.bc);
+    if (state == IcSiteState::kGeneric) continue;
+    types = runtime->newList();
+    // Module attribute caches are keyed by module id instead of a layout id.
+    if (isByteCodeWithCache(op.bc) && op.bc != LOAD_ATTR_MODULE &&
+        caches_obj.isMutableTuple()) {
+      RawMutableTuple caches = MutableTuple::cast(*caches_obj);
+      word index = op.cache * kIcPointersPerEntry;
+      RawObject key = caches.at(index + kIcEntryKeyOffset);
+      if (key.isUnbound()) {
+        MutableTuple polymorphic_cache(
+            &scope, caches.at(index + kIcEntryValueOffset));
+        for (word j = 0; j < kIcPointersPerPolyCache;
+             j += kIcPointersPerEntry) {
+          appendCachedTypes(thread, op.bc,
+                            polymorphic_cache.at(j + kIcEntryKeyOffset), types);
+        }
+      } else {
+        appendCachedTypes(thread, op.bc, key, types);
+      }
+    }
+    offset = SmallInt::fromWord((i - 1) * kCompilerCodeUnitSize);
+    name = Runtime::internStrFromCStr(thread, kBytecodeNames[op.bc]);
+    state_name = Runtime::internStrFromCStr(thread, icSiteStateName(state));
+    items = types.items();
+    types_tuple = runtime->tupleSubseq(thread, items, 0, types.numItems());
+    site = runtime->newTupleWith4(offset, name, state_name, types_tuple);
+    runtime->listAdd(thread, result, site);
+  }
+  return *result;
+}
+
+}  // namespace py
@@ -0,0 +1,75 @@
+/* Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com) */
+#pragma once
+
+#include "bytecode.h"
+#include "globals.h"
+#include "handles-decl.h"
+
+namespace py {
+
+class Thread;
+
+// Statistics about the bytecode specialization done by the interpreter.
+//
+// Build with `-DSKYBISON_IC_STATS=1` to make the interpreters and
+// JIT-compiled code count opcode executions, cache misses and rewrites.
+// Otherwise the counters stay zero and nothing is emitted on the fast paths.
+#ifdef SKYBISON_IC_STATS
+const bool kIcStatsEnabled = true;
+#else
+const bool kIcStatsEnabled = false;
+#endif
+
+// The stages a caching site goes through as it is specialized.
+enum class IcSiteState {
+  // An opcode that is never specialized or a site that was rewritten back to
+  // the generic opcode.
+  kGeneric,
+  // Specializable, but nothing is cached yet.
+  kAnamorphic,
+  // Specialized for a single type.
+  kMonomorphic,
+  // Caches up to `kIcEntriesPerPolyCache` types.
+  kPolymorphic,
+  // Uses the runtime-wide megamorphic cache.
+  kMegamorphic,
+};
+
+const word kNumIcSiteStates = 5;
+
+// Returns the state of a site that holds `bc`.
+IcSiteState icSiteState(Bytecode bc);
+
+// Returns the lowercase name of `state`, for example "monomorphic".
+const char* icSiteStateName(IcSiteState state);
+
+// Counters kept by every thread so that counting needs no synchronization.
+// `Runtime::icStats()` adds them up.
+struct IcStats {
+  // Executions of each opcode.
+  word executions[kNumBytecodes];
+  // Cache misses of each specialized opcode.
+  word misses[kNumBytecodes];
+  // Number of times a site was rewritten to each opcode.
+  word rewrites[kNumBytecodes];
+  // Number of rewrites between site states, indexed by [from][to].
+  word transitions[kNumIcSiteStates][kNumIcSiteStates];
+  // Number of times JIT-compiled code returned to the interpreter.
+  word jit_deopts;
+
+  void add(const IcStats& other);
+
+  // Records that a site holding `from` is rewritten to `to`.
+  void countRewrite(Bytecode from, Bytecode to);
+};
+
+// Returns the counters of all threads as a dict for `sys._ic_stats()`.
+RawObject icStatsAsDict(Thread* thread);
+
+// Returns a list with a `(offset, opcode, state, types)` tuple for every
+// specialized site of `function`. `offset` is the offset in the original
+// bytecode and `types` holds the types cached at the site; binary operations
+// list `(left, right)` pairs.
+RawObject icStatsForFunction(Thread* thread, const Function& function);
+
+}  // namespace py
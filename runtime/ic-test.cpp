@@ -148,6 +148,78 @@ TEST_F(IcTest, IcUpdateAttrUpdatesPolymorphicEntry) {
   EXPECT_TRUE(is_found);
 }
 
+TEST_F(IcTest, IcUpdateAttrWithFullPolymorphicCacheReturnsMegamorphic) {
+  HandleScope scope(thread_);
+  MutableTuple caches(&scope,
+                      runtime_->newMutableTuple(1 * kIcPointersPerEntry));
+  caches.fill(NoneType::object());
+  Object value(&scope, runtime_->newInt(88));
+  Object name(&scope, Str::empty());
+  Function dependent(&scope, newEmptyFunction());
+  LayoutId layout_ids[] = {LayoutId::kSmallInt, LayoutId::kSmallStr,
+                           LayoutId::kSmallBytes, LayoutId::kBool};
+  static_assert(ARRAYSIZE(layout_ids) == kIcEntriesPerPolyCache,
+                "expected one layout id per polymorphic cache entry");
+  for (LayoutId layout_id : layout_ids) {
+    ASSERT_NE(icUpdateAttr(thread_, caches, 0, layout_id, value, name,
+                           dependent),
+              ICState::kMegamorphic);
+  }
+  EXPECT_EQ(icUpdateAttr(thread_, caches, 0, LayoutId::kNoneType, value, name,
+                         dependent),
+            ICState::kMegamorphic);
+  bool is_found;
+  icLookupPolymorphic(*caches, 0, LayoutId::kNoneType, &is_found);
+  EXPECT_FALSE(is_found);
+  EXPECT_EQ(icUpdateAttr(thread_, caches, 0, LayoutId::kBool, value, name,
+                         dependent),
+            ICState::kPolymorphic);
+}
+
+TEST_F(IcTest, IcUpdateMegamorphicSetsEntry) {
+  HandleScope scope(thread_);
+  MutableTuple cache(&scope,
+                     runtime_->newMutableTuple(kIcMegamorphicCacheEntries));
+  cache.fill(NoneType::object());
+  Object foo(&scope, Runtime::internStrFromCStr(thread_, "foo"));
+  Object long_name(&scope, Runtime::internStrFromCStr(
+                               thread_, "a_long_attribute_name"));
+  Object int_value(&scope, SmallInt::fromWord(1));
+  Object str_value(&scope, SmallInt::fromWord(2));
+  Object long_value(&scope, SmallInt::fromWord(3));
+  bool is_found;
+  EXPECT_TRUE(icLookupMegamorphic(*cache, LayoutId::kSmallInt, *foo, &is_found)
+                  .isErrorNotFound());
+  EXPECT_FALSE(is_found);
+
+  icUpdateMegamorphic(thread_, cache, LayoutId::kSmallInt, foo, int_value);
+  icUpdateMegamorphic(thread_, cache, LayoutId::kSmallStr, foo, str_value);
+  icUpdateMegamorphic(thread_, cache, LayoutId::kSmallInt, long_name,
+                      long_value);
+  EXPECT_EQ(icLookupMegamorphic(*cache, LayoutId::kSmallInt, *foo, &is_found),
+            *int_value);
+  EXPECT_TRUE(is_found);
+  EXPECT_EQ(icLookupMegamorphic(*cache, LayoutId::kSmallStr, *foo, &is_found),
+            *str_value);
+  EXPECT_TRUE(is_found);
+  EXPECT_EQ(
+      icLookupMegamorphic(*cache, LayoutId::kSmallInt, *long_name, &is_found),
+      *long_value);
+  EXPECT_TRUE(is_found);
+  EXPECT_TRUE(
+      icLookupMegamorphic(*cache, LayoutId::kSmallStr, *long_name, &is_found)
+          .isErrorNotFound());
+  EXPECT_FALSE(is_found);
+
+  icInvalidateMegamorphic(cache, foo);
+  icLookupMegamorphic(*cache, LayoutId::kSmallInt, *foo, &is_found);
+  EXPECT_FALSE(is_found);
+  icLookupMegamorphic(*cache, LayoutId::kSmallStr, *foo, &is_found);
+  EXPECT_FALSE(is_found);
+  icLookupMegamorphic(*cache, LayoutId::kSmallInt, *long_name, &is_found);
+  EXPECT_TRUE(is_found);
+}
+
 TEST_F(IcTest, IcUpdateAttrInsertsDependencyUpToDefiningType) {
   HandleScope scope(thread_);
   ASSERT_FALSE(runFromCStr(runtime_, R"(
@@ -227,6 +299,38 @@ static bool icDependentIncluded(RawObject dependent, RawObject link) {
   return false;
 }
 
+TEST_F(IcTest, IcInvalidateAttrEvictsMegamorphicCacheEntries) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class A:
+  def foo(self): pass
+
+class B(A):
+  pass
+
+b = B()
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  MutableTuple cache(&scope, runtime_->megamorphicCache());
+  Object b(&scope, mainModuleAt(runtime_, "b"));
+  Type type_a(&scope, mainModuleAt(runtime_, "A"));
+  Object foo(&scope, Runtime::internStrFromCStr(thread_, "foo"));
+  Object value(&scope, typeAt(type_a, foo));
+  icUpdateMegamorphic(thread_, cache, b.layoutId(), foo, value);
+  EXPECT_TRUE(icDependentIncluded(
+      *cache, dependencyLinkOfTypeAttr(thread_, type_a, "foo")));
+  Type type_b(&scope, mainModuleAt(runtime_, "B"));
+  EXPECT_TRUE(icDependentIncluded(
+      *cache, dependencyLinkOfTypeAttr(thread_, type_b, "foo")));
+
+  ASSERT_FALSE(runFromCStr(runtime_, "B.foo = 5").isError());
+  bool is_found;
+  icLookupMegamorphic(*cache, b.layoutId(), *foo, &is_found);
+  EXPECT_FALSE(is_found);
+  EXPECT_FALSE(icDependentIncluded(
+      *cache, dependencyLinkOfTypeAttr(thread_, type_b, "foo")));
+}
+
 TEST_F(IcTest, IcEvictAttr) {
   ASSERT_FALSE(runFromCStr(runtime_, R"(
 class A:
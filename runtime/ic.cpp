@@ -86,10 +86,10 @@ ICState icUpdateAttr(Thread* thread, const MutableTuple& caches, word cache,
       polymorphic_cache.atPut(j + kIcEntryKeyOffset, key);
       polymorphic_cache.atPut(j + kIcEntryValueOffset, *value);
       insertDependencyForTypeLookupInMro(thread, layout_id, name, dependent);
-      break;
+      return ICState::kPolymorphic;
     }
   }
-  return ICState::kPolymorphic;
+  return ICState::kMegamorphic;
 }
 
 bool icIsCacheEmpty(const MutableTuple& caches, word cache) {
@@ -97,6 +97,37 @@ bool icIsCacheEmpty(const MutableTuple& caches, word cache) {
   return caches.at(index + kIcEntryKeyOffset).isNoneType();
 }
 
+void icUpdateMegamorphic(Thread* thread, const MutableTuple& cache,
+                         LayoutId layout_id, const Object& name,
+                         const Object& value) {
+  HandleScope scope(thread);
+  uword name_hash = name.raw();
+  if (!name.isSmallStr()) {
+    name_hash = strHash(thread, *name);
+  }
+  MutableTuple entry(&scope, thread->runtime()->newMutableTuple(
+                                 kIcPointersPerMegamorphicEntry));
+  entry.atPut(kIcEntryKeyOffset,
+              SmallInt::fromWord(static_cast<word>(layout_id)));
+  entry.atPut(kIcEntryValueOffset, *value);
+  entry.atPut(kIcMegamorphicEntryNameOffset, *name);
+  cache.atPut(icMegamorphicCacheIndex(layout_id, name_hash),
+              entry.becomeImmutable());
+  insertDependencyForTypeLookupInMro(thread, layout_id, name, cache);
+}
+
+void icInvalidateMegamorphic(const MutableTuple& cache, const Object& name) {
+  RawStr name_str = Str::cast(*name);
+  for (word i = 0; i < kIcMegamorphicCacheEntries; i++) {
+    RawObject entry = cache.at(i);
+    if (entry.isTuple() &&
+        name_str.equals(
+            Str::cast(Tuple::cast(entry).at(kIcMegamorphicEntryNameOffset)))) {
+      cache.atPut(i, NoneType::object());
+    }
+  }
+}
+
 void icUpdateAttrModule(Thread* thread, const MutableTuple& caches, word cache,
                         const Object& receiver, const ValueCell& value_cell,
                         const Function& dependent) {
@@ -111,6 +142,9 @@ void icUpdateAttrModule(Thread* thread, const MutableTuple& caches, word cache,
   word pc = thread->currentFrame()->virtualPC() - kCodeUnitSize;
   DCHECK(bytecode.byteAt(pc) == LOAD_ATTR_ANAMORPHIC,
          "current opcode must be LOAD_ATTR_ANAMORPHIC");
+  if (kIcStatsEnabled) {
+    thread->icStats()->countRewrite(LOAD_ATTR_ANAMORPHIC, LOAD_ATTR_MODULE);
+  }
   bytecode.byteAtPut(pc, LOAD_ATTR_MODULE);
   icInsertDependentToValueCellDependencyLink(thread, dependent, value_cell);
 }
@@ -130,6 +164,9 @@ void icUpdateAttrType(Thread* thread, const MutableTuple& caches, word cache,
   word pc = thread->currentFrame()->virtualPC() - kCodeUnitSize;
   DCHECK(bytecode.byteAt(pc) == LOAD_ATTR_ANAMORPHIC,
          "current opcode must be LOAD_ATTR_ANAMORPHIC");
+  if (kIcStatsEnabled) {
+    thread->icStats()->countRewrite(LOAD_ATTR_ANAMORPHIC, LOAD_ATTR_TYPE);
+  }
   bytecode.byteAtPut(pc, LOAD_ATTR_TYPE);
   LayoutId layout_id = receiver.rawCast<RawType>().instanceLayoutId();
   insertDependencyForTypeLookupInMro(thread, layout_id, selector, dependent);
@@ -160,6 +197,10 @@ void icUpdateCallFunctionTypeNew(Thread* thread, const MutableTuple& caches,
   word pc = thread->currentFrame()->virtualPC() - kCodeUnitSize;
   DCHECK(bytecode.byteAt(pc) == CALL_FUNCTION_ANAMORPHIC,
          "current opcode must be CALL_FUNCTION_ANAMORPHIC");
+  if (kIcStatsEnabled) {
+    thread->icStats()->countRewrite(CALL_FUNCTION_ANAMORPHIC,
+                                    CALL_FUNCTION_TYPE_NEW);
+  }
   bytecode.byteAtPut(pc, CALL_FUNCTION_TYPE_NEW);
   if (!type.isBuiltin()) {
     icInsertConstructorDependencies(thread, static_cast<LayoutId>(id),
@@ -669,11 +710,21 @@ void icInvalidateAttr(Thread* thread, const Type& type, const Object& attr_name,
                                      ? AttributeKind::kDataDescriptor
                                      : AttributeKind::kNotADataDescriptor;
   Object link(&scope, value_cell.dependencyLink());
+  Object referent(&scope, NoneType::object());
   while (!link.isNoneType()) {
-    Function dependent(&scope, WeakLink::cast(*link).referent());
+    referent = WeakLink::cast(*link).referent();
     // Capturing the next node in case the current node is deleted by
     // icEvictCacheForTypeAttrInDependent
     link = WeakLink::cast(*link).next();
+    if (referent == thread->runtime()->megamorphicCache()) {
+      // The megamorphic cache does not track which of its entries went through
+      // this type, so drop every entry for the attribute.
+      MutableTuple cache(&scope, *referent);
+      icInvalidateMegamorphic(cache, attr_name);
+      icDeleteDependentInValueCell(thread, value_cell, cache);
+      continue;
+    }
+    Function dependent(&scope, *referent);
     icEvictCache(thread, dependent, type, attr_name, attribute_kind);
   }
   // In case is_data_descriptor is true, we shouldn't see any dependents after
@@ -773,8 +824,14 @@ void icUpdateGlobalVar(Thread* thread, const Function& function, word index,
       continue;
     }
     if (op.bc == LOAD_GLOBAL) {
+      if (kIcStatsEnabled) {
+        thread->icStats()->countRewrite(LOAD_GLOBAL, LOAD_GLOBAL_CACHED);
+      }
       rewrittenBytecodeOpAtPut(bytecode, i - 1, LOAD_GLOBAL_CACHED);
     } else if (op.bc == STORE_GLOBAL) {
+      if (kIcStatsEnabled) {
+        thread->icStats()->countRewrite(STORE_GLOBAL, STORE_GLOBAL_CACHED);
+      }
       rewrittenBytecodeOpAtPut(bytecode, i - 1, STORE_GLOBAL_CACHED);
     }
   }
@@ -830,12 +887,18 @@ void icInvalidateGlobalVar(Thread* thread, const ValueCell& value_cell) {
         case LOAD_GLOBAL_CACHED:
           original_bc = LOAD_GLOBAL;
           if (op.bc != original_bc && op.arg == name_index_found) {
+            if (kIcStatsEnabled) {
+              thread->icStats()->countRewrite(op.bc, original_bc);
+            }
             rewrittenBytecodeOpAtPut(bytecode, i - 1, original_bc);
           }
           break;
         case STORE_GLOBAL_CACHED:
           original_bc = STORE_GLOBAL;
           if (op.bc != original_bc && op.arg == name_index_found) {
+            if (kIcStatsEnabled) {
+              thread->icStats()->countRewrite(op.bc, original_bc);
+            }
             rewrittenBytecodeOpAtPut(bytecode, i - 1, original_bc);
           }
           break;
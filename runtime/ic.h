@@ -20,6 +20,12 @@ RawObject icLookupPolymorphic(RawMutableTuple caches, word cache,
 RawObject icLookupMonomorphic(RawMutableTuple caches, word cache,
                               LayoutId layout_id, bool* is_found);
 
+// Looks for an entry for the attribute `name` of instances with `layout_id` in
+// the runtime-wide megamorphic cache `cache`.
+// Returns `ErrorNotFound` if none was found, and set *is_found to false.
+RawObject icLookupMegamorphic(RawMutableTuple cache, LayoutId layout_id,
+                              RawObject name, bool* is_found);
+
 // Returns the current state of the cache at caches[cache].
 ICState icCurrentState(RawTuple caches, word cache);
 
@@ -49,13 +55,25 @@ RawSmallInt encodeBinaryOpKey(LayoutId left_layout_id, LayoutId right_layout_id,
                               BinaryOpFlags flags);
 
 // Sets a cache entry for an attribute to the given `layout_id` as key and
-// `value` as value.
+// `value` as value. Returns `ICState::kMegamorphic` without caching anything
+// when the polymorphic cache at `cache` is full.
 ICState icUpdateAttr(Thread* thread, const MutableTuple& caches, word cache,
                      LayoutId layout_id, const Object& value,
                      const Object& name, const Function& dependent);
 
 bool icIsCacheEmpty(const MutableTuple& caches, word cache);
 
+// Sets the entry for the attribute `name` of instances with `layout_id` in
+// the runtime-wide megamorphic cache `cache`, replacing whichever entry was
+// stored in its slot before. `cache` itself is registered as the dependent of
+// the type attributes the lookup went through.
+void icUpdateMegamorphic(Thread* thread, const MutableTuple& cache,
+                         LayoutId layout_id, const Object& name,
+                         const Object& value);
+
+// Removes all entries for the attribute `name` from the megamorphic cache.
+void icInvalidateMegamorphic(const MutableTuple& cache, const Object& name);
+
 void icUpdateAttrModule(Thread* thread, const MutableTuple& caches, word cache,
                         const Object& receiver, const ValueCell& value_cell,
                         const Function& dependent);
@@ -268,6 +286,21 @@ const int kIcPointersPerPolyCache =
 const int kIcEntryKeyOffset = 0;
 const int kIcEntryValueOffset = 1;
 
+// Megamorphic cache layout:
+//  Attribute loads that see more layouts than fit into a polymorphic cache
+//  are rewritten to probe a single cache shared by the whole runtime
+//  (`Runtime::megamorphicCache()`). It is a MutableTuple of
+//  kIcMegamorphicCacheEntries slots indexed by a hash of the layout id and the
+//  interned attribute name. A slot holds None or an immutable tuple
+//  (layout_id, value, name), so a slot is replaced by a single store and
+//  readers never observe half of an entry. Values are encoded like the values
+//  of attribute caches in functions.
+const int kIcMegamorphicCacheBits = 12;
+const int kIcMegamorphicCacheEntries = 1 << kIcMegamorphicCacheBits;
+
+const int kIcMegamorphicEntryNameOffset = 2;
+const int kIcPointersPerMegamorphicEntry = 3;
+
 // TODO(T54277418): Use SymbolId for binop method names.
 class IcIterator {
  public:
@@ -338,10 +371,13 @@ class IcIterator {
       case LOAD_ATTR_INSTANCE_TYPE:
       case LOAD_ATTR_INSTANCE_TYPE_BOUND_METHOD:
       case LOAD_ATTR_INSTANCE_TYPE_DESCR:
+      case LOAD_ATTR_MEGAMORPHIC:
+      case LOAD_ATTR_POLYMORPHIC:
       case LOAD_ATTR_TYPE:
       case LOAD_ATTR_ANAMORPHIC:
       case LOAD_METHOD_ANAMORPHIC:
       case LOAD_METHOD_INSTANCE_FUNCTION:
+      case LOAD_METHOD_MEGAMORPHIC:
       case LOAD_METHOD_POLYMORPHIC:
       case STORE_ATTR_INSTANCE:
       case STORE_ATTR_INSTANCE_OVERFLOW:
@@ -524,6 +560,40 @@ inline RawObject icLookupMonomorphic(RawMutableTuple caches, word cache,
   return Error::notFound();
 }
 
+// Returns the slot of the megamorphic cache for `layout_id` and a name with
+// `name_hash`.
+inline word icMegamorphicCacheIndex(LayoutId layout_id, uword name_hash) {
+  uword key = name_hash ^ (static_cast<uword>(layout_id) << 32);
+  return (key * uword{0x9e3779b97f4a7c15}) >>
+         (kBitsPerWord - kIcMegamorphicCacheBits);
+}
+
+inline RawObject icLookupMegamorphic(RawMutableTuple cache, LayoutId layout_id,
+                                     RawObject name, bool* is_found) {
+  // Small strs are hashed by their bits. Large strs use the hash in their
+  // header, which icUpdateMegamorphic() computes before adding an entry.
+  uword name_hash = name.raw();
+  if (!name.isSmallStr()) {
+    name_hash = HeapObject::cast(name).header().hashCode();
+    if (name_hash == RawHeader::kUninitializedHash) {
+      *is_found = false;
+      return Error::notFound();
+    }
+  }
+  RawObject entry = cache.at(icMegamorphicCacheIndex(layout_id, name_hash));
+  if (entry.isTuple()) {
+    RawTuple tuple = Tuple::cast(entry);
+    if (tuple.at(kIcEntryKeyOffset) ==
+            SmallInt::fromWord(static_cast<word>(layout_id)) &&
+        tuple.at(kIcMegamorphicEntryNameOffset) == name) {
+      *is_found = true;
+      return tuple.at(kIcEntryValueOffset);
+    }
+  }
+  *is_found = false;
+  return Error::notFound();
+}
+
 inline RawObject icLookupBinOpPolymorphic(RawMutableTuple caches, word cache,
                                           LayoutId left_layout_id,
                                           LayoutId right_layout_id,
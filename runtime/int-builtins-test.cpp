@@ -3,7 +3,10 @@
 
 #include <cmath>
 #include <limits>
+#include <string>
+#include <vector>
 
+#include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 
 #include "builtins.h"
@@ -850,6 +853,69 @@ TEST_F(IntBuiltinsTest, DunderMulWithPositiveNegativeLargeIntsReturnsLargeInt) {
   EXPECT_TRUE(isIntEqualsDigits(*result, expected_digits));
 }
 
+// Returns 2**(64*num_digits) - 1, negated if `negative` is true.
+static RawObject newAllOnesLargeInt(Runtime* runtime, word num_digits,
+                                    bool negative) {
+  std::vector<uword> digits(num_digits + 1, negative ? 0 : kMaxUword);
+  if (negative) {
+    digits[0] = 1;
+    digits[num_digits] = kMaxUword;
+  } else {
+    digits[num_digits] = 0;
+  }
+  return runtime->newLargeIntWithDigits(
+      {digits.data(), static_cast<word>(digits.size())});
+}
+
+// Checks that `obj` equals (2**(64*n) - 1) * (2**(64*m) - 1) for n >= m.
+static ::testing::AssertionResult isAllOnesProduct(RawObject obj, word n,
+                                                   word m) {
+  std::vector<uword> digits(n + m + 1, 0);
+  digits[0] = 1;
+  for (word i = m; i < n; i++) digits[i] = kMaxUword;
+  digits[n] = kMaxUword - 1;
+  for (word i = n + 1; i < n + m; i++) digits[i] = kMaxUword;
+  return isIntEqualsDigits(obj,
+                           {digits.data(), static_cast<word>(digits.size())});
+}
+
+TEST_F(IntBuiltinsTest, DunderMulWithKaratsubaSizedLargeIntsReturnsLargeInt) {
+  HandleScope scope(thread_);
+
+  Int left(&scope, newAllOnesLargeInt(runtime_, 100, false));
+  Int right(&scope, newAllOnesLargeInt(runtime_, 70, false));
+  Object result(&scope, runBuiltin(METH(int, __mul__), left, right));
+  EXPECT_TRUE(isAllOnesProduct(*result, 100, 70));
+}
+
+TEST_F(IntBuiltinsTest, DunderMulWithLopsidedLargeIntsReturnsLargeInt) {
+  HandleScope scope(thread_);
+
+  Int left(&scope, newAllOnesLargeInt(runtime_, 45, false));
+  Int right(&scope, newAllOnesLargeInt(runtime_, 300, false));
+  Object result(&scope, runBuiltin(METH(int, __mul__), left, right));
+  EXPECT_TRUE(isAllOnesProduct(*result, 300, 45));
+}
+
+TEST_F(IntBuiltinsTest, DunderMulWithSameLargeIntReturnsSquare) {
+  HandleScope scope(thread_);
+
+  Int num(&scope, newAllOnesLargeInt(runtime_, 150, false));
+  Object result(&scope, runBuiltin(METH(int, __mul__), num, num));
+  EXPECT_TRUE(isAllOnesProduct(*result, 150, 150));
+}
+
+TEST_F(IntBuiltinsTest,
+       DunderMulWithNegativeKaratsubaSizedLargeIntReturnsLargeInt) {
+  HandleScope scope(thread_);
+
+  Int left(&scope, newAllOnesLargeInt(runtime_, 80, true));
+  Int right(&scope, newAllOnesLargeInt(runtime_, 80, false));
+  Object result(&scope, runBuiltin(METH(int, __mul__), left, right));
+  Int negated(&scope, runBuiltin(METH(int, __neg__), result));
+  EXPECT_TRUE(isAllOnesProduct(*negated, 80, 80));
+}
+
 TEST_F(IntBuiltinsTest, DunderMulWithNonIntSelfRaisesTypeError) {
   HandleScope scope(thread_);
 
@@ -3191,5 +3257,54 @@ TEST_F(IntBuiltinsTest, CompareWithBigNegativeNumber) {
   EXPECT_GT(b.compare(*a), 0);
 }
 
+// Benchmarks
+class IntBenchmark : public benchmark::Fixture {
+ public:
+  void SetUp(benchmark::State&) { runtime_ = createTestRuntime(); }
+
+  void TearDown(benchmark::State&) { delete runtime_; }
+
+ protected:
+  Runtime* runtime_;
+};
+
+BENCHMARK_DEFINE_F(IntBenchmark, Multiply)(benchmark::State& state) {
+  Thread* thread = Thread::current();
+  HandleScope scope(thread);
+  Int left(&scope, newAllOnesLargeInt(runtime_, state.range(0), false));
+  Int right(&scope, newAllOnesLargeInt(runtime_, state.range(0), true));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runtime_->intMultiply(thread, left, right));
+  }
+}
+BENCHMARK_REGISTER_F(IntBenchmark, Multiply)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096);
+
+BENCHMARK_DEFINE_F(IntBenchmark, Square)(benchmark::State& state) {
+  Thread* thread = Thread::current();
+  HandleScope scope(thread);
+  Int num(&scope, newAllOnesLargeInt(runtime_, state.range(0), false));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runtime_->intMultiply(thread, num, num));
+  }
+}
+BENCHMARK_REGISTER_F(IntBenchmark, Square)->RangeMultiplier(4)->Range(16, 4096);
+
+BENCHMARK_DEFINE_F(IntBenchmark, NewFromDecimalStr)(benchmark::State& state) {
+  HandleScope scope(Thread::current());
+  Type type(&scope, runtime_->typeAt(LayoutId::kInt));
+  std::string digits(state.range(0), '7');
+  Str str(&scope, runtime_->newStrFromCStr(digits.c_str()));
+  Int base(&scope, SmallInt::fromWord(10));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        runBuiltin(FUNC(_builtins, _int_new_from_str), type, str, base));
+  }
+}
+BENCHMARK_REGISTER_F(IntBenchmark, NewFromDecimalStr)
+    ->RangeMultiplier(4)
+    ->Range(64, 65536);
+
 }  // namespace testing
 }  // namespace py
@@ -25,6 +25,9 @@
 
 namespace py {
 
+static void deoptimizeCurrentFunction(Thread* thread);
+static word jitUnwind(Thread* thread);
+
 namespace {
 
 #if DCHECK_IS_ON()
@@ -35,6 +38,8 @@ namespace {
 
 using namespace x64;
 
+void jitTierUpCurrentFunction(Thread* thread);
+
 const word kInstructionCacheLineSize = 64;
 
 // Abbreviated x86-64 ABI:
@@ -114,7 +119,9 @@ static_assert(kNativeStackFrameSize % 16 == 0,
 // +----------------------+
 // | opcode 255 handler   | <- handlers_base + 255 * kHandlerSize
 // +----------------------+
-const word kHandlerSizeShift = 8;
+// Counting executions for `sys._ic_stats()` makes some handlers too big for
+// the default spacing.
+const word kHandlerSizeShift = kIcStatsEnabled ? 9 : 8;
 const word kHandlerSize = 1 << kHandlerSizeShift;
 
 const Interpreter::OpcodeHandler kCppHandlers[] = {
@@ -171,6 +178,9 @@ struct EmitEnv {
   Label call_trampoline;
   View<RegisterAssignment> call_trampoline_assignment = kNoRegisterAssignment;
 
+  // Called with handler_assignment when a function's JIT countdown expires.
+  Label jit_tier_up;
+
   Label do_return;
   View<RegisterAssignment> do_return_assignment = kNoRegisterAssignment;
 
@@ -225,6 +235,10 @@ class JitEnv : public EmitEnv {
 
   Label deopt_handler;
 
+  // Called with the PC register holding a bytecode offset that was computed
+  // at runtime (exception handlers, `CALL_FINALLY` return addresses).
+  Label jump_to_pc;
+
  private:
   Function function_;
   Thread* thread_ = nullptr;
@@ -406,11 +420,13 @@ SaveRestoreFlags mayChangeFramePC(Bytecode bc) {
     case INPLACE_SUB_SMALLINT:
     case LOAD_ATTR_INSTANCE:
     case LOAD_ATTR_INSTANCE_TYPE_BOUND_METHOD:
+    case LOAD_ATTR_MEGAMORPHIC:
     case LOAD_ATTR_POLYMORPHIC:
     case STORE_ATTR_INSTANCE:
     case STORE_ATTR_INSTANCE_OVERFLOW:
     case STORE_ATTR_POLYMORPHIC:
     case LOAD_METHOD_INSTANCE_FUNCTION:
+    case LOAD_METHOD_MEGAMORPHIC:
     case LOAD_METHOD_POLYMORPHIC:
       return kHandlerWithoutFrameChange;
     case CALL_FUNCTION:
@@ -446,6 +462,8 @@ void emitJumpToDeopt(EmitEnv* env) {
   __ jmp(&jenv->deopt_handler, Assembler::kFarJump);
 }
 
+static void jitEmitCallPushedFrame(JitEnv* env);
+
 void emitHandleContinue(EmitEnv* env, SaveRestoreFlags flags) {
   ScratchReg r_result(env, kReturnRegs[0]);
 
@@ -455,6 +473,15 @@ void emitHandleContinue(EmitEnv* env, SaveRestoreFlags flags) {
   __ testl(r_result, r_result);
   __ jcc(NOT_ZERO, &handle_flow, Assembler::kNearJump);
 
+  // C++ handlers may push a frame for the callee instead of calling it (see
+  // Interpreter::tailcall()), which JIT-compiled code cannot just continue
+  // into.
+  Label frame_pushed;
+  if (env->in_jit && (flags & kVMFrame)) {
+    __ cmpq(env->frame, Address(env->thread, Thread::currentFrameOffset()));
+    __ jcc(NOT_EQUAL, &frame_pushed, Assembler::kFarJump);
+  }
+
   // Note that we do not restore the `kHandlerBase` for now. That saves some
   // cycles but fail to cleanly switch interpreter handlers for stackframes that
   // are already active at the time the handlers are switched.
@@ -471,6 +498,11 @@ void emitHandleContinue(EmitEnv* env, SaveRestoreFlags flags) {
     __ cmpb(r_result,
             Immediate(static_cast<byte>(Interpreter::Continue::DEOPT)));
     __ jcc(EQUAL, &deopt, Assembler::kNearJump);
+    // The handler saved the VM state before it raised.
+    __ cmpb(r_result,
+            Immediate(static_cast<byte>(Interpreter::Continue::UNWIND)));
+    env->register_state.check(env->return_handler_assignment);
+    __ jcc(EQUAL, &env->unwind_handler, Assembler::kFarJump);
     // The JIT should never get here; it should always deopt beforehand.
     __ ud2();
 
@@ -487,6 +519,13 @@ void emitHandleContinue(EmitEnv* env, SaveRestoreFlags flags) {
     __ jmp(r_result);
   }
 
+  if (env->in_jit && (flags & kVMFrame)) {
+    JitEnv* jenv = static_cast<JitEnv*>(env);
+    __ bind(&frame_pushed);
+    env->register_state.resetTo(jenv->jit_handler_assignment);
+    jitEmitCallPushedFrame(jenv);
+  }
+
   env->register_state.reset();
 }
 
@@ -695,25 +734,26 @@ void emitIcLookupMonomorphic(EmitEnv* env, Label* not_found, Register r_dst,
   __ movq(r_dst, Address(r_caches, kIcEntryValueOffset * kPointerSize));
 }
 
-// Allocate and push a BoundMethod on the stack. If the heap is full and a GC
-// is needed, jump to slow_path instead. r_self and r_function will be used to
-// populate the BoundMethod. r_space and r_scratch are used as scratch
-// registers.
+// Allocate and push a BoundMethod on the stack. If the allocation buffer of
+// the thread is exhausted, jump to slow_path instead. r_self and r_function
+// will be used to populate the BoundMethod. r_space and r_scratch are used as
+// scratch registers.
 //
 // Writes to r_space and r_scratch.
 void emitPushBoundMethod(EmitEnv* env, Label* slow_path, Register r_self,
                          Register r_function, Register r_space) {
   ScratchReg r_scratch(env);
-  __ movq(r_space, Address(env->thread, Thread::runtimeOffset()));
-  __ movq(r_space,
-          Address(r_space, Runtime::heapOffset() + Heap::spaceOffset()));
+  // The allocation buffer belongs to this thread; no atomics are needed.
+  __ leaq(r_space, Address(env->thread, Thread::allocationBufferOffset()));
 
-  __ movq(r_scratch, Address(r_space, Space::fillOffset()));
+  __ movq(r_scratch, Address(r_space, AllocationBuffer::fillOffset()));
   int num_attrs = BoundMethod::kSize / kPointerSize;
-  __ addq(r_scratch, Immediate(Instance::allocationSize(num_attrs)));
-  __ cmpq(r_scratch, Address(r_space, Space::endOffset()));
+  word size = Instance::allocationSize(num_attrs);
+  __ addq(r_scratch, Immediate(size));
+  __ cmpq(r_scratch, Address(r_space, AllocationBuffer::limitOffset()));
   __ jcc(GREATER, slow_path, Assembler::kFarJump);
-  __ xchgq(r_scratch, Address(r_space, Space::fillOffset()));
+  __ movq(Address(r_space, AllocationBuffer::fillOffset()), r_scratch);
+  __ subq(r_scratch, Immediate(size));
   RawHeader header = Header::from(num_attrs, 0, LayoutId::kBoundMethod,
                                   ObjectFormat::kObjects);
   __ movq(Address(r_scratch, 0), Immediate(header.raw()));
@@ -753,6 +793,23 @@ void emitLoadOverflowTuple(EmitEnv* env, Register r_dst, Register r_layout_id,
   __ movq(r_dst, Address(r_obj, r_dst, TIMES_4, heapObjectDisp(0)));
 }
 
+// Write barrier: mark the card of the word at address r_slot as dirty. Spaces
+// are aligned to Space::kAlignment with their card table at the very start, so
+// the table is found by clearing the low bits of the address.
+//
+// Writes to r_slot and r_scratch.
+static void emitMarkCard(EmitEnv* env, Register r_slot, Register r_scratch) {
+  static_assert(Space::kAlignment == uword{1} << 32,
+                "card table lookup assumes 4GiB aligned spaces");
+  __ movq(r_scratch, r_slot);
+  __ shrq(r_scratch, Immediate(32));
+  __ shlq(r_scratch, Immediate(32));
+  // A 32-bit move zero-extends, leaving the offset into the space.
+  __ movl(r_slot, r_slot);
+  __ shrq(r_slot, Immediate(Space::kCardShift));
+  __ movb(Address(r_scratch, r_slot, TIMES_1, 0), Immediate(Space::kDirtyCard));
+}
+
 // Push/pop from/into an attribute of r_obj, given a SmallInt offset in r_offset
 // (which may be negative to signal an overflow attribute). r_layout_id should
 // contain the object's LayoutId as a SmallInt and is used to look up the
@@ -762,16 +819,25 @@ void emitLoadOverflowTuple(EmitEnv* env, Register r_dst, Register r_layout_id,
 // next at that location, and jumps to next at the end of the overflow attribute
 // case.
 //
-// Writes to r_offset.
+// Stores (popq) are followed by a write barrier.
+//
+// Writes to r_offset and, for stores, to r_layout_id.
 void emitAttrWithOffset(EmitEnv* env, void (Assembler::*asm_op)(Address),
                         Label* next, Register r_obj, Register r_offset,
                         Register r_layout_id) {
+  bool is_store =
+      asm_op == static_cast<void (Assembler::*)(Address)>(&Assembler::popq);
   Label is_overflow;
   emitConvertFromSmallInt(env, r_offset);
   __ testq(r_offset, r_offset);
   __ jcc(SIGN, &is_overflow, Assembler::kNearJump);
   // In-object attribute. For now, asm_op is always pushq or popq.
-  (env->as.*asm_op)(Address(r_obj, r_offset, TIMES_1, heapObjectDisp(0)));
+  Address in_object(r_obj, r_offset, TIMES_1, heapObjectDisp(0));
+  (env->as.*asm_op)(in_object);
+  if (is_store) {
+    __ leaq(r_offset, in_object);
+    emitMarkCard(env, r_offset, r_layout_id);
+  }
   __ bind(next);
   emitNextOpcode(env);
 
@@ -780,7 +846,12 @@ void emitAttrWithOffset(EmitEnv* env, void (Assembler::*asm_op)(Address),
   emitLoadOverflowTuple(env, r_scratch, r_layout_id, r_obj);
   // The real tuple index is -offset - 1, which is the same as ~offset.
   __ notq(r_offset);
-  (env->as.*asm_op)(Address(r_scratch, r_offset, TIMES_8, heapObjectDisp(0)));
+  Address overflow(r_scratch, r_offset, TIMES_8, heapObjectDisp(0));
+  (env->as.*asm_op)(overflow);
+  if (is_store) {
+    __ leaq(r_offset, overflow);
+    emitMarkCard(env, r_offset, r_layout_id);
+  }
   __ jmp(next, Assembler::kNearJump);
 }
 
@@ -1028,13 +1099,60 @@ static void emitPseudoCall(EmitEnv* env, Register r_function) {
   __ bind(&next);
 }
 
+// Continue after a callee returned to JIT-compiled code with an emulated
+// `ret'. The callee already popped its frame; if it raised it left
+// `Error::exception()` in place of a result and this frame has to unwind.
+static void jitEmitHandleCallResult(JitEnv* env) {
+  Label unwind;
+  __ cmpq(Address(RSP, 0), Immediate(Error::exception().raw()));
+  __ jcc(EQUAL, &unwind, Assembler::kNearJump);
+  emitNextOpcode(env);
+
+  __ bind(&unwind);
+  {
+    ScratchReg r_scratch(env);
+    __ popq(r_scratch);
+  }
+  env->register_state.assign(&env->pc, kPCReg);
+  __ movq(env->pc, Immediate(env->virtualPC()));
+  emitSaveInterpreterState(env, kVMPC | kVMStack | kVMFrame);
+  env->register_state.check(env->return_handler_assignment);
+  __ jmp(&env->unwind_handler, Assembler::kFarJump);
+}
+
+// Run a frame that a C++ handler pushed in the assembly interpreter and
+// return here once it is done, the same way as for emitPseudoCall().
+static void jitEmitCallPushedFrame(JitEnv* env) {
+  Label next;
+  {
+    ScratchReg r_frame(env);
+    ScratchReg r_scratch(env);
+    __ movq(r_frame, Address(env->thread, Thread::currentFrameOffset()));
+    __ movq(r_scratch, Immediate(word{Frame::ReturnMode::kJitReturn}
+                                 << Frame::kReturnModeOffset));
+    __ orq(Address(r_frame, Frame::kBlockStackDepthReturnModeOffset),
+           r_scratch);
+
+    __ subq(RBP, Immediate(kCallStackAlignment));
+    __ leaq(r_scratch, &next);
+    __ movq(Address(RBP, -kNativeStackFrameSize), r_scratch);
+  }
+  emitRestoreInterpreterState(env, kGenericHandler);
+  emitNextOpcodeImpl(env);
+  // `next' label address must be able to fit in a SmallInt.
+  __ align(1 << Object::kSmallIntTagBits);
+  __ bind(&next);
+  env->register_state.resetTo(env->jit_handler_assignment);
+  jitEmitHandleCallResult(env);
+}
+
 static void emitFunctionCall(EmitEnv* env, Register r_function) {
   emitSetReturnMode(env);
   if (env->in_jit) {
     // TODO(T91716080): Push next opcode as return address instead of
     // emitNextOpcode second jump
     emitPseudoCall(env, r_function);
-    emitNextOpcode(env);
+    jitEmitHandleCallResult(static_cast<JitEnv*>(env));
   } else {
     emitJumpToEntryAsm(env, r_function);
   }
@@ -1104,7 +1222,10 @@ void emitHandler<STORE_SUBSCR_LIST>(EmitEnv* env) {
   // Therefore, applying TIMES_4 will compute index * 8.
   static_assert(Object::kSmallIntTag == 0, "unexpected tag for SmallInt");
   static_assert(Object::kSmallIntTagBits == 1, "unexpected tag for SmallInt");
-  __ movq(Address(r_container, r_key, TIMES_4, heapObjectDisp(0)), r_layout_id);
+  Address item(r_container, r_key, TIMES_4, heapObjectDisp(0));
+  __ movq(item, r_layout_id);
+  __ leaq(r_key, item);
+  emitMarkCard(env, r_key, r_layout_id);
 
   emitNextOpcode(env);
 
@@ -1380,7 +1501,10 @@ void emitHandler<STORE_ATTR_INSTANCE>(EmitEnv* env) {
   emitIcLookupMonomorphic(env, &slow_path, r_cache_value, r_layout_id,
                           r_caches);
   emitConvertFromSmallInt(env, r_cache_value);
-  __ popq(Address(r_base, r_cache_value, TIMES_1, heapObjectDisp(0)));
+  Address attribute(r_base, r_cache_value, TIMES_1, heapObjectDisp(0));
+  __ popq(attribute);
+  __ leaq(r_caches, attribute);
+  emitMarkCard(env, r_caches, r_layout_id);
   emitNextOpcode(env);
 
   __ bind(&slow_path);
@@ -1412,7 +1536,10 @@ void emitHandler<STORE_ATTR_INSTANCE_OVERFLOW>(EmitEnv* env) {
     emitLoadOverflowTuple(env, r_scratch, r_layout_id, r_base);
     // The real tuple index is -offset - 1, which is the same as ~offset.
     __ notq(r_cache_value);
-    __ popq(Address(r_scratch, r_cache_value, TIMES_8, heapObjectDisp(0)));
+    Address attribute(r_scratch, r_cache_value, TIMES_8, heapObjectDisp(0));
+    __ popq(attribute);
+    __ leaq(r_caches, attribute);
+    emitMarkCard(env, r_caches, r_layout_id);
     emitNextOpcode(env);
   }
 
@@ -1449,6 +1576,17 @@ void emitHandler<STORE_ATTR_POLYMORPHIC>(EmitEnv* env) {
   emitJumpToGenericHandler(env);
 }
 
+// Counts down the JIT countdown of r_function and jumps to the tier up stub
+// once it expires. Expects the handler register assignment.
+static void emitJitCountdown(EmitEnv* env, Register r_function) {
+  DCHECK(!env->in_jit, "compiled functions do not count down");
+  static_assert(Object::kSmallIntTag == 0, "unexpected tag");
+  __ subq(Address(r_function, heapObjectDisp(RawFunction::kJitCountdownOffset)),
+          smallIntImmediate(1));
+  env->register_state.check(env->handler_assignment);
+  __ jcc(ZERO, &env->jit_tier_up, Assembler::kFarJump);
+}
+
 static void emitPushCallFrame(EmitEnv* env, Label* stack_overflow) {
   ScratchReg r_initial_size(env);
 
@@ -1602,6 +1740,7 @@ static void emitFunctionEntrySimpleInterpretedHandler(EmitEnv* env,
   __ jcc(NOT_EQUAL, &env->call_interpreted_slow_path, Assembler::kFarJump);
 
   emitPushCallFrame(env, /*stack_overflow=*/&env->call_interpreted_slow_path);
+  emitJitCountdown(env, env->callable);
   emitNextOpcode(env);
 
   env->register_state.check(env->call_interpreted_slow_path_assignment);
@@ -1635,9 +1774,28 @@ void emitCallTrampoline(EmitEnv* env) {
                 "type mismatch");
   emitCallReg(env, r_scratch);
   ScratchReg r_result(env, kReturnRegs[0]);
-  // if (result.isErrorException()) return UNWIND;
+  if (env->in_jit) {
+    // if (result.isErrorException()) return UNWIND;
+    __ cmpl(r_result, Immediate(Error::exception().raw()));
+    __ jcc(EQUAL, &env->unwind_handler, Assembler::kFarJump);
+    emitRestoreInterpreterState(env, kHandlerWithoutFrameChange);
+    __ pushq(r_result);
+    emitNextOpcode(env);
+    return;
+  }
+  // if (result.isErrorException() && !return_to_jit) return UNWIND;
+  // JIT-compiled callers check for the exception themselves.
+  Label push_result;
   __ cmpl(r_result, Immediate(Error::exception().raw()));
-  __ jcc(EQUAL, &env->unwind_handler, Assembler::kFarJump);
+  __ jcc(NOT_EQUAL, &push_result, Assembler::kNearJump);
+  {
+    ScratchReg r_return_mode(env);
+    __ movq(r_return_mode, env->return_mode);
+    __ shrq(r_return_mode, Immediate(Frame::kReturnModeOffset));
+    __ cmpq(r_return_mode, Immediate(Frame::ReturnMode::kJitReturn));
+    __ jcc(NOT_EQUAL, &env->unwind_handler, Assembler::kFarJump);
+  }
+  __ bind(&push_result);
   emitRestoreInterpreterState(env, kHandlerWithoutFrameChange);
   __ pushq(r_result);
   // if (return_to_jit) ret;
@@ -1678,11 +1836,25 @@ void emitFunctionEntryWithNoIntrinsicHandler(EmitEnv* env, Label* next_opcode) {
   __ jcc(NOT_EQUAL, &env->call_interpreted_slow_path, Assembler::kFarJump);
 
   emitPushCallFrame(env, &env->call_interpreted_slow_path);
+  emitJitCountdown(env, env->callable);
 
   __ bind(next_opcode);
   emitNextOpcode(env);
 }
 
+// Gives the runtime a chance to JIT-compile the function of the current frame
+// and continues interpreting the frame afterwards.
+static void emitJitTierUp(EmitEnv* env) {
+  emitSaveInterpreterState(env, kVMPC | kVMStack | kVMFrame);
+  {
+    ScratchReg r_arg0(env, kArgRegs[0]);
+    __ movq(r_arg0, env->thread);
+    emitCall<void (*)(Thread*)>(env, jitTierUpCurrentFunction);
+  }
+  emitRestoreInterpreterState(env, kGenericHandler);
+  emitNextOpcode(env);
+}
+
 static void emitCallInterpretedSlowPath(EmitEnv* env) {
   // Interpreter::callInterpreted(thread, nargs, function)
   ScratchReg r_arg2(env, kArgRegs[2]);
@@ -1694,6 +1866,35 @@ static void emitCallInterpretedSlowPath(EmitEnv* env) {
   emitCall<Interpreter::Continue (*)(Thread*, word, RawFunction)>(
       env, Interpreter::callInterpreted);
   emitRestoreInterpreterState(env, kHandlerBase);
+
+  // The callee frame returns to the caller the same way as a frame pushed by
+  // emitPushCallFrame(), so it needs the caller's return mode.
+  Label handle_continue;
+  {
+    ScratchReg r_result(env, kReturnRegs[0]);
+    ScratchReg r_scratch(env);
+    __ movq(r_scratch, env->return_mode);
+    __ shrq(r_scratch, Immediate(Frame::kReturnModeOffset));
+    __ cmpq(r_scratch, Immediate(Frame::ReturnMode::kJitReturn));
+    __ jcc(NOT_EQUAL, &handle_continue, Assembler::kNearJump);
+
+    Label unwind;
+    static_assert(static_cast<int>(Interpreter::Continue::NEXT) == 0,
+                  "NEXT must be 0");
+    __ testl(r_result, r_result);
+    __ jcc(NOT_ZERO, &unwind, Assembler::kNearJump);
+    __ movq(r_scratch, Address(env->thread, Thread::currentFrameOffset()));
+    __ orq(Address(r_scratch, Frame::kBlockStackDepthReturnModeOffset),
+           env->return_mode);
+    __ jmp(&handle_continue, Assembler::kNearJump);
+
+    // No frame was pushed; let the JIT-compiled caller unwind.
+    __ bind(&unwind);
+    emitRestoreInterpreterState(env, kGenericHandler);
+    __ pushq(Immediate(Error::exception().raw()));
+    emitPseudoRet(env);
+  }
+  __ bind(&handle_continue);
   emitHandleContinueIntoInterpreter(env, kGenericHandler);
 }
 
@@ -1721,10 +1922,19 @@ void emitFunctionEntryWithIntrinsicHandler(EmitEnv* env) {
   __ popq(env->callable);
   emitRestoreInterpreterState(env, kHandlerWithoutFrameChange);
   __ testb(r_result, r_result);
-  Label next_opcode;
-  __ jcc(NOT_ZERO, &next_opcode, Assembler::kFarJump);
+  Label intrinsic_succeeded;
+  __ jcc(NOT_ZERO, &intrinsic_succeeded, Assembler::kFarJump);
 
+  Label next_opcode;
   emitFunctionEntryWithNoIntrinsicHandler(env, &next_opcode);
+
+  // The intrinsic pushed its result; return to the caller, which may be
+  // JIT-compiled code that expects an emulated `ret'.
+  __ bind(&intrinsic_succeeded);
+  __ shrq(env->return_mode, Immediate(Frame::kReturnModeOffset));
+  __ cmpq(env->return_mode, Immediate(Frame::ReturnMode::kJitReturn));
+  __ jcc(NOT_EQUAL, &next_opcode, Assembler::kFarJump);
+  emitPseudoRet(env);
 }
 
 void emitFunctionEntryBuiltin(EmitEnv* env, word nargs) {
@@ -1778,11 +1988,21 @@ void emitFunctionEntryBuiltin(EmitEnv* env, word nargs) {
   }
   ScratchReg r_result(env, kReturnRegs[0]);
 
-  // if (return.isErrorException()) return UNWIND;
+  // if (return.isErrorException() && !return_to_jit) return UNWIND;
+  // JIT-compiled callers check for the exception themselves.
+  Label pop_frame;
   __ cmpl(r_result, Immediate(Error::exception().raw()));
-  __ jcc(EQUAL, &unwind, Assembler::kFarJump);
+  __ jcc(NOT_EQUAL, &pop_frame, Assembler::kNearJump);
+  {
+    ScratchReg r_scratch(env);
+    __ movq(r_scratch, env->return_mode);
+    __ shrq(r_scratch, Immediate(Frame::kReturnModeOffset));
+    __ cmpq(r_scratch, Immediate(Frame::ReturnMode::kJitReturn));
+    __ jcc(NOT_EQUAL, &unwind, Assembler::kFarJump);
+  }
 
   // thread->popFrame()
+  __ bind(&pop_frame);
   __ leaq(RSP, Address(env->frame,
                        locals_offset + (Frame::kFunctionOffsetFromLocals + 1) *
                                            kPointerSize));
@@ -2233,8 +2453,38 @@ void emitHandler<JUMP_IF_TRUE_OR_POP>(EmitEnv* env) {
 
 template <>
 void emitHandler<JUMP_ABSOLUTE>(EmitEnv* env) {
+  if (env->in_jit) {
+    emitJumpAbsolute(env);
+    emitNextOpcodeFallthrough(env);
+    return;
+  }
+  Label next;
+  Label safepoint;
+  {
+    // Only backward jumps count towards the JIT countdown.
+    ScratchReg r_target(env);
+    __ leaq(r_target, Address(env->oparg, TIMES_2, 0));
+    __ cmpl(r_target, env->pc);
+    __ jcc(GREATER, &next, Assembler::kNearJump);
+    // Loops poll for safepoints so they cannot hold up a garbage collection.
+    __ testb(Address(env->thread, Thread::interruptFlagsOffset()),
+             Immediate(Thread::kSafepoint));
+    __ jcc(NOT_ZERO, &safepoint, Assembler::kFarJump);
+    ScratchReg r_function(env);
+    __ movq(r_function, Address(env->frame, Frame::kLocalsOffsetOffset));
+    __ movq(r_function,
+            Address(env->frame, r_function, TIMES_1,
+                    Frame::kFunctionOffsetFromLocals * kPointerSize));
+    emitJumpAbsolute(env);
+    emitJitCountdown(env, r_function);
+    emitNextOpcode(env);
+  }
+  __ bind(&next);
   emitJumpAbsolute(env);
-  emitNextOpcodeFallthrough(env);
+  emitNextOpcode(env);
+
+  __ bind(&safepoint);
+  emitJumpToGenericHandler(env);
 }
 
 template <>
@@ -2555,9 +2805,13 @@ void emitInterpreter(EmitEnv* env) {
   env->handler_assignment = handler_assignment;
 
   RegisterAssignment call_interpreted_slow_path_assignment[] = {
-      {&env->pc, kPCReg},       {&env->callable, kCallableReg},
-      {&env->frame, kFrameReg}, {&env->thread, kThreadReg},
-      {&env->oparg, kOpargReg}, {&env->handlers_base, kHandlersBaseReg},
+      {&env->pc, kPCReg},
+      {&env->callable, kCallableReg},
+      {&env->frame, kFrameReg},
+      {&env->thread, kThreadReg},
+      {&env->oparg, kOpargReg},
+      {&env->handlers_base, kHandlersBaseReg},
+      {&env->return_mode, kReturnModeReg},
   };
   env->call_interpreted_slow_path_assignment =
       call_interpreted_slow_path_assignment;
@@ -2740,14 +2994,30 @@ void jitEmitHandler<JUMP_FORWARD>(JitEnv* env) {
 template <>
 void jitEmitHandler<RETURN_VALUE>(JitEnv* env) {
   ScratchReg r_return_value(env);
+  ScratchReg r_return_mode(env);
+  Label fast_path;
+  Label slow_path;
 
-  // The return mode for simple interpreted functions is normally 0 (see
-  // emitPushCallFrame/Thread::pushCallFrameImpl), so we can skip the slow
-  // path.
   // TODO(T89514778): When profiling is enabled, discard all JITed functions
   // and stop JITing.
 
+  // Frames called from the assembly interpreter have a return mode of 0 and
+  // frames called from JIT-compiled code have kJitReturn. Everything else goes
+  // to slow_path. frame->blockStackDepth() should always be 0 here.
+  __ movq(r_return_mode,
+          Address(env->frame, Frame::kBlockStackDepthReturnModeOffset));
+  __ testq(r_return_mode, r_return_mode);
+  __ jcc(ZERO, &fast_path, Assembler::kNearJump);
+  {
+    ScratchReg r_scratch(env);
+    __ movq(r_scratch, Immediate(word{Frame::ReturnMode::kJitReturn}
+                                 << Frame::kReturnModeOffset));
+    __ cmpq(r_return_mode, r_scratch);
+    __ jcc(NOT_EQUAL, &slow_path, Assembler::kFarJump);
+  }
+
   // Fast path: pop return value, restore caller frame, push return value.
+  __ bind(&fast_path);
   __ popq(r_return_value);
 
   {
@@ -2762,16 +3032,97 @@ void jitEmitHandler<RETURN_VALUE>(JitEnv* env) {
     __ movq(env->frame, Address(env->frame, Frame::kPreviousFrameOffset));
   }
 
-  // Need to restore handler base from the calling frame, which (so far) is
-  // always the assembly interpreter. This allows emitNextOpcode to find a
-  // handler for the next opcode.
+  // Need to restore handler base from the calling frame, which is either the
+  // assembly interpreter or JIT-compiled code expecting an emulated `ret'.
   emitRestoreInterpreterState(env, kBytecode | kVMPC | kHandlerBase);
   __ pushq(r_return_value);
+  Label return_to_jit;
+  __ testq(r_return_mode, r_return_mode);
+  __ jcc(NOT_ZERO, &return_to_jit, Assembler::kNearJump);
+  emitNextOpcodeImpl(env);
+
+  __ bind(&return_to_jit);
+  emitPseudoRet(env);
+
+  __ bind(&slow_path);
+  emitSaveInterpreterState(env, kVMStack | kVMFrame);
+  const word handler_offset =
+      -(Interpreter::kNumContinues -
+        static_cast<int>(Interpreter::Continue::RETURN)) *
+      kHandlerSize;
+  ScratchReg r_scratch(env);
+  __ leaq(r_scratch, Address(env->handlers_base, handler_offset));
+  env->register_state.check(env->return_handler_assignment);
+  __ jmp(r_scratch);
+}
+
+template <>
+void jitEmitHandler<CALL_FINALLY>(JitEnv* env) {
+  // Push the return address for END_FINALLY and jump into the finally block.
+  __ pushq(smallIntImmediate(env->virtualPC()));
+  __ jmp(env->opcodeAtByteOffset(env->virtualPC() +
+                                 env->currentOp().arg * kCodeUnitScale),
+         Assembler::kFarJump);
+}
+
+template <>
+void jitEmitHandler<END_FINALLY>(JitEnv* env) {
+  jitEmitGenericHandlerSetup(env);
+  __ movq(kArgRegs[0], env->thread);
+  emitSaveInterpreterState(env, kVMPC | kVMStack | kVMFrame);
+  emitCall<Interpreter::Continue (*)(Thread*, word)>(env,
+                                                     kCppHandlers[END_FINALLY]);
+  Label unwind;
+  {
+    ScratchReg r_result(env, kReturnRegs[0]);
+    static_assert(static_cast<int>(Interpreter::Continue::NEXT) == 0,
+                  "NEXT must be 0");
+    __ testl(r_result, r_result);
+    __ jcc(NOT_ZERO, &unwind, Assembler::kNearJump);
+  }
+  // Continue at the return address pushed by CALL_FINALLY, if any.
+  emitRestoreInterpreterState(env, kGenericHandler);
+  __ cmpl(env->pc, Immediate(env->virtualPC()));
+  __ jcc(NOT_EQUAL, &env->jump_to_pc, Assembler::kFarJump);
+  emitNextOpcode(env);
+
+  __ bind(&unwind);
+  env->register_state.check(env->return_handler_assignment);
+  __ jmp(&env->unwind_handler, Assembler::kFarJump);
+}
+
+// Jump to the code for the bytecode offset in the PC register. Only offsets
+// that the block stack can produce are looked up; anything else continues in
+// the assembly interpreter.
+void jitEmitJumpToPC(JitEnv* env) {
+  HandleScope scope(env->compilingThread());
+  MutableBytes code(&scope,
+                    Function::cast(env->function()).rewrittenBytecode());
+  for (word i = 0; i < env->numOpcodes();) {
+    BytecodeOp op = nextBytecodeOp(code, &i);
+    word next_pc = i * kCodeUnitSize;
+    word target;
+    switch (op.bc) {
+      case CALL_FINALLY:
+        target = next_pc;
+        break;
+      case SETUP_ASYNC_WITH:
+      case SETUP_FINALLY:
+      case SETUP_WITH:
+        target = next_pc + op.arg * kCodeUnitScale;
+        break;
+      default:
+        continue;
+    }
+    __ cmpl(env->pc, Immediate(target));
+    __ jcc(EQUAL, env->opcodeAtByteOffset(target), Assembler::kFarJump);
+  }
   emitNextOpcodeImpl(env);
 }
 
 bool isSupportedInJIT(Bytecode bc) {
   switch (bc) {
+    case BEGIN_FINALLY:
     case BINARY_ADD:
     case BINARY_ADD_SMALLINT:
     case BINARY_AND:
@@ -2807,6 +3158,7 @@ bool isSupportedInJIT(Bytecode bc) {
     case BUILD_TUPLE:
     case BUILD_TUPLE_UNPACK:
     case BUILD_TUPLE_UNPACK_WITH_CALL:
+    case CALL_FINALLY:
     case CALL_FUNCTION:
     case COMPARE_EQ_SMALLINT:
     case COMPARE_GE_SMALLINT:
@@ -2823,6 +3175,7 @@ bool isSupportedInJIT(Bytecode bc) {
     case DELETE_SUBSCR:
     case DUP_TOP:
     case DUP_TOP_TWO:
+    case END_FINALLY:
     case FORMAT_VALUE:
     case FOR_ITER:
     case FOR_ITER_LIST:
@@ -2855,6 +3208,7 @@ bool isSupportedInJIT(Bytecode bc) {
     case LOAD_ATTR:
     case LOAD_ATTR_INSTANCE:
     case LOAD_ATTR_INSTANCE_TYPE_BOUND_METHOD:
+    case LOAD_ATTR_MEGAMORPHIC:
     case LOAD_ATTR_POLYMORPHIC:
     case LOAD_BOOL:
     case LOAD_BUILD_CLASS:
@@ -2869,16 +3223,21 @@ bool isSupportedInJIT(Bytecode bc) {
     case MAKE_FUNCTION:
     case MAP_ADD:
     case NOP:
+    case POP_BLOCK:
+    case POP_EXCEPT:
+    case POP_FINALLY:
     case POP_JUMP_IF_FALSE:
     case POP_JUMP_IF_TRUE:
     case POP_TOP:
     case PRINT_EXPR:
+    case RAISE_VARARGS:
     case RETURN_VALUE:
     case ROT_FOUR:
     case ROT_THREE:
     case ROT_TWO:
     case SETUP_ANNOTATIONS:
     case SETUP_ASYNC_WITH:
+    case SETUP_FINALLY:
     case SETUP_WITH:
     case SET_ADD:
     case STORE_ATTR:
@@ -2897,16 +3256,27 @@ bool isSupportedInJIT(Bytecode bc) {
     case UNARY_POSITIVE:
     case UNPACK_EX:
     case UNPACK_SEQUENCE:
+    case WITH_CLEANUP_FINISH:
+    case WITH_CLEANUP_START:
       return true;
     default:
       return false;
   }
 }
 
+void emitCountExecution(EmitEnv* env) {
+  __ incq(Address(env->thread, Thread::icStatsOffset() +
+                                   offsetof(IcStats, executions) +
+                                   env->current_op * kWordSize));
+}
+
 void emitBeforeHandler(EmitEnv* env) {
   if (env->count_opcodes) {
     __ incq(Address(env->thread, Thread::opcodeCountOffset()));
   }
+  if (kIcStatsEnabled) {
+    emitCountExecution(env);
+  }
 }
 
 word emitHandlerTable(EmitEnv* env) {
@@ -2922,17 +3292,28 @@ word emitHandlerTable(EmitEnv* env) {
     }
     __ movq(kArgRegs[0], env->thread);
 
-    // TODO(T91716258): Add JIT support here for isErrorNotFound and
-    // appropriate jmp.
     emitCall<RawObject (*)(Thread*)>(env, Interpreter::unwind);
-    ScratchReg r_result(env, kReturnRegs[0]);
-    // Check result.isErrorError()
-    __ cmpl(r_result, Immediate(Error::error().raw()));
-    env->register_state.assign(&env->return_value, r_result);
+    Label return_to_jit;
+    {
+      ScratchReg r_result(env, kReturnRegs[0]);
+      // Check result.isErrorNotFound()
+      __ cmpl(r_result, Immediate(Error::notFound().raw()));
+      __ jcc(EQUAL, &return_to_jit, Assembler::kNearJump);
+      // Check result.isErrorError()
+      __ cmpl(r_result, Immediate(Error::error().raw()));
+      env->register_state.assign(&env->return_value, r_result);
+    }
     env->register_state.check(env->do_return_assignment);
     __ jcc(NOT_EQUAL, &env->do_return, Assembler::kFarJump);
     emitRestoreInterpreterState(env, kGenericHandler);
     emitNextOpcode(env);
+
+    // The frame was called from JIT-compiled code; `unwind()` popped it and
+    // pushed `Error::exception()` as its result. Return to the JIT code, which
+    // checks for it and continues unwinding itself.
+    __ bind(&return_to_jit);
+    emitRestoreInterpreterState(env, kGenericHandler);
+    emitPseudoRet(env);
   }
 
   // RETURN pseudo-handler
@@ -2994,8 +3375,14 @@ word emitHandlerTable(EmitEnv* env) {
     env->register_state.resetTo(env->return_handler_assignment);
     HandlerSizer sizer(env, kHandlerSize);
     DCHECK(!env->in_jit, "DEOPT handler should not get hit");
-    __ breakpoint();
-    __ ud2();
+    // A function can get compiled while an interpreted activation of it is
+    // still running (see `jitTierUpCurrentFunction`). Inline cache updates in
+    // that frame invalidate the compiled code, so throw it away and re-try the
+    // current opcode.
+    __ movq(kArgRegs[0], env->thread);
+    emitCall<void (*)(Thread*)>(env, deoptimizeCurrentFunction);
+    emitRestoreInterpreterState(env, kGenericHandler);
+    emitNextOpcode(env);
   }
 
   word offset_0 = env->as.codeSize();
@@ -3057,6 +3444,10 @@ void emitSharedCode(EmitEnv* env) {
   env->register_state.resetTo(env->call_trampoline_assignment);
   emitCallTrampoline(env);
 
+  __ bind(&env->jit_tier_up);
+  env->register_state.resetTo(env->handler_assignment);
+  emitJitTierUp(env);
+
   // Emit the generic handler stubs at the end, out of the way of the
   // interesting code.
   for (word i = 0; i < 256; ++i) {
@@ -3150,8 +3541,25 @@ void* X64Interpreter::entryAsm(const Function& function) {
 
 }  // namespace
 
+// Unwinds the pending exception in the current frame if the frame handles it.
+// Returns the bytecode offset of the handler or -1 if the exception propagates
+// out of the frame.
+static word jitUnwind(Thread* thread) {
+  Frame* frame = thread->currentFrame();
+  if (!frame->blockStackHasFinally()) {
+    return -1;
+  }
+  RawObject result = Interpreter::unwind(thread);
+  DCHECK(result.isErrorError() && thread->currentFrame() == frame,
+         "expected the exception to be handled in the current frame");
+  return frame->virtualPC();
+}
+
 static void deoptimizeCurrentFunction(Thread* thread) {
   EVENT(DEOPT_FUNCTION);
+  if (kIcStatsEnabled) {
+    thread->icStats()->jit_deopts++;
+  }
   Frame* frame = thread->currentFrame();
   // Reset the PC because we're about to jump back into the assembly
   // interpreter and we want to re-try the current opcode.
@@ -3162,24 +3570,17 @@ static void deoptimizeCurrentFunction(Thread* thread) {
   function.setFlags(function.flags() & ~Function::Flags::kCompiled);
 }
 
-bool canCompileFunction(Thread* thread, const Function& function) {
+// Returns nullptr if the function can be JIT-compiled or a description of why
+// it cannot be otherwise.
+static const char* jitRejectReason(Thread* thread, const Function& function) {
   if (!function.isInterpreted()) {
-    std::fprintf(
-        stderr, "Could not compile '%s' (not interpreted)\n",
-        unique_c_ptr<char>(Str::cast(function.qualname()).toCStr()).get());
-    return false;
+    return "not interpreted";
   }
   if (!function.hasSimpleCall()) {
-    std::fprintf(
-        stderr, "Could not compile '%s' (not simple)\n",
-        unique_c_ptr<char>(Str::cast(function.qualname()).toCStr()).get());
-    return false;
+    return "not simple";
   }
   if (function.isCompiled()) {
-    std::fprintf(
-        stderr, "Could not compile '%s' (already compiled)\n",
-        unique_c_ptr<char>(Str::cast(function.qualname()).toCStr()).get());
-    return false;
+    return "already compiled";
   }
   HandleScope scope(thread);
   MutableBytes code(&scope, function.rewrittenBytecode());
@@ -3187,16 +3588,42 @@ bool canCompileFunction(Thread* thread, const Function& function) {
   for (word i = 0; i < num_opcodes;) {
     BytecodeOp op = nextBytecodeOp(code, &i);
     if (!isSupportedInJIT(op.bc)) {
-      std::fprintf(
-          stderr, "Could not compile '%s' (%s)\n",
-          unique_c_ptr<char>(Str::cast(function.qualname()).toCStr()).get(),
-          kBytecodeNames[op.bc]);
-      return false;
+      return kBytecodeNames[op.bc];
     }
   }
+  return nullptr;
+}
+
+bool canCompileFunction(Thread* thread, const Function& function) {
+  const char* reason = jitRejectReason(thread, function);
+  if (reason != nullptr) {
+    std::fprintf(
+        stderr, "Could not compile '%s' (%s)\n",
+        unique_c_ptr<char>(Str::cast(function.qualname()).toCStr()).get(),
+        reason);
+    return false;
+  }
   return true;
 }
 
+namespace {
+
+void jitTierUpCurrentFunction(Thread* thread) {
+  HandleScope scope(thread);
+  Function function(&scope, thread->currentFrame()->function());
+  // Every function is only considered once, whether it compiles or not.
+  function.setJitCountdown(SmallInt::kMaxValue);
+  Runtime* runtime = thread->runtime();
+  if (runtime->jitThreshold() == 0 ||
+      jitRejectReason(thread, function) != nullptr) {
+    return;
+  }
+  compileFunction(thread, function);
+  runtime->incrementJitTierUps();
+}
+
+}  // namespace
+
 void compileFunction(Thread* thread, const Function& function) {
   EVENT(COMPILE_FUNCTION);
   HandleScope scope(thread);
@@ -3213,6 +3640,7 @@ void compileFunction(Thread* thread, const Function& function) {
       {&env->thread, kThreadReg},
       {&env->handlers_base, kHandlersBaseReg},
       {&env->callable, kCallableReg},
+      {&env->return_mode, kReturnModeReg},
   };
   env->function_entry_assignment = function_entry_assignment;
 
@@ -3233,9 +3661,13 @@ void compileFunction(Thread* thread, const Function& function) {
   env->jit_handler_assignment = jit_handler_assignment;
 
   RegisterAssignment call_interpreted_slow_path_assignment[] = {
-      {&env->pc, kPCReg},       {&env->callable, kCallableReg},
-      {&env->frame, kFrameReg}, {&env->thread, kThreadReg},
-      {&env->oparg, kOpargReg}, {&env->handlers_base, kHandlersBaseReg},
+      {&env->pc, kPCReg},
+      {&env->callable, kCallableReg},
+      {&env->frame, kFrameReg},
+      {&env->thread, kThreadReg},
+      {&env->oparg, kOpargReg},
+      {&env->handlers_base, kHandlersBaseReg},
+      {&env->return_mode, kReturnModeReg},
   };
   env->call_interpreted_slow_path_assignment =
       call_interpreted_slow_path_assignment;
@@ -3282,9 +3714,8 @@ void compileFunction(Thread* thread, const Function& function) {
   env->register_state.check(env->call_interpreted_slow_path_assignment);
   __ jcc(NOT_EQUAL, &call_interpreted_slow_path, Assembler::kFarJump);
 
-  // Open a new frame.
-  env->register_state.assign(&env->return_mode, kReturnModeReg);
-  __ xorl(env->return_mode, env->return_mode);
+  // Open a new frame. It keeps the return mode of the caller, which is
+  // kJitReturn when called from JIT-compiled code.
   emitPushCallFrame(env, /*stack_overflow=*/&call_interpreted_slow_path);
 
   for (word i = 0; i < num_opcodes;) {
@@ -3299,6 +3730,9 @@ void compileFunction(Thread* thread, const Function& function) {
     env->register_state.resetTo(env->jit_handler_assignment);
     COMMENT("%s %d (%d)", kBytecodeNames[op.bc], op.arg, op.cache);
     __ bind(env->opcodeAtByteOffset(current_pc));
+    if (kIcStatsEnabled) {
+      emitCountExecution(env);
+    }
     switch (op.bc) {
 #define BC(name, _0, _1)                                                       \
   case name: {                                                                 \
@@ -3312,9 +3746,38 @@ void compileFunction(Thread* thread, const Function& function) {
 
   if (!env->unwind_handler.isUnused()) {
     COMMENT("Unwind");
+    // Called with the VM state saved. Continue at the exception handler if
+    // this frame has one, otherwise let the UNWIND pseudo-handler pop the
+    // frame and return to the caller.
     __ bind(&env->unwind_handler);
-    // TODO(T91715866): Unwind.
-    __ ud2();
+    env->register_state.resetTo(env->return_handler_assignment);
+    __ movq(kArgRegs[0], env->thread);
+    emitCall<word (*)(Thread*)>(env, jitUnwind);
+    Label unwind_caller;
+    {
+      ScratchReg r_result(env, kReturnRegs[0]);
+      __ testq(r_result, r_result);
+      __ jcc(SIGN, &unwind_caller, Assembler::kNearJump);
+    }
+    emitRestoreInterpreterState(env, kGenericHandler);
+    __ jmp(&env->jump_to_pc, Assembler::kFarJump);
+
+    __ bind(&unwind_caller);
+    const word handler_offset =
+        -(Interpreter::kNumContinues -
+          static_cast<int>(Interpreter::Continue::UNWIND)) *
+        kHandlerSize;
+    ScratchReg r_scratch(env);
+    __ leaq(r_scratch, Address(env->handlers_base, handler_offset));
+    env->register_state.check(env->return_handler_assignment);
+    __ jmp(r_scratch);
+  }
+
+  if (!env->jump_to_pc.isUnused()) {
+    COMMENT("Jump to PC");
+    __ bind(&env->jump_to_pc);
+    env->register_state.resetTo(env->handler_assignment);
+    jitEmitJumpToPC(env);
   }
 
   COMMENT("Call interpreted slow path");
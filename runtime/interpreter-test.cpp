@@ -5608,6 +5608,48 @@ user_obj = C()
   EXPECT_EQ(rewrittenBytecodeOpAt(bytecode, 2), FOR_ITER_MONOMORPHIC);
 }
 
+TEST_F(InterpreterTest, ForIterAnamorphicWithItertoolsIterRewritesOpcode) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+import itertools
+
+def foo(i, s=0):
+  for a in i:
+    s += a
+  return s
+
+chain_obj = itertools.chain([4], (5,))
+islice_obj = itertools.islice(itertools.count(4), 2)
+repeat_obj = itertools.repeat(3, 3)
+accumulate_obj = itertools.accumulate([1, 2, 3])
+tee_obj = itertools.tee([4, 5])[0]
+)")
+                   .isError());
+  Function foo(&scope, mainModuleAt(runtime_, "foo"));
+  MutableBytes bytecode(&scope, foo.rewrittenBytecode());
+  ASSERT_EQ(rewrittenBytecodeOpAt(bytecode, 2), FOR_ITER_ANAMORPHIC);
+
+  Object arg(&scope, mainModuleAt(runtime_, "chain_obj"));
+  EXPECT_TRUE(isIntEqualsWord(Interpreter::call1(thread_, foo, arg), 9));
+  EXPECT_EQ(rewrittenBytecodeOpAt(bytecode, 2), FOR_ITER_CHAIN);
+
+  arg = mainModuleAt(runtime_, "islice_obj");
+  EXPECT_TRUE(isIntEqualsWord(Interpreter::call1(thread_, foo, arg), 9));
+  EXPECT_EQ(rewrittenBytecodeOpAt(bytecode, 2), FOR_ITER_ISLICE);
+
+  arg = mainModuleAt(runtime_, "repeat_obj");
+  EXPECT_TRUE(isIntEqualsWord(Interpreter::call1(thread_, foo, arg), 9));
+  EXPECT_EQ(rewrittenBytecodeOpAt(bytecode, 2), FOR_ITER_REPEAT);
+
+  arg = mainModuleAt(runtime_, "accumulate_obj");
+  EXPECT_TRUE(isIntEqualsWord(Interpreter::call1(thread_, foo, arg), 10));
+  EXPECT_EQ(rewrittenBytecodeOpAt(bytecode, 2), FOR_ITER_ACCUMULATE);
+
+  arg = mainModuleAt(runtime_, "tee_obj");
+  EXPECT_TRUE(isIntEqualsWord(Interpreter::call1(thread_, foo, arg), 9));
+  EXPECT_EQ(rewrittenBytecodeOpAt(bytecode, 2), FOR_ITER_TEE);
+}
+
 TEST_F(InterpreterTest, FormatValueCallsDunderStr) {
   HandleScope scope(thread_);
   ASSERT_FALSE(runFromCStr(runtime_, R"(
@@ -6565,6 +6607,137 @@ d = D()
   EXPECT_EQ(rewrittenBytecodeOpAt(bytecode, 1), LOAD_METHOD_POLYMORPHIC);
 }
 
+TEST_F(InterpreterTest, LoadMethodWithManyTypesRewritesToMegamorphic) {
+  HandleScope scope(thread_);
+  EXPECT_FALSE(runFromCStr(runtime_, R"(
+class A:
+  def foo(self):
+    return 1
+
+class B(A): pass
+class C(A): pass
+class D(A): pass
+class E(A): pass
+
+def test(obj):
+  return obj.foo()
+
+instances = [A(), B(), C(), D(), E()]
+# The first round fills the polymorphic cache, the second one the megamorphic
+# cache.
+result = [test(obj) for obj in instances]
+result = [test(obj) for obj in instances]
+)")
+                   .isError());
+  Object result(&scope, mainModuleAt(runtime_, "result"));
+  EXPECT_PYLIST_EQ(result, {1, 1, 1, 1, 1});
+  Function test_function(&scope, mainModuleAt(runtime_, "test"));
+  MutableBytes bytecode(&scope, test_function.rewrittenBytecode());
+  EXPECT_EQ(rewrittenBytecodeOpAt(bytecode, 1), LOAD_METHOD_MEGAMORPHIC);
+
+  List instances(&scope, mainModuleAt(runtime_, "instances"));
+  Object instance(&scope, NoneType::object());
+  word hits = runtime_->megamorphicCacheHits();
+  word misses = runtime_->megamorphicCacheMisses();
+  for (word i = 0; i < instances.numItems(); i++) {
+    instance = instances.at(i);
+    result = Interpreter::call1(thread_, test_function, instance);
+    EXPECT_TRUE(isIntEqualsWord(*result, 1));
+  }
+  EXPECT_EQ(runtime_->megamorphicCacheHits(), hits + 5);
+  EXPECT_EQ(runtime_->megamorphicCacheMisses(), misses);
+
+  ASSERT_FALSE(runFromCStr(runtime_, "A.foo = lambda self: 2").isError());
+  hits = runtime_->megamorphicCacheHits();
+  misses = runtime_->megamorphicCacheMisses();
+  for (word i = 0; i < instances.numItems(); i++) {
+    instance = instances.at(i);
+    result = Interpreter::call1(thread_, test_function, instance);
+    EXPECT_TRUE(isIntEqualsWord(*result, 2));
+  }
+  EXPECT_EQ(runtime_->megamorphicCacheHits(), hits);
+  EXPECT_EQ(runtime_->megamorphicCacheMisses(), misses + 5);
+}
+
+TEST_F(InterpreterTest,
+       LoadMethodMegamorphicWithInstanceAttributeEntryPushesAttribute) {
+  HandleScope scope(thread_);
+  EXPECT_FALSE(runFromCStr(runtime_, R"(
+class A:
+  def foo(self):
+    return 1
+
+class B(A): pass
+class C(A): pass
+class D(A): pass
+class E(A): pass
+
+class F:
+  def __init__(self):
+    self.foo = lambda: 7
+
+def load_attr(obj):
+  return obj.foo
+
+def load_method(obj):
+  return obj.foo()
+
+instances = [A(), B(), C(), D(), E()]
+# Cache F().foo as an instance attribute in the megamorphic cache.
+for obj in instances:
+  load_attr(obj)
+load_attr(F())
+for obj in instances:
+  load_method(obj)
+result = load_method(F())
+)")
+                   .isError());
+  EXPECT_TRUE(isIntEqualsWord(mainModuleAt(runtime_, "result"), 7));
+  Function load_attr(&scope, mainModuleAt(runtime_, "load_attr"));
+  EXPECT_TRUE(containsBytecode(load_attr, LOAD_ATTR_MEGAMORPHIC));
+  Function load_method(&scope, mainModuleAt(runtime_, "load_method"));
+  MutableBytes bytecode(&scope, load_method.rewrittenBytecode());
+  EXPECT_EQ(rewrittenBytecodeOpAt(bytecode, 1), LOAD_METHOD_MEGAMORPHIC);
+}
+
+TEST_F(InterpreterTest, LoadAttrWithManyTypesRewritesToMegamorphic) {
+  HandleScope scope(thread_);
+  EXPECT_FALSE(runFromCStr(runtime_, R"(
+class A:
+  def __init__(self, value):
+    self.value = value
+  def method(self):
+    return self.value
+
+class B(A): pass
+class C(A): pass
+class D(A): pass
+class E(A): pass
+
+def get_value(obj):
+  return obj.value
+
+def get_method(obj):
+  return obj.method
+
+instances = [A(1), B(2), C(3), D(4), E(5)]
+values = [get_value(obj) for obj in instances]
+values = [get_value(obj) for obj in instances]
+methods = [get_method(obj)() for obj in instances]
+A.method = lambda self: -self.value
+methods = [get_method(obj)() for obj in instances]
+)")
+                   .isError());
+  Object values(&scope, mainModuleAt(runtime_, "values"));
+  EXPECT_PYLIST_EQ(values, {1, 2, 3, 4, 5});
+  Object methods(&scope, mainModuleAt(runtime_, "methods"));
+  EXPECT_PYLIST_EQ(methods, {-1, -2, -3, -4, -5});
+  Function get_value(&scope, mainModuleAt(runtime_, "get_value"));
+  EXPECT_TRUE(containsBytecode(get_value, LOAD_ATTR_MEGAMORPHIC));
+  Function get_method(&scope, mainModuleAt(runtime_, "get_method"));
+  EXPECT_TRUE(containsBytecode(get_method, LOAD_ATTR_MEGAMORPHIC));
+}
+
 TEST_F(InterpreterTest, DoLoadImmediate) {
   HandleScope scope(thread_);
   EXPECT_FALSE(runFromCStr(runtime_, R"(
@@ -6840,6 +7013,68 @@ TEST_F(JitTest, CompileFunctionSetsEntryAsm) {
   EXPECT_NE(function.entryAsm(), entry_before);
 }
 
+TEST_F(JitTest, CallingFunctionPastThresholdCompilesFunction) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+def foo():
+  return 5
+)")
+                   .isError());
+  runtime_->setJitThreshold(3);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+for i in range(4):
+  result = foo()
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Function foo(&scope, mainModuleAt(runtime_, "foo"));
+  EXPECT_TRUE(foo.isCompiled());
+  EXPECT_GE(runtime_->numJitTierUps(), 1);
+  EXPECT_TRUE(isIntEqualsWord(mainModuleAt(runtime_, "result"), 5));
+}
+
+TEST_F(JitTest, LoopingPastThresholdCompilesFunction) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+  runtime_->setJitThreshold(3);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+def foo(n):
+  total = 0
+  i = 0
+  while i < n:
+    total += i
+    i += 1
+  return total
+result = foo(10)
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Function foo(&scope, mainModuleAt(runtime_, "foo"));
+  EXPECT_TRUE(foo.isCompiled());
+  EXPECT_TRUE(isIntEqualsWord(mainModuleAt(runtime_, "result"), 45));
+}
+
+TEST_F(JitTest, CallingFunctionWithoutThresholdDoesNotCompileFunction) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+  ASSERT_EQ(runtime_->jitThreshold(), 0);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+def foo():
+  return 5
+for i in range(100):
+  foo()
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Function foo(&scope, mainModuleAt(runtime_, "foo"));
+  EXPECT_FALSE(foo.isCompiled());
+  EXPECT_EQ(runtime_->numJitTierUps(), 0);
+}
+
 // Create the function:
 //   def caller():
 //     return foo()
@@ -8257,6 +8492,37 @@ instance = E(3)
   EXPECT_NE(function.entryAsm(), entry_jit);
 }
 
+TEST_F(JitTest, LoadAttrMegamorphicWithCacheHitReturnsAttribute) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+  EXPECT_FALSE(runFromCStr(runtime_, R"(
+class A:
+  def __init__(self, value):
+    self.value = value
+
+class B(A): pass
+class C(A): pass
+class D(A): pass
+class E(A): pass
+
+def foo(obj):
+  return obj.value
+
+# Rewrite LOAD_ATTR_ANAMORPHIC to LOAD_ATTR_MEGAMORPHIC
+for obj in (A(1), B(2), C(3), D(4), E(5)):
+  foo(obj)
+instance = E(6)
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Function function(&scope, mainModuleAt(runtime_, "foo"));
+  EXPECT_TRUE(containsBytecode(function, LOAD_ATTR_MEGAMORPHIC));
+  Object obj(&scope, mainModuleAt(runtime_, "instance"));
+  Object result(&scope, compileAndCallJITFunction1(thread_, function, obj));
+  EXPECT_TRUE(isIntEqualsWord(*result, 6));
+}
+
 TEST_F(JitTest, StoreAttrInstanceWithInstanceStoresAttribute) {
   if (useCppInterpreter()) {
     GTEST_SKIP();
@@ -9175,5 +9441,168 @@ instance = D()
   EXPECT_EQ(function.entryAsm(), entry_before);
 }
 
+TEST_F(JitTest, RaiseVarargsInTryBlockJumpsToExceptHandler) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+exc = ValueError("hello")
+def foo():
+  try:
+    raise exc
+  except ValueError:
+    return 5
+  return 7
+# Rewrite LOAD_GLOBAL to LOAD_GLOBAL_CACHED
+foo()
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Function function(&scope, mainModuleAt(runtime_, "foo"));
+  EXPECT_TRUE(containsBytecode(function, RAISE_VARARGS));
+  Object result(&scope, compileAndCallJITFunction(thread_, function));
+  EXPECT_TRUE(isIntEqualsWord(*result, 5));
+  EXPECT_FALSE(thread_->hasPendingException());
+}
+
+TEST_F(JitTest, ExceptionRaisedByCalleeJumpsToExceptHandler) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+exc = ValueError("hello")
+def bar():
+  raise exc
+def foo():
+  try:
+    bar()
+  except ValueError:
+    return 5
+  return 7
+# Rewrite CALL_FUNCTION_ANAMORPHIC to CALL_FUNCTION
+foo()
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Function function(&scope, mainModuleAt(runtime_, "foo"));
+  EXPECT_TRUE(containsBytecode(function, CALL_FUNCTION));
+  Object result(&scope, compileAndCallJITFunction(thread_, function));
+  EXPECT_TRUE(isIntEqualsWord(*result, 5));
+}
+
+TEST_F(JitTest, ExceptionRaisedByCompiledCalleeJumpsToExceptHandler) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+exc = ValueError("hello")
+def bar():
+  raise exc
+def foo():
+  try:
+    bar()
+  except ValueError:
+    return 5
+  return 7
+# Rewrite CALL_FUNCTION_ANAMORPHIC to CALL_FUNCTION
+foo()
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Function callee(&scope, mainModuleAt(runtime_, "bar"));
+  compileFunction(thread_, callee);
+  Function function(&scope, mainModuleAt(runtime_, "foo"));
+  Object result(&scope, compileAndCallJITFunction(thread_, function));
+  EXPECT_TRUE(isIntEqualsWord(*result, 5));
+}
+
+TEST_F(JitTest, UnhandledExceptionPropagatesToCaller) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+exc = ValueError("hello")
+def bar():
+  raise exc
+def foo():
+  try:
+    bar()
+  except TypeError:
+    return 5
+  return 7
+# Rewrite CALL_FUNCTION_ANAMORPHIC to CALL_FUNCTION
+try:
+  foo()
+except ValueError:
+  pass
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Function callee(&scope, mainModuleAt(runtime_, "bar"));
+  compileFunction(thread_, callee);
+  Function function(&scope, mainModuleAt(runtime_, "foo"));
+  Object result(&scope, compileAndCallJITFunction(thread_, function));
+  EXPECT_TRUE(raisedWithStr(*result, LayoutId::kValueError, "hello"));
+}
+
+TEST_F(JitTest, ReturnInTryFinallyRunsFinallyBlock) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+def foo(d):
+  try:
+    return 2
+  finally:
+    d[0] = 3
+# Rewrite STORE_SUBSCR_ANAMORPHIC to STORE_SUBSCR_LIST
+foo([0])
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Function function(&scope, mainModuleAt(runtime_, "foo"));
+  EXPECT_TRUE(containsBytecode(function, CALL_FINALLY));
+  List list(&scope, runtime_->newList());
+  Object zero(&scope, SmallInt::fromWord(0));
+  runtime_->listAdd(thread_, list, zero);
+  Object result(&scope, compileAndCallJITFunction1(thread_, function, list));
+  EXPECT_TRUE(isIntEqualsWord(*result, 2));
+  EXPECT_TRUE(isIntEqualsWord(list.at(0), 3));
+}
+
+TEST_F(JitTest, WithStatementSuppressingExceptionContinuesAfterBlock) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  def __enter__(self):
+    return self
+  def __exit__(self, typ, val, tb):
+    global exited
+    exited = typ
+    return True
+exc = ValueError("hello")
+def foo(c):
+  with c:
+    raise exc
+  return 5
+instance = C()
+# Rewrite LOAD_GLOBAL to LOAD_GLOBAL_CACHED
+foo(instance)
+exited = None
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Function function(&scope, mainModuleAt(runtime_, "foo"));
+  EXPECT_TRUE(containsBytecode(function, SETUP_WITH));
+  Object instance(&scope, mainModuleAt(runtime_, "instance"));
+  Object result(&scope,
+                compileAndCallJITFunction1(thread_, function, instance));
+  EXPECT_TRUE(isIntEqualsWord(*result, 5));
+  EXPECT_EQ(mainModuleAt(runtime_, "exited"),
+            runtime_->typeAt(LayoutId::kValueError));
+}
+
 }  // namespace testing
 }  // namespace py
@@ -18,6 +18,7 @@
 #include "ic.h"
 #include "int-builtins.h"
 #include "interpreter-gen.h"
+#include "itertools-module.h"
 #include "list-builtins.h"
 #include "module-builtins.h"
 #include "object-builtins.h"
@@ -34,7 +35,11 @@
 
 // TODO(emacs): Figure out why this produces different (more) results than
 // using EVENT_ID with the opcode as arg0 and remove EVENT_CACHE.
-#define EVENT_CACHE(op) EVENT(InvalidateInlineCache_##op)
+#define EVENT_CACHE(op)                                                        \
+  do {                                                                         \
+    EVENT(InvalidateInlineCache_##op);                                         \
+    if (kIcStatsEnabled) Thread::current()->icStats()->misses[op]++;           \
+  } while (0)
 
 namespace py {
 
@@ -1397,7 +1402,12 @@ static inline word currentCacheIndex(Frame* frame) {
 
 static void rewriteCurrentBytecode(Frame* frame, Bytecode bytecode) {
   word pc = frame->virtualPC() - kCodeUnitSize;
-  MutableBytes::cast(frame->bytecode()).byteAtPut(pc, bytecode);
+  RawMutableBytes code = MutableBytes::cast(frame->bytecode());
+  if (kIcStatsEnabled) {
+    Thread::current()->icStats()->countRewrite(
+        static_cast<Bytecode>(code.byteAt(pc)), bytecode);
+  }
+  code.byteAtPut(pc, bytecode);
 }
 
 HANDLER_INLINE Continue Interpreter::doInvalidBytecode(Thread* thread, word) {
@@ -3039,6 +3049,123 @@ HANDLER_INLINE Continue Interpreter::doForIterStr(Thread* thread, word arg) {
   return Continue::NEXT;
 }
 
+// Pushes the value returned by one of the itertools `*Next()` functions, or
+// jumps past the loop body once the iterator is exhausted.
+static Continue forIterNextResult(Thread* thread, RawObject result, word arg) {
+  if (result.isErrorNoMoreItems()) {
+    Frame* frame = thread->currentFrame();
+    thread->stackPop();
+    frame->setVirtualPC(frame->virtualPC() + arg * kCodeUnitScale);
+    return Continue::NEXT;
+  }
+  if (result.isErrorException()) return Continue::UNWIND;
+  thread->stackPush(result);
+  return Continue::NEXT;
+}
+
+HANDLER_INLINE Continue Interpreter::doForIterAccumulate(Thread* thread,
+                                                         word arg) {
+  RawObject iter_obj = thread->stackTop();
+  if (!iter_obj.isAccumulate()) {
+    EVENT_CACHE(FOR_ITER_ACCUMULATE);
+    return retryForIterAnamorphic(thread, arg);
+  }
+  HandleScope scope(thread);
+  Accumulate iter(&scope, iter_obj);
+  return forIterNextResult(thread, accumulateNext(thread, iter), arg);
+}
+
+HANDLER_INLINE Continue Interpreter::doForIterChain(Thread* thread, word arg) {
+  RawObject iter_obj = thread->stackTop();
+  if (!iter_obj.isChain()) {
+    EVENT_CACHE(FOR_ITER_CHAIN);
+    return retryForIterAnamorphic(thread, arg);
+  }
+  HandleScope scope(thread);
+  Chain iter(&scope, iter_obj);
+  return forIterNextResult(thread, chainNext(thread, iter), arg);
+}
+
+HANDLER_INLINE Continue Interpreter::doForIterCount(Thread* thread, word arg) {
+  RawObject iter_obj = thread->stackTop();
+  if (!iter_obj.isCount()) {
+    EVENT_CACHE(FOR_ITER_COUNT);
+    return retryForIterAnamorphic(thread, arg);
+  }
+  HandleScope scope(thread);
+  Count iter(&scope, iter_obj);
+  return forIterNextResult(thread, countNext(thread, iter), arg);
+}
+
+HANDLER_INLINE Continue Interpreter::doForIterGroupby(Thread* thread,
+                                                      word arg) {
+  RawObject iter_obj = thread->stackTop();
+  if (!iter_obj.isGroupby()) {
+    EVENT_CACHE(FOR_ITER_GROUPBY);
+    return retryForIterAnamorphic(thread, arg);
+  }
+  HandleScope scope(thread);
+  Groupby iter(&scope, iter_obj);
+  return forIterNextResult(thread, groupbyNext(thread, iter), arg);
+}
+
+HANDLER_INLINE Continue Interpreter::doForIterIslice(Thread* thread, word arg) {
+  RawObject iter_obj = thread->stackTop();
+  if (!iter_obj.isIslice()) {
+    EVENT_CACHE(FOR_ITER_ISLICE);
+    return retryForIterAnamorphic(thread, arg);
+  }
+  HandleScope scope(thread);
+  Islice iter(&scope, iter_obj);
+  return forIterNextResult(thread, isliceNext(thread, iter), arg);
+}
+
+HANDLER_INLINE Continue Interpreter::doForIterProduct(Thread* thread,
+                                                      word arg) {
+  RawObject iter_obj = thread->stackTop();
+  if (!iter_obj.isProduct()) {
+    EVENT_CACHE(FOR_ITER_PRODUCT);
+    return retryForIterAnamorphic(thread, arg);
+  }
+  HandleScope scope(thread);
+  Product iter(&scope, iter_obj);
+  return forIterNextResult(thread, productNext(thread, iter), arg);
+}
+
+HANDLER_INLINE Continue Interpreter::doForIterRepeat(Thread* thread, word arg) {
+  RawObject iter_obj = thread->stackTop();
+  if (!iter_obj.isRepeat()) {
+    EVENT_CACHE(FOR_ITER_REPEAT);
+    return retryForIterAnamorphic(thread, arg);
+  }
+  HandleScope scope(thread);
+  Repeat iter(&scope, iter_obj);
+  return forIterNextResult(thread, repeatNext(thread, iter), arg);
+}
+
+HANDLER_INLINE Continue Interpreter::doForIterTee(Thread* thread, word arg) {
+  RawObject iter_obj = thread->stackTop();
+  if (!iter_obj.isTee()) {
+    EVENT_CACHE(FOR_ITER_TEE);
+    return retryForIterAnamorphic(thread, arg);
+  }
+  HandleScope scope(thread);
+  Tee iter(&scope, iter_obj);
+  return forIterNextResult(thread, teeNext(thread, iter), arg);
+}
+
+HANDLER_INLINE Continue Interpreter::doForIterZipLongest(Thread* thread,
+                                                         word arg) {
+  RawObject iter_obj = thread->stackTop();
+  if (!iter_obj.isZipLongest()) {
+    EVENT_CACHE(FOR_ITER_ZIP_LONGEST);
+    return retryForIterAnamorphic(thread, arg);
+  }
+  HandleScope scope(thread);
+  ZipLongest iter(&scope, iter_obj);
+  return forIterNextResult(thread, zipLongestNext(thread, iter), arg);
+}
+
 HANDLER_INLINE Continue Interpreter::doForIterMonomorphic(Thread* thread,
                                                           word arg) {
   Frame* frame = thread->currentFrame();
@@ -3095,6 +3222,33 @@ HANDLER_INLINE Continue Interpreter::doForIterAnamorphic(Thread* thread,
     case LayoutId::kGenerator:
       rewriteCurrentBytecode(frame, FOR_ITER_GENERATOR);
       return doForIterGenerator(thread, arg);
+    case LayoutId::kAccumulate:
+      rewriteCurrentBytecode(frame, FOR_ITER_ACCUMULATE);
+      return doForIterAccumulate(thread, arg);
+    case LayoutId::kChain:
+      rewriteCurrentBytecode(frame, FOR_ITER_CHAIN);
+      return doForIterChain(thread, arg);
+    case LayoutId::kCount:
+      rewriteCurrentBytecode(frame, FOR_ITER_COUNT);
+      return doForIterCount(thread, arg);
+    case LayoutId::kGroupby:
+      rewriteCurrentBytecode(frame, FOR_ITER_GROUPBY);
+      return doForIterGroupby(thread, arg);
+    case LayoutId::kIslice:
+      rewriteCurrentBytecode(frame, FOR_ITER_ISLICE);
+      return doForIterIslice(thread, arg);
+    case LayoutId::kProduct:
+      rewriteCurrentBytecode(frame, FOR_ITER_PRODUCT);
+      return doForIterProduct(thread, arg);
+    case LayoutId::kRepeat:
+      rewriteCurrentBytecode(frame, FOR_ITER_REPEAT);
+      return doForIterRepeat(thread, arg);
+    case LayoutId::kTee:
+      rewriteCurrentBytecode(frame, FOR_ITER_TEE);
+      return doForIterTee(thread, arg);
+    case LayoutId::kZipLongest:
+      rewriteCurrentBytecode(frame, FOR_ITER_ZIP_LONGEST);
+      return doForIterZipLongest(thread, arg);
     default:
       break;
   }
@@ -3704,14 +3858,23 @@ Continue Interpreter::loadAttrUpdateCache(Thread* thread, word arg,
     DCHECK(
         currentBytecode(thread) == LOAD_ATTR_INSTANCE ||
             currentBytecode(thread) == LOAD_ATTR_INSTANCE_TYPE_BOUND_METHOD ||
-            currentBytecode(thread) == LOAD_ATTR_POLYMORPHIC,
+            currentBytecode(thread) == LOAD_ATTR_POLYMORPHIC ||
+            currentBytecode(thread) == LOAD_ATTR_MEGAMORPHIC,
         "unexpected opcode");
     switch (kind) {
       case LoadAttrKind::kInstanceOffset:
       case LoadAttrKind::kInstanceFunction:
+        if (currentBytecode(thread) == LOAD_ATTR_MEGAMORPHIC ||
+            icUpdateAttr(thread, caches, cache, receiver_layout_id, location,
+                         name, dependent) == ICState::kMegamorphic) {
+          rewriteCurrentBytecode(frame, LOAD_ATTR_MEGAMORPHIC);
+          MutableTuple megamorphic_cache(&scope,
+                                         thread->runtime()->megamorphicCache());
+          icUpdateMegamorphic(thread, megamorphic_cache, receiver_layout_id,
+                              name, location);
+          break;
+        }
         rewriteCurrentBytecode(frame, LOAD_ATTR_POLYMORPHIC);
-        icUpdateAttr(thread, caches, cache, receiver_layout_id, location, name,
-                     dependent);
         break;
       default:
         break;
@@ -3933,6 +4096,27 @@ HANDLER_INLINE Continue Interpreter::doLoadAttrPolymorphic(Thread* thread,
   return Continue::NEXT;
 }
 
+HANDLER_INLINE Continue Interpreter::doLoadAttrMegamorphic(Thread* thread,
+                                                           word arg) {
+  Frame* frame = thread->currentFrame();
+  RawObject receiver = thread->stackTop();
+  Runtime* runtime = thread->runtime();
+  RawObject name = Tuple::cast(Code::cast(frame->code()).names()).at(arg);
+  bool is_found;
+  RawObject cached =
+      icLookupMegamorphic(MutableTuple::cast(runtime->megamorphicCache()),
+                          receiver.layoutId(), name, &is_found);
+  if (!is_found) {
+    runtime->incrementMegamorphicCacheMisses();
+    EVENT_CACHE(LOAD_ATTR_MEGAMORPHIC);
+    return loadAttrUpdateCache(thread, arg, currentCacheIndex(frame));
+  }
+  runtime->incrementMegamorphicCacheHits();
+  RawObject result = loadAttrWithLocation(thread, receiver, cached);
+  thread->stackSetTop(result);
+  return Continue::NEXT;
+}
+
 HANDLER_INLINE Continue Interpreter::doLoadAttrType(Thread* thread, word arg) {
   Frame* frame = thread->currentFrame();
   RawObject receiver = thread->stackTop();
@@ -4169,7 +4353,13 @@ HANDLER_INLINE Continue Interpreter::doJumpIfTrueOrPop(Thread* thread,
 
 HANDLER_INLINE Continue Interpreter::doJumpAbsolute(Thread* thread, word arg) {
   Frame* frame = thread->currentFrame();
-  frame->setVirtualPC(arg * kCodeUnitScale);
+  word target = arg * kCodeUnitScale;
+  // Loops poll for safepoints so they cannot hold up a garbage collection.
+  if (target < frame->virtualPC() &&
+      UNLIKELY(thread->isInterrupted(Thread::kSafepoint))) {
+    thread->runtime()->safepoint(thread);
+  }
+  frame->setVirtualPC(target);
   return Continue::NEXT;
 }
 
@@ -5117,8 +5307,11 @@ Continue Interpreter::loadMethodUpdateCache(Thread* thread, word arg,
 
   // Cache the attribute load.
   MutableTuple caches(&scope, frame->caches());
-  ICState next_ic_state = icUpdateAttr(
-      thread, caches, cache, receiver.layoutId(), location, name, dependent);
+  ICState next_ic_state =
+      currentBytecode(thread) == LOAD_METHOD_MEGAMORPHIC
+          ? ICState::kMegamorphic
+          : icUpdateAttr(thread, caches, cache, receiver.layoutId(), location,
+                         name, dependent);
 
   switch (next_ic_state) {
     case ICState::kMonomorphic:
@@ -5127,6 +5320,13 @@ Continue Interpreter::loadMethodUpdateCache(Thread* thread, word arg,
     case ICState::kPolymorphic:
       rewriteCurrentBytecode(frame, LOAD_METHOD_POLYMORPHIC);
       break;
+    case ICState::kMegamorphic: {
+      rewriteCurrentBytecode(frame, LOAD_METHOD_MEGAMORPHIC);
+      MutableTuple megamorphic_cache(&scope,
+                                     thread->runtime()->megamorphicCache());
+      icUpdateMegamorphic(thread, megamorphic_cache, receiver.layoutId(), name,
+                          location);
+    } break;
     case ICState::kAnamorphic:
       UNREACHABLE("next_ic_state cannot be anamorphic");
       break;
@@ -5159,6 +5359,32 @@ Interpreter::doLoadMethodInstanceFunction(Thread* thread, word arg) {
   return Continue::NEXT;
 }
 
+HANDLER_INLINE Continue Interpreter::doLoadMethodMegamorphic(Thread* thread,
+                                                             word arg) {
+  Frame* frame = thread->currentFrame();
+  RawObject receiver = thread->stackTop();
+  Runtime* runtime = thread->runtime();
+  RawObject name = Tuple::cast(Code::cast(frame->code()).names()).at(arg);
+  bool is_found;
+  RawObject cached =
+      icLookupMegamorphic(MutableTuple::cast(runtime->megamorphicCache()),
+                          receiver.layoutId(), name, &is_found);
+  if (!is_found) {
+    runtime->incrementMegamorphicCacheMisses();
+    EVENT_CACHE(LOAD_METHOD_MEGAMORPHIC);
+    return loadMethodUpdateCache(thread, arg, currentCacheIndex(frame));
+  }
+  runtime->incrementMegamorphicCacheHits();
+  if (cached.isFunction()) {
+    thread->stackInsertAt(1, cached);
+    return Continue::NEXT;
+  }
+  // The entry was added by a LOAD_ATTR site for an instance attribute.
+  thread->stackPush(loadAttrWithLocation(thread, receiver, cached));
+  thread->stackSetAt(1, Unbound::object());
+  return Continue::NEXT;
+}
+
 HANDLER_INLINE Continue Interpreter::doLoadMethodPolymorphic(Thread* thread,
                                                              word arg) {
   Frame* frame = thread->currentFrame();
@@ -6266,7 +6492,8 @@ extendedArg:
   goto* dispatch_table[bc];
 
 #define OP(name, id, handler)                                                  \
-  handle##name : cont = handler(thread, arg);                                  \
+  handle##name : if (kIcStatsEnabled) thread->icStats()->executions[name]++;   \
+  cont = handler(thread, arg);                                                 \
   if (LIKELY(cont == Continue::NEXT)) goto* next_label();                      \
   goto handle_return_or_unwind;
   FOREACH_BYTECODE(OP)
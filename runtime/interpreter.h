@@ -45,6 +45,7 @@ enum class ICState {
   kAnamorphic,
   kMonomorphic,
   kPolymorphic,
+  kMegamorphic,
 };
 
 class Interpreter {
@@ -405,16 +406,25 @@ class Interpreter {
   static Continue doEndAsyncFor(Thread* thread, word arg);
   static Continue doEndFinally(Thread* thread, word arg);
   static Continue doForIter(Thread* thread, word arg);
+  static Continue doForIterAccumulate(Thread* thread, word arg);
   static Continue doForIterAnamorphic(Thread* thread, word arg);
+  static Continue doForIterChain(Thread* thread, word arg);
+  static Continue doForIterCount(Thread* thread, word arg);
   static Continue doForIterDict(Thread* thread, word arg);
   static Continue doForIterGenerator(Thread* thread, word arg);
+  static Continue doForIterGroupby(Thread* thread, word arg);
+  static Continue doForIterIslice(Thread* thread, word arg);
   static Continue doForIterList(Thread* thread, word arg);
   static Continue doForIterMonomorphic(Thread* thread, word arg);
   static Continue doForIterPolymorphic(Thread* thread, word arg);
+  static Continue doForIterProduct(Thread* thread, word arg);
   static Continue doForIterRange(Thread* thread, word arg);
+  static Continue doForIterRepeat(Thread* thread, word arg);
   static Continue doForIterStr(Thread* thread, word arg);
+  static Continue doForIterTee(Thread* thread, word arg);
   static Continue doForIterTuple(Thread* thread, word arg);
   static Continue doForIterUncached(Thread* thread, word arg);
+  static Continue doForIterZipLongest(Thread* thread, word arg);
   static Continue doFormatValue(Thread* thread, word arg);
   static Continue doGetAiter(Thread* thread, word arg);
   static Continue doGetAnext(Thread* thread, word arg);
@@ -450,6 +460,7 @@ class Interpreter {
   static Continue doLoadAttrInstanceSlotDescr(Thread* thread, word arg);
   static Continue doLoadAttrInstanceType(Thread* thread, word arg);
   static Continue doLoadAttrInstanceTypeDescr(Thread* thread, word arg);
+  static Continue doLoadAttrMegamorphic(Thread* thread, word arg);
   static Continue doLoadAttrModule(Thread* thread, word arg);
   static Continue doLoadAttrPolymorphic(Thread* thread, word arg);
   static Continue doLoadAttrType(Thread* thread, word arg);
@@ -461,6 +472,7 @@ class Interpreter {
   static Continue doLoadMethod(Thread* thread, word arg);
   static Continue doLoadMethodAnamorphic(Thread* thread, word arg);
   static Continue doLoadMethodInstanceFunction(Thread* thread, word arg);
+  static Continue doLoadMethodMegamorphic(Thread* thread, word arg);
   static Continue doLoadMethodPolymorphic(Thread* thread, word arg);
   static Continue doLoadName(Thread* thread, word arg);
   static Continue doPopExcept(Thread* thread, word arg);
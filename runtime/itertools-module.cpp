@@ -0,0 +1,985 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "itertools-module.h"
+
+#include "builtins.h"
+#include "handles.h"
+#include "int-builtins.h"
+#include "interpreter.h"
+#include "modules.h"
+#include "objects.h"
+#include "runtime.h"
+#include "thread.h"
+#include "type-builtins.h"
+
+namespace py {
+
+static const BuiltinAttribute kAccumulateAttributes[] = {
+    {ID(_accumulate__iterator), RawAccumulate::kIteratorOffset,
+     AttributeFlags::kHidden},
+    {ID(_accumulate__func), RawAccumulate::kFuncOffset,
+     AttributeFlags::kHidden},
+    {ID(_accumulate__total), RawAccumulate::kTotalOffset,
+     AttributeFlags::kHidden},
+    {ID(_accumulate__initial), RawAccumulate::kInitialOffset,
+     AttributeFlags::kHidden},
+};
+
+static const BuiltinAttribute kChainAttributes[] = {
+    {ID(_chain__source), RawChain::kSourceOffset, AttributeFlags::kHidden},
+    {ID(_chain__active), RawChain::kActiveOffset, AttributeFlags::kHidden},
+};
+
+static const BuiltinAttribute kCountAttributes[] = {
+    {ID(_count__count), RawCount::kCountOffset, AttributeFlags::kHidden},
+    {ID(_count__step), RawCount::kStepOffset, AttributeFlags::kHidden},
+};
+
+static const BuiltinAttribute kGroupbyAttributes[] = {
+    {ID(_groupby__iterator), RawGroupby::kIteratorOffset,
+     AttributeFlags::kHidden},
+    {ID(_groupby__key_func), RawGroupby::kKeyFuncOffset,
+     AttributeFlags::kHidden},
+    {ID(_groupby__target_key), RawGroupby::kTargetKeyOffset,
+     AttributeFlags::kHidden},
+    {ID(_groupby__current_key), RawGroupby::kCurrentKeyOffset,
+     AttributeFlags::kHidden},
+    {ID(_groupby__current_value), RawGroupby::kCurrentValueOffset,
+     AttributeFlags::kHidden},
+    {ID(_groupby__current_grouper), RawGroupby::kCurrentGrouperOffset,
+     AttributeFlags::kHidden},
+};
+
+static const BuiltinAttribute kGrouperAttributes[] = {
+    {ID(_grouper__parent), RawGrouper::kParentOffset, AttributeFlags::kHidden},
+    {ID(_grouper__target_key), RawGrouper::kTargetKeyOffset,
+     AttributeFlags::kHidden},
+};
+
+static const BuiltinAttribute kIsliceAttributes[] = {
+    {ID(_islice__iterator), RawIslice::kIteratorOffset,
+     AttributeFlags::kHidden},
+    {ID(_islice__next), RawIslice::kNextOffset, AttributeFlags::kHidden},
+    {ID(_islice__stop), RawIslice::kStopOffset, AttributeFlags::kHidden},
+    {ID(_islice__step), RawIslice::kStepOffset, AttributeFlags::kHidden},
+    {ID(_islice__count), RawIslice::kCountOffset, AttributeFlags::kHidden},
+};
+
+static const BuiltinAttribute kProductAttributes[] = {
+    {ID(_product__pools), RawProduct::kPoolsOffset, AttributeFlags::kHidden},
+    {ID(_product__indices), RawProduct::kIndicesOffset,
+     AttributeFlags::kHidden},
+    {ID(_product__result), RawProduct::kResultOffset, AttributeFlags::kHidden},
+    {ID(_product__stopped), RawProduct::kStoppedOffset,
+     AttributeFlags::kHidden},
+};
+
+static const BuiltinAttribute kRepeatAttributes[] = {
+    {ID(_repeat__element), RawRepeat::kElementOffset, AttributeFlags::kHidden},
+    {ID(_repeat__times), RawRepeat::kTimesOffset, AttributeFlags::kHidden},
+};
+
+static const BuiltinAttribute kTeeAttributes[] = {
+    {ID(_tee__data), RawTee::kDataOffset, AttributeFlags::kHidden},
+    {ID(_tee__index), RawTee::kIndexOffset, AttributeFlags::kHidden},
+};
+
+static const BuiltinAttribute kTeeDataObjectAttributes[] = {
+    {ID(_tee_dataobject__iterator), RawTeeDataObject::kIteratorOffset,
+     AttributeFlags::kHidden},
+    {ID(_tee_dataobject__values), RawTeeDataObject::kValuesOffset,
+     AttributeFlags::kHidden},
+    {ID(_tee_dataobject__num_read), RawTeeDataObject::kNumReadOffset,
+     AttributeFlags::kHidden},
+    {ID(_tee_dataobject__next), RawTeeDataObject::kNextOffset,
+     AttributeFlags::kHidden},
+    {ID(_tee_dataobject__running), RawTeeDataObject::kRunningOffset,
+     AttributeFlags::kHidden},
+};
+
+static const BuiltinAttribute kZipLongestAttributes[] = {
+    {ID(_zip_longest__iterators), RawZipLongest::kIteratorsOffset,
+     AttributeFlags::kHidden},
+    {ID(_zip_longest__num_active), RawZipLongest::kNumActiveOffset,
+     AttributeFlags::kHidden},
+    {ID(_zip_longest__fill_value), RawZipLongest::kFillValueOffset,
+     AttributeFlags::kHidden},
+};
+
+void initializeItertoolsTypes(Thread* thread) {
+  addBuiltinType(thread, ID(accumulate), LayoutId::kAccumulate,
+                 /*superclass_id=*/LayoutId::kObject, kAccumulateAttributes,
+                 Accumulate::kSize, /*basetype=*/true);
+  addBuiltinType(thread, ID(chain), LayoutId::kChain,
+                 /*superclass_id=*/LayoutId::kObject, kChainAttributes,
+                 Chain::kSize, /*basetype=*/true);
+  addBuiltinType(thread, ID(count), LayoutId::kCount,
+                 /*superclass_id=*/LayoutId::kObject, kCountAttributes,
+                 Count::kSize, /*basetype=*/true);
+  addBuiltinType(thread, ID(groupby), LayoutId::kGroupby,
+                 /*superclass_id=*/LayoutId::kObject, kGroupbyAttributes,
+                 Groupby::kSize, /*basetype=*/true);
+  addBuiltinType(thread, ID(_grouper), LayoutId::kGrouper,
+                 /*superclass_id=*/LayoutId::kObject, kGrouperAttributes,
+                 Grouper::kSize, /*basetype=*/false);
+  addBuiltinType(thread, ID(islice), LayoutId::kIslice,
+                 /*superclass_id=*/LayoutId::kObject, kIsliceAttributes,
+                 Islice::kSize, /*basetype=*/true);
+  addBuiltinType(thread, ID(product), LayoutId::kProduct,
+                 /*superclass_id=*/LayoutId::kObject, kProductAttributes,
+                 Product::kSize, /*basetype=*/true);
+  addBuiltinType(thread, ID(repeat), LayoutId::kRepeat,
+                 /*superclass_id=*/LayoutId::kObject, kRepeatAttributes,
+                 Repeat::kSize, /*basetype=*/true);
+  addBuiltinType(thread, ID(_tee), LayoutId::kTee,
+                 /*superclass_id=*/LayoutId::kObject, kTeeAttributes,
+                 Tee::kSize, /*basetype=*/false);
+  addBuiltinType(thread, ID(_tee_dataobject), LayoutId::kTeeDataObject,
+                 /*superclass_id=*/LayoutId::kObject, kTeeDataObjectAttributes,
+                 TeeDataObject::kSize, /*basetype=*/false);
+  addBuiltinType(thread, ID(zip_longest), LayoutId::kZipLongest,
+                 /*superclass_id=*/LayoutId::kObject, kZipLongestAttributes,
+                 ZipLongest::kSize, /*basetype=*/true);
+}
+
+// Calls `iterator.__next__()`. Returns Error::noMoreItems() instead of raising
+// StopIteration.
+static RawObject iteratorNext(Thread* thread, const Object& iterator) {
+  RawObject result = thread->invokeMethod1(iterator, ID(__next__));
+  if (result.isErrorException()) {
+    if (thread->clearPendingStopIteration()) return Error::noMoreItems();
+    return result;
+  }
+  if (result.isErrorNotFound()) {
+    return thread->raiseWithFmt(LayoutId::kTypeError,
+                                "'%T' object is not an iterator", &iterator);
+  }
+  return result;
+}
+
+// Returns the instance layout of `type_obj` if it is a subtype of the builtin
+// type with `layout_id`. Raises TypeError otherwise.
+static RawObject subtypeLayout(Thread* thread, const Object& type_obj,
+                               LayoutId layout_id) {
+  Runtime* runtime = thread->runtime();
+  if (!runtime->isInstanceOfType(*type_obj)) {
+    return thread->raiseWithFmt(LayoutId::kTypeError, "not a type object");
+  }
+  HandleScope scope(thread);
+  Type type(&scope, *type_obj);
+  if (type.builtinBase() != layout_id) {
+    Type base(&scope, runtime->typeAt(layout_id));
+    Str name(&scope, base.name());
+    return thread->raiseWithFmt(LayoutId::kTypeError, "not a subtype of %S",
+                                &name);
+  }
+  return type.instanceLayout();
+}
+
+// Converts an islice() argument into a word. Returns -1 for anything that is
+// not an int in the range of a word.
+static word isliceIndex(Thread* thread, const Object& obj) {
+  if (!thread->runtime()->isInstanceOfInt(*obj)) return -1;
+  HandleScope scope(thread);
+  Int value(&scope, intUnderlying(*obj));
+  if (value.numDigits() > 1) return -1;
+  return value.asWord();
+}
+
+static bool isNumber(Thread* thread, const Object& obj) {
+  Runtime* runtime = thread->runtime();
+  if (runtime->isInstanceOfInt(*obj) || runtime->isInstanceOfFloat(*obj) ||
+      runtime->isInstanceOfComplex(*obj)) {
+    return true;
+  }
+  HandleScope scope(thread);
+  Type type(&scope, runtime->typeOf(*obj));
+  return !typeLookupInMroById(thread, *type, ID(__int__)).isErrorNotFound() ||
+         !typeLookupInMroById(thread, *type, ID(__float__)).isErrorNotFound();
+}
+
+static RawObject raiseStopIterationOrError(Thread* thread, RawObject result) {
+  if (result.isErrorNoMoreItems()) {
+    return thread->raise(LayoutId::kStopIteration, NoneType::object());
+  }
+  return result;
+}
+
+// accumulate
+
+RawObject accumulateNext(Thread* thread, const Accumulate& accumulate) {
+  HandleScope scope(thread);
+  Object total(&scope, accumulate.initial());
+  if (!total.isNoneType()) {
+    accumulate.setInitial(NoneType::object());
+    accumulate.setTotal(*total);
+    return *total;
+  }
+  Object iterator(&scope, accumulate.iterator());
+  Object value(&scope, iteratorNext(thread, iterator));
+  if (value.isError()) return *value;
+  total = accumulate.total();
+  if (total.isUnbound()) {
+    total = *value;
+  } else {
+    Object func(&scope, accumulate.func());
+    if (func.isNoneType()) {
+      total = Interpreter::binaryOperation(
+          thread, Interpreter::BinaryOp::ADD, total, value);
+    } else {
+      total = Interpreter::call2(thread, func, total, value);
+    }
+    if (total.isErrorException()) return *total;
+  }
+  accumulate.setTotal(*total);
+  return *total;
+}
+
+RawObject METH(accumulate, __new__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object type(&scope, args.get(0));
+  Object layout_obj(&scope,
+                    subtypeLayout(thread, type, LayoutId::kAccumulate));
+  if (layout_obj.isErrorException()) return *layout_obj;
+  Object iterable(&scope, args.get(1));
+  Object iterator(&scope, Interpreter::createIterator(thread, iterable));
+  if (iterator.isErrorException()) return *iterator;
+  Layout layout(&scope, *layout_obj);
+  Accumulate result(&scope, thread->runtime()->newInstance(layout));
+  result.setIterator(*iterator);
+  result.setFunc(args.get(2));
+  result.setTotal(Unbound::object());
+  result.setInitial(args.get(3));
+  return *result;
+}
+
+RawObject METH(accumulate, __next__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfAccumulate(*self)) {
+    return thread->raiseRequiresType(self, ID(accumulate));
+  }
+  Accumulate accumulate(&scope, *self);
+  return raiseStopIterationOrError(thread, accumulateNext(thread, accumulate));
+}
+
+// chain
+
+RawObject chainNext(Thread* thread, const Chain& chain) {
+  HandleScope scope(thread);
+  Object active(&scope, chain.active());
+  Object source(&scope, NoneType::object());
+  Object value(&scope, NoneType::object());
+  for (;;) {
+    if (active.isNoneType()) {
+      source = chain.source();
+      if (source.isNoneType()) return Error::noMoreItems();
+      Object iterable(&scope, iteratorNext(thread, source));
+      if (iterable.isErrorNoMoreItems()) {
+        chain.setSource(NoneType::object());
+        return *iterable;
+      }
+      if (iterable.isErrorException()) return *iterable;
+      active = Interpreter::createIterator(thread, iterable);
+      if (active.isErrorException()) return *active;
+      chain.setActive(*active);
+    }
+    value = iteratorNext(thread, active);
+    if (!value.isErrorNoMoreItems()) return *value;
+    active = NoneType::object();
+    chain.setActive(NoneType::object());
+  }
+}
+
+static RawObject newChain(Thread* thread, const Object& type,
+                          const Object& iterables) {
+  HandleScope scope(thread);
+  Object layout_obj(&scope, subtypeLayout(thread, type, LayoutId::kChain));
+  if (layout_obj.isErrorException()) return *layout_obj;
+  Object source(&scope, Interpreter::createIterator(thread, iterables));
+  if (source.isErrorException()) return *source;
+  Layout layout(&scope, *layout_obj);
+  Chain result(&scope, thread->runtime()->newInstance(layout));
+  result.setSource(*source);
+  result.setActive(NoneType::object());
+  return *result;
+}
+
+RawObject METH(chain, __new__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object type(&scope, args.get(0));
+  Object iterables(&scope, args.get(1));
+  return newChain(thread, type, iterables);
+}
+
+RawObject METH(chain, __next__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfChain(*self)) {
+    return thread->raiseRequiresType(self, ID(chain));
+  }
+  Chain chain(&scope, *self);
+  return raiseStopIterationOrError(thread, chainNext(thread, chain));
+}
+
+RawObject METH(chain, from_iterable)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object type(&scope, args.get(0));
+  Object iterable(&scope, args.get(1));
+  return newChain(thread, type, iterable);
+}
+
+// count
+
+RawObject countNext(Thread* thread, const Count& count) {
+  RawObject current = count.count();
+  RawObject step = count.step();
+  if (current.isSmallInt() && step.isSmallInt()) {
+    word next =
+        SmallInt::cast(current).value() + SmallInt::cast(step).value();
+    if (SmallInt::isValid(next)) {
+      count.setCount(SmallInt::fromWord(next));
+      return current;
+    }
+  }
+  HandleScope scope(thread);
+  Object result(&scope, current);
+  Object step_obj(&scope, step);
+  Object next(&scope, Interpreter::binaryOperation(
+                          thread, Interpreter::BinaryOp::ADD, result,
+                          step_obj));
+  if (next.isErrorException()) return *next;
+  count.setCount(*next);
+  return *result;
+}
+
+RawObject METH(count, __new__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object type(&scope, args.get(0));
+  Object layout_obj(&scope, subtypeLayout(thread, type, LayoutId::kCount));
+  if (layout_obj.isErrorException()) return *layout_obj;
+  Object start(&scope, args.get(1));
+  Object step(&scope, args.get(2));
+  if (!isNumber(thread, start) || !isNumber(thread, step)) {
+    return thread->raiseWithFmt(LayoutId::kTypeError, "a number is required");
+  }
+  Layout layout(&scope, *layout_obj);
+  Count result(&scope, thread->runtime()->newInstance(layout));
+  result.setCount(*start);
+  result.setStep(*step);
+  return *result;
+}
+
+RawObject METH(count, __next__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfCount(*self)) {
+    return thread->raiseRequiresType(self, ID(count));
+  }
+  Count count(&scope, *self);
+  return raiseStopIterationOrError(thread, countNext(thread, count));
+}
+
+RawObject METH(count, __repr__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  Runtime* runtime = thread->runtime();
+  if (!runtime->isInstanceOfCount(*self)) {
+    return thread->raiseRequiresType(self, ID(count));
+  }
+  Count count(&scope, *self);
+  Type type(&scope, runtime->typeOf(*self));
+  Str name(&scope, type.name());
+  Object current(&scope, count.count());
+  Object current_repr(&scope,
+                      thread->invokeFunction1(ID(builtins), ID(repr), current));
+  if (current_repr.isErrorException()) return *current_repr;
+  Object step(&scope, count.step());
+  if (step == SmallInt::fromWord(1)) {
+    return runtime->newStrFromFmt("%S(%S)", &name, &current_repr);
+  }
+  Object step_repr(&scope,
+                   thread->invokeFunction1(ID(builtins), ID(repr), step));
+  if (step_repr.isErrorException()) return *step_repr;
+  return runtime->newStrFromFmt("%S(%S, %S)", &name, &current_repr,
+                                &step_repr);
+}
+
+// groupby
+
+// Advances the underlying iterator of `groupby` and computes the key of the
+// new current value.
+static RawObject groupbyStep(Thread* thread, const Groupby& groupby) {
+  HandleScope scope(thread);
+  Object iterator(&scope, groupby.iterator());
+  Object value(&scope, iteratorNext(thread, iterator));
+  if (value.isError()) return *value;
+  Object key(&scope, *value);
+  Object key_func(&scope, groupby.keyFunc());
+  if (!key_func.isNoneType()) {
+    key = Interpreter::call1(thread, key_func, value);
+    if (key.isErrorException()) return *key;
+  }
+  groupby.setCurrentValue(*value);
+  groupby.setCurrentKey(*key);
+  return NoneType::object();
+}
+
+RawObject groupbyNext(Thread* thread, const Groupby& groupby) {
+  groupby.setCurrentGrouper(NoneType::object());
+  HandleScope scope(thread);
+  Object current_key(&scope, NoneType::object());
+  Object target_key(&scope, NoneType::object());
+  Object result(&scope, NoneType::object());
+  // Skip the rest of the current group.
+  for (;;) {
+    current_key = groupby.currentKey();
+    if (!current_key.isUnbound()) {
+      target_key = groupby.targetKey();
+      if (target_key.isUnbound()) break;
+      result = Runtime::objectEquals(thread, *target_key, *current_key);
+      if (result.isErrorException()) return *result;
+      if (result == Bool::falseObj()) break;
+    }
+    result = groupbyStep(thread, groupby);
+    if (result.isError()) return *result;
+  }
+  groupby.setTargetKey(*current_key);
+  Runtime* runtime = thread->runtime();
+  Layout layout(&scope, runtime->layoutAt(LayoutId::kGrouper));
+  Grouper grouper(&scope, runtime->newInstance(layout));
+  grouper.setParent(*groupby);
+  grouper.setTargetKey(*current_key);
+  groupby.setCurrentGrouper(*grouper);
+  return runtime->newTupleWith2(current_key, grouper);
+}
+
+RawObject METH(groupby, __new__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object type(&scope, args.get(0));
+  Object layout_obj(&scope, subtypeLayout(thread, type, LayoutId::kGroupby));
+  if (layout_obj.isErrorException()) return *layout_obj;
+  Object iterable(&scope, args.get(1));
+  Object iterator(&scope, Interpreter::createIterator(thread, iterable));
+  if (iterator.isErrorException()) return *iterator;
+  Layout layout(&scope, *layout_obj);
+  Groupby result(&scope, thread->runtime()->newInstance(layout));
+  result.setIterator(*iterator);
+  result.setKeyFunc(args.get(2));
+  result.setTargetKey(Unbound::object());
+  result.setCurrentKey(Unbound::object());
+  result.setCurrentValue(Unbound::object());
+  result.setCurrentGrouper(NoneType::object());
+  return *result;
+}
+
+RawObject METH(groupby, __next__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfGroupby(*self)) {
+    return thread->raiseRequiresType(self, ID(groupby));
+  }
+  Groupby groupby(&scope, *self);
+  return raiseStopIterationOrError(thread, groupbyNext(thread, groupby));
+}
+
+static RawObject grouperNext(Thread* thread, const Grouper& grouper) {
+  HandleScope scope(thread);
+  Groupby parent(&scope, grouper.parent());
+  if (parent.currentGrouper() != *grouper) return Error::noMoreItems();
+  if (parent.currentValue().isUnbound()) {
+    Object step_result(&scope, groupbyStep(thread, parent));
+    if (step_result.isError()) return *step_result;
+  }
+  Object equals(&scope, Runtime::objectEquals(thread, grouper.targetKey(),
+                                              parent.currentKey()));
+  if (equals.isErrorException()) return *equals;
+  if (equals == Bool::falseObj()) return Error::noMoreItems();
+  RawObject result = parent.currentValue();
+  parent.setCurrentValue(Unbound::object());
+  parent.setCurrentKey(Unbound::object());
+  return result;
+}
+
+RawObject METH(_grouper, __next__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  if (!self.isGrouper()) {
+    return thread->raiseRequiresType(self, ID(_grouper));
+  }
+  Grouper grouper(&scope, *self);
+  return raiseStopIterationOrError(thread, grouperNext(thread, grouper));
+}
+
+// islice
+
+RawObject isliceNext(Thread* thread, const Islice& islice) {
+  HandleScope scope(thread);
+  Object iterator(&scope, islice.iterator());
+  if (iterator.isNoneType()) return Error::noMoreItems();
+  word stop = islice.stop();
+  Object value(&scope, NoneType::object());
+  for (word next = islice.next(); islice.count() < next;) {
+    value = iteratorNext(thread, iterator);
+    if (value.isError()) {
+      islice.setIterator(NoneType::object());
+      return *value;
+    }
+    islice.setCount(islice.count() + 1);
+  }
+  if (stop != Islice::kNoStop && islice.count() >= stop) {
+    islice.setIterator(NoneType::object());
+    return Error::noMoreItems();
+  }
+  value = iteratorNext(thread, iterator);
+  if (value.isError()) {
+    islice.setIterator(NoneType::object());
+    return *value;
+  }
+  islice.setCount(islice.count() + 1);
+  word next = islice.next() + islice.step();
+  if (next > SmallInt::kMaxValue) next = SmallInt::kMaxValue;
+  if (stop != Islice::kNoStop && next > stop) next = stop;
+  islice.setNext(next);
+  return *value;
+}
+
+RawObject METH(islice, __new__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object type(&scope, args.get(0));
+  Object layout_obj(&scope, subtypeLayout(thread, type, LayoutId::kIslice));
+  if (layout_obj.isErrorException()) return *layout_obj;
+  Object start_obj(&scope, args.get(2));
+  Object stop_obj(&scope, args.get(3));
+  Object step_obj(&scope, args.get(4));
+  if (stop_obj.isUnbound()) {
+    stop_obj = *start_obj;
+    start_obj = NoneType::object();
+  }
+  word start = 0;
+  word stop = Islice::kNoStop;
+  word step = 1;
+  if (!stop_obj.isNoneType()) {
+    stop = isliceIndex(thread, stop_obj);
+    if (stop == -1) {
+      return thread->raiseWithFmt(
+          LayoutId::kValueError,
+          "Stop argument for islice() must be None or an integer: "
+          "0 <= x <= sys.maxsize.");
+    }
+  }
+  if (!start_obj.isNoneType()) {
+    start = isliceIndex(thread, start_obj);
+  }
+  if (start < 0 || stop < -1) {
+    return thread->raiseWithFmt(
+        LayoutId::kValueError,
+        "Indices for islice() must be None or an integer: "
+        "0 <= x <= sys.maxsize.");
+  }
+  if (!step_obj.isNoneType() && !step_obj.isUnbound()) {
+    step = isliceIndex(thread, step_obj);
+    if (step < 1) {
+      return thread->raiseWithFmt(
+          LayoutId::kValueError,
+          "Step for islice() must be a positive integer or None.");
+    }
+  }
+  Object iterable(&scope, args.get(1));
+  Object iterator(&scope, Interpreter::createIterator(thread, iterable));
+  if (iterator.isErrorException()) return *iterator;
+  Layout layout(&scope, *layout_obj);
+  Islice result(&scope, thread->runtime()->newInstance(layout));
+  result.setIterator(*iterator);
+  result.setNext(Utils::minimum(start, SmallInt::kMaxValue));
+  result.setStop(Utils::minimum(stop, SmallInt::kMaxValue));
+  result.setStep(Utils::minimum(step, SmallInt::kMaxValue));
+  result.setCount(0);
+  return *result;
+}
+
+RawObject METH(islice, __next__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfIslice(*self)) {
+    return thread->raiseRequiresType(self, ID(islice));
+  }
+  Islice islice(&scope, *self);
+  return raiseStopIterationOrError(thread, isliceNext(thread, islice));
+}
+
+// product
+
+RawObject productNext(Thread* thread, const Product& product) {
+  if (product.stopped()) return Error::noMoreItems();
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Tuple pools(&scope, product.pools());
+  word num_pools = pools.length();
+  Object result_obj(&scope, product.result());
+  Tuple pool(&scope, runtime->emptyTuple());
+  if (num_pools == 0) {
+    if (!result_obj.isNoneType()) {
+      product.setStopped(true);
+      return Error::noMoreItems();
+    }
+    product.setResult(runtime->emptyTuple());
+    return runtime->emptyTuple();
+  }
+  MutableTuple result(&scope, runtime->newMutableTuple(num_pools));
+  if (result_obj.isNoneType()) {
+    // The first result holds the first element of each pool.
+    for (word i = 0; i < num_pools; i++) {
+      pool = pools.at(i);
+      if (pool.length() == 0) {
+        product.setStopped(true);
+        return Error::noMoreItems();
+      }
+      result.atPut(i, pool.at(0));
+    }
+  } else {
+    // Advance the indices right to left, moving on to the next pool only
+    // when the previous one rolls over.
+    Tuple previous(&scope, *result_obj);
+    result.replaceFromWith(0, *previous, num_pools);
+    MutableTuple indices(&scope, product.indices());
+    word i = num_pools - 1;
+    for (; i >= 0; i--) {
+      pool = pools.at(i);
+      word index = SmallInt::cast(indices.at(i)).value() + 1;
+      if (index < pool.length()) {
+        indices.atPut(i, SmallInt::fromWord(index));
+        result.atPut(i, pool.at(index));
+        break;
+      }
+      indices.atPut(i, SmallInt::fromWord(0));
+      result.atPut(i, pool.at(0));
+    }
+    if (i < 0) {
+      product.setStopped(true);
+      return Error::noMoreItems();
+    }
+  }
+  Tuple result_tuple(&scope, result.becomeImmutable());
+  product.setResult(*result_tuple);
+  return *result_tuple;
+}
+
+RawObject METH(product, __new__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object type(&scope, args.get(0));
+  Object layout_obj(&scope, subtypeLayout(thread, type, LayoutId::kProduct));
+  if (layout_obj.isErrorException()) return *layout_obj;
+  Runtime* runtime = thread->runtime();
+  Tuple iterables(&scope, args.get(2));
+  Object repeat_obj(&scope, args.get(1));
+  repeat_obj = intFromIndex(thread, repeat_obj);
+  if (repeat_obj.isErrorException()) return *repeat_obj;
+  Int repeat_int(&scope, intUnderlying(*repeat_obj));
+  if (repeat_int.isNegative()) {
+    return thread->raiseWithFmt(LayoutId::kValueError,
+                                "repeat argument cannot be negative");
+  }
+  word num_iterables = iterables.length();
+  word repeat = repeat_int.asWordSaturated();
+  if (repeat > 0 &&
+      num_iterables > SmallInt::kMaxValue / kPointerSize / repeat) {
+    return thread->raiseWithFmt(LayoutId::kOverflowError,
+                                "repeat argument too large");
+  }
+  word num_pools = repeat == 0 ? 0 : num_iterables * repeat;
+  Tuple pools(&scope, runtime->emptyTuple());
+  Object indices(&scope, runtime->emptyTuple());
+  if (num_pools > 0) {
+    MutableTuple new_pools(&scope, runtime->newMutableTuple(num_pools));
+    Object iterable(&scope, NoneType::object());
+    Object pool(&scope, NoneType::object());
+    Type tuple_type(&scope, runtime->typeAt(LayoutId::kTuple));
+    for (word i = 0; i < num_iterables; i++) {
+      iterable = iterables.at(i);
+      if (iterable.isTuple()) {
+        pool = *iterable;
+      } else {
+        pool = Interpreter::call1(thread, tuple_type, iterable);
+        if (pool.isErrorException()) return *pool;
+      }
+      for (word j = i; j < num_pools; j += num_iterables) {
+        new_pools.atPut(j, *pool);
+      }
+    }
+    pools = new_pools.becomeImmutable();
+    MutableTuple new_indices(&scope, runtime->newMutableTuple(num_pools));
+    new_indices.fill(SmallInt::fromWord(0));
+    indices = *new_indices;
+  }
+  Layout layout(&scope, *layout_obj);
+  Product result(&scope, runtime->newInstance(layout));
+  result.setPools(*pools);
+  result.setIndices(*indices);
+  result.setResult(NoneType::object());
+  result.setStopped(false);
+  return *result;
+}
+
+RawObject METH(product, __next__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfProduct(*self)) {
+    return thread->raiseRequiresType(self, ID(product));
+  }
+  Product product(&scope, *self);
+  return raiseStopIterationOrError(thread, productNext(thread, product));
+}
+
+// repeat
+
+RawObject repeatNext(Thread*, const Repeat& repeat) {
+  RawObject times = repeat.times();
+  if (times.isNoneType()) return repeat.element();
+  word remaining = SmallInt::cast(times).value();
+  if (remaining == 0) return Error::noMoreItems();
+  repeat.setTimes(SmallInt::fromWord(remaining - 1));
+  return repeat.element();
+}
+
+RawObject METH(repeat, __length_hint__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfRepeat(*self)) {
+    return thread->raiseRequiresType(self, ID(repeat));
+  }
+  Repeat repeat(&scope, *self);
+  RawObject times = repeat.times();
+  if (times.isNoneType()) {
+    return thread->raiseWithFmt(LayoutId::kTypeError,
+                                "len() of unsized object");
+  }
+  return times;
+}
+
+RawObject METH(repeat, __new__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object type(&scope, args.get(0));
+  Object layout_obj(&scope, subtypeLayout(thread, type, LayoutId::kRepeat));
+  if (layout_obj.isErrorException()) return *layout_obj;
+  Object times(&scope, args.get(2));
+  if (!times.isNoneType()) {
+    times = intFromIndex(thread, times);
+    if (times.isErrorException()) return *times;
+    word value = intUnderlying(*times).asWordSaturated();
+    times = SmallInt::fromWord(
+        Utils::maximum(word{0}, Utils::minimum(value, SmallInt::kMaxValue)));
+  }
+  Layout layout(&scope, *layout_obj);
+  Repeat result(&scope, thread->runtime()->newInstance(layout));
+  result.setElement(args.get(1));
+  result.setTimes(*times);
+  return *result;
+}
+
+RawObject METH(repeat, __next__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfRepeat(*self)) {
+    return thread->raiseRequiresType(self, ID(repeat));
+  }
+  Repeat repeat(&scope, *self);
+  return raiseStopIterationOrError(thread, repeatNext(thread, repeat));
+}
+
+RawObject METH(repeat, __repr__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  Runtime* runtime = thread->runtime();
+  if (!runtime->isInstanceOfRepeat(*self)) {
+    return thread->raiseRequiresType(self, ID(repeat));
+  }
+  Repeat repeat(&scope, *self);
+  Type type(&scope, runtime->typeOf(*self));
+  Str name(&scope, type.name());
+  Object element(&scope, repeat.element());
+  Object element_repr(&scope,
+                      thread->invokeFunction1(ID(builtins), ID(repr), element));
+  if (element_repr.isErrorException()) return *element_repr;
+  RawObject times = repeat.times();
+  if (times.isNoneType()) {
+    return runtime->newStrFromFmt("%S(%S)", &name, &element_repr);
+  }
+  return runtime->newStrFromFmt("%S(%S, %w)", &name, &element_repr,
+                                SmallInt::cast(times).value());
+}
+
+// tee
+
+static RawObject newTeeDataObject(Thread* thread, const Object& iterator) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Layout layout(&scope, runtime->layoutAt(LayoutId::kTeeDataObject));
+  TeeDataObject result(&scope, runtime->newInstance(layout));
+  result.setIterator(*iterator);
+  result.setValues(runtime->newMutableTuple(TeeDataObject::kMaxValues));
+  result.setNumRead(0);
+  result.setNext(NoneType::object());
+  result.setRunning(false);
+  return *result;
+}
+
+static RawObject newTee(Thread* thread, const Object& data, word index) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Layout layout(&scope, runtime->layoutAt(LayoutId::kTee));
+  Tee result(&scope, runtime->newInstance(layout));
+  result.setData(*data);
+  result.setIndex(index);
+  return *result;
+}
+
+RawObject teeNext(Thread* thread, const Tee& tee) {
+  HandleScope scope(thread);
+  TeeDataObject data(&scope, tee.data());
+  word index = tee.index();
+  if (index >= TeeDataObject::kMaxValues) {
+    // Move on to the next link, creating it if no other tee did so yet.
+    Object next(&scope, data.next());
+    if (next.isNoneType()) {
+      Object iterator(&scope, data.iterator());
+      next = newTeeDataObject(thread, iterator);
+      data.setNext(*next);
+    }
+    data = *next;
+    tee.setData(*data);
+    index = 0;
+  }
+  MutableTuple values(&scope, data.values());
+  if (index < data.numRead()) {
+    tee.setIndex(index + 1);
+    return values.at(index);
+  }
+  DCHECK(index == data.numRead(), "tee index is ahead of its data");
+  if (data.running()) {
+    return thread->raiseWithFmt(LayoutId::kRuntimeError,
+                                "cannot re-enter the tee iterator");
+  }
+  data.setRunning(true);
+  Object iterator(&scope, data.iterator());
+  Object value(&scope, iteratorNext(thread, iterator));
+  data.setRunning(false);
+  if (value.isError()) return *value;
+  values.atPut(index, *value);
+  data.setNumRead(index + 1);
+  tee.setIndex(index + 1);
+  return *value;
+}
+
+RawObject METH(_tee, __copy__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  if (!self.isTee()) {
+    return thread->raiseRequiresType(self, ID(_tee));
+  }
+  Tee tee(&scope, *self);
+  Object data(&scope, tee.data());
+  return newTee(thread, data, tee.index());
+}
+
+RawObject METH(_tee, __new__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object type(&scope, args.get(0));
+  Runtime* runtime = thread->runtime();
+  if (type != runtime->typeAt(LayoutId::kTee)) {
+    return thread->raiseWithFmt(LayoutId::kTypeError, "not a subtype of _tee");
+  }
+  Object iterable(&scope, args.get(1));
+  Object iterator(&scope, Interpreter::createIterator(thread, iterable));
+  if (iterator.isErrorException()) return *iterator;
+  if (iterator.isTee()) {
+    Tee tee(&scope, *iterator);
+    Object data(&scope, tee.data());
+    return newTee(thread, data, tee.index());
+  }
+  Object data(&scope, newTeeDataObject(thread, iterator));
+  return newTee(thread, data, 0);
+}
+
+RawObject METH(_tee, __next__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  if (!self.isTee()) {
+    return thread->raiseRequiresType(self, ID(_tee));
+  }
+  Tee tee(&scope, *self);
+  return raiseStopIterationOrError(thread, teeNext(thread, tee));
+}
+
+// zip_longest
+
+RawObject zipLongestNext(Thread* thread, const ZipLongest& zip_longest) {
+  word num_active = zip_longest.numActive();
+  if (num_active == 0) return Error::noMoreItems();
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  MutableTuple iterators(&scope, zip_longest.iterators());
+  word length = iterators.length();
+  MutableTuple result(&scope, runtime->newMutableTuple(length));
+  Object iterator(&scope, NoneType::object());
+  Object value(&scope, NoneType::object());
+  for (word i = 0; i < length; i++) {
+    iterator = iterators.at(i);
+    if (iterator.isNoneType()) {
+      result.atPut(i, zip_longest.fillValue());
+      continue;
+    }
+    value = iteratorNext(thread, iterator);
+    if (value.isErrorException()) return *value;
+    if (value.isErrorNoMoreItems()) {
+      num_active--;
+      zip_longest.setNumActive(num_active);
+      if (num_active == 0) return *value;
+      iterators.atPut(i, NoneType::object());
+      value = zip_longest.fillValue();
+    }
+    result.atPut(i, *value);
+  }
+  return result.becomeImmutable();
+}
+
+RawObject METH(zip_longest, __new__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object type(&scope, args.get(0));
+  Object layout_obj(&scope,
+                    subtypeLayout(thread, type, LayoutId::kZipLongest));
+  if (layout_obj.isErrorException()) return *layout_obj;
+  Runtime* runtime = thread->runtime();
+  Tuple iterables(&scope, args.get(2));
+  word length = iterables.length();
+  Object iterators(&scope, runtime->emptyTuple());
+  if (length > 0) {
+    MutableTuple new_iterators(&scope, runtime->newMutableTuple(length));
+    Object iterable(&scope, NoneType::object());
+    Object iterator(&scope, NoneType::object());
+    for (word i = 0; i < length; i++) {
+      iterable = iterables.at(i);
+      iterator = Interpreter::createIterator(thread, iterable);
+      if (iterator.isErrorException()) return *iterator;
+      new_iterators.atPut(i, *iterator);
+    }
+    iterators = *new_iterators;
+  }
+  Layout layout(&scope, *layout_obj);
+  ZipLongest result(&scope, runtime->newInstance(layout));
+  result.setIterators(*iterators);
+  result.setNumActive(length);
+  result.setFillValue(args.get(1));
+  return *result;
+}
+
+RawObject METH(zip_longest, __next__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfZipLongest(*self)) {
+    return thread->raiseRequiresType(self, ID(zip_longest));
+  }
+  ZipLongest zip_longest(&scope, *self);
+  return raiseStopIterationOrError(thread, zipLongestNext(thread, zip_longest));
+}
+
+}  // namespace py
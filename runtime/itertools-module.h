@@ -0,0 +1,27 @@
+/* Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com) */
+#pragma once
+
+#include "handles-decl.h"
+#include "objects.h"
+
+namespace py {
+
+class Thread;
+
+// The following functions return the next item of the given iterator,
+// Error::noMoreItems() once it is exhausted or Error::exception() if an
+// exception was raised. They are shared by the `__next__` methods and the
+// FOR_ITER_* specializations of the interpreter.
+RawObject accumulateNext(Thread* thread, const Accumulate& accumulate);
+RawObject chainNext(Thread* thread, const Chain& chain);
+RawObject countNext(Thread* thread, const Count& count);
+RawObject groupbyNext(Thread* thread, const Groupby& groupby);
+RawObject isliceNext(Thread* thread, const Islice& islice);
+RawObject productNext(Thread* thread, const Product& product);
+RawObject repeatNext(Thread* thread, const Repeat& repeat);
+RawObject teeNext(Thread* thread, const Tee& tee);
+RawObject zipLongestNext(Thread* thread, const ZipLongest& zip_longest);
+
+void initializeItertoolsTypes(Thread* thread);
+
+}  // namespace py
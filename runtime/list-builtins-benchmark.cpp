@@ -0,0 +1,57 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "benchmark/benchmark.h"
+
+#include "benchmark-utils.h"
+#include "handles.h"
+#include "list-builtins.h"
+#include "runtime.h"
+
+namespace py {
+namespace testing {
+
+using ListBenchmark = RuntimeBenchmark;
+
+// Returns a list of `num_items` values in a scrambled order.
+static RawObject newScrambledList(Thread* thread, word num_items,
+                                  bool as_floats) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  List list(&scope, runtime->newList());
+  Object value(&scope, NoneType::object());
+  for (word i = 0; i < num_items; i++) {
+    word scrambled = (i * 7919) % num_items;
+    value = as_floats ? runtime->newFloat(scrambled / 3.0)
+                      : SmallInt::fromWord(scrambled);
+    runtime->listAdd(thread, list, value);
+  }
+  return *list;
+}
+
+static void sortCopies(benchmark::State& state, Thread* thread,
+                       bool as_floats) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  word num_items = state.range(0);
+  List source(&scope, newScrambledList(thread, num_items, as_floats));
+  List list(&scope, runtime->newList());
+  for (auto _ : state) {
+    state.PauseTiming();
+    list = listSlice(thread, source, 0, num_items, 1);
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(listSort(thread, list));
+  }
+  state.SetItemsProcessed(state.iterations() * num_items);
+}
+
+BENCHMARK_DEFINE_F(ListBenchmark, SortSmallInts)(benchmark::State& state) {
+  sortCopies(state, thread_, /*as_floats=*/false);
+}
+BENCHMARK_REGISTER_F(ListBenchmark, SortSmallInts)->Arg(1024)->Arg(1 << 20);
+
+BENCHMARK_DEFINE_F(ListBenchmark, SortFloats)(benchmark::State& state) {
+  sortCopies(state, thread_, /*as_floats=*/true);
+}
+BENCHMARK_REGISTER_F(ListBenchmark, SortFloats)->Arg(1024)->Arg(1 << 20);
+
+}  // namespace testing
+}  // namespace py
@@ -891,6 +891,161 @@ TEST_F(ListBuiltinsTest, SortIsStable) {
   EXPECT_EQ(list.at(3), *elt3);
 }
 
+TEST_F(ListBuiltinsTest, SortWithSortedInputComparesEachNeighborOnce) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+count = 0
+class C:
+  def __init__(self, value):
+    self.value = value
+  def __lt__(self, other):
+    global count
+    count += 1
+    return self.value < other.value
+ascending = [C(i) for i in range(1000)]
+ascending.sort()
+ascending_count = count
+count = 0
+descending = [C(-i) for i in range(1000)]
+descending.sort()
+descending_count = count
+ascending_sorted = all(a.value < b.value for a, b in zip(ascending, ascending[1:]))
+descending_sorted = all(a.value < b.value
+                        for a, b in zip(descending, descending[1:]))
+)")
+                   .isError());
+  EXPECT_TRUE(isIntEqualsWord(mainModuleAt(runtime_, "ascending_count"), 999));
+  EXPECT_TRUE(isIntEqualsWord(mainModuleAt(runtime_, "descending_count"), 999));
+  EXPECT_EQ(mainModuleAt(runtime_, "ascending_sorted"), Bool::trueObj());
+  EXPECT_EQ(mainModuleAt(runtime_, "descending_sorted"), Bool::trueObj());
+}
+
+TEST_F(ListBuiltinsTest, SortWithRunsIsStable) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  def __init__(self, value, index):
+    self.value = value
+    self.index = index
+  def __lt__(self, other):
+    return self.value < other.value
+values = [i % 13 for i in range(500)] + list(range(300)) + [7] * 200
+values += list(range(400, 0, -1))
+items = [C(value, index) for index, value in enumerate(values)]
+items.sort()
+result = [(item.value, item.index) for item in items]
+expected = sorted((value, index) for index, value in enumerate(values))
+is_stable = result == expected
+)")
+                   .isError());
+  EXPECT_EQ(mainModuleAt(runtime_, "is_stable"), Bool::trueObj());
+}
+
+TEST_F(ListBuiltinsTest, SortWithRaisingComparisonKeepsAllItems) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+count = 0
+class C:
+  def __init__(self, value):
+    self.value = value
+  def __lt__(self, other):
+    global count
+    count += 1
+    if count == 3000:
+      raise UserWarning()
+    return self.value < other.value
+items = [C((i * 7919) % 1000) for i in range(1000)]
+before = sorted(item.value for item in items)
+try:
+  items.sort()
+except UserWarning:
+  pass
+after = sorted(item.value for item in items)
+kept_items = count >= 3000 and before == after
+)")
+                   .isError());
+  EXPECT_EQ(mainModuleAt(runtime_, "kept_items"), Bool::trueObj());
+}
+
+TEST_F(ListBuiltinsTest, SortWithHomogeneousItemsDoesNotCallCompareFunction) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+import _builtins
+count = 0
+def counting_lt(a, b):
+  global count
+  count += 1
+  return a < b
+def counting_lt_key(a, b):
+  global count
+  count += 1
+  return a[0] < b[0]
+_builtins._lt = counting_lt
+_builtins._lt_key = counting_lt_key
+ints = [(i * 7919) % 1000 for i in range(1000)] + [1 << 70, -(1 << 70)]
+ints.sort()
+floats = [1.5, -0.0, 3.25, float("inf"), -2.0]
+floats.sort()
+strs = ["pear", "apple", "fig", "banana" * 10]
+strs.sort()
+tuples = [(3, "c"), (1, "a"), (2, "b")]
+tuples.sort()
+by_key = sorted(range(10), key=lambda x: -x)
+native_count = count
+mixed = [3, 1.5, 2]
+mixed.sort()
+mixed_calls_compare = count > native_count
+)")
+                   .isError());
+  EXPECT_TRUE(isIntEqualsWord(mainModuleAt(runtime_, "native_count"), 0));
+  EXPECT_EQ(mainModuleAt(runtime_, "mixed_calls_compare"), Bool::trueObj());
+  HandleScope scope(thread_);
+  Object floats(&scope, mainModuleAt(runtime_, "floats"));
+  EXPECT_PYLIST_EQ(floats, {-2.0, -0.0, 1.5, 3.25, kDoubleInfinity});
+  Object strs(&scope, mainModuleAt(runtime_, "strs"));
+  EXPECT_PYLIST_EQ(strs, {"apple", "bananabananabananabananabananabananabanana"
+                                   "bananabananabanana",
+                          "fig", "pear"});
+  Object by_key(&scope, mainModuleAt(runtime_, "by_key"));
+  EXPECT_PYLIST_EQ(by_key, {9, 8, 7, 6, 5, 4, 3, 2, 1, 0});
+}
+
+TEST_F(ListBuiltinsTest, SortWithTuplesComparesEqualFirstElementsInPython) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  def __init__(self, value):
+    self.value = value
+  def __lt__(self, other):
+    return self.value < other.value
+nan = float("nan")
+ints = [(1, C(2)), (0, C(5)), (1, C(1)), (0, C(4))]
+ints.sort()
+int_values = [b.value for a, b in ints]
+nans = [(nan, C(2)), (nan, C(1))]
+nans.sort()
+nan_values = [b.value for a, b in nans]
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Object int_values(&scope, mainModuleAt(runtime_, "int_values"));
+  EXPECT_PYLIST_EQ(int_values, {4, 5, 1, 2});
+  Object nan_values(&scope, mainModuleAt(runtime_, "nan_values"));
+  EXPECT_PYLIST_EQ(nan_values, {1, 2});
+}
+
+TEST_F(ListBuiltinsTest, SortWithTuplesToleratesItemsReplacedDuringSort) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  def __lt__(self, other):
+    items[0] = "not a tuple"
+    return False
+items = [(i % 3, C()) for i in range(100)]
+try:
+  items.sort()
+except TypeError:
+  pass
+has_str = "not a tuple" in items
+)")
+                   .isError());
+  EXPECT_EQ(mainModuleAt(runtime_, "has_str"), Bool::trueObj());
+}
+
 TEST_F(ListBuiltinsTest, ListExtendSelfDuplicatesElements) {
   ASSERT_FALSE(runFromCStr(runtime_, R"(
 a = [1, 2, 3]
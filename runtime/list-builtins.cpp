@@ -104,92 +104,649 @@ RawObject listSlice(Thread* thread, const List& list, word start, word stop,
   return *result;
 }
 
-// TODO(T63900795): Investigate this threshold on a realistic benchmark.
-static const int kListInsertionSortSize = 8;
+// The kinds of values that `ListSorter` compares without calling into Python.
+// Items of these kinds never run user code when compared with each other.
+enum class SortKind {
+  kObject,
+  kInt,
+  kFloat,
+  kStr,
+};
+
+static SortKind sortKindOf(RawObject value) {
+  if (value.isSmallInt() || value.isLargeInt()) return SortKind::kInt;
+  if (value.isFloat()) return SortKind::kFloat;
+  if (value.isStr()) return SortKind::kStr;
+  return SortKind::kObject;
+}
+
+// Sorts the items of a list with Timsort, a stable merge sort that looks for
+// runs that are already in order and merges them with galloping. Nearly
+// sorted input takes a linear number of comparisons. This follows CPython's
+// `Objects/listsort.txt`, which explains the constants and the merge pattern.
+class ListSorter {
+ public:
+  // When `by_key` is set the items are `(key, item)` tuples that are ordered
+  // by their keys.
+  ListSorter(HandleScope* scope, Thread* thread, const MutableTuple& data,
+             const Object& compare_func, bool by_key)
+      : thread_(thread),
+        data_(scope, *data),
+        temp_(scope, NoneType::object()),
+        compare_func_(scope, *compare_func),
+        left_(scope, NoneType::object()),
+        right_(scope, NoneType::object()),
+        by_key_(by_key) {}
+
+  // Sorts `data[0:num_items]`. Returns None or the Error raised by a
+  // comparison, in which case the items are in some permutation.
+  RawObject sort(word num_items);
+
+ private:
+  struct Run {
+    word base;
+    word length;
+  };
+
+  // Returns a Bool, or Error if the comparison raised.
+  RawObject lessThan(RawObject left, RawObject right);
+
+  // Looks at every item to find out whether the sort keys all have the same
+  // kind, so that `lessThan` can compare them natively.
+  void pickSortKind(word num_items);
+
+  // Returns the value `lessThan` compares natively for `item`, or Unbound if
+  // it does not have the kind found by `pickSortKind`. Comparing tuples may
+  // run user code that replaces items, so the kind is checked every time.
+  RawObject sortValue(RawObject item);
+
+  RawObject binaryInsertionSort(word lo, word hi, word start);
+  RawObject countRun(word lo, word hi, word* length_out);
+  RawObject gallopLeft(const Object& key, const MutableTuple& array, word base,
+                       word length, word hint, word* result_out);
+  RawObject gallopRight(const Object& key, const MutableTuple& array, word base,
+                        word length, word hint, word* result_out);
+  RawObject mergeAt(word index);
+  RawObject mergeCollapse();
+  RawObject mergeForceCollapse();
+  RawObject mergeLow(word base_a, word length_a, word base_b, word length_b);
+  RawObject mergeHigh(word base_a, word length_a, word base_b, word length_b);
+  RawMutableTuple tempWithLength(word length);
+
+  static word minRunLength(word num_items);
+
+  static const word kMinGallop = 7;
+  static const word kMinMerge = 64;
+  // Run lengths grow at least as fast as the Fibonacci numbers, so this is
+  // enough for any list that fits into memory.
+  static const word kMaxRuns = 85;
+
+  Thread* thread_;
+  MutableTuple data_;
+  // Scratch space for the shorter of the two runs being merged. It is
+  // allocated by the first merge that needs it.
+  Object temp_;
+  Object compare_func_;
+  Object left_;
+  Object right_;
+  bool by_key_;
+  // Set when the sort keys are tuples that are ordered by their first elements
+  // until those compare equal.
+  bool by_first_element_ = false;
+  SortKind kind_ = SortKind::kObject;
+  word min_gallop_ = kMinGallop;
+  Run runs_[kMaxRuns];
+  word num_runs_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ListSorter);
+};
 
-static RawObject objectLessThan(Thread* thread, const Object& left,
-                                const Object& right,
-                                const Object& compare_func) {
-  if (left.isSmallInt() && right.isSmallInt()) {
-    return Bool::fromBool(SmallInt::cast(*left).value() <
-                          SmallInt::cast(*right).value());
+static bool sortValueLessThan(SortKind kind, RawObject left, RawObject right) {
+  switch (kind) {
+    case SortKind::kInt:
+      return Int::cast(left).compare(Int::cast(right)) < 0;
+    case SortKind::kFloat:
+      // NaN is neither less nor greater than anything, like in Python.
+      return Float::cast(left).value() < Float::cast(right).value();
+    case SortKind::kStr:
+      return Str::cast(left).compare(Str::cast(right)) < 0;
+    case SortKind::kObject:
+      break;
   }
-  if (left.isStr() && right.isStr()) {
-    return Bool::fromBool(Str::cast(*left).compare(Str::cast(*right)) < 0);
+  UNREACHABLE("objects are not compared natively");
+}
+
+static bool sortValueEquals(SortKind kind, RawObject left, RawObject right) {
+  // Tuple comparison treats identical elements as equal.
+  if (left == right) return true;
+  switch (kind) {
+    case SortKind::kInt:
+      return Int::cast(left).compare(Int::cast(right)) == 0;
+    case SortKind::kFloat:
+      return Float::cast(left).value() == Float::cast(right).value();
+    case SortKind::kStr:
+      return Str::cast(left).equals(Str::cast(right));
+    case SortKind::kObject:
+      break;
   }
-  return Interpreter::call2(thread, compare_func, left, right);
+  UNREACHABLE("objects are not compared natively");
 }
 
-static RawObject listInsertionSort(Thread* thread, const MutableTuple& data,
-                                   const Object& compare_func, word start,
-                                   word end) {
-  HandleScope scope(thread);
-  Object item_i(&scope, NoneType::object());
-  Object item_j(&scope, NoneType::object());
-  Object compare_result(&scope, NoneType::object());
-  for (word i = start + 1; i < end; i++) {
-    item_i = data.at(i);
-    word j = i - 1;
-    for (; j >= start; j--) {
-      item_j = data.at(j);
-      compare_result = objectLessThan(thread, item_i, item_j, compare_func);
-      if (compare_result.isError()) {
-        return *compare_result;
-      }
-      compare_result = Interpreter::isTrue(thread, *compare_result);
-      if (compare_result.isError()) {
-        return *compare_result;
-      }
-      if (!Bool::cast(*compare_result).value()) {
-        break;
+RawObject ListSorter::lessThan(RawObject left, RawObject right) {
+  if (kind_ != SortKind::kObject) {
+    RawObject left_value = sortValue(left);
+    RawObject right_value = sortValue(right);
+    if (!left_value.isUnbound() && !right_value.isUnbound() &&
+        !(by_first_element_ &&
+          sortValueEquals(kind_, left_value, right_value))) {
+      return Bool::fromBool(sortValueLessThan(kind_, left_value, right_value));
+    }
+  }
+  left_ = left;
+  right_ = right;
+  HandleScope scope(thread_);
+  Object result(&scope,
+                Interpreter::call2(thread_, compare_func_, left_, right_));
+  if (result.isError()) return *result;
+  return Interpreter::isTrue(thread_, *result);
+}
+
+void ListSorter::pickSortKind(word num_items) {
+  RawObject first = data_.at(0);
+  if (by_key_) {
+    if (!first.isTuple()) return;
+    first = Tuple::cast(first).at(0);
+  }
+  by_first_element_ = first.isTuple() && Tuple::cast(first).length() > 0;
+  if (by_first_element_) {
+    first = Tuple::cast(first).at(0);
+  }
+  kind_ = sortKindOf(first);
+  for (word i = 1; kind_ != SortKind::kObject && i < num_items; i++) {
+    if (sortValue(data_.at(i)).isUnbound()) {
+      kind_ = SortKind::kObject;
+    }
+  }
+}
+
+RawObject ListSorter::sortValue(RawObject item) {
+  if (by_key_) {
+    if (!item.isTuple()) return Unbound::object();
+    item = Tuple::cast(item).at(0);
+  }
+  if (by_first_element_) {
+    if (!item.isTuple() || Tuple::cast(item).length() == 0) {
+      return Unbound::object();
+    }
+    item = Tuple::cast(item).at(0);
+  }
+  return sortKindOf(item) == kind_ ? item : Unbound::object();
+}
+
+RawMutableTuple ListSorter::tempWithLength(word length) {
+  word capacity =
+      temp_.isNoneType() ? 0 : MutableTuple::cast(*temp_).length();
+  if (capacity < length) {
+    temp_ = thread_->runtime()->newMutableTuple(
+        Runtime::newCapacity(capacity, length));
+  }
+  return MutableTuple::cast(*temp_);
+}
+
+word ListSorter::minRunLength(word num_items) {
+  // Take the six most significant bits and add one if any of the remaining
+  // bits are set. This keeps the number of runs at or just below a power of
+  // two, which balances the merges.
+  word remainder = 0;
+  while (num_items >= kMinMerge) {
+    remainder |= num_items & 1;
+    num_items >>= 1;
+  }
+  return num_items + remainder;
+}
+
+// Sorts `data[lo:hi]` where `data[lo:start]` is already sorted.
+RawObject ListSorter::binaryInsertionSort(word lo, word hi, word start) {
+  HandleScope scope(thread_);
+  Object pivot(&scope, NoneType::object());
+  for (; start < hi; start++) {
+    pivot = data_.at(start);
+    // Find the first position in `data[lo:start]` that is greater than the
+    // pivot, so that equal items keep their order.
+    word left = lo;
+    word right = start;
+    while (left < right) {
+      word middle = left + (right - left) / 2;
+      RawObject less = lessThan(*pivot, data_.at(middle));
+      if (less.isError()) return less;
+      if (less == Bool::trueObj()) {
+        right = middle;
+      } else {
+        left = middle + 1;
       }
-      data.atPut(j + 1, *item_j);
     }
-    data.atPut(j + 1, *item_i);
+    data_.replaceFromWithStartAt(left + 1, *data_, start - left, left);
+    data_.atPut(left, *pivot);
   }
   return NoneType::object();
 }
 
-// Merge 2 sublists, input[left: right], input[right: end] into
-// output[left: end].
-static RawObject listMerge(Thread* thread, const MutableTuple& input,
-                           const MutableTuple& output,
-                           const Object& compare_func, word left, word right,
-                           word end) {
-  HandleScope scope(thread);
-  Object item_i(&scope, NoneType::object());
-  Object item_j(&scope, NoneType::object());
-  Object compare_result(&scope, NoneType::object());
-  word i = left;
-  word j = right;
-  word k = left;
-  while (i < right && j < end) {
-    item_i = input.at(i);
-    item_j = input.at(j);
-    compare_result = objectLessThan(thread, item_j, item_i, compare_func);
-    if (compare_result.isError()) {
-      return *compare_result;
+// Finds the length of the run that starts at `lo`. A strictly descending run
+// is reversed in place; requiring strictness keeps the sort stable.
+RawObject ListSorter::countRun(word lo, word hi, word* length_out) {
+  word i = lo + 1;
+  if (i == hi) {
+    *length_out = 1;
+    return NoneType::object();
+  }
+  RawObject less = lessThan(data_.at(i), data_.at(lo));
+  if (less.isError()) return less;
+  bool descending = less == Bool::trueObj();
+  for (i++; i < hi; i++) {
+    less = lessThan(data_.at(i), data_.at(i - 1));
+    if (less.isError()) return less;
+    if ((less == Bool::trueObj()) != descending) break;
+  }
+  if (descending) {
+    for (word left = lo, right = i - 1; left < right; left++, right--) {
+      data_.swap(left, right);
+    }
+  }
+  *length_out = i - lo;
+  return NoneType::object();
+}
+
+// Finds the position `k` in the sorted `array[base:base+length]` where
+// `array[base+k-1] < key <= array[base+k]`, starting the search at `hint`.
+// The leftmost position keeps equal items from the left run first.
+RawObject ListSorter::gallopLeft(const Object& key, const MutableTuple& array,
+                                 word base, word length, word hint,
+                                 word* result_out) {
+  word last_offset = 0;
+  word offset = 1;
+  RawObject less = lessThan(array.at(base + hint), *key);
+  if (less.isError()) return less;
+  if (less == Bool::trueObj()) {
+    // Gallop right until array[hint+last_offset] < key <= array[hint+offset].
+    word max_offset = length - hint;
+    while (offset < max_offset) {
+      less = lessThan(array.at(base + hint + offset), *key);
+      if (less.isError()) return less;
+      if (less != Bool::trueObj()) break;
+      last_offset = offset;
+      offset = (offset << 1) + 1;
     }
-    compare_result = Interpreter::isTrue(thread, *compare_result);
-    if (compare_result.isError()) {
-      return *compare_result;
+    offset = Utils::minimum(offset, max_offset);
+    last_offset += hint;
+    offset += hint;
+  } else {
+    // Gallop left until array[hint-offset] < key <= array[hint-last_offset].
+    word max_offset = hint + 1;
+    while (offset < max_offset) {
+      less = lessThan(array.at(base + hint - offset), *key);
+      if (less.isError()) return less;
+      if (less == Bool::trueObj()) break;
+      last_offset = offset;
+      offset = (offset << 1) + 1;
     }
-    if (*compare_result == Bool::trueObj()) {
-      output.atPut(k++, *item_j);
-      j++;
+    offset = Utils::minimum(offset, max_offset);
+    word old_last_offset = last_offset;
+    last_offset = hint - offset;
+    offset = hint - old_last_offset;
+  }
+  // Now array[last_offset] < key <= array[offset]; binary search between.
+  for (last_offset++; last_offset < offset;) {
+    word middle = last_offset + ((offset - last_offset) >> 1);
+    less = lessThan(array.at(base + middle), *key);
+    if (less.isError()) return less;
+    if (less == Bool::trueObj()) {
+      last_offset = middle + 1;
     } else {
-      DCHECK(compare_result == Bool::falseObj(), "expected to be false");
-      output.atPut(k++, *item_i);
-      i++;
+      offset = middle;
     }
   }
-  for (; i < right; i++) {
-    output.atPut(k++, input.at(i));
+  *result_out = offset;
+  return NoneType::object();
+}
+
+// Like `gallopLeft()`, but finds the position `k` where
+// `array[base+k-1] <= key < array[base+k]`.
+RawObject ListSorter::gallopRight(const Object& key, const MutableTuple& array,
+                                  word base, word length, word hint,
+                                  word* result_out) {
+  word last_offset = 0;
+  word offset = 1;
+  RawObject less = lessThan(*key, array.at(base + hint));
+  if (less.isError()) return less;
+  if (less == Bool::trueObj()) {
+    // Gallop left until array[hint-offset] <= key < array[hint-last_offset].
+    word max_offset = hint + 1;
+    while (offset < max_offset) {
+      less = lessThan(*key, array.at(base + hint - offset));
+      if (less.isError()) return less;
+      if (less != Bool::trueObj()) break;
+      last_offset = offset;
+      offset = (offset << 1) + 1;
+    }
+    offset = Utils::minimum(offset, max_offset);
+    word old_last_offset = last_offset;
+    last_offset = hint - offset;
+    offset = hint - old_last_offset;
+  } else {
+    // Gallop right until array[hint+last_offset] <= key < array[hint+offset].
+    word max_offset = length - hint;
+    while (offset < max_offset) {
+      less = lessThan(*key, array.at(base + hint + offset));
+      if (less.isError()) return less;
+      if (less == Bool::trueObj()) break;
+      last_offset = offset;
+      offset = (offset << 1) + 1;
+    }
+    offset = Utils::minimum(offset, max_offset);
+    last_offset += hint;
+    offset += hint;
   }
-  for (; j < end; j++) {
-    output.atPut(k++, input.at(j));
+  // Now array[last_offset] <= key < array[offset]; binary search between.
+  for (last_offset++; last_offset < offset;) {
+    word middle = last_offset + ((offset - last_offset) >> 1);
+    less = lessThan(*key, array.at(base + middle));
+    if (less.isError()) return less;
+    if (less == Bool::trueObj()) {
+      offset = middle;
+    } else {
+      last_offset = middle + 1;
+    }
+  }
+  *result_out = offset;
+  return NoneType::object();
+}
+
+// Merges the adjacent runs `data[base_a:base_a+length_a]` and
+// `data[base_b:base_b+length_b]` where the first run is not longer than the
+// second. The first item of B belongs before A and the last item of A belongs
+// after B. A is moved to the scratch space and the merge fills `data` from
+// the left.
+RawObject ListSorter::mergeLow(word base_a, word length_a, word base_b,
+                               word length_b) {
+  DCHECK(length_a > 0 && length_b > 0 && base_a + length_a == base_b,
+         "runs must be adjacent and non-empty");
+  HandleScope scope(thread_);
+  MutableTuple temp(&scope, tempWithLength(length_a));
+  temp.replaceFromWithStartAt(0, *data_, length_a, base_a);
+  Object key(&scope, NoneType::object());
+  word a = 0;
+  word b = base_b;
+  word dest = base_a;
+  RawObject result = NoneType::object();
+  data_.atPut(dest++, data_.at(b++));
+  length_b--;
+  if (length_b == 0) goto done;
+  if (length_a == 1) goto copy_b;
+  for (;;) {
+    // Merge one item at a time until one run wins often enough in a row.
+    word count_a = 0;
+    word count_b = 0;
+    do {
+      RawObject less = lessThan(data_.at(b), temp.at(a));
+      if (less.isError()) {
+        result = less;
+        goto done;
+      }
+      if (less == Bool::trueObj()) {
+        data_.atPut(dest++, data_.at(b++));
+        count_b++;
+        count_a = 0;
+        if (--length_b == 0) goto done;
+      } else {
+        data_.atPut(dest++, temp.at(a++));
+        count_a++;
+        count_b = 0;
+        if (--length_a == 1) goto copy_b;
+      }
+    } while ((count_a | count_b) < min_gallop_);
+
+    // Gallop: find where the next item of each run goes in the other run and
+    // move whole slices until neither run wins by much.
+    min_gallop_++;
+    do {
+      min_gallop_ -= min_gallop_ > 1;
+      key = data_.at(b);
+      word k;
+      result = gallopRight(key, temp, a, length_a, 0, &k);
+      if (result.isError()) goto done;
+      count_a = k;
+      if (k > 0) {
+        data_.replaceFromWithStartAt(dest, *temp, k, a);
+        dest += k;
+        a += k;
+        length_a -= k;
+        if (length_a == 1) goto copy_b;
+        // With a consistent comparison the last item of A is greater than
+        // all of B, so A cannot run out here.
+        if (length_a == 0) goto done;
+      }
+      data_.atPut(dest++, data_.at(b++));
+      if (--length_b == 0) goto done;
+
+      key = temp.at(a);
+      result = gallopLeft(key, data_, b, length_b, 0, &k);
+      if (result.isError()) goto done;
+      count_b = k;
+      if (k > 0) {
+        data_.replaceFromWithStartAt(dest, *data_, k, b);
+        dest += k;
+        b += k;
+        length_b -= k;
+        if (length_b == 0) goto done;
+      }
+      data_.atPut(dest++, temp.at(a++));
+      if (--length_a == 1) goto copy_b;
+    } while (count_a >= kMinGallop || count_b >= kMinGallop);
+    // Penalize leaving the galloping mode.
+    min_gallop_++;
+  }
+
+copy_b:
+  // The last item of A belongs after the rest of B.
+  DCHECK(length_a == 1 && length_b > 0, "unexpected run lengths");
+  data_.replaceFromWithStartAt(dest, *data_, length_b, b);
+  data_.atPut(dest + length_b, temp.at(a));
+  return NoneType::object();
+
+done:
+  // Put back what is left of A, which also keeps all items in the list when
+  // a comparison raised.
+  if (length_a > 0) {
+    data_.replaceFromWithStartAt(dest, *temp, length_a, a);
+  }
+  return result;
+}
+
+// Mirror image of `mergeLow()` for a second run that is shorter than the
+// first. B is moved to the scratch space and the merge fills `data` from the
+// right.
+RawObject ListSorter::mergeHigh(word base_a, word length_a, word base_b,
+                                word length_b) {
+  DCHECK(length_a > 0 && length_b > 0 && base_a + length_a == base_b,
+         "runs must be adjacent and non-empty");
+  HandleScope scope(thread_);
+  MutableTuple temp(&scope, tempWithLength(length_b));
+  temp.replaceFromWithStartAt(0, *data_, length_b, base_b);
+  Object key(&scope, NoneType::object());
+  // Indexes of the last unmerged item of each run and the last free slot.
+  word a = base_a + length_a - 1;
+  word b = length_b - 1;
+  word dest = base_b + length_b - 1;
+  RawObject result = NoneType::object();
+  data_.atPut(dest--, data_.at(a--));
+  length_a--;
+  if (length_a == 0) goto done;
+  if (length_b == 1) goto copy_a;
+  for (;;) {
+    word count_a = 0;
+    word count_b = 0;
+    do {
+      RawObject less = lessThan(temp.at(b), data_.at(a));
+      if (less.isError()) {
+        result = less;
+        goto done;
+      }
+      if (less == Bool::trueObj()) {
+        data_.atPut(dest--, data_.at(a--));
+        count_a++;
+        count_b = 0;
+        if (--length_a == 0) goto done;
+      } else {
+        data_.atPut(dest--, temp.at(b--));
+        count_b++;
+        count_a = 0;
+        if (--length_b == 1) goto copy_a;
+      }
+    } while ((count_a | count_b) < min_gallop_);
+
+    min_gallop_++;
+    do {
+      min_gallop_ -= min_gallop_ > 1;
+      key = temp.at(b);
+      word k;
+      result = gallopRight(key, data_, base_a, length_a, length_a - 1, &k);
+      if (result.isError()) goto done;
+      k = length_a - k;
+      count_a = k;
+      if (k > 0) {
+        dest -= k;
+        a -= k;
+        data_.replaceFromWithStartAt(dest + 1, *data_, k, a + 1);
+        length_a -= k;
+        if (length_a == 0) goto done;
+      }
+      data_.atPut(dest--, temp.at(b--));
+      if (--length_b == 1) goto copy_a;
+
+      key = data_.at(a);
+      result = gallopLeft(key, temp, 0, length_b, length_b - 1, &k);
+      if (result.isError()) goto done;
+      k = length_b - k;
+      count_b = k;
+      if (k > 0) {
+        dest -= k;
+        b -= k;
+        data_.replaceFromWithStartAt(dest + 1, *temp, k, b + 1);
+        length_b -= k;
+        if (length_b == 1) goto copy_a;
+        // With a consistent comparison the first item of B is less than all
+        // of A, so B cannot run out here.
+        if (length_b == 0) goto done;
+      }
+      data_.atPut(dest--, data_.at(a--));
+      if (--length_a == 0) goto done;
+    } while (count_a >= kMinGallop || count_b >= kMinGallop);
+    min_gallop_++;
   }
-  DCHECK(k == end, "sublists were not fully copied");
+
+copy_a:
+  // The first item of B belongs before the rest of A.
+  DCHECK(length_b == 1 && length_a > 0, "unexpected run lengths");
+  dest -= length_a;
+  a -= length_a;
+  data_.replaceFromWithStartAt(dest + 1, *data_, length_a, a + 1);
+  data_.atPut(dest, temp.at(b));
+  return NoneType::object();
+
+done:
+  if (length_b > 0) {
+    data_.replaceFromWithStartAt(dest - (length_b - 1), *temp, length_b, 0);
+  }
+  return result;
+}
+
+// Merges the runs at `index` and `index + 1` of the run stack.
+RawObject ListSorter::mergeAt(word index) {
+  word base_a = runs_[index].base;
+  word length_a = runs_[index].length;
+  word base_b = runs_[index + 1].base;
+  word length_b = runs_[index + 1].length;
+  runs_[index].length = length_a + length_b;
+  if (index == num_runs_ - 3) {
+    runs_[index + 1] = runs_[index + 2];
+  }
+  num_runs_--;
+
+  HandleScope scope(thread_);
+  // Items of A that are not greater than the first item of B are already in
+  // place, and so are items of B that are not less than the last item of A.
+  Object key(&scope, data_.at(base_b));
+  word k;
+  RawObject result = gallopRight(key, data_, base_a, length_a, 0, &k);
+  if (result.isError()) return result;
+  base_a += k;
+  length_a -= k;
+  if (length_a == 0) return NoneType::object();
+  key = data_.at(base_a + length_a - 1);
+  result = gallopLeft(key, data_, base_b, length_b, length_b - 1, &k);
+  if (result.isError()) return result;
+  length_b = k;
+  if (length_b == 0) return NoneType::object();
+  if (length_a <= length_b) {
+    return mergeLow(base_a, length_a, base_b, length_b);
+  }
+  return mergeHigh(base_a, length_a, base_b, length_b);
+}
+
+// Merges runs until the lengths on the stack decrease faster than the
+// Fibonacci numbers from the bottom up.
+RawObject ListSorter::mergeCollapse() {
+  while (num_runs_ > 1) {
+    word n = num_runs_ - 2;
+    if ((n > 0 &&
+         runs_[n - 1].length <= runs_[n].length + runs_[n + 1].length) ||
+        (n > 1 &&
+         runs_[n - 2].length <= runs_[n - 1].length + runs_[n].length)) {
+      if (runs_[n - 1].length < runs_[n + 1].length) n--;
+    } else if (runs_[n].length > runs_[n + 1].length) {
+      break;
+    }
+    RawObject result = mergeAt(n);
+    if (result.isError()) return result;
+  }
+  return NoneType::object();
+}
+
+RawObject ListSorter::mergeForceCollapse() {
+  while (num_runs_ > 1) {
+    word n = num_runs_ - 2;
+    if (n > 0 && runs_[n - 1].length < runs_[n + 1].length) n--;
+    RawObject result = mergeAt(n);
+    if (result.isError()) return result;
+  }
+  return NoneType::object();
+}
+
+RawObject ListSorter::sort(word num_items) {
+  if (num_items < 2) return NoneType::object();
+  pickSortKind(num_items);
+  word min_run = minRunLength(num_items);
+  for (word lo = 0; lo < num_items;) {
+    word length;
+    RawObject result = countRun(lo, num_items, &length);
+    if (result.isError()) return result;
+    // Extend short runs to `min_run` items with insertion sort.
+    if (length < min_run) {
+      word forced = Utils::minimum(min_run, num_items - lo);
+      result = binaryInsertionSort(lo, lo + forced, lo + length);
+      if (result.isError()) return result;
+      length = forced;
+    }
+    DCHECK(num_runs_ < kMaxRuns, "run stack overflow");
+    runs_[num_runs_++] = {lo, length};
+    result = mergeCollapse();
+    if (result.isError()) return result;
+    lo += length;
+  }
+  RawObject result = mergeForceCollapse();
+  if (result.isError()) return result;
+  DCHECK(num_runs_ == 1 && runs_[0].length == num_items,
+         "all runs must be merged");
   return NoneType::object();
 }
 
@@ -197,16 +754,10 @@ RawObject listSort(Thread* thread, const List& list) {
   return listSortWithCompareMethod(thread, list, ID(_lt));
 }
 
-// This uses an adaptation of merge sort. It sorts sublists of size
-// kListInsertionSortSize or less using insertion sort first. Afterwards, it is
-// using a bottom-up merge sort to increase the sublists' size by power of 2.
-// Also, this function allocates a temporary space to ease merging and swaps
-// `input` and `output` to avoid further allocation.
-// TODO(T39107329): Consider using Timsort for further optimization.
 RawObject listSortWithCompareMethod(Thread* thread, const List& list,
                                     SymbolId compare_method) {
   word num_items = list.numItems();
-  if (num_items == 0) {
+  if (num_items < 2) {
     return NoneType::object();
   }
   HandleScope scope(thread);
@@ -214,38 +765,10 @@ RawObject listSortWithCompareMethod(Thread* thread, const List& list,
   Object compare_func(&scope, runtime->lookupNameInModule(thread, ID(_builtins),
                                                           compare_method));
   if (compare_func.isError()) return *compare_func;
-  MutableTuple input(&scope, list.items());
-  Object compare_result(&scope, NoneType::object());
-  for (word left = 0; left < num_items; left += kListInsertionSortSize) {
-    word right = Utils::minimum(left + kListInsertionSortSize, num_items);
-    compare_result =
-        listInsertionSort(thread, input, compare_func, left, right);
-    if (compare_result.isError()) {
-      return *compare_result;
-    }
-  }
-  if (num_items <= kListInsertionSortSize) {
-    // The input list is small enough to be sorted by insertion sort.
-    return NoneType::object();
-  }
-  MutableTuple output(&scope, runtime->newMutableTuple(input.length()));
-  Object tmp(&scope, NoneType::object());
-  for (word width = kListInsertionSortSize; width < num_items; width *= 2) {
-    for (word left = 0; left < num_items; left += width * 2) {
-      word right = Utils::minimum(num_items, left + width);
-      word end = Utils::minimum(num_items, left + width * 2);
-      compare_result =
-          listMerge(thread, input, output, compare_func, left, right, end);
-      if (compare_result.isError()) {
-        return *compare_result;
-      }
-    }
-    tmp = *output;
-    output = *input;
-    input = MutableTuple::cast(*tmp);
-  }
-  list.setItems(*input);
-  return NoneType::object();
+  MutableTuple data(&scope, list.items());
+  ListSorter sorter(&scope, thread, data, compare_func,
+                    compare_method == ID(_lt_key));
+  return sorter.sort(num_items);
 }
 
 RawObject listIteratorNext(Thread* thread, const ListIterator& iter) {
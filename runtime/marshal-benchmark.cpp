@@ -0,0 +1,74 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include <memory>
+
+#include "benchmark/benchmark.h"
+
+#include "benchmark-utils.h"
+#include "handles.h"
+#include "marshal.h"
+#include "runtime.h"
+
+namespace py {
+namespace testing {
+
+using MarshalBenchmark = RuntimeBenchmark;
+
+// Compiles a moderately sized module, the kind of code object that importing
+// a module writes to and reads from a `.pyc` file.
+static void compileBenchmarkModule(Runtime* runtime) {
+  CHECK(!runFromCStr(runtime, R"(
+marshal_source = "\n".join(
+  f"""
+class C{i}:
+    attribute_{i} = {i}
+    def method_{i}(self, argument, *args, keyword={i}.5, **kwargs):
+        return (argument, args, keyword, kwargs, "constant string {i}")
+"""
+  for i in range(50)
+)
+marshal_code = compile(marshal_source, "<benchmark>", "exec")
+)")
+             .isError(),
+        "setup failed");
+}
+
+BENCHMARK_DEFINE_F(MarshalBenchmark, ReadCode)(benchmark::State& state) {
+  compileBenchmarkModule(runtime_);
+  HandleScope scope(thread_);
+  Object code(&scope, mainModuleAt(runtime_, "marshal_code"));
+  Marshal::Writer writer(&scope, thread_, 2);
+  CHECK(!writer.writeObject(code).isError(), "write failed");
+  Bytes data(&scope, writer.result());
+  word length = data.length();
+  std::unique_ptr<byte[]> buffer(new byte[length]);
+  data.copyTo(buffer.get(), length);
+  for (auto _ : state) {
+    HandleScope iteration_scope(thread_);
+    Marshal::Reader reader(&iteration_scope, thread_,
+                           View<byte>(buffer.get(), length));
+    benchmark::DoNotOptimize(reader.readObject());
+  }
+  state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK_REGISTER_F(MarshalBenchmark, ReadCode);
+
+// Writes the same code object. The argument is the marshal version; version 3
+// adds the pass that finds objects occurring more than once.
+BENCHMARK_DEFINE_F(MarshalBenchmark, WriteCode)(benchmark::State& state) {
+  compileBenchmarkModule(runtime_);
+  HandleScope scope(thread_);
+  Object code(&scope, mainModuleAt(runtime_, "marshal_code"));
+  word version = state.range(0);
+  word length = 0;
+  for (auto _ : state) {
+    HandleScope iteration_scope(thread_);
+    Marshal::Writer writer(&iteration_scope, thread_, version);
+    benchmark::DoNotOptimize(writer.writeObject(code));
+    length = Bytes::cast(writer.result()).length();
+  }
+  state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK_REGISTER_F(MarshalBenchmark, WriteCode)->Arg(2)->Arg(3)->Arg(4);
+
+}  // namespace testing
+}  // namespace py
@@ -25,6 +25,20 @@ void FUNC(marshal, __init_module__)(Thread* thread, const Module& module,
   executeFrozenModule(thread, module, bytecode);
 }
 
+RawObject FUNC(marshal, dumps)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object value(&scope, args.get(0));
+  Object version_obj(&scope, args.get(1));
+  if (!thread->runtime()->isInstanceOfInt(*version_obj)) {
+    return thread->raiseRequiresType(version_obj, ID(int));
+  }
+  word version = intUnderlying(*version_obj).asWordSaturated();
+  Marshal::Writer writer(&scope, thread, version);
+  Object result(&scope, writer.writeObject(value));
+  if (result.isErrorException()) return *result;
+  return writer.result();
+}
+
 RawObject FUNC(marshal, loads)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   Object bytes_obj(&scope, args.get(0));
@@ -3,10 +3,12 @@
 
 #include <cmath>
 #include <cstdint>
+#include <memory>
 
 #include "gtest/gtest.h"
 
 #include "globals.h"
+#include "interpreter.h"
 #include "runtime.h"
 #include "test-utils.h"
 
@@ -15,6 +17,7 @@ namespace testing {
 
 using MarshalReaderDeathTest = RuntimeFixture;
 using MarshalReaderTest = RuntimeFixture;
+using MarshalWriterTest = RuntimeFixture;
 
 TEST_F(MarshalReaderTest, ReadBytes) {
   HandleScope scope(thread_);
@@ -640,5 +643,180 @@ TEST_F(MarshalReaderTest,
   EXPECT_TRUE(isIntEqualsWord(*result, -0x8000000000000000));
 }
 
+static RawObject writeObject(Thread* thread, const Object& value,
+                             word version) {
+  HandleScope scope(thread);
+  Marshal::Writer writer(&scope, thread, version);
+  Object result(&scope, writer.writeObject(value));
+  if (result.isErrorException()) return *result;
+  return writer.result();
+}
+
+static RawObject readObject(Thread* thread, const Bytes& data) {
+  HandleScope scope(thread);
+  word length = data.length();
+  std::unique_ptr<byte[]> buffer(new byte[length]);
+  data.copyTo(buffer.get(), length);
+  Marshal::Reader reader(&scope, thread, View<byte>(buffer.get(), length));
+  return reader.readObject();
+}
+
+TEST_F(MarshalWriterTest, WriteLongWritesLittleEndian) {
+  HandleScope scope(thread_);
+  Marshal::Writer writer(&scope, thread_, 2);
+  writer.writeLong(0x12345678);
+  writer.writeShort(-2);
+  writer.writeByte('x');
+  const byte expected[] = {0x78, 0x56, 0x34, 0x12, 0xfe, 0xff, 'x'};
+  Object result(&scope, writer.result());
+  EXPECT_TRUE(isBytesEqualsBytes(result, expected));
+}
+
+TEST_F(MarshalWriterTest, WriteObjectRoundTripsThroughReader) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+values = (
+  0, -1, 2 ** 31, -(2 ** 31) - 1, 2 ** 62, -(2 ** 63), 2 ** 64 - 1,
+  7 ** 100, -(7 ** 100), 0.1, -0.0, float("inf"), 1.5 + 2.5j, "",
+  "hello", "a" * 300, "héllo \U0001f600" * 20, "\udc80", b"bytes",
+  (), (1,) * 300, [None, True, False, ...], {"a": [1, 2.0], 3: ()},
+  {1, "two"}, frozenset({(3,)}), StopIteration,
+)
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Object values(&scope, mainModuleAt(runtime_, "values"));
+  Object data(&scope, NoneType::object());
+  Object result(&scope, NoneType::object());
+  Object equal(&scope, NoneType::object());
+  for (word version = 0; version <= 4; version++) {
+    data = writeObject(thread_, values, version);
+    ASSERT_TRUE(data.isBytes()) << "version " << version;
+    Bytes bytes(&scope, *data);
+    result = readObject(thread_, bytes);
+    equal =
+        Interpreter::compareOperation(thread_, CompareOp::EQ, values, result);
+    EXPECT_EQ(equal, Bool::trueObj()) << "version " << version;
+  }
+}
+
+TEST_F(MarshalWriterTest, WriteObjectRoundTripsCode) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+def f(a, b=2, *args, c, **kwargs):
+  def g():
+    return a
+  return g, "constant", 1.5
+code = f.__code__
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Object code(&scope, mainModuleAt(runtime_, "code"));
+  for (word version = 2; version <= 4; version++) {
+    Bytes data(&scope, writeObject(thread_, code, version));
+    Object result(&scope, readObject(thread_, data));
+    ASSERT_TRUE(result.isCode());
+    Code original(&scope, *code);
+    Code copy(&scope, *result);
+    EXPECT_EQ(copy.argcount(), original.argcount());
+    EXPECT_EQ(copy.kwonlyargcount(), original.kwonlyargcount());
+    EXPECT_EQ(copy.flags(), original.flags());
+    EXPECT_EQ(copy.firstlineno(), original.firstlineno());
+    Object left(&scope, original.code());
+    Object right(&scope, copy.code());
+    EXPECT_EQ(
+        Interpreter::compareOperation(thread_, CompareOp::EQ, left, right),
+        Bool::trueObj());
+    left = original.varnames();
+    right = copy.varnames();
+    EXPECT_EQ(
+        Interpreter::compareOperation(thread_, CompareOp::EQ, left, right),
+        Bool::trueObj());
+    left = original.cellvars();
+    right = copy.cellvars();
+    EXPECT_EQ(
+        Interpreter::compareOperation(thread_, CompareOp::EQ, left, right),
+        Bool::trueObj());
+    Tuple consts(&scope, copy.consts());
+    ASSERT_EQ(consts.length(), Tuple::cast(original.consts()).length());
+    bool has_code = false;
+    for (word i = 0; i < consts.length(); i++) {
+      has_code |= consts.at(i).isCode();
+    }
+    EXPECT_TRUE(has_code);
+  }
+}
+
+TEST_F(MarshalWriterTest, WriteObjectWithVersion3SharesRepeatedObjects) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+shared = [1.5, "x" * 40]
+value = [shared, shared, (shared,)]
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Object value(&scope, mainModuleAt(runtime_, "value"));
+  Bytes data(&scope, writeObject(thread_, value, 3));
+  List result(&scope, readObject(thread_, data));
+  ASSERT_EQ(result.numItems(), 3);
+  EXPECT_TRUE(result.at(0).isList());
+  EXPECT_EQ(result.at(0), result.at(1));
+  EXPECT_EQ(Tuple::cast(result.at(2)).at(0), result.at(0));
+
+  // Version 2 writes the shared list three times.
+  Bytes data_v2(&scope, writeObject(thread_, value, 2));
+  EXPECT_GT(data_v2.length(), data.length());
+  List result_v2(&scope, readObject(thread_, data_v2));
+  EXPECT_NE(result_v2.at(0), result_v2.at(1));
+}
+
+TEST_F(MarshalWriterTest, WriteObjectWithManySharedObjectsGrowsRefs) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+items = [str(i) * 20 for i in range(1000)]
+value = (items, items[::-1])
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Object value(&scope, mainModuleAt(runtime_, "value"));
+  Bytes data(&scope, writeObject(thread_, value, 3));
+  Tuple result(&scope, readObject(thread_, data));
+  List items(&scope, result.at(0));
+  List reversed(&scope, result.at(1));
+  ASSERT_EQ(items.numItems(), 1000);
+  for (word i = 0; i < 1000; i++) {
+    EXPECT_EQ(items.at(i), reversed.at(999 - i));
+  }
+}
+
+TEST_F(MarshalWriterTest, WriteObjectWithVersion3WritesSelfReferences) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+value = []
+value.append(value)
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Object value(&scope, mainModuleAt(runtime_, "value"));
+  Bytes data(&scope, writeObject(thread_, value, 3));
+  List result(&scope, readObject(thread_, data));
+  ASSERT_EQ(result.numItems(), 1);
+  EXPECT_EQ(result.at(0), *result);
+  EXPECT_TRUE(raisedWithStr(writeObject(thread_, value, 2),
+                            LayoutId::kValueError,
+                            "object too deeply nested to marshal"));
+}
+
+TEST_F(MarshalWriterTest, WriteObjectWithUnmarshallableRaisesValueError) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C(int):
+  pass
+value = [1, {"key": C(2)}]
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Object value(&scope, mainModuleAt(runtime_, "value"));
+  for (word version = 0; version <= 4; version++) {
+    EXPECT_TRUE(raisedWithStr(writeObject(thread_, value, version),
+                              LayoutId::kValueError, "unmarshallable object"));
+    thread_->clearPendingException();
+  }
+}
+
 }  // namespace testing
 }  // namespace py
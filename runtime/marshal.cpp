@@ -5,6 +5,10 @@
 #include <cstring>
 #include <memory>
 
+#include "bytearray-builtins.h"
+#include "byteslike.h"
+#include "dict-builtins.h"
+#include "float-conversion.h"
 #include "handles.h"
 #include "heap.h"
 #include "modules.h"
@@ -149,7 +153,7 @@ RawObject Marshal::Reader::readObject() {
       return NoneType::object();
 
     case TYPE_STOPITER:
-      UNIMPLEMENTED("TYPE_STOPITER");
+      return runtime_->typeAt(LayoutId::kStopIteration);
 
     case TYPE_ELLIPSIS:
       return runtime_->ellipsis();
@@ -177,7 +181,7 @@ RawObject Marshal::Reader::readObject() {
     }
 
     case TYPE_FLOAT:
-      UNIMPLEMENTED("TYPE_FLOAT");
+      return readTypeFloat();
 
     case TYPE_BINARY_FLOAT: {
       double n = readBinaryFloat();
@@ -190,7 +194,7 @@ RawObject Marshal::Reader::readObject() {
     }
 
     case TYPE_COMPLEX:
-      UNIMPLEMENTED("TYPE_COMPLEX");
+      return readTypeComplex();
 
     case TYPE_BINARY_COMPLEX: {
       double real = readBinaryFloat();
@@ -228,10 +232,10 @@ RawObject Marshal::Reader::readObject() {
       return readTypeTuple();
 
     case TYPE_LIST:
-      UNIMPLEMENTED("TYPE_LIST");
+      return readTypeList();
 
     case TYPE_DICT:
-      UNIMPLEMENTED("TYPE_DICT");
+      return readTypeDict();
 
     case TYPE_SET:
       return readTypeSet();
@@ -279,6 +283,47 @@ RawObject Marshal::Reader::readTypeString() {
   return *result;
 }
 
+bool Marshal::Reader::readFloatStr(double* result) {
+  word length = readByte();
+  const byte* data = readBytes(length);
+  char buffer[256];
+  std::memcpy(buffer, data, length);
+  buffer[length] = '\0';
+  char* end;
+  ConversionResult conversion;
+  *result = parseFloat(buffer, &end, &conversion);
+  return conversion == ConversionResult::kSuccess && end == buffer + length;
+}
+
+RawObject Marshal::Reader::readTypeFloat() {
+  double value;
+  if (!readFloatStr(&value)) {
+    return thread_->raiseWithFmt(LayoutId::kValueError,
+                                 "bad marshal data (invalid float)");
+  }
+  HandleScope scope(thread_);
+  Object result(&scope, runtime_->newFloat(value));
+  if (isRef_) {
+    addRef(result);
+  }
+  return *result;
+}
+
+RawObject Marshal::Reader::readTypeComplex() {
+  double real;
+  double imag;
+  if (!readFloatStr(&real) || !readFloatStr(&imag)) {
+    return thread_->raiseWithFmt(LayoutId::kValueError,
+                                 "bad marshal data (invalid complex)");
+  }
+  HandleScope scope(thread_);
+  Object result(&scope, runtime_->newComplex(real, imag));
+  if (isRef_) {
+    addRef(result);
+  }
+  return *result;
+}
+
 RawObject Marshal::Reader::readTypeAscii() {
   word length = readLong();
   if (length < 0) {
@@ -358,6 +403,57 @@ RawObject Marshal::Reader::doTupleElements(int32_t length) {
   return result.becomeImmutable();
 }
 
+RawObject Marshal::Reader::readTypeList() {
+  int32_t length = readLong();
+  if (length < 0) {
+    return thread_->raiseWithFmt(LayoutId::kValueError,
+                                 "bad marshal data (list size out of range)");
+  }
+  HandleScope scope(thread_);
+  List result(&scope, runtime_->newList());
+  if (isRef_) {
+    addRef(result);
+  }
+  runtime_->listEnsureCapacity(thread_, result, length);
+  Object value(&scope, NoneType::object());
+  for (int32_t i = 0; i < length; i++) {
+    value = readObject();
+    if (value.isErrorException()) return *value;
+    runtime_->listAdd(thread_, result, value);
+  }
+  return *result;
+}
+
+RawObject Marshal::Reader::readTypeDict() {
+  HandleScope scope(thread_);
+  Dict result(&scope, runtime_->newDict());
+  if (isRef_) {
+    addRef(result);
+  }
+  Object key(&scope, NoneType::object());
+  Object value(&scope, NoneType::object());
+  Object hash_obj(&scope, NoneType::object());
+  // The items are terminated by TYPE_NULL, which `readObject()` cannot tell
+  // apart from the integer 0.
+  while (pos_ < length_ && start_[pos_] != TYPE_NULL) {
+    key = readObject();
+    if (key.isErrorException()) return *key;
+    value = readObject();
+    if (value.isErrorException()) return *value;
+    hash_obj = Interpreter::hash(thread_, key);
+    if (hash_obj.isErrorException()) return *hash_obj;
+    word hash = SmallInt::cast(*hash_obj).value();
+    RawObject put_result = dictAtPut(thread_, result, key, hash, value);
+    if (put_result.isErrorException()) return put_result;
+  }
+  if (pos_ == length_) {
+    return thread_->raiseWithFmt(LayoutId::kEOFError,
+                                 "EOF read where object expected");
+  }
+  pos_++;
+  return *result;
+}
+
 RawObject Marshal::Reader::readTypeSet() {
   int32_t n = readLong();
   HandleScope scope(thread_);
@@ -557,4 +653,458 @@ RawObject Marshal::Reader::readLongObject() {
   return *result;
 }
 
+
+Marshal::Writer::Writer(HandleScope* scope, Thread* thread, word version)
+    : thread_(thread),
+      runtime_(thread->runtime()),
+      buffer_(scope, runtime_->newBytearray()),
+      refs_(scope, runtime_->newMutableTuple(kInitialRefsCapacity * 2)),
+      refs_remaining_(kInitialRefsCapacity * 2 / 3),
+      version_(version) {
+  refs_.fill(Unbound::object());
+}
+
+RawObject Marshal::Writer::result() {
+  return bytearrayAsBytes(thread_, buffer_);
+}
+
+void Marshal::Writer::writeByte(byte value) {
+  bytearrayAdd(thread_, runtime_, buffer_, value);
+}
+
+void Marshal::Writer::writeBytes(View<byte> data) {
+  runtime_->bytearrayExtend(thread_, buffer_, data);
+}
+
+void Marshal::Writer::writeShort(int16_t value) {
+  byte buffer[2] = {static_cast<byte>(value), static_cast<byte>(value >> 8)};
+  writeBytes(buffer);
+}
+
+void Marshal::Writer::writeLong(int32_t value) {
+  byte buffer[4] = {static_cast<byte>(value), static_cast<byte>(value >> 8),
+                    static_cast<byte>(value >> 16),
+                    static_cast<byte>(value >> 24)};
+  writeBytes(buffer);
+}
+
+void Marshal::Writer::writeBinaryFloat(double value) {
+  byte buffer[sizeof(value)];
+  std::memcpy(buffer, &value, sizeof(value));
+  writeBytes(buffer);
+}
+
+void Marshal::Writer::writeFloatStr(double value) {
+  unique_c_ptr<char> str(
+      doubleToString(value, 'g', 17, false, false, false, nullptr));
+  word length = std::strlen(str.get());
+  writeByte(static_cast<byte>(length));
+  writeBytes(View<byte>(reinterpret_cast<byte*>(str.get()), length));
+}
+
+void Marshal::Writer::writeInt(const Int& value, byte flag) {
+  if (value.isSmallInt()) {
+    word small = value.asWord();
+    if (kMinInt32 <= small && small <= kMaxInt32) {
+      writeByte(TYPE_INT | flag);
+      writeLong(static_cast<int32_t>(small));
+      return;
+    }
+  }
+  // Write the magnitude in 15 bit digits, least significant first, and
+  // carry the sign in the digit count.
+  word num_digits = value.numDigits();
+  std::unique_ptr<uword[]> digits(new uword[num_digits]);
+  for (word i = 0; i < num_digits; i++) {
+    digits[i] = value.digitAt(i);
+  }
+  bool negative = value.isNegative();
+  if (negative) {
+    uword carry = 1;
+    for (word i = 0; i < num_digits; i++) {
+      uword digit = digits[i];
+      carry = __builtin_uaddl_overflow(~digit, carry, &digit);
+      digits[i] = digit;
+    }
+  }
+  while (digits[num_digits - 1] == 0) {
+    num_digits--;
+  }
+  word num_bits = (num_digits - 1) * kBitsPerWord +
+                  Utils::highestBit(digits[num_digits - 1]);
+  word num_long_digits =
+      (num_bits + kBitsPerLongDigit - 1) / kBitsPerLongDigit;
+  writeByte(TYPE_LONG | flag);
+  writeLong(negative ? -num_long_digits : num_long_digits);
+  for (word i = 0; i < num_long_digits; i++) {
+    word bit = i * kBitsPerLongDigit;
+    word index = bit / kBitsPerWord;
+    word shift = bit % kBitsPerWord;
+    uword digit = digits[index] >> shift;
+    if (shift > kBitsPerWord - kBitsPerLongDigit && index + 1 < num_digits) {
+      digit |= digits[index + 1] << (kBitsPerWord - shift);
+    }
+    writeShort(digit & ((1 << kBitsPerLongDigit) - 1));
+  }
+}
+
+void Marshal::Writer::writeStr(const Str& value, byte flag) {
+  word length = value.length();
+  if (version_ >= 4 && value.isASCII()) {
+    bool interned = Runtime::isInternedStr(thread_, value);
+    if (length <= kMaxByte) {
+      writeByte((interned ? TYPE_SHORT_ASCII_INTERNED : TYPE_SHORT_ASCII) |
+                flag);
+      writeByte(static_cast<byte>(length));
+    } else {
+      writeByte((interned ? TYPE_ASCII_INTERNED : TYPE_ASCII) | flag);
+      writeLong(static_cast<int32_t>(length));
+    }
+  } else {
+    writeByte(TYPE_UNICODE | flag);
+    writeLong(static_cast<int32_t>(length));
+  }
+  // Strings are stored as UTF-8 with surrogates encoded like any other code
+  // point, which is the `surrogatepass` encoding marshal uses.
+  word num_items = buffer_.numItems();
+  runtime_->bytearrayEnsureCapacity(thread_, buffer_, num_items + length);
+  byte* dst = reinterpret_cast<byte*>(
+      MutableBytes::cast(buffer_.items()).address() + num_items);
+  value.copyTo(dst, length);
+  buffer_.setNumItems(num_items + length);
+}
+
+word Marshal::Writer::refsLookup(RawObject key) {
+  word mask = refs_.length() / 2 - 1;
+  for (word i = runtime_->hash(key) & mask;; i = (i + 1) & mask) {
+    RawObject slot_key = refs_.at(i * 2);
+    if (slot_key == key || slot_key.isUnbound()) return i;
+  }
+}
+
+void Marshal::Writer::refsGrow() {
+  HandleScope scope(thread_);
+  MutableTuple old_refs(&scope, *refs_);
+  // The old table has two entries per slot, so this doubles the slots.
+  word num_slots = old_refs.length();
+  refs_ = runtime_->newMutableTuple(num_slots * 2);
+  refs_.fill(Unbound::object());
+  refs_remaining_ = num_slots * 2 / 3;
+  for (word i = 0; i < old_refs.length(); i += 2) {
+    RawObject key = old_refs.at(i);
+    if (key.isUnbound()) continue;
+    word index = refsLookup(key);
+    refs_.atPut(index * 2, key);
+    refs_.atPut(index * 2 + 1, old_refs.at(i + 1));
+    refs_remaining_--;
+  }
+}
+
+// The objects a code object is marshaled with, in the order they are written.
+// `co_firstlineno` is written before the last one.
+static const word kNumCodeFields = 9;
+
+static RawObject codeFieldAt(RawCode code, word index) {
+  switch (index) {
+    case 0:
+      return code.code();
+    case 1:
+      return code.consts();
+    case 2:
+      return code.names();
+    case 3:
+      return code.varnames();
+    case 4:
+      return code.freevars();
+    case 5:
+      return code.cellvars();
+    case 6:
+      return code.filename();
+    case 7:
+      return code.name();
+    case 8:
+      return code.lnotab();
+  }
+  UNREACHABLE("invalid code field index");
+}
+
+static bool isMarshalSingleton(Runtime* runtime, RawObject value) {
+  return value.isNoneType() || value.isBool() || value == runtime->ellipsis() ||
+         value == runtime->typeAt(LayoutId::kStopIteration);
+}
+
+RawObject Marshal::Writer::countRefs(const Object& value, word depth) {
+  if (depth > kMaxDepth) {
+    return thread_->raiseWithFmt(LayoutId::kValueError,
+                                 "object too deeply nested to marshal");
+  }
+  if (isMarshalSingleton(runtime_, *value)) return NoneType::object();
+  word index = refsLookup(*value);
+  if (!refs_.at(index * 2).isUnbound()) {
+    // The contents were counted when the object was seen first; they are
+    // written only once.
+    word count = SmallInt::cast(refs_.at(index * 2 + 1)).value();
+    refs_.atPut(index * 2 + 1, SmallInt::fromWord(count + 1));
+    return NoneType::object();
+  }
+  refs_.atPut(index * 2, *value);
+  refs_.atPut(index * 2 + 1, SmallInt::fromWord(1));
+  if (--refs_remaining_ == 0) {
+    refsGrow();
+  }
+
+  if (value.isInt() || value.isFloat() || value.isComplex() || value.isStr() ||
+      runtime_->isByteslike(*value)) {
+    return NoneType::object();
+  }
+  HandleScope scope(thread_);
+  Object item(&scope, NoneType::object());
+  Object result(&scope, NoneType::object());
+  if (value.isTuple()) {
+    Tuple tuple(&scope, *value);
+    for (word i = 0, length = tuple.length(); i < length; i++) {
+      item = tuple.at(i);
+      result = countRefs(item, depth + 1);
+      if (result.isErrorException()) return *result;
+    }
+    return NoneType::object();
+  }
+  if (value.isList()) {
+    List list(&scope, *value);
+    for (word i = 0; i < list.numItems(); i++) {
+      item = list.at(i);
+      result = countRefs(item, depth + 1);
+      if (result.isErrorException()) return *result;
+    }
+    return NoneType::object();
+  }
+  if (value.isDict()) {
+    Dict dict(&scope, *value);
+    Object dict_value(&scope, NoneType::object());
+    for (word i = 0; dictNextItem(dict, &i, &item, &dict_value);) {
+      result = countRefs(item, depth + 1);
+      if (result.isErrorException()) return *result;
+      result = countRefs(dict_value, depth + 1);
+      if (result.isErrorException()) return *result;
+    }
+    return NoneType::object();
+  }
+  if (value.isSet() || value.isFrozenSet()) {
+    SetBase set(&scope, *value);
+    RawObject raw_item = NoneType::object();
+    for (word i = 0; setNextItem(set, &i, &raw_item);) {
+      item = raw_item;
+      result = countRefs(item, depth + 1);
+      if (result.isErrorException()) return *result;
+    }
+    return NoneType::object();
+  }
+  if (value.isCode()) {
+    Code code(&scope, *value);
+    for (word i = 0; i < kNumCodeFields; i++) {
+      item = codeFieldAt(*code, i);
+      result = countRefs(item, depth + 1);
+      if (result.isErrorException()) return *result;
+    }
+    return NoneType::object();
+  }
+  return thread_->raiseWithFmt(LayoutId::kValueError, "unmarshallable object");
+}
+
+RawObject Marshal::Writer::writeObject(const Object& value) {
+  if (version_ >= 3) {
+    HandleScope scope(thread_);
+    Object result(&scope, countRefs(value, 0));
+    if (result.isErrorException()) return *result;
+  }
+  return doWriteObject(value, 0);
+}
+
+RawObject Marshal::Writer::doWriteObject(const Object& value, word depth) {
+  if (depth > kMaxDepth) {
+    return thread_->raiseWithFmt(LayoutId::kValueError,
+                                 "object too deeply nested to marshal");
+  }
+  if (value.isNoneType()) {
+    writeByte(TYPE_NONE);
+    return NoneType::object();
+  }
+  if (value.isBool()) {
+    writeByte(value == Bool::trueObj() ? TYPE_TRUE : TYPE_FALSE);
+    return NoneType::object();
+  }
+  if (value == runtime_->ellipsis()) {
+    writeByte(TYPE_ELLIPSIS);
+    return NoneType::object();
+  }
+  if (value == runtime_->typeAt(LayoutId::kStopIteration)) {
+    writeByte(TYPE_STOPITER);
+    return NoneType::object();
+  }
+
+  byte flag = 0;
+  if (version_ >= 3) {
+    word index = refsLookup(*value);
+    DCHECK(!refs_.at(index * 2).isUnbound(), "object was not counted");
+    word count = SmallInt::cast(refs_.at(index * 2 + 1)).value();
+    if (count < 0) {
+      writeByte(TYPE_REF);
+      writeLong(static_cast<int32_t>(-1 - count));
+      return NoneType::object();
+    }
+    if (count > 1) {
+      if (num_refs_ >= kMaxInt32) {
+        return thread_->raiseWithFmt(LayoutId::kValueError,
+                                     "too many objects to marshal");
+      }
+      refs_.atPut(index * 2 + 1, SmallInt::fromWord(-1 - num_refs_));
+      num_refs_++;
+      flag = FLAG_REF;
+    }
+  }
+
+  HandleScope scope(thread_);
+  if (value.isInt()) {
+    Int value_int(&scope, *value);
+    writeInt(value_int, flag);
+    return NoneType::object();
+  }
+  if (value.isFloat()) {
+    double value_float = Float::cast(*value).value();
+    if (version_ > 1) {
+      writeByte(TYPE_BINARY_FLOAT | flag);
+      writeBinaryFloat(value_float);
+    } else {
+      writeByte(TYPE_FLOAT | flag);
+      writeFloatStr(value_float);
+    }
+    return NoneType::object();
+  }
+  if (value.isComplex()) {
+    RawComplex value_complex = Complex::cast(*value);
+    double real = value_complex.real();
+    double imag = value_complex.imag();
+    if (version_ > 1) {
+      writeByte(TYPE_BINARY_COMPLEX | flag);
+      writeBinaryFloat(real);
+      writeBinaryFloat(imag);
+    } else {
+      writeByte(TYPE_COMPLEX | flag);
+      writeFloatStr(real);
+      writeFloatStr(imag);
+    }
+    return NoneType::object();
+  }
+  if (value.isStr()) {
+    Str str(&scope, *value);
+    if (str.length() > kMaxInt32) {
+      return thread_->raiseWithFmt(LayoutId::kValueError,
+                                   "unmarshallable object");
+    }
+    writeStr(str, flag);
+    return NoneType::object();
+  }
+  if (runtime_->isByteslike(*value)) {
+    Byteslike bytes(&scope, thread_, *value);
+    word length = bytes.length();
+    if (length > kMaxInt32) {
+      return thread_->raiseWithFmt(LayoutId::kValueError,
+                                   "unmarshallable object");
+    }
+    writeByte(TYPE_STRING | flag);
+    writeLong(static_cast<int32_t>(length));
+    word num_items = buffer_.numItems();
+    runtime_->bytearrayEnsureCapacity(thread_, buffer_, num_items + length);
+    byte* dst = reinterpret_cast<byte*>(
+        MutableBytes::cast(buffer_.items()).address() + num_items);
+    bytes.copyTo(dst, length);
+    buffer_.setNumItems(num_items + length);
+    return NoneType::object();
+  }
+  if (value.isTuple()) {
+    Tuple tuple(&scope, *value);
+    word length = tuple.length();
+    if (version_ >= 4 && length <= kMaxByte) {
+      writeByte(TYPE_SMALL_TUPLE | flag);
+      writeByte(static_cast<byte>(length));
+    } else {
+      writeByte(TYPE_TUPLE | flag);
+      writeLong(static_cast<int32_t>(length));
+    }
+    Object item(&scope, NoneType::object());
+    Object result(&scope, NoneType::object());
+    for (word i = 0; i < length; i++) {
+      item = tuple.at(i);
+      result = doWriteObject(item, depth + 1);
+      if (result.isErrorException()) return *result;
+    }
+    return NoneType::object();
+  }
+  if (value.isList()) {
+    List list(&scope, *value);
+    word length = list.numItems();
+    writeByte(TYPE_LIST | flag);
+    writeLong(static_cast<int32_t>(length));
+    Object item(&scope, NoneType::object());
+    Object result(&scope, NoneType::object());
+    for (word i = 0; i < length; i++) {
+      item = list.at(i);
+      result = doWriteObject(item, depth + 1);
+      if (result.isErrorException()) return *result;
+    }
+    return NoneType::object();
+  }
+  if (value.isDict()) {
+    Dict dict(&scope, *value);
+    writeByte(TYPE_DICT | flag);
+    Object key(&scope, NoneType::object());
+    Object dict_value(&scope, NoneType::object());
+    Object result(&scope, NoneType::object());
+    for (word i = 0; dictNextItem(dict, &i, &key, &dict_value);) {
+      result = doWriteObject(key, depth + 1);
+      if (result.isErrorException()) return *result;
+      result = doWriteObject(dict_value, depth + 1);
+      if (result.isErrorException()) return *result;
+    }
+    writeByte(TYPE_NULL);
+    return NoneType::object();
+  }
+  if (value.isSet() || value.isFrozenSet()) {
+    SetBase set(&scope, *value);
+    writeByte((value.isSet() ? TYPE_SET : TYPE_FROZENSET) | flag);
+    writeLong(static_cast<int32_t>(set.numItems()));
+    Object item(&scope, NoneType::object());
+    Object result(&scope, NoneType::object());
+    RawObject raw_item = NoneType::object();
+    for (word i = 0; setNextItem(set, &i, &raw_item);) {
+      item = raw_item;
+      result = doWriteObject(item, depth + 1);
+      if (result.isErrorException()) return *result;
+    }
+    return NoneType::object();
+  }
+  if (value.isCode()) {
+    Code code(&scope, *value);
+    writeByte(TYPE_CODE | flag);
+    writeLong(code.argcount());
+    writeLong(code.posonlyargcount());
+    writeLong(code.kwonlyargcount());
+    writeLong(code.nlocals());
+    writeLong(code.stacksize());
+    writeLong(code.flags());
+    Object field(&scope, NoneType::object());
+    Object result(&scope, NoneType::object());
+    for (word i = 0; i < kNumCodeFields; i++) {
+      if (i == kNumCodeFields - 1) {
+        writeLong(code.firstlineno());
+      }
+      field = codeFieldAt(*code, i);
+      result = doWriteObject(field, depth + 1);
+      if (result.isErrorException()) return *result;
+    }
+    return NoneType::object();
+  }
+  return thread_->raiseWithFmt(LayoutId::kValueError, "unmarshallable object");
+}
+
 }  // namespace py
@@ -43,6 +43,8 @@ class Marshal {
     const byte* readBytes(int length);
 
     RawObject readTypeString();
+    RawObject readTypeFloat();
+    RawObject readTypeComplex();
     RawObject readTypeAscii();
     RawObject readTypeAsciiInterned();
     RawObject readTypeUnicode();
@@ -50,6 +52,8 @@ class Marshal {
     RawObject readTypeShortAsciiInterned();
     RawObject readTypeSmallTuple();
     RawObject readTypeTuple();
+    RawObject readTypeList();
+    RawObject readTypeDict();
     RawObject readTypeSet();
     RawObject readTypeFrozenSet();
     RawObject readTypeCode();
@@ -62,6 +66,7 @@ class Marshal {
     word addRef(const Object& value);
     void setRef(word index, RawObject value);
 
+    bool readFloatStr(double* result);
     RawObject readStr(word length);
     RawObject readAndInternStr(word length);
     RawObject readLongObject();
@@ -89,6 +94,62 @@ class Marshal {
     DISALLOW_HEAP_ALLOCATION();
   };
 
+  // Serializes objects into the marshal format understood by `Reader` and by
+  // CPython's `marshal` module. Versions below 2 write floats as text,
+  // version 3 adds references to objects that occur more than once and
+  // version 4 adds the compact encodings of ASCII strings and short tuples.
+  class Writer {
+   public:
+    Writer(HandleScope* scope, Thread* thread, word version);
+
+    // Appends the serialization of `value` to the output. Returns None or
+    // raises ValueError if `value` contains an object that cannot be
+    // marshaled.
+    RawObject writeObject(const Object& value);
+
+    // Returns the output as a bytes object.
+    RawObject result();
+
+    void writeBinaryFloat(double value);
+    void writeByte(byte value);
+    void writeBytes(View<byte> data);
+    void writeLong(int32_t value);
+    void writeShort(int16_t value);
+
+    // CPython refuses to marshal objects nested deeper than this.
+    static const word kMaxDepth = 2000;
+
+   private:
+    RawObject countRefs(const Object& value, word depth);
+    RawObject doWriteObject(const Object& value, word depth);
+
+    word refsLookup(RawObject key);
+    void refsGrow();
+
+    void writeFloatStr(double value);
+    void writeInt(const Int& value, byte flag);
+    void writeStr(const Str& value, byte flag);
+
+    Thread* thread_;
+    Runtime* runtime_;
+    Bytearray buffer_;
+    // Version 3 and up write `FLAG_REF` with every object that occurs more
+    // than once and a reference for every later occurrence. `countRefs()`
+    // fills this open addressing table of key and value pairs, which maps
+    // objects by identity to the number of times they occur. Once an object
+    // is written, its count is replaced by `-1 - ref_index`.
+    MutableTuple refs_;
+    word refs_remaining_;
+    word num_refs_ = 0;
+    word version_;
+
+    static const word kInitialRefsCapacity = 16;
+    static const int kBitsPerLongDigit = 15;
+
+    DISALLOW_COPY_AND_ASSIGN(Writer);
+    DISALLOW_HEAP_ALLOCATION();
+  };
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(Marshal);
 };
 
@@ -242,6 +242,8 @@ static const BuiltinAttribute kModuleAttributes[] = {
     {ID(_module__state), RawModule::kStateOffset, AttributeFlags::kHidden},
     {ID(_module__proxy), RawModule::kModuleProxyOffset,
      AttributeFlags::kHidden},
+    {ID(_module__api_handle), RawModule::kApiHandleOffset,
+     AttributeFlags::kHidden},
 };
 
 void initializeModuleType(Thread* thread) {
@@ -17,6 +17,7 @@
 #include <limits>
 
 #include "globals.h"
+#include "space.h"
 #include "utils.h"
 #include "view.h"
 
@@ -55,6 +56,7 @@ class Thread;
   V(Tuple)
 
 #define INSTANCE_CLASS_NAMES(V)                                                \
+  V(Accumulate)                                                                \
   V(Array)                                                                     \
   V(AsyncGenerator)                                                            \
   V(AsyncGeneratorAclose)                                                      \
@@ -71,12 +73,14 @@ class Thread;
   V(BytesIO)                                                                   \
   V(BytesIterator)                                                             \
   V(Cell)                                                                      \
+  V(Chain)                                                                     \
   V(ClassMethod)                                                               \
   V(Code)                                                                      \
   V(Context)                                                                   \
   V(ContextVar)                                                                \
   V(Coroutine)                                                                 \
   V(CoroutineWrapper)                                                          \
+  V(Count)                                                                     \
   V(Deque)                                                                     \
   V(DequeIterator)                                                             \
   V(DequeReverseIterator)                                                      \
@@ -95,13 +99,17 @@ class Thread;
   V(Function)                                                                  \
   V(Generator)                                                                 \
   V(GeneratorFrame)                                                            \
+  V(Groupby)                                                                   \
+  V(Grouper)                                                                   \
   V(IncrementalNewlineDecoder)                                                 \
   V(InstanceMethod)                                                            \
   V(InstanceProxy)                                                             \
+  V(Islice)                                                                    \
   V(Layout)                                                                    \
   V(List)                                                                      \
   V(ListIterator)                                                              \
   V(LongRangeIterator)                                                         \
+  V(LruCacheWrapper)                                                           \
   V(MappingProxy)                                                              \
   V(MemoryView)                                                                \
   V(Mmap)                                                                      \
@@ -109,9 +117,11 @@ class Thread;
   V(ModuleProxy)                                                               \
   V(Object)                                                                    \
   V(Pointer)                                                                   \
+  V(Product)                                                                   \
   V(Property)                                                                  \
   V(Range)                                                                     \
   V(RangeIterator)                                                             \
+  V(Repeat)                                                                    \
   V(SeqIterator)                                                               \
   V(Set)                                                                       \
   V(SetIterator)                                                               \
@@ -122,6 +132,8 @@ class Thread;
   V(StrIterator)                                                               \
   V(StringIO)                                                                  \
   V(Super)                                                                     \
+  V(Tee)                                                                       \
+  V(TeeDataObject)                                                             \
   V(TextIOWrapper)                                                             \
   V(Token)                                                                     \
   V(Traceback)                                                                 \
@@ -137,7 +149,8 @@ class Thread;
   V(WeakCallableProxy)                                                         \
   V(WeakProxy)                                                                 \
   V(WeakLink)                                                                  \
-  V(WeakRef)
+  V(WeakRef)                                                                   \
+  V(ZipLongest)
 
 // Heap-allocated Python types in the BaseException hierarchy.
 #define EXCEPTION_CLASS_NAMES(V)                                               \
@@ -317,6 +330,7 @@ class RawObject {
   bool isUnbound() const;
 
   // Heap objects
+  bool isAccumulate() const;
   bool isArray() const;
   bool isAsyncGenerator() const;
   bool isAsyncGeneratorAclose() const;
@@ -335,6 +349,7 @@ class RawObject {
   bool isBytesIO() const;
   bool isBytesIterator() const;
   bool isCell() const;
+  bool isChain() const;
   bool isClassMethod() const;
   bool isCode() const;
   bool isComplex() const;
@@ -342,6 +357,7 @@ class RawObject {
   bool isContextVar() const;
   bool isCoroutine() const;
   bool isCoroutineWrapper() const;
+  bool isCount() const;
   bool isDataArray() const;
   bool isDeque() const;
   bool isDequeIterator() const;
@@ -364,6 +380,8 @@ class RawObject {
   bool isFunction() const;
   bool isGenerator() const;
   bool isGeneratorFrame() const;
+  bool isGroupby() const;
+  bool isGrouper() const;
   bool isHeapObject() const;
   bool isHeapObjectWithLayout(LayoutId layout_id) const;
   bool isImportError() const;
@@ -372,6 +390,7 @@ class RawObject {
   bool isInstance() const;
   bool isInstanceMethod() const;
   bool isInstanceProxy() const;
+  bool isIslice() const;
   bool isKeyError() const;
   bool isLargeBytes() const;
   bool isLargeInt() const;
@@ -380,6 +399,7 @@ class RawObject {
   bool isList() const;
   bool isListIterator() const;
   bool isLongRangeIterator() const;
+  bool isLruCacheWrapper() const;
   bool isLookupError() const;
   bool isMappingProxy() const;
   bool isMemoryView() const;
@@ -391,9 +411,11 @@ class RawObject {
   bool isMutableTuple() const;
   bool isNotImplementedError() const;
   bool isPointer() const;
+  bool isProduct() const;
   bool isProperty() const;
   bool isRange() const;
   bool isRangeIterator() const;
+  bool isRepeat() const;
   bool isRuntimeError() const;
   bool isSeqIterator() const;
   bool isSet() const;
@@ -408,6 +430,8 @@ class RawObject {
   bool isSuper() const;
   bool isSyntaxError() const;
   bool isSystemExit() const;
+  bool isTee() const;
+  bool isTeeDataObject() const;
   bool isTextIOWrapper() const;
   bool isToken() const;
   bool isTraceback() const;
@@ -429,6 +453,7 @@ class RawObject {
   bool isWeakProxy() const;
   bool isWeakLink() const;
   bool isWeakRef() const;
+  bool isZipLongest() const;
 
   // superclass objects
   bool isBytes() const;
@@ -1364,6 +1389,11 @@ class RawType : public RawAttributeDict {
   RawObject qualname() const;
   void setQualname(RawObject qualname) const;
 
+  // The C-API handle of this type as a `SmallInt` made by `fromAlignedCPtr()`
+  // or None. Only used for instances of exactly `type`; see `ApiHandle`.
+  RawObject apiHandle() const;
+  void setApiHandle(RawObject handle) const;
+
   bool isBaseExceptionSubclass() const;
 
   // Check if the type dictionary is mutable. If the current type's dict is
@@ -1385,7 +1415,8 @@ class RawType : public RawAttributeDict {
   static const int kProxyOffset = kSubclassesOffset + kPointerSize;
   static const int kCtorOffset = kProxyOffset + kPointerSize;
   static const int kQualnameOffset = kCtorOffset + kPointerSize;
-  static const int kSize = kQualnameOffset + kPointerSize;
+  static const int kApiHandleOffset = kQualnameOffset + kPointerSize;
+  static const int kSize = kApiHandleOffset + kPointerSize;
 
   static const int kBuiltinBaseMask = 0xff;
 
@@ -2504,6 +2535,11 @@ class RawFunction : public RawInstance {
   void* intrinsic() const;
   void setIntrinsic(void* fp) const;
 
+  // Number of calls and loop iterations left until the assembly interpreter
+  // considers the function for JIT compilation.
+  word jitCountdown() const;
+  void setJitCountdown(word countdown) const;
+
   // A dict containing defaults for keyword-only parameters
   RawObject kwDefaults() const;
   void setKwDefaults(RawObject kw_defaults) const;
@@ -2579,7 +2615,8 @@ class RawFunction : public RawInstance {
   static const int kCachesOffset = kRewrittenBytecodeOffset + kPointerSize;
   static const int kDictOffset = kCachesOffset + kPointerSize;
   static const int kIntrinsicOffset = kDictOffset + kPointerSize;
-  static const int kSize = kIntrinsicOffset + kPointerSize;
+  static const int kJitCountdownOffset = kIntrinsicOffset + kPointerSize;
+  static const int kSize = kJitCountdownOffset + kPointerSize;
 
   RAW_OBJECT_COMMON(Function);
 };
@@ -2679,6 +2716,11 @@ class RawModule : public RawAttributeDict {
   RawObject moduleProxy() const;
   void setModuleProxy(RawObject module_proxy) const;
 
+  // The C-API handle of this module as a `SmallInt` made by
+  // `fromAlignedCPtr()` or None. Only used for instances of exactly `module`.
+  RawObject apiHandle() const;
+  void setApiHandle(RawObject handle) const;
+
   // Unique ID allocated at module creation time.
   word id() const;
   void setId(word id) const;
@@ -2688,7 +2730,8 @@ class RawModule : public RawAttributeDict {
   static const int kDefOffset = kNameOffset + kPointerSize;
   static const int kStateOffset = kDefOffset + kPointerSize;
   static const int kModuleProxyOffset = kStateOffset + kPointerSize;
-  static const int kSize = kModuleProxyOffset + kPointerSize;
+  static const int kApiHandleOffset = kModuleProxyOffset + kPointerSize;
+  static const int kSize = kApiHandleOffset + kPointerSize;
 
   // Constants.
   static const word kMaxModuleId = RawHeader::kHashCodeMask;
@@ -2840,6 +2883,336 @@ class RawDeque : public RawInstance {
   RAW_OBJECT_COMMON(Deque);
 };
 
+// The callable returned by functools.lru_cache().
+//
+// RawLayout:
+//   [Wrapped      ] - the user function
+//   [Cache        ] - dict of keys to results, or to links when bounded
+//   [Root         ] - sentinel link of the LRU list or None
+//   [Maxsize      ] - maximum number of cached results or None
+//   [Typed        ] - whether argument types are part of the key
+//   [CacheInfoType] - the namedtuple type returned by cache_info()
+//   [Hits         ] - number of calls answered from the cache
+//   [Misses       ] - number of calls forwarded to the user function
+//
+// A bounded cache keeps its entries in a circular doubly linked list ordered
+// from least to most recently used. Each link is a MutableTuple of length
+// kLinkSize and the cache maps every key directly to its link, so a hit is a
+// single dict lookup followed by a few pointer updates.
+class RawLruCacheWrapper : public RawInstance {
+ public:
+  // Getters and setters
+  RawObject wrapped() const;
+  void setWrapped(RawObject wrapped) const;
+
+  RawObject cache() const;
+  void setCache(RawObject cache) const;
+
+  RawObject root() const;
+  void setRoot(RawObject root) const;
+
+  RawObject maxsize() const;
+  void setMaxsize(RawObject maxsize) const;
+
+  bool typed() const;
+  void setTyped(bool typed) const;
+
+  RawObject cacheInfoType() const;
+  void setCacheInfoType(RawObject cache_info_type) const;
+
+  word hits() const;
+  void setHits(word hits) const;
+
+  word misses() const;
+  void setMisses(word misses) const;
+
+  // Layout of a link in the LRU list
+  static const word kLinkPrevIndex = 0;
+  static const word kLinkNextIndex = 1;
+  static const word kLinkHashIndex = 2;
+  static const word kLinkKeyIndex = 3;
+  static const word kLinkResultIndex = 4;
+  static const word kLinkSize = 5;
+
+  // Layout
+  static const int kWrappedOffset = RawHeapObject::kSize;
+  static const int kCacheOffset = kWrappedOffset + kPointerSize;
+  static const int kRootOffset = kCacheOffset + kPointerSize;
+  static const int kMaxsizeOffset = kRootOffset + kPointerSize;
+  static const int kTypedOffset = kMaxsizeOffset + kPointerSize;
+  static const int kCacheInfoTypeOffset = kTypedOffset + kPointerSize;
+  static const int kHitsOffset = kCacheInfoTypeOffset + kPointerSize;
+  static const int kMissesOffset = kHitsOffset + kPointerSize;
+  static const int kSize = kMissesOffset + kPointerSize;
+
+  RAW_OBJECT_COMMON_NO_CAST(LruCacheWrapper);
+};
+
+// An iterator that returns the running results of a binary function.
+class RawAccumulate : public RawInstance {
+ public:
+  // Getters and setters
+  RawObject iterator() const;
+  void setIterator(RawObject iterator) const;
+
+  RawObject func() const;
+  void setFunc(RawObject func) const;
+
+  RawObject total() const;
+  void setTotal(RawObject total) const;
+
+  RawObject initial() const;
+  void setInitial(RawObject initial) const;
+
+  // Layout
+  static const int kIteratorOffset = RawHeapObject::kSize;
+  static const int kFuncOffset = kIteratorOffset + kPointerSize;
+  static const int kTotalOffset = kFuncOffset + kPointerSize;
+  static const int kInitialOffset = kTotalOffset + kPointerSize;
+  static const int kSize = kInitialOffset + kPointerSize;
+
+  RAW_OBJECT_COMMON_NO_CAST(Accumulate);
+};
+
+// An iterator over the items of a sequence of iterables, one after another.
+class RawChain : public RawInstance {
+ public:
+  // Getters and setters
+  RawObject source() const;
+  void setSource(RawObject source) const;
+
+  RawObject active() const;
+  void setActive(RawObject active) const;
+
+  // Layout
+  static const int kSourceOffset = RawHeapObject::kSize;
+  static const int kActiveOffset = kSourceOffset + kPointerSize;
+  static const int kSize = kActiveOffset + kPointerSize;
+
+  RAW_OBJECT_COMMON_NO_CAST(Chain);
+};
+
+// An iterator that returns evenly spaced numbers without end.
+class RawCount : public RawInstance {
+ public:
+  // Getters and setters
+  RawObject count() const;
+  void setCount(RawObject count) const;
+
+  RawObject step() const;
+  void setStep(RawObject step) const;
+
+  // Layout
+  static const int kCountOffset = RawHeapObject::kSize;
+  static const int kStepOffset = kCountOffset + kPointerSize;
+  static const int kSize = kStepOffset + kPointerSize;
+
+  RAW_OBJECT_COMMON_NO_CAST(Count);
+};
+
+// An iterator that returns consecutive keys and groups of an iterable.
+class RawGroupby : public RawInstance {
+ public:
+  // Getters and setters
+  RawObject iterator() const;
+  void setIterator(RawObject iterator) const;
+
+  RawObject keyFunc() const;
+  void setKeyFunc(RawObject key_func) const;
+
+  RawObject targetKey() const;
+  void setTargetKey(RawObject target_key) const;
+
+  RawObject currentKey() const;
+  void setCurrentKey(RawObject current_key) const;
+
+  RawObject currentValue() const;
+  void setCurrentValue(RawObject current_value) const;
+
+  RawObject currentGrouper() const;
+  void setCurrentGrouper(RawObject current_grouper) const;
+
+  // Layout
+  static const int kIteratorOffset = RawHeapObject::kSize;
+  static const int kKeyFuncOffset = kIteratorOffset + kPointerSize;
+  static const int kTargetKeyOffset = kKeyFuncOffset + kPointerSize;
+  static const int kCurrentKeyOffset = kTargetKeyOffset + kPointerSize;
+  static const int kCurrentValueOffset = kCurrentKeyOffset + kPointerSize;
+  static const int kCurrentGrouperOffset = kCurrentValueOffset + kPointerSize;
+  static const int kSize = kCurrentGrouperOffset + kPointerSize;
+
+  RAW_OBJECT_COMMON_NO_CAST(Groupby);
+};
+
+// An iterator over one group produced by a groupby iterator.
+class RawGrouper : public RawInstance {
+ public:
+  // Getters and setters
+  RawObject parent() const;
+  void setParent(RawObject parent) const;
+
+  RawObject targetKey() const;
+  void setTargetKey(RawObject target_key) const;
+
+  // Layout
+  static const int kParentOffset = RawHeapObject::kSize;
+  static const int kTargetKeyOffset = kParentOffset + kPointerSize;
+  static const int kSize = kTargetKeyOffset + kPointerSize;
+
+  RAW_OBJECT_COMMON(Grouper);
+};
+
+// An iterator over a slice of another iterator.
+class RawIslice : public RawInstance {
+ public:
+  // Getters and setters
+  RawObject iterator() const;
+  void setIterator(RawObject iterator) const;
+
+  word next() const;
+  void setNext(word next) const;
+
+  word stop() const;
+  void setStop(word stop) const;
+
+  word step() const;
+  void setStep(word step) const;
+
+  word count() const;
+  void setCount(word count) const;
+
+  // Stop index of an islice without an upper bound
+  static const word kNoStop = -1;
+
+  // Layout
+  static const int kIteratorOffset = RawHeapObject::kSize;
+  static const int kNextOffset = kIteratorOffset + kPointerSize;
+  static const int kStopOffset = kNextOffset + kPointerSize;
+  static const int kStepOffset = kStopOffset + kPointerSize;
+  static const int kCountOffset = kStepOffset + kPointerSize;
+  static const int kSize = kCountOffset + kPointerSize;
+
+  RAW_OBJECT_COMMON_NO_CAST(Islice);
+};
+
+// An iterator over the cartesian product of a sequence of pools.
+class RawProduct : public RawInstance {
+ public:
+  // Getters and setters
+  RawObject pools() const;
+  void setPools(RawObject pools) const;
+
+  RawObject indices() const;
+  void setIndices(RawObject indices) const;
+
+  RawObject result() const;
+  void setResult(RawObject result) const;
+
+  bool stopped() const;
+  void setStopped(bool stopped) const;
+
+  // Layout
+  static const int kPoolsOffset = RawHeapObject::kSize;
+  static const int kIndicesOffset = kPoolsOffset + kPointerSize;
+  static const int kResultOffset = kIndicesOffset + kPointerSize;
+  static const int kStoppedOffset = kResultOffset + kPointerSize;
+  static const int kSize = kStoppedOffset + kPointerSize;
+
+  RAW_OBJECT_COMMON_NO_CAST(Product);
+};
+
+// An iterator that returns the same object over and over again.
+class RawRepeat : public RawInstance {
+ public:
+  // Getters and setters
+  RawObject element() const;
+  void setElement(RawObject element) const;
+
+  RawObject times() const;
+  void setTimes(RawObject times) const;
+
+  // Layout
+  static const int kElementOffset = RawHeapObject::kSize;
+  static const int kTimesOffset = kElementOffset + kPointerSize;
+  static const int kSize = kTimesOffset + kPointerSize;
+
+  RAW_OBJECT_COMMON_NO_CAST(Repeat);
+};
+
+// One of several independent iterators sharing a chain of TeeDataObjects.
+class RawTee : public RawInstance {
+ public:
+  // Getters and setters
+  RawObject data() const;
+  void setData(RawObject data) const;
+
+  word index() const;
+  void setIndex(word index) const;
+
+  // Layout
+  static const int kDataOffset = RawHeapObject::kSize;
+  static const int kIndexOffset = kDataOffset + kPointerSize;
+  static const int kSize = kIndexOffset + kPointerSize;
+
+  RAW_OBJECT_COMMON(Tee);
+};
+
+// A link in the buffer shared by tee iterators.
+class RawTeeDataObject : public RawInstance {
+ public:
+  // Getters and setters
+  RawObject iterator() const;
+  void setIterator(RawObject iterator) const;
+
+  RawObject values() const;
+  void setValues(RawObject values) const;
+
+  word numRead() const;
+  void setNumRead(word num_read) const;
+
+  RawObject next() const;
+  void setNext(RawObject next) const;
+
+  bool running() const;
+  void setRunning(bool running) const;
+
+  // Number of values buffered in one link
+  static const word kMaxValues = 57;
+
+  // Layout
+  static const int kIteratorOffset = RawHeapObject::kSize;
+  static const int kValuesOffset = kIteratorOffset + kPointerSize;
+  static const int kNumReadOffset = kValuesOffset + kPointerSize;
+  static const int kNextOffset = kNumReadOffset + kPointerSize;
+  static const int kRunningOffset = kNextOffset + kPointerSize;
+  static const int kSize = kRunningOffset + kPointerSize;
+
+  RAW_OBJECT_COMMON(TeeDataObject);
+};
+
+// An iterator that aggregates items of several iterators until all of
+// them are exhausted.
+class RawZipLongest : public RawInstance {
+ public:
+  // Getters and setters
+  RawObject iterators() const;
+  void setIterators(RawObject iterators) const;
+
+  word numActive() const;
+  void setNumActive(word num_active) const;
+
+  RawObject fillValue() const;
+  void setFillValue(RawObject fill_value) const;
+
+  // Layout
+  static const int kIteratorsOffset = RawHeapObject::kSize;
+  static const int kNumActiveOffset = kIteratorsOffset + kPointerSize;
+  static const int kFillValueOffset = kNumActiveOffset + kPointerSize;
+  static const int kSize = kFillValueOffset + kPointerSize;
+
+  RAW_OBJECT_COMMON_NO_CAST(ZipLongest);
+};
+
 // A simple dict that uses open addressing and linear probing.
 //
 // RawLayout:
@@ -2849,6 +3222,7 @@ class RawDeque : public RawInstance {
 //   [Data    ] - RawTuple that stores the underlying data.
 //   [Indices ] - RawTuple storing indices into the data tuple.
 //   [FirstEmptyItemIndex] - Index pointing to the first empty item in data.
+//   [FirstLiveItemIndex] - No item before this index in data is live.
 //
 class RawDict : public RawInstance {
  public:
@@ -2869,6 +3243,11 @@ class RawDict : public RawInstance {
   word firstEmptyItemIndex() const;
   void setFirstEmptyItemIndex(word first_empty_item_index) const;
 
+  // Index at or before the first live item in data. Items before it are all
+  // tombstones, so scans from the front of the dict can start here.
+  word firstLiveItemIndex() const;
+  void setFirstLiveItemIndex(word first_live_item_index) const;
+
   // Number of indices.
   word numIndices() const;
 
@@ -2877,7 +3256,9 @@ class RawDict : public RawInstance {
   static const int kDataOffset = kNumItemsOffset + kPointerSize;
   static const int kIndicesOffset = kDataOffset + kPointerSize;
   static const int kFirstEmptyItemIndexOffset = kIndicesOffset + kPointerSize;
-  static const int kSize = kFirstEmptyItemIndexOffset + kPointerSize;
+  static const int kFirstLiveItemIndexOffset =
+      kFirstEmptyItemIndexOffset + kPointerSize;
+  static const int kSize = kFirstLiveItemIndexOffset + kPointerSize;
 
   RAW_OBJECT_COMMON(Dict);
 };
@@ -4096,6 +4477,10 @@ inline bool RawObject::isInstance() const {
                             LayoutId::kLastNonInstance);
 }
 
+inline bool RawObject::isAccumulate() const {
+  return isHeapObjectWithLayout(LayoutId::kAccumulate);
+}
+
 inline bool RawObject::isArray() const {
   return isHeapObjectWithLayout(LayoutId::kArray);
 }
@@ -4149,6 +4534,42 @@ inline bool RawObject::isBufferedWriter() const {
   return isHeapObjectWithLayout(LayoutId::kBufferedWriter);
 }
 
+inline bool RawObject::isChain() const {
+  return isHeapObjectWithLayout(LayoutId::kChain);
+}
+
+inline bool RawObject::isCount() const {
+  return isHeapObjectWithLayout(LayoutId::kCount);
+}
+
+inline bool RawObject::isGroupby() const {
+  return isHeapObjectWithLayout(LayoutId::kGroupby);
+}
+
+inline bool RawObject::isGrouper() const {
+  return isHeapObjectWithLayout(LayoutId::kGrouper);
+}
+
+inline bool RawObject::isIslice() const {
+  return isHeapObjectWithLayout(LayoutId::kIslice);
+}
+
+inline bool RawObject::isProduct() const {
+  return isHeapObjectWithLayout(LayoutId::kProduct);
+}
+
+inline bool RawObject::isRepeat() const {
+  return isHeapObjectWithLayout(LayoutId::kRepeat);
+}
+
+inline bool RawObject::isTee() const {
+  return isHeapObjectWithLayout(LayoutId::kTee);
+}
+
+inline bool RawObject::isTeeDataObject() const {
+  return isHeapObjectWithLayout(LayoutId::kTeeDataObject);
+}
+
 inline bool RawObject::isUnderBufferedIOBase() const {
   return isHeapObjectWithLayout(LayoutId::kUnderBufferedIOBase);
 }
@@ -4349,6 +4770,10 @@ inline bool RawObject::isLongRangeIterator() const {
   return isHeapObjectWithLayout(LayoutId::kLongRangeIterator);
 }
 
+inline bool RawObject::isLruCacheWrapper() const {
+  return isHeapObjectWithLayout(LayoutId::kLruCacheWrapper);
+}
+
 inline bool RawObject::isLookupError() const {
   return isHeapObjectWithLayout(LayoutId::kLookupError);
 }
@@ -4536,6 +4961,10 @@ inline bool RawObject::isWeakRef() const {
          isHeapObjectWithLayout(LayoutId::kWeakLink);
 }
 
+inline bool RawObject::isZipLongest() const {
+  return isHeapObjectWithLayout(LayoutId::kZipLongest);
+}
+
 inline bool RawObject::isBytes() const {
   return isSmallBytes() || isLargeBytes();
 }
@@ -5179,7 +5608,9 @@ inline RawObject RawInstance::instanceVariableAt(word offset) const {
 inline void RawInstance::instanceVariableAtPut(word offset,
                                                RawObject value) const {
   DCHECK_INDEX(offset, headerCountOrOverflow() * kPointerSize);
-  *reinterpret_cast<RawObject*>(address() + offset) = value;
+  uword slot = address() + offset;
+  *reinterpret_cast<RawObject*>(slot) = value;
+  Space::markCard(slot);
 }
 
 inline void RawInstance::setLayoutId(LayoutId layout_id) const {
@@ -5448,6 +5879,14 @@ inline void RawType::setQualname(RawObject qualname) const {
   instanceVariableAtPut(kQualnameOffset, qualname);
 }
 
+inline RawObject RawType::apiHandle() const {
+  return instanceVariableAt(kApiHandleOffset);
+}
+
+inline void RawType::setApiHandle(RawObject handle) const {
+  instanceVariableAtPut(kApiHandleOffset, handle);
+}
+
 inline bool RawType::isBuiltin() const {
   return instanceLayoutId() <= LayoutId::kLastBuiltinId;
 }
@@ -5654,7 +6093,9 @@ inline RawObject RawTuple::at(word index) const {
 
 inline void RawTuple::atPut(word index, RawObject value) const {
   DCHECK_INDEX(index, length());
-  *reinterpret_cast<RawObject*>(address() + (index * kPointerSize)) = value;
+  uword slot = address() + index * kPointerSize;
+  *reinterpret_cast<RawObject*>(slot) = value;
+  Space::markCard(slot);
 }
 
 // RawUserTupleBase
@@ -6453,6 +6894,391 @@ inline void RawDeque::setState(word state) const {
   instanceVariableAtPut(kStateOffset, RawSmallInt::fromWord(state));
 }
 
+// RawLruCacheWrapper
+
+inline RawObject RawLruCacheWrapper::wrapped() const {
+  return instanceVariableAt(kWrappedOffset);
+}
+
+inline void RawLruCacheWrapper::setWrapped(RawObject wrapped) const {
+  instanceVariableAtPut(kWrappedOffset, wrapped);
+}
+
+inline RawObject RawLruCacheWrapper::cache() const {
+  return instanceVariableAt(kCacheOffset);
+}
+
+inline void RawLruCacheWrapper::setCache(RawObject cache) const {
+  instanceVariableAtPut(kCacheOffset, cache);
+}
+
+inline RawObject RawLruCacheWrapper::root() const {
+  return instanceVariableAt(kRootOffset);
+}
+
+inline void RawLruCacheWrapper::setRoot(RawObject root) const {
+  instanceVariableAtPut(kRootOffset, root);
+}
+
+inline RawObject RawLruCacheWrapper::maxsize() const {
+  return instanceVariableAt(kMaxsizeOffset);
+}
+
+inline void RawLruCacheWrapper::setMaxsize(RawObject maxsize) const {
+  instanceVariableAtPut(kMaxsizeOffset, maxsize);
+}
+
+inline bool RawLruCacheWrapper::typed() const {
+  return RawBool::cast(instanceVariableAt(kTypedOffset)).value();
+}
+
+inline void RawLruCacheWrapper::setTyped(bool typed) const {
+  instanceVariableAtPut(kTypedOffset, RawBool::fromBool(typed));
+}
+
+inline RawObject RawLruCacheWrapper::cacheInfoType() const {
+  return instanceVariableAt(kCacheInfoTypeOffset);
+}
+
+inline void RawLruCacheWrapper::setCacheInfoType(
+    RawObject cache_info_type) const {
+  instanceVariableAtPut(kCacheInfoTypeOffset, cache_info_type);
+}
+
+inline word RawLruCacheWrapper::hits() const {
+  return RawSmallInt::cast(instanceVariableAt(kHitsOffset)).value();
+}
+
+inline void RawLruCacheWrapper::setHits(word hits) const {
+  instanceVariableAtPut(kHitsOffset, RawSmallInt::fromWord(hits));
+}
+
+inline word RawLruCacheWrapper::misses() const {
+  return RawSmallInt::cast(instanceVariableAt(kMissesOffset)).value();
+}
+
+inline void RawLruCacheWrapper::setMisses(word misses) const {
+  instanceVariableAtPut(kMissesOffset, RawSmallInt::fromWord(misses));
+}
+
+// RawAccumulate
+
+inline RawObject RawAccumulate::iterator() const {
+  return instanceVariableAt(kIteratorOffset);
+}
+
+inline void RawAccumulate::setIterator(RawObject iterator) const {
+  instanceVariableAtPut(kIteratorOffset, iterator);
+}
+
+inline RawObject RawAccumulate::func() const {
+  return instanceVariableAt(kFuncOffset);
+}
+
+inline void RawAccumulate::setFunc(RawObject func) const {
+  instanceVariableAtPut(kFuncOffset, func);
+}
+
+inline RawObject RawAccumulate::total() const {
+  return instanceVariableAt(kTotalOffset);
+}
+
+inline void RawAccumulate::setTotal(RawObject total) const {
+  instanceVariableAtPut(kTotalOffset, total);
+}
+
+inline RawObject RawAccumulate::initial() const {
+  return instanceVariableAt(kInitialOffset);
+}
+
+inline void RawAccumulate::setInitial(RawObject initial) const {
+  instanceVariableAtPut(kInitialOffset, initial);
+}
+
+// RawChain
+
+inline RawObject RawChain::source() const {
+  return instanceVariableAt(kSourceOffset);
+}
+
+inline void RawChain::setSource(RawObject source) const {
+  instanceVariableAtPut(kSourceOffset, source);
+}
+
+inline RawObject RawChain::active() const {
+  return instanceVariableAt(kActiveOffset);
+}
+
+inline void RawChain::setActive(RawObject active) const {
+  instanceVariableAtPut(kActiveOffset, active);
+}
+
+// RawCount
+
+inline RawObject RawCount::count() const {
+  return instanceVariableAt(kCountOffset);
+}
+
+inline void RawCount::setCount(RawObject count) const {
+  instanceVariableAtPut(kCountOffset, count);
+}
+
+inline RawObject RawCount::step() const {
+  return instanceVariableAt(kStepOffset);
+}
+
+inline void RawCount::setStep(RawObject step) const {
+  instanceVariableAtPut(kStepOffset, step);
+}
+
+// RawGroupby
+
+inline RawObject RawGroupby::iterator() const {
+  return instanceVariableAt(kIteratorOffset);
+}
+
+inline void RawGroupby::setIterator(RawObject iterator) const {
+  instanceVariableAtPut(kIteratorOffset, iterator);
+}
+
+inline RawObject RawGroupby::keyFunc() const {
+  return instanceVariableAt(kKeyFuncOffset);
+}
+
+inline void RawGroupby::setKeyFunc(RawObject key_func) const {
+  instanceVariableAtPut(kKeyFuncOffset, key_func);
+}
+
+inline RawObject RawGroupby::targetKey() const {
+  return instanceVariableAt(kTargetKeyOffset);
+}
+
+inline void RawGroupby::setTargetKey(RawObject target_key) const {
+  instanceVariableAtPut(kTargetKeyOffset, target_key);
+}
+
+inline RawObject RawGroupby::currentKey() const {
+  return instanceVariableAt(kCurrentKeyOffset);
+}
+
+inline void RawGroupby::setCurrentKey(RawObject current_key) const {
+  instanceVariableAtPut(kCurrentKeyOffset, current_key);
+}
+
+inline RawObject RawGroupby::currentValue() const {
+  return instanceVariableAt(kCurrentValueOffset);
+}
+
+inline void RawGroupby::setCurrentValue(RawObject current_value) const {
+  instanceVariableAtPut(kCurrentValueOffset, current_value);
+}
+
+inline RawObject RawGroupby::currentGrouper() const {
+  return instanceVariableAt(kCurrentGrouperOffset);
+}
+
+inline void RawGroupby::setCurrentGrouper(RawObject current_grouper) const {
+  instanceVariableAtPut(kCurrentGrouperOffset, current_grouper);
+}
+
+// RawGrouper
+
+inline RawObject RawGrouper::parent() const {
+  return instanceVariableAt(kParentOffset);
+}
+
+inline void RawGrouper::setParent(RawObject parent) const {
+  instanceVariableAtPut(kParentOffset, parent);
+}
+
+inline RawObject RawGrouper::targetKey() const {
+  return instanceVariableAt(kTargetKeyOffset);
+}
+
+inline void RawGrouper::setTargetKey(RawObject target_key) const {
+  instanceVariableAtPut(kTargetKeyOffset, target_key);
+}
+
+// RawIslice
+
+inline RawObject RawIslice::iterator() const {
+  return instanceVariableAt(kIteratorOffset);
+}
+
+inline void RawIslice::setIterator(RawObject iterator) const {
+  instanceVariableAtPut(kIteratorOffset, iterator);
+}
+
+inline word RawIslice::next() const {
+  return RawSmallInt::cast(instanceVariableAt(kNextOffset)).value();
+}
+
+inline void RawIslice::setNext(word next) const {
+  instanceVariableAtPut(kNextOffset, RawSmallInt::fromWord(next));
+}
+
+inline word RawIslice::stop() const {
+  return RawSmallInt::cast(instanceVariableAt(kStopOffset)).value();
+}
+
+inline void RawIslice::setStop(word stop) const {
+  instanceVariableAtPut(kStopOffset, RawSmallInt::fromWord(stop));
+}
+
+inline word RawIslice::step() const {
+  return RawSmallInt::cast(instanceVariableAt(kStepOffset)).value();
+}
+
+inline void RawIslice::setStep(word step) const {
+  instanceVariableAtPut(kStepOffset, RawSmallInt::fromWord(step));
+}
+
+inline word RawIslice::count() const {
+  return RawSmallInt::cast(instanceVariableAt(kCountOffset)).value();
+}
+
+inline void RawIslice::setCount(word count) const {
+  instanceVariableAtPut(kCountOffset, RawSmallInt::fromWord(count));
+}
+
+// RawProduct
+
+inline RawObject RawProduct::pools() const {
+  return instanceVariableAt(kPoolsOffset);
+}
+
+inline void RawProduct::setPools(RawObject pools) const {
+  instanceVariableAtPut(kPoolsOffset, pools);
+}
+
+inline RawObject RawProduct::indices() const {
+  return instanceVariableAt(kIndicesOffset);
+}
+
+inline void RawProduct::setIndices(RawObject indices) const {
+  instanceVariableAtPut(kIndicesOffset, indices);
+}
+
+inline RawObject RawProduct::result() const {
+  return instanceVariableAt(kResultOffset);
+}
+
+inline void RawProduct::setResult(RawObject result) const {
+  instanceVariableAtPut(kResultOffset, result);
+}
+
+inline bool RawProduct::stopped() const {
+  return RawBool::cast(instanceVariableAt(kStoppedOffset)).value();
+}
+
+inline void RawProduct::setStopped(bool stopped) const {
+  instanceVariableAtPut(kStoppedOffset, RawBool::fromBool(stopped));
+}
+
+// RawRepeat
+
+inline RawObject RawRepeat::element() const {
+  return instanceVariableAt(kElementOffset);
+}
+
+inline void RawRepeat::setElement(RawObject element) const {
+  instanceVariableAtPut(kElementOffset, element);
+}
+
+inline RawObject RawRepeat::times() const {
+  return instanceVariableAt(kTimesOffset);
+}
+
+inline void RawRepeat::setTimes(RawObject times) const {
+  instanceVariableAtPut(kTimesOffset, times);
+}
+
+// RawTee
+
+inline RawObject RawTee::data() const {
+  return instanceVariableAt(kDataOffset);
+}
+
+inline void RawTee::setData(RawObject data) const {
+  instanceVariableAtPut(kDataOffset, data);
+}
+
+inline word RawTee::index() const {
+  return RawSmallInt::cast(instanceVariableAt(kIndexOffset)).value();
+}
+
+inline void RawTee::setIndex(word index) const {
+  instanceVariableAtPut(kIndexOffset, RawSmallInt::fromWord(index));
+}
+
+// RawTeeDataObject
+
+inline RawObject RawTeeDataObject::iterator() const {
+  return instanceVariableAt(kIteratorOffset);
+}
+
+inline void RawTeeDataObject::setIterator(RawObject iterator) const {
+  instanceVariableAtPut(kIteratorOffset, iterator);
+}
+
+inline RawObject RawTeeDataObject::values() const {
+  return instanceVariableAt(kValuesOffset);
+}
+
+inline void RawTeeDataObject::setValues(RawObject values) const {
+  instanceVariableAtPut(kValuesOffset, values);
+}
+
+inline word RawTeeDataObject::numRead() const {
+  return RawSmallInt::cast(instanceVariableAt(kNumReadOffset)).value();
+}
+
+inline void RawTeeDataObject::setNumRead(word num_read) const {
+  instanceVariableAtPut(kNumReadOffset, RawSmallInt::fromWord(num_read));
+}
+
+inline RawObject RawTeeDataObject::next() const {
+  return instanceVariableAt(kNextOffset);
+}
+
+inline void RawTeeDataObject::setNext(RawObject next) const {
+  instanceVariableAtPut(kNextOffset, next);
+}
+
+inline bool RawTeeDataObject::running() const {
+  return RawBool::cast(instanceVariableAt(kRunningOffset)).value();
+}
+
+inline void RawTeeDataObject::setRunning(bool running) const {
+  instanceVariableAtPut(kRunningOffset, RawBool::fromBool(running));
+}
+
+// RawZipLongest
+
+inline RawObject RawZipLongest::iterators() const {
+  return instanceVariableAt(kIteratorsOffset);
+}
+
+inline void RawZipLongest::setIterators(RawObject iterators) const {
+  instanceVariableAtPut(kIteratorsOffset, iterators);
+}
+
+inline word RawZipLongest::numActive() const {
+  return RawSmallInt::cast(instanceVariableAt(kNumActiveOffset)).value();
+}
+
+inline void RawZipLongest::setNumActive(word num_active) const {
+  instanceVariableAtPut(kNumActiveOffset, RawSmallInt::fromWord(num_active));
+}
+
+inline RawObject RawZipLongest::fillValue() const {
+  return instanceVariableAt(kFillValueOffset);
+}
+
+inline void RawZipLongest::setFillValue(RawObject fill_value) const {
+  instanceVariableAtPut(kFillValueOffset, fill_value);
+}
+
 // RawDequeIterator
 
 inline word RawDequeIterator::state() const {
@@ -6509,6 +7335,16 @@ inline void RawDict::setFirstEmptyItemIndex(word first_empty_item_index) const {
                         RawSmallInt::fromWord(first_empty_item_index));
 }
 
+inline word RawDict::firstLiveItemIndex() const {
+  return RawSmallInt::cast(instanceVariableAt(kFirstLiveItemIndexOffset))
+      .value();
+}
+
+inline void RawDict::setFirstLiveItemIndex(word first_live_item_index) const {
+  instanceVariableAtPut(kFirstLiveItemIndexOffset,
+                        RawSmallInt::fromWord(first_live_item_index));
+}
+
 inline word RawDict::numIndices() const {
   RawObject indices_obj = indices();
   if (indices_obj == RawSmallInt::fromWord(0)) return 0;
@@ -6711,6 +7547,14 @@ inline void RawFunction::setIntrinsic(void* fp) const {
   instanceVariableAtPut(kIntrinsicOffset, RawSmallInt::fromAlignedCPtr(fp));
 }
 
+inline word RawFunction::jitCountdown() const {
+  return RawSmallInt::cast(instanceVariableAt(kJitCountdownOffset)).value();
+}
+
+inline void RawFunction::setJitCountdown(word countdown) const {
+  instanceVariableAtPut(kJitCountdownOffset, RawSmallInt::fromWord(countdown));
+}
+
 inline RawObject RawFunction::kwDefaults() const {
   return instanceVariableAt(kKwDefaultsOffset);
 }
@@ -7047,6 +7891,14 @@ inline void RawModule::setModuleProxy(RawObject module_proxy) const {
   instanceVariableAtPut(kModuleProxyOffset, module_proxy);
 }
 
+inline RawObject RawModule::apiHandle() const {
+  return instanceVariableAt(kApiHandleOffset);
+}
+
+inline void RawModule::setApiHandle(RawObject handle) const {
+  instanceVariableAtPut(kApiHandleOffset, handle);
+}
+
 inline word RawModule::id() const {
   word index = header().hashCode();
   DCHECK(index != RawHeader::kUninitializedHash,
@@ -4,6 +4,7 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -60,6 +61,63 @@ byte* OS::allocateMemory(word size, word* allocated_size) {
   return static_cast<byte*>(result);
 }
 
+byte* OS::allocateAlignedMemory(word size, word alignment,
+                                word* allocated_size) {
+  DCHECK(Utils::isPowerOfTwo(alignment), "alignment must be a power of two");
+  DCHECK(alignment >= kPageSize, "alignment must be at least a page");
+  size = Utils::roundUp(size, kPageSize);
+  if (allocated_size != nullptr) *allocated_size = size;
+  // Reserve enough address space to find an aligned region inside of it and
+  // give back the unused head and tail of the reservation afterwards. The
+  // reservation is inaccessible so it does not count against overcommit.
+  word reserved_size = size + alignment;
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+  void* reservation = ::mmap(nullptr, reserved_size, PROT_NONE, flags, -1, 0);
+  CHECK(reservation != MAP_FAILED, "mmap failure");
+  uword start = reinterpret_cast<uword>(reservation);
+  uword mask = static_cast<uword>(alignment) - 1;
+  uword aligned = (start + mask) & ~mask;
+  if (aligned > start) {
+    ::munmap(reservation, aligned - start);
+  }
+  uword end = start + reserved_size;
+  if (end > aligned + size) {
+    ::munmap(reinterpret_cast<void*>(aligned + size), end - (aligned + size));
+  }
+  byte* result = reinterpret_cast<byte*>(aligned);
+  int status = ::mprotect(result, size, PROT_READ | PROT_WRITE);
+  CHECK(status == 0, "mprotect failure");
+  return result;
+}
+
+byte* OS::allocateMemoryAt(uword address, word size, word* allocated_size) {
+  DCHECK(Utils::isAligned(address, kPageSize), "address must be page aligned");
+  size = Utils::roundUp(size, kPageSize);
+  if (allocated_size != nullptr) *allocated_size = size;
+  // Only pass the address as a hint: MAP_FIXED would silently replace
+  // whatever is mapped there already.
+  void* hint = reinterpret_cast<void*>(address);
+  int prot = PROT_READ | PROT_WRITE;
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+  void* result = ::mmap(hint, size, prot, flags, -1, 0);
+  if (result == MAP_FAILED) return nullptr;
+  if (result != hint) {
+    ::munmap(result, size);
+    return nullptr;
+  }
+  return static_cast<byte*>(result);
+}
+
+bool OS::mapFilePrivate(byte* address, word size, int fd, word offset) {
+  DCHECK(Utils::isAligned(reinterpret_cast<uword>(address), kPageSize),
+         "address must be page aligned");
+  DCHECK(Utils::isAligned(size, kPageSize), "size must be page aligned");
+  DCHECK(Utils::isAligned(offset, kPageSize), "offset must be page aligned");
+  void* result = ::mmap(address, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_FIXED, fd, offset);
+  return result != MAP_FAILED;
+}
+
 bool OS::access(const char* path, int mode) {
   return ::access(path, mode) == 0;
 }
@@ -218,4 +276,49 @@ double OS::currentTime() {
   return result;
 }
 
+bool OS::startProfilingTimer(word interval_usec, SignalHandler handler) {
+  DCHECK(interval_usec > 0, "interval must be positive");
+  // The assembly interpreter uses the machine stack as the value stack, so a
+  // signal frame pushed below the stack pointer would leave garbage in the
+  // next frame's locals. Run the handler on the alternate signal stack and
+  // set one up if the thread does not have one yet.
+  stack_t altstack;
+  if (::sigaltstack(nullptr, &altstack) == -1) {
+    return false;
+  }
+  if (altstack.ss_flags & SS_DISABLE) {
+    static void* profiling_signal_stack = nullptr;
+    if (profiling_signal_stack == nullptr) {
+      profiling_signal_stack = std::malloc(SIGSTKSZ);
+      if (profiling_signal_stack == nullptr) {
+        return false;
+      }
+    }
+    altstack.ss_sp = profiling_signal_stack;
+    altstack.ss_size = SIGSTKSZ;
+    altstack.ss_flags = 0;
+    if (::sigaltstack(&altstack, nullptr) == -1) {
+      return false;
+    }
+  }
+  struct sigaction context;
+  context.sa_handler = handler;
+  sigemptyset(&context.sa_mask);
+  context.sa_flags = SA_ONSTACK | SA_RESTART;
+  if (::sigaction(SIGPROF, &context, nullptr) == -1) {
+    return false;
+  }
+  itimerval timer;
+  timer.it_interval.tv_sec = interval_usec / kMicrosecondsPerSecond;
+  timer.it_interval.tv_usec = interval_usec % kMicrosecondsPerSecond;
+  timer.it_value = timer.it_interval;
+  return ::setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+}
+
+void OS::stopProfilingTimer() {
+  itimerval timer = {};
+  ::setitimer(ITIMER_PROF, &timer, nullptr);
+  setSignalHandler(SIGPROF, SIG_IGN);
+}
+
 }  // namespace py
@@ -34,6 +34,20 @@ class OS {
   // allocated_size is not nullptr, the rounded-up size will be written to it.
   static byte* allocateMemory(word size, word* allocated_size);
 
+  // Like allocateMemory() but the returned address is a multiple of
+  // alignment, which must be a power of two multiple of the page size.
+  static byte* allocateAlignedMemory(word size, word alignment,
+                                     word* allocated_size);
+
+  // Like allocateMemory() but places the memory at `address`, which must be
+  // page aligned. Returns nullptr if the range is not available.
+  static byte* allocateMemoryAt(uword address, word size, word* allocated_size);
+
+  // Replaces the `size` bytes of memory at `address` with a private
+  // copy-on-write mapping of the file `fd` starting at `offset`. `address`,
+  // `size` and `offset` must be page aligned.
+  static bool mapFilePrivate(byte* address, word size, int fd, word offset);
+
   // Returns whether the user has access to the specified path with the given
   // mode (which represents a bit mask of flags for the file existing, being
   // readable, writable, or executable).
@@ -58,6 +72,14 @@ class OS {
   static SignalHandler setSignalHandler(int signum, SignalHandler handler);
   static SignalHandler signalHandler(int signum);
 
+  // Delivers SIGPROF to `handler` every `interval_usec` microseconds of CPU
+  // time consumed by the process. Interrupted system calls are restarted.
+  static bool startProfilingTimer(word interval_usec, SignalHandler handler);
+
+  // Disarms the profiling timer. SIGPROF is ignored afterwards so that a
+  // signal still in flight does not terminate the process.
+  static void stopProfilingTimer();
+
   static byte* readFile(FILE* fp, word* len_out);
 
   static const char* name();
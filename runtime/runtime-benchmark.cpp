@@ -0,0 +1,63 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "benchmark/benchmark.h"
+
+#include "benchmark-utils.h"
+#include "handles.h"
+#include "runtime.h"
+
+namespace py {
+namespace testing {
+
+using RuntimeAllocationBenchmark = RuntimeBenchmark;
+
+BENCHMARK_DEFINE_F(RuntimeAllocationBenchmark, NewTupleWith2)
+(benchmark::State& state) {
+  HandleScope scope(thread_);
+  Object item(&scope, SmallInt::fromWord(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runtime_->newTupleWith2(item, item));
+  }
+}
+BENCHMARK_REGISTER_F(RuntimeAllocationBenchmark, NewTupleWith2);
+
+BENCHMARK_DEFINE_F(RuntimeAllocationBenchmark, NewTuple)
+(benchmark::State& state) {
+  HandleScope scope(thread_);
+  word length = state.range(0);
+  MutableTuple tuple(&scope, runtime_->newMutableTuple(length));
+  for (auto _ : state) {
+    tuple = runtime_->newMutableTuple(length);
+    tuple.fill(SmallInt::fromWord(0));
+    benchmark::DoNotOptimize(tuple.becomeImmutable());
+  }
+}
+BENCHMARK_REGISTER_F(RuntimeAllocationBenchmark, NewTuple)->Arg(4)->Arg(256);
+
+BENCHMARK_DEFINE_F(RuntimeAllocationBenchmark, NewList)
+(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runtime_->newList());
+  }
+}
+BENCHMARK_REGISTER_F(RuntimeAllocationBenchmark, NewList);
+
+BENCHMARK_DEFINE_F(RuntimeAllocationBenchmark, NewListAppend)
+(benchmark::State& state) {
+  HandleScope scope(thread_);
+  word length = state.range(0);
+  List list(&scope, runtime_->newList());
+  Object item(&scope, SmallInt::fromWord(0));
+  for (auto _ : state) {
+    list = runtime_->newList();
+    for (word i = 0; i < length; i++) {
+      runtime_->listAdd(thread_, list, item);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * length);
+}
+BENCHMARK_REGISTER_F(RuntimeAllocationBenchmark, NewListAppend)
+    ->Arg(4)
+    ->Arg(256);
+
+}  // namespace testing
+}  // namespace py
@@ -4,6 +4,7 @@
 #include <csignal>
 #include <cstdlib>
 #include <memory>
+#include <string>
 
 #include "gtest/gtest.h"
 
@@ -1372,6 +1373,30 @@ TEST_F(RuntimeTest, IsInternWithStrReturnsFalse) {
   EXPECT_FALSE(runtime_->isInternedStr(thread_, str));
 }
 
+TEST_F(RuntimeTest, InternStrWhileGrowingReturnsSameStr) {
+  HandleScope scope(thread_);
+  // Enough strings to grow every shard of the intern table a few times.
+  word num_strs = 50000;
+  List interned(&scope, runtime_->newList());
+  Object str(&scope, NoneType::object());
+  for (word i = 0; i < num_strs; i++) {
+    std::string name = "intern_growth_test_" + std::to_string(i);
+    str = Runtime::internStrFromCStr(thread_, name.c_str());
+    runtime_->listAdd(thread_, interned, str);
+    if (i == num_strs / 2) runtime_->collectGarbage();
+  }
+  Object copy(&scope, NoneType::object());
+  for (word i = 0; i < num_strs; i++) {
+    std::string name = "intern_growth_test_" + std::to_string(i);
+    copy = runtime_->newStrFromCStr(name.c_str());
+    str = interned.at(i);
+    ASSERT_TRUE(runtime_->isInternedStr(thread_, str));
+    ASSERT_FALSE(runtime_->isInternedStr(thread_, copy));
+    ASSERT_EQ(Runtime::internStr(thread_, copy), *str);
+    ASSERT_EQ(Runtime::internStrFromCStr(thread_, name.c_str()), *str);
+  }
+}
+
 TEST_F(RuntimeTest, CollectAttributes) {
   HandleScope scope(thread_);
 
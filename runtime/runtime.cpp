@@ -13,6 +13,7 @@
 #include <cwchar>
 #include <fstream>
 #include <memory>
+#include <thread>
 
 #include "array-module.h"
 #include "attributedict.h"
@@ -38,9 +39,11 @@
 #include "globals.h"
 #include "handles.h"
 #include "heap.h"
+#include "ic.h"
 #include "int-builtins.h"
 #include "interpreter.h"
 #include "iterator-builtins.h"
+#include "itertools-module.h"
 #include "layout-builtins.h"
 #include "layout.h"
 #include "list-builtins.h"
@@ -59,6 +62,7 @@
 #include "set-builtins.h"
 #include "siphash.h"
 #include "slice-builtins.h"
+#include "snapshot.h"
 #include "str-builtins.h"
 #include "str-intern.h"
 #include "strarray-builtins.h"
@@ -70,6 +74,7 @@
 #include "type-builtins.h"
 #include "under-collections-module.h"
 #include "under-contextvars-module.h"
+#include "under-functools-module.h"
 #include "under-io-module.h"
 #include "under-signal-module.h"
 #include "unicode.h"
@@ -147,18 +152,35 @@ RandomState randomStateFromSeed(uint64_t seed) {
 
 Runtime::Runtime(word heap_size, Interpreter* interpreter,
                  RandomState random_seed)
-    : heap_(heap_size), interpreter_(interpreter), random_state_(random_seed) {
+    : Runtime(heap_size, interpreter, random_seed, nullptr) {}
+
+Runtime::Runtime(word heap_size, Interpreter* interpreter,
+                 RandomState random_seed, Snapshot* snapshot)
+    : heap_(heap_size, snapshot == nullptr ? 0 : snapshot->heapStart()),
+      interpreter_(interpreter),
+      random_state_(random_seed) {
+  // Another runtime may be running on this OS thread. Its allocation buffer
+  // must not be used for the objects of this runtime.
+  Thread::setCurrentThread(nullptr);
   Thread* thread = newThread();
   thread->begin();
-  // This must be called before initializeTypes is called. Methods in
-  // initializeTypes rely on instances that are created in this method.
-  initializePrimitiveInstances();
-  initializeInterned(thread);
-  initializeSymbols(thread);
-  initializeLayouts();
-  initializeTypes(thread);
-  initializeCAPIState(this);
-  initializeModules(thread);
+  interned_ = new InternTable;
+  if (snapshot != nullptr && !snapshot->isWriting()) {
+    symbols_ = new Symbols;
+    initializeCAPIState(this);
+    snapshot->restore(thread, this);
+  } else {
+    // This must be called before initializeTypes is called. Methods in
+    // initializeTypes rely on instances that are created in this method.
+    initializePrimitiveInstances();
+    initializeInterned(thread);
+    initializeSymbols(thread);
+    initializeLayouts();
+    initializeTypes(thread);
+    initializeCAPIState(this);
+    initializeModules(thread);
+    if (snapshot != nullptr) snapshot->write(thread, this);
+  }
   initializeCAPIModules();
   initializeJITState();
 
@@ -177,6 +199,7 @@ Runtime::~Runtime() {
     CHECK(main_thread_ != nullptr, "the runtime does not have any threads");
     Thread::setCurrentThread(main_thread_);
   }
+  sampling_profiler_.stop();
   callAtExit();
   flushStdFiles();
   finalizeSignals(Thread::current());
@@ -195,6 +218,7 @@ Runtime::~Runtime() {
     }
   }
   delete symbols_;
+  delete interned_;
   delete machine_code_;
 }
 
@@ -609,6 +633,7 @@ RawObject Runtime::newFunction(Thread* thread, const Object& name,
   function.setEntryKw(entry_kw);
   function.setEntryEx(entry_ex);
   function.setIntrinsic(nullptr);
+  function.setJitCountdown(jitInitialCountdown());
   populateEntryAsm(function);
   return *function;
 }
@@ -1360,42 +1385,15 @@ RawObject Runtime::newStrWithAll(View<byte> code_units) {
   return result;
 }
 
-void NEVER_INLINE Runtime::internSetGrow(Thread* thread) {
-  interned_ = py::internSetGrow(thread, MutableTuple::cast(interned_),
-                                &interned_remaining_);
-}
-
 RawObject Runtime::internLargeStr(Thread* thread, const Object& str) {
-  Runtime* runtime = thread->runtime();
-  RawObject result = NoneType::object();
-  if (internSetAdd(thread, MutableTuple::cast(runtime->interned_), str,
-                   &result)) {
-    DCHECK(result == str, "expected str");
-    if (--runtime->interned_remaining_ == 0) {
-      runtime->internSetGrow(thread);
-      return *str;
-    }
-  }
-  return result;
+  return thread->runtime()->interned_->add(thread, str);
 }
 
 RawObject Runtime::internStrFromAll(Thread* thread, View<byte> bytes) {
   if (bytes.length() <= SmallStr::kMaxLength) {
     return SmallStr::fromBytes(bytes);
   }
-
-  Runtime* runtime = thread->runtime();
-  RawObject result = NoneType::object();
-  if (internSetAddFromAll(thread, MutableTuple::cast(runtime->interned_), bytes,
-                          &result)) {
-    if (--runtime->interned_remaining_ == 0) {
-      HandleScope scope(thread);
-      Object result_obj(&scope, result);
-      runtime->internSetGrow(thread);
-      return *result_obj;
-    }
-  }
-  return result;
+  return thread->runtime()->interned_->addFromAll(thread, bytes);
 }
 
 RawObject Runtime::internStrFromCStr(Thread* thread, const char* c_str) {
@@ -1408,8 +1406,7 @@ bool Runtime::isInternedStr(Thread* thread, const Object& str) {
   if (str.isSmallStr()) {
     return true;
   }
-  return internSetContains(MutableTuple::cast(thread->runtime()->interned_),
-                           LargeStr::cast(*str));
+  return thread->runtime()->interned_->contains(LargeStr::cast(*str));
 }
 
 word Runtime::hash(RawObject object) {
@@ -1631,6 +1628,35 @@ void Runtime::populateEntryAsm(const Function& function) {
   function.setEntryAsm(interpreter_->entryAsm(function));
 }
 
+namespace {
+
+class JitCountdownResetter : public HeapObjectVisitor {
+ public:
+  explicit JitCountdownResetter(word countdown) : countdown_(countdown) {}
+
+  void visitHeapObject(RawHeapObject object) override {
+    if (!object.isFunction()) return;
+    RawFunction function = Function::cast(object);
+    if (function.isCompiled()) return;
+    function.setJitCountdown(countdown_);
+  }
+
+ private:
+  word countdown_;
+};
+
+}  // namespace
+
+void Runtime::setJitThreshold(word threshold) {
+  DCHECK(threshold >= 0 && threshold <= SmallInt::kMaxValue,
+         "threshold out of range");
+  jit_threshold_ = threshold;
+  // Restart the countdown of existing functions so the new threshold applies
+  // to them as well.
+  JitCountdownResetter resetter(jitInitialCountdown());
+  heap_.visitAllObjects(&resetter);
+}
+
 static const word kFixedSpaceSize = 1 * kGiB;
 
 void Runtime::initializeJITState() {
@@ -1684,6 +1710,7 @@ void Runtime::initializeTypes(Thread* thread) {
   initializeGeneratorTypes(thread);
   initializeIntTypes(thread);
   initializeIteratorType(thread);
+  initializeItertoolsTypes(thread);
   initializeLayoutType(thread);
   initializeListTypes(thread);
   initializeMappingProxyType(thread);
@@ -1703,6 +1730,7 @@ void Runtime::initializeTypes(Thread* thread) {
   initializeTypeTypes(thread);
   initializeUnderCollectionsTypes(thread);
   initializeUnderContextvarsTypes(thread);
+  initializeUnderFunctoolsTypes(thread);
   initializeUnderIOTypes(thread);
   initializeValueCellTypes(thread);
 
@@ -1723,11 +1751,30 @@ void Runtime::initializeTypes(Thread* thread) {
 
 void Runtime::collectGarbageInto(CompactionDestination destination) {
   EVENT(CollectGarbage);
+  stopOtherThreads(Thread::current());
   bool run_callback = callbacks_ == NoneType::object();
-  RawObject cb = (destination == CompactionDestination::kImmortalPartition)
-                     ? scavengeImmortalize(this)
-                     : scavenge(this);
+  RawObject cb = NoneType::object();
+  switch (destination) {
+    case CompactionDestination::kImmortalPartition:
+      cb = scavengeImmortalize(this);
+      break;
+    case CompactionDestination::kNewPartition:
+      cb = scavenge(this);
+      break;
+    case CompactionDestination::kYoungGeneration:
+      cb = scavengeYoung(this);
+      break;
+  }
+  {
+    // The allocation buffers point into the evacuated young generation.
+    MutexGuard lock(&threads_mutex_);
+    for (Thread* thread = main_thread_; thread != nullptr;
+         thread = thread->next()) {
+      thread->allocationBuffer()->reset();
+    }
+  }
   callbacks_ = WeakRef::spliceQueue(callbacks_, cb);
+  resumeOtherThreads();
   if (run_callback) {
     processCallbacks();
   }
@@ -1739,7 +1786,7 @@ void Runtime::collectGarbageInto(CompactionDestination destination) {
 Thread* Runtime::newThread() {
   Thread* thread = new Thread(this, Thread::kDefaultStackSize);
   {
-    MutexGuard lock(&threads_mutex_);
+    ThreadMutexGuard lock(Thread::current(), &threads_mutex_);
     if (main_thread_ == nullptr) {
       main_thread_ = thread;
     } else {
@@ -1752,11 +1799,17 @@ Thread* Runtime::newThread() {
       }
     }
   }
+  // Allocate once the thread is linked so that its roots are visited by a
+  // garbage collection the allocation may start.
+  thread->setCaughtExceptionState(newExceptionState());
   return thread;
 }
 
 void Runtime::deleteThread(Thread* thread) {
   CHECK(thread != main_thread_, "cannot delete main thread");
+  // The thread stays stopped until it is gone.
+  thread->enterBlockingRegion();
+  Thread::setCurrentThread(nullptr);
   MutexGuard lock(&threads_mutex_);
   Thread* prev = thread->prev();
   Thread* next = thread->next();
@@ -1764,9 +1817,56 @@ void Runtime::deleteThread(Thread* thread) {
   if (next != nullptr) {
     next->setPrev(prev);
   }
+  retired_ic_stats_.add(*thread->icStats());
   delete thread;
 }
 
+void Runtime::icStats(IcStats* result) {
+  ThreadMutexGuard lock(Thread::current(), &threads_mutex_);
+  result->add(retired_ic_stats_);
+  for (Thread* thread = main_thread_; thread != nullptr;
+       thread = thread->next()) {
+    result->add(*thread->icStats());
+  }
+}
+
+void Runtime::stopOtherThreads(Thread* thread) {
+  if (!safepoint_mutex_.tryLock()) {
+    // Another thread is stopping the world; stay stopped until it is done.
+    thread->enterBlockingRegion();
+    safepoint_mutex_.lock();
+    thread->leaveBlockingRegion();
+  }
+  __atomic_store_n(&stop_requested_, true, __ATOMIC_SEQ_CST);
+  MutexGuard lock(&threads_mutex_);
+  if (main_thread_->next() == nullptr) return;
+  for (Thread* other = main_thread_; other != nullptr; other = other->next()) {
+    if (other != thread) other->interrupt(Thread::kSafepoint);
+  }
+  for (Thread* other = main_thread_; other != nullptr; other = other->next()) {
+    while (other != thread && !other->isAtSafepoint()) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void Runtime::resumeOtherThreads() {
+  __atomic_store_n(&stop_requested_, false, __ATOMIC_SEQ_CST);
+  safepoint_mutex_.unlock();
+}
+
+void Runtime::safepoint(Thread* thread) {
+  thread->clearInterrupt(Thread::kSafepoint);
+  if (!isStopRequested()) return;
+  thread->enterBlockingRegion();
+  thread->leaveBlockingRegion();
+}
+
+void Runtime::waitForResume() {
+  safepoint_mutex_.lock();
+  safepoint_mutex_.unlock();
+}
+
 void Runtime::processCallbacks() {
   Thread* thread = Thread::current();
   HandleScope scope(thread);
@@ -1899,6 +1999,8 @@ void Runtime::initializePrimitiveInstances() {
   empty_frozen_set_ = newFrozenSet();
   empty_mutable_bytes_ = createMutableBytes(0);
   empty_slice_ = newInstanceWithSize(LayoutId::kSlice, Slice::kSize);
+  megamorphic_cache_ = newMutableTuple(kIcMegamorphicCacheEntries);
+  MutableTuple::cast(megamorphic_cache_).fill(NoneType::object());
   {
     uword address;
     CHECK(heap()->allocate(Ellipsis::allocationSize(), &address),
@@ -1908,8 +2010,7 @@ void Runtime::initializePrimitiveInstances() {
 }
 
 void Runtime::initializeInterned(Thread*) {
-  interned_ = newMutableTuple(kInitialInternSetCapacity);
-  interned_remaining_ = internSetComputeRemaining(kInitialInternSetCapacity);
+  interned_->initialize(this, kInitialInternSetCapacity);
 }
 
 void Runtime::initializeSymbols(Thread* thread) {
@@ -2096,6 +2197,7 @@ void Runtime::visitRuntimeRoots(PointerVisitor* visitor) {
   visitor->visitPointer(&empty_mutable_bytes_, PointerKind::kRuntime);
   visitor->visitPointer(&empty_slice_, PointerKind::kRuntime);
   visitor->visitPointer(&empty_tuple_, PointerKind::kRuntime);
+  visitor->visitPointer(&megamorphic_cache_, PointerKind::kRuntime);
   visitor->visitPointer(&module_dunder_getattribute_, PointerKind::kRuntime);
   visitor->visitPointer(&object_dunder_class_, PointerKind::kRuntime);
   visitor->visitPointer(&object_dunder_eq_, PointerKind::kRuntime);
@@ -2112,7 +2214,7 @@ void Runtime::visitRuntimeRoots(PointerVisitor* visitor) {
   visitor->visitPointer(&type_dunder_getattribute_, PointerKind::kRuntime);
 
   // Visit interned strings.
-  visitor->visitPointer(&interned_, PointerKind::kRuntime);
+  interned_->visitRoots(visitor);
 
   // Visit modules
   visitor->visitPointer(&modules_, PointerKind::kRuntime);
@@ -2129,11 +2231,80 @@ void Runtime::visitRuntimeRoots(PointerVisitor* visitor) {
   visitor->visitPointer(&profiling_new_thread_, PointerKind::kRuntime);
   visitor->visitPointer(&profiling_call_, PointerKind::kRuntime);
   visitor->visitPointer(&profiling_return_, PointerKind::kRuntime);
+  sampling_profiler_.visitRoots(visitor);
 
   // Visit finalizable native instances
   visitor->visitPointer(&finalizable_references_, PointerKind::kRuntime);
 }
 
+namespace {
+
+class RootSaver : public PointerVisitor {
+ public:
+  explicit RootSaver(Vector<RawObject>* roots) : roots_(roots) {}
+
+  void visitPointer(RawObject* pointer, PointerKind) override {
+    roots_->push_back(*pointer);
+  }
+
+ private:
+  Vector<RawObject>* roots_;
+};
+
+class RootRestorer : public PointerVisitor {
+ public:
+  explicit RootRestorer(View<RawObject> roots) : roots_(roots) {}
+
+  void visitPointer(RawObject* pointer, PointerKind) override {
+    *pointer = roots_.get(index_++);
+  }
+
+  word numRestored() { return index_; }
+
+ private:
+  View<RawObject> roots_;
+  word index_ = 0;
+};
+
+}  // namespace
+
+void Runtime::saveSnapshotState(SnapshotState* state,
+                                Vector<RawObject>* roots) {
+  interned_->finishGrowing();
+  state->num_layouts = num_layouts_;
+  state->max_module_id = max_module_id_;
+  state->builtins_module_id = builtins_module_id_;
+  state->siphash24_secret = random_state_.siphash24_secret;
+  state->layouts = layouts_.raw();
+  state->layout_type_transitions = layout_type_transitions_.raw();
+  RootSaver saver(roots);
+  visitRuntimeRoots(&saver);
+}
+
+void Runtime::restoreSnapshotState(Thread* thread, const SnapshotState& state,
+                                   View<RawObject> roots) {
+  num_layouts_ = state.num_layouts;
+  max_module_id_ = state.max_module_id;
+  builtins_module_id_ = state.builtins_module_id;
+  // Cached str hashes and dict layouts in the snapshot depend on the secret.
+  random_state_.siphash24_secret = state.siphash24_secret;
+  // The builtin layouts are visited as roots inside of `layouts_`.
+  layouts_ = RawObject{state.layouts};
+  layout_type_transitions_ = RawObject{state.layout_type_transitions};
+  RootRestorer restorer(roots);
+  visitRuntimeRoots(&restorer);
+  CHECK(restorer.numRestored() == roots.length(),
+        "snapshot has %ld roots, expected %ld", roots.length(),
+        restorer.numRestored());
+  interned_->recomputeRemaining();
+
+  // Signal handlers are process state and need to be installed again.
+  HandleScope scope(thread);
+  signal_callbacks_ = NoneType::object();
+  Module under_signal(&scope, findModuleById(ID(_signal)));
+  initializeSignals(thread, under_signal);
+}
+
 void Runtime::visitThreadRoots(PointerVisitor* visitor) {
   MutexGuard lock(&threads_mutex_);
   for (Thread* thread = main_thread_; thread != nullptr;
@@ -3146,10 +3317,10 @@ RawObject Runtime::strRepeat(Thread* thread, const Str& str, word count) {
 RawObject Runtime::strSlice(Thread* thread, const Str& str, word start,
                             word stop, word step) {
   word length = Slice::length(start, stop, step);
-  word start_index = str.offsetByCodePoints(0, start);
+  word start_index = thread->strOffset(str, start);
 
   if (step == 1) {
-    word end_index = str.offsetByCodePoints(start_index, length);
+    word end_index = thread->strOffset(str, start + length);
     word num_chars = end_index - start_index;
     return strSubstr(thread, str, start_index, num_chars);
   }
@@ -4264,6 +4435,261 @@ static void fullMultiply(uword x, uword y, uword* result_low,
   *result_high = static_cast<uword>(result >> 64);
 }
 
+// Large ints with at least this many digits are multiplied with the Karatsuba
+// algorithm. See the `RuntimeIntBenchmark` cases for tuning.
+static const word kKaratsubaThreshold = 40;
+static const word kKaratsubaSquareThreshold = 64;
+// Ints with at least this many digits are squared with `digitsSquare()`.
+static const word kSquareThreshold = 4;
+
+// The following functions work on unsigned little endian arrays of digits.
+
+// Computes `x += y` for `yn <= xn` and returns the carry out of `x`.
+static uword digitsAdd(uword* x, word xn, const uword* y, word yn) {
+  DCHECK(yn <= xn, "y must not be longer than x");
+  uword carry = 0;
+  word i = 0;
+  for (; i < yn; i++) {
+    x[i] = addWithCarry(x[i], y[i], carry, &carry);
+  }
+  for (; carry != 0 && i < xn; i++) {
+    x[i] = addWithCarry(x[i], 0, carry, &carry);
+  }
+  return carry;
+}
+
+// Computes `x -= y` for `yn <= xn` and returns the borrow out of `x`.
+static uword digitsSubtract(uword* x, word xn, const uword* y, word yn) {
+  DCHECK(yn <= xn, "y must not be longer than x");
+  uword borrow = 0;
+  word i = 0;
+  for (; i < yn; i++) {
+    x[i] = subtractWithBorrow(x[i], y[i], borrow, &borrow);
+  }
+  for (; borrow != 0 && i < xn; i++) {
+    x[i] = subtractWithBorrow(x[i], 0, borrow, &borrow);
+  }
+  return borrow;
+}
+
+// Writes the `xn + yn` digits of `x * y` to `result`.
+static void digitsMultiplySchoolbook(uword* result, const uword* x, word xn,
+                                     const uword* y, word yn) {
+  std::memset(result, 0, (xn + yn) * sizeof(result[0]));
+  for (word i = 0; i < xn; i++) {
+    uword carry = 0;
+    for (word j = 0; j < yn; j++) {
+      uword product_low;
+      uword product_high;
+      fullMultiply(x[i], y[j], &product_low, &product_high);
+      uword carry0;
+      uword sum0 = addWithCarry(result[i + j], product_low, 0, &carry0);
+      uword carry1;
+      result[i + j] = addWithCarry(sum0, carry, 0, &carry1);
+      carry = product_high + carry0 + carry1;
+    }
+    result[i + yn] = carry;
+  }
+}
+
+// Writes the `2 * n` digits of `x * x` to `result`. Every cross product
+// `x[i] * x[j]` is computed once and doubled, which saves almost half of the
+// multiplications compared to `digitsMultiplySchoolbook()`.
+static void digitsSquareSchoolbook(uword* result, const uword* x, word n) {
+  std::memset(result, 0, 2 * n * sizeof(result[0]));
+  for (word i = 0; i < n; i++) {
+    uword carry = 0;
+    for (word j = i + 1; j < n; j++) {
+      uword product_low;
+      uword product_high;
+      fullMultiply(x[i], x[j], &product_low, &product_high);
+      uword carry0;
+      uword sum0 = addWithCarry(result[i + j], product_low, 0, &carry0);
+      uword carry1;
+      result[i + j] = addWithCarry(sum0, carry, 0, &carry1);
+      carry = product_high + carry0 + carry1;
+    }
+    result[i + n] = carry;
+  }
+  uword shifted_out = 0;
+  for (word i = 0; i < 2 * n; i++) {
+    uword digit = result[i];
+    result[i] = (digit << 1) | shifted_out;
+    shifted_out = digit >> (kBitsPerWord - 1);
+  }
+  uword carry = 0;
+  for (word i = 0; i < n; i++) {
+    uword product_low;
+    uword product_high;
+    fullMultiply(x[i], x[i], &product_low, &product_high);
+    result[2 * i] = addWithCarry(result[2 * i], product_low, carry, &carry);
+    result[2 * i + 1] =
+        addWithCarry(result[2 * i + 1], product_high, carry, &carry);
+  }
+  DCHECK(carry == 0, "square must fit into 2 * n digits");
+}
+
+// Adds the middle term `z1` of a Karatsuba step to `result[offset..]`, which
+// has `available` digits. `z1` may have more digits than that, but they must
+// be zero.
+static void addMiddleTerm(uword* result, word available, const uword* z1,
+                          word z1_digits) {
+  while (z1_digits > available) {
+    DCHECK(z1[z1_digits - 1] == 0, "middle term must fit into the result");
+    z1_digits--;
+  }
+  uword carry = digitsAdd(result, available, z1, z1_digits);
+  DCHECK(carry == 0, "product must fit into the result");
+  static_cast<void>(carry);
+}
+
+static void digitsMultiply(uword* result, const uword* x, word xn,
+                           const uword* y, word yn);
+
+// Multiplies `x` with a much shorter `y` by multiplying `y` with slices of `x`
+// of the same length as `y`. This keeps the Karatsuba steps balanced.
+static void digitsMultiplyLopsided(uword* result, const uword* x, word xn,
+                                   const uword* y, word yn) {
+  std::memset(result, 0, (xn + yn) * sizeof(result[0]));
+  std::unique_ptr<uword[]> product(new uword[2 * yn]);
+  for (word start = 0; start < xn; start += yn) {
+    word slice = Utils::minimum(yn, xn - start);
+    digitsMultiply(product.get(), x + start, slice, y, yn);
+    uword carry =
+        digitsAdd(result + start, xn + yn - start, product.get(), slice + yn);
+    DCHECK(carry == 0, "product must fit into the result");
+    static_cast<void>(carry);
+  }
+}
+
+// Writes the `xn + yn` digits of `x * y` to `result`. Uses the Karatsuba
+// algorithm when both operands have at least `kKaratsubaThreshold` digits:
+// With `x = x1 * B + x0` and `y = y1 * B + y0` the product is
+// `z2 * B**2 + z1 * B + z0` where `z0 = x0 * y0`, `z2 = x1 * y1` and
+// `z1 = (x0 + x1) * (y0 + y1) - z0 - z2`, which needs three recursive
+// multiplications instead of four.
+static void digitsMultiply(uword* result, const uword* x, word xn,
+                           const uword* y, word yn) {
+  if (xn < yn) {
+    std::swap(x, y);
+    std::swap(xn, yn);
+  }
+  if (yn < kKaratsubaThreshold) {
+    digitsMultiplySchoolbook(result, x, xn, y, yn);
+    return;
+  }
+  if (2 * yn <= xn) {
+    digitsMultiplyLopsided(result, x, xn, y, yn);
+    return;
+  }
+
+  word half = xn / 2;
+  const uword* x1 = x + half;
+  const uword* y1 = y + half;
+  word x1n = xn - half;
+  word y1n = yn - half;
+  digitsMultiply(result, x, half, y, half);
+  digitsMultiply(result + 2 * half, x1, x1n, y1, y1n);
+
+  word sum_x_digits = x1n + 1;
+  std::unique_ptr<uword[]> sum_x(new uword[sum_x_digits]);
+  std::memcpy(sum_x.get(), x1, x1n * sizeof(x1[0]));
+  sum_x[x1n] = 0;
+  digitsAdd(sum_x.get(), sum_x_digits, x, half);
+
+  word sum_y_digits = Utils::maximum(half, y1n) + 1;
+  std::unique_ptr<uword[]> sum_y(new uword[sum_y_digits]);
+  std::memset(sum_y.get(), 0, sum_y_digits * sizeof(sum_y[0]));
+  std::memcpy(sum_y.get(), y, half * sizeof(y[0]));
+  digitsAdd(sum_y.get(), sum_y_digits, y1, y1n);
+
+  word z1_digits = sum_x_digits + sum_y_digits;
+  std::unique_ptr<uword[]> z1(new uword[z1_digits]);
+  digitsMultiply(z1.get(), sum_x.get(), sum_x_digits, sum_y.get(),
+                 sum_y_digits);
+  digitsSubtract(z1.get(), z1_digits, result, 2 * half);
+  digitsSubtract(z1.get(), z1_digits, result + 2 * half, x1n + y1n);
+  addMiddleTerm(result + half, xn + yn - half, z1.get(), z1_digits);
+}
+
+// Writes the `2 * n` digits of `x * x` to `result`. This is the Karatsuba
+// algorithm of `digitsMultiply()` specialized for equal operands.
+static void digitsSquare(uword* result, const uword* x, word n) {
+  if (n < kKaratsubaSquareThreshold) {
+    digitsSquareSchoolbook(result, x, n);
+    return;
+  }
+
+  word half = n / 2;
+  const uword* x1 = x + half;
+  word x1n = n - half;
+  digitsSquare(result, x, half);
+  digitsSquare(result + 2 * half, x1, x1n);
+
+  word sum_digits = x1n + 1;
+  std::unique_ptr<uword[]> sum(new uword[sum_digits]);
+  std::memcpy(sum.get(), x1, x1n * sizeof(x1[0]));
+  sum[x1n] = 0;
+  digitsAdd(sum.get(), sum_digits, x, half);
+
+  word z1_digits = 2 * sum_digits;
+  std::unique_ptr<uword[]> z1(new uword[z1_digits]);
+  digitsSquare(z1.get(), sum.get(), sum_digits);
+  digitsSubtract(z1.get(), z1_digits, result, 2 * half);
+  digitsSubtract(z1.get(), z1_digits, result + 2 * half, 2 * x1n);
+  addMiddleTerm(result + half, 2 * n - half, z1.get(), z1_digits);
+}
+
+// Writes the digits of the absolute value of `number` to `digits`.
+static void digitsFromIntMagnitude(uword* digits, const Int& number) {
+  word num_digits = number.numDigits();
+  for (word i = 0; i < num_digits; i++) {
+    digits[i] = number.digitAt(i);
+  }
+  if (number.isNegative()) {
+    uword carry = 1;
+    for (word i = 0; i < num_digits; i++) {
+      digits[i] = addWithCarry(~digits[i], 0, carry, &carry);
+    }
+  }
+}
+
+// Multiplication of two large ints via `digitsMultiply()` or `digitsSquare()`
+// on their magnitudes.
+static RawObject intMultiplyMagnitudes(Thread* thread, const Int& left,
+                                       const Int& right) {
+  word left_digits = left.numDigits();
+  word right_digits = right.numDigits();
+  std::unique_ptr<uword[]> left_magnitude(new uword[left_digits]);
+  digitsFromIntMagnitude(left_magnitude.get(), left);
+  word result_digits = left_digits + right_digits;
+  std::unique_ptr<uword[]> product(new uword[result_digits]);
+  if (*left == *right) {
+    digitsSquare(product.get(), left_magnitude.get(), left_digits);
+  } else {
+    std::unique_ptr<uword[]> right_magnitude(new uword[right_digits]);
+    digitsFromIntMagnitude(right_magnitude.get(), right);
+    digitsMultiply(product.get(), left_magnitude.get(), left_digits,
+                   right_magnitude.get(), right_digits);
+  }
+
+  // The magnitudes are at most 2**(64 * digits - 1) so the product has a free
+  // sign bit.
+  if (left.isNegative() != right.isNegative()) {
+    uword carry = 1;
+    for (word i = 0; i < result_digits; i++) {
+      product[i] = addWithCarry(~product[i], 0, carry, &carry);
+    }
+  }
+  Runtime* runtime = thread->runtime();
+  HandleScope scope(thread);
+  LargeInt result(&scope, runtime->createLargeInt(result_digits));
+  for (word i = 0; i < result_digits; i++) {
+    result.digitAtPut(i, product[i]);
+  }
+  return runtime->normalizeLargeInt(thread, result);
+}
+
 RawObject Runtime::intMultiply(Thread* thread, const Int& left,
                                const Int& right) {
   // See also Hackers Delight Chapter 8 Multiplication.
@@ -4278,6 +4704,12 @@ RawObject Runtime::intMultiply(Thread* thread, const Int& left,
     }
   }
 
+  if ((*left == *right && left_digits >= kSquareThreshold) ||
+      (left_digits >= kKaratsubaThreshold &&
+       right_digits >= kKaratsubaThreshold)) {
+    return intMultiplyMagnitudes(thread, left, right);
+  }
+
   HandleScope scope(thread);
   word result_digits = left.numDigits() + right.numDigits();
   LargeInt result(&scope, createLargeInt(result_digits));
@@ -5,21 +5,27 @@
 #include "capi.h"
 #include "handles.h"
 #include "heap.h"
+#include "ic-stats.h"
 #include "interpreter-gen.h"
 #include "interpreter.h"
 #include "layout.h"
 #include "modules.h"
 #include "mutex.h"
+#include "sampling-profiler.h"
 #include "symbols.h"
+#include "vector.h"
 #include "view.h"
 
 namespace py {
 
 class AttributeInfo;
 class Heap;
+class InternTable;
 class RawObject;
 class RawTuple;
 class PointerVisitor;
+class Snapshot;
+struct SnapshotState;
 class Thread;
 
 enum LayoutTypeTransition {
@@ -49,6 +55,10 @@ RandomState randomStateFromSeed(uint64_t seed);
 class Runtime {
  public:
   Runtime(word heap_size, Interpreter* interpreter, RandomState random_seed);
+  // Starts the runtime from the heap snapshot if it was opened for reading.
+  // Otherwise initializes the runtime from scratch and writes the snapshot.
+  Runtime(word heap_size, Interpreter* interpreter, RandomState random_seed,
+          Snapshot* snapshot);
   ~Runtime();
 
   // Completes the runtime initialization. Should be called after
@@ -64,6 +74,36 @@ class Runtime {
   // Allocate memory for JITed code.
   bool allocateForMachineCode(word size, uword* address_out);
 
+  // Number of calls and loop iterations after which the assembly interpreter
+  // JIT-compiles a function. Zero disables automatic compilation.
+  word jitThreshold() { return jit_threshold_; }
+  void setJitThreshold(word threshold);
+
+  // The value `Function::jitCountdown()` starts out with.
+  word jitInitialCountdown() {
+    return jit_threshold_ > 0 ? jit_threshold_ : SmallInt::kMaxValue;
+  }
+
+  // Number of functions that were JIT-compiled after reaching the threshold.
+  word numJitTierUps() { return num_jit_tier_ups_; }
+  void incrementJitTierUps() { num_jit_tier_ups_++; }
+
+  // The attribute cache shared by all megamorphic LOAD_ATTR and LOAD_METHOD
+  // sites. See the layout description in ic.h.
+  RawObject megamorphicCache() { return megamorphic_cache_; }
+
+  // Number of probes of the megamorphic cache that found or missed an entry.
+  // The counters are not synchronized and may lose updates when several
+  // threads run bytecode at the same time.
+  word megamorphicCacheHits() { return megamorphic_cache_hits_; }
+  word megamorphicCacheMisses() { return megamorphic_cache_misses_; }
+  void incrementMegamorphicCacheHits() { megamorphic_cache_hits_++; }
+  void incrementMegamorphicCacheMisses() { megamorphic_cache_misses_++; }
+
+  // Adds the inline cache counters of all threads, including the ones that
+  // already finished, to `result`.
+  void icStats(IcStats* result);
+
   RawObject newBoundMethod(const Object& function, const Object& self);
 
   RawObject newBytearray();
@@ -313,6 +353,8 @@ class Runtime {
   void setProfiling(const Object& new_thread_func, const Object& call_func,
                     const Object& return_func);
 
+  SamplingProfiler* samplingProfiler() { return &sampling_profiler_; }
+
   void reinitInterpreter();
 
   void builtinTypeCreated(Thread* thread, const Type& type);
@@ -329,10 +371,20 @@ class Runtime {
   // strings, even when the user did not explicitly intern them.
   static bool isInternedStr(Thread* thread, const Object& str);
 
-  enum class CompactionDestination { kImmortalPartition, kNewPartition };
+  enum class CompactionDestination {
+    kImmortalPartition,
+    kNewPartition,
+    kYoungGeneration,
+  };
+  // Collects both generations.
   void collectGarbage() {
     collectGarbageInto(CompactionDestination::kNewPartition);
   }
+  // Collects the young generation only, unless the old generation needs to be
+  // collected to make room for promoted objects.
+  void collectYoungGarbage() {
+    collectGarbageInto(CompactionDestination::kYoungGeneration);
+  }
   void immortalizeCurrentHeapObjects() {
     collectGarbageInto(CompactionDestination::kImmortalPartition);
   }
@@ -341,9 +393,28 @@ class Runtime {
   // Creates a new thread and adds it to the runtime.
   Thread* newThread();
 
-  // Removes the specified thread from the runtime and deletes it.
+  // Removes the specified thread from the runtime and deletes it. Must be
+  // called by the thread itself once it is done running.
   void deleteThread(Thread* thread);
 
+  // Stops all threads but `thread` at a safepoint and keeps them stopped until
+  // `resumeOtherThreads()`. Threads reach a safepoint when they take a new
+  // allocation buffer, push a frame, jump backwards or enter a blocking
+  // region. Only one thread can stop the others at a time.
+  void stopOtherThreads(Thread* thread);
+  void resumeOtherThreads();
+
+  // Stops `thread` until the other threads are resumed if another thread
+  // requested a stop. Called when `thread` sees the safepoint interrupt.
+  void safepoint(Thread* thread);
+
+  bool isStopRequested() {
+    return __atomic_load_n(&stop_requested_, __ATOMIC_SEQ_CST);
+  }
+  // Waits for `resumeOtherThreads()`. The calling thread must be in a
+  // blocking region.
+  void waitForResume();
+
   // Compute hash value suitable for `RawObject::operator==` (aka `a is b`)
   // equality tests.
   word hash(RawObject object);
@@ -364,6 +435,15 @@ class Runtime {
   RawObject* finalizableReferences();
 
   void visitRootsWithoutApiHandles(PointerVisitor* visitor);
+  void visitRuntimeRoots(PointerVisitor* visitor);
+
+  // Saves the state a heap snapshot needs besides the immortal objects and
+  // appends the values of the runtime roots to `roots`.
+  void saveSnapshotState(SnapshotState* state, Vector<RawObject>* roots);
+  // Restores the state saved by `saveSnapshotState()` once the immortal
+  // objects of the snapshot are in place.
+  void restoreSnapshotState(Thread* thread, const SnapshotState& state,
+                            View<RawObject> roots);
 
   RawObject findModule(const Object& name);
   RawObject findModuleById(SymbolId name);
@@ -631,25 +711,33 @@ class Runtime {
     if (obj.is##ty()) return true;                                             \
     return typeOf(obj).rawCast<RawType>().builtinBase() == LayoutId::k##ty;    \
   }
+  DEFINE_IS_INSTANCE(Accumulate)
   DEFINE_IS_INSTANCE(Array)
   DEFINE_IS_INSTANCE(BufferedReader)
   DEFINE_IS_INSTANCE(BufferedWriter)
   DEFINE_IS_INSTANCE(Bytearray)
   DEFINE_IS_INSTANCE(Bytes)
   DEFINE_IS_INSTANCE(BytesIO)
+  DEFINE_IS_INSTANCE(Chain)
   DEFINE_IS_INSTANCE(ClassMethod)
   DEFINE_IS_INSTANCE(Complex)
+  DEFINE_IS_INSTANCE(Count)
   DEFINE_IS_INSTANCE(Deque)
   DEFINE_IS_INSTANCE(Dict)
   DEFINE_IS_INSTANCE(FileIO)
   DEFINE_IS_INSTANCE(Float)
   DEFINE_IS_INSTANCE(FrozenSet)
+  DEFINE_IS_INSTANCE(Groupby)
   DEFINE_IS_INSTANCE(ImportError)
   DEFINE_IS_INSTANCE(Int)
+  DEFINE_IS_INSTANCE(Islice)
   DEFINE_IS_INSTANCE(List)
+  DEFINE_IS_INSTANCE(LruCacheWrapper)
   DEFINE_IS_INSTANCE(Mmap)
   DEFINE_IS_INSTANCE(Module)
+  DEFINE_IS_INSTANCE(Product)
   DEFINE_IS_INSTANCE(Property)
+  DEFINE_IS_INSTANCE(Repeat)
   DEFINE_IS_INSTANCE(Set)
   DEFINE_IS_INSTANCE(StaticMethod)
   DEFINE_IS_INSTANCE(StopIteration)
@@ -664,6 +752,7 @@ class Runtime {
   DEFINE_IS_INSTANCE(UnicodeError)
   DEFINE_IS_INSTANCE(UnicodeTranslateError)
   DEFINE_IS_INSTANCE(WeakRef)
+  DEFINE_IS_INSTANCE(ZipLongest)
 #undef DEFINE_IS_INSTANCE
 
   // User-defined subclasses of immediate types have no corresponding LayoutId,
@@ -887,9 +976,6 @@ class Runtime {
   void initializeSymbols(Thread* thread);
   void initializeTypes(Thread* thread);
 
-  void internSetGrow(Thread* thread);
-
-  void visitRuntimeRoots(PointerVisitor* visitor);
   void visitThreadRoots(PointerVisitor* visitor);
 
   word siphash24(View<byte> array);
@@ -927,6 +1013,8 @@ class Runtime {
 
   std::unique_ptr<Interpreter> interpreter_;
 
+  SamplingProfiler sampling_profiler_;
+
   // List of native instances which can be finalizable through tp_dealloc
   RawObject finalizable_references_ = NoneType::object();
 
@@ -962,6 +1050,7 @@ class Runtime {
   RawObject empty_mutable_bytes_ = NoneType::object();
   RawObject empty_slice_ = NoneType::object();
   RawObject empty_tuple_ = NoneType::object();
+  RawObject megamorphic_cache_ = NoneType::object();
   RawObject module_dunder_getattribute_ = NoneType::object();
   RawObject object_dunder_class_ = NoneType::object();
   RawObject object_dunder_eq_ = NoneType::object();
@@ -982,8 +1071,7 @@ class Runtime {
   RawObject profiling_return_ = NoneType::object();
 
   // Interned strings
-  RawObject interned_ = NoneType::object();
-  word interned_remaining_ = 0;
+  InternTable* interned_ = nullptr;
 
   // Modules
   RawObject modules_ = NoneType::object();
@@ -1009,6 +1097,10 @@ class Runtime {
   Thread* main_thread_ = nullptr;
   Mutex threads_mutex_;
 
+  // Held by the thread that stopped the other threads.
+  Mutex safepoint_mutex_;
+  bool stop_requested_ = false;
+
   RandomState random_state_;
 
   Symbols* symbols_;
@@ -1022,6 +1114,15 @@ class Runtime {
   // Non-moving memory for JIT compiled functions.
   Space* machine_code_ = nullptr;
 
+  word jit_threshold_ = 0;
+  word num_jit_tier_ups_ = 0;
+
+  word megamorphic_cache_hits_ = 0;
+  word megamorphic_cache_misses_ = 0;
+
+  // Inline cache counters of deleted threads. Guarded by `threads_mutex_`.
+  IcStats retired_ic_stats_ = {};
+
   static word next_module_index_;
 
   static wchar_t exec_prefix_[];
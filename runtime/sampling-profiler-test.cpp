@@ -0,0 +1,114 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "sampling-profiler.h"
+
+#include "gtest/gtest.h"
+
+#include "runtime.h"
+#include "test-utils.h"
+
+namespace py {
+namespace testing {
+
+using SamplingProfilerTest = RuntimeFixture;
+
+static bool samplesContainFunction(const List& samples, const Object& function,
+                                   word kind) {
+  for (word i = 0; i < samples.numItems(); i++) {
+    RawTuple sample = Tuple::cast(samples.at(i));
+    if (SmallInt::cast(sample.at(0)).value() != kind) continue;
+    RawTuple frames = Tuple::cast(sample.at(2));
+    for (word j = 0; j < frames.length(); j += 2) {
+      if (frames.at(j) == *function) return true;
+    }
+  }
+  return false;
+}
+
+TEST_F(SamplingProfilerTest, InterruptRecordsTimeSampleOnNextCall) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+def foo():
+  return 42
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Object foo(&scope, mainModuleAt(runtime_, "foo"));
+  SamplingProfiler* profiler = runtime_->samplingProfiler();
+  ASSERT_TRUE(profiler->start(thread_, 0, 0));
+  thread_->interrupt(Thread::kSample);
+  EXPECT_TRUE(isIntEqualsWord(Interpreter::call0(thread_, foo), 42));
+  EXPECT_TRUE(isIntEqualsWord(Interpreter::call0(thread_, foo), 42));
+  profiler->stop();
+
+  List samples(&scope, profiler->samples(thread_));
+  ASSERT_EQ(samples.numItems(), 1);
+  Tuple sample(&scope, samples.at(0));
+  EXPECT_TRUE(isIntEqualsWord(sample.at(0), 0));
+  EXPECT_TRUE(isIntEqualsWord(sample.at(1), 1));
+  EXPECT_TRUE(sample.at(2).isTuple());
+  profiler->clear();
+}
+
+TEST_F(SamplingProfilerTest, AllocationSamplesRecordAllocatingFunction) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+def foo():
+  result = []
+  for i in range(1000):
+    result.append([i, i, i])
+  return result
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Object foo(&scope, mainModuleAt(runtime_, "foo"));
+  SamplingProfiler* profiler = runtime_->samplingProfiler();
+  ASSERT_TRUE(profiler->start(thread_, 0, 4 * kKiB));
+  ASSERT_FALSE(Interpreter::call0(thread_, foo).isError());
+  profiler->stop();
+  AllocationBuffer* buffer = thread_->allocationBuffer();
+  EXPECT_EQ(buffer->limit, buffer->end);
+
+  runtime_->collectGarbage();
+  List samples(&scope, profiler->samples(thread_));
+  ASSERT_GT(samples.numItems(), 0);
+  Tuple sample(&scope, samples.at(0));
+  EXPECT_TRUE(isIntEqualsWord(sample.at(1), 4 * kKiB));
+  EXPECT_TRUE(samplesContainFunction(samples, foo, 1));
+  profiler->clear();
+}
+
+TEST_F(SamplingProfilerTest, FullBufferDropsOldestSamples) {
+  HandleScope scope(thread_);
+  SamplingProfiler* profiler = runtime_->samplingProfiler();
+  ASSERT_TRUE(profiler->start(thread_, 0, 0));
+  // Samples without any frames take up two words each.
+  word capacity = SamplingProfiler::kCapacity / 2;
+  for (word i = 0; i < capacity + 3; i++) {
+    profiler->sampleAllocation(thread_, i);
+  }
+  profiler->stop();
+  EXPECT_EQ(profiler->numDropped(), 3);
+
+  List samples(&scope, profiler->samples(thread_));
+  ASSERT_EQ(samples.numItems(), capacity);
+  Tuple oldest(&scope, samples.at(0));
+  EXPECT_TRUE(isIntEqualsWord(oldest.at(1), 3));
+  profiler->clear();
+  EXPECT_EQ(List::cast(profiler->samples(thread_)).numItems(), 0);
+}
+
+TEST_F(SamplingProfilerTest, SamplesOnlyWhileActive) {
+  HandleScope scope(thread_);
+  SamplingProfiler* profiler = runtime_->samplingProfiler();
+  EXPECT_FALSE(profiler->isActive());
+  profiler->sampleAllocation(thread_, 8);
+  ASSERT_TRUE(profiler->start(thread_, 0, 0));
+  EXPECT_TRUE(profiler->isActive());
+  profiler->sampleAllocation(thread_, 8);
+  profiler->stop();
+  EXPECT_FALSE(profiler->isActive());
+  List samples(&scope, profiler->samples(thread_));
+  EXPECT_EQ(samples.numItems(), 1);
+  profiler->clear();
+}
+
+}  // namespace testing
+}  // namespace py
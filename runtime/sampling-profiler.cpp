@@ -0,0 +1,174 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "sampling-profiler.h"
+
+#include <cstdlib>
+
+#include "bytecode.h"
+#include "frame.h"
+#include "handles.h"
+#include "os.h"
+#include "runtime.h"
+#include "thread.h"
+
+namespace py {
+
+// The thread the SIGPROF handler interrupts.
+static Thread* volatile sampled_thread = nullptr;
+
+// Each sample starts with a header word followed by a weight word and then a
+// function and bytecode offset for every recorded frame.
+static const word kSampleHeaderWords = 2;
+static const int kSampleKindBits = 1;
+
+static_assert(SamplingProfiler::kCapacity >=
+                  2 * (kSampleHeaderWords + SamplingProfiler::kMaxDepth * 2),
+              "buffer must hold at least two samples of maximum depth");
+
+static RawObject sampleHeader(SamplingProfiler::SampleKind kind, word depth) {
+  return SmallInt::fromWord(depth << kSampleKindBits |
+                            static_cast<word>(kind));
+}
+
+static word sampleDepth(RawObject header) {
+  return SmallInt::cast(header).value() >> kSampleKindBits;
+}
+
+static word sampleKind(RawObject header) {
+  return SmallInt::cast(header).value() & ((word{1} << kSampleKindBits) - 1);
+}
+
+SamplingProfiler::~SamplingProfiler() {
+  stop();
+  std::free(buffer_);
+}
+
+void SamplingProfiler::handleSignal(int) {
+  Thread* thread = sampled_thread;
+  if (thread != nullptr) {
+    thread->interrupt(Thread::kSample);
+  }
+}
+
+bool SamplingProfiler::start(Thread* thread, word interval_usec,
+                             word allocation_interval) {
+  DCHECK(interval_usec >= 0, "negative interval");
+  DCHECK(allocation_interval >= 0, "negative allocation interval");
+  stop();
+  if (buffer_ == nullptr) {
+    buffer_ = static_cast<RawObject*>(
+        std::malloc(kCapacity * sizeof(*buffer_)));
+    CHECK(buffer_ != nullptr, "out of memory");
+  }
+  thread_ = thread;
+  if (interval_usec > 0) {
+    sampled_thread = thread;
+    if (!OS::startProfilingTimer(interval_usec, handleSignal)) {
+      sampled_thread = nullptr;
+      thread_ = nullptr;
+      return false;
+    }
+    timer_started_ = true;
+  }
+  thread->runtime()->heap()->setAllocationSampleInterval(allocation_interval);
+  return true;
+}
+
+void SamplingProfiler::stop() {
+  if (thread_ == nullptr) return;
+  if (timer_started_) {
+    OS::stopProfilingTimer();
+    sampled_thread = nullptr;
+    timer_started_ = false;
+  }
+  thread_->clearInterrupt(Thread::kSample);
+  thread_->runtime()->heap()->setAllocationSampleInterval(0);
+  thread_ = nullptr;
+}
+
+void SamplingProfiler::sampleTime(Thread* thread) {
+  thread->clearInterrupt(Thread::kSample);
+  if (thread != thread_) return;
+  record(thread, SampleKind::kTime, 1);
+}
+
+void SamplingProfiler::sampleAllocation(Thread* thread, word bytes) {
+  if (thread != thread_) return;
+  record(thread, SampleKind::kAllocation, bytes);
+}
+
+void SamplingProfiler::record(Thread* thread, SampleKind kind, word weight) {
+  if (paused_) return;
+  word depth = 0;
+  for (Frame* frame = thread->currentFrame();
+       !frame->isSentinel() && depth < kMaxDepth;
+       frame = frame->previousFrame()) {
+    depth++;
+  }
+  word size = kSampleHeaderWords + depth * 2;
+  while (head_ + size - tail_ > kCapacity) {
+    tail_ += kSampleHeaderWords + sampleDepth(*slotAt(tail_)) * 2;
+    num_dropped_++;
+  }
+
+  word index = head_;
+  *slotAt(index++) = sampleHeader(kind, depth);
+  *slotAt(index++) = SmallInt::fromWord(weight);
+  Frame* frame = thread->currentFrame();
+  for (word i = 0; i < depth; i++, frame = frame->previousFrame()) {
+    word pc = 0;
+    if (!frame->isNative()) {
+      pc = Utils::maximum(frame->virtualPC() - kCodeUnitSize, word{0});
+    }
+    *slotAt(index++) = frame->function();
+    *slotAt(index++) = SmallInt::fromWord(pc);
+  }
+  head_ = index;
+}
+
+RawObject SamplingProfiler::samples(Thread* thread) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  List result(&scope, runtime->newList());
+  // Allocating below may trigger allocation samples, which must not overwrite
+  // the samples being read.
+  bool paused = paused_;
+  paused_ = true;
+  Object kind(&scope, NoneType::object());
+  Object weight(&scope, NoneType::object());
+  Object frames(&scope, NoneType::object());
+  Object sample(&scope, NoneType::object());
+  for (word index = tail_; index < head_;) {
+    RawObject header = *slotAt(index);
+    word depth = sampleDepth(header);
+    kind = SmallInt::fromWord(sampleKind(header));
+    weight = *slotAt(index + 1);
+    index += kSampleHeaderWords;
+    if (depth == 0) {
+      frames = runtime->emptyTuple();
+    } else {
+      MutableTuple frames_tuple(&scope, runtime->newMutableTuple(depth * 2));
+      for (word i = 0; i < depth * 2; i++) {
+        frames_tuple.atPut(i, *slotAt(index++));
+      }
+      frames = frames_tuple.becomeImmutable();
+    }
+    sample = runtime->newTupleWith3(kind, weight, frames);
+    runtime->listAdd(thread, result, sample);
+  }
+  paused_ = paused;
+  return *result;
+}
+
+void SamplingProfiler::clear() {
+  head_ = 0;
+  tail_ = 0;
+  num_dropped_ = 0;
+}
+
+void SamplingProfiler::visitRoots(PointerVisitor* visitor) {
+  for (word index = tail_; index < head_; index++) {
+    visitor->visitPointer(slotAt(index), PointerKind::kRuntime);
+  }
+}
+
+}  // namespace py
@@ -0,0 +1,80 @@
+/* Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com) */
+#pragma once
+
+#include "globals.h"
+#include "objects.h"
+#include "visitor.h"
+
+namespace py {
+
+class Thread;
+
+// Periodically records the Python stack of a thread into a fixed size ring
+// buffer. Unlike the opcode counting hooks in `profiling.h` this never calls
+// back into Python, which keeps it cheap enough to leave running.
+//
+// A SIGPROF timer only raises an interrupt on the sampled thread; the stack is
+// recorded when the thread handles the interrupt on its next call. Allocation
+// samples are taken by the heap every time roughly `allocation_interval` bytes
+// were allocated. In both cases the buffer is only ever written by the sampled
+// thread itself, so no locking is required and recording never allocates. When
+// the buffer is full the oldest samples are dropped.
+class SamplingProfiler {
+ public:
+  enum class SampleKind : word {
+    kTime = 0,
+    kAllocation = 1,
+  };
+
+  // Frames beyond this depth are not recorded; the innermost ones are kept.
+  static const word kMaxDepth = 128;
+
+  // Number of words in the ring buffer. Must be a power of two.
+  static const word kCapacity = word{1} << 18;
+
+  SamplingProfiler() = default;
+  ~SamplingProfiler();
+
+  bool isActive() { return thread_ != nullptr; }
+
+  // Starts sampling `thread` every `interval_usec` microseconds of CPU time
+  // and every `allocation_interval` allocated bytes. Either interval may be 0
+  // to disable that kind of sampling. Returns false if the timer could not be
+  // set up.
+  bool start(Thread* thread, word interval_usec, word allocation_interval);
+  void stop();
+
+  void sampleTime(Thread* thread);
+  void sampleAllocation(Thread* thread, word bytes);
+
+  // Returns a list with one `(kind, weight, frames)` tuple per buffered sample,
+  // oldest first. `frames` alternates between a function and the bytecode
+  // offset executing in it, starting with the innermost frame.
+  RawObject samples(Thread* thread);
+  void clear();
+
+  // Number of samples dropped because the buffer was full.
+  word numDropped() { return num_dropped_; }
+
+  void visitRoots(PointerVisitor* visitor);
+
+ private:
+  static void handleSignal(int signum);
+
+  void record(Thread* thread, SampleKind kind, word weight);
+  RawObject* slotAt(word index) { return &buffer_[index & (kCapacity - 1)]; }
+
+  RawObject* buffer_ = nullptr;
+  // Index one past the newest sample; grows monotonically.
+  word head_ = 0;
+  // Index of the oldest sample; grows monotonically.
+  word tail_ = 0;
+  word num_dropped_ = 0;
+  bool timer_started_ = false;
+  bool paused_ = false;
+  Thread* thread_ = nullptr;
+
+  DISALLOW_COPY_AND_ASSIGN(SamplingProfiler);
+};
+
+}  // namespace py
@@ -0,0 +1,71 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "benchmark/benchmark.h"
+
+#include "benchmark-utils.h"
+#include "handles.h"
+#include "runtime.h"
+
+namespace py {
+namespace testing {
+
+using ScavengerBenchmark = RuntimeBenchmark;
+
+// Builds a list of `num_objects` small object graphs that stay alive across
+// collections: a tuple pointing to a string, a float and a short list.
+static RawObject newSyntheticHeap(Thread* thread, word num_objects) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  List result(&scope, runtime->newList());
+  Object str(&scope, NoneType::object());
+  Object number(&scope, NoneType::object());
+  List list(&scope, runtime->newList());
+  Object tuple(&scope, NoneType::object());
+  for (word i = 0; i < num_objects; i++) {
+    str = runtime->newStrFromFmt("synthetic heap object %w", i);
+    number = runtime->newFloat(i);
+    list = runtime->newList();
+    runtime->listAdd(thread, list, str);
+    runtime->listAdd(thread, list, number);
+    tuple = runtime->newTupleWith3(str, number, list);
+    runtime->listAdd(thread, result, tuple);
+  }
+  return *result;
+}
+
+BENCHMARK_DEFINE_F(ScavengerBenchmark, CollectGarbage)
+(benchmark::State& state) {
+  HandleScope scope(thread_);
+  word num_objects = state.range(0);
+  List live(&scope, newSyntheticHeap(thread_, num_objects));
+  for (auto _ : state) {
+    runtime_->collectGarbage();
+  }
+  CHECK(live.numItems() == num_objects, "live objects were lost");
+  state.SetItemsProcessed(state.iterations() * num_objects);
+}
+BENCHMARK_REGISTER_F(ScavengerBenchmark, CollectGarbage)
+    ->Arg(1024)
+    ->Arg(64 * 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+// Measures a young collection that promotes a freshly allocated object graph.
+BENCHMARK_DEFINE_F(ScavengerBenchmark, CollectYoungGarbage)
+(benchmark::State& state) {
+  HandleScope scope(thread_);
+  word num_objects = state.range(0);
+  List live(&scope, runtime_->newList());
+  for (auto _ : state) {
+    state.PauseTiming();
+    live = newSyntheticHeap(thread_, num_objects);
+    state.ResumeTiming();
+    runtime_->collectYoungGarbage();
+  }
+  state.SetItemsProcessed(state.iterations() * num_objects);
+}
+BENCHMARK_REGISTER_F(ScavengerBenchmark, CollectYoungGarbage)
+    ->Arg(1024)
+    ->Arg(16 * 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace testing
+}  // namespace py
@@ -1,6 +1,8 @@
 // Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
 #include "scavenger.h"
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "builtins-module.h"
@@ -434,5 +436,264 @@ class C:
   EXPECT_EQ(c.instanceLayout(), runtime_->layoutAt(c_layout_id));
 }
 
+TEST_F(ScavengerTest, CollectYoungGarbagePromotesObjectsSurvivingTwice) {
+  HandleScope scope(thread_);
+  Tuple tuple(&scope, newTupleWithNone(10));
+  Heap* heap = runtime_->heap();
+  ASSERT_TRUE(heap->space()->isAllocated(tuple.address()));
+
+  runtime_->collectYoungGarbage();
+  EXPECT_TRUE(heap->space()->isAllocated(tuple.address()));
+  EXPECT_FALSE(heap->isOld(tuple.address()));
+
+  runtime_->collectYoungGarbage();
+  EXPECT_TRUE(heap->isOld(tuple.address()));
+  EXPECT_EQ(tuple.at(0), NoneType::object());
+}
+
+TEST_F(ScavengerTest, CollectGarbageTenuresSurvivors) {
+  HandleScope scope(thread_);
+  Tuple tuple(&scope, newTupleWithNone(10));
+  runtime_->collectGarbage();
+  EXPECT_TRUE(runtime_->heap()->isOld(tuple.address()));
+  EXPECT_EQ(runtime_->heap()->ageMark(), runtime_->heap()->space()->start());
+}
+
+TEST_F(ScavengerTest,
+       CollectYoungGarbagePreservesYoungObjectReferencedFromOldObject) {
+  HandleScope scope(thread_);
+  MutableTuple old_tuple(&scope, runtime_->newMutableTuple(3));
+  old_tuple.fill(NoneType::object());
+  runtime_->collectGarbage();
+  ASSERT_TRUE(runtime_->heap()->isOld(old_tuple.address()));
+  {
+    Object three(&scope, SmallInt::fromWord(3));
+    Object four(&scope, SmallInt::fromWord(4));
+    Tuple young(&scope, runtime_->newTupleWith2(three, four));
+    ASSERT_FALSE(runtime_->heap()->isOld(young.address()));
+    old_tuple.atPut(1, *young);
+  }
+
+  runtime_->collectYoungGarbage();
+  Object result(&scope, old_tuple.at(1));
+  ASSERT_TRUE(result.isTuple());
+  EXPECT_TRUE(runtime_->heap()->space()->isAllocated(
+      HeapObject::cast(*result).address()));
+  EXPECT_TRUE(isIntEqualsWord(Tuple::cast(*result).at(0), 3));
+  EXPECT_TRUE(isIntEqualsWord(Tuple::cast(*result).at(1), 4));
+
+  // The card stays dirty while the old object references a young object.
+  runtime_->collectYoungGarbage();
+  result = old_tuple.at(1);
+  ASSERT_TRUE(result.isTuple());
+  EXPECT_TRUE(runtime_->heap()->isOld(HeapObject::cast(*result).address()));
+  EXPECT_TRUE(isIntEqualsWord(Tuple::cast(*result).at(1), 4));
+}
+
+TEST_F(ScavengerTest, CollectYoungGarbagePreservesInstanceAttributeValue) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  pass
+c = C()
+)")
+                   .isError());
+  runtime_->collectGarbage();
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+def store(obj):
+  obj.value = [1, 2, 3]
+store(c)
+)")
+                   .isError());
+  runtime_->collectYoungGarbage();
+  ASSERT_FALSE(runFromCStr(runtime_, "result = c.value[2]").isError());
+  EXPECT_TRUE(isIntEqualsWord(mainModuleAt(runtime_, "result"), 3));
+}
+
+TEST_F(ScavengerTest, CollectYoungGarbageClearsWeakReferenceToDeadObject) {
+  HandleScope scope(thread_);
+  Object ref(&scope, NoneType::object());
+  {
+    Tuple array(&scope, newTupleWithNone(10));
+    ref = runtime_->newWeakRef(thread_, array);
+  }
+  runtime_->collectYoungGarbage();
+  EXPECT_EQ(WeakRef::cast(*ref).referent(), NoneType::object());
+}
+
+TEST_F(ScavengerTest, CollectYoungGarbagePreservesOldWeakReferent) {
+  HandleScope scope(thread_);
+  Tuple array(&scope, newTupleWithNone(10));
+  runtime_->collectGarbage();
+  WeakRef ref(&scope, runtime_->newWeakRef(thread_, array));
+  runtime_->collectYoungGarbage();
+  EXPECT_EQ(ref.referent(), *array);
+}
+
+// A random object graph for the parallel scavenger tests. Every node is a
+// MutableTuple holding its index, a Float and references to other nodes.
+// Some nodes are too large for a scavenger allocation buffer.
+class RandomGraph {
+ public:
+  RandomGraph(Thread* thread, word num_nodes, uword seed);
+
+  // Stores a new young Float in every surviving node.
+  void replaceValues();
+
+  // Checks that exactly the nodes reachable from the roots survived and that
+  // their contents are intact.
+  void expectReachableNodesSurvived(double value_offset);
+
+ private:
+  word random(word limit) {
+    seed_ = seed_ * 6364136223846793005u + 1442695040888963407u;
+    return static_cast<word>(seed_ >> 33) % limit;
+  }
+
+  Thread* thread_;
+  HandleScope scope_;
+  // Keeps the root nodes alive.
+  MutableTuple roots_;
+  MutableTuple weakrefs_;
+  std::vector<std::vector<word>> edges_;
+  std::vector<bool> reachable_;
+  uword seed_;
+};
+
+RandomGraph::RandomGraph(Thread* thread, word num_nodes, uword seed)
+    : thread_(thread),
+      scope_(thread),
+      roots_(&scope_, thread->runtime()->newMutableTuple(8)),
+      weakrefs_(&scope_, thread->runtime()->newMutableTuple(num_nodes)),
+      edges_(num_nodes),
+      reachable_(num_nodes),
+      seed_(seed) {
+  Runtime* runtime = thread->runtime();
+  HandleScope scope(thread);
+  MutableTuple nodes(&scope, runtime->newMutableTuple(num_nodes));
+  Object value(&scope, NoneType::object());
+  for (word i = 0; i < num_nodes; i++) {
+    word num_edges = (i % 50 == 0) ? 1500 : random(5);
+    for (word j = 0; j < num_edges; j++) {
+      edges_[i].push_back(random(num_nodes));
+    }
+    MutableTuple node(&scope, runtime->newMutableTuple(2 + num_edges));
+    node.fill(NoneType::object());
+    node.atPut(0, SmallInt::fromWord(i));
+    value = runtime->newFloat(i);
+    node.atPut(1, *value);
+    nodes.atPut(i, *node);
+    weakrefs_.atPut(i, runtime->newWeakRef(thread, node));
+  }
+  for (word i = 0; i < num_nodes; i++) {
+    MutableTuple node(&scope, nodes.at(i));
+    for (size_t j = 0; j < edges_[i].size(); j++) {
+      node.atPut(2 + j, nodes.at(edges_[i][j]));
+    }
+  }
+  std::vector<word> work;
+  for (word i = 0; i < roots_.length(); i++) {
+    word root = random(num_nodes);
+    roots_.atPut(i, nodes.at(root));
+    work.push_back(root);
+  }
+  while (!work.empty()) {
+    word index = work.back();
+    work.pop_back();
+    if (reachable_[index]) continue;
+    reachable_[index] = true;
+    for (word target : edges_[index]) {
+      work.push_back(target);
+    }
+  }
+}
+
+void RandomGraph::replaceValues() {
+  Runtime* runtime = thread_->runtime();
+  HandleScope scope(thread_);
+  Object value(&scope, NoneType::object());
+  for (word i = 0, length = weakrefs_.length(); i < length; i++) {
+    RawObject node = WeakRef::cast(weakrefs_.at(i)).referent();
+    if (node.isNoneType()) continue;
+    value = runtime->newFloat(i + 0.5);
+    MutableTuple::cast(WeakRef::cast(weakrefs_.at(i)).referent())
+        .atPut(1, *value);
+  }
+}
+
+void RandomGraph::expectReachableNodesSurvived(double value_offset) {
+  for (word i = 0, length = weakrefs_.length(); i < length; i++) {
+    RawObject referent = WeakRef::cast(weakrefs_.at(i)).referent();
+    ASSERT_EQ(referent.isNoneType(), !reachable_[i]) << "node " << i;
+    if (referent.isNoneType()) continue;
+    RawMutableTuple node = MutableTuple::cast(referent);
+    EXPECT_TRUE(isIntEqualsWord(node.at(0), i));
+    EXPECT_EQ(Float::cast(node.at(1)).value(), i + value_offset);
+    ASSERT_EQ(node.length(), static_cast<word>(2 + edges_[i].size()));
+    for (size_t j = 0; j < edges_[i].size(); j++) {
+      RawObject target = weakrefs_.at(edges_[i][j]);
+      EXPECT_EQ(node.at(2 + j), WeakRef::cast(target).referent());
+    }
+  }
+}
+
+TEST_F(ScavengerTest, ParallelCollectGarbagePreservesReachability) {
+  for (word num_workers = 1; num_workers <= 4; num_workers++) {
+    runtime_->heap()->setNumScavengerWorkers(num_workers);
+    RandomGraph graph(thread_, 3000, num_workers);
+    runtime_->collectGarbage();
+    graph.expectReachableNodesSurvived(0);
+    runtime_->collectGarbage();
+    graph.expectReachableNodesSurvived(0);
+  }
+}
+
+TEST_F(ScavengerTest, ParallelCollectYoungGarbagePreservesReachability) {
+  for (word num_workers = 1; num_workers <= 4; num_workers++) {
+    runtime_->heap()->setNumScavengerWorkers(num_workers);
+    RandomGraph graph(thread_, 3000, num_workers);
+    runtime_->collectYoungGarbage();
+    graph.expectReachableNodesSurvived(0);
+    // The surviving nodes are promoted by the second collection.
+    runtime_->collectYoungGarbage();
+    graph.expectReachableNodesSurvived(0);
+    // Old nodes referencing young objects are only found via dirty cards.
+    graph.replaceValues();
+    runtime_->collectYoungGarbage();
+    graph.expectReachableNodesSurvived(0.5);
+    runtime_->collectYoungGarbage();
+    graph.expectReachableNodesSurvived(0.5);
+  }
+}
+
+TEST_F(ScavengerTest, ParallelCollectGarbageCollectsDeadLayout) {
+  runtime_->heap()->setNumScavengerWorkers(4);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  pass
+class D:
+  pass
+d = [D() for i in range(1000)]
+)")
+                   .isError());
+
+  HandleScope scope(thread_);
+  LayoutId c_layout_id;
+  LayoutId d_layout_id;
+  {
+    Type c(&scope, mainModuleAt(runtime_, "C"));
+    c_layout_id = Layout::cast(c.instanceLayout()).id();
+    Type d(&scope, mainModuleAt(runtime_, "D"));
+    d_layout_id = Layout::cast(d.instanceLayout()).id();
+  }
+
+  ASSERT_FALSE(runFromCStr(runtime_, "del C, D").isError());
+  runtime_->collectGarbage();
+  EXPECT_TRUE(runtime_->layoutAt(c_layout_id) == SmallInt::fromWord(0));
+  ASSERT_TRUE(runtime_->layoutAt(d_layout_id).isLayout());
+  List d(&scope, mainModuleAt(runtime_, "d"));
+  Object first(&scope, d.at(0));
+  EXPECT_EQ(first.layoutId(), d_layout_id);
+}
+
 }  // namespace testing
 }  // namespace py
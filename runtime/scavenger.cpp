@@ -1,41 +1,116 @@
 // Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
 #include "scavenger.h"
 
+#include <atomic>
 #include <cstring>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "capi.h"
+#include "mutex.h"
 #include "runtime.h"
 
 namespace py {
 
+class ScavengerWorker;
+
 class Scavenger : public PointerVisitor {
  public:
   explicit Scavenger(Runtime* runtime);
 
   bool isWhiteObject(RawHeapObject object);
 
+  bool isCollectingOld() { return old_from_ != nullptr; }
+
   RawObject scavenge();
 
+  RawObject scavengeYoung();
+
   RawObject scavengeIntoImmortal();
 
   void visitPointer(RawObject* pointer, PointerKind kind) override;
 
  private:
+  friend class ScavengerWorker;
+
   enum class SaveLocation { kImmortalHeap, kNewSpace };
 
+  // Objects in [start, end) of `space` that were copied but not scanned yet.
+  struct GrayRange {
+    Space* space;
+    uword start;
+    uword end;
+  };
+
   void collect(SaveLocation);
 
+  // Returns true if the object at `address` is evacuated by this collection.
+  bool isCollected(uword address) {
+    return from_->contains(address) ||
+           (old_from_ != nullptr && old_from_->contains(address));
+  }
+
+  // Returns true if objects that survived the previous scavenge are moved
+  // into the old generation instead of `to_`.
+  bool promotes() { return old_ != nullptr && old_ != to_; }
+
+  // Returns true if objects copied into `space` must be recorded with
+  // `Space::recordObjectStart()`.
+  bool recordsObjectStarts(Space* space) { return space == old_; }
+
+  // Where objects reachable from gray objects in `space` are copied to.
+  SaveLocation saveLocationFor(Space* space) {
+    return space == immortal_ ? SaveLocation::kImmortalHeap : save_location_;
+  }
+
+  // Keeps the card of `slot` dirty if it is an old slot referencing a young
+  // object after the scavenge.
+  void recordSlot(uword slot, RawObject value);
+
   void scavengePointer(RawObject* pointer);
 
   RawObject transport(RawObject old_object);
 
+  // Returns the new location of a weakly referenced object or SmallInt 0 if
+  // the object did not survive.
+  RawObject weakReferent(RawObject object);
+
   void processDelayedReferences();
 
+  void processDirtyCards();
+
+  void processDirtyCard(word card, uword limit, PointerVisitor* visitor);
+
   void processGrayObjects();
 
   uword processGrayObjectsIn(Space*, uword);
 
+  // Parallel collection. With more than one worker all objects are copied by
+  // `ScavengerWorker`s, which own the gray objects in their allocation
+  // buffers and hand out gray ranges to idle workers.
+  bool isParallel() { return !workers_.empty(); }
+
+  void startWorkers();
+
+  void stopWorkers();
+
+  void processGrayObjectsInParallel();
+
+  bool claimDirtyCards(word* first, word* last);
+
+  // Returns true if there are more idle workers than gray ranges for them.
+  bool needsMoreGrayRanges() {
+    return num_idle_workers_.load(std::memory_order_relaxed) >
+           num_gray_ranges_.load(std::memory_order_relaxed);
+  }
+
+  void pushGrayRange(GrayRange range);
+
+  // Blocks until there is a gray range to scan and returns true, or returns
+  // false once all workers are out of work.
+  bool popGrayRange(GrayRange* range);
+
   void processLayouts();
 
   void compactLayoutTypeTransitions();
@@ -44,14 +119,90 @@ class Scavenger : public PointerVisitor {
   Heap* heap_;
   Space* immortal_;
   Space* from_;
+  // The old generation when it is evacuated as well, nullptr otherwise.
+  Space* old_from_;
+  // Where promoted objects are copied to; nullptr when nothing is promoted.
+  Space* old_;
   Space* to_;
+  uword age_mark_;
   uword to_gray_line_;
+  uword old_gray_line_;
   uword immortal_gray_line_;
   RawMutableTuple layouts_;
   RawMutableTuple layout_type_transitions_;
   RawObject delayed_references_;
   RawObject delayed_callbacks_;
   SaveLocation save_location_;
+
+  word num_workers_;
+  std::vector<std::unique_ptr<ScavengerWorker>> workers_;
+  Mutex gray_ranges_mutex_;
+  std::vector<GrayRange> gray_ranges_;
+  std::atomic<word> num_idle_workers_;
+  std::atomic<word> num_gray_ranges_;
+  std::atomic<word> next_dirty_card_;
+  word last_dirty_card_;
+};
+
+// Copies objects on behalf of a parallel `Scavenger`. Every worker copies
+// into local allocation buffers (LABs) carved out of the destination spaces
+// and scans the objects it copied itself. Objects are forwarded with a
+// compare-and-swap on their header so that each one is copied exactly once
+// even when several workers find it at the same time.
+class ScavengerWorker : public PointerVisitor {
+ public:
+  explicit ScavengerWorker(Scavenger* scavenger);
+
+  void visitPointer(RawObject* pointer, PointerKind kind) override;
+
+  void scavengePointer(RawObject* pointer);
+
+  RawObject transport(RawObject old_object);
+
+  void processGrayRange(Scavenger::GrayRange range,
+                        Scavenger::SaveLocation location);
+
+  // Processes dirty cards and gray objects until no worker has any left.
+  void run();
+
+  // Returns the unused ends of the allocation buffers to their spaces.
+  void releaseLabs();
+
+  RawObject takeDelayedReferences();
+
+ private:
+  struct Lab {
+    Space* space;
+    // Gray objects are in [scan, fill), free memory is in [fill, end).
+    uword scan;
+    uword fill;
+    uword end;
+  };
+
+  bool allocate(Lab* lab, word size, uword* address, bool* in_lab);
+
+  void undoAllocation(Lab* lab, uword address, word size, bool in_lab);
+
+  void releaseLab(Lab* lab);
+
+  bool isWhiteObject(RawHeapObject object);
+
+  void processDirtyCards();
+
+  bool processLabs();
+
+  void scavengeLayout(LayoutId layout_id);
+
+  static const word kLabSize = 32 * kKiB;
+  // Gray ranges smaller than this are not worth handing to another worker.
+  static const word kMinSharedRangeSize = 4 * kKiB;
+
+  Scavenger* scavenger_;
+  Lab immortal_lab_;
+  Lab old_lab_;
+  Lab to_lab_;
+  RawObject delayed_references_;
+  Scavenger::SaveLocation save_location_;
 };
 
 Scavenger::Scavenger(Runtime* runtime)
@@ -59,13 +210,21 @@ Scavenger::Scavenger(Runtime* runtime)
       heap_(runtime->heap()),
       immortal_(heap_->immortal()),
       from_(heap_->space()),
+      old_from_(nullptr),
+      old_(nullptr),
       to_(nullptr),
+      age_mark_(heap_->ageMark()),
       layouts_(MutableTuple::cast(runtime->layouts())),
       layout_type_transitions_(
           MutableTuple::cast(runtime->layoutTypeTransitions())),
       delayed_references_(NoneType::object()),
       delayed_callbacks_(NoneType::object()),
-      save_location_(SaveLocation::kNewSpace) {}
+      save_location_(SaveLocation::kNewSpace),
+      num_workers_(heap_->numScavengerWorkers()),
+      num_idle_workers_(0),
+      num_gray_ranges_(0),
+      next_dirty_card_(0),
+      last_dirty_card_(-1) {}
 
 void Scavenger::collect(SaveLocation copy_into) {
   save_location_ = copy_into;
@@ -76,12 +235,28 @@ void Scavenger::collect(SaveLocation copy_into) {
   // black area extends from the start to the gray line
   to_gray_line_ = to_->start();
   immortal_gray_line_ = immortal_->start();
+  // Objects promoted during this collection are appended to the old space;
+  // everything below the current fill is only scanned through dirty cards.
+  old_gray_line_ = promotes() ? old_->fill() : 0;
+
+  if (num_workers_ > 1) {
+    startWorkers();
+  }
 
   // We touch all roots.  If we find code objects we will
   // move them into the immortal partition.
-  immortal_gray_line_ = processGrayObjectsIn(immortal_, immortal_gray_line_);
+  if (isParallel()) {
+    workers_[0]->processGrayRange({immortal_, immortal_->start(),
+                                   immortal_->fill()},
+                                  save_location_);
+  } else {
+    immortal_gray_line_ = processGrayObjectsIn(immortal_, immortal_gray_line_);
+  }
   runtime_->visitRootsWithoutApiHandles(this);
-  visitIncrementedApiHandles(runtime_, this);
+  visitIncrementedApiHandles(runtime_, this, this);
+  if (old_gray_line_ != 0) {
+    processDirtyCards();
+  }
 
   // Gray objects in the immortal space are code objects
   // All objects in the to_ space are gray. We first want to follow
@@ -101,6 +276,10 @@ void Scavenger::collect(SaveLocation copy_into) {
 
   // One last cleanup
   processGrayObjects();
+
+  if (isParallel()) {
+    stopWorkers();
+  }
 }
 
 RawObject Scavenger::scavenge() {
@@ -109,24 +288,61 @@ RawObject Scavenger::scavenge() {
   // Nothing else should be allocating during a GC.
   heap_->setSpace(nullptr);
 
-  // Set up a new space for reachable, non-immortal objects
-  to_ = new Space(from_->size());
+  // Evacuate both generations into a new old space. Everything that survives
+  // a full collection is tenured.
+  old_from_ = heap_->old();
+  word old_size = old_from_->size();
+  word live_upper_bound = (old_from_->fill() - old_from_->start()) +
+                          (from_->fill() - from_->start());
+  to_ = new Space(Utils::maximum(old_size, live_upper_bound));
+  old_ = to_;
 
   // Collect and copy objects into to_
   collect(SaveLocation::kNewSpace);
 
-  // Swap the new space and and delete the old mortal heap
+  // Start with a fresh, empty young generation
+  Space* space = new Space(from_->size());
+  heap_->setSpace(space);
+  heap_->setAgeMark(space->start());
+  heap_->setOld(to_);
+  DCHECK(heap_->verify(), "Heap failed to verify after GC");
+  delete from_;
+  delete old_from_;
+  return delayed_callbacks_;
+}
+
+RawObject Scavenger::scavengeYoung() {
+  if (heap_->shouldCollectOld()) {
+    return scavenge();
+  }
+  DCHECK(heap_->verify(), "Heap failed to verify before GC");
+
+  // Nothing else should be allocating during a GC.
+  heap_->setSpace(nullptr);
+
+  // Set up a new space for the survivors. Objects that survived the previous
+  // scavenge are promoted into the old generation instead.
+  to_ = new Space(from_->size());
+  old_ = heap_->old();
+
+  // Collect and copy objects into to_ and old_
+  collect(SaveLocation::kNewSpace);
+
+  // Everything in to_ has now survived a scavenge.
   heap_->setSpace(to_);
+  heap_->setAgeMark(to_->fill());
   DCHECK(heap_->verify(), "Heap failed to verify after GC");
   delete from_;
   return delayed_callbacks_;
 }
 
 RawObject Scavenger::scavengeIntoImmortal() {
+  old_from_ = heap_->old();
   // Make sure we have enough room
   // TODO(T89880293) We can try compacting first if there isn't enough room
   uword immortal_available = immortal_->end() - immortal_->fill();
-  uword heap_used = from_->fill() - from_->start();
+  uword heap_used = (from_->fill() - from_->start()) +
+                    (old_from_->fill() - old_from_->start());
   DCHECK(heap_used < immortal_available,
          "Immortal heap partition may not be big enough");
 
@@ -138,52 +354,130 @@ RawObject Scavenger::scavengeIntoImmortal() {
   // Collect and copy objects into immortal partition
   collect(SaveLocation::kImmortalHeap);
 
-  // Start with a fresh, empty heap
-  heap_->setSpace(new Space(from_->size()));
+  // Start with fresh, empty generations
+  Space* space = new Space(from_->size());
+  heap_->setSpace(space);
+  heap_->setAgeMark(space->start());
+  heap_->setOld(new Space(old_from_->size()));
   DCHECK(heap_->verify(), "Heap failed to verify after GC");
   delete from_;
+  delete old_from_;
   return delayed_callbacks_;
 }
 
 void Scavenger::visitPointer(RawObject* pointer, PointerKind) {
+  if (isParallel()) {
+    workers_[0]->scavengePointer(pointer);
+    return;
+  }
   scavengePointer(pointer);
 }
 
+void Scavenger::recordSlot(uword slot, RawObject value) {
+  if (promotes() && old_->contains(slot) &&
+      to_->contains(HeapObject::cast(value).address())) {
+    Space::markCard(slot);
+  }
+}
+
 void Scavenger::scavengePointer(RawObject* pointer) {
   if (!(*pointer).isHeapObject()) {
     return;
   }
   RawHeapObject object = HeapObject::cast(*pointer);
-  if (!from_->contains(object.address())) {
+  if (!isCollected(object.address())) {
     DCHECK(object.header().isHeader(), "object must have a header");
-    DCHECK(
-        to_->contains(object.address()) || heap_->isImmortal(object.address()),
-        "object must be in 'from' or 'to' or 'immortal'space");
-  } else if (object.isForwarding()) {
+    DCHECK(to_->contains(object.address()) ||
+               heap_->isImmortal(object.address()) ||
+               heap_->isOld(object.address()),
+           "object must be in 'from' or 'to' or 'old' or 'immortal' space");
+    return;
+  }
+  if (object.isForwarding()) {
     DCHECK(to_->contains(HeapObject::cast(object.forward()).address()) ||
-               heap_->isImmortal(HeapObject::cast(object.forward()).address()),
-           "transported object must be located in 'to' or 'immortal' space");
+               heap_->isImmortal(HeapObject::cast(object.forward()).address()) ||
+               heap_->isOld(HeapObject::cast(object.forward()).address()),
+           "transported object must be located in 'to' or 'old' or "
+           "'immortal' space");
     *pointer = object.forward();
   } else {
     *pointer = transport(object);
   }
+  // Old objects that still reference young objects after the scavenge must
+  // keep their card dirty for the next one.
+  recordSlot(reinterpret_cast<uword>(pointer), *pointer);
 }
 
 bool Scavenger::isWhiteObject(RawHeapObject object) {
   DCHECK(to_ == immortal_ || !to_->contains(object.address()),
          "must not test objects that have already been visited");
-  return !object.isForwarding();
+  return isCollected(object.address()) && !object.isForwarding();
+}
+
+// Scan the parts of the old generation that were written to since the last
+// scavenge. Every reference found there is treated as a strong root.
+void Scavenger::processDirtyCards() {
+  uword limit = old_gray_line_;
+  if (limit == old_->start()) return;
+  word last = Space::cardIndex(limit - 1);
+  if (isParallel()) {
+    // The workers claim the cards once they start processing gray objects.
+    next_dirty_card_ = old_->firstCard();
+    last_dirty_card_ = last;
+    return;
+  }
+  for (word card = old_->firstCard(); card <= last; card++) {
+    if (!old_->isCardDirty(card)) continue;
+    old_->clearCard(card);
+    processDirtyCard(card, limit, this);
+  }
+}
+
+void Scavenger::processDirtyCard(word card, uword limit,
+                                 PointerVisitor* visitor) {
+  uword card_start = old_->cardStart(card);
+  uword card_end = Utils::minimum(card_start + Space::kCardSize, limit);
+  uword scan = old_->objectStartForCard(card);
+  while (scan < card_end) {
+    if (!(*reinterpret_cast<RawObject*>(scan)).isHeader()) {
+      // Skip immediate values for alignment padding or header overflow.
+      scan += kPointerSize;
+      continue;
+    }
+    RawHeapObject object = HeapObject::fromAddress(scan + RawHeader::kSize);
+    uword end = object.baseAddress() + object.size();
+    if (object.isRoot()) {
+      // Only visit the part of the object that is covered by this card.
+      uword first = Utils::maximum(scan + RawHeader::kSize, card_start);
+      uword last = Utils::minimum(end, card_end);
+      for (uword slot = first; slot < last; slot += kPointerSize) {
+        visitor->visitPointer(reinterpret_cast<RawObject*>(slot),
+                              PointerKind::kUnknown);
+      }
+    }
+    scan = end;
+  }
 }
 
 void Scavenger::processGrayObjects() {
+  if (isParallel()) {
+    processGrayObjectsInParallel();
+    return;
+  }
   SaveLocation saved = save_location_;
   while (immortal_gray_line_ < immortal_->fill() ||
-         to_gray_line_ < to_->fill()) {
+         to_gray_line_ < to_->fill() ||
+         (old_gray_line_ != 0 && old_gray_line_ < old_->fill())) {
     // Gray immortal code objects and all reachables
     save_location_ = SaveLocation::kImmortalHeap;
     immortal_gray_line_ = processGrayObjectsIn(immortal_, immortal_gray_line_);
     save_location_ = saved;
 
+    // Objects promoted into the old generation
+    if (old_gray_line_ != 0) {
+      old_gray_line_ = processGrayObjectsIn(old_, old_gray_line_);
+    }
+
     // Objects reachable from gray objects become gray as well
     to_gray_line_ = (to_ == immortal_)
                         ? immortal_gray_line_
@@ -232,25 +526,22 @@ void Scavenger::processLayouts() {
        i < end; ++i) {
     RawObject layout = layouts_.at(i);
     if (layout == SmallInt::fromWord(0)) continue;
-    RawHeapObject heap_obj = HeapObject::cast(layout);
-    if (to_->contains(heap_obj.address())) continue;
-    if (heap_->isImmortal(heap_obj.address())) continue;
-
-    if (heap_obj.isForwarding()) {
-      DCHECK(heap_obj.forward().isLayout(), "Bad Layout forwarded value");
-      layouts_.atPut(i, heap_obj.forward());
-    } else {
-      layouts_.atPut(i, SmallInt::fromWord(0));
+    RawObject result = weakReferent(layout);
+    if (result != layout) {
+      DCHECK(result == SmallInt::fromWord(0) || result.isLayout(),
+             "Bad Layout forwarded value");
+      layouts_.atPut(i, result);
     }
   }
 
   // TODO(T59281894): We can skip this step if the Layouts table doesn't live
   // in the managed heap.
-  runtime_->setLayouts(transport(layouts_));
+  runtime_->setLayouts(isParallel() ? workers_[0]->transport(layouts_)
+                                    : transport(layouts_));
 
   // Remove dead empty entries (triples (A, B, C) where either A or C is dead).
   // Post-condition: all entries in the tuple will either be references to
-  // to-space or None.
+  // surviving objects or None.
   word length = layout_type_transitions_.length();
   DCHECK(!to_->contains(layout_type_transitions_.address()) ||
              immortal_->contains(layout_type_transitions_.address()),
@@ -260,24 +551,15 @@ void Scavenger::processLayouts() {
         layout_type_transitions_.at(i + LayoutTypeTransition::kFrom);
     if (from_obj == SmallInt::fromWord(0)) continue;
 
-    RawHeapObject from = HeapObject::cast(from_obj);
-    RawHeapObject to = HeapObject::cast(
+    RawObject from = weakReferent(from_obj);
+    RawObject to = weakReferent(
         layout_type_transitions_.at(i + LayoutTypeTransition::kTo));
-    RawHeapObject result = HeapObject::cast(
+    RawObject result = weakReferent(
         layout_type_transitions_.at(i + LayoutTypeTransition::kResult));
-    DCHECK(!to_->contains(to.address()),
-           "reference should not have been moved");
-    DCHECK(!to_->contains(from.address()),
-           "reference should not have been moved");
-    DCHECK(!to_->contains(result.address()),
-           "reference should not have been moved");
-    if (from.isForwarding() && result.isForwarding()) {
-      layout_type_transitions_.atPut(i + LayoutTypeTransition::kFrom,
-                                     from.forward());
-      layout_type_transitions_.atPut(i + LayoutTypeTransition::kTo,
-                                     to.forward());
-      layout_type_transitions_.atPut(i + LayoutTypeTransition::kResult,
-                                     result.forward());
+    if (from != SmallInt::fromWord(0) && result != SmallInt::fromWord(0)) {
+      layout_type_transitions_.atPut(i + LayoutTypeTransition::kFrom, from);
+      layout_type_transitions_.atPut(i + LayoutTypeTransition::kTo, to);
+      layout_type_transitions_.atPut(i + LayoutTypeTransition::kResult, result);
     } else {
       // Remove the transition edge of the from or result layouts have been
       // collected.
@@ -291,7 +573,9 @@ void Scavenger::processLayouts() {
   }
 
   compactLayoutTypeTransitions();
-  runtime_->setLayoutTypeTransitions(transport(layout_type_transitions_));
+  runtime_->setLayoutTypeTransitions(
+      isParallel() ? workers_[0]->transport(layout_type_transitions_)
+                   : transport(layout_type_transitions_));
 }
 
 static inline word getLeftMostNoneObjectIndex(RawTuple layout_type_transitions,
@@ -342,6 +626,13 @@ void Scavenger::compactLayoutTypeTransitions() {
   } while (left < right);
 }
 
+RawObject Scavenger::weakReferent(RawObject object) {
+  RawHeapObject heap_obj = HeapObject::cast(object);
+  if (!isCollected(heap_obj.address())) return object;
+  if (heap_obj.isForwarding()) return heap_obj.forward();
+  return SmallInt::fromWord(0);
+}
+
 // Process the list of weakrefs that had otherwise-unreachable referents during
 // processGrayObjects().
 //
@@ -369,11 +660,10 @@ void Scavenger::processDelayedReferences() {
 
 RawObject Scavenger::transport(RawObject old_object) {
   RawHeapObject from_object = HeapObject::cast(old_object);
-  if (heap_->isImmortal(from_object.address())) {
+  if (!isCollected(from_object.address())) {
+    // Immortal objects and old objects during a young collection stay put.
     return old_object;
   }
-  DCHECK(from_->contains(from_object.address()),
-         "objects must be transported from 'from' space");
   DCHECK(from_object.header().isHeader(),
          "object must have a header and must not forward");
 
@@ -387,10 +677,18 @@ RawObject Scavenger::transport(RawObject old_object) {
     // Allocate these from the immortal partition
     bool success = immortal_->allocate(size, &address);
     CHECK(success, "out of memory in immortal space");
+  } else if (promotes() &&
+             from_object.baseAddress() < age_mark_ &&
+             old_->allocate(size, &address)) {
+    // Objects that survived the previous scavenge are promoted
+    old_->recordObjectStart(address, size);
   } else {
     // Otherwise allocate from the standard partition
     bool success = to_->allocate(size, &address);
     DCHECK(success, "GC transport allocation failed in new heap partition");
+    if (to_ == old_) {
+      to_->recordObjectStart(address, size);
+    }
   }
 
   auto dst = reinterpret_cast<void*>(address);
@@ -408,12 +706,384 @@ RawObject Scavenger::transport(RawObject old_object) {
   return to_object;
 }
 
+// Returns the size of `object` from a copy of its `header`. Other workers may
+// replace the header word in the object itself with a forwarding pointer at
+// any time.
+static word sizeWithHeader(RawHeapObject object, RawHeader header) {
+  word count = header.count();
+  if (header.hasOverflow()) {
+    count = reinterpret_cast<RawSmallInt*>(object.address() +
+                                           RawHeapObject::kHeaderOverflowOffset)
+                ->value();
+  }
+  word result = RawHeapObject::headerSize(count);
+  switch (header.format()) {
+    case ObjectFormat::kData:
+      result += count;
+      break;
+    case ObjectFormat::kObjects:
+      result += count * kPointerSize;
+      break;
+  }
+  return roundAllocationSize(result);
+}
+
+// Returns the first object boundary in the middle of [start, end) or later.
+static uword splitGrayRange(uword start, uword end) {
+  uword middle = start + (end - start) / 2;
+  uword scan = start;
+  while (scan < middle) {
+    if (!(*reinterpret_cast<RawObject*>(scan)).isHeader()) {
+      scan += kPointerSize;
+      continue;
+    }
+    RawHeapObject object = HeapObject::fromAddress(scan + RawHeader::kSize);
+    scan = object.baseAddress() + object.size();
+  }
+  return scan;
+}
+
+static uword* headerWord(RawHeapObject object) {
+  return reinterpret_cast<uword*>(object.address() +
+                                  RawHeapObject::kHeaderOffset);
+}
+
+void Scavenger::startWorkers() {
+  for (word i = 0; i < num_workers_; i++) {
+    workers_.emplace_back(new ScavengerWorker(this));
+  }
+}
+
+void Scavenger::stopWorkers() {
+  for (auto& worker : workers_) {
+    worker->releaseLabs();
+  }
+  DCHECK(gray_ranges_.empty(), "all gray objects must have been processed");
+  workers_.clear();
+}
+
+void Scavenger::processGrayObjectsInParallel() {
+  num_idle_workers_ = 0;
+  std::vector<std::thread> helpers;
+  for (word i = 1; i < num_workers_; i++) {
+    ScavengerWorker* worker = workers_[i].get();
+    helpers.emplace_back([worker] { worker->run(); });
+  }
+  workers_[0]->run();
+  for (std::thread& helper : helpers) {
+    helper.join();
+  }
+  num_idle_workers_ = 0;
+  DCHECK(gray_ranges_.empty(), "all gray objects must have been processed");
+  for (auto& worker : workers_) {
+    delayed_references_ = WeakRef::spliceQueue(
+        delayed_references_, worker->takeDelayedReferences());
+  }
+}
+
+bool Scavenger::claimDirtyCards(word* first, word* last) {
+  // Claim a few cards at a time to keep the contention down.
+  const word cards_per_claim = 16;
+  word card = next_dirty_card_.fetch_add(cards_per_claim);
+  if (card > last_dirty_card_) return false;
+  *first = card;
+  *last = Utils::minimum(card + cards_per_claim - 1, last_dirty_card_);
+  return true;
+}
+
+void Scavenger::pushGrayRange(GrayRange range) {
+  MutexGuard lock(&gray_ranges_mutex_);
+  gray_ranges_.push_back(range);
+  num_gray_ranges_++;
+}
+
+bool Scavenger::popGrayRange(GrayRange* range) {
+  gray_ranges_mutex_.lock();
+  num_idle_workers_++;
+  for (;;) {
+    if (!gray_ranges_.empty()) {
+      *range = gray_ranges_.back();
+      gray_ranges_.pop_back();
+      num_gray_ranges_--;
+      num_idle_workers_--;
+      gray_ranges_mutex_.unlock();
+      return true;
+    }
+    // Only busy workers publish gray ranges, so once every worker is idle
+    // there is nothing left to do.
+    if (num_idle_workers_ == num_workers_) {
+      gray_ranges_mutex_.unlock();
+      return false;
+    }
+    gray_ranges_mutex_.unlock();
+    std::this_thread::yield();
+    gray_ranges_mutex_.lock();
+  }
+}
+
+ScavengerWorker::ScavengerWorker(Scavenger* scavenger)
+    : scavenger_(scavenger),
+      immortal_lab_{scavenger->immortal_, 0, 0, 0},
+      old_lab_{scavenger->old_, 0, 0, 0},
+      to_lab_{scavenger->to_, 0, 0, 0},
+      delayed_references_(NoneType::object()),
+      save_location_(scavenger->save_location_) {}
+
+void ScavengerWorker::visitPointer(RawObject* pointer, PointerKind) {
+  scavengePointer(pointer);
+}
+
+void ScavengerWorker::scavengePointer(RawObject* pointer) {
+  RawObject object = *pointer;
+  if (!object.isHeapObject()) return;
+  RawObject moved = transport(object);
+  if (moved == object) return;
+  *pointer = moved;
+  scavenger_->recordSlot(reinterpret_cast<uword>(pointer), moved);
+}
+
+RawObject ScavengerWorker::transport(RawObject old_object) {
+  RawHeapObject from_object = HeapObject::cast(old_object);
+  if (!scavenger_->isCollected(from_object.address())) {
+    return old_object;
+  }
+  uword* header_word = headerWord(from_object);
+  uword header_raw = __atomic_load_n(header_word, __ATOMIC_ACQUIRE);
+  if (!RawObject{header_raw}.isHeader()) {
+    // Another worker got here first.
+    return RawObject{header_raw};
+  }
+  RawHeader header = RawObject{header_raw}.rawCast<RawHeader>();
+  word size = sizeWithHeader(from_object, header);
+  word offset = RawHeader::kSize + (header.hasOverflow() ? kPointerSize : 0);
+  uword base_address = from_object.address() - offset;
+
+  // Same placement policy as `Scavenger::transport()`.
+  Lab* lab;
+  uword address;
+  bool in_lab;
+  if (header.layoutId() == LayoutId::kCode ||
+      save_location_ == Scavenger::SaveLocation::kImmortalHeap) {
+    lab = &immortal_lab_;
+    bool success = allocate(lab, size, &address, &in_lab);
+    CHECK(success, "out of memory in immortal space");
+  } else if (scavenger_->promotes() && base_address < scavenger_->age_mark_ &&
+             allocate(&old_lab_, size, &address, &in_lab)) {
+    lab = &old_lab_;
+  } else {
+    lab = &to_lab_;
+    bool success = allocate(lab, size, &address, &in_lab);
+    DCHECK(success, "GC transport allocation failed in new heap partition");
+  }
+
+  std::memcpy(reinterpret_cast<void*>(address),
+              reinterpret_cast<void*>(base_address), size);
+  RawHeapObject to_object = HeapObject::fromAddress(address + offset);
+  // The copy may have picked up a forwarding pointer from a competing worker.
+  to_object.setHeader(header);
+  uword expected = header_raw;
+  if (!__atomic_compare_exchange_n(header_word, &expected, to_object.raw(),
+                                   /*weak=*/false, __ATOMIC_ACQ_REL,
+                                   __ATOMIC_ACQUIRE)) {
+    undoAllocation(lab, address, size, in_lab);
+    return RawObject{expected};
+  }
+  if (scavenger_->recordsObjectStarts(lab->space)) {
+    lab->space->recordObjectStart(address, size);
+  }
+  if (!in_lab) {
+    scavenger_->pushGrayRange({lab->space, address, address + size});
+  }
+  scavengeLayout(to_object.layoutId());
+  return to_object;
+}
+
+// Every copied object scavenges the entry for its layout, so workers share
+// the slots of the layouts tuple.
+void ScavengerWorker::scavengeLayout(LayoutId layout_id) {
+  uword slot = scavenger_->layouts_.address() +
+               static_cast<word>(layout_id) * kPointerSize;
+  uword* slot_word = reinterpret_cast<uword*>(slot);
+  RawObject layout{__atomic_load_n(slot_word, __ATOMIC_RELAXED)};
+  if (!layout.isHeapObject()) return;
+  RawObject moved = transport(layout);
+  if (moved == layout) return;
+  __atomic_store_n(slot_word, moved.raw(), __ATOMIC_RELAXED);
+  scavenger_->recordSlot(slot, moved);
+}
+
+// Objects that do not fit into the allocation buffer are allocated from the
+// space directly and published as a gray range of their own.
+bool ScavengerWorker::allocate(Lab* lab, word size, uword* address,
+                               bool* in_lab) {
+  if (size <= static_cast<word>(lab->end - lab->fill)) {
+    *address = lab->fill;
+    lab->fill += size;
+    *in_lab = true;
+    return true;
+  }
+  *in_lab = false;
+  if (size > kLabSize / 4) {
+    return lab->space->allocateShared(size, address);
+  }
+  releaseLab(lab);
+  uword start;
+  if (!lab->space->allocateShared(kLabSize, &start)) {
+    return lab->space->allocateShared(size, address);
+  }
+  lab->scan = start;
+  lab->fill = start + size;
+  lab->end = start + kLabSize;
+  *address = start;
+  *in_lab = true;
+  return true;
+}
+
+// Gives back the memory of a copy that lost the race to forward its object.
+// Memory past the fill of a space must stay zeroed.
+void ScavengerWorker::undoAllocation(Lab* lab, uword address, word size,
+                                     bool in_lab) {
+  std::memset(reinterpret_cast<void*>(address), 0, size);
+  if (in_lab) {
+    DCHECK(lab->fill == address + static_cast<uword>(size),
+           "must undo the last allocation");
+    lab->fill = address;
+    return;
+  }
+  if (!lab->space->releaseShared(address, size) &&
+      scavenger_->recordsObjectStarts(lab->space)) {
+    // The zeroed words are skipped like alignment padding.
+    lab->space->recordObjectStart(address, size);
+  }
+}
+
+void ScavengerWorker::releaseLab(Lab* lab) {
+  if (lab->scan < lab->fill) {
+    scavenger_->pushGrayRange({lab->space, lab->scan, lab->fill});
+  }
+  word unused = lab->end - lab->fill;
+  if (unused > 0 && !lab->space->releaseShared(lab->fill, unused) &&
+      scavenger_->recordsObjectStarts(lab->space)) {
+    lab->space->recordObjectStart(lab->fill, unused);
+  }
+  lab->scan = lab->fill = lab->end = 0;
+}
+
+void ScavengerWorker::releaseLabs() {
+  releaseLab(&to_lab_);
+  releaseLab(&old_lab_);
+  releaseLab(&immortal_lab_);
+}
+
+RawObject ScavengerWorker::takeDelayedReferences() {
+  RawObject result = delayed_references_;
+  delayed_references_ = NoneType::object();
+  return result;
+}
+
+bool ScavengerWorker::isWhiteObject(RawHeapObject object) {
+  if (!scavenger_->isCollected(object.address())) return false;
+  return RawObject{__atomic_load_n(headerWord(object), __ATOMIC_ACQUIRE)}
+      .isHeader();
+}
+
+void ScavengerWorker::run() {
+  processDirtyCards();
+  for (;;) {
+    if (processLabs()) continue;
+    Scavenger::GrayRange range;
+    if (!scavenger_->popGrayRange(&range)) return;
+    processGrayRange(range, scavenger_->saveLocationFor(range.space));
+  }
+}
+
+void ScavengerWorker::processDirtyCards() {
+  Space* old = scavenger_->old_;
+  word first, last;
+  while (scavenger_->claimDirtyCards(&first, &last)) {
+    for (word card = first; card <= last; card++) {
+      if (!old->isCardDirty(card)) continue;
+      old->clearCard(card);
+      scavenger_->processDirtyCard(card, scavenger_->old_gray_line_, this);
+    }
+  }
+}
+
+// Scans the gray objects in this worker's allocation buffers. Returns false
+// if there were none.
+bool ScavengerWorker::processLabs() {
+  bool found = false;
+  for (Lab* lab : {&immortal_lab_, &old_lab_, &to_lab_}) {
+    while (lab->scan < lab->fill) {
+      // Claim the range first; the buffer may be replaced while scanning it.
+      Scavenger::GrayRange range = {lab->space, lab->scan, lab->fill};
+      lab->scan = lab->fill;
+      processGrayRange(range, scavenger_->saveLocationFor(range.space));
+      found = true;
+    }
+  }
+  return found;
+}
+
+void ScavengerWorker::processGrayRange(Scavenger::GrayRange range,
+                                       Scavenger::SaveLocation location) {
+  Scavenger::SaveLocation saved = save_location_;
+  save_location_ = location;
+  uword scan = range.start;
+  while (scan < range.end) {
+    if (!(*reinterpret_cast<RawObject*>(scan)).isHeader()) {
+      // Skip immediate values for alignment padding or header overflow.
+      scan += kPointerSize;
+      continue;
+    }
+    if (range.end - scan >= kMinSharedRangeSize &&
+        scavenger_->needsMoreGrayRanges()) {
+      // Hand the second half of the range to a worker that ran out of work.
+      uword split = splitGrayRange(scan, range.end);
+      if (split < range.end) {
+        scavenger_->pushGrayRange({range.space, split, range.end});
+        range.end = split;
+      }
+    }
+    RawHeapObject object = HeapObject::fromAddress(scan + RawHeader::kSize);
+    uword end = object.baseAddress() + object.size();
+    // Scan pointers that follow the header word, if any.
+    if (!object.isRoot()) {
+      scan = end;
+      continue;
+    }
+    scan += RawHeader::kSize;
+    if (object.isWeakRef()) {
+      RawWeakRef weakref = WeakRef::cast(object);
+      RawObject referent = weakref.referent();
+      if (!referent.isNoneType() && isWhiteObject(HeapObject::cast(referent))) {
+        // Delay the reference object for later processing.
+        WeakRef::enqueue(object, &delayed_references_);
+        // Skip over the referent field and continue scavenging.
+        scan += kPointerSize;
+      }
+    }
+    for (; scan < end; scan += kPointerSize) {
+      scavengePointer(reinterpret_cast<RawObject*>(scan));
+    }
+  }
+  save_location_ = saved;
+}
+
 bool isWhiteObject(Scavenger* scavenger, RawHeapObject object) {
   return scavenger->isWhiteObject(object);
 }
 
+bool isCollectingOld(Scavenger* scavenger) {
+  return scavenger->isCollectingOld();
+}
+
 RawObject scavenge(Runtime* runtime) { return Scavenger(runtime).scavenge(); }
 
+RawObject scavengeYoung(Runtime* runtime) {
+  return Scavenger(runtime).scavengeYoung();
+}
+
 RawObject scavengeImmortalize(Runtime* runtime) {
   return Scavenger(runtime).scavengeIntoImmortal();
 }
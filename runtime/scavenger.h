@@ -10,8 +10,17 @@ class Scavenger;
 
 bool isWhiteObject(Scavenger* scavenger, RawHeapObject object);
 
+// Returns true if `scavenger` evacuates the old generation as well. A young
+// collection leaves old and immortal objects where they are.
+bool isCollectingOld(Scavenger* scavenger);
+
+// Evacuates the young and the old generation. Survivors are tenured.
 RawObject scavenge(Runtime* runtime);
 
+// Evacuates the young generation only, unless the old generation is running
+// out of room for promoted objects.
+RawObject scavengeYoung(Runtime* runtime);
+
 RawObject scavengeImmortalize(Runtime* runtime);
 
 }  // namespace py
@@ -0,0 +1,91 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "snapshot.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "dict-builtins.h"
+#include "runtime.h"
+#include "space.h"
+#include "test-utils.h"
+
+namespace py {
+namespace testing {
+
+static std::string writeSnapshot(const TemporaryDirectory& tempdir) {
+  std::string path = tempdir.path + "snapshot";
+  std::unique_ptr<Snapshot> snapshot(Snapshot::create(path.c_str()));
+  delete createTestRuntimeWithSnapshot(snapshot.get());
+  EXPECT_EQ(snapshot->error(), nullptr) << snapshot->error();
+  return path;
+}
+
+static void checkRuntimeWorks(Runtime* runtime) {
+  ASSERT_FALSE(runFromCStr(runtime, R"(
+import _signal
+class C:
+  def __init__(self, value):
+    self.value = value
+  def __repr__(self):
+    return f'C({self.value!r})'
+result = repr(sorted([C(2), C(1)], key=lambda c: c.value))
+words = {"b": 2, "a": 1}
+words["c"] = len("hello".upper())
+handler = _signal.getsignal(_signal.SIGINT)
+)")
+                   .isError());
+  EXPECT_TRUE(isStrEqualsCStr(mainModuleAt(runtime, "result"), "[C(1), C(2)]"));
+  Thread* thread = Thread::current();
+  HandleScope scope(thread);
+  Dict words(&scope, mainModuleAt(runtime, "words"));
+  Str key(&scope, runtime->newStrFromCStr("c"));
+  EXPECT_TRUE(isIntEqualsWord(dictAtByStr(thread, words, key), 5));
+  EXPECT_TRUE(mainModuleAt(runtime, "handler").isFunction());
+  runtime->collectGarbage();
+  EXPECT_TRUE(runtime->heap()->verify());
+}
+
+TEST(SnapshotTest, RuntimeStartsFromSnapshot) {
+  TemporaryDirectory tempdir;
+  std::string path = writeSnapshot(tempdir);
+  const char* error = nullptr;
+  std::unique_ptr<Snapshot> snapshot(Snapshot::open(path.c_str(), &error));
+  ASSERT_NE(snapshot, nullptr) << error;
+  std::unique_ptr<Runtime> runtime(
+      createTestRuntimeWithSnapshot(snapshot.get()));
+  EXPECT_EQ(runtime->heap()->immortal()->start(), snapshot->heapStart());
+  checkRuntimeWorks(runtime.get());
+}
+
+TEST(SnapshotTest, RuntimeRelocatesSnapshotWhenAddressIsTaken) {
+  TemporaryDirectory tempdir;
+  std::string path = writeSnapshot(tempdir);
+  const char* error = nullptr;
+  std::unique_ptr<Snapshot> snapshot(Snapshot::open(path.c_str(), &error));
+  ASSERT_NE(snapshot, nullptr) << error;
+  Space blocker(kTestHeapSize, snapshot->heapStart());
+  ASSERT_EQ(blocker.start(), snapshot->heapStart());
+  std::unique_ptr<Runtime> runtime(
+      createTestRuntimeWithSnapshot(snapshot.get()));
+  EXPECT_NE(runtime->heap()->immortal()->start(), snapshot->heapStart());
+  checkRuntimeWorks(runtime.get());
+}
+
+TEST(SnapshotTest, OpenRejectsOtherFiles) {
+  TemporaryDirectory tempdir;
+  std::string path = tempdir.path + "not_a_snapshot";
+  writeFile(path, "hello world, this is not a heap snapshot");
+  const char* error = nullptr;
+  EXPECT_EQ(Snapshot::open(path.c_str(), &error), nullptr);
+  EXPECT_STREQ(error, "not a heap snapshot");
+
+  error = nullptr;
+  std::string missing = tempdir.path + "missing";
+  EXPECT_EQ(Snapshot::open(missing.c_str(), &error), nullptr);
+  EXPECT_NE(error, nullptr);
+}
+
+}  // namespace testing
+}  // namespace py
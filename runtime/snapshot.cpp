@@ -0,0 +1,410 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "snapshot.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "dict-builtins.h"
+#include "file.h"
+#include "handles.h"
+#include "heap.h"
+#include "module-builtins.h"
+#include "modules.h"
+#include "os.h"
+#include "runtime.h"
+#include "thread.h"
+#include "utils.h"
+#include "vector.h"
+#include "visitor.h"
+
+namespace py {
+
+static const char kMagic[8] = {'P', 'Y', 'R', 'O', 'S', 'N', 'A', 'P'};
+
+static uword anchorAddress() {
+  return reinterpret_cast<uword>(&Snapshot::open);
+}
+
+// Identifies the executable by its size and modification time.
+static bool binaryIdentity(word* size, word* mtime) {
+  unique_c_ptr<char> path(OS::executablePath());
+  struct stat st;
+  if (::stat(path.get(), &st) != 0) return false;
+  *size = st.st_size;
+  *mtime = st.st_mtime;
+  return true;
+}
+
+static bool readAll(int fd, word offset, void* buffer, word size) {
+  if (File::seek(fd, offset, SEEK_SET) != offset) return false;
+  byte* dst = static_cast<byte*>(buffer);
+  while (size > 0) {
+    ssize_t result = File::read(fd, dst, size);
+    if (result <= 0) return false;
+    dst += result;
+    size -= result;
+  }
+  return true;
+}
+
+static bool writeAll(int fd, word offset, const void* buffer, word size) {
+  if (File::seek(fd, offset, SEEK_SET) != offset) return false;
+  const byte* src = static_cast<const byte*>(buffer);
+  while (size > 0) {
+    ssize_t result = File::write(fd, src, size);
+    if (result <= 0) return false;
+    src += result;
+    size -= result;
+  }
+  return true;
+}
+
+namespace {
+
+// Finds objects that refer to memory outside of the heap, which a snapshot
+// cannot capture.
+class NativeMemoryFinder : public HeapObjectVisitor {
+ public:
+  void visitHeapObject(RawHeapObject object) override {
+    if (object.isPointer()) found_ = true;
+  }
+
+  bool found() { return found_; }
+
+ private:
+  bool found_ = false;
+};
+
+// Moves pointers to objects in [start, end) by `delta` bytes.
+class PointerRelocator : public HeapObjectVisitor {
+ public:
+  PointerRelocator(uword start, uword end, word delta)
+      : start_(start), end_(end), delta_(delta) {}
+
+  void relocate(RawObject* pointer) {
+    RawObject value = *pointer;
+    if (!value.isHeapObject()) return;
+    uword address = HeapObject::cast(value).address();
+    if (address < start_ || address >= end_) return;
+    *pointer = RawObject{value.raw() + delta_};
+  }
+
+  void visitHeapObject(RawHeapObject object) override {
+    if (!object.isRoot()) return;
+    uword end = object.baseAddress() + object.size();
+    for (uword scan = object.address(); scan < end; scan += kPointerSize) {
+      relocate(reinterpret_cast<RawObject*>(scan));
+    }
+  }
+
+ private:
+  uword start_;
+  uword end_;
+  word delta_;
+};
+
+// Updates the native pointers stored in functions and code objects and clears
+// the C-API handles embedded in types and modules.
+class NativePointerFixer : public HeapObjectVisitor {
+ public:
+  NativePointerFixer(Thread* thread, word delta)
+      : thread_(thread), delta_(delta) {}
+
+  void* move(void* pointer) {
+    if (pointer == nullptr) return nullptr;
+    return reinterpret_cast<void*>(reinterpret_cast<uword>(pointer) + delta_);
+  }
+
+  RawFunction::Entry move(RawFunction::Entry entry) {
+    return reinterpret_cast<RawFunction::Entry>(
+        move(reinterpret_cast<void*>(entry)));
+  }
+
+  void visitHeapObject(RawHeapObject object) override {
+    if (object.isType()) {
+      Type::cast(object).setApiHandle(NoneType::object());
+      return;
+    }
+    if (object.isModule()) {
+      Module::cast(object).setApiHandle(NoneType::object());
+      return;
+    }
+    if (object.isCode()) {
+      RawCode code = Code::cast(object);
+      if (delta_ == 0) return;
+      if (code.isNative()) {
+        code.setCode(SmallInt::fromAlignedCPtr(
+            move(SmallInt::cast(code.code()).asAlignedCPtr())));
+      }
+      code.setIntrinsic(move(code.intrinsic()));
+      return;
+    }
+    if (!object.isFunction()) return;
+    RawFunction function = Function::cast(object);
+    if (delta_ != 0) {
+      function.setEntry(move(function.entry()));
+      function.setEntryKw(move(function.entryKw()));
+      function.setEntryEx(move(function.entryEx()));
+      function.setIntrinsic(move(function.intrinsic()));
+      // Functions of extension modules keep a C pointer in place of a code
+      // object. Their modules are initialized again after the restore.
+      RawObject code = function.code();
+      if (code.isCode() && Code::cast(code).isNative()) {
+        function.setStacksizeOrBuiltin(SmallInt::fromAlignedCPtr(
+            move(SmallInt::cast(function.stacksizeOrBuiltin()).asAlignedCPtr())));
+      }
+    }
+    // The assembly interpreter is generated at runtime.
+    HandleScope scope(thread_);
+    Function handle(&scope, function);
+    thread_->runtime()->populateEntryAsm(handle);
+  }
+
+ private:
+  Thread* thread_;
+  word delta_;
+};
+
+// Replaces references to objects with other objects.
+class PointerReplacer : public HeapObjectVisitor, public PointerVisitor {
+ public:
+  struct Replacement {
+    uword from;
+    uword to;
+    bool operator<(const Replacement& other) const { return from < other.from; }
+  };
+
+  void add(RawObject from, RawObject to) {
+    replacements_.push_back({from.raw(), to.raw()});
+  }
+
+  void prepare() {
+    std::sort(replacements_.begin(), replacements_.end());
+    if (!replacements_.empty()) {
+      min_ = replacements_.front().from;
+      max_ = replacements_.back().from;
+    }
+  }
+
+  bool empty() { return replacements_.empty(); }
+
+  void visitPointer(RawObject* pointer, PointerKind) override {
+    uword raw = pointer->raw();
+    if (raw < min_ || raw > max_) return;
+    Replacement key = {raw, 0};
+    auto it = std::lower_bound(replacements_.begin(), replacements_.end(), key);
+    if (it != replacements_.end() && it->from == raw) {
+      *pointer = RawObject{it->to};
+    }
+  }
+
+  void visitHeapObject(RawHeapObject object) override {
+    if (!object.isRoot()) return;
+    uword end = object.baseAddress() + object.size();
+    for (uword scan = object.address(); scan < end; scan += kPointerSize) {
+      visitPointer(reinterpret_cast<RawObject*>(scan), PointerKind::kRuntime);
+    }
+  }
+
+ private:
+  Vector<Replacement> replacements_;
+  uword min_ = 1;
+  uword max_ = 0;
+};
+
+}  // namespace
+
+// Extension modules keep state outside of the managed heap, such as their
+// `PyModuleDef` registration and C-API handles. Initialize them again and
+// redirect all references from the stale module objects and their attributes
+// to the new ones.
+static void reinitializeExtensionModules(Thread* thread, Runtime* runtime) {
+  HandleScope scope(thread);
+  Dict modules(&scope, runtime->modules());
+  List names(&scope, runtime->newList());
+  List stale_modules(&scope, runtime->newList());
+  Object name(&scope, NoneType::object());
+  Object value(&scope, NoneType::object());
+  for (word i = 0; dictNextItem(modules, &i, &name, &value);) {
+    if (!value.isModule() || !Module::cast(*value).hasDef()) continue;
+    name = Runtime::internStr(thread, name);
+    runtime->listAdd(thread, names, name);
+    runtime->listAdd(thread, stale_modules, value);
+  }
+  if (names.numItems() == 0) return;
+  for (word i = 0; i < names.numItems(); i++) {
+    name = names.at(i);
+    dictRemoveByStr(thread, modules, name);
+  }
+
+  Space* immortal = runtime->heap()->immortal();
+  PointerReplacer replacer;
+  List keys(&scope, runtime->newList());
+  Object new_value(&scope, NoneType::object());
+  for (word i = 0; i < names.numItems(); i++) {
+    Str module_name(&scope, names.at(i));
+    // Initializing one module may have imported another one already.
+    value = ensureBuiltinModule(thread, module_name);
+    CHECK(value.isModule(), "could not initialize extension module %s",
+          unique_c_ptr<char>(module_name.toCStr()).get());
+    Module module(&scope, *value);
+    Module stale(&scope, stale_modules.at(i));
+    replacer.add(*stale, *module);
+    keys = moduleKeys(thread, stale);
+    for (word j = 0; j < keys.numItems(); j++) {
+      name = keys.at(j);
+      value = moduleAt(stale, name);
+      new_value = moduleAt(module, name);
+      if (new_value.isErrorNotFound()) {
+        // Attributes set by the import system, like `__spec__`.
+        moduleAtPut(thread, module, name, value);
+        continue;
+      }
+      if (*value != *new_value && value.isHeapObject() &&
+          immortal->isAllocated(HeapObject::cast(*value).address())) {
+        replacer.add(*value, *new_value);
+      }
+    }
+  }
+  replacer.prepare();
+  runtime->heap()->visitSpace(immortal, &replacer);
+  runtime->visitRuntimeRoots(&replacer);
+}
+
+Snapshot* Snapshot::open(const char* path, const char** error) {
+  int fd = File::open(path, File::kBinaryFlag, 0);
+  if (fd < 0) {
+    *error = std::strerror(-fd);
+    return nullptr;
+  }
+  Snapshot* snapshot = new Snapshot;
+  snapshot->path_ = path;
+  snapshot->fd_ = fd;
+  Header* header = &snapshot->header_;
+  word binary_size, binary_mtime;
+  if (!readAll(fd, 0, header, sizeof(*header)) ||
+      std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+    *error = "not a heap snapshot";
+  } else if (header->version != kVersion) {
+    *error = "unsupported snapshot version";
+  } else if (!binaryIdentity(&binary_size, &binary_mtime) ||
+             header->binary_size != binary_size ||
+             header->binary_mtime != binary_mtime ||
+             !Utils::isAligned(anchorAddress() - header->binary_anchor,
+                               OS::kPageSize)) {
+    *error = "snapshot was written by a different executable";
+  } else if (File::size(fd) <
+             header->roots_offset + header->num_roots * kPointerSize) {
+    *error = "snapshot is truncated";
+  } else {
+    return snapshot;
+  }
+  delete snapshot;
+  return nullptr;
+}
+
+Snapshot* Snapshot::create(const char* path) {
+  Snapshot* snapshot = new Snapshot;
+  snapshot->path_ = path;
+  return snapshot;
+}
+
+Snapshot::~Snapshot() {
+  if (fd_ >= 0) File::close(fd_);
+}
+
+void Snapshot::write(Thread*, Runtime* runtime) {
+  DCHECK(isWriting(), "snapshot was opened for reading");
+  runtime->immortalizeCurrentHeapObjects();
+  Heap* heap = runtime->heap();
+  Space* immortal = heap->immortal();
+  NativeMemoryFinder finder;
+  heap->visitSpace(immortal, &finder);
+  if (finder.found()) {
+    error_ = "objects refer to native memory";
+    return;
+  }
+
+  Vector<RawObject> roots;
+  std::memcpy(header_.magic, kMagic, sizeof(kMagic));
+  header_.version = kVersion;
+  if (!binaryIdentity(&header_.binary_size, &header_.binary_mtime)) {
+    error_ = "could not determine the executable";
+    return;
+  }
+  header_.binary_anchor = anchorAddress();
+  header_.heap_start = immortal->start();
+  header_.heap_size = immortal->fill() - immortal->start();
+  header_.heap_offset = OS::kPageSize;
+  runtime->saveSnapshotState(&header_.state, &roots);
+  header_.num_roots = roots.size();
+  header_.roots_offset =
+      header_.heap_offset + Utils::roundUp(header_.heap_size, OS::kPageSize);
+  static_assert(sizeof(Header) <= OS::kPageSize, "header must fit in a page");
+
+  int fd = File::open(
+      path_,
+      File::kBinaryFlag | File::kCreate | File::kTruncate | File::kWriteOnly,
+      0644);
+  if (fd < 0) {
+    error_ = std::strerror(-fd);
+    return;
+  }
+  if (!writeAll(fd, 0, &header_, sizeof(header_)) ||
+      !writeAll(fd, header_.heap_offset,
+                reinterpret_cast<void*>(header_.heap_start),
+                header_.heap_size) ||
+      !writeAll(fd, header_.roots_offset, roots.begin(),
+                header_.num_roots * kPointerSize)) {
+    error_ = std::strerror(errno);
+  }
+  File::close(fd);
+}
+
+void Snapshot::restore(Thread* thread, Runtime* runtime) {
+  DCHECK(!isWriting(), "snapshot was opened for writing");
+  Heap* heap = runtime->heap();
+  Space* immortal = heap->immortal();
+  uword start;
+  CHECK(immortal->fill() == immortal->start() &&
+            immortal->allocate(header_.heap_size, &start),
+        "heap snapshot does not fit into the immortal partition");
+  CHECK(OS::mapFilePrivate(reinterpret_cast<byte*>(start),
+                           Utils::roundUp(header_.heap_size, OS::kPageSize),
+                           fd_, header_.heap_offset),
+        "could not map heap snapshot %s", path_);
+
+  Vector<RawObject> roots;
+  roots.reserve(header_.num_roots);
+  for (word i = 0; i < header_.num_roots; i++) {
+    roots.push_back(NoneType::object());
+  }
+  CHECK(readAll(fd_, header_.roots_offset, roots.begin(),
+                header_.num_roots * kPointerSize),
+        "could not read heap snapshot %s", path_);
+
+  SnapshotState state = header_.state;
+  word delta = start - header_.heap_start;
+  if (delta != 0) {
+    PointerRelocator relocator(header_.heap_start,
+                               header_.heap_start + header_.heap_size, delta);
+    heap->visitSpace(immortal, &relocator);
+    for (word i = 0; i < header_.num_roots; i++) {
+      relocator.relocate(&roots[i]);
+    }
+    relocator.relocate(reinterpret_cast<RawObject*>(&state.layouts));
+    relocator.relocate(
+        reinterpret_cast<RawObject*>(&state.layout_type_transitions));
+  }
+
+  NativePointerFixer fixer(thread, anchorAddress() - header_.binary_anchor);
+  heap->visitSpace(immortal, &fixer);
+  runtime->restoreSnapshotState(
+      thread, state, View<RawObject>(roots.begin(), roots.size()));
+  reinitializeExtensionModules(thread, runtime);
+}
+
+}  // namespace py
@@ -0,0 +1,102 @@
+/* Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com) */
+#pragma once
+
+#include "globals.h"
+
+namespace py {
+
+class Runtime;
+class Thread;
+
+// Runtime state outside of the heap that is saved with a heap snapshot.
+// Objects are stored as raw values so the struct can be written as is.
+struct SnapshotState {
+  word num_layouts;
+  word max_module_id;
+  word builtins_module_id;
+  uint64_t siphash24_secret;
+  uword layouts;
+  uword layout_type_transitions;
+};
+
+// A heap snapshot is an image of the runtime right after the builtin types and
+// the required modules were created.
+//
+// Building the builtin types and running the frozen modules dominates the
+// startup time of the runtime. Instead, a runtime started from a snapshot maps
+// the image into its immortal partition as a private copy-on-write file
+// mapping and only restores the runtime roots and the few native pointers
+// stored in functions and code objects. Pages that are never written to stay
+// shared with the page cache.
+//
+// The immortal partition is placed at the address the image was written from
+// whenever that address range is free. Otherwise every object pointer in the
+// image is relocated, which touches all pages of the image but still avoids
+// rerunning the initialization.
+//
+// C-API handles live outside of the managed heap and are not part of the
+// image. Extension modules imported while building the snapshot are initialized
+// again on restore and references to their old module objects and attributes
+// are redirected to the new ones.
+//
+// A snapshot is only valid for the binary that wrote it. The hash secret of
+// str and bytes objects is part of the image, so `PYTHONHASHSEED` has no effect
+// on runtimes started from a snapshot.
+class Snapshot {
+ public:
+  // Opens the snapshot at `path` to start a runtime from. Returns nullptr and
+  // points `error` at a description of the problem if the file cannot be used
+  // by this binary.
+  static Snapshot* open(const char* path, const char** error);
+
+  // Returns a snapshot that the runtime constructor writes to `path` once the
+  // required modules are initialized. Check `error()` afterwards.
+  static Snapshot* create(const char* path);
+
+  ~Snapshot();
+
+  bool isWriting() { return fd_ < 0; }
+
+  // The address the immortal partition started at when the snapshot was
+  // written.
+  uword heapStart() { return header_.heap_start; }
+
+  // Returns the reason writing the snapshot failed or nullptr on success.
+  const char* error() { return error_; }
+
+  // Called by the runtime constructor to fill the snapshot or the runtime.
+  void write(Thread* thread, Runtime* runtime);
+  void restore(Thread* thread, Runtime* runtime);
+
+  static const word kVersion = 2;
+
+ private:
+  struct Header {
+    char magic[8];
+    word version;
+    // Identifies the executable the snapshot was written by. The address of
+    // a function in it tells how far native pointers need to be moved.
+    word binary_size;
+    word binary_mtime;
+    uword binary_anchor;
+    // The immortal objects, stored page aligned at `heap_offset`.
+    uword heap_start;
+    word heap_size;
+    word heap_offset;
+    // The values of the runtime roots in `Runtime::visitRuntimeRoots()` order.
+    word num_roots;
+    word roots_offset;
+    SnapshotState state;
+  };
+
+  Snapshot() = default;
+
+  const char* path_ = nullptr;
+  const char* error_ = nullptr;
+  int fd_ = -1;
+  Header header_ = {};
+
+  DISALLOW_COPY_AND_ASSIGN(Snapshot);
+};
+
+}  // namespace py
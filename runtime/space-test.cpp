@@ -30,4 +30,62 @@ TEST(SpaceTest, Allocate) {
   EXPECT_EQ(space.start(), space.fill());
 }
 
+TEST(SpaceTest, SpaceIsAligned) {
+  Space space(64 * kKiB);
+  EXPECT_TRUE(Utils::isAligned(space.start(), Space::kCardSize));
+  EXPECT_EQ(space.start() & ~(Space::kAlignment - 1),
+            space.end() & ~(Space::kAlignment - 1));
+}
+
+TEST(SpaceTest, MarkCardDirtiesCard) {
+  Space space(64 * kKiB);
+  uword address;
+  ASSERT_TRUE(space.allocate(4 * Space::kCardSize, &address));
+  word card = Space::cardIndex(address + Space::kCardSize);
+  EXPECT_EQ(card, space.firstCard() + 1);
+  EXPECT_FALSE(space.isCardDirty(card));
+
+  Space::markCard(address + Space::kCardSize + kPointerSize);
+  EXPECT_FALSE(space.isCardDirty(card - 1));
+  EXPECT_TRUE(space.isCardDirty(card));
+  EXPECT_FALSE(space.isCardDirty(card + 1));
+
+  space.clearCard(card);
+  EXPECT_FALSE(space.isCardDirty(card));
+}
+
+TEST(SpaceTest, MarkCardsDirtiesRange) {
+  Space space(64 * kKiB);
+  uword address;
+  ASSERT_TRUE(space.allocate(4 * Space::kCardSize, &address));
+  Space::markCards(address + Space::kCardSize - kPointerSize,
+                   2 * kPointerSize);
+  word card = space.firstCard();
+  EXPECT_TRUE(space.isCardDirty(card));
+  EXPECT_TRUE(space.isCardDirty(card + 1));
+  EXPECT_FALSE(space.isCardDirty(card + 2));
+
+  space.reset();
+  EXPECT_FALSE(space.isCardDirty(card));
+  EXPECT_FALSE(space.isCardDirty(card + 1));
+}
+
+TEST(SpaceTest, ObjectStartForCardReturnsCoveringObject) {
+  Space space(64 * kKiB);
+  uword first;
+  word first_size = Space::kCardSize + 2 * kPointerSize;
+  ASSERT_TRUE(space.allocate(first_size, &first));
+  space.recordObjectStart(first, first_size);
+  uword second;
+  word second_size = 3 * Space::kCardSize;
+  ASSERT_TRUE(space.allocate(second_size, &second));
+  space.recordObjectStart(second, second_size);
+
+  word card = space.firstCard();
+  EXPECT_EQ(space.objectStartForCard(card), first);
+  EXPECT_EQ(space.objectStartForCard(card + 1), first);
+  EXPECT_EQ(space.objectStartForCard(card + 2), second);
+  EXPECT_EQ(space.objectStartForCard(card + 3), second);
+}
+
 }  // namespace py
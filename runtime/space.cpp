@@ -7,26 +7,93 @@
 
 namespace py {
 
-Space::Space(word size) {
-  raw_ = OS::allocateMemory(size, &size);
-  CHECK(raw_ != nullptr, "out of memory");
-  start_ = fill_ = reinterpret_cast<uword>(raw_);
-  end_ = start_ + size;
+// Returns the number of bytes needed in front of the objects of a space with
+// `size` bytes to hold one card table byte and one object start entry for
+// every card of the whole reservation.
+static word prefixSize(word size) {
+  word prefix = 0;
+  for (;;) {
+    word num_cards = Utils::roundUpDiv(prefix + size, Space::kCardSize);
+    word needed = Utils::roundUp(
+        num_cards * static_cast<word>(1 + sizeof(uint32_t)), OS::kPageSize);
+    if (needed <= prefix) return prefix;
+    prefix = needed;
+  }
+}
+
+Space::Space(word size) : Space(size, 0) {}
+
+Space::Space(word size, uword preferred_start) {
+  size = Utils::roundUp(size, OS::kPageSize);
+  word prefix = prefixSize(size);
+  CHECK(static_cast<uword>(prefix + size) <= kAlignment,
+        "space size exceeds maximum");
+  byte* raw = nullptr;
+  if (preferred_start != 0 &&
+      ((preferred_start - prefix) & (kAlignment - 1)) == 0) {
+    raw = OS::allocateMemoryAt(preferred_start - prefix, prefix + size,
+                               &reserved_size_);
+  }
+  if (raw == nullptr) {
+    raw = OS::allocateAlignedMemory(prefix + size, kAlignment,
+                                    &reserved_size_);
+  }
+  CHECK(raw != nullptr, "out of memory");
+  base_ = reinterpret_cast<uword>(raw);
+  num_cards_ = Utils::roundUpDiv(prefix + size, kCardSize);
+  start_ = fill_ = base_ + prefix;
+  end_ = limit_ = start_ + size;
 }
 
 Space::~Space() {
-  if (raw_ != nullptr) {
-    OS::freeMemory(raw_, size());
+  if (base_ != 0) {
+    OS::freeMemory(reinterpret_cast<byte*>(base_), reserved_size_);
   }
 }
 
-void Space::protect() { OS::protectMemory(raw_, size(), OS::kNoAccess); }
+void Space::protect() {
+  OS::protectMemory(reinterpret_cast<byte*>(start_), size(), OS::kNoAccess);
+}
 
-void Space::unprotect() { OS::protectMemory(raw_, size(), OS::kReadWrite); }
+void Space::unprotect() {
+  OS::protectMemory(reinterpret_cast<byte*>(start_), size(), OS::kReadWrite);
+}
 
 void Space::reset() {
   std::memset(reinterpret_cast<void*>(start()), 0xFF, size());
+  std::memset(reinterpret_cast<void*>(base_), kCleanCard, num_cards_);
   fill_ = start();
+  limit_ = end();
+}
+
+void Space::markCards(uword address, word size) {
+  if (size <= 0) return;
+  uword base = address & ~(kAlignment - 1);
+  byte* cards = reinterpret_cast<byte*>(base);
+  for (word card = cardIndex(address), last = cardIndex(address + size - 1);
+       card <= last; card++) {
+    cards[card] = kDirtyCard;
+  }
+}
+
+void Space::recordObjectStart(uword address, word size) {
+  DCHECK(contains(address), "object must be in space");
+  // Every card whose first byte lies inside the object gets the object as its
+  // scan start. Allocation is contiguous so every card start below `fill()` is
+  // covered by exactly one object.
+  word first = cardIndex(address + kCardSize - 1);
+  word last = cardIndex(address + size - 1);
+  uint32_t offset = static_cast<uint32_t>((address - base_) >> kWordSizeLog2);
+  uint32_t* starts = objectStarts();
+  for (word card = first; card <= last; card++) {
+    starts[card] = offset;
+  }
+}
+
+uword Space::objectStartForCard(word card) {
+  DCHECK(cardStart(card) >= start_ && cardStart(card) < fill_,
+         "card must cover allocated memory");
+  return base_ + (static_cast<uword>(objectStarts()[card]) << kWordSizeLog2);
 }
 
 }  // namespace py
@@ -6,13 +6,31 @@
 
 namespace py {
 
+// A contiguous region of memory that objects are bump allocated into.
+//
+// Every space is placed at a kAlignment boundary and starts with a card table
+// followed by an object start table. This makes it possible to find the card
+// for any address inside of any space without knowing which space it belongs
+// to, which keeps the write barrier down to a couple of instructions.
 class Space {
  public:
   explicit Space(word size);
+  // Places the objects of the space at `preferred_start` if that address
+  // range is available.
+  Space(word size, uword preferred_start);
   ~Space();
 
   bool allocate(word size, uword* result);
 
+  // Like `allocate()`, but safe to call from several threads at once. Used by
+  // the scavenger to hand out allocation buffers to its workers.
+  bool allocateShared(word size, uword* result);
+
+  // Gives back [address, address + size) if it is the last allocation of the
+  // space and returns true. Returns false if anything was allocated after it.
+  // Safe to call concurrently with `allocateShared()`.
+  bool releaseShared(uword address, word size);
+
   void protect();
 
   void unprotect();
@@ -29,27 +47,84 @@ class Space {
 
   uword fill() { return fill_; }
 
+  // Bump allocation fails once it would cross the limit. The limit is the end
+  // of the space unless the heap lowered it to sample an allocation.
+  uword limit() { return limit_; }
+  void setLimit(uword limit) {
+    DCHECK(limit >= start_ && limit <= end_, "limit outside of space");
+    limit_ = limit;
+  }
+
   void reset();
 
   word size() { return end_ - start_; }
 
+  // Card table.
+
+  // Records a write to the word at `address`. The address must be in a space.
+  static void markCard(uword address);
+
+  // Records writes to all words in [address, address + size).
+  static void markCards(uword address, word size);
+
+  static word cardIndex(uword address) {
+    return (address & (kAlignment - 1)) >> kCardShift;
+  }
+
+  uword cardStart(word card) { return base_ + (card << kCardShift); }
+
+  // Index of the first card covering allocatable memory.
+  word firstCard() { return cardIndex(start_); }
+
+  bool isCardDirty(word card) {
+    return reinterpret_cast<byte*>(base_)[card] != kCleanCard;
+  }
+
+  void clearCard(word card) {
+    reinterpret_cast<byte*>(base_)[card] = kCleanCard;
+  }
+
+  // Remembers that an object has been allocated at [address, address + size)
+  // so that `objectStartForCard()` can find it. Only spaces that are scanned
+  // by card need to do this.
+  void recordObjectStart(uword address, word size);
+
+  // Returns the base address of the object that covers the start of `card`.
+  // Only valid for cards below `fill()` in spaces with recorded object starts.
+  uword objectStartForCard(word card);
+
   static int endOffset() { return offsetof(Space, end_); }
 
+  static int limitOffset() { return offsetof(Space, limit_); }
+
   static int fillOffset() { return offsetof(Space, fill_); }
 
+  static const uword kAlignment = uword{4} * kGiB;
+  static const int kCardShift = 9;
+  static const word kCardSize = word{1} << kCardShift;
+  static const byte kCleanCard = 0;
+  static const byte kDirtyCard = 1;
+
  private:
+  uint32_t* objectStarts() {
+    return reinterpret_cast<uint32_t*>(base_ + num_cards_);
+  }
+
   uword start_;
   uword end_;
   uword fill_;
+  uword limit_;
 
-  byte* raw_;
+  uword base_;
+  word num_cards_;
+  word reserved_size_;
 
   DISALLOW_COPY_AND_ASSIGN(Space);
 };
 
 inline bool Space::allocate(word size, uword* result) {
   word fill = fill_;
-  word free = end_ - fill;
+  word free = limit_ - fill;
   if (size > free) {
     return false;
   }
@@ -58,4 +133,29 @@ inline bool Space::allocate(word size, uword* result) {
   return true;
 }
 
+inline bool Space::allocateShared(word size, uword* result) {
+  uword fill = __atomic_load_n(&fill_, __ATOMIC_RELAXED);
+  do {
+    if (size > static_cast<word>(end_ - fill)) {
+      return false;
+    }
+  } while (!__atomic_compare_exchange_n(&fill_, &fill, fill + size,
+                                        /*weak=*/true, __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED));
+  *result = fill;
+  return true;
+}
+
+inline bool Space::releaseShared(uword address, word size) {
+  uword expected = address + size;
+  return __atomic_compare_exchange_n(&fill_, &expected, address,
+                                     /*weak=*/false, __ATOMIC_RELAXED,
+                                     __ATOMIC_RELAXED);
+}
+
+inline void Space::markCard(uword address) {
+  uword base = address & ~(kAlignment - 1);
+  reinterpret_cast<byte*>(base)[cardIndex(address)] = kDirtyCard;
+}
+
 }  // namespace py
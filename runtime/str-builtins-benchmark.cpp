@@ -0,0 +1,75 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "benchmark-utils.h"
+#include "bytes-builtins.h"
+#include "handles.h"
+#include "runtime.h"
+#include "str-builtins.h"
+
+namespace py {
+namespace testing {
+
+using StrBenchmark = RuntimeBenchmark;
+
+// Decodes `state.range(0)` bytes of mostly ASCII text with a two byte code
+// point every 64 bytes.
+BENCHMARK_DEFINE_F(StrBenchmark, BytesDecodeUTF8)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  word length = state.range(0);
+  std::string contents;
+  while (static_cast<word>(contents.size()) < length) {
+    contents +=
+        "The quick brown fox jumps over the lazy dogs, and then "
+        "na\u00efvely ";
+  }
+  Bytes bytes(&scope, runtime_->newBytesWithAll(View<byte>(
+                          reinterpret_cast<const byte*>(contents.data()),
+                          contents.size())));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bytesDecodeUTF8(thread_, bytes));
+  }
+  state.SetBytesProcessed(state.iterations() * bytes.length());
+}
+BENCHMARK_REGISTER_F(StrBenchmark, BytesDecodeUTF8)->Arg(64)->Arg(64 * 1024);
+
+// Searches for a needle at the very end of a `state.range(0)` byte haystack
+// made of near misses.
+BENCHMARK_DEFINE_F(StrBenchmark, StrFind)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  word length = state.range(0);
+  std::string haystack_contents;
+  while (static_cast<word>(haystack_contents.size()) < length) {
+    haystack_contents += "needlf ";
+  }
+  haystack_contents += "needle";
+  Str haystack(&scope, runtime_->newStrFromCStr(haystack_contents.c_str()));
+  Str needle(&scope, runtime_->newStrFromCStr("needle"));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(strFind(haystack, needle));
+  }
+  state.SetBytesProcessed(state.iterations() * haystack.length());
+}
+BENCHMARK_REGISTER_F(StrBenchmark, StrFind)->Arg(64)->Arg(16 * 1024);
+
+BENCHMARK_DEFINE_F(StrBenchmark, StrSplit)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  word num_fields = state.range(0);
+  std::string contents;
+  for (word i = 0; i < num_fields; i++) {
+    if (i > 0) contents += ", ";
+    contents += "field" + std::to_string(i);
+  }
+  Str str(&scope, runtime_->newStrFromCStr(contents.c_str()));
+  Str sep(&scope, runtime_->newStrFromCStr(", "));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(strSplit(thread_, str, sep, kMaxWord));
+  }
+  state.SetItemsProcessed(state.iterations() * num_fields);
+}
+BENCHMARK_REGISTER_F(StrBenchmark, StrSplit)->Arg(4)->Arg(1024);
+
+}  // namespace testing
+}  // namespace py
@@ -22,17 +22,74 @@
 
 namespace py {
 
-word adjustedStrIndex(const Str& str, word index) {
+word adjustedStrIndex(Thread* thread, const Str& str, word index) {
   word len = str.length();
   if (index >= 0) {
-    return str.offsetByCodePoints(0, index);
+    return thread->strOffset(str, index);
   }
   if (-len < index) {
+    if (len >= kStrIndexMinLength) {
+      index += thread->strCodePointLength(str);
+      return index < 0 ? 0 : thread->strOffset(str, index);
+    }
     return Utils::maximum(0l, str.offsetByCodePoints(len, index));
   }
   return 0;
 }
 
+static const word kStrIndexEntrySize = sizeof(uint32_t);
+
+RawObject strIndexBuild(Thread* thread, const LargeStr& str) {
+  word length = str.length();
+  DCHECK(length <= static_cast<word>(kMaxUint32), "string too long to index");
+  word num_code_points = str.codePointLength();
+  if (num_code_points == length) return NoneType::object();
+  word num_checkpoints = num_code_points / kStrIndexStride + 1;
+  HandleScope scope(thread);
+  MutableBytes index(&scope, thread->runtime()->newMutableBytesUninitialized(
+                                 (num_checkpoints + 1) * kStrIndexEntrySize));
+  index.uint32AtPut(0, num_code_points);
+  for (word i = 0, offset = 0; i < num_checkpoints; i++) {
+    index.uint32AtPut((i + 1) * kStrIndexEntrySize, offset);
+    offset = str.offsetByCodePoints(offset, kStrIndexStride);
+  }
+  return *index;
+}
+
+word strIndexCodePointLength(RawMutableBytes index) {
+  return index.uint32At(0);
+}
+
+word strIndexOffset(RawLargeStr str, RawMutableBytes index, word code_point) {
+  DCHECK(code_point >= 0, "code point index must not be negative");
+  if (code_point >= strIndexCodePointLength(index)) return str.length();
+  word checkpoint = code_point / kStrIndexStride;
+  word offset = index.uint32At((checkpoint + 1) * kStrIndexEntrySize);
+  return str.offsetByCodePoints(offset, code_point % kStrIndexStride);
+}
+
+word strIndexCodePoint(RawLargeStr str, RawMutableBytes index, word offset) {
+  DCHECK_INDEX(offset, str.length() + 1);
+  // Find the last checkpoint at or before `offset`.
+  word low = 0;
+  word high = index.length() / kStrIndexEntrySize - 2;
+  while (low < high) {
+    word mid = (low + high + 1) / 2;
+    if (static_cast<word>(index.uint32At((mid + 1) * kStrIndexEntrySize)) <=
+        offset) {
+      low = mid;
+    } else {
+      high = mid - 1;
+    }
+  }
+  word result = low * kStrIndexStride;
+  for (word i = index.uint32At((low + 1) * kStrIndexEntrySize); i < offset;
+       i++) {
+    if (UTF8::isLeadByte(str.byteAt(i))) result++;
+  }
+  return result;
+}
+
 RawObject dataArraySubstr(Thread* thread, const DataArray& data, word start,
                           word length) {
   word data_len = data.length();
@@ -692,8 +749,8 @@ bool METH(str, __getitem___intrinsic)(Thread* thread) {
       // Manually adjust slice bounds to avoid an extra call to codePointLength
       HandleScope scope(thread);
       Str self(&scope, arg0);
-      word start_index = adjustedStrIndex(self, start);
-      word stop_index = adjustedStrIndex(self, stop);
+      word start_index = adjustedStrIndex(thread, self, start);
+      word stop_index = adjustedStrIndex(thread, self, stop);
       word length = stop_index - start_index;
 
       thread->stackDrop(2);
@@ -703,27 +760,22 @@ bool METH(str, __getitem___intrinsic)(Thread* thread) {
     }
     return true;
   }
-  RawStr self = Str::cast(arg0);
+  HandleScope scope(thread);
+  Str self(&scope, arg0);
   word len = self.length();
+  word offset = -1;
   if (0 <= idx && idx < len) {
-    word offset = self.offsetByCodePoints(0, idx);
-    if (offset < len) {
-      word ignored;
-      thread->stackDrop(2);
-      thread->stackSetTop(
-          RawSmallStr::fromCodePoint(self.codePointAt(offset, &ignored)));
-      return true;
-    }
+    offset = thread->strOffset(self, idx);
+  } else if (0 > idx) {
+    idx += thread->strCodePointLength(self);
+    if (idx >= 0) offset = thread->strOffset(self, idx);
   }
-  if (0 > idx) {
-    word offset = self.offsetByCodePoints(len, idx);
-    if (offset < len && offset != -1) {
-      word ignored;
-      thread->stackDrop(2);
-      thread->stackSetTop(
-          RawSmallStr::fromCodePoint(self.codePointAt(offset, &ignored)));
-      return true;
-    }
+  if (0 <= offset && offset < len) {
+    word ignored;
+    thread->stackDrop(2);
+    thread->stackSetTop(
+        RawSmallStr::fromCodePoint(self.codePointAt(offset, &ignored)));
+    return true;
   }
   return false;
 }
@@ -864,18 +916,19 @@ word strFind(const Str& haystack, const Str& needle) {
   return -1;
 }
 
-word strFindWithRange(const Str& haystack, const Str& needle, word start,
-                      word end) {
+word strFindWithRange(Thread* thread, const Str& haystack, const Str& needle,
+                      word start, word end) {
   if (end < 0 || start < 0) {
-    Slice::adjustSearchIndices(&start, &end, haystack.codePointLength());
+    Slice::adjustSearchIndices(&start, &end,
+                               thread->strCodePointLength(haystack));
   }
 
-  word start_index = haystack.offsetByCodePoints(0, start);
+  word start_index = thread->strOffset(haystack, start);
   if (start_index == haystack.length() && needle.length() > 0) {
     // Haystack is too small; fast early return
     return -1;
   }
-  word end_index = haystack.offsetByCodePoints(start_index, end - start);
+  word end_index = end < start ? -1 : thread->strOffset(haystack, end);
 
   if ((end_index - start_index) < needle.length() || start_index > end_index) {
     // Haystack is too small; fast early return
@@ -1005,7 +1058,7 @@ RawObject METH(str, __len__)(Thread* thread, Arguments args) {
     return thread->raiseRequiresType(self_obj, ID(str));
   }
   Str self(&scope, strUnderlying(*self_obj));
-  return SmallInt::fromWord(self.codePointLength());
+  return SmallInt::fromWord(thread->strCodePointLength(self));
 }
 
 static RawObject strLowerASCII(Thread* thread, Object& str_obj, Str& str,
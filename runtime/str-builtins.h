@@ -9,7 +9,32 @@
 
 namespace py {
 
-word adjustedStrIndex(const Str& str, word index);
+// Returns the byte offset of code point `index` of `str`, counting from the
+// end if `index` is negative. Clamps to the bounds of the string.
+word adjustedStrIndex(Thread* thread, const Str& str, word index);
+
+// Long non-ASCII strings get a checkpoint index that records the byte offset
+// of every `kStrIndexStride`th code point, so translating between code point
+// indices and byte offsets only scans a few bytes. The index is a MutableBytes
+// of uint32 values: the code point length followed by the checkpoints.
+// Threads build and cache indexes on demand; see `Thread::strOffset()`.
+const word kStrIndexStride = 64;
+// Shorter strings are cheap enough to scan.
+const word kStrIndexMinLength = 256;
+
+// Returns the checkpoint index of `str`, or None if `str` is ASCII. Strings
+// longer than `kMaxUint32` bytes cannot be indexed.
+RawObject strIndexBuild(Thread* thread, const LargeStr& str);
+
+// Returns the number of code points of the string `index` was built for.
+word strIndexCodePointLength(RawMutableBytes index);
+
+// Returns the byte offset of code point `code_point` in `str`, or the length
+// of `str` if `code_point` is past its end.
+word strIndexOffset(RawLargeStr str, RawMutableBytes index, word code_point);
+
+// Returns the index of the code point starting at byte `offset` in `str`.
+word strIndexCodePoint(RawLargeStr str, RawMutableBytes index, word offset);
 
 RawObject dataArraySubstr(Thread* thread, const DataArray& data, word start,
                           word length);
@@ -44,8 +69,8 @@ word strFind(const Str& haystack, const Str& needle);
 // Look for needle in haystack in the range [start, end]. Return the first
 // index found in that range, or -1 if needle was not found. Note that start
 // and end are code point offsets, not byte offsets.
-word strFindWithRange(const Str& haystack, const Str& needle, word start,
-                      word end);
+word strFindWithRange(Thread* thread, const Str& haystack, const Str& needle,
+                      word start, word end);
 
 word strFindAsciiChar(const Str& haystack, byte needle);
 
@@ -0,0 +1,101 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "benchmark-utils.h"
+#include "handles.h"
+#include "runtime.h"
+#include "str-intern.h"
+
+namespace py {
+namespace testing {
+
+using StrInternBenchmark = RuntimeBenchmark;
+
+static std::vector<std::string> largeStrContents(word num_strs) {
+  std::vector<std::string> result;
+  for (word i = 0; i < num_strs; i++) {
+    result.push_back("intern_benchmark_identifier_" + std::to_string(i));
+  }
+  return result;
+}
+
+static View<byte> viewOf(const std::string& str) {
+  return View<byte>(reinterpret_cast<const byte*>(str.data()), str.length());
+}
+
+// Fills a fresh table, growing it as needed. This is what happens to the
+// names in a module that is unmarshaled for the first time.
+BENCHMARK_DEFINE_F(StrInternBenchmark, InternSetAddFromAllNew)
+(benchmark::State& state) {
+  HandleScope scope(thread_);
+  word num_strs = state.range(0);
+  std::vector<std::string> contents = largeStrContents(num_strs);
+  word capacity = 16;
+  MutableTuple data(&scope, runtime_->newMutableTuple(capacity));
+  for (auto _ : state) {
+    data = runtime_->newMutableTuple(capacity);
+    data.fill(SmallInt::fromWord(0));
+    word remaining = internSetComputeRemaining(capacity);
+    for (const std::string& str : contents) {
+      RawObject result = NoneType::object();
+      if (internSetAddFromAll(thread_, *data, viewOf(str), &result) &&
+          --remaining == 0) {
+        data = internSetGrow(thread_, *data, &remaining);
+      }
+      benchmark::DoNotOptimize(result);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_strs);
+}
+BENCHMARK_REGISTER_F(StrInternBenchmark, InternSetAddFromAllNew)
+    ->Arg(64)
+    ->Arg(4096);
+
+// Looks up strings that are already interned, which is the common case once
+// the program has warmed up.
+BENCHMARK_DEFINE_F(StrInternBenchmark, InternStrFromAllExisting)
+(benchmark::State& state) {
+  word num_strs = state.range(0);
+  std::vector<std::string> contents = largeStrContents(num_strs);
+  for (const std::string& str : contents) {
+    Runtime::internStrFromAll(thread_, viewOf(str));
+  }
+  for (auto _ : state) {
+    for (const std::string& str : contents) {
+      benchmark::DoNotOptimize(Runtime::internStrFromAll(thread_, viewOf(str)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_strs);
+}
+BENCHMARK_REGISTER_F(StrInternBenchmark, InternStrFromAllExisting)
+    ->Arg(64)
+    ->Arg(4096);
+
+// Looks up attribute names from many threads at once. Lookups of interned
+// strings do not take a lock, so throughput should scale with the threads.
+BENCHMARK_DEFINE_F(StrInternBenchmark, InternStrFromAllExistingThreaded)
+(benchmark::State& state) {
+  std::vector<std::string> contents = largeStrContents(1024);
+  if (state.thread_index == 0) {
+    for (const std::string& str : contents) {
+      Runtime::internStrFromAll(thread_, viewOf(str));
+    }
+  }
+  // Only lookups run concurrently; they neither allocate nor need a thread of
+  // their own.
+  for (auto _ : state) {
+    for (const std::string& str : contents) {
+      benchmark::DoNotOptimize(Runtime::internStrFromAll(thread_, viewOf(str)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * contents.size());
+}
+BENCHMARK_REGISTER_F(StrInternBenchmark, InternStrFromAllExistingThreaded)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+}  // namespace testing
+}  // namespace py
@@ -3,7 +3,9 @@
 
 #include "handles.h"
 #include "runtime.h"
+#include "space.h"
 #include "thread.h"
+#include "visitor.h"
 
 namespace py {
 
@@ -42,25 +44,214 @@ RawObject internSetGrow(Thread* thread, RawMutableTuple data_raw,
   return *new_data;
 }
 
-bool internSetContains(RawMutableTuple data, RawLargeStr str) {
+// Table slots are read without holding the shard lock. Stores publish a
+// string with its hash already set in the header.
+static RawObject slotAt(RawMutableTuple data, word index) {
+  DCHECK_INDEX(index, data.length());
+  uword* slot = reinterpret_cast<uword*>(data.address() + index * kPointerSize);
+  return RawObject{__atomic_load_n(slot, __ATOMIC_ACQUIRE)};
+}
+
+static void slotAtPut(RawMutableTuple data, word index, RawObject value) {
+  DCHECK_INDEX(index, data.length());
+  uword slot = data.address() + index * kPointerSize;
+  __atomic_store_n(reinterpret_cast<uword*>(slot), value.raw(),
+                   __ATOMIC_RELEASE);
+  Space::markCard(slot);
+}
+
+static RawObject loadTable(RawObject* table) {
+  return RawObject{
+      __atomic_load_n(reinterpret_cast<uword*>(table), __ATOMIC_ACQUIRE)};
+}
+
+static void storeTable(RawObject* table, RawObject value) {
+  __atomic_store_n(reinterpret_cast<uword*>(table), value.raw(),
+                   __ATOMIC_RELEASE);
+}
+
+static RawObject tableFindBytes(RawObject table, word hash, View<byte> bytes) {
+  if (table.isNoneType()) return Error::notFound();
+  RawMutableTuple data = MutableTuple::cast(table);
+  word mask = data.length() - 1;
+  word index = hash & mask;
+  for (word num_probes = 0;;) {
+    RawObject slot = slotAt(data, index);
+    if (slot == SmallInt::fromWord(0)) return Error::notFound();
+    if (LargeStr::cast(slot).header().hashCode() == hash &&
+        LargeStr::cast(slot).equalsBytes(bytes)) {
+      return slot;
+    }
+    num_probes++;
+    index = (index + num_probes) & mask;
+  }
+}
+
+static RawObject tableFindStr(RawObject table, word hash, RawLargeStr str) {
+  if (table.isNoneType()) return Error::notFound();
+  RawMutableTuple data = MutableTuple::cast(table);
+  word mask = data.length() - 1;
+  word index = hash & mask;
+  for (word num_probes = 0;;) {
+    RawObject slot = slotAt(data, index);
+    if (slot == str) return slot;
+    if (slot == SmallInt::fromWord(0)) return Error::notFound();
+    if (LargeStr::cast(slot).header().hashCode() == hash &&
+        LargeStr::cast(slot).equals(str)) {
+      return slot;
+    }
+    num_probes++;
+    index = (index + num_probes) & mask;
+  }
+}
+
+static bool tableContains(RawObject table, word hash, RawLargeStr str) {
+  if (table.isNoneType()) return false;
+  RawMutableTuple data = MutableTuple::cast(table);
+  word mask = data.length() - 1;
+  word index = hash & mask;
+  for (word num_probes = 0;;) {
+    RawObject slot = slotAt(data, index);
+    if (slot == str) return true;
+    if (slot == SmallInt::fromWord(0)) return false;
+    num_probes++;
+    index = (index + num_probes) & mask;
+  }
+}
+
+// Inserts `str` into a table that does not contain an equal string.
+static void tableInsert(RawMutableTuple data, word hash, RawLargeStr str) {
+  word mask = data.length() - 1;
+  word index = hash & mask;
+  for (word num_probes = 0; data.at(index) != SmallInt::fromWord(0);) {
+    num_probes++;
+    index = (index + num_probes) & mask;
+  }
+  slotAtPut(data, index, str);
+}
+
+void InternTable::initialize(Runtime* runtime, word capacity) {
+  word shard_capacity = capacity / kNumShards;
+  DCHECK(Utils::isPowerOfTwo(shard_capacity), "must be power of two");
+  for (Shard& shard : shards_) {
+    shard.data = runtime->newMutableTuple(shard_capacity);
+    shard.old_data = NoneType::object();
+    shard.old_index = 0;
+    shard.remaining = internSetComputeRemaining(shard_capacity);
+  }
+}
+
+RawObject InternTable::add(Thread* thread, const Object& str) {
+  DCHECK(str.isLargeStr(), "expected large string");
+  word hash = thread->runtime()->valueHash(*str);
+  Shard* shard = shardFor(hash);
+  RawLargeStr raw_str = LargeStr::cast(*str);
+  RawObject result = tableFindStr(loadTable(&shard->data), hash, raw_str);
+  if (result.isErrorNotFound()) {
+    result = tableFindStr(loadTable(&shard->old_data), hash, raw_str);
+  }
+  if (!result.isErrorNotFound()) return result;
+  HandleScope scope(thread);
+  LargeStr large_str(&scope, *str);
+  return insert(thread, shard, large_str, hash);
+}
+
+RawObject InternTable::addFromAll(Thread* thread, View<byte> bytes) {
+  DCHECK(bytes.length() > SmallStr::kMaxLength, "only need to intern LargeStr");
+  Runtime* runtime = thread->runtime();
+  word hash = runtime->bytesHash(bytes);
+  Shard* shard = shardFor(hash);
+  RawObject result = tableFindBytes(loadTable(&shard->data), hash, bytes);
+  if (result.isErrorNotFound()) {
+    result = tableFindBytes(loadTable(&shard->old_data), hash, bytes);
+  }
+  if (!result.isErrorNotFound()) return result;
+  // Allocate outside of the lock; another thread may win the race to insert.
+  HandleScope scope(thread);
+  LargeStr str(&scope, runtime->newStrWithAll(bytes));
+  str.setHeader(str.header().withHashCode(hash));
+  return insert(thread, shard, str, hash);
+}
+
+RawObject InternTable::insert(Thread* thread, Shard* shard, const LargeStr& str,
+                              word hash) {
+  ThreadMutexGuard guard(thread, &shard->mutex);
+  RawObject existing = tableFindStr(shard->data, hash, *str);
+  if (existing.isErrorNotFound()) {
+    existing = tableFindStr(shard->old_data, hash, *str);
+  }
+  if (!existing.isErrorNotFound()) return existing;
+  tableInsert(MutableTuple::cast(shard->data), hash, *str);
+  shard->remaining--;
+  moveOldEntries(shard, kMoveStep);
+  if (shard->remaining <= 0) {
+    grow(thread, shard);
+  }
+  return *str;
+}
+
+void InternTable::moveOldEntries(Shard* shard, word num_slots) {
+  if (shard->old_data.isNoneType()) return;
+  RawMutableTuple old_data = MutableTuple::cast(shard->old_data);
+  RawMutableTuple data = MutableTuple::cast(shard->data);
+  word end = Utils::minimum(shard->old_index + num_slots, old_data.length());
+  for (word i = shard->old_index; i < end; i++) {
+    RawObject slot = old_data.at(i);
+    if (slot == SmallInt::fromWord(0)) continue;
+    RawLargeStr str = LargeStr::cast(slot);
+    tableInsert(data, str.header().hashCode(), str);
+    shard->remaining--;
+  }
+  shard->old_index = end;
+  if (end == old_data.length()) {
+    storeTable(&shard->old_data, NoneType::object());
+  }
+}
+
+void InternTable::grow(Thread* thread, Shard* shard) {
+  moveOldEntries(shard, kMaxWord);
+  word capacity = MutableTuple::cast(shard->data).length() * 2;
+  // The allocation may move the tables; read them afterwards.
+  RawObject new_data = thread->runtime()->newMutableTuple(capacity);
+  storeTable(&shard->old_data, shard->data);
+  shard->old_index = 0;
+  shard->remaining = internSetComputeRemaining(capacity);
+  storeTable(&shard->data, new_data);
+}
+
+bool InternTable::contains(RawLargeStr str) {
   word hash = str.header().hashCode();
   if (hash == Header::kUninitializedHash) {
     return false;
   }
-  DCHECK(Utils::isPowerOfTwo(data.length()), "length must be power of two");
-  word mask = data.length() - 1;
-  word idx = hash & mask;
-  word num_probes = 0;
-  for (;;) {
-    RawObject slot = data.at(idx);
-    if (slot == str) {
-      return true;
-    }
-    if (slot == SmallInt::fromWord(0)) {
-      return false;
+  Shard* shard = shardFor(hash);
+  return tableContains(loadTable(&shard->data), hash, str) ||
+         tableContains(loadTable(&shard->old_data), hash, str);
+}
+
+void InternTable::finishGrowing() {
+  for (Shard& shard : shards_) {
+    moveOldEntries(&shard, kMaxWord);
+  }
+}
+
+void InternTable::recomputeRemaining() {
+  for (Shard& shard : shards_) {
+    DCHECK(shard.old_data.isNoneType(), "snapshot taken while growing");
+    RawMutableTuple data = MutableTuple::cast(shard.data);
+    word remaining = internSetComputeRemaining(data.length());
+    for (word i = 0, length = data.length(); i < length; i++) {
+      if (data.at(i) != SmallInt::fromWord(0)) remaining--;
     }
-    num_probes++;
-    idx = (idx + num_probes) & mask;
+    shard.old_index = 0;
+    shard.remaining = remaining;
+  }
+}
+
+void InternTable::visitRoots(PointerVisitor* visitor) {
+  for (Shard& shard : shards_) {
+    visitor->visitPointer(&shard.data, PointerKind::kRuntime);
+    visitor->visitPointer(&shard.old_data, PointerKind::kRuntime);
   }
 }
 
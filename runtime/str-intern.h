@@ -3,6 +3,7 @@
 
 #include "globals.h"
 #include "handles-decl.h"
+#include "mutex.h"
 #include "objects.h"
 #include "runtime.h"
 #include "thread.h"
@@ -25,11 +26,76 @@ bool internSetAddFromAll(Thread* thread, RawMutableTuple data, View<byte> bytes,
 
 word internSetComputeRemaining(word data_length);
 
-bool internSetContains(RawMutableTuple data, RawLargeStr str);
-
 RawObject internSetGrow(Thread* thread, RawMutableTuple data,
                         word* remaining_out);
 
+// The set of strings interned by a runtime, safe to use from several threads.
+//
+// Strings are spread over `kNumShards` open addressing tables by the high bits
+// of their hash. Looking up a string that is already interned takes no lock:
+// slots only change from empty to a string and a string is never removed, so
+// any string found is the canonical one. Adding a string takes the lock of its
+// shard and repeats the lookup before inserting.
+//
+// A full shard is not rehashed at once. It switches to a table of twice the
+// size and every following insertion into the shard moves `kMoveStep` slots of
+// the old table over. Lookups check both tables until the old one is empty.
+class InternTable {
+ public:
+  static const int kShardBits = 4;
+  static const word kNumShards = word{1} << kShardBits;
+  static const word kMoveStep = 16;
+
+  InternTable() = default;
+
+  // Allocates tables with `capacity` slots in total.
+  void initialize(Runtime* runtime, word capacity);
+
+  // Returns the interned string equal to the `LargeStr` `str`, adding `str`
+  // if there is none.
+  RawObject add(Thread* thread, const Object& str);
+
+  // Returns the interned string equal to `bytes`, adding a new `LargeStr` if
+  // there is none.
+  RawObject addFromAll(Thread* thread, View<byte> bytes);
+
+  bool contains(RawLargeStr str);
+
+  // Finishes moving entries out of old tables. Only valid while no other
+  // thread uses the table.
+  void finishGrowing();
+
+  // Recomputes the remaining free slots of each shard after the tables were
+  // restored from a heap snapshot.
+  void recomputeRemaining();
+
+  void visitRoots(PointerVisitor* visitor);
+
+ private:
+  struct Shard {
+    Mutex mutex;
+    // The current table and the table entries are moved out of while growing.
+    RawObject data = NoneType::object();
+    RawObject old_data = NoneType::object();
+    word old_index = 0;
+    word remaining = 0;
+  };
+
+  Shard* shardFor(word hash) {
+    return &shards_[(hash >> (RawHeader::kHashCodeBits - kShardBits)) &
+                    (kNumShards - 1)];
+  }
+
+  RawObject insert(Thread* thread, Shard* shard, const LargeStr& str,
+                   word hash);
+  void moveOldEntries(Shard* shard, word num_slots);
+  void grow(Thread* thread, Shard* shard);
+
+  Shard shards_[kNumShards];
+
+  DISALLOW_COPY_AND_ASSIGN(InternTable);
+};
+
 inline bool internSetAddFromAll(Thread* thread, RawMutableTuple data,
                                 View<byte> bytes, RawObject* result) {
   DCHECK(bytes.length() > SmallStr::kMaxLength, "only need to intern LargeStr");
@@ -14,11 +14,15 @@ static const char* kPredefinedSymbols[] = {
 };
 // clang-format on
 
-Symbols::Symbols(Runtime* runtime) {
+Symbols::Symbols() {
   auto num_symbols = static_cast<uword>(SymbolId::kMaxId);
   uword symbol_size = sizeof(*symbols_);
   symbols_ = static_cast<RawObject*>(std::calloc(num_symbols, symbol_size));
   CHECK(symbols_ != nullptr, "could not allocate memory for symbol table");
+}
+
+Symbols::Symbols(Runtime* runtime) : Symbols() {
+  auto num_symbols = static_cast<uword>(SymbolId::kMaxId);
   for (uword i = 0; i < num_symbols; i++) {
     symbols_[i] = runtime->newStrFromCStr(kPredefinedSymbols[i]);
   }
@@ -258,6 +258,10 @@ class Runtime;
   V(__weaklink__prev)                                                          \
   V(__weaklink__referent)                                                      \
   V(__xor__)                                                                   \
+  V(_accumulate__func)                                                         \
+  V(_accumulate__initial)                                                      \
+  V(_accumulate__iterator)                                                     \
+  V(_accumulate__total)                                                        \
   V(_appending)                                                                \
   V(_array__buffer)                                                            \
   V(_array__length)                                                            \
@@ -295,6 +299,8 @@ class Runtime;
   V(_bytes_new)                                                                \
   V(_calculate_path)                                                           \
   V(_cast_addr)                                                                \
+  V(_chain__active)                                                            \
+  V(_chain__source)                                                            \
   V(_closed)                                                                   \
   V(_closefd)                                                                  \
   V(_code__cell2arg)                                                           \
@@ -310,6 +316,8 @@ class Runtime;
   V(_coroutine__frame)                                                         \
   V(_coroutine__origin)                                                        \
   V(_coroutine_wrapper__cw_coroutine)                                          \
+  V(_count__count)                                                             \
+  V(_count__step)                                                              \
   V(_created)                                                                  \
   V(_decode_with_cls)                                                          \
   V(_decoded_chars)                                                            \
@@ -330,6 +338,7 @@ class Runtime;
   V(_descrclassmethod)                                                         \
   V(_dict__data)                                                               \
   V(_dict__first_empty_item_index)                                             \
+  V(_dict__first_live_item_index)                                              \
   V(_dict__num_items)                                                          \
   V(_dict__sparse)                                                             \
   V(_dict_item_iterator__index)                                                \
@@ -344,7 +353,7 @@ class Runtime;
   V(_dict_value_iterator__iterable)                                            \
   V(_dict_value_iterator__num_found)                                           \
   V(_dict_values__dict)                                                        \
-  V(_enable_threads)                                                           \
+  V(_encode_with_cls)                                                          \
   V(_encoder)                                                                  \
   V(_encoding)                                                                 \
   V(_err_program_text)                                                         \
@@ -381,9 +390,19 @@ class Runtime;
   V(_function__total_args)                                                     \
   V(_function__total_vars)                                                     \
   V(_function__intrinsic)                                                      \
+  V(_function__jit_countdown)                                                  \
   V(_generator__exception_state)                                               \
   V(_generator__frame)                                                         \
   V(_generator__yield_from)                                                    \
+  V(_groupby__current_grouper)                                                 \
+  V(_groupby__current_key)                                                     \
+  V(_groupby__current_value)                                                   \
+  V(_groupby__iterator)                                                        \
+  V(_groupby__key_func)                                                        \
+  V(_groupby__target_key)                                                      \
+  V(_grouper)                                                                  \
+  V(_grouper__parent)                                                          \
+  V(_grouper__target_key)                                                      \
   V(_has_read1)                                                                \
   V(_import_all_from)                                                          \
   V(_index_or_int)                                                             \
@@ -394,6 +413,11 @@ class Runtime;
   V(_int_ctor_obj)                                                             \
   V(_int_new_from_str)                                                         \
   V(_io)                                                                       \
+  V(_islice__count)                                                            \
+  V(_islice__iterator)                                                         \
+  V(_islice__next)                                                             \
+  V(_islice__step)                                                             \
+  V(_islice__stop)                                                             \
   V(_iterator__index)                                                          \
   V(_iterator__iterable)                                                       \
   V(_json)                                                                     \
@@ -415,6 +439,15 @@ class Runtime;
   V(_lookup_text)                                                              \
   V(_lt)                                                                       \
   V(_lt_key)                                                                   \
+  V(_lru_cache_wrapper)                                                        \
+  V(_lru_cache_wrapper__cache)                                                 \
+  V(_lru_cache_wrapper__cache_info_type)                                       \
+  V(_lru_cache_wrapper__hits)                                                  \
+  V(_lru_cache_wrapper__maxsize)                                               \
+  V(_lru_cache_wrapper__misses)                                                \
+  V(_lru_cache_wrapper__root)                                                  \
+  V(_lru_cache_wrapper__typed)                                                 \
+  V(_lru_cache_wrapper__wrapped)                                               \
   V(_mappingproxy__mapping)                                                    \
   V(_memmove_addr)                                                             \
   V(_memoryview__buffer)                                                       \
@@ -424,6 +457,7 @@ class Runtime;
   V(_mmap__access)                                                             \
   V(_mmap__data)                                                               \
   V(_mmap__fd)                                                                 \
+  V(_module__api_handle)                                                       \
   V(_module__attributes)                                                       \
   V(_module__attributes_remaining)                                             \
   V(_module__def)                                                              \
@@ -460,6 +494,10 @@ class Runtime;
   V(_pointer__cptr)                                                            \
   V(_pointer__length)                                                          \
   V(_pos)                                                                      \
+  V(_product__indices)                                                         \
+  V(_product__pools)                                                           \
+  V(_product__result)                                                          \
+  V(_product__stopped)                                                         \
   V(_range_iterator__length)                                                   \
   V(_range_iterator__next)                                                     \
   V(_range_iterator__step)                                                     \
@@ -474,6 +512,8 @@ class Runtime;
   V(_ref__hash)                                                                \
   V(_ref__link)                                                                \
   V(_ref__referent)                                                            \
+  V(_repeat__element)                                                          \
+  V(_repeat__times)                                                            \
   V(_run_module_as_main)                                                       \
   V(_seekable)                                                                 \
   V(_seennl)                                                                   \
@@ -505,6 +545,15 @@ class Runtime;
   V(_structseq_new)                                                            \
   V(_structseq_repr)                                                           \
   V(_super_ctor)                                                               \
+  V(_tee)                                                                      \
+  V(_tee__data)                                                                \
+  V(_tee__index)                                                               \
+  V(_tee_dataobject)                                                           \
+  V(_tee_dataobject__iterator)                                                 \
+  V(_tee_dataobject__next)                                                     \
+  V(_tee_dataobject__num_read)                                                 \
+  V(_tee_dataobject__running)                                                  \
+  V(_tee_dataobject__values)                                                   \
   V(_telling)                                                                  \
   V(_thread)                                                                   \
   V(_traceback__function)                                                      \
@@ -519,6 +568,7 @@ class Runtime;
   V(_tuple_iterator__length)                                                   \
   V(_tuple_len)                                                                \
   V(_type__abstract_methods)                                                   \
+  V(_type__api_handle)                                                         \
   V(_type__attributes)                                                         \
   V(_type__attributes_remaining)                                               \
   V(_type__bases)                                                              \
@@ -546,7 +596,11 @@ class Runtime;
   V(_writenl)                                                                  \
   V(_writetranslate)                                                           \
   V(_wstring_at_addr)                                                          \
+  V(_zip_longest__fill_value)                                                  \
+  V(_zip_longest__iterators)                                                   \
+  V(_zip_longest__num_active)                                                  \
   V(abs)                                                                       \
+  V(accumulate)                                                                \
   V(add)                                                                       \
   V(and_)                                                                      \
   V(args)                                                                      \
@@ -574,6 +628,7 @@ class Runtime;
   V(callable_iterator)                                                         \
   V(cell)                                                                      \
   V(cell_contents)                                                             \
+  V(chain)                                                                     \
   V(classmethod)                                                               \
   V(co_argcount)                                                               \
   V(co_cellvars)                                                               \
@@ -597,6 +652,7 @@ class Runtime;
   V(contains)                                                                  \
   V(coroutine)                                                                 \
   V(coroutine_wrapper)                                                         \
+  V(count)                                                                     \
   V(countOf)                                                                   \
   V(cr_running)                                                                \
   V(decode)                                                                    \
@@ -639,6 +695,7 @@ class Runtime;
   V(getline)                                                                   \
   V(getsizeof)                                                                 \
   V(gi_running)                                                                \
+  V(groupby)                                                                   \
   V(hash_info)                                                                 \
   V(hexversion)                                                                \
   V(iadd)                                                                      \
@@ -664,6 +721,7 @@ class Runtime;
   V(irshift)                                                                   \
   V(isidentifier)                                                              \
   V(isinstance)                                                                \
+  V(islice)                                                                    \
   V(issubclass)                                                                \
   V(isub)                                                                      \
   V(items)                                                                     \
@@ -728,6 +786,7 @@ class Runtime;
   V(pos)                                                                       \
   V(pow)                                                                       \
   V(print_file_and_line)                                                       \
+  V(product)                                                                   \
   V(property)                                                                  \
   V(proxy)                                                                     \
   V(pycache_prefix)                                                            \
@@ -739,6 +798,7 @@ class Runtime;
   V(real)                                                                      \
   V(reason)                                                                    \
   V(ref_obj)                                                                   \
+  V(repeat)                                                                    \
   V(replace)                                                                   \
   V(repr)                                                                      \
   V(reset)                                                                     \
@@ -806,7 +866,8 @@ class Runtime;
   V(weakcallableproxy)                                                         \
   V(weakproxy)                                                                 \
   V(write)                                                                     \
-  V(xor)
+  V(xor)                                                                       \
+  V(zip_longest)
 
 // clang-format off
 enum class SymbolId {
@@ -821,6 +882,9 @@ enum class SymbolId {
 // Provides convenient, fast access to commonly used names. Stolen from Dart.
 class Symbols {
  public:
+  // Creates a table with all symbols set to 0, to be filled in by a visitor.
+  // Used when restoring the runtime from a heap snapshot.
+  Symbols();
   explicit Symbols(Runtime* runtime);
   ~Symbols();
 
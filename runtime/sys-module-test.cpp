@@ -9,6 +9,7 @@
 #include "gtest/gtest.h"
 
 #include "builtins.h"
+#include "ic-stats.h"
 #include "runtime.h"
 #include "str-builtins.h"
 #include "test-utils.h"
@@ -253,5 +254,99 @@ TEST_F(SysModuleTest, ByteorderIsCorrectString) {
       *byteorder, endian::native == endian::little ? "little" : "big"));
 }
 
+TEST_F(SysModuleTest, IcStatsReturnsDictOfCounters) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+import sys
+stats = sys._ic_stats()
+keys = sorted(stats.keys())
+enabled = stats["enabled"]
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Object keys(&scope, mainModuleAt(runtime_, "keys"));
+  EXPECT_PYLIST_EQ(keys, {"enabled", "executions", "jit_deopts",
+                          "megamorphic_cache_hits", "megamorphic_cache_misses",
+                          "misses", "rewrites", "transitions"});
+  EXPECT_EQ(mainModuleAt(runtime_, "enabled"), Bool::fromBool(kIcStatsEnabled));
+}
+
+TEST_F(SysModuleTest, IcStatsWithFunctionListsSpecializedSites) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+import sys
+class A:
+  def __init__(self):
+    self.x = 1
+class B:
+  def __init__(self):
+    self.x = 2
+def get(obj):
+  return obj.x
+get(A())
+get(B())
+result = sys._ic_stats(get) == [
+  (2, "LOAD_ATTR_POLYMORPHIC", "polymorphic", (A, B)),
+]
+)")
+                   .isError());
+  EXPECT_EQ(mainModuleAt(runtime_, "result"), Bool::trueObj());
+}
+
+TEST_F(SysModuleTest, IcStatsWithFunctionListsBinaryOpTypePairs) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+import sys
+def add(a, b):
+  return a + b
+add(1.0, 2.0)
+sites = sys._ic_stats(add)
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Object sites_obj(&scope, mainModuleAt(runtime_, "sites"));
+  ASSERT_TRUE(sites_obj.isList());
+  List sites(&scope, *sites_obj);
+  ASSERT_EQ(sites.numItems(), 1);
+  Tuple site(&scope, sites.at(0));
+  EXPECT_TRUE(isIntEqualsWord(site.at(0), 4));
+  EXPECT_TRUE(isStrEqualsCStr(site.at(1), "BINARY_OP_MONOMORPHIC"));
+  EXPECT_TRUE(isStrEqualsCStr(site.at(2), "monomorphic"));
+  Tuple types(&scope, site.at(3));
+  ASSERT_EQ(types.length(), 1);
+  Tuple pair(&scope, types.at(0));
+  Object float_type(&scope, runtime_->typeAt(LayoutId::kFloat));
+  EXPECT_EQ(pair.at(0), *float_type);
+  EXPECT_EQ(pair.at(1), *float_type);
+}
+
+TEST_F(SysModuleTest, IcStatsWithNonFunctionRaisesTypeError) {
+  EXPECT_TRUE(raisedWithStr(runFromCStr(runtime_, R"(
+import sys
+sys._ic_stats(1)
+)"),
+                            LayoutId::kTypeError,
+                            "'_ic_stats' for 'function' objects doesn't apply "
+                            "to a 'int' object"));
+}
+
+TEST_F(SysModuleTest, IcStatsCountRewriteCountsStateTransitions) {
+  IcStats stats = {};
+  stats.countRewrite(LOAD_ATTR_ANAMORPHIC, LOAD_ATTR_INSTANCE);
+  stats.countRewrite(LOAD_ATTR_INSTANCE, LOAD_ATTR_POLYMORPHIC);
+  stats.countRewrite(LOAD_ATTR_POLYMORPHIC, LOAD_ATTR_POLYMORPHIC);
+  stats.countRewrite(LOAD_GLOBAL_CACHED, LOAD_GLOBAL);
+  EXPECT_EQ(stats.rewrites[LOAD_ATTR_INSTANCE], 1);
+  EXPECT_EQ(stats.rewrites[LOAD_ATTR_POLYMORPHIC], 1);
+  EXPECT_EQ(stats.rewrites[LOAD_GLOBAL], 1);
+  auto transitions = [&](IcSiteState from, IcSiteState to) {
+    return stats.transitions[static_cast<word>(from)][static_cast<word>(to)];
+  };
+  EXPECT_EQ(transitions(IcSiteState::kAnamorphic, IcSiteState::kMonomorphic),
+            1);
+  EXPECT_EQ(transitions(IcSiteState::kMonomorphic, IcSiteState::kPolymorphic),
+            1);
+  EXPECT_EQ(transitions(IcSiteState::kPolymorphic, IcSiteState::kPolymorphic),
+            0);
+  EXPECT_EQ(transitions(IcSiteState::kMonomorphic, IcSiteState::kGeneric), 1);
+}
+
 }  // namespace testing
 }  // namespace py
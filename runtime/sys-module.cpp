@@ -20,6 +20,7 @@
 #include "frozen-modules.h"
 #include "globals.h"
 #include "handles.h"
+#include "ic-stats.h"
 #include "int-builtins.h"
 #include "module-builtins.h"
 #include "modules.h"
@@ -288,6 +289,19 @@ RawObject FUNC(sys, _getframe)(Thread* thread, Arguments args) {
   return *result;
 }
 
+RawObject FUNC(sys, _ic_stats)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object function_obj(&scope, args.get(0));
+  if (function_obj.isNoneType()) {
+    return icStatsAsDict(thread);
+  }
+  if (!function_obj.isFunction()) {
+    return thread->raiseRequiresType(function_obj, ID(function));
+  }
+  Function function(&scope, *function_obj);
+  return icStatsForFunction(thread, function);
+}
+
 RawObject FUNC(sys, _program_name)(Thread* thread, Arguments) {
   return newStrFromWideChar(thread, Runtime::programName());
 }
@@ -75,13 +75,15 @@ bool useCppInterpreter() {
          ::strcmp(pyro_cpp_interpreter, "1") == 0;
 }
 
-Runtime* createTestRuntime() {
+Runtime* createTestRuntime() { return createTestRuntimeWithSnapshot(nullptr); }
+
+Runtime* createTestRuntimeWithSnapshot(Snapshot* snapshot) {
   bool use_cpp_interpreter = useCppInterpreter();
-  word heap_size = 128 * kMiB;
+  word heap_size = kTestHeapSize;
   Interpreter* interpreter =
       use_cpp_interpreter ? createCppInterpreter() : createAsmInterpreter();
   RandomState random_state = randomState();
-  Runtime* runtime = new Runtime(heap_size, interpreter, random_state);
+  Runtime* runtime = new Runtime(heap_size, interpreter, random_state, snapshot);
   Thread* thread = Thread::current();
   CHECK(initializeSysWithDefaults(thread).isNoneType(),
         "initializeSys() failed");
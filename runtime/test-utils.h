@@ -31,8 +31,14 @@ namespace py {
 
 namespace testing {
 
+const word kTestHeapSize = 128 * kMiB;
+
 Runtime* createTestRuntime();
 
+// Starts the runtime from `snapshot` if it was opened for reading, otherwise
+// writes the snapshot while creating the runtime.
+Runtime* createTestRuntimeWithSnapshot(Snapshot* snapshot);
+
 bool useCppInterpreter();
 
 class RuntimeFixture : public ::testing::Test {
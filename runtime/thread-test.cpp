@@ -2,6 +2,7 @@
 #include "thread.h"
 
 #include <memory>
+#include <string>
 
 #include "gtest/gtest.h"
 
@@ -337,6 +338,21 @@ TEST_F(ThreadTest, ManipulateBlockStack) {
   EXPECT_EQ(popped1.level(), pushed1.level());
 }
 
+TEST_F(ThreadTest, BlockStackHasFinallyLooksPastExceptHandlers) {
+  Frame* frame = thread_->currentFrame();
+  EXPECT_FALSE(frame->blockStackHasFinally());
+
+  frame->blockStackPush(TryBlock(TryBlock::kFinally, 100, 10));
+  frame->blockStackPush(TryBlock(TryBlock::kExceptHandler, 200, 20));
+  EXPECT_TRUE(frame->blockStackHasFinally());
+
+  frame->blockStackPop();
+  frame->blockStackPop();
+  frame->blockStackPush(TryBlock(TryBlock::kExceptHandler, 200, 20));
+  EXPECT_FALSE(frame->blockStackHasFinally());
+  frame->blockStackPop();
+}
+
 TEST_F(ThreadTest, CallFunction) {
   HandleScope scope(thread_);
 
@@ -2114,5 +2130,43 @@ TEST_F(ThreadTest, StrOffsetWithCacheMissReturnsCorrectOffsets) {
   EXPECT_EQ(thread_->strOffset(str, 2), 2);
 }
 
+TEST_F(ThreadTest, StrOffsetAfterOutOfBoundsCacheMissReturnsCorrectOffsets) {
+  HandleScope scope(thread_);
+  Str str(&scope, runtime_->newStrFromCStr("abcdefghijk.py"));
+  EXPECT_EQ(thread_->strOffset(str, SmallInt::kMaxValue), 14);
+  EXPECT_EQ(thread_->strOffset(str, 0), 0);
+  EXPECT_EQ(thread_->strOffset(str, 11), 11);
+}
+
+TEST_F(ThreadTest, StrOffsetWithLongNonASCIIStrUsesIndex) {
+  HandleScope scope(thread_);
+  // Mix one, two and three byte code points across several checkpoints.
+  std::string text;
+  for (word i = 0; i < 200; i++) {
+    text += i % 3 == 0 ? "a" : i % 3 == 1 ? "\u00e9" : "\u20ac";
+  }
+  Str str(&scope, runtime_->newStrFromCStr(text.c_str()));
+  ASSERT_TRUE(str.isLargeStr());
+  EXPECT_EQ(thread_->strCodePointLength(str), 200);
+  for (word i = 0; i <= 200; i++) {
+    word offset = str.offsetByCodePoints(0, i);
+    EXPECT_EQ(thread_->strOffset(str, i), offset);
+    EXPECT_EQ(thread_->strCodePointIndex(str, offset), i);
+  }
+  EXPECT_EQ(thread_->strOffset(str, 1000), str.length());
+  runtime_->collectGarbage();
+  EXPECT_EQ(thread_->strOffset(str, 130), str.offsetByCodePoints(0, 130));
+}
+
+TEST_F(ThreadTest, StrOffsetWithLongASCIIStrReturnsIndex) {
+  HandleScope scope(thread_);
+  std::string text(300, 'x');
+  Str str(&scope, runtime_->newStrFromCStr(text.c_str()));
+  EXPECT_EQ(thread_->strCodePointLength(str), 300);
+  EXPECT_EQ(thread_->strOffset(str, 123), 123);
+  EXPECT_EQ(thread_->strOffset(str, 500), 300);
+  EXPECT_EQ(thread_->strCodePointIndex(str, 42), 42);
+}
+
 }  // namespace testing
 }  // namespace py
@@ -16,11 +16,14 @@
 #include "handles.h"
 #include "interpreter.h"
 #include "module-builtins.h"
+#include "mutex.h"
 #include "objects.h"
 #include "profiling.h"
 #include "runtime.h"
+#include "str-builtins.h"
 #include "tuple-builtins.h"
 #include "type-builtins.h"
+#include "unicode.h"
 #include "visitor.h"
 
 namespace py {
@@ -46,16 +49,55 @@ Thread::Thread(Runtime* runtime, word size) : runtime_(runtime) {
   limit_ = start_;
   stack_pointer_ = reinterpret_cast<RawObject*>(end_);
   current_frame_ = pushInitialFrame();
-  setCaughtExceptionState(runtime_->newExceptionState());
 }
 
 Thread::~Thread() { delete[] start_; }
 
 void Thread::begin() {
   Thread::setCurrentThread(this);
+  leaveBlockingRegion();
   runtime_->interpreter()->setupThread(this);
 }
 
+void Thread::enterBlockingRegion() {
+  __atomic_store_n(&at_safepoint_, true, __ATOMIC_SEQ_CST);
+}
+
+bool Thread::tryLeaveBlockingRegion() {
+  // Pairs with `Runtime::stopOtherThreads()`, which requests the stop before
+  // it checks whether this thread is at a safepoint.
+  __atomic_store_n(&at_safepoint_, false, __ATOMIC_SEQ_CST);
+  if (!runtime_->isStopRequested()) return true;
+  __atomic_store_n(&at_safepoint_, true, __ATOMIC_SEQ_CST);
+  return false;
+}
+
+void Thread::leaveBlockingRegion() {
+  while (!tryLeaveBlockingRegion()) {
+    runtime_->waitForResume();
+  }
+}
+
+ThreadMutexGuard::ThreadMutexGuard(Thread* thread, Mutex* mutex)
+    : mutex_(mutex) {
+  if (mutex->tryLock()) return;
+  if (thread == nullptr) {
+    mutex->lock();
+    return;
+  }
+  thread->enterBlockingRegion();
+  for (;;) {
+    mutex->lock();
+    if (thread->tryLeaveBlockingRegion()) return;
+    // Do not keep the lock while stopped; the thread collecting garbage may
+    // need it.
+    mutex->unlock();
+    thread->runtime()->waitForResume();
+  }
+}
+
+ThreadMutexGuard::~ThreadMutexGuard() { mutex_->unlock(); }
+
 void Thread::visitRoots(PointerVisitor* visitor) {
   visitStackRoots(visitor);
   handles()->visitPointers(visitor);
@@ -69,6 +111,10 @@ void Thread::visitRoots(PointerVisitor* visitor) {
   visitor->visitPointer(&pending_exc_value_, PointerKind::kThread);
   visitor->visitPointer(&profiling_data_, PointerKind::kThread);
   visitor->visitPointer(&str_offset_str_, PointerKind::kThread);
+  for (word i = 0; i < kStrIndexCacheSize; i++) {
+    visitor->visitPointer(&str_index_cache_[i].str, PointerKind::kThread);
+    visitor->visitPointer(&str_index_cache_[i].index, PointerKind::kThread);
+  }
 }
 
 void Thread::visitStackRoots(PointerVisitor* visitor) {
@@ -175,17 +221,22 @@ RawObject Thread::heapFrameAtDepth(word depth) {
 
 void Thread::setCurrentThread(Thread* thread) {
   Thread::current_thread_ = thread;
+  Heap::setCurrentBuffer(thread == nullptr ? nullptr
+                                           : thread->allocationBuffer());
 }
 
 void Thread::clearInterrupt(InterruptKind kind) {
-  interrupt_flags_ &= ~kind;
-  if (interrupt_flags_ == 0) {
+  // Interrupts may be raised from signal handlers, so the flags must be
+  // updated with a single read-modify-write.
+  uint8_t mask = ~kind;
+  if (__atomic_and_fetch(&interrupt_flags_, mask, __ATOMIC_RELAXED) == 0) {
     limit_ = start_;
   }
 }
 
 void Thread::interrupt(InterruptKind kind) {
-  interrupt_flags_ |= kind;
+  __atomic_fetch_or(&interrupt_flags_, static_cast<uint8_t>(kind),
+                    __ATOMIC_RELAXED);
   limit_ = end_;
 }
 
@@ -196,6 +247,9 @@ bool Thread::handleInterrupt(word size) {
     return true;
   }
   uint8_t interrupt_flags = interrupt_flags_;
+  if (interrupt_flags & kSafepoint) {
+    runtime_->safepoint(this);
+  }
   if ((interrupt_flags & kSignal) != 0 &&
       !runtime_->handlePendingSignals(this).isNoneType()) {
     return true;
@@ -204,6 +258,9 @@ bool Thread::handleInterrupt(word size) {
     clearInterrupt(kReinitInterpreter);
     runtime_->interpreter()->setupThread(this);
   }
+  if (interrupt_flags & kSample) {
+    runtime_->samplingProfiler()->sampleTime(this);
+  }
   return false;
 }
 
@@ -269,6 +326,12 @@ NEVER_INLINE Frame* Thread::handleInterruptPushCallFrame(
   if (handleInterrupt(max_stack_size)) {
     return nullptr;
   }
+  // Handling the interrupt may have moved the function. Reload it from the
+  // slot right above the arguments, where the new frame expects it.
+  byte* locals = reinterpret_cast<byte*>(stack_pointer_) - initial_stack_size +
+                 locals_offset;
+  function = Function::cast(reinterpret_cast<RawObject*>(
+      locals)[Frame::kFunctionOffsetFromLocals]);
   Frame* result =
       pushCallFrameImpl(function, initial_stack_size, locals_offset);
   handleInterruptWithFrame();
@@ -347,6 +410,7 @@ Frame* Thread::popFrameToGeneratorFrame(const GeneratorFrame& generator_frame) {
   word copy_size =
       (generator_frame.numFrameWords() - unused_stack) * kPointerSize;
   std::memcpy(dest, src, copy_size);
+  Space::markCards(reinterpret_cast<uword>(dest), copy_size);
   generator_frame.setStackSize(stack_size);
   return popFrame();
 }
@@ -862,12 +926,66 @@ void Thread::reprLeave(const Object& obj) {
   }
 }
 
+// Whether lookups into `str` go through a checkpoint index.
+static bool isIndexedStr(const Str& str) {
+  word length = str.length();
+  return kStrIndexMinLength <= length &&
+         length <= static_cast<word>(kMaxUint32);
+}
+
+RawObject Thread::strIndex(const Str& str) {
+  DCHECK(isIndexedStr(str), "string is not indexed");
+  for (word i = 0; i < kStrIndexCacheSize; i++) {
+    if (str_index_cache_[i].str == *str) return str_index_cache_[i].index;
+  }
+  HandleScope scope(this);
+  LargeStr large_str(&scope, *str);
+  RawObject data = strIndexBuild(this, large_str);
+  word slot = str_index_next_;
+  str_index_next_ = (slot + 1) % kStrIndexCacheSize;
+  str_index_cache_[slot].str = *large_str;
+  str_index_cache_[slot].index = data;
+  return data;
+}
+
+word Thread::strCodePointLength(const Str& str) {
+  if (!isIndexedStr(str)) return str.codePointLength();
+  RawObject index = strIndex(str);
+  if (index.isNoneType()) return str.length();
+  return strIndexCodePointLength(MutableBytes::cast(index));
+}
+
+word Thread::strCodePointIndex(const Str& str, word offset) {
+  if (isIndexedStr(str)) {
+    RawObject index = strIndex(str);
+    if (index.isNoneType()) return offset;
+    return strIndexCodePoint(LargeStr::cast(*str), MutableBytes::cast(index),
+                             offset);
+  }
+  word result = 0;
+  for (word i = 0; i < offset; i++) {
+    if (UTF8::isLeadByte(str.byteAt(i))) result++;
+  }
+  return result;
+}
+
 word Thread::strOffset(const Str& str, word index) {
+  if (index >= 0 && isIndexedStr(str)) {
+    RawObject str_index = strIndex(str);
+    if (str_index.isNoneType()) return Utils::minimum(index, str.length());
+    return strIndexOffset(LargeStr::cast(*str), MutableBytes::cast(str_index),
+                          index);
+  }
   if (str != str_offset_str_) {
-    str_offset_str_ = *str;
-    str_offset_index_ = index;
-    str_offset_offset_ = str.offsetByCodePoints(0, index);
-    return str_offset_offset_;
+    word offset = str.offsetByCodePoints(0, index);
+    // Only cache positions inside the string, so later lookups can walk from
+    // the cached offset by the difference in indices.
+    if (offset < str.length()) {
+      str_offset_str_ = *str;
+      str_offset_index_ = index;
+      str_offset_offset_ = offset;
+    }
+    return offset;
   }
   word index_diff = index - str_offset_index_;
   word offset = str.offsetByCodePoints(str_offset_offset_, index_diff);
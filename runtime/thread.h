@@ -4,6 +4,8 @@
 #include "frame.h"
 #include "globals.h"
 #include "handles-decl.h"
+#include "heap.h"
+#include "ic-stats.h"
 #include "objects.h"
 #include "os.h"
 #include "symbols.h"
@@ -17,6 +19,8 @@ class HandleScope;
 class PointerVisitor;
 class Runtime;
 
+class Mutex;
+
 class Handles {
  public:
   Handles() = default;
@@ -49,6 +53,10 @@ class Thread {
     kSignal = 1 << 0,
     kReinitInterpreter = 1 << 1,
     kProfile = 1 << 2,
+    kSample = 1 << 3,
+    // Another thread waits for this one to stop at a safepoint; see
+    // `Runtime::stopOtherThreads()`.
+    kSafepoint = 1 << 4,
   };
 
   explicit Thread(Runtime* runtime, word size);
@@ -138,6 +146,22 @@ class Thread {
 
   void clearInterrupt(InterruptKind kind);
   void interrupt(InterruptKind kind);
+  bool isInterrupted(InterruptKind kind) {
+    return (__atomic_load_n(&interrupt_flags_, __ATOMIC_RELAXED) & kind) != 0;
+  }
+
+  // A thread in a blocking region does not touch the heap, so it counts as
+  // stopped at a safepoint while it waits for a lock or a system call. Leaving
+  // the region waits for any garbage collection running meanwhile to finish.
+  void enterBlockingRegion();
+  void leaveBlockingRegion();
+  // Leaves the blocking region unless a garbage collection is running.
+  bool tryLeaveBlockingRegion();
+  bool isAtSafepoint() {
+    return __atomic_load_n(&at_safepoint_, __ATOMIC_SEQ_CST);
+  }
+
+  AllocationBuffer* allocationBuffer() { return &allocation_buffer_; }
 
   bool isMainThread();
 
@@ -377,6 +401,10 @@ class Thread {
   // to be accurate when `Runtime::supportProfiling()` is enabled.
   word opcodeCount() { return opcode_count_; }
 
+  // Inline cache counters of this thread. They only change when the runtime
+  // is built with `SKYBISON_IC_STATS`.
+  IcStats* icStats() { return &ic_stats_; }
+
   bool profilingEnabled();
   void enableProfiling();
   void disableProfiling();
@@ -384,7 +412,12 @@ class Thread {
   RawObject profilingData() { return profiling_data_; }
   void setProfilingData(RawObject data) { profiling_data_ = data; }
 
+  // Translate between code point indices and byte offsets of `str`. Long
+  // non-ASCII strings are indexed on first use and the index is cached, so
+  // repeated lookups into the same strings take constant time.
   word strOffset(const Str& str, word index);
+  word strCodePointLength(const Str& str);
+  word strCodePointIndex(const Str& str, word offset);
 
   bool wouldStackOverflow(word size);
   bool handleInterrupt(word size);
@@ -397,10 +430,20 @@ class Thread {
 
   static int opcodeCountOffset() { return offsetof(Thread, opcode_count_); }
 
+  static int icStatsOffset() { return offsetof(Thread, ic_stats_); }
+
   static int runtimeOffset() { return offsetof(Thread, runtime_); }
 
   static int limitOffset() { return offsetof(Thread, limit_); }
 
+  static int interruptFlagsOffset() {
+    return offsetof(Thread, interrupt_flags_);
+  }
+
+  static int allocationBufferOffset() {
+    return offsetof(Thread, allocation_buffer_);
+  }
+
   static int stackPointerOffset() { return offsetof(Thread, stack_pointer_); }
 
  private:
@@ -420,6 +463,10 @@ class Thread {
                                 word size);
   Frame* pushNativeFrameImpl(word locals_offset);
 
+  // Returns the checkpoint index of the long string `str`, or None if it is
+  // ASCII.
+  RawObject strIndex(const Str& str);
+
   Handles handles_;
 
   byte* start_;  // base address of the stack
@@ -431,6 +478,12 @@ class Thread {
   // Has the runtime requested a thread interruption? (e.g. signals, GC)
   uint8_t interrupt_flags_ = 0;
 
+  // Whether the thread is in a blocking region. Threads start out in one until
+  // they `begin()` running.
+  bool at_safepoint_ = true;
+
+  AllocationBuffer allocation_buffer_;
+
   // Number of opcodes executed in the thread while opcode counting was enabled.
   word opcode_count_ = 0;
 
@@ -464,17 +517,58 @@ class Thread {
   word str_offset_index_;
   word str_offset_offset_;
 
+  // Recently used strings and their checkpoint indexes; see `strIndex()`.
+  struct StrIndexEntry {
+    RawObject str = RawNoneType::object();
+    RawObject index = RawNoneType::object();
+  };
+  static const word kStrIndexCacheSize = 4;
+  StrIndexEntry str_index_cache_[kStrIndexCacheSize];
+  word str_index_next_ = 0;
+
   // C-API current recursion depth used via _PyThreadState_GetRecursionDepth
   int recursion_depth_ = 0;
 
   // C-API recursion limit as set via Py_SetRecursionLimit.
   int recursion_limit_ = 1000;  // CPython's default: Py_DEFAULT_RECURSION_LIMIT
 
+  // Kept last since it is large and rarely touched.
+  IcStats ic_stats_ = {};
+
   static thread_local Thread* current_thread_;
 
   DISALLOW_COPY_AND_ASSIGN(Thread);
 };
 
+// Keeps `thread` in a blocking region for the lifetime of the object. Object
+// handles stay valid inside the region, raw objects do not.
+class BlockingRegion {
+ public:
+  explicit BlockingRegion(Thread* thread) : thread_(thread) {
+    thread_->enterBlockingRegion();
+  }
+  ~BlockingRegion() { thread_->leaveBlockingRegion(); }
+
+ private:
+  Thread* thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(BlockingRegion);
+};
+
+// Like `MutexGuard`, but waits for a contended lock in a blocking region so
+// that the wait cannot hold up a garbage collection. `thread` may be nullptr
+// when no thread is running on this OS thread yet.
+class ThreadMutexGuard {
+ public:
+  ThreadMutexGuard(Thread* thread, Mutex* mutex);
+  ~ThreadMutexGuard();
+
+ private:
+  Mutex* mutex_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadMutexGuard);
+};
+
 inline RawObject* Thread::valueStackBase() {
   return reinterpret_cast<RawObject*>(current_frame_);
 }
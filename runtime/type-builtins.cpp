@@ -1172,6 +1172,8 @@ static const BuiltinAttribute kTypeAttributes[] = {
     {ID(_type__proxy), RawType::kProxyOffset, AttributeFlags::kHidden},
     {ID(_type__ctor), RawType::kCtorOffset, AttributeFlags::kHidden},
     {ID(_type__qualname), RawType::kQualnameOffset, AttributeFlags::kHidden},
+    {ID(_type__api_handle), RawType::kApiHandleOffset,
+     AttributeFlags::kHidden},
 };
 
 static const BuiltinAttribute kTypeProxyAttributes[] = {
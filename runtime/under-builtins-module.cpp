@@ -495,8 +495,11 @@ bool FUNC(_builtins, _str_guard_intrinsic)(Thread* thread) {
 bool FUNC(_builtins, _str_len_intrinsic)(Thread* thread) {
   RawObject arg = thread->stackPeek(0);
   if (arg.isStr()) {
+    HandleScope scope(thread);
+    Str str(&scope, arg);
+    word length = thread->strCodePointLength(str);
     thread->stackPop();
-    thread->stackSetTop(SmallInt::fromWord(Str::cast(arg).codePointLength()));
+    thread->stackSetTop(SmallInt::fromWord(length));
     return true;
   }
   return false;
@@ -1308,6 +1311,9 @@ RawObject FUNC(_builtins, _bytes_decode)(Thread* thread, Arguments args) {
       enc.compareCStr("iso-8859-1") != 0) {
     return Unbound::object();
   }
+  if (enc == utf8) {
+    return bytesDecodeUTF8(thread, bytes);
+  }
   return bytesDecodeASCII(thread, bytes);
 }
 
@@ -1328,7 +1334,7 @@ RawObject FUNC(_builtins, _bytes_decode_utf_8)(Thread* thread, Arguments args) {
     return Unbound::object();
   }
   Bytes bytes(&scope, *bytes_obj);
-  return bytesDecodeASCII(thread, bytes);
+  return bytesDecodeUTF8(thread, bytes);
 }
 
 RawObject FUNC(_builtins, _bytes_guard)(Thread* thread, Arguments args) {
@@ -3156,6 +3162,59 @@ static word digitValue(byte digit, word base) {
   return -1;
 }
 
+// Returns the int made of the base `base` digit values in `digits`, most
+// significant first. Runs of digits that fit into a word are converted
+// directly. These chunks are then combined pairwise as
+// `high * base**n + low`, doubling `n` every round. This needs far fewer
+// operations on large ints than adding one digit at a time and lets huge
+// conversions benefit from Karatsuba multiplication.
+static RawObject intFromDigits(Thread* thread, const Vector<byte>& digits,
+                               word base) {
+  word chunk_digits = 1;
+  word chunk_base = base;
+  while (chunk_base <= kMaxWord / base) {
+    chunk_base *= base;
+    chunk_digits++;
+  }
+  word num_digits = digits.size();
+  word num_chunks = (num_digits + chunk_digits - 1) / chunk_digits;
+  Runtime* runtime = thread->runtime();
+  HandleScope scope(thread);
+  MutableTuple parts(&scope, runtime->newMutableTuple(num_chunks));
+  // Chunks are numbered from the least significant one.
+  for (word i = 0; i < num_chunks; i++) {
+    word end = num_digits - i * chunk_digits;
+    word start = Utils::maximum(word{0}, end - chunk_digits);
+    word value = 0;
+    for (word j = start; j < end; j++) {
+      value = value * base + digits[j];
+    }
+    parts.atPut(i, runtime->newInt(value));
+  }
+
+  Int power(&scope, runtime->newInt(chunk_base));
+  Int high(&scope, SmallInt::fromWord(0));
+  Int low(&scope, SmallInt::fromWord(0));
+  word num_parts = num_chunks;
+  while (num_parts > 1) {
+    word num_combined = 0;
+    for (word i = 0; i + 1 < num_parts; i += 2) {
+      high = parts.at(i + 1);
+      low = parts.at(i);
+      high = runtime->intMultiply(thread, high, power);
+      parts.atPut(num_combined++, runtime->intAdd(thread, high, low));
+    }
+    if (num_parts % 2 == 1) {
+      parts.atPut(num_combined++, parts.at(num_parts - 1));
+    }
+    num_parts = num_combined;
+    if (num_parts > 1) {
+      power = runtime->intMultiply(thread, power, power);
+    }
+  }
+  return parts.at(0);
+}
+
 static word inferBase(byte second_byte) {
   switch (second_byte) {
     case 'x':
@@ -3219,11 +3278,8 @@ static RawObject intFromByteslike(Thread* thread, const Byteslike& byteslike,
     base = 10;
   }
 
-  Runtime* runtime = thread->runtime();
-  HandleScope scope(thread);
-  Int result(&scope, SmallInt::fromWord(0));
-  Int digit(&scope, SmallInt::fromWord(0));
-  Int base_obj(&scope, SmallInt::fromWord(base));
+  Vector<byte> digits;
+  digits.reserve(length - idx + 1);
   word num_start = idx;
   for (;;) {
     if (b == '_') {
@@ -3235,14 +3291,14 @@ static RawObject intFromByteslike(Thread* thread, const Byteslike& byteslike,
     }
     word digit_val = digitValue(b, base);
     if (digit_val == -1) return Error::error();
-    digit = Int::cast(SmallInt::fromWord(digit_val));
-    result = runtime->intAdd(thread, result, digit);
+    digits.push_back(digit_val);
     if (idx >= length) break;
     b = byteslike.byteAt(idx++);
-    result = runtime->intMultiply(thread, result, base_obj);
   }
+  HandleScope scope(thread);
+  Int result(&scope, intFromDigits(thread, digits, base));
   if (sign < 0) {
-    result = runtime->intNegate(thread, result);
+    return thread->runtime()->intNegate(thread, result);
   }
   return *result;
 }
@@ -3327,11 +3383,8 @@ static RawObject intFromStr(Thread* thread, const Str& str, word base) {
       return Error::error();
     }
   }
-  Runtime* runtime = thread->runtime();
-  HandleScope scope(thread);
-  Int result(&scope, SmallInt::fromWord(0));
-  Int digit(&scope, SmallInt::fromWord(0));
-  Int base_obj(&scope, SmallInt::fromWord(base));
+  Vector<byte> digits;
+  digits.reserve(str.length() - start);
   for (word i = start; i < str.length(); i++) {
     byte digit_char = str.byteAt(i);
     if (digit_char == '_') {
@@ -3343,12 +3396,12 @@ static RawObject intFromStr(Thread* thread, const Str& str, word base) {
     }
     word digit_val = digitValue(digit_char, base);
     if (digit_val == -1) return Error::error();
-    digit = Int::cast(SmallInt::fromWord(digit_val));
-    result = runtime->intMultiply(thread, result, base_obj);
-    result = runtime->intAdd(thread, result, digit);
+    digits.push_back(digit_val);
   }
+  HandleScope scope(thread);
+  Int result(&scope, intFromDigits(thread, digits, base));
   if (sign < 0) {
-    result = runtime->intNegate(thread, result);
+    return thread->runtime()->intNegate(thread, result);
   }
   return *result;
 }
@@ -3418,6 +3471,25 @@ RawObject FUNC(_builtins, _jit_iscompiled)(Thread* thread, Arguments args) {
   return Bool::fromBool(function.isCompiled());
 }
 
+RawObject FUNC(_builtins, _jit_num_tier_ups)(Thread* thread, Arguments) {
+  return SmallInt::fromWord(thread->runtime()->numJitTierUps());
+}
+
+RawObject FUNC(_builtins, _jit_set_threshold)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object threshold(&scope, args.get(0));
+  if (!threshold.isSmallInt()) {
+    return thread->raiseRequiresType(threshold, ID(int));
+  }
+  word value = SmallInt::cast(*threshold).value();
+  if (value < 0) {
+    return thread->raiseWithFmt(LayoutId::kValueError,
+                                "threshold must be non-negative");
+  }
+  thread->runtime()->setJitThreshold(value);
+  return NoneType::object();
+}
+
 RawObject FUNC(_builtins, _list_append)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   Object self(&scope, args.get(0));
@@ -4260,6 +4332,48 @@ RawObject FUNC(_builtins, _profiler_install)(Thread* thread, Arguments args) {
   return NoneType::object();
 }
 
+RawObject FUNC(_builtins, _profiler_sample_start)(Thread* thread,
+                                                   Arguments args) {
+  HandleScope scope(thread);
+  Object interval_obj(&scope, args.get(0));
+  Object allocation_interval_obj(&scope, args.get(1));
+  if (!interval_obj.isSmallInt() ||
+      SmallInt::cast(*interval_obj).value() < 0) {
+    return thread->raiseWithFmt(
+        LayoutId::kValueError,
+        "'_profiler_sample_start' requires a non-negative interval");
+  }
+  if (!allocation_interval_obj.isSmallInt() ||
+      SmallInt::cast(*allocation_interval_obj).value() < 0) {
+    return thread->raiseWithFmt(
+        LayoutId::kValueError,
+        "'_profiler_sample_start' requires a non-negative allocation interval");
+  }
+  word interval_usec = SmallInt::cast(*interval_obj).value();
+  word allocation_interval = SmallInt::cast(*allocation_interval_obj).value();
+  allocation_interval = Utils::roundUp(allocation_interval, kPointerSize);
+  if (!thread->runtime()->samplingProfiler()->start(thread, interval_usec,
+                                                    allocation_interval)) {
+    return thread->raiseOSErrorFromErrno(errno);
+  }
+  return NoneType::object();
+}
+
+RawObject FUNC(_builtins, _profiler_sample_stop)(Thread* thread, Arguments) {
+  thread->runtime()->samplingProfiler()->stop();
+  return NoneType::object();
+}
+
+RawObject FUNC(_builtins, _profiler_samples)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  SamplingProfiler* profiler = thread->runtime()->samplingProfiler();
+  Object result(&scope, profiler->samples(thread));
+  if (args.get(0) == Bool::trueObj()) {
+    profiler->clear();
+  }
+  return *result;
+}
+
 RawObject FUNC(_builtins, _property)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   Object getter(&scope, args.get(0));
@@ -5048,7 +5162,7 @@ RawObject FUNC(_builtins, _str_find)(Thread* thread, Arguments args) {
   if (!end_obj.isNoneType()) {
     end = intUnderlying(*end_obj).asWordSaturated();
   }
-  word result = strFindWithRange(haystack, needle, start, end);
+  word result = strFindWithRange(thread, haystack, needle, start, end);
   return SmallInt::fromWord(result);
 }
 
@@ -5081,7 +5195,7 @@ RawObject FUNC(_builtins, _str_getitem)(Thread* thread, Arguments args) {
                                   &key);
     }
     if (index < 0) {
-      index += self.codePointLength();
+      index += thread->strCodePointLength(self);
     }
     if (index >= 0) {
       word offset = thread->strOffset(self, index);
@@ -5101,8 +5215,8 @@ RawObject FUNC(_builtins, _str_getitem)(Thread* thread, Arguments args) {
 
   // Manually adjust slice bounds to avoid an extra call to codePointLength
   Str self(&scope, strUnderlying(*self_obj));
-  word start_index = adjustedStrIndex(self, start);
-  word stop_index = adjustedStrIndex(self, stop);
+  word start_index = adjustedStrIndex(thread, self, start);
+  word stop_index = adjustedStrIndex(thread, self, stop);
   word length = stop_index - start_index;
   if (length <= 0) return Str::empty();
   return strSubstr(thread, self, start_index, length);
@@ -5144,7 +5258,7 @@ RawObject FUNC(_builtins, _str_join)(Thread* thread, Arguments args) {
 RawObject FUNC(_builtins, _str_len)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   Str self(&scope, strUnderlying(args.get(0)));
-  return SmallInt::fromWord(self.codePointLength());
+  return SmallInt::fromWord(thread->strCodePointLength(self));
 }
 
 RawObject FUNC(_builtins, _str_ljust)(Thread* thread, Arguments args) {
@@ -1,10 +1,13 @@
 // Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include <cstring>
+
 #include "gtest/gtest.h"
 
 #include "builtins.h"
 #include "bytearray-builtins.h"
 #include "runtime.h"
 #include "test-utils.h"
+#include "unicode.h"
 
 namespace py {
 namespace testing {
@@ -128,6 +131,84 @@ TEST_F(CodecsModuleTest, DecodeUTF8WithWellFormedUTF8ReturnsString) {
   EXPECT_TRUE(isStrEqualsCStr(result.at(2), ""));
 }
 
+TEST_F(CodecsModuleTest, DecodeUTF8WithLongWellFormedUTF8ReturnsString) {
+  HandleScope scope(thread_);
+  const char* expected =
+      "The quick brown fox \xC3\xA9 jumps over \xE2\xB3\x80 the lazy dog "
+      "\xF0\x9D\x87\xB0 and keeps running \xED\x9F\xBF past \xF4\x8F\xBF\xBF";
+  word length = std::strlen(expected);
+  Object bytes(&scope,
+               runtime_->newBytesWithAll(View<byte>(
+                   reinterpret_cast<const byte*>(expected), length)));
+  Object errors(&scope, runtime_->newStrFromCStr("strict"));
+  Object index(&scope, runtime_->newInt(4));
+  Object strarray(&scope, runtime_->newStrArray());
+  Object is_final(&scope, Bool::trueObj());
+  Object result_obj(&scope, runBuiltin(FUNC(_codecs, _utf_8_decode), bytes,
+                                       errors, index, strarray, is_final));
+  ASSERT_TRUE(result_obj.isTuple());
+
+  Tuple result(&scope, *result_obj);
+  EXPECT_TRUE(isStrEqualsCStr(result.at(0), expected + 4));
+  EXPECT_TRUE(isIntEqualsWord(result.at(1), length));
+  EXPECT_TRUE(isStrEqualsCStr(result.at(2), ""));
+}
+
+TEST_F(CodecsModuleTest, DecodeUTF8WithLateSurrogateReturnsIndices) {
+  HandleScope scope(thread_);
+  const char* encoded =
+      "a long run of ascii text that spans more than one block \xED\xA0\x80";
+  word length = std::strlen(encoded);
+  Object bytes(&scope,
+               runtime_->newBytesWithAll(View<byte>(
+                   reinterpret_cast<const byte*>(encoded), length)));
+  Object errors(&scope, runtime_->newStrFromCStr("strict"));
+  Object index(&scope, runtime_->newInt(0));
+  Object strarray(&scope, runtime_->newStrArray());
+  Object is_final(&scope, Bool::trueObj());
+  Object result_obj(&scope, runBuiltin(FUNC(_codecs, _utf_8_decode), bytes,
+                                       errors, index, strarray, is_final));
+  ASSERT_TRUE(result_obj.isTuple());
+
+  Tuple result(&scope, *result_obj);
+  EXPECT_TRUE(isIntEqualsWord(result.at(0), length - 3));
+  EXPECT_TRUE(isIntEqualsWord(result.at(1), length - 2));
+  EXPECT_TRUE(isStrEqualsCStr(result.at(2), "invalid continuation byte"));
+}
+
+TEST_F(CodecsModuleTest, UTF8IsValidChecksSequencesAtEveryOffset) {
+  struct Case {
+    const char* sequence;
+    bool valid;
+  };
+  Case cases[] = {
+      {"\xC2\x80", true},          {"\xDF\xBF", true},
+      {"\xE0\xA0\x80", true},      {"\xED\x9F\xBF", true},
+      {"\xEE\x80\x80", true},      {"\xF0\x90\x80\x80", true},
+      {"\xF4\x8F\xBF\xBF", true},  {"\x80", false},
+      {"\xC0\x80", false},         {"\xC1\xBF", false},
+      {"\xC2", false},             {"\xC2\x41", false},
+      {"\xE0\x80\x80", false},     {"\xE0\x9F\xBF", false},
+      {"\xED\xA0\x80", false},     {"\xED\xBF\xBF", false},
+      {"\xE2\x82", false},         {"\xE2\x82\xAC\x80", false},
+      {"\xF0\x80\x80\x80", false}, {"\xF0\x8F\xBF\xBF", false},
+      {"\xF4\x90\x80\x80", false}, {"\xF5\x80\x80\x80", false},
+      {"\xF0\x90\x80", false},     {"\xFF", false},
+  };
+  byte buffer[80];
+  for (const Case& c : cases) {
+    word length = std::strlen(c.sequence);
+    for (word offset = 0; offset + length <= 70; offset++) {
+      std::memset(buffer, 'a', sizeof(buffer));
+      std::memcpy(buffer + offset, c.sequence, length);
+      EXPECT_EQ(UTF8::isValid(buffer, sizeof(buffer)), c.valid)
+          << "sequence at offset " << offset;
+      EXPECT_EQ(UTF8::isValid(buffer, offset + length), c.valid)
+          << "sequence at end of " << offset + length << " bytes";
+    }
+  }
+}
+
 TEST_F(CodecsModuleTest, DecodeUTF8WithIgnoreErrorHandlerReturnsStr) {
   HandleScope scope(thread_);
   byte encoded[] = {'h', 'e', 'l', 'l', 0x80, 'o'};
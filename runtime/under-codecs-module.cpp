@@ -771,7 +771,21 @@ RawObject FUNC(_codecs, _utf_8_decode)(Thread* thread, Arguments args) {
   Byteslike bytes(&scope, thread, *data);
   length = bytes.length();
   runtime->strArrayEnsureCapacity(thread, dst, length);
-  word i = asciiDecode(thread, dst, bytes, index, length);
+  word i;
+  if (UTF8::isValid(reinterpret_cast<byte*>(bytes.address() + index),
+                    length - index)) {
+    // Valid input is already in the internal representation of str.
+    word num_items = dst.numItems();
+    word new_length = num_items + length - index;
+    runtime->strArrayEnsureCapacity(thread, dst, new_length);
+    byte* dst_bytes =
+        reinterpret_cast<byte*>(MutableBytes::cast(dst.items()).address());
+    bytes.copyToStartAt(dst_bytes + num_items, length - index, index);
+    dst.setNumItems(new_length);
+    i = length;
+  } else {
+    i = asciiDecode(thread, dst, bytes, index, length);
+  }
   if (i == length) {
     Object dst_obj(&scope, runtime->strFromStrArray(dst));
     Object length_obj(&scope, runtime->newInt(length));
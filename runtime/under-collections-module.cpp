@@ -2,9 +2,11 @@
 #include "under-collections-module.h"
 
 #include "builtins.h"
+#include "dict-builtins.h"
 #include "frame.h"
 #include "globals.h"
 #include "int-builtins.h"
+#include "interpreter.h"
 #include "objects.h"
 #include "runtime.h"
 #include "slice-builtins.h"
@@ -194,6 +196,47 @@ RawObject FUNC(_collections, _deque_setitem)(Thread* thread, Arguments args) {
   return NoneType::object();
 }
 
+RawObject FUNC(_collections, _ordered_dict_move_to_end)(Thread* thread,
+                                                       Arguments args) {
+  HandleScope scope(thread);
+  Object self_obj(&scope, args.get(0));
+  Runtime* runtime = thread->runtime();
+  if (!runtime->isInstanceOfDict(*self_obj)) {
+    return thread->raiseRequiresType(self_obj, ID(dict));
+  }
+  Dict self(&scope, *self_obj);
+  Object key(&scope, args.get(1));
+  Object hash_obj(&scope, Interpreter::hash(thread, key));
+  if (hash_obj.isErrorException()) return *hash_obj;
+  word hash = SmallInt::cast(*hash_obj).value();
+  Object last(&scope, Interpreter::isTrue(thread, args.get(2)));
+  if (last.isErrorException()) return *last;
+  Object result(&scope, dictMoveToEnd(thread, self, key, hash,
+                                      last == Bool::trueObj()));
+  if (result.isErrorNotFound()) {
+    return thread->raise(LayoutId::kKeyError, *key);
+  }
+  return *result;
+}
+
+RawObject FUNC(_collections, _ordered_dict_popitem)(Thread* thread,
+                                                   Arguments args) {
+  HandleScope scope(thread);
+  Object self_obj(&scope, args.get(0));
+  Runtime* runtime = thread->runtime();
+  if (!runtime->isInstanceOfDict(*self_obj)) {
+    return thread->raiseRequiresType(self_obj, ID(dict));
+  }
+  Dict self(&scope, *self_obj);
+  Object last(&scope, Interpreter::isTrue(thread, args.get(1)));
+  if (last.isErrorException()) return *last;
+  Object result(&scope, dictPopitem(thread, self, last == Bool::trueObj()));
+  if (result.isErrorNotFound()) {
+    return thread->raiseWithFmt(LayoutId::kKeyError, "dictionary is empty");
+  }
+  return *result;
+}
+
 RawObject METH(_deque_iterator, __length_hint__)(Thread* thread,
                                                  Arguments args) {
   HandleScope scope(thread);
@@ -0,0 +1,324 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "under-functools-module.h"
+
+#include "builtins.h"
+#include "dict-builtins.h"
+#include "handles.h"
+#include "int-builtins.h"
+#include "interpreter.h"
+#include "modules.h"
+#include "objects.h"
+#include "runtime.h"
+#include "thread.h"
+#include "type-builtins.h"
+
+namespace py {
+
+static const BuiltinAttribute kLruCacheWrapperAttributes[] = {
+    {ID(_lru_cache_wrapper__wrapped), RawLruCacheWrapper::kWrappedOffset,
+     AttributeFlags::kHidden},
+    {ID(_lru_cache_wrapper__cache), RawLruCacheWrapper::kCacheOffset,
+     AttributeFlags::kHidden},
+    {ID(_lru_cache_wrapper__root), RawLruCacheWrapper::kRootOffset,
+     AttributeFlags::kHidden},
+    {ID(_lru_cache_wrapper__maxsize), RawLruCacheWrapper::kMaxsizeOffset,
+     AttributeFlags::kHidden},
+    {ID(_lru_cache_wrapper__typed), RawLruCacheWrapper::kTypedOffset,
+     AttributeFlags::kHidden},
+    {ID(_lru_cache_wrapper__cache_info_type),
+     RawLruCacheWrapper::kCacheInfoTypeOffset, AttributeFlags::kHidden},
+    {ID(_lru_cache_wrapper__hits), RawLruCacheWrapper::kHitsOffset,
+     AttributeFlags::kHidden},
+    {ID(_lru_cache_wrapper__misses), RawLruCacheWrapper::kMissesOffset,
+     AttributeFlags::kHidden},
+};
+
+void initializeUnderFunctoolsTypes(Thread* thread) {
+  HandleScope scope(thread);
+  Type type(&scope, addBuiltinType(thread, ID(_lru_cache_wrapper),
+                                   LayoutId::kLruCacheWrapper,
+                                   /*superclass_id=*/LayoutId::kObject,
+                                   kLruCacheWrapperAttributes,
+                                   LruCacheWrapper::kSize, /*basetype=*/false));
+  // functools.update_wrapper() copies __name__, __doc__ and friends onto the
+  // wrapper.
+  builtinTypeEnableTupleOverflow(thread, type);
+}
+
+// Returns the cache key for a call. Calls without keyword arguments use the
+// positional arguments tuple itself, and a single int or str argument is its
+// own key, so the common cases do not allocate.
+static RawObject lruCacheKey(Thread* thread, bool typed, const Tuple& args,
+                             const Dict& kwargs) {
+  word num_args = args.length();
+  word num_kwargs = kwargs.numItems();
+  if (num_kwargs == 0 && !typed) {
+    if (num_args == 1) {
+      RawObject arg = args.at(0);
+      if (arg.isSmallInt() || arg.isLargeInt() || arg.isStr()) return arg;
+    }
+    return *args;
+  }
+  word length = num_args;
+  if (num_kwargs > 0) length += 1 + num_kwargs * 2;
+  if (typed) length += num_args + num_kwargs;
+  if (length == 0) return *args;
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  MutableTuple key(&scope, runtime->newMutableTuple(length));
+  key.replaceFromWith(0, *args, num_args);
+  word index = num_args;
+  if (num_kwargs > 0) {
+    // Separate the positional from the keyword arguments with a marker that
+    // ordinary arguments are very unlikely to be.
+    key.atPut(index++, runtime->typeAt(LayoutId::kLruCacheWrapper));
+    Object name(&scope, NoneType::object());
+    Object value(&scope, NoneType::object());
+    for (word i = 0; dictNextItem(kwargs, &i, &name, &value);) {
+      key.atPut(index++, *name);
+      key.atPut(index++, *value);
+    }
+  }
+  if (typed) {
+    for (word i = 0; i < num_args; i++) {
+      key.atPut(index++, runtime->typeOf(args.at(i)));
+    }
+    Object value(&scope, NoneType::object());
+    for (word i = 0; dictNextValue(kwargs, &i, &value);) {
+      key.atPut(index++, runtime->typeOf(*value));
+    }
+  }
+  DCHECK(index == length, "key length mismatch");
+  return key.becomeImmutable();
+}
+
+static RawObject lruCacheCallWrapped(Thread* thread,
+                                     const LruCacheWrapper& self,
+                                     const Tuple& args, const Dict& kwargs) {
+  thread->stackPush(self.wrapped());
+  thread->stackPush(*args);
+  thread->stackPush(*kwargs);
+  return Interpreter::callEx(thread, CallFunctionExFlag::VAR_KEYWORDS);
+}
+
+// Unlinks `link` from the LRU list.
+static void lruLinkExtract(RawMutableTuple link) {
+  RawMutableTuple prev =
+      MutableTuple::cast(link.at(LruCacheWrapper::kLinkPrevIndex));
+  RawMutableTuple next =
+      MutableTuple::cast(link.at(LruCacheWrapper::kLinkNextIndex));
+  prev.atPut(LruCacheWrapper::kLinkNextIndex, next);
+  next.atPut(LruCacheWrapper::kLinkPrevIndex, prev);
+}
+
+// Inserts `link` as the most recently used entry, just before `root`.
+static void lruLinkAppend(RawMutableTuple root, RawMutableTuple link) {
+  RawMutableTuple last =
+      MutableTuple::cast(root.at(LruCacheWrapper::kLinkPrevIndex));
+  last.atPut(LruCacheWrapper::kLinkNextIndex, link);
+  root.atPut(LruCacheWrapper::kLinkPrevIndex, link);
+  link.atPut(LruCacheWrapper::kLinkPrevIndex, last);
+  link.atPut(LruCacheWrapper::kLinkNextIndex, root);
+}
+
+static void lruLinkInitRoot(RawMutableTuple root) {
+  root.atPut(LruCacheWrapper::kLinkPrevIndex, root);
+  root.atPut(LruCacheWrapper::kLinkNextIndex, root);
+  root.atPut(LruCacheWrapper::kLinkHashIndex, NoneType::object());
+  root.atPut(LruCacheWrapper::kLinkKeyIndex, NoneType::object());
+  root.atPut(LruCacheWrapper::kLinkResultIndex, NoneType::object());
+}
+
+static RawObject lruCacheBoundedCall(Thread* thread,
+                                     const LruCacheWrapper& self,
+                                     const Tuple& args, const Dict& kwargs,
+                                     const Object& key, word hash) {
+  HandleScope scope(thread);
+  Dict cache(&scope, self.cache());
+  Object link_obj(&scope, dictAt(thread, cache, key, hash));
+  if (!link_obj.isErrorNotFound()) {
+    if (link_obj.isErrorException()) return *link_obj;
+    RawMutableTuple link = MutableTuple::cast(*link_obj);
+    lruLinkExtract(link);
+    lruLinkAppend(MutableTuple::cast(self.root()), link);
+    self.setHits(self.hits() + 1);
+    return link.at(LruCacheWrapper::kLinkResultIndex);
+  }
+  self.setMisses(self.misses() + 1);
+  Object result(&scope, lruCacheCallWrapped(thread, self, args, kwargs));
+  if (result.isErrorException()) return *result;
+  // The user function may have cached the same key while it ran.
+  Object present(&scope, dictAt(thread, cache, key, hash));
+  if (present.isErrorException()) return *present;
+  if (!present.isErrorNotFound()) return *result;
+
+  MutableTuple root(&scope, self.root());
+  word maxsize = SmallInt::cast(self.maxsize()).value();
+  if (cache.numItems() < maxsize ||
+      root.at(LruCacheWrapper::kLinkNextIndex) == *root) {
+    MutableTuple link(
+        &scope, thread->runtime()->newMutableTuple(LruCacheWrapper::kLinkSize));
+    link.atPut(LruCacheWrapper::kLinkHashIndex, SmallInt::fromWord(hash));
+    link.atPut(LruCacheWrapper::kLinkKeyIndex, *key);
+    link.atPut(LruCacheWrapper::kLinkResultIndex, *result);
+    Object put_result(&scope, dictAtPut(thread, cache, key, hash, link));
+    if (put_result.isErrorException()) return *put_result;
+    lruLinkAppend(*root, *link);
+    return *result;
+  }
+
+  // Recycle the least recently used link for the new entry.
+  MutableTuple oldest(&scope, root.at(LruCacheWrapper::kLinkNextIndex));
+  lruLinkExtract(*oldest);
+  Object oldest_key(&scope, oldest.at(LruCacheWrapper::kLinkKeyIndex));
+  word oldest_hash =
+      SmallInt::cast(oldest.at(LruCacheWrapper::kLinkHashIndex)).value();
+  Object removed(&scope, dictRemove(thread, cache, oldest_key, oldest_hash));
+  if (removed.isErrorException()) return *removed;
+  // A reentrant call already removed the link from the cache.
+  if (removed.isErrorNotFound()) return *result;
+  oldest.atPut(LruCacheWrapper::kLinkHashIndex, SmallInt::fromWord(hash));
+  oldest.atPut(LruCacheWrapper::kLinkKeyIndex, *key);
+  oldest.atPut(LruCacheWrapper::kLinkResultIndex, *result);
+  Object put_result(&scope, dictAtPut(thread, cache, key, hash, oldest));
+  if (put_result.isErrorException()) return *put_result;
+  lruLinkAppend(*root, *oldest);
+  return *result;
+}
+
+RawObject METH(_lru_cache_wrapper, __call__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self_obj(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfLruCacheWrapper(*self_obj)) {
+    return thread->raiseRequiresType(self_obj, ID(_lru_cache_wrapper));
+  }
+  LruCacheWrapper self(&scope, *self_obj);
+  Tuple call_args(&scope, args.get(1));
+  Dict call_kwargs(&scope, args.get(2));
+  if (self.maxsize() == SmallInt::fromWord(0)) {
+    self.setMisses(self.misses() + 1);
+    return lruCacheCallWrapped(thread, self, call_args, call_kwargs);
+  }
+  Object key(&scope,
+             lruCacheKey(thread, self.typed(), call_args, call_kwargs));
+  Object hash_obj(&scope, Interpreter::hash(thread, key));
+  if (hash_obj.isErrorException()) return *hash_obj;
+  word hash = SmallInt::cast(*hash_obj).value();
+  if (!self.maxsize().isNoneType()) {
+    return lruCacheBoundedCall(thread, self, call_args, call_kwargs, key,
+                               hash);
+  }
+  Dict cache(&scope, self.cache());
+  Object result(&scope, dictAt(thread, cache, key, hash));
+  if (!result.isErrorNotFound()) {
+    if (result.isErrorException()) return *result;
+    self.setHits(self.hits() + 1);
+    return *result;
+  }
+  self.setMisses(self.misses() + 1);
+  result = lruCacheCallWrapped(thread, self, call_args, call_kwargs);
+  if (result.isErrorException()) return *result;
+  Object put_result(&scope, dictAtPut(thread, cache, key, hash, result));
+  if (put_result.isErrorException()) return *put_result;
+  return *result;
+}
+
+RawObject METH(_lru_cache_wrapper, __get__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfLruCacheWrapper(*self)) {
+    return thread->raiseRequiresType(self, ID(_lru_cache_wrapper));
+  }
+  Object instance(&scope, args.get(1));
+  if (instance.isNoneType()) return *self;
+  return thread->runtime()->newBoundMethod(self, instance);
+}
+
+RawObject METH(_lru_cache_wrapper, __new__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object type_obj(&scope, args.get(0));
+  Runtime* runtime = thread->runtime();
+  if (!runtime->isInstanceOfType(*type_obj)) {
+    return thread->raiseWithFmt(LayoutId::kTypeError, "not a type object");
+  }
+  Type type(&scope, *type_obj);
+  if (type.builtinBase() != LayoutId::kLruCacheWrapper) {
+    return thread->raiseWithFmt(LayoutId::kTypeError,
+                                "not a subtype of _lru_cache_wrapper");
+  }
+  Object user_function(&scope, args.get(1));
+  if (!runtime->isCallable(thread, user_function)) {
+    return thread->raiseWithFmt(LayoutId::kTypeError,
+                                "the first argument must be callable");
+  }
+  Object maxsize_obj(&scope, args.get(2));
+  if (!maxsize_obj.isNoneType()) {
+    if (!runtime->isInstanceOfInt(*maxsize_obj)) {
+      return thread->raiseWithFmt(LayoutId::kTypeError,
+                                  "maxsize should be integer or None");
+    }
+    word maxsize = intUnderlying(*maxsize_obj).asWordSaturated();
+    if (maxsize < 0) maxsize = 0;
+    if (maxsize > SmallInt::kMaxValue) maxsize = SmallInt::kMaxValue;
+    maxsize_obj = SmallInt::fromWord(maxsize);
+  }
+  Object typed(&scope, Interpreter::isTrue(thread, args.get(3)));
+  if (typed.isErrorException()) return *typed;
+
+  Layout layout(&scope, type.instanceLayout());
+  LruCacheWrapper result(&scope, runtime->newInstance(layout));
+  result.setWrapped(*user_function);
+  result.setCache(runtime->newDict());
+  if (maxsize_obj.isNoneType() || maxsize_obj == SmallInt::fromWord(0)) {
+    result.setRoot(NoneType::object());
+  } else {
+    MutableTuple root(&scope,
+                      runtime->newMutableTuple(LruCacheWrapper::kLinkSize));
+    lruLinkInitRoot(*root);
+    result.setRoot(*root);
+  }
+  result.setMaxsize(*maxsize_obj);
+  result.setTyped(Bool::cast(*typed).value());
+  result.setCacheInfoType(args.get(4));
+  result.setHits(0);
+  result.setMisses(0);
+  return *result;
+}
+
+RawObject METH(_lru_cache_wrapper, cache_clear)(Thread* thread,
+                                                Arguments args) {
+  HandleScope scope(thread);
+  Object self_obj(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfLruCacheWrapper(*self_obj)) {
+    return thread->raiseRequiresType(self_obj, ID(_lru_cache_wrapper));
+  }
+  LruCacheWrapper self(&scope, *self_obj);
+  if (!self.root().isNoneType()) {
+    lruLinkInitRoot(MutableTuple::cast(self.root()));
+  }
+  Dict cache(&scope, self.cache());
+  dictClear(thread, cache);
+  self.setHits(0);
+  self.setMisses(0);
+  return NoneType::object();
+}
+
+RawObject METH(_lru_cache_wrapper, cache_info)(Thread* thread,
+                                               Arguments args) {
+  HandleScope scope(thread);
+  Object self_obj(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfLruCacheWrapper(*self_obj)) {
+    return thread->raiseRequiresType(self_obj, ID(_lru_cache_wrapper));
+  }
+  LruCacheWrapper self(&scope, *self_obj);
+  Object cache_info_type(&scope, self.cacheInfoType());
+  Object hits(&scope, SmallInt::fromWord(self.hits()));
+  Object misses(&scope, SmallInt::fromWord(self.misses()));
+  Object maxsize(&scope, self.maxsize());
+  Object currsize(&scope,
+                  SmallInt::fromWord(Dict::cast(self.cache()).numItems()));
+  return Interpreter::call4(thread, cache_info_type, hits, misses, maxsize,
+                            currsize);
+}
+
+}  // namespace py
@@ -0,0 +1,10 @@
+/* Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com) */
+#pragma once
+
+namespace py {
+
+class Thread;
+
+void initializeUnderFunctoolsTypes(Thread* thread);
+
+}  // namespace py
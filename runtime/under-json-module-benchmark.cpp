@@ -0,0 +1,59 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "benchmark/benchmark.h"
+
+#include "benchmark-utils.h"
+#include "handles.h"
+#include "interpreter.h"
+#include "runtime.h"
+
+namespace py {
+namespace testing {
+
+using UnderJsonModuleBenchmark = RuntimeBenchmark;
+
+BENCHMARK_DEFINE_F(UnderJsonModuleBenchmark, Loads)(benchmark::State& state) {
+  CHECK(!runFromCStr(runtime_, R"(
+from _json import loads as json_loads
+json_document = "[" + ", ".join(
+  f'{{"id": {i}, "name": "item {i}", "price": {i}.25, "tags": ["a", "b"], '
+  f'"active": {"true" if i % 2 else "false"}, "parent": null}}'
+  for i in range(200)
+) + "]"
+)")
+             .isError(),
+        "setup failed");
+  HandleScope scope(thread_);
+  Object loads(&scope, mainModuleAt(runtime_, "json_loads"));
+  Str document(&scope, mainModuleAt(runtime_, "json_document"));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Interpreter::call1(thread_, loads, document));
+  }
+  state.SetBytesProcessed(state.iterations() * document.length());
+}
+BENCHMARK_REGISTER_F(UnderJsonModuleBenchmark, Loads);
+
+BENCHMARK_DEFINE_F(UnderJsonModuleBenchmark, Dumps)(benchmark::State& state) {
+  CHECK(!runFromCStr(runtime_, R"(
+from _json import dumps as json_dumps
+json_value = [
+  {"id": i, "name": f"item {i}", "price": i + 0.25, "tags": ["a", "b"],
+   "active": bool(i % 2), "parent": None}
+  for i in range(200)
+]
+json_length = len(json_dumps(json_value))
+)")
+             .isError(),
+        "setup failed");
+  HandleScope scope(thread_);
+  Object dumps(&scope, mainModuleAt(runtime_, "json_dumps"));
+  Object value(&scope, mainModuleAt(runtime_, "json_value"));
+  word length = SmallInt::cast(mainModuleAt(runtime_, "json_length")).value();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Interpreter::call1(thread_, dumps, value));
+  }
+  state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK_REGISTER_F(UnderJsonModuleBenchmark, Dumps);
+
+}  // namespace testing
+}  // namespace py
@@ -1,8 +1,15 @@
 // Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include <cmath>
+#include <cstring>
+
 #include "builtins.h"
 #include "dict-builtins.h"
 #include "float-builtins.h"
+#include "float-conversion.h"
+#include "formatter-utils.h"
+#include "formatter.h"
 #include "handles.h"
+#include "list-builtins.h"
 #include "objects.h"
 #include "runtime.h"
 #include "str-builtins.h"
@@ -943,4 +950,568 @@ RawObject FUNC(_json, loads)(Thread* thread, Arguments args) {
   return parse(thread, &env, data);
 }
 
+enum class DumpsArg {
+  kObj = 0,
+  kSkipkeys = 1,
+  kEnsureAscii = 2,
+  kCheckCircular = 3,
+  kAllowNan = 4,
+  kCls = 5,
+  kIndent = 6,
+  kSeparators = 7,
+  kDefault = 8,
+  kSortKeys = 9,
+  kKw = 10,
+};
+
+// Escaping a byte produces at most 6 bytes (`\u001f`). Code points outside the
+// BMP take 4 bytes and are escaped as 12 bytes with `ensure_ascii`.
+static const word kMaxEscapedLength = 6;
+static const word kEscapeChunkLength = 256;
+
+// Returns true if the word of string bytes has a byte that cannot be copied
+// into a JSON string as is: a control character, a quote or a backslash and,
+// with `ensure_ascii`, anything above `~`.
+static bool wordNeedsEscape(uword block, bool ensure_ascii) {
+  uword mask_0 = ~uword{0} / 0xFF;  // 0x010101...
+  uword mask_7 = mask_0 << 7;       // 0x808080...
+  uword quotes = block ^ (mask_0 * '"');
+  uword backslashes = block ^ (mask_0 * '\\');
+  uword special = ((block - mask_0 * ' ') & ~block) |
+                  ((quotes - mask_0) & ~quotes) |
+                  ((backslashes - mask_0) & ~backslashes);
+  if (ensure_ascii) {
+    special |= (block + mask_0 * ('\x7f' - '~')) | block;
+  }
+  return (special & mask_7) != 0;
+}
+
+static byte* writeUEscape(byte* dst, int32_t code_unit) {
+  *dst++ = '\\';
+  *dst++ = 'u';
+  uwordToHexadecimal(dst, kNumUEscapeChars, code_unit);
+  return dst + kNumUEscapeChars;
+}
+
+// Serializes objects into JSON text. Everything is written into a single
+// growing `StrArray` that is turned into a `str` at the end.
+class JSONEncoder {
+ public:
+  JSONEncoder(HandleScope* scope, Thread* thread)
+      : thread_(thread),
+        out_(scope, thread->runtime()->newStrArray()),
+        markers_(scope, thread->runtime()->newList()),
+        default_(scope, NoneType::object()),
+        indent_(scope, NoneType::object()),
+        item_separator_(scope, SmallStr::fromCStr(", ")),
+        key_separator_(scope, SmallStr::fromCStr(": ")) {}
+
+  // Appends the JSON text for `value`. Returns None or an Error.
+  RawObject encode(const Object& value);
+
+  RawObject result() { return thread_->runtime()->strFromStrArray(out_); }
+
+  bool allow_nan = true;
+  bool check_circular = true;
+  bool ensure_ascii = true;
+  bool skipkeys = false;
+  bool sort_keys = false;
+
+  void setDefault(const Object& default_func) { default_ = *default_func; }
+  void setIndent(const Str& indent) { indent_ = *indent; }
+  void setSeparators(const Str& item_separator, const Str& key_separator) {
+    item_separator_ = *item_separator;
+    key_separator_ = *key_separator;
+  }
+
+ private:
+  RawObject encodeDefault(const Object& value);
+  RawObject encodeDict(const Dict& dict);
+  RawObject encodeDictItem(const Object& key, const Object& value,
+                           bool* first);
+  RawObject encodeFloat(double value);
+  void encodeInt(const Int& value);
+  RawObject encodeSequence(const Object& sequence);
+  void encodeString(const Str& str);
+
+  RawObject enterContainer(const Object& container);
+  void leaveContainer(const Object& container);
+
+  void writeASCII(const char* text);
+  void writeByte(byte b) {
+    thread_->runtime()->strArrayAddASCII(thread_, out_, b);
+  }
+  void writeBytes(View<byte> bytes);
+  void writeNewlineIndent();
+  void writeStr(const Str& str) {
+    thread_->runtime()->strArrayAddStr(thread_, out_, str);
+  }
+
+  Thread* thread_;
+  StrArray out_;
+  // The containers that are being encoded, to detect circular references.
+  List markers_;
+  Object default_;
+  Object indent_;
+  Str item_separator_;
+  Str key_separator_;
+  word depth_ = 0;
+  word indent_level_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(JSONEncoder);
+};
+
+void JSONEncoder::writeASCII(const char* text) {
+  writeBytes(View<byte>(reinterpret_cast<const byte*>(text),
+                        static_cast<word>(std::strlen(text))));
+}
+
+void JSONEncoder::writeBytes(View<byte> bytes) {
+  word num_items = out_.numItems();
+  thread_->runtime()->strArrayEnsureCapacity(thread_, out_,
+                                             num_items + bytes.length());
+  MutableBytes::cast(out_.items()).replaceFromWithAll(num_items, bytes);
+  out_.setNumItems(num_items + bytes.length());
+}
+
+void JSONEncoder::writeNewlineIndent() {
+  if (indent_.isNoneType()) return;
+  writeByte('\n');
+  HandleScope scope(thread_);
+  Str indent(&scope, *indent_);
+  for (word i = 0; i < indent_level_; i++) {
+    writeStr(indent);
+  }
+}
+
+RawObject JSONEncoder::enterContainer(const Object& container) {
+  if (++depth_ > thread_->recursionLimit()) {
+    return thread_->raiseWithFmt(
+        LayoutId::kRecursionError,
+        "maximum recursion depth exceeded while encoding a JSON object");
+  }
+  if (!check_circular) return NoneType::object();
+  for (word i = 0, length = markers_.numItems(); i < length; i++) {
+    if (markers_.at(i) == *container) {
+      return thread_->raiseWithFmt(LayoutId::kValueError,
+                                   "Circular reference detected");
+    }
+  }
+  thread_->runtime()->listAdd(thread_, markers_, container);
+  return NoneType::object();
+}
+
+void JSONEncoder::leaveContainer(const Object& container) {
+  depth_--;
+  if (!check_circular) return;
+  word last = markers_.numItems() - 1;
+  DCHECK(markers_.at(last) == *container, "unbalanced container markers");
+  markers_.atPut(last, NoneType::object());
+  markers_.setNumItems(last);
+}
+
+void JSONEncoder::encodeString(const Str& str) {
+  Runtime* runtime = thread_->runtime();
+  word length = str.length();
+  byte small_str[SmallStr::kMaxLength];
+  if (str.isSmallStr()) {
+    str.copyTo(small_str, length);
+  }
+  writeByte('"');
+  for (word i = 0; i < length;) {
+    word chunk_end = Utils::minimum(length, i + kEscapeChunkLength);
+    word num_items = out_.numItems();
+    runtime->strArrayEnsureCapacity(
+        thread_, out_,
+        num_items + (chunk_end - i + UTF8::kMaxLength) * kMaxEscapedLength);
+    // Both buffers may move while the output grows, so the pointers are only
+    // valid for one chunk.
+    const byte* src =
+        str.isSmallStr()
+            ? small_str
+            : reinterpret_cast<const byte*>(LargeStr::cast(*str).address());
+    byte* dst_start =
+        reinterpret_cast<byte*>(MutableBytes::cast(out_.items()).address()) +
+        num_items;
+    byte* dst = dst_start;
+    while (i < chunk_end) {
+      if (i + kWordSize <= chunk_end) {
+        uword block;
+        std::memcpy(&block, src + i, kWordSize);
+        if (!wordNeedsEscape(block, ensure_ascii)) {
+          std::memcpy(dst, &block, kWordSize);
+          dst += kWordSize;
+          i += kWordSize;
+          continue;
+        }
+      }
+      byte b = src[i];
+      if (b == '"' || b == '\\') {
+        *dst++ = '\\';
+        *dst++ = b;
+        i++;
+      } else if (b < ' ') {
+        *dst++ = '\\';
+        switch (b) {
+          case '\b':
+            *dst++ = 'b';
+            break;
+          case '\f':
+            *dst++ = 'f';
+            break;
+          case '\n':
+            *dst++ = 'n';
+            break;
+          case '\r':
+            *dst++ = 'r';
+            break;
+          case '\t':
+            *dst++ = 't';
+            break;
+          default:
+            dst = writeUEscape(dst - 1, b);
+            break;
+        }
+        i++;
+      } else if (b <= '~' || !ensure_ascii) {
+        *dst++ = b;
+        i++;
+      } else {
+        word num_bytes;
+        int32_t code_point = str.codePointAt(i, &num_bytes);
+        if (code_point > kMaxUint16) {
+          code_point -= 0x10000;
+          dst = writeUEscape(dst, Unicode::kHighSurrogateStart |
+                                      ((code_point >> 10) & 0x3ff));
+          code_point = Unicode::kLowSurrogateStart | (code_point & 0x3ff);
+        }
+        dst = writeUEscape(dst, code_point);
+        i += num_bytes;
+      }
+    }
+    out_.setNumItems(num_items + (dst - dst_start));
+  }
+  writeByte('"');
+}
+
+void JSONEncoder::encodeInt(const Int& value) {
+  if (value.isLargeInt()) {
+    HandleScope scope(thread_);
+    Str text(&scope, formatIntDecimalSimple(thread_, value));
+    writeStr(text);
+    return;
+  }
+  word value_word = value.asWord();
+  uword magnitude =
+      value_word >= 0 ? value_word : -static_cast<uword>(value_word);
+  byte buffer[kUwordDigits10 + 1];
+  byte* end = buffer + sizeof(buffer);
+  byte* start = uwordToDecimal(magnitude, end);
+  if (value_word < 0) *--start = '-';
+  writeBytes(View<byte>(start, end - start));
+}
+
+RawObject JSONEncoder::encodeFloat(double value) {
+  const char* special;
+  if (std::isnan(value)) {
+    special = "NaN";
+  } else if (std::isinf(value)) {
+    special = value > 0 ? "Infinity" : "-Infinity";
+  } else {
+    unique_c_ptr<char> text(
+        doubleToString(value, 'r', 0, false, true, false, nullptr));
+    writeASCII(text.get());
+    return NoneType::object();
+  }
+  if (!allow_nan) {
+    return thread_->raiseWithFmt(
+        LayoutId::kValueError,
+        "Out of range float values are not JSON compliant");
+  }
+  writeASCII(special);
+  return NoneType::object();
+}
+
+RawObject JSONEncoder::encodeSequence(const Object& sequence) {
+  HandleScope scope(thread_);
+  Runtime* runtime = thread_->runtime();
+  // Subclasses of list and tuple are encoded from their underlying items,
+  // like CPython's C encoder does.
+  bool is_list = runtime->isInstanceOfList(*sequence);
+  Object items(&scope, NoneType::object());
+  word length;
+  if (is_list) {
+    List list(&scope, *sequence);
+    length = list.numItems();
+  } else {
+    items = tupleUnderlying(*sequence);
+    length = Tuple::cast(*items).length();
+  }
+  if (length == 0) {
+    writeASCII("[]");
+    return NoneType::object();
+  }
+  Object result(&scope, enterContainer(sequence));
+  if (result.isErrorException()) return *result;
+  writeByte('[');
+  indent_level_++;
+  writeNewlineIndent();
+  Object item(&scope, NoneType::object());
+  for (word i = 0; i < length; i++) {
+    if (i > 0) {
+      writeStr(item_separator_);
+      writeNewlineIndent();
+    }
+    if (is_list) {
+      // The list may change while `default` runs.
+      List list(&scope, *sequence);
+      if (i >= list.numItems()) break;
+      item = list.at(i);
+    } else {
+      item = Tuple::cast(*items).at(i);
+    }
+    result = encode(item);
+    if (result.isErrorException()) return *result;
+  }
+  indent_level_--;
+  writeNewlineIndent();
+  writeByte(']');
+  leaveContainer(sequence);
+  return NoneType::object();
+}
+
+RawObject JSONEncoder::encodeDictItem(const Object& key, const Object& value,
+                                      bool* first) {
+  Runtime* runtime = thread_->runtime();
+  bool is_str = runtime->isInstanceOfStr(*key);
+  if (!is_str && !key.isNoneType() && !runtime->isInstanceOfInt(*key) &&
+      !runtime->isInstanceOfFloat(*key)) {
+    if (skipkeys) return NoneType::object();
+    return thread_->raiseWithFmt(
+        LayoutId::kTypeError,
+        "keys must be str, int, float, bool or None, not %T", &key);
+  }
+  if (*first) {
+    *first = false;
+  } else {
+    writeStr(item_separator_);
+    writeNewlineIndent();
+  }
+  if (is_str) {
+    HandleScope scope(thread_);
+    Str key_str(&scope, strUnderlying(*key));
+    encodeString(key_str);
+  } else {
+    // The other keys are written like values, all of which are ASCII.
+    writeByte('"');
+    RawObject result = encode(key);
+    if (result.isErrorException()) return result;
+    writeByte('"');
+  }
+  writeStr(key_separator_);
+  return encode(value);
+}
+
+RawObject JSONEncoder::encodeDict(const Dict& dict) {
+  if (dict.numItems() == 0) {
+    writeASCII("{}");
+    return NoneType::object();
+  }
+  HandleScope scope(thread_);
+  Runtime* runtime = thread_->runtime();
+  Object result(&scope, enterContainer(dict));
+  if (result.isErrorException()) return *result;
+  writeByte('{');
+  indent_level_++;
+  writeNewlineIndent();
+  Object key(&scope, NoneType::object());
+  Object value(&scope, NoneType::object());
+  bool first = true;
+  if (dict.isDict() && !sort_keys) {
+    for (word i = 0; dictNextItem(dict, &i, &key, &value);) {
+      result = encodeDictItem(key, value, &first);
+      if (result.isErrorException()) return *result;
+    }
+  } else {
+    // Subclasses may override `items()`. The sorted order comes from sorting
+    // the `(key, value)` pairs, like `sorted(dict.items())`.
+    Object items(&scope, thread_->invokeMethod1(dict, ID(items)));
+    if (items.isErrorException()) return *items;
+    Object list_type(&scope, runtime->typeAt(LayoutId::kList));
+    items = Interpreter::call1(thread_, list_type, items);
+    if (items.isErrorException()) return *items;
+    List list(&scope, *items);
+    if (sort_keys) {
+      result = listSort(thread_, list);
+      if (result.isErrorException()) return *result;
+    }
+    Object item(&scope, NoneType::object());
+    for (word i = 0; i < list.numItems(); i++) {
+      item = list.at(i);
+      if (!runtime->isInstanceOfTuple(*item) ||
+          tupleUnderlying(*item).length() != 2) {
+        return thread_->raiseWithFmt(LayoutId::kValueError,
+                                     "items must return 2-tuples");
+      }
+      key = tupleUnderlying(*item).at(0);
+      value = tupleUnderlying(*item).at(1);
+      result = encodeDictItem(key, value, &first);
+      if (result.isErrorException()) return *result;
+    }
+  }
+  indent_level_--;
+  writeNewlineIndent();
+  writeByte('}');
+  leaveContainer(dict);
+  return NoneType::object();
+}
+
+RawObject JSONEncoder::encodeDefault(const Object& value) {
+  HandleScope scope(thread_);
+  if (default_.isNoneType()) {
+    return thread_->raiseWithFmt(LayoutId::kTypeError,
+                                 "Object of type %T is not JSON serializable",
+                                 &value);
+  }
+  Object result(&scope, enterContainer(value));
+  if (result.isErrorException()) return *result;
+  Object replacement(&scope, Interpreter::call1(thread_, default_, value));
+  if (replacement.isErrorException()) return *replacement;
+  result = encode(replacement);
+  if (result.isErrorException()) return *result;
+  leaveContainer(value);
+  return NoneType::object();
+}
+
+RawObject JSONEncoder::encode(const Object& value) {
+  HandleScope scope(thread_);
+  Runtime* runtime = thread_->runtime();
+  if (runtime->isInstanceOfStr(*value)) {
+    Str str(&scope, strUnderlying(*value));
+    encodeString(str);
+    return NoneType::object();
+  }
+  if (value.isNoneType()) {
+    writeASCII("null");
+    return NoneType::object();
+  }
+  if (value.isBool()) {
+    writeASCII(Bool::cast(*value).value() ? "true" : "false");
+    return NoneType::object();
+  }
+  // Subclasses of int and float are written by value even when they override
+  // `__repr__`, like `IntEnum`.
+  if (runtime->isInstanceOfInt(*value)) {
+    Int number(&scope, intUnderlying(*value));
+    encodeInt(number);
+    return NoneType::object();
+  }
+  if (runtime->isInstanceOfFloat(*value)) {
+    return encodeFloat(floatUnderlying(*value).value());
+  }
+  if (runtime->isInstanceOfList(*value) || runtime->isInstanceOfTuple(*value)) {
+    return encodeSequence(value);
+  }
+  if (runtime->isInstanceOfDict(*value)) {
+    Dict dict(&scope, *value);
+    return encodeDict(dict);
+  }
+  return encodeDefault(value);
+}
+
+// Calls `_json._encode_with_cls` to encode with a `JSONEncoder` object.
+static RawObject encodeWithCls(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Object function(&scope, runtime->lookupNameInModule(thread, ID(_json),
+                                                      ID(_encode_with_cls)));
+  CHECK(!function.isErrorNotFound(), "missing function in internal module");
+  thread->stackPush(*function);
+  word num_args = static_cast<word>(DumpsArg::kKw);
+  MutableTuple call_args(&scope, runtime->newMutableTuple(num_args));
+  for (word i = 0; i < num_args; i++) {
+    call_args.atPut(i, args.get(i));
+  }
+  thread->stackPush(call_args.becomeImmutable());
+  thread->stackPush(args.get(static_cast<word>(DumpsArg::kKw)));
+  return Interpreter::callEx(thread, CallFunctionExFlag::VAR_KEYWORDS);
+}
+
+static RawObject dumpsFlag(Thread* thread, Arguments args, DumpsArg arg,
+                           bool* flag_out) {
+  HandleScope scope(thread);
+  Object value(&scope, args.get(static_cast<word>(arg)));
+  if (value.isBool()) {
+    *flag_out = Bool::cast(*value).value();
+    return NoneType::object();
+  }
+  Object result(&scope, Interpreter::isTrue(thread, *value));
+  if (result.isErrorException()) return *result;
+  *flag_out = Bool::cast(*result).value();
+  return NoneType::object();
+}
+
+RawObject FUNC(_json, dumps)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Object cls(&scope, args.get(static_cast<word>(DumpsArg::kCls)));
+  Dict kw(&scope, args.get(static_cast<word>(DumpsArg::kKw)));
+  if (!cls.isNoneType() || kw.numItems() > 0) {
+    return encodeWithCls(thread, args);
+  }
+
+  JSONEncoder encoder(&scope, thread);
+  Object indent(&scope, args.get(static_cast<word>(DumpsArg::kIndent)));
+  if (indent.isSmallInt()) {
+    word width = Utils::maximum(word{0}, SmallInt::cast(*indent).value());
+    MutableBytes spaces(&scope, runtime->newMutableBytesUninitialized(width));
+    spaces.replaceFromWithByte(0, ' ', width);
+    Str indent_str(&scope, spaces.becomeStr());
+    encoder.setIndent(indent_str);
+  } else if (runtime->isInstanceOfStr(*indent)) {
+    Str indent_str(&scope, strUnderlying(*indent));
+    encoder.setIndent(indent_str);
+  } else if (!indent.isNoneType()) {
+    return encodeWithCls(thread, args);
+  }
+  Object separators(&scope,
+                    args.get(static_cast<word>(DumpsArg::kSeparators)));
+  if (separators.isTuple() && Tuple::cast(*separators).length() == 2 &&
+      runtime->isInstanceOfStr(Tuple::cast(*separators).at(0)) &&
+      runtime->isInstanceOfStr(Tuple::cast(*separators).at(1))) {
+    Str item_separator(&scope, strUnderlying(Tuple::cast(*separators).at(0)));
+    Str key_separator(&scope, strUnderlying(Tuple::cast(*separators).at(1)));
+    encoder.setSeparators(item_separator, key_separator);
+  } else if (separators.isNoneType()) {
+    if (!indent.isNoneType()) {
+      Str item_separator(&scope, SmallStr::fromCodePoint(','));
+      Str key_separator(&scope, SmallStr::fromCStr(": "));
+      encoder.setSeparators(item_separator, key_separator);
+    }
+  } else {
+    return encodeWithCls(thread, args);
+  }
+  Object default_func(&scope, args.get(static_cast<word>(DumpsArg::kDefault)));
+  encoder.setDefault(default_func);
+
+  Object result(&scope, NoneType::object());
+  result = dumpsFlag(thread, args, DumpsArg::kSkipkeys, &encoder.skipkeys);
+  if (result.isErrorException()) return *result;
+  result =
+      dumpsFlag(thread, args, DumpsArg::kEnsureAscii, &encoder.ensure_ascii);
+  if (result.isErrorException()) return *result;
+  result = dumpsFlag(thread, args, DumpsArg::kCheckCircular,
+                     &encoder.check_circular);
+  if (result.isErrorException()) return *result;
+  result = dumpsFlag(thread, args, DumpsArg::kAllowNan, &encoder.allow_nan);
+  if (result.isErrorException()) return *result;
+  result = dumpsFlag(thread, args, DumpsArg::kSortKeys, &encoder.sort_keys);
+  if (result.isErrorException()) return *result;
+
+  Object obj(&scope, args.get(static_cast<word>(DumpsArg::kObj)));
+  result = encoder.encode(obj);
+  if (result.isErrorException()) return *result;
+  return encoder.result();
+}
+
 }  // namespace py
@@ -0,0 +1,2411 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+// Regular expression engine backing the `re` module.
+//
+// This is a port of the backtracking matcher of CPython's `_sre` that works
+// on the runtime's own string and bytes data. Strings are stored as UTF-8, so
+// the matcher walks positions as byte addresses: subjects with one byte per
+// character (bytes-like objects and ASCII strings) use `ByteText`, other
+// strings decode one code point at a time with `UTF8Text`. Positions handed
+// back to Python are converted to code point indices only for the match
+// results that are actually built.
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#include "builtins.h"
+#include "bytes-builtins.h"
+#include "byteslike.h"
+#include "handles.h"
+#include "int-builtins.h"
+#include "list-builtins.h"
+#include "modules.h"
+#include "objects.h"
+#include "runtime.h"
+#include "str-builtins.h"
+#include "thread.h"
+#include "unicode.h"
+#include "utils.h"
+#include "vector.h"
+
+namespace py {
+
+using SreCode = uint32_t;
+
+static const SreCode kMaxRepeat = ~SreCode{0};
+static const SreCode kMaxGroups = kMaxRepeat / 2;
+
+// A packed pattern is a bytes object holding a header followed by the code
+// words produced by `sre_compile`.
+static const word kCodeHeaderGroups = 0;
+static const word kCodeHeaderKind = 1;
+static const word kCodeHeaderLength = 2;
+
+enum SreKind : SreCode {
+  kKindStr = 0,
+  kKindBytes = 1,
+  kKindAny = 2,
+};
+
+enum SreOp : SreCode {
+  kOpFailure = 0,
+  kOpSuccess = 1,
+  kOpAny = 2,
+  kOpAnyAll = 3,
+  kOpAssert = 4,
+  kOpAssertNot = 5,
+  kOpAt = 6,
+  kOpBranch = 7,
+  kOpCall = 8,
+  kOpCategory = 9,
+  kOpCharset = 10,
+  kOpBigCharset = 11,
+  kOpGroupref = 12,
+  kOpGrouprefExists = 13,
+  kOpIn = 14,
+  kOpInfo = 15,
+  kOpJump = 16,
+  kOpLiteral = 17,
+  kOpMark = 18,
+  kOpMaxUntil = 19,
+  kOpMinUntil = 20,
+  kOpNotLiteral = 21,
+  kOpNegate = 22,
+  kOpRange = 23,
+  kOpRepeat = 24,
+  kOpRepeatOne = 25,
+  kOpSubpattern = 26,
+  kOpMinRepeatOne = 27,
+  kOpGrouprefIgnore = 28,
+  kOpInIgnore = 29,
+  kOpLiteralIgnore = 30,
+  kOpNotLiteralIgnore = 31,
+  kOpGrouprefLocIgnore = 32,
+  kOpInLocIgnore = 33,
+  kOpLiteralLocIgnore = 34,
+  kOpNotLiteralLocIgnore = 35,
+  kOpGrouprefUniIgnore = 36,
+  kOpInUniIgnore = 37,
+  kOpLiteralUniIgnore = 38,
+  kOpNotLiteralUniIgnore = 39,
+  kOpRangeUniIgnore = 40,
+};
+
+enum SreAt : SreCode {
+  kAtBeginning = 0,
+  kAtBeginningLine = 1,
+  kAtBeginningString = 2,
+  kAtBoundary = 3,
+  kAtNonBoundary = 4,
+  kAtEnd = 5,
+  kAtEndLine = 6,
+  kAtEndString = 7,
+  kAtLocBoundary = 8,
+  kAtLocNonBoundary = 9,
+  kAtUniBoundary = 10,
+  kAtUniNonBoundary = 11,
+};
+
+enum SreCategory : SreCode {
+  kCategoryDigit = 0,
+  kCategoryNotDigit = 1,
+  kCategorySpace = 2,
+  kCategoryNotSpace = 3,
+  kCategoryWord = 4,
+  kCategoryNotWord = 5,
+  kCategoryLinebreak = 6,
+  kCategoryNotLinebreak = 7,
+  kCategoryLocWord = 8,
+  kCategoryLocNotWord = 9,
+  kCategoryUniDigit = 10,
+  kCategoryUniNotDigit = 11,
+  kCategoryUniSpace = 12,
+  kCategoryUniNotSpace = 13,
+  kCategoryUniWord = 14,
+  kCategoryUniNotWord = 15,
+  kCategoryUniLinebreak = 16,
+  kCategoryUniNotLinebreak = 17,
+};
+
+enum SreInfo : SreCode {
+  kInfoPrefix = 1,
+  kInfoLiteral = 2,
+  kInfoCharset = 4,
+};
+
+enum SreError : word {
+  kErrorIllegal = -1,
+  kErrorState = -2,
+  kErrorMemory = -9,
+  kErrorInterrupted = -10,
+};
+
+enum class SreMode {
+  kMatch = 0,
+  kFullMatch = 1,
+  kSearch = 2,
+};
+
+// Character predicates
+
+static bool isDigit(SreCode ch) { return ch < 128 && ASCII::isDigit(ch); }
+
+static bool isSpace(SreCode ch) { return ch < 128 && Byte::isSpace(ch); }
+
+static bool isLinebreak(SreCode ch) { return ch == '\n'; }
+
+static bool isWord(SreCode ch) {
+  return ch < 128 && (Byte::isAlnum(ch) || ch == '_');
+}
+
+static bool isLocWord(SreCode ch) {
+  return ch < 256 && (std::isalnum(static_cast<int>(ch)) || ch == '_');
+}
+
+static bool isUniDigit(SreCode ch) {
+  return ch <= kMaxUnicode && Unicode::isDecimal(ch);
+}
+
+static bool isUniSpace(SreCode ch) {
+  return ch <= kMaxUnicode && Unicode::isSpace(ch);
+}
+
+static bool isUniLinebreak(SreCode ch) {
+  return ch <= kMaxUnicode && Unicode::isLinebreak(ch);
+}
+
+static bool isUniWord(SreCode ch) {
+  return ch <= kMaxUnicode && (Unicode::isAlnum(ch) || ch == '_');
+}
+
+static SreCode lowerASCII(SreCode ch) {
+  return ch < 128 ? ASCII::toLower(ch) : ch;
+}
+
+static SreCode lowerLocale(SreCode ch) {
+  return ch < 256 ? std::tolower(static_cast<int>(ch)) : ch;
+}
+
+static SreCode upperLocale(SreCode ch) {
+  return ch < 256 ? std::toupper(static_cast<int>(ch)) : ch;
+}
+
+static SreCode lowerUnicode(SreCode ch) {
+  return ch <= kMaxUnicode ? Unicode::toLower(ch).code_points[0] : ch;
+}
+
+static SreCode upperUnicode(SreCode ch) {
+  return ch <= kMaxUnicode ? Unicode::toUpper(ch).code_points[0] : ch;
+}
+
+static bool inCategory(SreCode category, SreCode ch) {
+  switch (category) {
+    case kCategoryDigit:
+      return isDigit(ch);
+    case kCategoryNotDigit:
+      return !isDigit(ch);
+    case kCategorySpace:
+      return isSpace(ch);
+    case kCategoryNotSpace:
+      return !isSpace(ch);
+    case kCategoryWord:
+      return isWord(ch);
+    case kCategoryNotWord:
+      return !isWord(ch);
+    case kCategoryLinebreak:
+      return isLinebreak(ch);
+    case kCategoryNotLinebreak:
+      return !isLinebreak(ch);
+    case kCategoryLocWord:
+      return isLocWord(ch);
+    case kCategoryLocNotWord:
+      return !isLocWord(ch);
+    case kCategoryUniDigit:
+      return isUniDigit(ch);
+    case kCategoryUniNotDigit:
+      return !isUniDigit(ch);
+    case kCategoryUniSpace:
+      return isUniSpace(ch);
+    case kCategoryUniNotSpace:
+      return !isUniSpace(ch);
+    case kCategoryUniWord:
+      return isUniWord(ch);
+    case kCategoryUniNotWord:
+      return !isUniWord(ch);
+    case kCategoryUniLinebreak:
+      return isUniLinebreak(ch);
+    case kCategoryUniNotLinebreak:
+      return !isUniLinebreak(ch);
+  }
+  return false;
+}
+
+static bool charLocIgnore(SreCode pattern, SreCode ch) {
+  return ch == pattern || lowerLocale(ch) == pattern ||
+         upperLocale(ch) == pattern;
+}
+
+// Returns whether `ch` is a member of the character set starting at `set`.
+static bool inCharset(const SreCode* set, SreCode ch) {
+  bool ok = true;
+  for (;;) {
+    switch (*set++) {
+      case kOpFailure:
+        return !ok;
+      case kOpLiteral:
+        // <LITERAL> <code>
+        if (ch == set[0]) return ok;
+        set++;
+        break;
+      case kOpCategory:
+        // <CATEGORY> <code>
+        if (inCategory(set[0], ch)) return ok;
+        set++;
+        break;
+      case kOpCharset:
+        // <CHARSET> <bitmap>
+        if (ch < 256 && (set[ch / 32] & (1u << (ch & 31)))) return ok;
+        set += 256 / 32;
+        break;
+      case kOpRange:
+        // <RANGE> <lower> <upper>
+        if (set[0] <= ch && ch <= set[1]) return ok;
+        set += 2;
+        break;
+      case kOpRangeUniIgnore: {
+        // <RANGE_UNI_IGNORE> <lower> <upper>; `ch` is already lower cased.
+        if (set[0] <= ch && ch <= set[1]) return ok;
+        SreCode upper = upperUnicode(ch);
+        if (set[0] <= upper && upper <= set[1]) return ok;
+        set += 2;
+        break;
+      }
+      case kOpNegate:
+        ok = !ok;
+        break;
+      case kOpBigCharset: {
+        // <BIGCHARSET> <blockcount> <256 blockindices> <blocks>
+        word count = *set++;
+        word block = -1;
+        if (ch < 0x10000u) {
+          block = reinterpret_cast<const byte*>(set)[ch >> 8];
+        }
+        set += 256 / sizeof(SreCode);
+        if (block >= 0 &&
+            (set[(block * 256 + (ch & 255)) / 32] & (1u << (ch & 31)))) {
+          return ok;
+        }
+        set += count * (256 / 32);
+        break;
+      }
+      default:
+        // The validator rejects anything else.
+        return false;
+    }
+  }
+}
+
+static bool inCharsetLocIgnore(const SreCode* set, SreCode ch) {
+  SreCode lower = lowerLocale(ch);
+  if (inCharset(set, lower)) return true;
+  SreCode upper = upperLocale(ch);
+  return upper != lower && inCharset(set, upper);
+}
+
+// Subject text with one byte per character: bytes-like objects and ASCII
+// strings.
+struct ByteText {
+  static SreCode read(const byte* ptr) { return *ptr; }
+  static const byte* next(const byte* ptr) { return ptr + 1; }
+  static const byte* prev(const byte* ptr) { return ptr - 1; }
+
+  // Returns the position `count` characters before `ptr`, or nullptr if that
+  // is before `beginning`.
+  static const byte* back(const byte* ptr, const byte* beginning, word count) {
+    return ptr - beginning < count ? nullptr : ptr - count;
+  }
+
+  // Advances `*ptr` by up to `max_count` characters before `end`; returns the
+  // number of characters skipped.
+  static word skip(const byte** ptr, const byte* end, word max_count) {
+    word count = Utils::minimum(end - *ptr, max_count);
+    *ptr += count;
+    return count;
+  }
+
+  // Advances `*ptr` over up to `max_count` characters before `end` that
+  // satisfy `pred`; returns the number of characters skipped.
+  template <typename Pred>
+  static word skipWhile(const byte** ptr, const byte* end, word max_count,
+                        Pred pred) {
+    const byte* start = *ptr;
+    const byte* p = start;
+    if (max_count < end - p) end = p + max_count;
+    while (p < end && pred(*p)) p++;
+    *ptr = p;
+    return p - start;
+  }
+};
+
+// UTF-8 encoded text of strings with non-ASCII characters.
+struct UTF8Text {
+  static SreCode read(const byte* ptr) {
+    byte b0 = ptr[0];
+    if (b0 <= kMaxASCII) return b0;
+    if (b0 < 0xE0) return ((b0 & 0x1F) << 6) | (ptr[1] & 0x3F);
+    if (b0 < 0xF0) {
+      return ((b0 & 0x0F) << 12) | ((ptr[1] & 0x3F) << 6) | (ptr[2] & 0x3F);
+    }
+    return ((b0 & 0x07) << 18) | ((ptr[1] & 0x3F) << 12) |
+           ((ptr[2] & 0x3F) << 6) | (ptr[3] & 0x3F);
+  }
+  static const byte* next(const byte* ptr) {
+    return ptr + UTF8::numChars(*ptr);
+  }
+  static const byte* prev(const byte* ptr) {
+    do {
+      ptr--;
+    } while (UTF8::isTrailByte(*ptr));
+    return ptr;
+  }
+
+  static const byte* back(const byte* ptr, const byte* beginning, word count) {
+    for (; count > 0; count--) {
+      if (ptr <= beginning) return nullptr;
+      ptr = prev(ptr);
+    }
+    return ptr;
+  }
+
+  static word skip(const byte** ptr, const byte* end, word max_count) {
+    const byte* p = *ptr;
+    word count = 0;
+    for (; count < max_count && p < end; count++) p = next(p);
+    *ptr = p;
+    return count;
+  }
+
+  template <typename Pred>
+  static word skipWhile(const byte** ptr, const byte* end, word max_count,
+                        Pred pred) {
+    const byte* p = *ptr;
+    word count = 0;
+    for (; count < max_count && p < end && pred(read(p)); count++) {
+      p = next(p);
+    }
+    *ptr = p;
+    return count;
+  }
+};
+
+struct SreRepeat {
+  word count;
+  // Points at the arguments of the REPEAT operator.
+  const SreCode* pattern;
+  // Position of the last iteration, to stop zero-width loops.
+  const byte* last_ptr;
+  SreRepeat* prev;
+};
+
+struct SreState {
+  Thread* thread;
+  // Start of the subject data; lookbehinds may look back up to here.
+  const byte* beginning;
+  // Start of the current match attempt.
+  const byte* start;
+  // Current position; the end of the match on success.
+  const byte* ptr;
+  // End of the searched slice of the subject.
+  const byte* end;
+  const byte** mark;
+  word lastmark;
+  word lastindex;
+  bool match_all;
+  bool must_advance;
+  // Backtracking stack holding match contexts and saved marks.
+  byte* data_stack;
+  word data_stack_size;
+  word data_stack_base;
+  SreRepeat* repeat;
+  // Repeat contexts are recycled through `free_repeats` and owned by
+  // `repeats`, so nothing leaks when a match is abandoned on error.
+  SreRepeat* free_repeats;
+  Vector<SreRepeat*> repeats;
+  // The literal prefix of the pattern encoded like the subject; `nullptr` if
+  // the prefix cannot occur in the subject at all.
+  const byte* prefix;
+  word prefix_length;
+  word prefix_skip;
+};
+
+static word dataStackGrow(SreState* state, word size) {
+  word minsize = state->data_stack_base + size;
+  if (state->data_stack_size < minsize) {
+    word cursize = minsize + minsize / 4 + 1024;
+    void* stack = std::realloc(state->data_stack, cursize);
+    if (stack == nullptr) return kErrorMemory;
+    state->data_stack = static_cast<byte*>(stack);
+    state->data_stack_size = cursize;
+  }
+  return 0;
+}
+
+static SreRepeat* repeatAlloc(SreState* state) {
+  SreRepeat* repeat = state->free_repeats;
+  if (repeat != nullptr) {
+    state->free_repeats = repeat->prev;
+    return repeat;
+  }
+  repeat = new SreRepeat;
+  state->repeats.push_back(repeat);
+  return repeat;
+}
+
+static void repeatFree(SreState* state, SreRepeat* repeat) {
+  repeat->prev = state->free_repeats;
+  state->free_repeats = repeat;
+}
+
+template <typename Text, typename IsWord>
+static bool isBoundary(const SreState* state, const byte* ptr,
+                       IsWord is_word) {
+  bool that = ptr > state->beginning && is_word(Text::read(Text::prev(ptr)));
+  bool here = ptr < state->end && is_word(Text::read(ptr));
+  return here != that;
+}
+
+template <typename Text>
+static bool atPosition(const SreState* state, const byte* ptr, SreCode at) {
+  switch (at) {
+    case kAtBeginning:
+    case kAtBeginningString:
+      return ptr == state->beginning;
+    case kAtBeginningLine:
+      return ptr == state->beginning ||
+             isLinebreak(Text::read(Text::prev(ptr)));
+    case kAtEnd:
+      return (state->end - ptr == 1 && isLinebreak(*ptr)) ||
+             ptr >= state->end;
+    case kAtEndLine:
+      return ptr >= state->end || isLinebreak(Text::read(ptr));
+    case kAtEndString:
+      return ptr >= state->end;
+    case kAtBoundary:
+      return state->beginning != state->end &&
+             isBoundary<Text>(state, ptr, isWord);
+    case kAtNonBoundary:
+      return state->beginning != state->end &&
+             !isBoundary<Text>(state, ptr, isWord);
+    case kAtLocBoundary:
+      return state->beginning != state->end &&
+             isBoundary<Text>(state, ptr, isLocWord);
+    case kAtLocNonBoundary:
+      return state->beginning != state->end &&
+             !isBoundary<Text>(state, ptr, isLocWord);
+    case kAtUniBoundary:
+      return state->beginning != state->end &&
+             isBoundary<Text>(state, ptr, isUniWord);
+    case kAtUniNonBoundary:
+      return state->beginning != state->end &&
+             !isBoundary<Text>(state, ptr, isUniWord);
+  }
+  return false;
+}
+
+// Returns the position after the text of group `group` matched again at
+// `ptr` with characters compared after applying `fold`, or nullptr if it does
+// not match there.
+template <typename Text, typename Fold>
+static const byte* matchGroup(const SreState* state, const byte* ptr,
+                              word group, Fold fold) {
+  word groupref = group * 2;
+  if (groupref >= state->lastmark) return nullptr;
+  const byte* p = state->mark[groupref];
+  const byte* e = state->mark[groupref + 1];
+  if (p == nullptr || e == nullptr || e < p) return nullptr;
+  while (p < e) {
+    if (ptr >= state->end || fold(Text::read(ptr)) != fold(Text::read(p))) {
+      return nullptr;
+    }
+    p = Text::next(p);
+    ptr = Text::next(ptr);
+  }
+  return ptr;
+}
+
+static bool isGroupSet(const SreState* state, word group) {
+  word groupref = group * 2;
+  if (groupref >= state->lastmark) return false;
+  const byte* p = state->mark[groupref];
+  const byte* e = state->mark[groupref + 1];
+  return p != nullptr && e != nullptr && e >= p;
+}
+
+template <typename Text>
+static word sreMatch(SreState* state, const SreCode* pattern, bool toplevel);
+
+// Returns how many times the single character pattern `pattern` matches from
+// `state->ptr`, up to `maxcount`, and leaves `state->ptr` after the last one.
+template <typename Text>
+static word sreCount(SreState* state, const SreCode* pattern,
+                     SreCode maxcount) {
+  const byte* ptr = state->ptr;
+  const byte* end = state->end;
+  word max_count = maxcount == kMaxRepeat ? kMaxWord : maxcount;
+  SreCode chr = pattern[1];
+  word count;
+  switch (pattern[0]) {
+    case kOpIn:
+      count = Text::skipWhile(&ptr, end, max_count, [pattern](SreCode ch) {
+        return inCharset(pattern + 2, ch);
+      });
+      break;
+    case kOpAny:
+      count = Text::skipWhile(&ptr, end, max_count,
+                              [](SreCode ch) { return !isLinebreak(ch); });
+      break;
+    case kOpAnyAll:
+      count = Text::skip(&ptr, end, max_count);
+      break;
+    case kOpLiteral:
+      count = Text::skipWhile(&ptr, end, max_count,
+                              [chr](SreCode ch) { return ch == chr; });
+      break;
+    case kOpLiteralIgnore:
+      count = Text::skipWhile(&ptr, end, max_count, [chr](SreCode ch) {
+        return lowerASCII(ch) == chr;
+      });
+      break;
+    case kOpLiteralUniIgnore:
+      count = Text::skipWhile(&ptr, end, max_count, [chr](SreCode ch) {
+        return lowerUnicode(ch) == chr;
+      });
+      break;
+    case kOpLiteralLocIgnore:
+      count = Text::skipWhile(&ptr, end, max_count, [chr](SreCode ch) {
+        return charLocIgnore(chr, ch);
+      });
+      break;
+    case kOpNotLiteral:
+      count = Text::skipWhile(&ptr, end, max_count,
+                              [chr](SreCode ch) { return ch != chr; });
+      break;
+    case kOpNotLiteralIgnore:
+      count = Text::skipWhile(&ptr, end, max_count, [chr](SreCode ch) {
+        return lowerASCII(ch) != chr;
+      });
+      break;
+    case kOpNotLiteralUniIgnore:
+      count = Text::skipWhile(&ptr, end, max_count, [chr](SreCode ch) {
+        return lowerUnicode(ch) != chr;
+      });
+      break;
+    case kOpNotLiteralLocIgnore:
+      count = Text::skipWhile(&ptr, end, max_count, [chr](SreCode ch) {
+        return !charLocIgnore(chr, ch);
+      });
+      break;
+    default: {
+      // Repeated single character pattern; each successful match moves
+      // `state->ptr` forward by one character.
+      count = 0;
+      ptr = state->ptr;
+      while (count < max_count && state->ptr < end) {
+        word result = sreMatch<Text>(state, pattern, false);
+        if (result < 0) return result;
+        if (result == 0) break;
+        ptr = state->ptr;
+        count++;
+      }
+      break;
+    }
+  }
+  state->ptr = ptr;
+  return count;
+}
+
+// The matcher runs on an explicit stack of contexts kept in
+// `state->data_stack` instead of recursing; see CPython's `_sre.c` for the
+// rationale of the LASTMARK and MARK bookkeeping.
+#define LASTMARK_SAVE()                                                        \
+  do {                                                                         \
+    ctx->lastmark = state->lastmark;                                           \
+    ctx->lastindex = state->lastindex;                                         \
+  } while (0)
+#define LASTMARK_RESTORE()                                                     \
+  do {                                                                         \
+    state->lastmark = ctx->lastmark;                                           \
+    state->lastindex = ctx->lastindex;                                         \
+  } while (0)
+
+#define RETURN_ERROR(i)                                                        \
+  do {                                                                         \
+    return i;                                                                  \
+  } while (0)
+#define RETURN_FAILURE                                                         \
+  do {                                                                         \
+    ret = 0;                                                                   \
+    goto exit;                                                                 \
+  } while (0)
+#define RETURN_SUCCESS                                                         \
+  do {                                                                         \
+    ret = 1;                                                                   \
+    goto exit;                                                                 \
+  } while (0)
+#define RETURN_ON_ERROR(i)                                                     \
+  do {                                                                         \
+    if (i < 0) RETURN_ERROR(i);                                                \
+  } while (0)
+#define RETURN_ON_SUCCESS(i)                                                   \
+  do {                                                                         \
+    RETURN_ON_ERROR(i);                                                        \
+    if (i > 0) RETURN_SUCCESS;                                                 \
+  } while (0)
+#define RETURN_ON_FAILURE(i)                                                   \
+  do {                                                                         \
+    RETURN_ON_ERROR(i);                                                        \
+    if (i == 0) RETURN_FAILURE;                                                \
+  } while (0)
+
+#define DATA_LOOKUP_AT(type, ptr, pos)                                         \
+  do {                                                                         \
+    ptr = reinterpret_cast<type*>(state->data_stack + (pos));                  \
+  } while (0)
+#define DATA_ALLOC(type, ptr)                                                  \
+  do {                                                                         \
+    alloc_pos = state->data_stack_base;                                        \
+    if (static_cast<word>(sizeof(type)) >                                      \
+        state->data_stack_size - alloc_pos) {                                  \
+      word j = dataStackGrow(state, sizeof(type));                             \
+      if (j < 0) return j;                                                     \
+      if (ctx_pos != -1) DATA_LOOKUP_AT(SreContext, ctx, ctx_pos);             \
+    }                                                                          \
+    ptr = reinterpret_cast<type*>(state->data_stack + alloc_pos);              \
+    state->data_stack_base += sizeof(type);                                    \
+  } while (0)
+#define DATA_STACK_PUSH(data, size)                                            \
+  do {                                                                         \
+    if ((size) > state->data_stack_size - state->data_stack_base) {            \
+      word j = dataStackGrow(state, size);                                     \
+      if (j < 0) return j;                                                     \
+      if (ctx_pos != -1) DATA_LOOKUP_AT(SreContext, ctx, ctx_pos);             \
+    }                                                                          \
+    std::memcpy(state->data_stack + state->data_stack_base, data, size);       \
+    state->data_stack_base += size;                                            \
+  } while (0)
+#define DATA_STACK_POP(data, size, discard)                                    \
+  do {                                                                         \
+    std::memcpy(data, state->data_stack + state->data_stack_base - (size),     \
+                size);                                                         \
+    if (discard) state->data_stack_base -= size;                               \
+  } while (0)
+#define DATA_STACK_POP_DISCARD(size)                                           \
+  do {                                                                         \
+    state->data_stack_base -= size;                                            \
+  } while (0)
+
+#define DATA_PUSH(x)                                                           \
+  DATA_STACK_PUSH((x), static_cast<word>(sizeof(*(x))))
+#define DATA_POP(x) DATA_STACK_POP((x), static_cast<word>(sizeof(*(x))), true)
+#define DATA_POP_DISCARD(x)                                                    \
+  DATA_STACK_POP_DISCARD(static_cast<word>(sizeof(*(x))))
+
+#define MARK_PUSH(lastmark)                                                    \
+  do {                                                                         \
+    if (lastmark > 0) {                                                        \
+      i = lastmark; /* ctx->lastmark may change if reallocated */              \
+      DATA_STACK_PUSH(state->mark,                                             \
+                      (i + 1) * static_cast<word>(sizeof(*state->mark)));      \
+    }                                                                          \
+  } while (0)
+#define MARK_POP(lastmark)                                                     \
+  do {                                                                         \
+    if (lastmark > 0) {                                                        \
+      DATA_STACK_POP(state->mark,                                              \
+                     (lastmark + 1) * static_cast<word>(sizeof(*state->mark)), \
+                     true);                                                    \
+    }                                                                          \
+  } while (0)
+#define MARK_POP_KEEP(lastmark)                                                \
+  do {                                                                         \
+    if (lastmark > 0) {                                                        \
+      DATA_STACK_POP(state->mark,                                              \
+                     (lastmark + 1) * static_cast<word>(sizeof(*state->mark)), \
+                     false);                                                   \
+    }                                                                          \
+  } while (0)
+#define MARK_POP_DISCARD(lastmark)                                             \
+  do {                                                                         \
+    if (lastmark > 0) {                                                        \
+      DATA_STACK_POP_DISCARD(                                                  \
+          (lastmark + 1) * static_cast<word>(sizeof(*state->mark)));           \
+    }                                                                          \
+  } while (0)
+
+#define DO_JUMPX(jumpvalue, jumplabel, nextpattern, toplevel_)                 \
+  DATA_ALLOC(SreContext, nextctx);                                             \
+  nextctx->last_ctx_pos = ctx_pos;                                             \
+  nextctx->jump = jumpvalue;                                                   \
+  nextctx->pattern = nextpattern;                                              \
+  nextctx->toplevel = toplevel_;                                               \
+  ctx_pos = alloc_pos;                                                         \
+  ctx = nextctx;                                                               \
+  goto entrance;                                                               \
+  jumplabel:                                                                   \
+  do {                                                                         \
+  } while (0)
+
+#define DO_JUMP(jumpvalue, jumplabel, nextpattern)                             \
+  DO_JUMPX(jumpvalue, jumplabel, nextpattern, ctx->toplevel)
+
+#define DO_JUMP0(jumpvalue, jumplabel, nextpattern)                            \
+  DO_JUMPX(jumpvalue, jumplabel, nextpattern, false)
+
+enum SreJump : word {
+  kJumpNone,
+  kJumpMaxUntil1,
+  kJumpMaxUntil2,
+  kJumpMaxUntil3,
+  kJumpMinUntil1,
+  kJumpMinUntil2,
+  kJumpMinUntil3,
+  kJumpRepeat,
+  kJumpRepeatOne1,
+  kJumpRepeatOne2,
+  kJumpMinRepeatOne,
+  kJumpBranch,
+  kJumpAssert,
+  kJumpAssertNot,
+};
+
+struct SreContext {
+  word last_ctx_pos;
+  word jump;
+  const byte* ptr;
+  const SreCode* pattern;
+  word count;
+  word lastmark;
+  word lastindex;
+  union {
+    SreCode chr;
+    SreRepeat* rep;
+  } u;
+  bool toplevel;
+};
+
+// Returns whether the subject matches `pattern` at `state->ptr`: 1 if it
+// does, 0 if it does not and a negative `SreError` on errors.
+template <typename Text>
+static word sreMatch(SreState* state, const SreCode* pattern, bool toplevel) {
+  const byte* end = state->end;
+  const byte* back_ptr;
+  word alloc_pos, ctx_pos = -1;
+  word i, ret = 0;
+  word jump;
+  uword sigcount = 0;
+  SreContext* ctx;
+  SreContext* nextctx;
+
+  DATA_ALLOC(SreContext, ctx);
+  ctx->last_ctx_pos = -1;
+  ctx->jump = kJumpNone;
+  ctx->pattern = pattern;
+  ctx->toplevel = toplevel;
+  ctx_pos = alloc_pos;
+
+entrance:
+  ctx->ptr = state->ptr;
+  if (ctx->pattern[0] == kOpInfo) {
+    // Optimization info block: <INFO> <1=skip> <2=flags> <3=min> ...
+    // Every character takes at least one byte, so too few bytes left means
+    // too few characters left.
+    if (ctx->pattern[3] && end - ctx->ptr < ctx->pattern[3]) {
+      RETURN_FAILURE;
+    }
+    ctx->pattern += ctx->pattern[1] + 1;
+  }
+
+  for (;;) {
+    if ((++sigcount & 0xfff) == 0 &&
+        state->thread->isInterrupted(Thread::kSignal)) {
+      RETURN_ERROR(kErrorInterrupted);
+    }
+
+    switch (*ctx->pattern++) {
+      case kOpMark:
+        // <MARK> <gid>
+        i = ctx->pattern[0];
+        if (i & 1) state->lastindex = i / 2 + 1;
+        if (i > state->lastmark) {
+          // Marks skipped over by a jump in lastmark have not been seen.
+          word j = state->lastmark + 1;
+          while (j < i) state->mark[j++] = nullptr;
+          state->lastmark = i;
+        }
+        state->mark[i] = ctx->ptr;
+        ctx->pattern++;
+        break;
+
+      case kOpLiteral:
+        // <LITERAL> <code>
+        if (ctx->ptr >= end || Text::read(ctx->ptr) != ctx->pattern[0]) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern++;
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpNotLiteral:
+        // <NOT_LITERAL> <code>
+        if (ctx->ptr >= end || Text::read(ctx->ptr) == ctx->pattern[0]) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern++;
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpSuccess:
+        if (ctx->toplevel &&
+            ((state->match_all && ctx->ptr != state->end) ||
+             (state->must_advance && ctx->ptr == state->start))) {
+          RETURN_FAILURE;
+        }
+        state->ptr = ctx->ptr;
+        RETURN_SUCCESS;
+
+      case kOpAt:
+        // <AT> <code>
+        if (!atPosition<Text>(state, ctx->ptr, ctx->pattern[0])) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern++;
+        break;
+
+      case kOpCategory:
+        // <CATEGORY> <code>
+        if (ctx->ptr >= end ||
+            !inCategory(ctx->pattern[0], Text::read(ctx->ptr))) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern++;
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpAny:
+        if (ctx->ptr >= end || isLinebreak(Text::read(ctx->ptr))) {
+          RETURN_FAILURE;
+        }
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpAnyAll:
+        if (ctx->ptr >= end) RETURN_FAILURE;
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpIn:
+        // <IN> <skip> <set>
+        if (ctx->ptr >= end ||
+            !inCharset(ctx->pattern + 1, Text::read(ctx->ptr))) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern += ctx->pattern[0];
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpLiteralIgnore:
+        if (ctx->ptr >= end ||
+            lowerASCII(Text::read(ctx->ptr)) != ctx->pattern[0]) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern++;
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpLiteralUniIgnore:
+        if (ctx->ptr >= end ||
+            lowerUnicode(Text::read(ctx->ptr)) != ctx->pattern[0]) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern++;
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpLiteralLocIgnore:
+        if (ctx->ptr >= end ||
+            !charLocIgnore(ctx->pattern[0], Text::read(ctx->ptr))) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern++;
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpNotLiteralIgnore:
+        if (ctx->ptr >= end ||
+            lowerASCII(Text::read(ctx->ptr)) == ctx->pattern[0]) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern++;
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpNotLiteralUniIgnore:
+        if (ctx->ptr >= end ||
+            lowerUnicode(Text::read(ctx->ptr)) == ctx->pattern[0]) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern++;
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpNotLiteralLocIgnore:
+        if (ctx->ptr >= end ||
+            charLocIgnore(ctx->pattern[0], Text::read(ctx->ptr))) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern++;
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpInIgnore:
+        if (ctx->ptr >= end ||
+            !inCharset(ctx->pattern + 1, lowerASCII(Text::read(ctx->ptr)))) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern += ctx->pattern[0];
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpInUniIgnore:
+        if (ctx->ptr >= end ||
+            !inCharset(ctx->pattern + 1,
+                       lowerUnicode(Text::read(ctx->ptr)))) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern += ctx->pattern[0];
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpInLocIgnore:
+        if (ctx->ptr >= end ||
+            !inCharsetLocIgnore(ctx->pattern + 1, Text::read(ctx->ptr))) {
+          RETURN_FAILURE;
+        }
+        ctx->pattern += ctx->pattern[0];
+        ctx->ptr = Text::next(ctx->ptr);
+        break;
+
+      case kOpJump:
+      case kOpInfo:
+        // <JUMP> <offset>
+        ctx->pattern += ctx->pattern[0];
+        break;
+
+      case kOpBranch:
+        // <BRANCH> <0=skip> code <JUMP> ... <NULL>
+        LASTMARK_SAVE();
+        ctx->u.rep = state->repeat;
+        if (ctx->u.rep) MARK_PUSH(ctx->lastmark);
+        for (; ctx->pattern[0]; ctx->pattern += ctx->pattern[0]) {
+          if (ctx->pattern[1] == kOpLiteral &&
+              (ctx->ptr >= end || Text::read(ctx->ptr) != ctx->pattern[2])) {
+            continue;
+          }
+          if (ctx->pattern[1] == kOpIn &&
+              (ctx->ptr >= end ||
+               !inCharset(ctx->pattern + 3, Text::read(ctx->ptr)))) {
+            continue;
+          }
+          state->ptr = ctx->ptr;
+          DO_JUMP(kJumpBranch, jump_branch, ctx->pattern + 1);
+          if (ret) {
+            if (ctx->u.rep) MARK_POP_DISCARD(ctx->lastmark);
+            RETURN_ON_ERROR(ret);
+            RETURN_SUCCESS;
+          }
+          if (ctx->u.rep) MARK_POP_KEEP(ctx->lastmark);
+          LASTMARK_RESTORE();
+        }
+        if (ctx->u.rep) MARK_POP_DISCARD(ctx->lastmark);
+        RETURN_FAILURE;
+
+      case kOpRepeatOne:
+        // Maximizing repeat of an item exactly one character wide:
+        // <REPEAT_ONE> <skip> <1=min> <2=max> item <SUCCESS> tail
+        if (static_cast<word>(ctx->pattern[1]) > end - ctx->ptr) {
+          RETURN_FAILURE;
+        }
+        state->ptr = ctx->ptr;
+        ret = sreCount<Text>(state, ctx->pattern + 3, ctx->pattern[2]);
+        RETURN_ON_ERROR(ret);
+        DATA_LOOKUP_AT(SreContext, ctx, ctx_pos);
+        ctx->count = ret;
+        ctx->ptr = state->ptr;
+        if (ctx->count < static_cast<word>(ctx->pattern[1])) RETURN_FAILURE;
+
+        if (ctx->pattern[ctx->pattern[0]] == kOpSuccess &&
+            ctx->ptr == state->end &&
+            !(ctx->toplevel && state->must_advance &&
+              ctx->ptr == state->start)) {
+          // The tail is empty; we are done.
+          state->ptr = ctx->ptr;
+          RETURN_SUCCESS;
+        }
+
+        LASTMARK_SAVE();
+        if (ctx->pattern[ctx->pattern[0]] == kOpLiteral) {
+          // The tail starts with a literal; skip positions where the rest of
+          // the pattern cannot match.
+          ctx->u.chr = ctx->pattern[ctx->pattern[0] + 1];
+          for (;;) {
+            while (ctx->count >= static_cast<word>(ctx->pattern[1]) &&
+                   (ctx->ptr >= end || Text::read(ctx->ptr) != ctx->u.chr)) {
+              if (--ctx->count < static_cast<word>(ctx->pattern[1])) break;
+              ctx->ptr = Text::prev(ctx->ptr);
+            }
+            if (ctx->count < static_cast<word>(ctx->pattern[1])) break;
+            state->ptr = ctx->ptr;
+            DO_JUMP(kJumpRepeatOne1, jump_repeat_one_1,
+                    ctx->pattern + ctx->pattern[0]);
+            if (ret) {
+              RETURN_ON_ERROR(ret);
+              RETURN_SUCCESS;
+            }
+            LASTMARK_RESTORE();
+            if (--ctx->count < static_cast<word>(ctx->pattern[1])) break;
+            ctx->ptr = Text::prev(ctx->ptr);
+          }
+        } else {
+          while (ctx->count >= static_cast<word>(ctx->pattern[1])) {
+            state->ptr = ctx->ptr;
+            DO_JUMP(kJumpRepeatOne2, jump_repeat_one_2,
+                    ctx->pattern + ctx->pattern[0]);
+            if (ret) {
+              RETURN_ON_ERROR(ret);
+              RETURN_SUCCESS;
+            }
+            if (--ctx->count < static_cast<word>(ctx->pattern[1])) break;
+            ctx->ptr = Text::prev(ctx->ptr);
+            LASTMARK_RESTORE();
+          }
+        }
+        RETURN_FAILURE;
+
+      case kOpMinRepeatOne:
+        // Minimizing repeat of an item exactly one character wide:
+        // <MIN_REPEAT_ONE> <skip> <1=min> <2=max> item <SUCCESS> tail
+        if (static_cast<word>(ctx->pattern[1]) > end - ctx->ptr) {
+          RETURN_FAILURE;
+        }
+        state->ptr = ctx->ptr;
+        if (ctx->pattern[1] == 0) {
+          ctx->count = 0;
+        } else {
+          ret = sreCount<Text>(state, ctx->pattern + 3, ctx->pattern[1]);
+          RETURN_ON_ERROR(ret);
+          DATA_LOOKUP_AT(SreContext, ctx, ctx_pos);
+          if (ret < static_cast<word>(ctx->pattern[1])) RETURN_FAILURE;
+          ctx->count = ret;
+          ctx->ptr = state->ptr;
+        }
+
+        if (ctx->pattern[ctx->pattern[0]] == kOpSuccess &&
+            !(ctx->toplevel &&
+              ((state->match_all && ctx->ptr != state->end) ||
+               (state->must_advance && ctx->ptr == state->start)))) {
+          // The tail is empty; we are done.
+          state->ptr = ctx->ptr;
+          RETURN_SUCCESS;
+        }
+
+        LASTMARK_SAVE();
+        while (ctx->pattern[2] == kMaxRepeat ||
+               ctx->count <= static_cast<word>(ctx->pattern[2])) {
+          state->ptr = ctx->ptr;
+          DO_JUMP(kJumpMinRepeatOne, jump_min_repeat_one,
+                  ctx->pattern + ctx->pattern[0]);
+          if (ret) {
+            RETURN_ON_ERROR(ret);
+            RETURN_SUCCESS;
+          }
+          state->ptr = ctx->ptr;
+          ret = sreCount<Text>(state, ctx->pattern + 3, 1);
+          RETURN_ON_ERROR(ret);
+          DATA_LOOKUP_AT(SreContext, ctx, ctx_pos);
+          if (ret == 0) break;
+          DCHECK(ret == 1, "expected a single character");
+          ctx->ptr = state->ptr;
+          ctx->count++;
+          LASTMARK_RESTORE();
+        }
+        RETURN_FAILURE;
+
+      case kOpRepeat:
+        // Installs a repeat context; the UNTIL operators do the work.
+        // <REPEAT> <skip> <1=min> <2=max> item <UNTIL> tail
+        ctx->u.rep = repeatAlloc(state);
+        ctx->u.rep->count = -1;
+        ctx->u.rep->pattern = ctx->pattern;
+        ctx->u.rep->prev = state->repeat;
+        ctx->u.rep->last_ptr = nullptr;
+        state->repeat = ctx->u.rep;
+
+        state->ptr = ctx->ptr;
+        DO_JUMP(kJumpRepeat, jump_repeat, ctx->pattern + ctx->pattern[0]);
+        state->repeat = ctx->u.rep->prev;
+        repeatFree(state, ctx->u.rep);
+        if (ret) {
+          RETURN_ON_ERROR(ret);
+          RETURN_SUCCESS;
+        }
+        RETURN_FAILURE;
+
+      case kOpMaxUntil:
+        // Maximizing repeat:
+        // <REPEAT> <skip> <1=min> <2=max> item <MAX_UNTIL> tail
+        ctx->u.rep = state->repeat;
+        if (!ctx->u.rep) RETURN_ERROR(kErrorState);
+        state->ptr = ctx->ptr;
+        ctx->count = ctx->u.rep->count + 1;
+
+        if (ctx->count < static_cast<word>(ctx->u.rep->pattern[1])) {
+          // Not enough matches yet.
+          ctx->u.rep->count = ctx->count;
+          DO_JUMP(kJumpMaxUntil1, jump_max_until_1, ctx->u.rep->pattern + 3);
+          if (ret) {
+            RETURN_ON_ERROR(ret);
+            RETURN_SUCCESS;
+          }
+          ctx->u.rep->count = ctx->count - 1;
+          state->ptr = ctx->ptr;
+          RETURN_FAILURE;
+        }
+
+        if ((ctx->count < static_cast<word>(ctx->u.rep->pattern[2]) ||
+             ctx->u.rep->pattern[2] == kMaxRepeat) &&
+            state->ptr != ctx->u.rep->last_ptr) {
+          // There may be enough matches, but try to match another item.
+          ctx->u.rep->count = ctx->count;
+          LASTMARK_SAVE();
+          MARK_PUSH(ctx->lastmark);
+          // Zero-width match protection.
+          DATA_PUSH(&ctx->u.rep->last_ptr);
+          ctx->u.rep->last_ptr = state->ptr;
+          DO_JUMP(kJumpMaxUntil2, jump_max_until_2, ctx->u.rep->pattern + 3);
+          DATA_POP(&ctx->u.rep->last_ptr);
+          if (ret) {
+            MARK_POP_DISCARD(ctx->lastmark);
+            RETURN_ON_ERROR(ret);
+            RETURN_SUCCESS;
+          }
+          MARK_POP(ctx->lastmark);
+          LASTMARK_RESTORE();
+          ctx->u.rep->count = ctx->count - 1;
+          state->ptr = ctx->ptr;
+        }
+
+        // Cannot match more repeated items here; make sure the tail matches.
+        state->repeat = ctx->u.rep->prev;
+        DO_JUMP(kJumpMaxUntil3, jump_max_until_3, ctx->pattern);
+        RETURN_ON_SUCCESS(ret);
+        state->repeat = ctx->u.rep;
+        state->ptr = ctx->ptr;
+        RETURN_FAILURE;
+
+      case kOpMinUntil:
+        // Minimizing repeat:
+        // <REPEAT> <skip> <1=min> <2=max> item <MIN_UNTIL> tail
+        ctx->u.rep = state->repeat;
+        if (!ctx->u.rep) RETURN_ERROR(kErrorState);
+        state->ptr = ctx->ptr;
+        ctx->count = ctx->u.rep->count + 1;
+
+        if (ctx->count < static_cast<word>(ctx->u.rep->pattern[1])) {
+          // Not enough matches yet.
+          ctx->u.rep->count = ctx->count;
+          DO_JUMP(kJumpMinUntil1, jump_min_until_1, ctx->u.rep->pattern + 3);
+          if (ret) {
+            RETURN_ON_ERROR(ret);
+            RETURN_SUCCESS;
+          }
+          ctx->u.rep->count = ctx->count - 1;
+          state->ptr = ctx->ptr;
+          RETURN_FAILURE;
+        }
+
+        LASTMARK_SAVE();
+        // See if the tail matches.
+        state->repeat = ctx->u.rep->prev;
+        DO_JUMP(kJumpMinUntil2, jump_min_until_2, ctx->pattern);
+        if (ret) {
+          RETURN_ON_ERROR(ret);
+          RETURN_SUCCESS;
+        }
+        state->repeat = ctx->u.rep;
+        state->ptr = ctx->ptr;
+        LASTMARK_RESTORE();
+
+        if ((ctx->count >= static_cast<word>(ctx->u.rep->pattern[2]) &&
+             ctx->u.rep->pattern[2] != kMaxRepeat) ||
+            state->ptr == ctx->u.rep->last_ptr) {
+          RETURN_FAILURE;
+        }
+
+        ctx->u.rep->count = ctx->count;
+        // Zero-width match protection.
+        DATA_PUSH(&ctx->u.rep->last_ptr);
+        ctx->u.rep->last_ptr = state->ptr;
+        DO_JUMP(kJumpMinUntil3, jump_min_until_3, ctx->u.rep->pattern + 3);
+        DATA_POP(&ctx->u.rep->last_ptr);
+        if (ret) {
+          RETURN_ON_ERROR(ret);
+          RETURN_SUCCESS;
+        }
+        ctx->u.rep->count = ctx->count - 1;
+        state->ptr = ctx->ptr;
+        RETURN_FAILURE;
+
+      case kOpGroupref:
+        // <GROUPREF> <group>
+        ctx->ptr = matchGroup<Text>(state, ctx->ptr, ctx->pattern[0],
+                                    [](SreCode ch) { return ch; });
+        if (ctx->ptr == nullptr) RETURN_FAILURE;
+        ctx->pattern++;
+        break;
+
+      case kOpGrouprefIgnore:
+        ctx->ptr =
+            matchGroup<Text>(state, ctx->ptr, ctx->pattern[0], lowerASCII);
+        if (ctx->ptr == nullptr) RETURN_FAILURE;
+        ctx->pattern++;
+        break;
+
+      case kOpGrouprefUniIgnore:
+        ctx->ptr =
+            matchGroup<Text>(state, ctx->ptr, ctx->pattern[0], lowerUnicode);
+        if (ctx->ptr == nullptr) RETURN_FAILURE;
+        ctx->pattern++;
+        break;
+
+      case kOpGrouprefLocIgnore:
+        ctx->ptr =
+            matchGroup<Text>(state, ctx->ptr, ctx->pattern[0], lowerLocale);
+        if (ctx->ptr == nullptr) RETURN_FAILURE;
+        ctx->pattern++;
+        break;
+
+      case kOpGrouprefExists:
+        // <GROUPREF_EXISTS> <group> <skip> codeyes <JUMP> codeno ...
+        if (isGroupSet(state, ctx->pattern[0])) {
+          ctx->pattern += 2;
+        } else {
+          ctx->pattern += ctx->pattern[1];
+        }
+        break;
+
+      case kOpAssert:
+        // <ASSERT> <skip> <back> <pattern>
+        back_ptr = Text::back(ctx->ptr, state->beginning, ctx->pattern[1]);
+        if (back_ptr == nullptr) RETURN_FAILURE;
+        state->ptr = back_ptr;
+        DO_JUMP0(kJumpAssert, jump_assert, ctx->pattern + 2);
+        RETURN_ON_FAILURE(ret);
+        ctx->pattern += ctx->pattern[0];
+        break;
+
+      case kOpAssertNot:
+        // <ASSERT_NOT> <skip> <back> <pattern>
+        back_ptr = Text::back(ctx->ptr, state->beginning, ctx->pattern[1]);
+        if (back_ptr != nullptr) {
+          state->ptr = back_ptr;
+          DO_JUMP0(kJumpAssertNot, jump_assert_not, ctx->pattern + 2);
+          if (ret) {
+            RETURN_ON_ERROR(ret);
+            RETURN_FAILURE;
+          }
+        }
+        ctx->pattern += ctx->pattern[0];
+        break;
+
+      case kOpFailure:
+        RETURN_FAILURE;
+
+      default:
+        RETURN_ERROR(kErrorIllegal);
+    }
+  }
+
+exit:
+  ctx_pos = ctx->last_ctx_pos;
+  jump = ctx->jump;
+  DATA_POP_DISCARD(ctx);
+  if (ctx_pos == -1) return ret;
+  DATA_LOOKUP_AT(SreContext, ctx, ctx_pos);
+
+  switch (jump) {
+    case kJumpMaxUntil2:
+      goto jump_max_until_2;
+    case kJumpMaxUntil3:
+      goto jump_max_until_3;
+    case kJumpMinUntil2:
+      goto jump_min_until_2;
+    case kJumpMinUntil3:
+      goto jump_min_until_3;
+    case kJumpBranch:
+      goto jump_branch;
+    case kJumpMaxUntil1:
+      goto jump_max_until_1;
+    case kJumpMinUntil1:
+      goto jump_min_until_1;
+    case kJumpRepeat:
+      goto jump_repeat;
+    case kJumpRepeatOne1:
+      goto jump_repeat_one_1;
+    case kJumpRepeatOne2:
+      goto jump_repeat_one_2;
+    case kJumpMinRepeatOne:
+      goto jump_min_repeat_one;
+    case kJumpAssert:
+      goto jump_assert;
+    case kJumpAssertNot:
+      goto jump_assert_not;
+  }
+  return ret;
+}
+
+#undef LASTMARK_SAVE
+#undef LASTMARK_RESTORE
+#undef RETURN_ERROR
+#undef RETURN_FAILURE
+#undef RETURN_SUCCESS
+#undef RETURN_ON_ERROR
+#undef RETURN_ON_SUCCESS
+#undef RETURN_ON_FAILURE
+#undef DATA_LOOKUP_AT
+#undef DATA_ALLOC
+#undef DATA_STACK_PUSH
+#undef DATA_STACK_POP
+#undef DATA_STACK_POP_DISCARD
+#undef DATA_PUSH
+#undef DATA_POP
+#undef DATA_POP_DISCARD
+#undef MARK_PUSH
+#undef MARK_POP
+#undef MARK_POP_KEEP
+#undef MARK_POP_DISCARD
+#undef DO_JUMPX
+#undef DO_JUMP
+#undef DO_JUMP0
+
+static void resetCaptureGroups(SreState* state) {
+  state->lastmark = -1;
+  state->lastindex = -1;
+}
+
+// Searches for the first match of `pattern` from `state->start`; returns 1 if
+// there is one, 0 if not and a negative `SreError` on errors.
+template <typename Text>
+static word sreSearch(SreState* state, const SreCode* pattern) {
+  const byte* ptr = state->start;
+  const byte* end = state->end;
+  const SreCode* charset = nullptr;
+  SreCode flags = 0;
+  word prefix_skip = 0;
+  word status = 0;
+
+  if (ptr > end) return 0;
+
+  if (pattern[0] == kOpInfo) {
+    // <INFO> <1=skip> <2=flags> <3=min> <4=max> <5=prefix info>
+    flags = pattern[2];
+    if (pattern[3] && end - ptr < static_cast<word>(pattern[3])) return 0;
+    if (pattern[3] > 1) {
+      // A match needs at least `min` characters and each character takes at
+      // least one byte. Leave one character so literal search still works.
+      end -= pattern[3] - 1;
+      if (end <= ptr) end = ptr;
+    }
+    if (flags & kInfoPrefix) {
+      // <length> <skip> <prefix data> <overlap data>
+      prefix_skip = pattern[6];
+    } else if (flags & kInfoCharset) {
+      charset = pattern + 5;
+    }
+    pattern += 1 + pattern[1];
+  }
+
+  if (flags & kInfoPrefix) {
+    // The pattern starts with a known literal prefix, which was encoded like
+    // the subject when the state was set up. Find candidates for its first
+    // byte with memchr, then compare the rest.
+    const byte* prefix = state->prefix;
+    if (prefix == nullptr) return 0;
+    word prefix_length = state->prefix_length;
+    end = state->end;
+    state->must_advance = false;
+    while (end - ptr >= prefix_length) {
+      ptr = static_cast<const byte*>(
+          std::memchr(ptr, prefix[0], end - ptr - prefix_length + 1));
+      if (ptr == nullptr) return 0;
+      if (std::memcmp(ptr + 1, prefix + 1, prefix_length - 1) == 0) {
+        state->start = ptr;
+        state->ptr = ptr + state->prefix_skip;
+        if (flags & kInfoLiteral) return 1;
+        // Skip the LITERAL operators of the prefix characters already seen.
+        status = sreMatch<Text>(state, pattern + 2 * prefix_skip, false);
+        if (status != 0) return status;
+        resetCaptureGroups(state);
+      }
+      ptr++;
+    }
+    return 0;
+  }
+
+  if (charset != nullptr) {
+    // The pattern starts with a character from a known set.
+    end = state->end;
+    state->must_advance = false;
+    for (;;) {
+      while (ptr < end && !inCharset(charset, Text::read(ptr))) {
+        ptr = Text::next(ptr);
+      }
+      if (ptr >= end) return 0;
+      state->start = ptr;
+      state->ptr = ptr;
+      status = sreMatch<Text>(state, pattern, false);
+      if (status != 0) break;
+      ptr = Text::next(ptr);
+      resetCaptureGroups(state);
+    }
+    return status;
+  }
+
+  state->start = state->ptr = ptr;
+  status = sreMatch<Text>(state, pattern, true);
+  state->must_advance = false;
+  while (status == 0 && ptr < end) {
+    ptr = Text::next(ptr);
+    resetCaptureGroups(state);
+    state->start = state->ptr = ptr;
+    status = sreMatch<Text>(state, pattern, false);
+  }
+  return status;
+}
+
+// Validation of the code produced by `sre_compile`, so the matcher never
+// reads outside of the code or follows a jump that leaves it.
+
+static bool validateCharset(const SreCode* code, const SreCode* end) {
+  while (code < end) {
+    SreCode op = *code++;
+    switch (op) {
+      case kOpNegate:
+        break;
+      case kOpLiteral:
+        if (code >= end) return false;
+        code++;
+        break;
+      case kOpRange:
+      case kOpRangeUniIgnore:
+        if (end - code < 2) return false;
+        code += 2;
+        break;
+      case kOpCharset:
+        if (end - code < 256 / 32) return false;
+        code += 256 / 32;
+        break;
+      case kOpBigCharset: {
+        if (code >= end) return false;
+        SreCode num_blocks = *code++;
+        if (end - code < static_cast<word>(256 / sizeof(SreCode))) {
+          return false;
+        }
+        // Each block index must point to one of the blocks.
+        const byte* indices = reinterpret_cast<const byte*>(code);
+        for (word i = 0; i < 256; i++) {
+          if (indices[i] >= num_blocks) return false;
+        }
+        code += 256 / sizeof(SreCode);
+        if (static_cast<uword>(end - code) < num_blocks * (256 / 32)) {
+          return false;
+        }
+        code += num_blocks * (256 / 32);
+        break;
+      }
+      case kOpCategory:
+        if (code >= end || *code > kCategoryUniNotLinebreak) return false;
+        code++;
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+static bool validateInner(const SreCode* code, const SreCode* end,
+                          word groups);
+
+// Reads the skip argument at `*code` and checks that the region it spans,
+// less `adjust` words, stays inside the code.
+static bool readSkip(const SreCode** code, const SreCode* end, SreCode* skip,
+                     SreCode adjust) {
+  if (*code >= end) return false;
+  *skip = **code;
+  if (*skip - adjust > static_cast<uword>(end - *code)) return false;
+  (*code)++;
+  return true;
+}
+
+static bool readArg(const SreCode** code, const SreCode* end, SreCode* arg) {
+  if (*code >= end) return false;
+  *arg = *(*code)++;
+  return true;
+}
+
+static bool validateInfo(const SreCode** code_ptr, const SreCode* end) {
+  // <INFO> <1=skip> <2=flags> <3=min> <4=max> [<prefix info> | <charset>]
+  const SreCode* code = *code_ptr;
+  SreCode skip, flags, arg;
+  if (!readSkip(&code, end, &skip, 0)) return false;
+  const SreCode* info_end = code + skip - 1;
+  if (!readArg(&code, end, &flags) || !readArg(&code, end, &arg) ||
+      !readArg(&code, end, &arg)) {
+    return false;
+  }
+  if ((flags & ~(kInfoPrefix | kInfoLiteral | kInfoCharset)) != 0) {
+    return false;
+  }
+  // PREFIX and CHARSET are mutually exclusive and LITERAL implies PREFIX.
+  if ((flags & kInfoPrefix) && (flags & kInfoCharset)) return false;
+  if ((flags & kInfoLiteral) && !(flags & kInfoPrefix)) return false;
+  if (flags & kInfoPrefix) {
+    // <length> <skip> <prefix data> <overlap data>
+    SreCode prefix_length, prefix_skip;
+    if (!readArg(&code, end, &prefix_length) ||
+        !readArg(&code, end, &prefix_skip)) {
+      return false;
+    }
+    if (prefix_skip > prefix_length) return false;
+    if (prefix_length > static_cast<uword>(info_end - code)) return false;
+    code += prefix_length;
+    if (prefix_length > static_cast<uword>(info_end - code)) return false;
+    for (SreCode i = 0; i < prefix_length; i++) {
+      if (code[i] >= prefix_length) return false;
+    }
+    code += prefix_length;
+  }
+  if (flags & kInfoCharset) {
+    if (!validateCharset(code, info_end - 1) || info_end[-1] != kOpFailure) {
+      return false;
+    }
+    code = info_end;
+  } else if (code != info_end) {
+    return false;
+  }
+  *code_ptr = code;
+  return true;
+}
+
+static bool validateInner(const SreCode* code, const SreCode* end,
+                          word groups) {
+  if (code > end) return false;
+  while (code < end) {
+    SreCode op = *code++;
+    SreCode arg, skip, min, max;
+    switch (op) {
+      case kOpMark:
+        // Marks need not be properly nested; the matcher copes with that.
+        if (!readArg(&code, end, &arg)) return false;
+        if (arg > 2 * static_cast<uword>(groups) + 1) return false;
+        break;
+
+      case kOpLiteral:
+      case kOpNotLiteral:
+      case kOpLiteralIgnore:
+      case kOpNotLiteralIgnore:
+      case kOpLiteralUniIgnore:
+      case kOpNotLiteralUniIgnore:
+      case kOpLiteralLocIgnore:
+      case kOpNotLiteralLocIgnore:
+        if (!readArg(&code, end, &arg)) return false;
+        break;
+
+      case kOpSuccess:
+      case kOpFailure:
+      case kOpAny:
+      case kOpAnyAll:
+        break;
+
+      case kOpAt:
+        if (!readArg(&code, end, &arg) || arg > kAtUniNonBoundary) {
+          return false;
+        }
+        break;
+
+      case kOpIn:
+      case kOpInIgnore:
+      case kOpInUniIgnore:
+      case kOpInLocIgnore:
+        if (!readSkip(&code, end, &skip, 0) || skip < 2) return false;
+        if (!validateCharset(code, code + skip - 2)) return false;
+        if (code[skip - 2] != kOpFailure) return false;
+        code += skip - 1;
+        break;
+
+      case kOpInfo:
+        if (!validateInfo(&code, end)) return false;
+        break;
+
+      case kOpBranch: {
+        const SreCode* target = nullptr;
+        for (;;) {
+          if (!readSkip(&code, end, &skip, 0)) return false;
+          if (skip == 0) break;
+          if (skip < 3) return false;
+          // Each alternative ends with a JUMP to the same target.
+          if (!validateInner(code, code + skip - 3, groups)) return false;
+          code += skip - 3;
+          if (code >= end || *code++ != kOpJump) return false;
+          if (!readSkip(&code, end, &skip, 0)) return false;
+          if (target == nullptr) {
+            target = code + skip - 1;
+          } else if (code + skip - 1 != target) {
+            return false;
+          }
+        }
+        break;
+      }
+
+      case kOpRepeatOne:
+      case kOpMinRepeatOne:
+        if (!readSkip(&code, end, &skip, 0) || skip < 4) return false;
+        if (!readArg(&code, end, &min) || !readArg(&code, end, &max)) {
+          return false;
+        }
+        if (min > max) return false;
+        if (!validateInner(code, code + skip - 4, groups)) return false;
+        code += skip - 4;
+        if (code >= end || *code++ != kOpSuccess) return false;
+        break;
+
+      case kOpRepeat:
+        if (!readSkip(&code, end, &skip, 0) || skip < 3) return false;
+        if (!readArg(&code, end, &min) || !readArg(&code, end, &max)) {
+          return false;
+        }
+        if (min > max) return false;
+        if (!validateInner(code, code + skip - 3, groups)) return false;
+        code += skip - 3;
+        if (code >= end) return false;
+        op = *code++;
+        if (op != kOpMaxUntil && op != kOpMinUntil) return false;
+        break;
+
+      case kOpGroupref:
+      case kOpGrouprefIgnore:
+      case kOpGrouprefUniIgnore:
+      case kOpGrouprefLocIgnore:
+        if (!readArg(&code, end, &arg)) return false;
+        if (arg >= static_cast<uword>(groups)) return false;
+        break;
+
+      case kOpGrouprefExists:
+        // <GROUPREF_EXISTS> <group> <skipyes> then [<JUMP> <skipno> else]
+        // The skip is relative to the group argument.
+        if (!readArg(&code, end, &arg)) return false;
+        if (arg >= static_cast<uword>(groups)) return false;
+        if (!readSkip(&code, end, &skip, 1) || skip < 1) return false;
+        code--;
+        if (skip >= 3 && skip - 3 < static_cast<uword>(end - code) &&
+            code[skip - 3] == kOpJump) {
+          // Both a then and an else part.
+          if (!validateInner(code + 1, code + skip - 3, groups)) return false;
+          code += skip - 2;
+          if (!readSkip(&code, end, &skip, 0) || skip < 1) return false;
+          if (!validateInner(code, code + skip - 1, groups)) return false;
+          code += skip - 1;
+        } else {
+          if (!validateInner(code + 1, code + skip - 1, groups)) return false;
+          code += skip - 1;
+        }
+        break;
+
+      case kOpAssert:
+      case kOpAssertNot:
+        // <ASSERT> <skip> <back> <pattern> <SUCCESS>
+        if (!readSkip(&code, end, &skip, 0) || skip < 2) return false;
+        if (!readArg(&code, end, &arg)) return false;
+        if (arg & 0x80000000) return false;
+        code--;
+        if (!validateInner(code + 1, code + skip - 2, groups)) return false;
+        code += skip - 2;
+        if (code >= end || *code++ != kOpSuccess) return false;
+        break;
+
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+static bool validateCode(const SreCode* code, word length, word groups) {
+  if (groups < 0 || groups > kMaxGroups || length == 0 ||
+      code[length - 1] != kOpSuccess) {
+    return false;
+  }
+  return validateInner(code, code + length - 1, groups);
+}
+
+static const SreCode* codeWords(RawBytes code) {
+  return reinterpret_cast<const SreCode*>(LargeBytes::cast(code).address());
+}
+
+static word codeGroups(RawBytes code) {
+  return codeWords(code)[kCodeHeaderGroups];
+}
+
+static SreCode codeKind(RawBytes code) {
+  return codeWords(code)[kCodeHeaderKind];
+}
+
+// The string or bytes-like object a pattern is matched against.
+class Subject {
+ public:
+  Subject(HandleScope* scope, Thread* thread, const Object& object);
+
+  bool isValid() const { return is_str_ || bytes_.isValid(); }
+  bool isStr() const { return is_str_; }
+  // Strings with non-ASCII characters are matched with `UTF8Text`.
+  bool isUTF8() const { return is_utf8_; }
+  // Length in bytes.
+  word length() const { return length_; }
+  // Length in characters.
+  word numChars() const { return num_chars_; }
+
+  // Returns the address of the subject data. It changes when the data is
+  // moved by the garbage collector, so it must be fetched again after any
+  // allocation.
+  const byte* data();
+
+  // Returns the byte offset of the character at `index`, clamped to the
+  // subject.
+  word offsetAt(word index);
+  // Returns the character index of the byte offset `offset`.
+  word indexAt(word offset);
+  // Returns the text between the byte offsets as a str or bytes object.
+  RawObject slice(word start, word end);
+
+ private:
+  Thread* thread_;
+  Object str_;
+  Byteslike bytes_;
+  word length_;
+  word num_chars_;
+  bool is_str_;
+  bool is_utf8_;
+  byte small_data_[SmallStr::kMaxLength];
+
+  DISALLOW_HEAP_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(Subject);
+};
+
+Subject::Subject(HandleScope* scope, Thread* thread, const Object& object)
+    : thread_(thread),
+      str_(scope, thread->runtime()->isInstanceOfStr(*object)
+                      ? RawObject{strUnderlying(*object)}
+                      : NoneType::object()),
+      bytes_(scope, thread,
+             str_.isNoneType() ? *object : NoneType::object()) {
+  is_str_ = !str_.isNoneType();
+  is_utf8_ = false;
+  if (is_str_) {
+    Str str(scope, *str_);
+    length_ = str.length();
+    num_chars_ = thread->strCodePointLength(str);
+    is_utf8_ = num_chars_ != length_;
+  } else {
+    length_ = bytes_.isValid() ? bytes_.length() : 0;
+    num_chars_ = length_;
+  }
+}
+
+const byte* Subject::data() {
+  if (!is_str_) return reinterpret_cast<const byte*>(bytes_.address());
+  RawStr str = Str::cast(*str_);
+  if (str.isSmallStr()) {
+    str.copyTo(small_data_, length_);
+    return small_data_;
+  }
+  return reinterpret_cast<const byte*>(LargeStr::cast(str).address());
+}
+
+word Subject::offsetAt(word index) {
+  if (index <= 0) return 0;
+  if (!is_utf8_) return Utils::minimum(index, length_);
+  HandleScope scope(thread_);
+  Str str(&scope, *str_);
+  return thread_->strOffset(str, index);
+}
+
+word Subject::indexAt(word offset) {
+  if (!is_utf8_) return offset;
+  HandleScope scope(thread_);
+  Str str(&scope, *str_);
+  return thread_->strCodePointIndex(str, offset);
+}
+
+RawObject Subject::slice(word start, word end) {
+  HandleScope scope(thread_);
+  word length = Utils::maximum(end - start, word{0});
+  if (is_str_) {
+    Str str(&scope, *str_);
+    if (length == 0) return Str::empty();
+    return strSubstr(thread_, str, start, length);
+  }
+  if (length == 0) return Bytes::empty();
+  MutableBytes result(
+      &scope, thread_->runtime()->newMutableBytesUninitialized(length));
+  bytes_.copyToStartAt(reinterpret_cast<byte*>(result.address()), length,
+                       start);
+  return result.becomeImmutable();
+}
+
+// Runs a pattern over a subject, possibly several times as in `findall()`,
+// `split()` or `sub()`. Match positions are kept as byte offsets because the
+// subject data may move between runs.
+class Matcher {
+ public:
+  Matcher(Thread* thread, const Bytes& code, Subject* subject);
+  ~Matcher();
+
+  // Runs a match or search starting at byte offset `start` that may not go
+  // past `end`. Returns `Bool::trueObj()` on a match, `Bool::falseObj()`
+  // otherwise, or an error.
+  RawObject run(SreMode mode, word start, word end, bool must_advance);
+
+  word groups() const { return groups_; }
+  word lastindex() const { return lastindex_; }
+  // Returns the byte offsets of group `group` of the last match; group 0 is
+  // the whole match. Both are -1 when the group did not participate.
+  word groupStart(word group) const { return spans_[group * 2]; }
+  word groupEnd(word group) const { return spans_[group * 2 + 1]; }
+  word matchStart() const { return spans_[0]; }
+  word matchEnd() const { return spans_[1]; }
+
+ private:
+  void encodePrefix();
+
+  Thread* thread_;
+  const Bytes& code_;
+  Subject* subject_;
+  word groups_;
+  word lastindex_;
+  word* spans_;
+  SreState state_;
+  Vector<byte> prefix_;
+
+  DISALLOW_HEAP_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(Matcher);
+};
+
+Matcher::Matcher(Thread* thread, const Bytes& code, Subject* subject)
+    : thread_(thread),
+      code_(code),
+      subject_(subject),
+      groups_(codeGroups(*code)),
+      lastindex_(-1) {
+  spans_ = new word[(groups_ + 1) * 2];
+  state_.thread = thread;
+  state_.mark = new const byte*[(groups_ + 1) * 2];
+  state_.data_stack = nullptr;
+  state_.data_stack_size = 0;
+  state_.data_stack_base = 0;
+  state_.free_repeats = nullptr;
+  encodePrefix();
+}
+
+Matcher::~Matcher() {
+  for (SreRepeat* repeat : state_.repeats) delete repeat;
+  std::free(state_.data_stack);
+  delete[] state_.mark;
+  delete[] spans_;
+}
+
+// Encodes the literal prefix from the INFO block the way it appears in the
+// subject data, so that `sreSearch` can look for it with memchr.
+void Matcher::encodePrefix() {
+  state_.prefix = nullptr;
+  state_.prefix_length = 0;
+  state_.prefix_skip = 0;
+  const SreCode* pattern = codeWords(*code_) + kCodeHeaderLength;
+  if (pattern[0] != kOpInfo || !(pattern[2] & kInfoPrefix)) return;
+  // <INFO> <1=skip> <2=flags> <3=min> <4=max> <5=length> <6=skip> <prefix>
+  SreCode length = pattern[5];
+  SreCode skip = pattern[6];
+  const SreCode* prefix = pattern + 7;
+  for (SreCode i = 0; i < length; i++) {
+    if (i == skip) state_.prefix_skip = prefix_.size();
+    SreCode ch = prefix[i];
+    if (!subject_->isStr()) {
+      // The character does not fit into a byte and cannot occur.
+      if (ch > kMaxByte) return;
+      prefix_.push_back(ch);
+      continue;
+    }
+    if (ch > kMaxUnicode) return;
+    RawSmallStr encoded = RawSmallStr::fromCodePoint(ch);
+    for (word j = 0, num_bytes = encoded.length(); j < num_bytes; j++) {
+      prefix_.push_back(encoded.byteAt(j));
+    }
+  }
+  if (skip >= length) state_.prefix_skip = prefix_.size();
+  state_.prefix = prefix_.begin();
+  state_.prefix_length = prefix_.size();
+}
+
+RawObject Matcher::run(SreMode mode, word start, word end, bool must_advance) {
+  for (;;) {
+    const byte* data = subject_->data();
+    const SreCode* pattern = codeWords(*code_) + kCodeHeaderLength;
+    state_.beginning = data;
+    state_.start = data + start;
+    state_.ptr = state_.start;
+    state_.end = data + end;
+    state_.lastmark = -1;
+    state_.lastindex = -1;
+    state_.match_all = mode == SreMode::kFullMatch;
+    state_.must_advance = must_advance;
+    state_.data_stack_base = 0;
+    state_.repeat = nullptr;
+    word status;
+    if (subject_->isUTF8()) {
+      status = mode == SreMode::kSearch
+                   ? sreSearch<UTF8Text>(&state_, pattern)
+                   : sreMatch<UTF8Text>(&state_, pattern, true);
+    } else {
+      status = mode == SreMode::kSearch
+                   ? sreSearch<ByteText>(&state_, pattern)
+                   : sreMatch<ByteText>(&state_, pattern, true);
+    }
+    if (status == kErrorInterrupted) {
+      // Run the signal handlers, then start over: the handlers may have moved
+      // the subject data.
+      RawObject result = thread_->runtime()->handlePendingSignals(thread_);
+      if (result.isErrorException()) return result;
+      continue;
+    }
+    if (status == kErrorMemory) return thread_->raiseMemoryError();
+    if (status < 0) {
+      return thread_->raiseWithFmt(
+          LayoutId::kRuntimeError,
+          "internal error in regular expression engine");
+    }
+    if (status == 0) return Bool::falseObj();
+
+    spans_[0] = state_.start - data;
+    spans_[1] = state_.ptr - data;
+    for (word i = 0, j = 0; i < groups_; i++, j += 2) {
+      if (j + 1 <= state_.lastmark && state_.mark[j] != nullptr &&
+          state_.mark[j + 1] != nullptr) {
+        spans_[j + 2] = state_.mark[j] - data;
+        spans_[j + 3] = state_.mark[j + 1] - data;
+      } else {
+        spans_[j + 2] = spans_[j + 3] = -1;
+      }
+    }
+    lastindex_ = state_.lastindex;
+    return Bool::trueObj();
+  }
+}
+
+static RawObject checkSubject(Thread* thread, const Subject& subject,
+                              SreCode kind) {
+  if (!subject.isValid()) {
+    return thread->raiseWithFmt(LayoutId::kTypeError,
+                                "expected string or bytes-like object");
+  }
+  if (kind == kKindStr && !subject.isStr()) {
+    return thread->raiseWithFmt(
+        LayoutId::kTypeError,
+        "cannot use a string pattern on a bytes-like object");
+  }
+  if (kind == kKindBytes && subject.isStr()) {
+    return thread->raiseWithFmt(
+        LayoutId::kTypeError,
+        "cannot use a bytes pattern on a string-like object");
+  }
+  return NoneType::object();
+}
+
+static RawObject indexArgument(Thread* thread, const Object& arg,
+                               word* result) {
+  if (!thread->runtime()->isInstanceOfInt(*arg)) {
+    return thread->raiseRequiresType(arg, ID(int));
+  }
+  *result = intUnderlying(*arg).asWordSaturated();
+  return NoneType::object();
+}
+
+static RawObject groupSlice(Subject* subject, const Matcher& matcher,
+                            word group) {
+  word start = matcher.groupStart(group);
+  if (start < 0) return NoneType::object();
+  return subject->slice(start, matcher.groupEnd(group));
+}
+
+RawObject FUNC(_sre, _pack_code)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Object code_obj(&scope, args.get(0));
+  if (!runtime->isInstanceOfList(*code_obj)) {
+    return thread->raiseRequiresType(code_obj, ID(list));
+  }
+  List code(&scope, *code_obj);
+  word groups = SmallInt::cast(args.get(1)).value();
+  word kind = SmallInt::cast(args.get(2)).value();
+  word length = code.numItems();
+  MutableBytes result(&scope, runtime->newMutableBytesUninitialized(
+                                  (kCodeHeaderLength + length) *
+                                  static_cast<word>(sizeof(SreCode))));
+  SreCode header[kCodeHeaderLength];
+  header[kCodeHeaderGroups] = groups;
+  header[kCodeHeaderKind] = kind;
+  result.replaceFromWithAll(0, View<byte>(reinterpret_cast<byte*>(header),
+                                          sizeof(header)));
+  Object item(&scope, NoneType::object());
+  for (word i = 0; i < length; i++) {
+    item = code.at(i);
+    if (!runtime->isInstanceOfInt(*item)) {
+      return thread->raiseRequiresType(item, ID(int));
+    }
+    Int value(&scope, intUnderlying(*item));
+    if (value.isNegative() || value.bitLength() > 32) {
+      return thread->raiseWithFmt(
+          LayoutId::kOverflowError,
+          "regular expression code size limit exceeded");
+    }
+    SreCode word_value = value.asWord();
+    result.replaceFromWithAll(
+        (kCodeHeaderLength + i) * sizeof(SreCode),
+        View<byte>(reinterpret_cast<byte*>(&word_value), sizeof(word_value)));
+  }
+  const SreCode* words =
+      reinterpret_cast<const SreCode*>(result.address()) + kCodeHeaderLength;
+  if (!validateCode(words, length, groups)) {
+    return thread->raiseWithFmt(LayoutId::kRuntimeError, "invalid SRE code");
+  }
+  return result.becomeImmutable();
+}
+
+RawObject FUNC(_sre, _match)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Bytes code(&scope, args.get(0));
+  Object string(&scope, args.get(1));
+  Subject subject(&scope, thread, string);
+  Object result(&scope, checkSubject(thread, subject, codeKind(*code)));
+  if (result.isErrorException()) return *result;
+  word pos, endpos, start;
+  Object arg(&scope, args.get(2));
+  result = indexArgument(thread, arg, &pos);
+  if (result.isErrorException()) return *result;
+  arg = args.get(3);
+  result = indexArgument(thread, arg, &endpos);
+  if (result.isErrorException()) return *result;
+  arg = args.get(4);
+  result = indexArgument(thread, arg, &start);
+  if (result.isErrorException()) return *result;
+  word mode = SmallInt::cast(args.get(5)).value();
+  bool must_advance = Bool::cast(args.get(6)).value();
+
+  word num_chars = subject.numChars();
+  pos = Utils::maximum(word{0}, Utils::minimum(pos, num_chars));
+  endpos = Utils::maximum(word{0}, Utils::minimum(endpos, num_chars));
+  word start_offset = subject.offsetAt(Utils::maximum(pos, start));
+  word end_offset = subject.offsetAt(endpos);
+  Matcher matcher(thread, code, &subject);
+  result = matcher.run(static_cast<SreMode>(mode), start_offset, end_offset,
+                       must_advance);
+  if (result.isErrorException()) return *result;
+  if (result == Bool::falseObj()) return NoneType::object();
+
+  // (start0, end0, start1, end1, ..., lastindex, pos, endpos) in characters
+  word num_spans = (matcher.groups() + 1) * 2;
+  MutableTuple regs(&scope,
+                    thread->runtime()->newMutableTuple(num_spans + 3));
+  for (word i = 0; i < num_spans; i += 2) {
+    word span_start = matcher.groupStart(i / 2);
+    word span_end = matcher.groupEnd(i / 2);
+    if (span_start >= 0) {
+      span_start = subject.indexAt(span_start);
+      span_end = subject.indexAt(span_end);
+    }
+    regs.atPut(i, SmallInt::fromWord(span_start));
+    regs.atPut(i + 1, SmallInt::fromWord(span_end));
+  }
+  regs.atPut(num_spans, SmallInt::fromWord(matcher.lastindex()));
+  regs.atPut(num_spans + 1, SmallInt::fromWord(pos));
+  regs.atPut(num_spans + 2, SmallInt::fromWord(endpos));
+  return regs.becomeImmutable();
+}
+
+RawObject FUNC(_sre, _findall)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Bytes code(&scope, args.get(0));
+  Object string(&scope, args.get(1));
+  Subject subject(&scope, thread, string);
+  Object result(&scope, checkSubject(thread, subject, codeKind(*code)));
+  if (result.isErrorException()) return *result;
+  word pos, endpos;
+  Object arg(&scope, args.get(2));
+  result = indexArgument(thread, arg, &pos);
+  if (result.isErrorException()) return *result;
+  arg = args.get(3);
+  result = indexArgument(thread, arg, &endpos);
+  if (result.isErrorException()) return *result;
+
+  word start = subject.offsetAt(pos);
+  word end = subject.offsetAt(endpos);
+  Matcher matcher(thread, code, &subject);
+  word groups = matcher.groups();
+  List list(&scope, runtime->newList());
+  Object item(&scope, NoneType::object());
+  bool must_advance = false;
+  while (start <= end) {
+    result = matcher.run(SreMode::kSearch, start, end, must_advance);
+    if (result.isErrorException()) return *result;
+    if (result == Bool::falseObj()) break;
+    if (groups == 0) {
+      item = subject.slice(matcher.matchStart(), matcher.matchEnd());
+    } else if (groups == 1) {
+      item = groupSlice(&subject, matcher, 1);
+      if (item.isNoneType()) item = subject.slice(0, 0);
+    } else {
+      MutableTuple tuple(&scope, runtime->newMutableTuple(groups));
+      for (word i = 0; i < groups; i++) {
+        item = groupSlice(&subject, matcher, i + 1);
+        if (item.isNoneType()) item = subject.slice(0, 0);
+        tuple.atPut(i, *item);
+      }
+      item = tuple.becomeImmutable();
+    }
+    runtime->listAdd(thread, list, item);
+    must_advance = matcher.matchEnd() == matcher.matchStart();
+    start = matcher.matchEnd();
+  }
+  return *list;
+}
+
+RawObject FUNC(_sre, _split)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Bytes code(&scope, args.get(0));
+  Object string(&scope, args.get(1));
+  Subject subject(&scope, thread, string);
+  Object result(&scope, checkSubject(thread, subject, codeKind(*code)));
+  if (result.isErrorException()) return *result;
+  word maxsplit;
+  Object arg(&scope, args.get(2));
+  result = indexArgument(thread, arg, &maxsplit);
+  if (result.isErrorException()) return *result;
+
+  Matcher matcher(thread, code, &subject);
+  word groups = matcher.groups();
+  word length = subject.length();
+  List list(&scope, runtime->newList());
+  Object item(&scope, NoneType::object());
+  word last = 0;
+  bool must_advance = false;
+  for (word n = 0; maxsplit == 0 || n < maxsplit; n++) {
+    result = matcher.run(SreMode::kSearch, last, length, must_advance);
+    if (result.isErrorException()) return *result;
+    if (result == Bool::falseObj()) break;
+    item = subject.slice(last, matcher.matchStart());
+    runtime->listAdd(thread, list, item);
+    for (word i = 0; i < groups; i++) {
+      item = groupSlice(&subject, matcher, i + 1);
+      runtime->listAdd(thread, list, item);
+    }
+    must_advance = matcher.matchEnd() == matcher.matchStart();
+    last = matcher.matchEnd();
+  }
+  item = subject.slice(last, length);
+  runtime->listAdd(thread, list, item);
+  return *list;
+}
+
+// Appends the subject text between the byte offsets to `buffer`.
+static void appendSubject(Thread* thread, const StrArray& buffer,
+                          Subject* subject, word start, word end) {
+  word length = end - start;
+  if (length <= 0) return;
+  word num_items = buffer.numItems();
+  thread->runtime()->strArrayEnsureCapacity(thread, buffer,
+                                            num_items + length);
+  // The data may have moved while the buffer grew.
+  MutableBytes::cast(buffer.items())
+      .replaceFromWithAll(num_items,
+                          View<byte>(subject->data() + start, length));
+  buffer.setNumItems(num_items + length);
+}
+
+// Appends a literal part of a replacement template to `buffer`.
+static RawObject appendLiteral(Thread* thread, const StrArray& buffer,
+                               const Subject& subject, const Object& literal) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  if (subject.isStr()) {
+    if (!runtime->isInstanceOfStr(*literal)) {
+      return thread->raiseWithFmt(LayoutId::kTypeError,
+                                  "expected str instance, %T found", &literal);
+    }
+    Str str(&scope, strUnderlying(*literal));
+    runtime->strArrayAddStr(thread, buffer, str);
+    return NoneType::object();
+  }
+  Byteslike bytes(&scope, thread, *literal);
+  if (!bytes.isValid()) {
+    return thread->raiseWithFmt(LayoutId::kTypeError,
+                                "expected a bytes-like object, %T found",
+                                &literal);
+  }
+  word length = bytes.length();
+  word num_items = buffer.numItems();
+  runtime->strArrayEnsureCapacity(thread, buffer, num_items + length);
+  bytes.copyTo(
+      reinterpret_cast<byte*>(MutableBytes::cast(buffer.items()).address()) +
+          num_items,
+      length);
+  buffer.setNumItems(num_items + length);
+  return NoneType::object();
+}
+
+RawObject FUNC(_sre, _sub)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Bytes code(&scope, args.get(0));
+  Object template_obj(&scope, args.get(1));
+  Object string(&scope, args.get(2));
+  Subject subject(&scope, thread, string);
+  Object result(&scope, checkSubject(thread, subject, codeKind(*code)));
+  if (result.isErrorException()) return *result;
+  word count;
+  Object arg(&scope, args.get(3));
+  result = indexArgument(thread, arg, &count);
+  if (result.isErrorException()) return *result;
+
+  Matcher matcher(thread, code, &subject);
+  word groups = matcher.groups();
+  word length = subject.length();
+  StrArray buffer(&scope, runtime->newStrArray());
+  Object part(&scope, NoneType::object());
+  word last = 0;
+  word n = 0;
+  bool must_advance = false;
+  while (count == 0 || n < count) {
+    result = matcher.run(SreMode::kSearch, last, length, must_advance);
+    if (result.isErrorException()) return *result;
+    if (result == Bool::falseObj()) break;
+    appendSubject(thread, buffer, &subject, last, matcher.matchStart());
+    if (template_obj.isTuple()) {
+      // The template is a sequence of literals and group indices.
+      Tuple parts(&scope, *template_obj);
+      for (word i = 0, num_parts = parts.length(); i < num_parts; i++) {
+        part = parts.at(i);
+        if (!part.isSmallInt()) {
+          result = appendLiteral(thread, buffer, subject, part);
+          if (result.isErrorException()) return *result;
+          continue;
+        }
+        word group = SmallInt::cast(*part).value();
+        if (group < 0 || group > groups) {
+          return thread->raiseWithFmt(LayoutId::kIndexError,
+                                      "invalid group reference %w", group);
+        }
+        if (matcher.groupStart(group) >= 0) {
+          appendSubject(thread, buffer, &subject, matcher.groupStart(group),
+                        matcher.groupEnd(group));
+        }
+      }
+    } else {
+      result = appendLiteral(thread, buffer, subject, template_obj);
+      if (result.isErrorException()) return *result;
+    }
+    n++;
+    must_advance = matcher.matchEnd() == matcher.matchStart();
+    last = matcher.matchEnd();
+  }
+
+  MutableTuple pair(&scope, runtime->newMutableTuple(2));
+  if (n == 0) {
+    pair.atPut(0, subject.slice(0, length));
+  } else {
+    appendSubject(thread, buffer, &subject, last, length);
+    if (subject.isStr()) {
+      pair.atPut(0, runtime->strFromStrArray(buffer));
+    } else {
+      Bytes items(&scope, buffer.items());
+      pair.atPut(0, bytesSubseq(thread, items, 0, buffer.numItems()));
+    }
+  }
+  pair.atPut(1, SmallInt::fromWord(n));
+  return pair.becomeImmutable();
+}
+
+RawObject FUNC(_sre, _getslice)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object string(&scope, args.get(0));
+  Subject subject(&scope, thread, string);
+  word start = intUnderlying(args.get(1)).asWordSaturated();
+  word end = intUnderlying(args.get(2)).asWordSaturated();
+  if (start < 0 || end <= start) return subject.slice(0, 0);
+  return subject.slice(subject.offsetAt(start), subject.offsetAt(end));
+}
+
+static RawObject characterArgument(Thread* thread, const Object& arg,
+                                   SreCode* result) {
+  if (!thread->runtime()->isInstanceOfInt(*arg)) {
+    return thread->raiseRequiresType(arg, ID(int));
+  }
+  *result = static_cast<SreCode>(intUnderlying(*arg).asWordSaturated());
+  return NoneType::object();
+}
+
+RawObject FUNC(_sre, ascii_iscased)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object arg(&scope, args.get(0));
+  SreCode ch;
+  Object result(&scope, characterArgument(thread, arg, &ch));
+  if (result.isErrorException()) return *result;
+  return Bool::fromBool(ch < 128 && ASCII::isAlpha(ch));
+}
+
+RawObject FUNC(_sre, ascii_tolower)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object arg(&scope, args.get(0));
+  SreCode ch;
+  Object result(&scope, characterArgument(thread, arg, &ch));
+  if (result.isErrorException()) return *result;
+  return SmallInt::fromWord(lowerASCII(ch));
+}
+
+RawObject FUNC(_sre, unicode_iscased)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object arg(&scope, args.get(0));
+  SreCode ch;
+  Object result(&scope, characterArgument(thread, arg, &ch));
+  if (result.isErrorException()) return *result;
+  return Bool::fromBool(ch != lowerUnicode(ch) || ch != upperUnicode(ch));
+}
+
+RawObject FUNC(_sre, unicode_tolower)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object arg(&scope, args.get(0));
+  SreCode ch;
+  Object result(&scope, characterArgument(thread, arg, &ch));
+  if (result.isErrorException()) return *result;
+  return SmallInt::fromWord(lowerUnicode(ch));
+}
+
+}  // namespace py
@@ -63,13 +63,6 @@ static void* threadBegin(void* arg) {
 static RawObject startNewThread(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   Runtime* runtime = thread->runtime();
-  // TODO(T66337218): remove this guard once threading is safe
-  if (runtime->lookupNameInModule(thread, ID(_thread), ID(_enable_threads))
-          .isErrorNotFound()) {
-    UNIMPLEMENTED(
-        "PyRO runtime is not thread-safe. "
-        "Set `_thread._enable_threads = True` to bypass.");
-  }
   Object func(&scope, args.get(0));
   if (!runtime->isCallable(thread, func)) {
     return thread->raiseWithFmt(LayoutId::kTypeError,
@@ -3,6 +3,8 @@
 
 #include <cstdint>
 
+#include <immintrin.h>
+
 #include "unicode-db.h"
 
 namespace py {
@@ -181,4 +183,229 @@ FullCasing Unicode::toUpperDB(int32_t code_point) {
   return result;
 }
 
+// Returns the length of the well-formed UTF-8 sequence at the start of `data`,
+// or 0 if there is none. Follows `Objects/stringlib/codecs.h` in CPython.
+static word validSequenceLength(const byte* data, word length) {
+  byte ch = data[0];
+  if (ch <= kMaxASCII) return 1;
+  if (ch < 0xC2) return 0;
+  if (ch < 0xE0) {
+    return length >= 2 && UTF8::isTrailByte(data[1]) ? 2 : 0;
+  }
+  if (ch < 0xF0) {
+    if (length < 3 || !UTF8::isTrailByte(data[1]) ||
+        !UTF8::isTrailByte(data[2])) {
+      return 0;
+    }
+    // Reject overlong encodings and surrogates.
+    if ((ch == 0xE0 && data[1] < 0xA0) || (ch == 0xED && data[1] >= 0xA0)) {
+      return 0;
+    }
+    return 3;
+  }
+  if (ch < 0xF5) {
+    if (length < 4 || !UTF8::isTrailByte(data[1]) ||
+        !UTF8::isTrailByte(data[2]) || !UTF8::isTrailByte(data[3])) {
+      return 0;
+    }
+    // Reject overlong encodings and code points above U+10FFFF.
+    if ((ch == 0xF0 && data[1] < 0x90) || (ch == 0xF4 && data[1] >= 0x90)) {
+      return 0;
+    }
+    return 4;
+  }
+  return 0;
+}
+
+// Skips runs of ASCII 16 bytes at a time and checks everything else one
+// sequence at a time. SSE2 is part of x86-64, so this is always available.
+static bool isValidUTF8SSE2(const byte* data, word length) {
+  word i = 0;
+  while (i < length) {
+    if (i + 16 <= length &&
+        _mm_movemask_epi8(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(data + i))) == 0) {
+      i += 16;
+      continue;
+    }
+    word sequence_length = validSequenceLength(data + i, length - i);
+    if (sequence_length == 0) return false;
+    i += sequence_length;
+  }
+  return true;
+}
+
+// The AVX2 kernel classifies each byte together with the byte before it by
+// looking up the high and low nibble of the previous byte and the high nibble
+// of the current byte in three 16 entry tables. Every error pattern sets a bit in
+// all three lookups, so their AND is non-zero exactly where a 2 byte window is
+// invalid. A separate check makes sure that the third and fourth bytes of
+// longer sequences are continuation bytes. This is the algorithm from
+// "Validating UTF-8 In Less Than One Instruction Per Byte" by John Keiser and
+// Daniel Lemire.
+enum : byte {
+  kTooShort = 1 << 0,   // 11______ 0_______ or 11______ 11______
+  kTooLong = 1 << 1,    // 0_______ 10______
+  kOverlong3 = 1 << 2,  // 11100000 100_____
+  kTooLarge = 1 << 3,   // 11110100 1001____ or 11110101+ 10______
+  kSurrogate = 1 << 4,  // 11101101 101_____
+  kOverlong2 = 1 << 5,  // 1100000_ 10______
+  kTooLarge1000 = 1 << 6,  // 11110101+ 1000____
+  kOverlong4 = 1 << 6,     // 11110000 1000____
+  kTwoConts = 1 << 7,      // 10______ 10______
+  kCarry = kTooShort | kTooLong | kTwoConts,
+};
+
+static const byte kByte1HighTable[16] = {
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTwoConts,
+    kTwoConts,
+    kTwoConts,
+    kTwoConts,
+    kTooShort | kOverlong2,
+    kTooShort,
+    kTooShort | kOverlong3 | kSurrogate,
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+};
+
+static const byte kByte1LowTable[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    kCarry | kOverlong2,
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+};
+
+static const byte kByte2HighTable[16] = {
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+};
+
+// The largest byte at each position of a block after which the block does not
+// end in the middle of a sequence.
+static const byte kMaxCompleteBlock[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+};
+
+// Looks up each byte of `indices`, which must be below 16, in `table`.
+__attribute__((target("avx2"))) static __m256i lookup16(const byte* table,
+                                                        __m256i indices) {
+  __m128i entries = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table));
+  return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(entries), indices);
+}
+
+__attribute__((target("avx2"))) static __m256i highNibbles(__m256i input) {
+  return _mm256_and_si256(_mm256_srli_epi16(input, 4), _mm256_set1_epi8(0x0F));
+}
+
+// Returns `input` shifted by `N` bytes with the last bytes of `previous`
+// moved in at the front.
+template <int N>
+__attribute__((target("avx2"))) static __m256i previousBytes(
+    __m256i input, __m256i previous) {
+  return _mm256_alignr_epi8(
+      input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+}
+
+__attribute__((target("avx2"))) static __m256i checkUTF8Block(
+    __m256i input, __m256i previous) {
+  __m256i prev1 = previousBytes<1>(input, previous);
+  __m256i byte_1_high = lookup16(kByte1HighTable, highNibbles(prev1));
+  __m256i byte_1_low = lookup16(
+      kByte1LowTable, _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+  __m256i byte_2_high = lookup16(kByte2HighTable, highNibbles(input));
+  __m256i special_cases =
+      _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+  // Only 111_____ bytes two before and 1111____ bytes three before require a
+  // continuation byte, which `special_cases` marks with kTwoConts.
+  __m256i is_third_byte = _mm256_subs_epu8(previousBytes<2>(input, previous),
+                                           _mm256_set1_epi8(0xE0 - 0x80));
+  __m256i is_fourth_byte = _mm256_subs_epu8(previousBytes<3>(input, previous),
+                                            _mm256_set1_epi8(0xF0 - 0x80));
+  __m256i must_be_continuation =
+      _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte),
+                       _mm256_set1_epi8(static_cast<char>(0x80)));
+  return _mm256_xor_si256(must_be_continuation, special_cases);
+}
+
+// Returns non-zero bytes if the block ends in the middle of a sequence.
+__attribute__((target("avx2"))) static __m256i isIncompleteBlock(
+    __m256i input) {
+  __m256i max_complete = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(kMaxCompleteBlock));
+  return _mm256_subs_epu8(input, max_complete);
+}
+
+__attribute__((target("avx2"))) static bool isValidUTF8AVX2(const byte* data,
+                                                            word length) {
+  __m256i error = _mm256_setzero_si256();
+  __m256i previous = _mm256_setzero_si256();
+  __m256i previous_incomplete = _mm256_setzero_si256();
+  word i = 0;
+  for (; i + 32 <= length; i += 32) {
+    __m256i input =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    if (_mm256_movemask_epi8(input) == 0) {
+      // An ASCII block is only wrong if the block before was cut short.
+      error = _mm256_or_si256(error, previous_incomplete);
+    } else {
+      error = _mm256_or_si256(error, checkUTF8Block(input, previous));
+      previous_incomplete = isIncompleteBlock(input);
+    }
+    previous = input;
+  }
+  if (!_mm256_testz_si256(error, error)) return false;
+  // Sequences that start in the last 3 bytes of the last block were not
+  // checked to be complete. Check them again together with the rest.
+  word start = i;
+  for (word j = i - 1; j >= 0 && j >= i - 3; j--) {
+    if (data[j] <= kMaxASCII) break;
+    if (!UTF8::isTrailByte(data[j])) {
+      start = j;
+      break;
+    }
+  }
+  return isValidUTF8SSE2(data + start, length - start);
+}
+
+bool UTF8::isValid(const byte* data, word length) {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  if (has_avx2) return isValidUTF8AVX2(data, length);
+  return isValidUTF8SSE2(data, length);
+}
+
 }  // namespace py
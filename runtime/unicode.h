@@ -265,6 +265,11 @@ class UTF8 {
   // Given the lead byte of a UTF-8 code point, return its length.
   static word numChars(byte lead_byte);
 
+  // Returns true if `data[0:length]` is well-formed UTF-8: no overlong
+  // encodings, surrogates, code points above U+10FFFF or truncated sequences.
+  // Uses AVX2 when the processor supports it.
+  static bool isValid(const byte* data, word length);
+
  private:
   DISALLOW_IMPLICIT_CONSTRUCTORS(UTF8);
 };